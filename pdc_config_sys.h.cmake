@@ -9,6 +9,9 @@
 /* Define if you want to enable timing */
 #cmakedefine PDC_TIMING
 
+/* Most verbose log level compiled in, 0 (NONE) to 4 (DEBUG) */
+#define PDC_LOG_LEVEL_MAX @PDC_LOG_LEVEL_MAX@
+
 /* Define if you want to enable server cache */
 #cmakedefine PDC_SERVER_CACHE
 
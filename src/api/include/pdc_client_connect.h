@@ -92,11 +92,50 @@ struct _pdc_obj_reset_dims_args {
 struct _pdc_transfer_request_args {
     uint64_t metadata_id;
     int32_t  ret;
+    // Only used by a request posted without waiting, which is finished by its reply callback
+    int *        pending;
+    int *        failed;
+    uint64_t *   metadata_id_ptr;
+    hg_handle_t  handle;
+    uint32_t     data_server_id;
+    pdc_access_t access_type;
+    hg_size_t    size;
+    uint64_t     metrics_start;
+};
+
+struct _pdc_obj_create_batch_args {
+    int32_t ret;
+    int32_t n_created;
+};
+
+struct _pdc_obj_get_data_args {
+    int32_t  ret;
+    void *   data;
+    uint64_t size; // bytes the caller can take
 };
 
 struct _pdc_transfer_request_all_args {
     uint64_t metadata_id;
     int32_t  ret;
+    // Only used by a request posted without waiting, one metadata_id_ptr, pending and failed per packed
+    // request
+    int **      pending;
+    int **      failed;
+    uint64_t ** metadata_id_ptr;
+    int         n_objs;
+    hg_handle_t handle;
+    uint32_t    data_server_id;
+    hg_size_t   size;
+    uint64_t    metrics_start;
+};
+
+// Memory segments exposed to a data server as a single bulk handle
+struct _pdc_bulk_segments {
+    int        count;
+    void **    ptrs;
+    hg_size_t *sizes;
+    hg_size_t  total_size;
+    hg_size_t  header_size; // leading bytes holding the region descriptors, 0 if unknown
 };
 
 struct _pdc_transfer_request_metadata_query_args {
@@ -147,6 +186,13 @@ struct _pdc_query_result_list {
     uint64_t *data_arr_size;
     uint64_t  recv_data_nhits;
 
+    // Batched delivery of coords
+    uint64_t     recv_coords_nhits;
+    int          is_stream;    // deliver coords batch by batch with PDC_Client_query_get_next_batch
+    pdc_query_t *query;        // the query a stream belongs to
+    uint64_t     batch_nhits;  // number of coords in the current batch
+    hg_handle_t  batch_handle; // deferred ack of the current batch, the server sends the next one after it
+
     struct _pdc_query_result_list *prev;
     struct _pdc_query_result_list *next;
 };
@@ -155,13 +201,18 @@ struct _pdc_query_result_list {
 
 uint32_t PDC_get_client_data_server();
 
+// Seconds to wait for the server config file at init, override with PDC_CLIENT_CONFIG_WAIT_TIMEOUT
+#define PDC_CLIENT_CONFIG_WAIT_TIMEOUT_DEFAULT 512
+
 /***************************************/
 /* Library-private Function Prototypes */
 /***************************************/
 /**
- * Request from client to get address of the server
+ * Get the addrs of all servers and fill in $pdc_server_info_g. Rank 0 waits for the server config
+ * file and broadcasts all addrs at once, setting PDC_CLIENT_ADDR_SHM=1 limits the broadcast to one
+ * rank per node that shares its copy with the other ranks on the node.
  *
- * \return Number of servers on success/Negative on failure
+ * \return Non-negative on success/Negative on failure
  */
 perr_t PDC_Client_read_server_addr_from_file();
 
@@ -178,16 +229,120 @@ perr_t PDC_Client_read_server_addr_from_file();
 perr_t PDC_Client_send_name_recv_id(const char *obj_name, uint64_t cont_id, pdcid_t obj_create_prop,
                                     pdcid_t *meta_id, uint32_t *data_server_id, uint32_t *metadata_server_id);
 
+/**
+ * Client request of the obj ids of many objects with the same property, sending one RPC per metadata server
+ *
+ * \param n_objs [IN]           Number of objects
+ * \param obj_names [IN]        Names of the objects
+ * \param cont_id[IN]           Container ID (obtained from metadata server)
+ * \param obj_create_prop [IN]  ID of the object property
+ * \param meta_ids [OUT]        Medadata ids of the objects, 0 for the ones that could not be created
+ * \param data_server_id [OUT]  Data server of the objects
+ * \param metadata_server_ids [OUT]  Metadata server of each object
+ *
+ * \return Non-negative if all objects are created/Negative on failure
+ */
+perr_t PDC_Client_send_names_recv_ids(int n_objs, const char **obj_names, uint64_t cont_id,
+                                      pdcid_t obj_create_prop, pdcid_t *meta_ids, uint32_t *data_server_id,
+                                      uint32_t *metadata_server_ids);
+
+/**
+ * Get the largest object PDCobj_put_data/PDCobj_get_data send inline in a single RPC, set with
+ * PDC_OBJ_INLINE_SIZE
+ *
+ * \return Size in bytes, 0 if the inline path is disabled
+ */
+uint64_t PDC_Client_get_obj_inline_size();
+
+/**
+ * Create a 1D object and write its data with one RPC to its metadata server, which also becomes its data
+ * server
+ *
+ * \param obj_name [IN]         Name of the object
+ * \param cont_id [IN]          Container ID (obtained from metadata server)
+ * \param obj_create_prop [IN]  ID of the object property, with PDC_OBJ_STATIC region partition
+ * \param data [IN]             Data of the object
+ * \param size [IN]             Size of the data in bytes
+ * \param meta_id [OUT]         Pointer to medadata id
+ * \param server_id [OUT]       Metadata and data server of the object
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_obj_put_data(const char *obj_name, uint64_t cont_id, pdcid_t obj_create_prop, void *data,
+                               uint64_t size, pdcid_t *meta_id, uint32_t *server_id);
+
+/**
+ * Read the start of a 1D PDC_OBJ_STATIC object with one RPC, the data comes back in the reply
+ *
+ * \param obj_id [IN]           Metadata ID of the object
+ * \param data_server_id [IN]   Data server of the object
+ * \param obj_dim [IN]          Size of the object in elements
+ * \param unit [IN]             Size of an element in bytes
+ * \param data [OUT]            Buffer of at least size * unit bytes
+ * \param size [IN]             Number of elements to read
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_obj_get_data(uint64_t obj_id, uint32_t data_server_id, uint64_t obj_dim, uint64_t unit,
+                               void *data, uint64_t size);
+
+/**
+ * Send a transfer request to a data server. When pending is not NULL and the progress thread is running,
+ * return once the request is posted. *metadata_id is then filled in by the reply callback, which also
+ * decrements *pending and increments *failed when the data server reports an error.
+ *
+ * \param metadata_id [OUT]     Request ID assigned by the data server
+ * \param pending [IN/OUT]      Counter of posted requests waiting for a reply, NULL to always wait
+ * \param failed [IN/OUT]       Counter of posted requests whose reply failed, only used with pending
+ *
+ * \return Non-negative on success/Negative on failure
+ */
 perr_t PDC_Client_transfer_request(void *buf, pdcid_t obj_id, uint32_t data_server_id, int obj_ndim,
                                    uint64_t *obj_dims, int remote_ndim, uint64_t *remote_offset,
                                    uint64_t *remote_size, size_t unit, pdc_access_t access_type,
-                                   pdcid_t *metadata_id);
+                                   pdcid_t *metadata_id, int *pending, int *failed);
+
+/**
+ * Run the callbacks of the transfer requests that already got a reply, without blocking
+ */
+void PDC_Client_transfer_request_progress();
+
+/**
+ * Wait until every posted transfer request counted by pending has a reply
+ *
+ * \param pending [IN]          Counter passed to PDC_Client_transfer_request(_all_batch)
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_transfer_request_wait_posted(int *pending);
 
 int PDC_Client_get_var_type_size(pdc_var_type_t dtype);
 
 perr_t PDC_Client_transfer_request_all(int n_objs, pdc_access_t access_type, uint32_t data_server_id,
                                        char *bulk_buf, hg_size_t bulk_size, uint64_t *metadata_id);
 
+/**
+ * Send packed transfer requests to several data servers. All forwards are issued before any response is
+ * waited for, so the servers pull their bulk data concurrently.
+ *
+ * \param n_server [IN]         Number of data servers
+ * \param n_objs [IN]           Number of requests packed for each server
+ * \param access_type [IN]      PDC_WRITE or PDC_READ
+ * \param data_server_id [IN]   ID of each data server
+ * \param bulk [IN]             Bulk segments for each server, the packed header first
+ * \param metadata_id [OUT]     Where to store the ID of each packed request, in server order
+ * \param pending [IN/OUT]      Counter of each packed request, NULL to wait for the replies. With the
+ *                              progress thread running, the call returns once everything is posted and
+ *                              each reply fills in its IDs and decrements its counters.
+ * \param failed [IN/OUT]       Counter of each packed request, incremented if its server failed or was
+ *                              not posted to, NULL to only report the failure
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_transfer_request_all_batch(int n_server, int *n_objs, pdc_access_t access_type,
+                                             uint32_t *data_server_id, struct _pdc_bulk_segments *bulk,
+                                             uint64_t **metadata_id, int **pending, int **failed);
+
 perr_t PDC_Client_transfer_request_metadata_query(char *buf, uint64_t total_buf_size, int n_objs,
                                                   uint32_t metadata_server_id, uint8_t is_write,
                                                   uint64_t *output_buf_size, uint64_t *query_id);
@@ -633,6 +788,28 @@ perr_t PDC_Client_query_name_read_entire_obj_client_agg_cache_iter(int my_nobj,
 perr_t PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhits,
                            pdc_selection_t *sel, void *data);
 
+/**
+ * Get the next batch of coords selected by a query, the query is sent to the servers by the first
+ * call. Servers send at most one batch at a time and only after the previous batch is consumed.
+ *
+ * \param query [IN]            Query
+ * \param sel [OUT]             Coords of the batch, valid until the next call, nhits is 0 after the
+ *                              last batch
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_query_get_next_batch(pdc_query_t *query, pdc_selection_t *sel);
+
+/**
+ * Stop reading the batches of a query, the servers free the rest of its selection. Called when the
+ * query is freed.
+ *
+ * \param query [IN]            Query
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_query_close_batch(pdc_query_t *query);
+
 /**
  * ********
  *
@@ -751,6 +928,16 @@ perr_t PDC_Client_write_id(pdcid_t local_obj_id, struct pdc_region_info *region,
  */
 perr_t PDC_Client_all_server_checkpoint();
 
+/**
+ * Get the latency and throughput metrics of a server as a text table
+ *
+ * \param server_id [IN]        Server to get the metrics of
+ * \param snapshot [OUT]        Null-terminated table, freed by the caller
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Client_get_server_metrics(uint32_t server_id, char **snapshot);
+
 /**
  * Request of PDC client to delete metadata by object name
  *
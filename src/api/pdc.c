@@ -54,7 +54,6 @@ PDC_class_init()
         PGOTO_ERROR(FAIL, "unable to initialize pdc class interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -77,7 +76,6 @@ PDC_class_create(const char *pdc_name)
     ret_value   = pdcid;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -115,7 +113,6 @@ PDCinit(const char *pdc_name)
     ret_value = pdcid;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -147,7 +144,6 @@ PDC_class_close(pdcid_t pdc)
         PGOTO_ERROR(FAIL, "PDC: problem of freeing id");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -162,7 +158,6 @@ PDC_class_end()
         PGOTO_ERROR(FAIL, "unable to destroy pdc class interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -220,6 +215,5 @@ PDCclose(pdcid_t pdcid)
     PDC_Client_finalize();
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
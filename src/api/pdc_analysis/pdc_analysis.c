@@ -247,7 +247,6 @@ iterator_init(pdcid_t objectId, pdcid_t reg_id, int blocks, struct _pdc_iterator
     ret_value = 0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -271,7 +270,6 @@ PDCobj_data_block_iterator_create(pdcid_t obj_id, pdcid_t reg_id, int contig_blo
         PGOTO_ERROR(0, "Unable to register a new iterator");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -377,7 +375,6 @@ PDC_get_argv0_()
     ret_value = _argv0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -407,7 +404,6 @@ PDC_get_realpath(char *fname, char *app_path)
     ret_value = strdup(fullPath);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -502,7 +498,6 @@ done:
     if (loadpath)
         free(loadpath);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -526,7 +521,6 @@ PDCobj_data_getSliceCount(pdcid_t iter)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -626,7 +620,6 @@ PDCobj_data_getNextBlock(pdcid_t iter, void **nextBlock, size_t *dims)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
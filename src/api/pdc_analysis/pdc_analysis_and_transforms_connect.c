@@ -125,7 +125,6 @@ PDC_Client_send_iter_recv_id(pdcid_t iter_id, pdcid_t *meta_id)
     *meta_id = my_rpc_state_p->value;
 
 done:
-    fflush(stdout);
     HG_Destroy(my_rpc_state_p->handle);
     free(my_rpc_state_p);
 
@@ -153,7 +152,6 @@ client_register_iterator_rpc_cb(const struct hg_cb_info *info)
     }
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(info->info.forward.handle, &output);
 
@@ -242,7 +240,6 @@ PDC_Client_register_obj_analysis(struct _pdc_region_analysis_ftn_info *thisFtn,
     thisFtn->meta_index = my_rpc_state_p->value;
 
 done:
-    fflush(stdout);
     HG_Destroy(my_rpc_state_p->handle);
     free(my_rpc_state_p);
 
@@ -270,7 +267,6 @@ client_register_analysis_rpc_cb(const struct hg_cb_info *info)
     }
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(info->info.forward.handle, &output);
 
@@ -332,7 +328,6 @@ PDC_Client_register_region_transform(const char *func, const char *loadpath,
     // Here, we should update the local registry with the returned valued from my_rpc_state_p;
 
 done:
-    fflush(stdout);
     if (object_info)
         PDC_free_obj_info(object_info);
     HG_Destroy(my_rpc_state_p->handle);
@@ -360,7 +355,6 @@ client_register_transform_rpc_cb(const struct hg_cb_info *info)
     }
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(info->info.forward.handle, &output);
 
@@ -110,7 +110,6 @@ pdc_analysis_registry_init_(size_t newSize)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -145,7 +144,6 @@ pdc_transform_registry_init_(size_t newSize)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -191,7 +189,6 @@ check_analysis(pdc_obj_transform_t op_type ATTRIBUTE(unused), struct pdc_region_
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -233,7 +230,6 @@ PDC_add_analysis_ptr_to_registry_(struct _pdc_region_analysis_ftn_info *ftn_info
     ret_value = registry_index;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -287,7 +283,6 @@ PDCiter_get_nextId(void)
     ret_value = nextId;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -314,7 +309,6 @@ PDC_check_transform(pdc_obj_transform_t op_type, struct pdc_region_info *dest_re
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -331,7 +325,6 @@ PDC_get_transforms(struct _pdc_region_transform_ftn_info ***registry)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -371,7 +364,6 @@ PDC_add_transform_ptr_to_registry_(struct _pdc_region_transform_ftn_info *ftn_in
     ret_value = registry_index;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -391,7 +383,6 @@ PDC_update_transform_server_meta_index(int client_index, int meta_index)
         PGOTO_ERROR(-1, "Bad client index(%d)", client_index);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -442,7 +433,6 @@ PDC_get_ftnPtr_(const char *ftn, const char *loadpath, void **ftnPtr)
     ret_value = 0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -532,7 +522,6 @@ HG_TEST_RPC_CB(analysis_ftn, handle)
     }
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
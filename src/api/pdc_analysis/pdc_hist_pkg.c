@@ -46,7 +46,6 @@ PDC_sample_min_max(pdc_var_type_t dtype, uint64_t n, void *data, double sample_p
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -154,7 +153,6 @@ PDC_create_hist(pdc_var_type_t dtype, int nbin, double min, double max)
     ret_value = hist;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -237,7 +235,6 @@ PDC_hist_incr_all(pdc_histogram_t *hist, pdc_var_type_t dtype, uint64_t n, void
         PGOTO_ERROR(FAIL, "== datatype %d not supported!", dtype);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -279,7 +276,6 @@ PDC_gen_hist(pdc_var_type_t dtype, uint64_t n, void *data)
     ret_value = hist;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -296,7 +292,6 @@ PDC_free_hist(pdc_histogram_t *hist)
     free(hist);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE_VOID;
 }
 
@@ -319,7 +314,6 @@ PDC_print_hist(pdc_histogram_t *hist)
     printf("\n\n");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE_VOID;
 }
 
@@ -349,7 +343,6 @@ PDC_dup_hist(pdc_histogram_t *hist)
     ret_value = res;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -366,8 +359,8 @@ PDC_merge_hist(int n, pdc_histogram_t **hists)
     if (n == 0 || NULL == hists)
         PGOTO_DONE(NULL);
 
-    tot_min  = hists[0]->range[1];
-    tot_max  = hists[0]->range[2 * hists[0]->nbin - 2];
+    tot_min  = hists[0]->range[0];
+    tot_max  = hists[0]->range[2 * hists[0]->nbin - 1];
     incr_max = hists[0]->incr;
 
     for (i = 1; i < n; i++) {
@@ -419,7 +412,6 @@ PDC_merge_hist(int n, pdc_histogram_t **hists)
     ret_value = res;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -37,6 +37,7 @@
 #include "pdc_obj_pkg.h"
 #include "pdc_cont.h"
 #include "pdc_region.h"
+#include "pdc_region_pkg.h"
 #include "pdc_interface.h"
 #include "pdc_analysis_pkg.h"
 #include "pdc_transforms_common.h"
@@ -57,6 +58,11 @@
 #include <inttypes.h>
 #include <math.h>
 #include <sys/time.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
 
 #include "pdc_timing.h"
 
@@ -99,8 +105,23 @@ static hg_context_t *send_context_g     = NULL;
 static int           work_todo_g        = 0;
 int                  query_id_g         = 0;
 
+// Opt-in background progress for transfer requests, enabled with PDC_CLIENT_PROGRESS_THREAD=1
+static int             progress_thread_enabled_g = 0;
+static int             progress_thread_stop_g    = 0;
+static int             progress_todo_g           = 0; // posted transfer requests waiting for a reply
+static pthread_t       progress_thread_g;
+static pthread_mutex_t progress_mutex_g = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  progress_cond_g  = PTHREAD_COND_INITIALIZER;
+
+// PDCobj_put_data/get_data send objects up to this size inline in one RPC, set with PDC_OBJ_INLINE_SIZE
+#define PDC_OBJ_INLINE_SIZE_DEFAULT 65536
+static uint64_t pdc_obj_inline_size_g = PDC_OBJ_INLINE_SIZE_DEFAULT;
+
 static hg_id_t client_test_connect_register_id_g;
 static hg_id_t gen_obj_register_id_g;
+static hg_id_t gen_obj_batch_register_id_g;
+static hg_id_t obj_put_data_register_id_g;
+static hg_id_t obj_get_data_register_id_g;
 static hg_id_t gen_cont_register_id_g;
 static hg_id_t close_server_register_id_g;
 static hg_id_t flush_obj_register_id_g;
@@ -125,6 +146,7 @@ static hg_id_t data_server_read_check_register_id_g;
 static hg_id_t data_server_write_check_register_id_g;
 static hg_id_t data_server_write_register_id_g;
 static hg_id_t server_checkpoint_rpc_register_id_g;
+static hg_id_t server_metrics_rpc_register_id_g;
 static hg_id_t send_shm_register_id_g;
 
 // bulk
@@ -212,7 +234,6 @@ pdc_client_check_int_ret_cb(const struct hg_cb_info *callback_info)
         lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -244,90 +265,324 @@ PDC_Client_check_response(hg_context_t **hg_context)
 
     ret_value = SUCCEED;
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
+// The thread only calls HG_Progress, so network operations (the server's bulk pulls and the replies) move
+// on while the application computes. Callbacks are still triggered by the application thread, which keeps
+// work_todo_g and the transfer request state single threaded.
+static void *
+PDC_Client_progress_thread(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&progress_mutex_g);
+    while (!progress_thread_stop_g) {
+        // Sleep when nothing is posted, the NA layer may be in busy polling mode
+        if (progress_todo_g <= 0) {
+            pthread_cond_wait(&progress_cond_g, &progress_mutex_g);
+            continue;
+        }
+        pthread_mutex_unlock(&progress_mutex_g);
+        HG_Progress(send_context_g, 100);
+        pthread_mutex_lock(&progress_mutex_g);
+    }
+    pthread_mutex_unlock(&progress_mutex_g);
+
+    return NULL;
+}
+
+static void
+PDC_Client_progress_add(int n)
+{
+    pthread_mutex_lock(&progress_mutex_g);
+    progress_todo_g += n;
+    pthread_cond_signal(&progress_cond_g);
+    pthread_mutex_unlock(&progress_mutex_g);
+}
+
+void
+PDC_Client_transfer_request_progress()
+{
+    hg_return_t  hg_ret;
+    unsigned int actual_count;
+
+    FUNC_ENTER(NULL);
+
+    do {
+        hg_ret = HG_Trigger(send_context_g, 0 /* timeout */, 1 /* max count */, &actual_count);
+    } while ((hg_ret == HG_SUCCESS) && actual_count);
+
+    FUNC_LEAVE_VOID;
+}
+
 perr_t
-PDC_Client_read_server_addr_from_file()
+PDC_Client_transfer_request_wait_posted(int *pending)
 {
-    perr_t ret_value = SUCCEED;
-    int    max_tries = 9, sleeptime = 1;
-    int    i = 0, is_server_ready = 0;
-    char * p;
-    FILE * na_config = NULL;
-    char   config_fname[PATH_MAX];
-    char   n_server_string[PATH_MAX];
+    perr_t       ret_value = SUCCEED;
+    hg_return_t  hg_ret;
+    unsigned int actual_count;
 
     FUNC_ENTER(NULL);
 
-    if (pdc_client_mpi_rank_g == 0) {
-        sprintf(config_fname, "%s/%s", pdc_client_tmp_dir_g, pdc_server_cfg_name_g);
+    while (*pending > 0) {
+        do {
+            hg_ret = HG_Trigger(send_context_g, 0 /* timeout */, 1 /* max count */, &actual_count);
+        } while ((hg_ret == HG_SUCCESS) && actual_count);
 
-        for (i = 0; i < max_tries; i++) {
-            if (access(config_fname, F_OK) != -1) {
-                is_server_ready = 1;
-                break;
-            }
-            printf("==PDC_CLIENT[%d]: Config file from default location [%s] not available, "
-                   "waiting %d seconds\n",
-                   pdc_client_mpi_rank_g, config_fname, sleeptime);
-            fflush(stdout);
-            sleep(sleeptime);
-            sleeptime *= 2;
-        }
-        if (is_server_ready != 1)
-            PGOTO_ERROR(FAIL, "server is not ready");
+        if (*pending <= 0)
+            break;
+
+        hg_ret = HG_Progress(send_context_g, HG_MAX_IDLE_TIME);
+        if (hg_ret != HG_SUCCESS && hg_ret != HG_TIMEOUT)
+            PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error with HG_Progress", pdc_client_mpi_rank_g);
+    }
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Wait for the servers to write their config file, using inotify on the tmp dir when it is available and
+ * polling otherwise
+ *
+ * \param config_fname [IN]     Path of the config file
+ * \param timeout [IN]          Seconds to wait
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Client_wait_server_config(const char *config_fname, int timeout)
+{
+    perr_t         ret_value = FAIL;
+    struct timeval start, now;
+    int            remain_ms, sleep_ms = 10;
+#ifdef __linux__
+    struct inotify_event *event;
+    struct pollfd         pfd;
+    char                  events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t               len, pos;
+    int                   wd = -1;
+#endif
+
+    FUNC_ENTER(NULL);
+
+    gettimeofday(&start, 0);
+#ifdef __linux__
+    // Watch the tmp dir before checking for the file, so it can not be written unnoticed in between
+    pfd.fd     = inotify_init1(IN_CLOEXEC);
+    pfd.events = POLLIN;
+    if (pfd.fd >= 0)
+        wd = inotify_add_watch(pfd.fd, pdc_client_tmp_dir_g, IN_CLOSE_WRITE | IN_MOVED_TO);
+#endif
+
+    if (access(config_fname, F_OK) != -1)
+        PGOTO_DONE(SUCCEED);
 
-        na_config = fopen(config_fname, "r");
-        if (!na_config)
-            PGOTO_ERROR(FAIL, "Could not open config file from default location: %s", config_fname);
+    printf("==PDC_CLIENT[%d]: Config file [%s] not available, waiting up to %d seconds\n",
+           pdc_client_mpi_rank_g, config_fname, timeout);
+    fflush(stdout);
 
-        // Get the first line as $pdc_server_num_g
-        if (fgets(n_server_string, PATH_MAX, na_config) == NULL) {
-            PGOTO_ERROR(FAIL, "Get first line failed\n");
+    while (1) {
+        gettimeofday(&now, 0);
+        remain_ms = timeout * 1000 - (int)(PDC_get_elapsed_time_double(&start, &now) * 1000);
+        if (remain_ms <= 0)
+            break;
+#ifdef __linux__
+        if (wd >= 0) {
+            // Servers close the file once all addrs are written. Wake up every 100 ms and check the file
+            // too, in case the event is lost or the dir is on a file system that does not report it.
+            if (poll(&pfd, 1, remain_ms < 100 ? remain_ms : 100) > 0) {
+                len = read(pfd.fd, events, sizeof(events));
+                for (pos = 0; pos < len; pos += sizeof(struct inotify_event) + event->len) {
+                    event = (struct inotify_event *)(events + pos);
+                    if (event->len > 0 && strcmp(event->name, pdc_server_cfg_name_g) == 0)
+                        PGOTO_DONE(SUCCEED);
+                }
+            }
+            if (access(config_fname, F_OK) != -1)
+                PGOTO_DONE(SUCCEED);
+            continue;
         }
-        pdc_server_num_g = atoi(n_server_string);
+#endif
+        PDC_msleep(sleep_ms < remain_ms ? sleep_ms : remain_ms);
+        if (access(config_fname, F_OK) != -1)
+            PGOTO_DONE(SUCCEED);
+        if (sleep_ms < 1000)
+            sleep_ms *= 2;
     }
 
-#ifdef ENABLE_MPI
-    MPI_Bcast(&pdc_server_num_g, 1, MPI_INT, 0, PDC_CLIENT_COMM_WORLD_g);
+done:
+#ifdef __linux__
+    if (pfd.fd >= 0)
+        close(pfd.fd);
 #endif
+    FUNC_LEAVE(ret_value);
+}
 
-    if (pdc_server_num_g == 0) {
-        printf("==PDC_CLIENT[%d]: server number error %d\n", pdc_client_mpi_rank_g, pdc_server_num_g);
-        return -1;
+/*
+ * Read the server addrs from the config file into one buffer of null-terminated strings
+ *
+ * \param n_server [OUT]        Number of servers
+ * \param packed [OUT]          Packed addrs, to be freed by the caller
+ * \param packed_size [OUT]     Size of the packed addrs
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Client_pack_server_addr(int *n_server, char **packed, int *packed_size)
+{
+    perr_t ret_value = SUCCEED;
+    int    i, timeout = PDC_CLIENT_CONFIG_WAIT_TIMEOUT_DEFAULT;
+    char * p, *env;
+    FILE * na_config = NULL;
+    char   config_fname[PATH_MAX];
+    char   line[PATH_MAX];
+
+    FUNC_ENTER(NULL);
+
+    env = getenv("PDC_CLIENT_CONFIG_WAIT_TIMEOUT");
+    if (env != NULL)
+        timeout = atoi(env);
+
+    sprintf(config_fname, "%s/%s", pdc_client_tmp_dir_g, pdc_server_cfg_name_g);
+    if (PDC_Client_wait_server_config(config_fname, timeout) != SUCCEED)
+        PGOTO_ERROR(FAIL, "server is not ready");
+
+    na_config = fopen(config_fname, "r");
+    if (!na_config)
+        PGOTO_ERROR(FAIL, "Could not open config file from default location: %s", config_fname);
+
+    // Get the first line as the number of servers
+    if (fgets(line, PATH_MAX, na_config) == NULL)
+        PGOTO_ERROR(FAIL, "Get first line failed\n");
+    *n_server = atoi(line);
+    if (*n_server <= 0)
+        PGOTO_ERROR(FAIL, "server number error %d", *n_server);
+
+    *packed      = (char *)malloc((size_t)*n_server * ADDR_MAX);
+    *packed_size = 0;
+    for (i = 0; i < *n_server; i++) {
+        if (fgets(line, ADDR_MAX, na_config) == NULL)
+            PGOTO_ERROR(FAIL, "Get addr of server %d failed\n", i);
+        p = strrchr(line, '\n');
+        if (p != NULL)
+            *p = '\0';
+        strcpy(*packed + *packed_size, line);
+        *packed_size += strlen(line) + 1;
     }
 
-    // Allocate $pdc_server_info_g
-    pdc_server_info_g = (struct _pdc_server_info *)calloc(sizeof(struct _pdc_server_info), pdc_server_num_g);
+done:
+    if (na_config)
+        fclose(na_config);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Fill in $pdc_server_info_g from packed server addrs
+ *
+ * \param n_server [IN]         Number of servers
+ * \param packed [IN]           Null-terminated addrs, one after another
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Client_unpack_server_addr(int n_server, const char *packed)
+{
+    perr_t ret_value = SUCCEED;
+    int    i;
+
+    FUNC_ENTER(NULL);
 
-    i = 0;
-    while (i < pdc_server_num_g) {
-        if (pdc_client_mpi_rank_g == 0) {
-            if (fgets(pdc_server_info_g[i].addr_string, ADDR_MAX, na_config) == NULL) {
-                PGOTO_ERROR(FAIL, "Get first line failed\n");
-            }
-            p = strrchr(pdc_server_info_g[i].addr_string, '\n');
-            if (p != NULL)
-                *p = '\0';
-        }
+    pdc_server_num_g  = n_server;
+    pdc_server_info_g = (struct _pdc_server_info *)calloc(sizeof(struct _pdc_server_info), n_server);
+    if (pdc_server_info_g == NULL)
+        PGOTO_ERROR(FAIL, "Unable to allocate server info");
+
+    for (i = 0; i < n_server; i++) {
+        strncpy(pdc_server_info_g[i].addr_string, packed, ADDR_MAX - 1);
+        packed += strlen(packed) + 1;
+    }
 
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_read_server_addr_from_file()
+{
+    perr_t ret_value = SUCCEED;
+    // Number of servers (negative if rank 0 failed to read them) and size of the packed addrs
+    int   header[2] = {0, 0};
+    char *packed    = NULL;
 #ifdef ENABLE_MPI
-        MPI_Bcast(pdc_server_info_g[i].addr_string, ADDR_MAX, MPI_CHAR, 0, PDC_CLIENT_COMM_WORLD_g);
+    MPI_Comm leader_comm = MPI_COMM_NULL;
+    MPI_Win  win         = MPI_WIN_NULL;
+    MPI_Aint win_size;
+    char *   shared, *env;
+    int      disp_unit, use_shm = 0;
 #endif
 
-        i++;
-    }
+    FUNC_ENTER(NULL);
 
     if (pdc_client_mpi_rank_g == 0) {
-        fclose(na_config);
+        if (PDC_Client_pack_server_addr(&header[0], &packed, &header[1]) != SUCCEED)
+            header[0] = -1;
     }
 
-    ret_value = SUCCEED;
+#ifdef ENABLE_MPI
+    env = getenv("PDC_CLIENT_ADDR_SHM");
+    if (env != NULL && atoi(env) == 1 && pdc_client_same_node_size_g > 1)
+        use_shm = 1;
+
+    if (use_shm) {
+        // Only one rank per node takes part in the broadcast, the others read its copy through a
+        // shared memory window
+        MPI_Comm_split(PDC_CLIENT_COMM_WORLD_g, pdc_client_same_node_rank_g == 0 ? 0 : MPI_UNDEFINED,
+                       pdc_client_mpi_rank_g, &leader_comm);
+        if (leader_comm != MPI_COMM_NULL)
+            MPI_Bcast(header, 2, MPI_INT, 0, leader_comm);
+        MPI_Bcast(header, 2, MPI_INT, 0, PDC_SAME_NODE_COMM_g);
+        if (header[0] <= 0)
+            PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: failed to get the server addrs", pdc_client_mpi_rank_g);
+
+        MPI_Win_allocate_shared(pdc_client_same_node_rank_g == 0 ? header[1] : 0, 1, MPI_INFO_NULL,
+                                PDC_SAME_NODE_COMM_g, &shared, &win);
+        MPI_Win_shared_query(win, 0, &win_size, &disp_unit, &shared);
+        MPI_Win_fence(0, win);
+        if (leader_comm != MPI_COMM_NULL) {
+            if (pdc_client_mpi_rank_g == 0)
+                memcpy(shared, packed, header[1]);
+            MPI_Bcast(shared, header[1], MPI_CHAR, 0, leader_comm);
+        }
+        MPI_Win_fence(0, win);
+        ret_value = PDC_Client_unpack_server_addr(header[0], shared);
+        MPI_Win_fence(MPI_MODE_NOSUCCEED, win);
+        PGOTO_DONE(ret_value);
+    }
+
+    MPI_Bcast(header, 2, MPI_INT, 0, PDC_CLIENT_COMM_WORLD_g);
+    if (header[0] <= 0)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: failed to get the server addrs", pdc_client_mpi_rank_g);
+    if (pdc_client_mpi_rank_g != 0)
+        packed = (char *)malloc(header[1]);
+    // All addrs in one collective instead of one per server
+    MPI_Bcast(packed, header[1], MPI_CHAR, 0, PDC_CLIENT_COMM_WORLD_g);
+#else
+    if (header[0] <= 0)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: failed to get the server addrs", pdc_client_mpi_rank_g);
+#endif
+
+    ret_value = PDC_Client_unpack_server_addr(header[0], packed);
 
 done:
-    fflush(stdout);
+#ifdef ENABLE_MPI
+    if (win != MPI_WIN_NULL)
+        MPI_Win_free(&win);
+    if (leader_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&leader_comm);
+#endif
+    free(packed);
     FUNC_LEAVE(ret_value);
 }
 
@@ -381,7 +636,6 @@ obj_reset_dims_rpc_cb(const struct hg_cb_info *callback_info)
     }
     region_transfer_args->ret = output.ret;
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -471,7 +725,6 @@ client_send_transfer_request_metadata_query_rpc_cb(const struct hg_cb_info *call
     region_transfer_args->total_buf_size = output.total_buf_size;
     region_transfer_args->ret            = output.ret;
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -502,13 +755,68 @@ client_send_transfer_request_metadata_query2_rpc_cb(const struct hg_cb_info *cal
     }
     region_transfer_args->ret = output.ret;
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
     FUNC_LEAVE(ret_value);
 }
 
+// Finish a transfer request that was posted without waiting, called from its reply callback
+static void
+PDC_Client_transfer_request_complete(struct _pdc_transfer_request_args *args)
+{
+    *args->metadata_id_ptr = args->metadata_id;
+    PDC_PROFILE_FLOW("transfer_request", PDC_TRANSFER_FLOW_ID(args->data_server_id, args->metadata_id), 't');
+    if (args->ret != 1) {
+        printf("==PDC_CLIENT[%d]: transfer request to server %u failed\n", pdc_client_mpi_rank_g,
+               args->data_server_id);
+        (*args->failed)++;
+    }
+
+    HG_Destroy(args->handle);
+    PDC_metrics_record(args->access_type == PDC_READ ? PDC_METRIC_CLIENT_TRANSFER_REQUEST_READ
+                                                     : PDC_METRIC_CLIENT_TRANSFER_REQUEST_WRITE,
+                       args->metrics_start, args->size);
+    (*args->pending)--;
+    PDC_Client_progress_add(-1);
+    free(args);
+}
+
+// Fill in the request IDs from a transfer_request_all reply and release its handle
+static perr_t
+PDC_Client_transfer_request_all_finish(struct _pdc_transfer_request_all_args *args)
+{
+    int i;
+
+    for (i = 0; i < args->n_objs; i++) {
+        *args->metadata_id_ptr[i] = args->metadata_id + i;
+        PDC_PROFILE_FLOW("transfer_request",
+                         PDC_TRANSFER_FLOW_ID(args->data_server_id, args->metadata_id + i), 't');
+    }
+    HG_Destroy(args->handle);
+    PDC_metrics_record(PDC_METRIC_CLIENT_TRANSFER_REQUEST_ALL, args->metrics_start, args->size);
+    if (args->ret != 1) {
+        printf("==PDC_CLIENT[%d]: transfer request to server %u failed\n", pdc_client_mpi_rank_g,
+               args->data_server_id);
+        return FAIL;
+    }
+    return SUCCEED;
+}
+
+static void
+PDC_Client_transfer_request_all_complete(struct _pdc_transfer_request_all_args *args)
+{
+    int i, failed;
+
+    failed = PDC_Client_transfer_request_all_finish(args) != SUCCEED;
+    for (i = 0; i < args->n_objs; i++) {
+        *args->failed[i] += failed;
+        (*args->pending[i])--;
+    }
+    PDC_Client_progress_add(-1);
+    free(args);
+}
+
 static hg_return_t
 client_send_transfer_request_all_rpc_cb(const struct hg_cb_info *callback_info)
 {
@@ -533,9 +841,11 @@ client_send_transfer_request_all_rpc_cb(const struct hg_cb_info *callback_info)
     region_transfer_args->ret         = output.ret;
     region_transfer_args->metadata_id = output.metadata_id;
 done:
-    fflush(stdout);
-    work_todo_g--;
     HG_Free_output(handle, &output);
+    if (region_transfer_args->pending != NULL)
+        PDC_Client_transfer_request_all_complete(region_transfer_args);
+    else
+        work_todo_g--;
 
     FUNC_LEAVE(ret_value);
 }
@@ -562,7 +872,6 @@ client_send_transfer_request_wait_all_rpc_cb(const struct hg_cb_info *callback_i
     }
     region_transfer_args->ret = output.ret;
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -593,9 +902,11 @@ client_send_transfer_request_rpc_cb(const struct hg_cb_info *callback_info)
     region_transfer_args->ret         = output.ret;
     region_transfer_args->metadata_id = output.metadata_id;
 done:
-    fflush(stdout);
-    work_todo_g--;
     HG_Free_output(handle, &output);
+    if (region_transfer_args->pending != NULL)
+        PDC_Client_transfer_request_complete(region_transfer_args);
+    else
+        work_todo_g--;
 
     FUNC_LEAVE(ret_value);
 }
@@ -625,7 +936,6 @@ client_send_transfer_request_status_rpc_cb(const struct hg_cb_info *callback_inf
     region_transfer_args->status = output.status;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -658,7 +968,6 @@ client_send_transfer_request_wait_rpc_cb(const struct hg_cb_info *callback_info)
     region_transfer_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -692,7 +1001,6 @@ client_send_buf_unmap_rpc_cb(const struct hg_cb_info *callback_info)
     region_unmap_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -724,7 +1032,6 @@ client_send_buf_map_rpc_cb(const struct hg_cb_info *callback_info)
     buf_map_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g = 0;
     HG_Free_output(handle, &output);
 
@@ -753,7 +1060,6 @@ client_test_connect_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g = 0;
     HG_Free_output(handle, &output);
     HG_Destroy(callback_info->info.forward.handle);
@@ -792,7 +1098,6 @@ client_test_connect_lookup_cb(const struct hg_cb_info *callback_info)
         PGOTO_ERROR(ret_value, "Could not start HG_Forward");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -842,7 +1147,6 @@ PDC_Client_lookup_server(int server_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -867,7 +1171,6 @@ PDC_Client_try_lookup_server(int server_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -896,7 +1199,6 @@ client_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->obj_id = output.obj_id;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -926,7 +1228,6 @@ client_region_lock_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -954,7 +1255,6 @@ client_region_release_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -992,7 +1292,6 @@ client_region_release_with_transform_cb(const struct hg_cb_info *callback_info)
     transform_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1047,7 +1346,6 @@ hg_test_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     free(bulk_args);
 
     FUNC_LEAVE(ret_value);
@@ -1136,6 +1434,7 @@ PDC_Client_mercury_init(hg_class_t **hg_class, hg_context_t **hg_context, int po
     struct hg_init_info init_info            = {0};
     char *              default_hg_transport = "ofi+tcp";
     char *              hg_transport;
+    char *              auto_sm_env;
 #ifdef PDC_HAS_CRAY_DRC
     uint32_t          credential, cookie;
     drc_info_handle_t credential_info;
@@ -1195,13 +1494,21 @@ drc_access_again:
     init_info.na_init_info.progress_mode = NA_NO_BLOCK; // busy mode
 #endif
 
-// #ifndef PDC_HAS_CRAY_DRC
-#ifdef PDC_HAS_SHARED_SERVER
-    init_info.auto_sm = HG_TRUE;
-#endif
+    // Servers on the same node are reached through na+sm and bulk data is copied between the processes
+    // directly. Mercury picks sm or the network transport per server, PDC_HG_AUTO_SM=0 turns sm off.
+    auto_sm_env = getenv("PDC_HG_AUTO_SM");
+    if (auto_sm_env == NULL || atoi(auto_sm_env) != 0)
+        init_info.auto_sm = HG_TRUE;
     *hg_class = HG_Init_opt(na_info_string, HG_TRUE, &init_info);
+    if (*hg_class == NULL && init_info.auto_sm) {
+        // Mercury built without the na+sm plugin, or no usable shared memory, use the network only
+        init_info.auto_sm = HG_FALSE;
+        *hg_class         = HG_Init_opt(na_info_string, HG_TRUE, &init_info);
+    }
     if (*hg_class == NULL)
         PGOTO_ERROR(FAIL, "Error with HG_Init()");
+    if (pdc_client_mpi_rank_g == 0 && init_info.auto_sm)
+        printf("==PDC_CLIENT: using na+sm for servers on the same node\n");
 
     /* Create HG context */
     *hg_context = HG_Context_create(*hg_class);
@@ -1209,6 +1516,9 @@ drc_access_again:
     // Register RPC
     client_test_connect_register_id_g = PDC_client_test_connect_register(*hg_class);
     gen_obj_register_id_g             = PDC_gen_obj_id_register(*hg_class);
+    gen_obj_batch_register_id_g       = PDC_gen_obj_id_batch_register(*hg_class);
+    obj_put_data_register_id_g        = PDC_obj_put_data_register(*hg_class);
+    obj_get_data_register_id_g        = PDC_obj_get_data_register(*hg_class);
     gen_cont_register_id_g            = PDC_gen_cont_id_register(*hg_class);
     close_server_register_id_g        = PDC_close_server_register(*hg_class);
     flush_obj_register_id_g           = PDC_flush_obj_register(*hg_class);
@@ -1235,6 +1545,7 @@ drc_access_again:
     data_server_write_check_register_id_g  = PDC_data_server_write_check_register(*hg_class);
     data_server_write_register_id_g        = PDC_data_server_write_register(*hg_class);
     server_checkpoint_rpc_register_id_g    = PDC_server_checkpoint_rpc_register(*hg_class);
+    server_metrics_rpc_register_id_g       = PDC_server_metrics_rpc_register(*hg_class);
     send_shm_register_id_g                 = PDC_send_shm_register(*hg_class);
 
     // bulk
@@ -1320,7 +1631,6 @@ drc_access_again:
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1329,11 +1639,14 @@ PDC_Client_init()
 {
     perr_t ret_value  = SUCCEED;
     pdc_server_info_g = NULL;
-    char *   tmp_dir;
-    uint32_t port;
-    int      is_mpi_init = 0;
+    char *         tmp_dir, *progress_env, *inline_env;
+    uint32_t       port;
+    int            is_mpi_init = 0;
+    struct timeval init_start, addr_end, init_end;
 
     FUNC_ENTER(NULL);
+
+    gettimeofday(&init_start, 0);
     // Get up tmp dir env var
     tmp_dir = getenv("PDC_TMPDIR");
     if (tmp_dir == NULL)
@@ -1362,7 +1675,17 @@ PDC_Client_init()
     MPI_Comm_size(PDC_CLIENT_COMM_WORLD_g, &pdc_client_mpi_size_g);
     // printf("my client rank = %d, client communicator size = %d\n", pdc_client_mpi_rank_g,
     // pdc_client_mpi_size_g);
+
+    // Split the PDC_CLIENT_COMM_WORLD_g communicator, MPI_Comm_split_type requires MPI-3
+    MPI_Comm_split_type(PDC_CLIENT_COMM_WORLD_g, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                        &PDC_SAME_NODE_COMM_g);
+
+    MPI_Comm_rank(PDC_SAME_NODE_COMM_g, &pdc_client_same_node_rank_g);
+    MPI_Comm_size(PDC_SAME_NODE_COMM_g, &pdc_client_same_node_size_g);
+
+    pdc_nclient_per_server_g = pdc_client_same_node_size_g;
 #endif
+    PDC_log_init("PDC_CLIENT", pdc_client_mpi_rank_g);
 
     if (pdc_client_mpi_rank_g == 0)
         printf("==PDC_CLIENT: PDC_DEBUG set to %d!\n", is_client_debug_g);
@@ -1372,17 +1695,8 @@ PDC_Client_init()
         printf("==PDC_CLIENT[%d]: Error getting PDC Metadata servers info, exiting ...", pdc_server_num_g);
         exit(0);
     }
+    gettimeofday(&addr_end, 0);
 
-#ifdef ENABLE_MPI
-    // Split the PDC_CLIENT_COMM_WORLD_g communicator, MPI_Comm_split_type requires MPI-3
-    MPI_Comm_split_type(PDC_CLIENT_COMM_WORLD_g, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
-                        &PDC_SAME_NODE_COMM_g);
-
-    MPI_Comm_rank(PDC_SAME_NODE_COMM_g, &pdc_client_same_node_rank_g);
-    MPI_Comm_size(PDC_SAME_NODE_COMM_g, &pdc_client_same_node_size_g);
-
-    pdc_nclient_per_server_g = pdc_client_same_node_size_g;
-#endif
     // Get the number of clients per server(node) through environment variable
     tmp_dir = getenv("PDC_NCLIENT_PER_SERVER");
     if (tmp_dir == NULL)
@@ -1419,15 +1733,37 @@ PDC_Client_init()
         mercury_has_init_g = 1;
     }
 
+    // Transfer requests return once posted and complete in the background
+    progress_env = getenv("PDC_CLIENT_PROGRESS_THREAD");
+    if (progress_env != NULL && atoi(progress_env) > 0 && progress_thread_enabled_g == 0) {
+        progress_thread_stop_g = 0;
+        if (pthread_create(&progress_thread_g, NULL, PDC_Client_progress_thread, NULL) == 0)
+            progress_thread_enabled_g = 1;
+        else
+            printf("==PDC_CLIENT[%d]: could not start the progress thread\n", pdc_client_mpi_rank_g);
+    }
+
+    inline_env = getenv("PDC_OBJ_INLINE_SIZE");
+    if (inline_env != NULL)
+        pdc_obj_inline_size_g = strtoull(inline_env, NULL, 10);
+
     if (pdc_client_mpi_rank_g == 0) {
+        if (progress_thread_enabled_g)
+            printf("==PDC_CLIENT[%d]: progress thread enabled\n", pdc_client_mpi_rank_g);
+        if (pdc_obj_inline_size_g != PDC_OBJ_INLINE_SIZE_DEFAULT)
+            printf("==PDC_CLIENT[%d]: objects up to %" PRIu64 " bytes are sent inline\n",
+                   pdc_client_mpi_rank_g, pdc_obj_inline_size_g);
         printf("==PDC_CLIENT[%d]: using [%s] as tmp dir, %d clients per server\n", pdc_client_mpi_rank_g,
                pdc_client_tmp_dir_g, pdc_nclient_per_server_g);
+        gettimeofday(&init_end, 0);
+        printf("==PDC_CLIENT[%d]: client init took %.3f ms, %.3f ms to get the server addrs\n",
+               pdc_client_mpi_rank_g, PDC_get_elapsed_time_double(&init_start, &init_end) * 1000,
+               PDC_get_elapsed_time_double(&init_start, &addr_end) * 1000);
     }
 
     srand(time(NULL));
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1461,6 +1797,17 @@ PDC_Client_finalize()
 
     FUNC_ENTER(NULL);
 
+    if (progress_thread_enabled_g) {
+        // Posted requests must get their reply before the context is destroyed
+        PDC_Client_transfer_request_wait_posted(&progress_todo_g);
+        pthread_mutex_lock(&progress_mutex_g);
+        progress_thread_stop_g = 1;
+        pthread_cond_signal(&progress_cond_g);
+        pthread_mutex_unlock(&progress_mutex_g);
+        pthread_join(progress_thread_g, NULL);
+        progress_thread_enabled_g = 0;
+    }
+
     // Finalize Mercury
     for (i = 0; i < pdc_server_num_g; i++) {
         if (pdc_server_info_g[i].addr_valid) {
@@ -1495,7 +1842,7 @@ PDC_Client_finalize()
     /*     PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error with HG_Finalize", pdc_client_mpi_rank_g); */
 
 done:
-    fflush(stdout);
+    PDC_log_finalize();
     FUNC_LEAVE(ret_value);
 }
 
@@ -1565,7 +1912,6 @@ metadata_query_bulk_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->meta_arr = bulk_args->meta_arr;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1692,7 +2038,6 @@ PDC_partial_query(int is_list_all, int user_id, const char *app_name, const char
 
     // TODO: need to be careful when freeing the lookup_args, as it include the results returned to user
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1776,7 +2121,6 @@ PDC_Client_query_tag(const char *tags, int *n_res, pdc_metadata_t ***out)
 
     // TODO: need to be careful when freeing the lookup_args, as it include the results returned to user
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1816,7 +2160,6 @@ metadata_query_rpc_cb(const struct hg_cb_info *callback_info)
     }
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1848,7 +2191,6 @@ metadata_delete_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1878,7 +2220,6 @@ metadata_delete_by_id_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1908,7 +2249,6 @@ metadata_add_tag_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -1962,7 +2302,6 @@ PDC_Client_add_tag(pdcid_t obj_id, const char *tag)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: - add tag NOT successful ...", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_add_tag_handle);
 
     FUNC_LEAVE(ret_value);
@@ -1994,7 +2333,6 @@ metadata_update_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -2085,7 +2423,6 @@ PDC_Client_update_metadata(pdc_metadata_t *old, pdc_metadata_t *new)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: update NOT successful ...");
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_update_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2094,18 +2431,22 @@ done:
 perr_t
 PDC_Client_delete_metadata_by_id(uint64_t obj_id)
 {
-    perr_t                         ret_value = SUCCEED;
-    hg_return_t                    hg_ret    = 0;
-    metadata_delete_by_id_in_t     in;
-    uint32_t                       server_id;
-    struct _pdc_client_lookup_args lookup_args;
-    hg_handle_t                    metadata_delete_by_id_handle;
+    perr_t                          ret_value = SUCCEED;
+    hg_return_t                     hg_ret    = 0;
+    metadata_delete_by_id_in_t      in;
+    uint32_t                        server_id;
+    struct _pdc_client_lookup_args  lookup_args;
+    hg_handle_t                     metadata_delete_by_id_handle;
+    struct _pdc_client_lookup_args *storage_args    = NULL;
+    hg_handle_t *                   storage_handles = NULL;
+    int                             i, nstorage = 0;
 
     FUNC_ENTER(NULL);
 
     // Fill input structure
-    in.obj_id = obj_id;
-    server_id = PDC_get_server_by_obj_id(obj_id, pdc_server_num_g);
+    in.obj_id       = obj_id;
+    in.storage_only = 0;
+    server_id       = PDC_get_server_by_obj_id(obj_id, pdc_server_num_g);
 
     // Debug statistics for counting number of messages sent to each server.
     if (server_id >= (uint32_t)pdc_server_num_g)
@@ -2132,9 +2473,42 @@ PDC_Client_delete_metadata_by_id(uint64_t obj_id)
     if (lookup_args.ret < 0)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: delete_by_id NOT successful ...");
 
+    // The data of the object can be stored on any server, each one drops what it has
+    storage_args    = (struct _pdc_client_lookup_args *)calloc(pdc_server_num_g, sizeof(*storage_args));
+    storage_handles = (hg_handle_t *)calloc(pdc_server_num_g, sizeof(hg_handle_t));
+    if (storage_args == NULL || storage_handles == NULL)
+        PGOTO_ERROR(FAIL, "==CLIENT[%d]: cannot allocate delete requests", pdc_client_mpi_rank_g);
+    in.storage_only = 1;
+    for (i = 0; i < pdc_server_num_g; i++) {
+        if ((uint32_t)i == server_id)
+            continue;
+        if (PDC_Client_try_lookup_server(i) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
+        hg_ret = HG_Create(send_context_g, pdc_server_info_g[i].addr, metadata_delete_by_id_register_id_g,
+                           &storage_handles[nstorage]);
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "==CLIENT[%d]: Could not create handle", pdc_client_mpi_rank_g);
+        hg_ret = HG_Forward(storage_handles[nstorage], metadata_delete_by_id_rpc_cb, &storage_args[nstorage],
+                            &in);
+        nstorage++;
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "==CLIENT[%d]: Could not start HG_Forward()", pdc_client_mpi_rank_g);
+    }
+
+    work_todo_g = nstorage;
+    PDC_Client_check_response(&send_context_g);
+    for (i = 0; i < nstorage; i++) {
+        if (storage_args[i].ret < 0)
+            PGOTO_ERROR(FAIL, "==CLIENT[%d]: a server could not drop the data of object %" PRIu64,
+                        pdc_client_mpi_rank_g, obj_id);
+    }
+
 done:
-    fflush(stdout);
     HG_Destroy(metadata_delete_by_id_handle);
+    for (i = 0; i < nstorage; i++)
+        HG_Destroy(storage_handles[i]);
+    free(storage_args);
+    free(storage_handles);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2187,7 +2561,6 @@ PDC_Client_delete_metadata(char *delete_name, pdcid_t obj_delete_prop)
         printf("PDC_CLIENT: delete NOT successful ... ret_value = %d\n", lookup_args.ret);
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_delete_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2252,7 +2625,6 @@ PDC_Client_query_metadata_name_only(const char *obj_name, pdc_metadata_t **out)
     }
 
 done:
-    fflush(stdout);
     free(metadata_query_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2311,7 +2683,6 @@ PDC_Client_query_metadata_name_timestep(const char *obj_name, int time_step, pdc
     // printf("rank = %d, PDC_Client_query_metadata_name_timestep = %u\n", pdc_client_mpi_rank_g,
     // out[0]->data_server_id);
 done:
-    fflush(stdout);
     HG_Destroy(metadata_query_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2346,7 +2717,6 @@ PDC_Client_query_metadata_name_timestep_agg_same_node(const char *obj_name, int
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 #endif
@@ -2377,7 +2747,6 @@ PDC_Client_query_metadata_name_timestep_agg(const char *obj_name, int time_step,
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2392,6 +2761,7 @@ PDC_Client_create_cont_id(const char *cont_name, pdcid_t cont_create_prop ATTRIB
     uint32_t                       hash_name_value;
     struct _pdc_client_lookup_args lookup_args;
     hg_handle_t                    rpc_handle;
+    uint64_t                       metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 
@@ -2445,9 +2815,9 @@ PDC_Client_create_cont_id(const char *cont_name, pdcid_t cont_create_prop ATTRIB
     pdc_timings.PDCclient_cont_create_rpc += end - start;
     pdc_timestamp_register(pdc_client_create_cont_timestamps, function_start, end);
 #endif
+    PDC_metrics_record(PDC_METRIC_CLIENT_CONT_CREATE, metrics_start, 0);
 
 done:
-    fflush(stdout);
     HG_Destroy(rpc_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2531,13 +2901,60 @@ PDC_Client_obj_reset_dims(const char *obj_name, int time_step, int ndim, uint64_
     // printf("rank = %d, PDC_Client_query_metadata_name_timestep = %u\n", pdc_client_mpi_rank_g,
     // out[0]->data_server_id);
 done:
-    fflush(stdout);
     HG_Destroy(obj_reset_dims_handle);
 
     FUNC_LEAVE(ret_value);
 }
 
 // Send a name to server and receive an obj id
+/*
+ * Fill the object creation input from the object property
+ *
+ * \param obj_name [IN]         Name of the object
+ * \param cont_id [IN]          Container ID (obtained from metadata server)
+ * \param create_prop [IN]      Object property
+ * \param in [OUT]              Input structure to fill
+ */
+static void
+PDC_Client_fill_obj_create_input(const char *obj_name, uint64_t cont_id, struct _pdc_obj_prop *create_prop,
+                                 gen_obj_id_in_t *in)
+{
+    memset(in, 0, sizeof(*in));
+    in->data.obj_name         = obj_name;
+    in->data.cont_id          = cont_id;
+    in->data.time_step        = create_prop->time_step;
+    in->data.user_id          = create_prop->user_id;
+    in->data_type             = create_prop->obj_prop_pub->type;
+    in->data.data_server_id   = PDC_CLIENT_DATA_SERVER();
+    in->data.region_partition = create_prop->obj_prop_pub->region_partition;
+
+    if ((in->data.ndim = create_prop->obj_prop_pub->ndim) > 0) {
+        if (in->data.ndim >= 1)
+            in->data.dims0 = create_prop->obj_prop_pub->dims[0];
+        if (in->data.ndim >= 2)
+            in->data.dims1 = create_prop->obj_prop_pub->dims[1];
+        if (in->data.ndim >= 3)
+            in->data.dims2 = create_prop->obj_prop_pub->dims[2];
+        if (in->data.ndim >= 4)
+            in->data.dims3 = create_prop->obj_prop_pub->dims[3];
+    }
+
+    if (create_prop->tags == NULL)
+        in->data.tags = " ";
+    else
+        in->data.tags = create_prop->tags;
+
+    if (create_prop->app_name == NULL)
+        in->data.app_name = "Noname";
+    else
+        in->data.app_name = create_prop->app_name;
+
+    if (create_prop->data_loc == NULL)
+        in->data.data_location = " ";
+    else
+        in->data.data_location = create_prop->data_loc;
+}
+
 perr_t
 PDC_Client_send_name_recv_id(const char *obj_name, uint64_t cont_id, pdcid_t obj_create_prop,
                              pdcid_t *meta_id, uint32_t *data_server_id, uint32_t *metadata_server_id)
@@ -2550,6 +2967,7 @@ PDC_Client_send_name_recv_id(const char *obj_name, uint64_t cont_id, pdcid_t obj
     uint32_t                       hash_name_value;
     struct _pdc_client_lookup_args lookup_args;
     hg_handle_t                    rpc_handle;
+    uint64_t                       metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 
@@ -2564,46 +2982,8 @@ PDC_Client_send_name_recv_id(const char *obj_name, uint64_t cont_id, pdcid_t obj
         PGOTO_ERROR(FAIL, "Cannot create object with empty object name");
 
     // Fill input structure
-    memset(&in, 0, sizeof(in));
-    in.data.obj_name         = obj_name;
-    in.data.cont_id          = cont_id;
-    in.data.time_step        = create_prop->time_step;
-    in.data.user_id          = create_prop->user_id;
-    in.data_type             = create_prop->obj_prop_pub->type;
-    in.data.data_server_id   = PDC_CLIENT_DATA_SERVER();
-    in.data.region_partition = create_prop->obj_prop_pub->region_partition;
-    // printf("prepare for sending region partition %d with obj name %s\n", (int)in.data.region_partition,
-    // obj_name);
+    PDC_Client_fill_obj_create_input(obj_name, cont_id, create_prop, &in);
     *data_server_id = in.data.data_server_id;
-    // printf("pdc_client_mpi_rank_g = %d, pdc_nclient_per_server_g = %d, pdc_server_num_g = %d,
-    // data_server_id = %u\n", (int)pdc_client_mpi_rank_g, (int)pdc_nclient_per_server_g,
-    // (int)pdc_server_num_g, (unsigned)in.data.data_server_id);
-
-    if ((in.data.ndim = create_prop->obj_prop_pub->ndim) > 0) {
-        if (in.data.ndim >= 1)
-            in.data.dims0 = create_prop->obj_prop_pub->dims[0];
-        if (in.data.ndim >= 2)
-            in.data.dims1 = create_prop->obj_prop_pub->dims[1];
-        if (in.data.ndim >= 3)
-            in.data.dims2 = create_prop->obj_prop_pub->dims[2];
-        if (in.data.ndim >= 4)
-            in.data.dims3 = create_prop->obj_prop_pub->dims[3];
-    }
-
-    if (create_prop->tags == NULL)
-        in.data.tags = " ";
-    else
-        in.data.tags = create_prop->tags;
-
-    if (create_prop->app_name == NULL)
-        in.data.app_name = "Noname";
-    else
-        in.data.app_name = create_prop->app_name;
-
-    if (create_prop->data_loc == NULL)
-        in.data.data_location = " ";
-    else
-        in.data.data_location = create_prop->data_loc;
 
     hash_name_value = PDC_get_hash_by_name(obj_name);
     in.hash_value   = hash_name_value;
@@ -2651,9 +3031,9 @@ PDC_Client_send_name_recv_id(const char *obj_name, uint64_t cont_id, pdcid_t obj
     pdc_timings.PDCclient_obj_create_rpc += end - start;
     pdc_timestamp_register(pdc_client_create_obj_timestamps, function_start, end);
 #endif
+    PDC_metrics_record(PDC_METRIC_CLIENT_OBJ_CREATE, metrics_start, 0);
 
 done:
-    fflush(stdout);
     if (create_prop)
         PDC_obj_prop_free(create_prop);
     HG_Destroy(rpc_handle);
@@ -2661,6 +3041,333 @@ done:
     FUNC_LEAVE(ret_value);
 }
 
+uint64_t
+PDC_Client_get_obj_inline_size()
+{
+    return pdc_obj_inline_size_g;
+}
+
+perr_t
+PDC_Client_obj_put_data(const char *obj_name, uint64_t cont_id, pdcid_t obj_create_prop, void *data,
+                        uint64_t size, pdcid_t *meta_id, uint32_t *server_id)
+{
+    perr_t                         ret_value = SUCCEED;
+    hg_return_t                    hg_ret;
+    struct _pdc_obj_prop *         create_prop = NULL;
+    obj_put_data_in_t              in;
+    struct _pdc_client_lookup_args lookup_args;
+    hg_handle_t                    rpc_handle    = NULL;
+    uint64_t                       metrics_start = PDC_metrics_now();
+
+    FUNC_ENTER(NULL);
+
+    if (obj_name == NULL)
+        PGOTO_ERROR(FAIL, "Cannot create object with empty object name");
+
+    create_prop = PDC_obj_prop_get_info(obj_create_prop);
+
+    PDC_Client_fill_obj_create_input(obj_name, cont_id, create_prop, &in.obj);
+    in.obj.hash_value = PDC_get_hash_by_name(obj_name);
+    in.unit           = PDC_get_var_type_size(create_prop->obj_prop_pub->type);
+    in.size           = size;
+    in.data           = data;
+
+    // Same metadata server as PDC_Client_send_name_recv_id, the data is stored there too
+    *server_id                   = (in.obj.hash_value + in.obj.data.time_step) % pdc_server_num_g;
+    in.obj.data.data_server_id   = *server_id;
+    in.obj.data.region_partition = PDC_OBJ_STATIC;
+
+    debug_server_id_count[*server_id]++;
+
+    if (PDC_Client_try_lookup_server(*server_id) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
+
+    hg_ret = HG_Create(send_context_g, pdc_server_info_g[*server_id].addr, obj_put_data_register_id_g,
+                       &rpc_handle);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "PDC_Client_obj_put_data(): Could not create handle");
+
+    hg_ret = HG_Forward(rpc_handle, client_rpc_cb, &lookup_args, &in);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "PDC_Client_obj_put_data(): Could not start HG_Forward()");
+
+    work_todo_g = 1;
+    PDC_Client_check_response(&send_context_g);
+
+    *meta_id = lookup_args.obj_id;
+    if (lookup_args.obj_id == 0)
+        PGOTO_DONE(FAIL);
+
+    PDC_metrics_record(PDC_METRIC_CLIENT_OBJ_PUT_DATA, metrics_start, size);
+
+done:
+    if (create_prop)
+        PDC_obj_prop_free(create_prop);
+    if (rpc_handle)
+        HG_Destroy(rpc_handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
+static hg_return_t
+client_obj_get_data_rpc_cb(const struct hg_cb_info *callback_info)
+{
+    hg_return_t                    ret_value = HG_SUCCESS;
+    hg_handle_t                    handle;
+    struct _pdc_obj_get_data_args *get_args;
+    obj_get_data_out_t             output;
+
+    FUNC_ENTER(NULL);
+
+    get_args = (struct _pdc_obj_get_data_args *)callback_info->arg;
+    handle   = callback_info->info.forward.handle;
+
+    ret_value = HG_Get_output(handle, &output);
+    if (ret_value != HG_SUCCESS) {
+        get_args->ret = 0;
+        PGOTO_ERROR(ret_value, "PDC_CLIENT[%d]: client_obj_get_data_rpc_cb error with HG_Get_output",
+                    pdc_client_mpi_rank_g);
+    }
+    // Copy out before the output is freed
+    get_args->ret = output.ret;
+    if (output.ret == 1 && output.size == get_args->size)
+        memcpy(get_args->data, output.data, output.size);
+    else
+        get_args->ret = 0;
+
+done:
+    work_todo_g--;
+    HG_Free_output(handle, &output);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_obj_get_data(uint64_t obj_id, uint32_t data_server_id, uint64_t obj_dim, uint64_t unit,
+                        void *data, uint64_t size)
+{
+    perr_t                        ret_value = SUCCEED;
+    hg_return_t                   hg_ret;
+    obj_get_data_in_t             in;
+    struct _pdc_obj_get_data_args get_args;
+    hg_handle_t                   rpc_handle    = NULL;
+    uint64_t                      metrics_start = PDC_metrics_now();
+
+    FUNC_ENTER(NULL);
+
+    in.obj_id  = obj_id;
+    in.obj_dim = obj_dim;
+    in.unit    = unit;
+    in.size    = size;
+
+    get_args.ret  = 0;
+    get_args.data = data;
+    get_args.size = size * unit;
+
+    if (PDC_Client_try_lookup_server(data_server_id) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
+
+    hg_ret = HG_Create(send_context_g, pdc_server_info_g[data_server_id].addr, obj_get_data_register_id_g,
+                       &rpc_handle);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "PDC_Client_obj_get_data(): Could not create handle");
+
+    hg_ret = HG_Forward(rpc_handle, client_obj_get_data_rpc_cb, &get_args, &in);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "PDC_Client_obj_get_data(): Could not start HG_Forward()");
+
+    work_todo_g = 1;
+    PDC_Client_check_response(&send_context_g);
+
+    if (get_args.ret != 1)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error reading object %" PRIu64 " from server %u",
+                    pdc_client_mpi_rank_g, obj_id, data_server_id);
+
+    PDC_metrics_record(PDC_METRIC_CLIENT_OBJ_GET_DATA, metrics_start, get_args.size);
+
+done:
+    if (rpc_handle)
+        HG_Destroy(rpc_handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
+static hg_return_t
+client_obj_create_batch_rpc_cb(const struct hg_cb_info *callback_info)
+{
+    hg_return_t                        ret_value = HG_SUCCESS;
+    hg_handle_t                        handle;
+    struct _pdc_obj_create_batch_args *batch_args;
+    gen_obj_id_batch_out_t             output;
+
+    FUNC_ENTER(NULL);
+
+    batch_args = (struct _pdc_obj_create_batch_args *)callback_info->arg;
+    handle     = callback_info->info.forward.handle;
+
+    ret_value = HG_Get_output(handle, &output);
+    if (ret_value != HG_SUCCESS) {
+        batch_args->ret = -1;
+        PGOTO_ERROR(ret_value, "PDC_CLIENT[%d]: client_obj_create_batch_rpc_cb error with HG_Get_output",
+                    pdc_client_mpi_rank_g);
+    }
+    batch_args->ret       = output.ret;
+    batch_args->n_created = output.n_created;
+
+done:
+    work_todo_g--;
+    HG_Free_output(handle, &output);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_send_names_recv_ids(int n_objs, const char **obj_names, uint64_t cont_id, pdcid_t obj_create_prop,
+                               pdcid_t *meta_ids, uint32_t *data_server_id, uint32_t *metadata_server_ids)
+{
+    perr_t                             ret_value = SUCCEED;
+    hg_return_t                        hg_ret;
+    hg_class_t *                       hg_class;
+    struct _pdc_obj_prop *             create_prop = NULL;
+    gen_obj_id_batch_in_t              in;
+    struct _pdc_obj_create_batch_args *batch_args    = NULL;
+    hg_handle_t *                      rpc_handles   = NULL;
+    hg_bulk_t *                        bulk_handles  = NULL;
+    char **                            bufs          = NULL;
+    uint64_t *                         buf_sizes     = NULL, *name_offsets = NULL;
+    int *                              n_server_objs = NULL, *pos = NULL;
+    uint32_t *                         hash_values   = NULL, *hash_ptr;
+    uint32_t                           server_id;
+    char *                             name_ptr;
+    int                                i, n_sent = 0;
+
+    FUNC_ENTER(NULL);
+
+#ifdef PDC_TIMING
+    double start = MPI_Wtime(), end;
+#endif
+
+    if (n_objs <= 0)
+        PGOTO_DONE(SUCCEED);
+
+    create_prop = PDC_obj_prop_get_info(obj_create_prop);
+    PDC_Client_fill_obj_create_input("", cont_id, create_prop, &in.obj);
+    *data_server_id = in.obj.data.data_server_id;
+
+    hash_values   = (uint32_t *)malloc(n_objs * sizeof(uint32_t));
+    n_server_objs = (int *)calloc(pdc_server_num_g, sizeof(int));
+    pos           = (int *)calloc(pdc_server_num_g, sizeof(int));
+    buf_sizes     = (uint64_t *)calloc(pdc_server_num_g, sizeof(uint64_t));
+    name_offsets  = (uint64_t *)calloc(pdc_server_num_g, sizeof(uint64_t));
+    bufs          = (char **)calloc(pdc_server_num_g, sizeof(char *));
+    rpc_handles   = (hg_handle_t *)calloc(pdc_server_num_g, sizeof(hg_handle_t));
+    bulk_handles  = (hg_bulk_t *)calloc(pdc_server_num_g, sizeof(hg_bulk_t));
+    batch_args    = (struct _pdc_obj_create_batch_args *)calloc(pdc_server_num_g, sizeof(*batch_args));
+
+    // Group the names by metadata server, the same way PDC_Client_send_name_recv_id picks the server
+    for (i = 0; i < n_objs; i++) {
+        if (obj_names[i] == NULL)
+            PGOTO_ERROR(FAIL, "Cannot create object with empty object name");
+        hash_values[i]         = PDC_get_hash_by_name(obj_names[i]);
+        server_id              = (hash_values[i] + in.obj.data.time_step) % pdc_server_num_g;
+        metadata_server_ids[i] = server_id;
+        meta_ids[i]            = 0;
+        n_server_objs[server_id]++;
+        buf_sizes[server_id] += sizeof(uint64_t) + sizeof(uint32_t) + strlen(obj_names[i]) + 1;
+    }
+
+    // Each buffer has the object IDs, then the hash values, then the names
+    for (server_id = 0; server_id < (uint32_t)pdc_server_num_g; server_id++) {
+        if (n_server_objs[server_id] > 0)
+            bufs[server_id] = (char *)calloc(1, buf_sizes[server_id]);
+    }
+    for (i = 0; i < n_objs; i++) {
+        server_id = metadata_server_ids[i];
+        hash_ptr  = (uint32_t *)(bufs[server_id] + n_server_objs[server_id] * sizeof(uint64_t));
+        name_ptr  = bufs[server_id] + n_server_objs[server_id] * (sizeof(uint64_t) + sizeof(uint32_t));
+        hash_ptr[pos[server_id]] = hash_values[i];
+        strcpy(name_ptr + name_offsets[server_id], obj_names[i]);
+        name_offsets[server_id] += strlen(obj_names[i]) + 1;
+        pos[server_id]++;
+    }
+
+    // Send one RPC per server and wait for all of them
+    hg_class = HG_Context_get_class(send_context_g);
+    for (server_id = 0; server_id < (uint32_t)pdc_server_num_g; server_id++) {
+        if (n_server_objs[server_id] == 0)
+            continue;
+        debug_server_id_count[server_id]++;
+
+        if (PDC_Client_try_lookup_server(server_id) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
+
+        in.n_objs         = n_server_objs[server_id];
+        in.total_buf_size = buf_sizes[server_id];
+        hg_ret = HG_Bulk_create(hg_class, 1, (void **)&bufs[server_id], (hg_size_t *)&in.total_buf_size,
+                                HG_BULK_READWRITE, &bulk_handles[server_id]);
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "PDC_Client_send_names_recv_ids(): Could not create bulk data handle");
+        in.bulk_handle = bulk_handles[server_id];
+
+        hg_ret = HG_Create(send_context_g, pdc_server_info_g[server_id].addr, gen_obj_batch_register_id_g,
+                           &rpc_handles[server_id]);
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "PDC_Client_send_names_recv_ids(): Could not create handle");
+        hg_ret = HG_Forward(rpc_handles[server_id], client_obj_create_batch_rpc_cb, &batch_args[server_id],
+                            &in);
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "PDC_Client_send_names_recv_ids(): Could not start HG_Forward()");
+        n_sent++;
+    }
+
+    work_todo_g = n_sent;
+    PDC_Client_check_response(&send_context_g);
+    n_sent = 0;
+
+    // The servers wrote the IDs to the front of each buffer, in the order the names were packed
+    memset(pos, 0, pdc_server_num_g * sizeof(int));
+    for (i = 0; i < n_objs; i++) {
+        server_id = metadata_server_ids[i];
+        if (batch_args[server_id].ret == 1)
+            meta_ids[i] = ((uint64_t *)bufs[server_id])[pos[server_id]];
+        pos[server_id]++;
+        if (meta_ids[i] == 0)
+            ret_value = FAIL;
+    }
+
+#ifdef PDC_TIMING
+    end = MPI_Wtime();
+    pdc_timings.PDCclient_obj_create_rpc += end - start;
+#endif
+
+done:
+    // Wait for the RPCs already sent if a later one failed
+    if (n_sent > 0) {
+        work_todo_g = n_sent;
+        PDC_Client_check_response(&send_context_g);
+    }
+    if (create_prop)
+        PDC_obj_prop_free(create_prop);
+    for (server_id = 0; rpc_handles && server_id < (uint32_t)pdc_server_num_g; server_id++) {
+        if (rpc_handles[server_id])
+            HG_Destroy(rpc_handles[server_id]);
+        if (bulk_handles[server_id])
+            HG_Bulk_free(bulk_handles[server_id]);
+        free(bufs[server_id]);
+    }
+    free(hash_values);
+    free(n_server_objs);
+    free(pos);
+    free(buf_sizes);
+    free(name_offsets);
+    free(bufs);
+    free(rpc_handles);
+    free(bulk_handles);
+    free(batch_args);
+
+    FUNC_LEAVE(ret_value);
+}
+
 perr_t
 PDC_Client_close_all_server()
 {
@@ -2740,7 +3447,6 @@ PDC_Client_close_all_server()
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2803,7 +3509,6 @@ PDC_Client_buf_unmap(pdcid_t remote_obj_id, pdcid_t remote_reg_id, struct pdc_re
         PGOTO_ERROR(FAIL, "PDC_CLIENT: buf unmap failed...");
 
 done:
-    fflush(stdout);
     HG_Destroy(client_send_buf_unmap_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2840,7 +3545,6 @@ pack_region_metadata(int ndim, uint64_t *offset, uint64_t *size, region_info_tra
         transfer->start_2 = 0;
         transfer->count_2 = 0;
     }
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2880,7 +3584,6 @@ PDC_Client_flush_obj(uint64_t obj_id)
             PGOTO_ERROR(FAIL, "PDC_Client_flush_obj(): Could not destroy handle");
     }
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2920,7 +3623,6 @@ PDC_Client_flush_obj_all()
             PGOTO_ERROR(FAIL, "PDC_Client_flush_obj_all(): Could not destroy handle");
     }
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2928,13 +3630,42 @@ perr_t
 PDC_Client_transfer_request_all(int n_objs, pdc_access_t access_type, uint32_t data_server_id, char *bulk_buf,
                                 hg_size_t bulk_size, uint64_t *metadata_id)
 {
-    perr_t                                ret_value = SUCCEED;
-    hg_return_t                           hg_ret    = HG_SUCCESS;
-    transfer_request_all_in_t             in;
-    hg_class_t *                          hg_class;
-    int                                   i;
-    hg_handle_t                           client_send_transfer_request_all_handle;
-    struct _pdc_transfer_request_all_args transfer_args;
+    perr_t                    ret_value = SUCCEED;
+    uint64_t **               metadata_id_ptr;
+    void *                    ptr = bulk_buf;
+    struct _pdc_bulk_segments bulk;
+    int                       i;
+
+    FUNC_ENTER(NULL);
+
+    bulk.count       = 1;
+    bulk.ptrs        = &ptr;
+    bulk.sizes       = &bulk_size;
+    bulk.total_size  = bulk_size;
+    bulk.header_size = 0;
+    metadata_id_ptr  = (uint64_t **)malloc(sizeof(uint64_t *) * n_objs);
+    for (i = 0; i < n_objs; i++)
+        metadata_id_ptr[i] = metadata_id + i;
+    ret_value = PDC_Client_transfer_request_all_batch(1, &n_objs, access_type, &data_server_id, &bulk,
+                                                      metadata_id_ptr, NULL, NULL);
+    free(metadata_id_ptr);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_transfer_request_all_batch(int n_server, int *n_objs, pdc_access_t access_type,
+                                      uint32_t *data_server_id, struct _pdc_bulk_segments *bulk,
+                                      uint64_t **metadata_id, int **pending, int **failed)
+{
+    perr_t                                  ret_value = SUCCEED;
+    hg_return_t                             hg_ret    = HG_SUCCESS;
+    transfer_request_all_in_t               in;
+    hg_class_t *                            hg_class;
+    int                                     i, j, k, n_posted = 0, post_only = 0;
+    struct _pdc_transfer_request_all_args **transfer_args = NULL;
+    struct _pdc_transfer_request_all_args * args;
+    uint64_t                                metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -2943,37 +3674,91 @@ PDC_Client_transfer_request_all(int n_objs, pdc_access_t access_type, uint32_t d
 #endif
     if (!(access_type == PDC_WRITE || access_type == PDC_READ)) {
         ret_value = FAIL;
-        printf("Invalid PDC type in function PDC_Client_transfer_request_all @ %d\n", __LINE__);
+        printf("Invalid PDC type in function PDC_Client_transfer_request_all_batch @ %d\n", __LINE__);
         goto done;
     }
-    in.n_objs         = n_objs;
-    in.access_type    = access_type;
-    in.total_buf_size = bulk_size;
-
-    // Compute metadata server id
-    // meta_server_id    = PDC_get_server_by_obj_id(obj_id[0], pdc_server_num_g);
+    if (n_server <= 0)
+        PGOTO_DONE(SUCCEED);
 
-    debug_server_id_count[data_server_id]++;
+    // With the progress thread running, return once everything is posted, the reply callbacks finish
+    post_only     = pending != NULL && progress_thread_enabled_g;
+    transfer_args = (struct _pdc_transfer_request_all_args **)calloc(n_server, sizeof(*transfer_args));
+    if (transfer_args == NULL)
+        PGOTO_ERROR(FAIL, "PDC_Client_transfer_request_all_batch(): Could not allocate %d handles", n_server);
 
     hg_class = HG_Context_get_class(send_context_g);
 
-    if (PDC_Client_try_lookup_server(data_server_id) != SUCCEED)
-        PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server @ line %d",
-                    pdc_client_mpi_rank_g, __LINE__);
+    // Forward to every server before waiting, so the servers pull their bulk data concurrently and the
+    // whole batch costs about one round trip
+    for (i = 0, k = 0; i < n_server; k += n_objs[i], i++) {
+        args = (struct _pdc_transfer_request_all_args *)malloc(
+            sizeof(*args) + (sizeof(uint64_t *) + sizeof(int *) * 2) * n_objs[i]);
+        if (args == NULL) {
+            printf("PDC_Client_transfer_request_all_batch(): Could not allocate args @ line %d\n", __LINE__);
+            ret_value = FAIL;
+            break;
+        }
+        transfer_args[i]      = args;
+        args->ret             = -1;
+        args->n_objs          = n_objs[i];
+        args->data_server_id  = data_server_id[i];
+        args->size            = bulk[i].total_size;
+        args->metrics_start   = metrics_start;
+        args->metadata_id_ptr = (uint64_t **)(args + 1);
+        args->pending         = NULL;
+        args->failed          = NULL;
+        memcpy(args->metadata_id_ptr, metadata_id + k, sizeof(uint64_t *) * n_objs[i]);
+        if (post_only) {
+            args->pending = (int **)(args->metadata_id_ptr + n_objs[i]);
+            args->failed  = args->pending + n_objs[i];
+            memcpy(args->pending, pending + k, sizeof(int *) * n_objs[i]);
+            memcpy(args->failed, failed + k, sizeof(int *) * n_objs[i]);
+        }
 
-    hg_ret = HG_Create(send_context_g, pdc_server_info_g[data_server_id].addr,
-                       transfer_request_all_register_id_g, &client_send_transfer_request_all_handle);
+        debug_server_id_count[data_server_id[i]]++;
 
-    // Create bulk handles
-    hg_ret = HG_Bulk_create(hg_class, 1, (void **)&bulk_buf, &bulk_size, HG_BULK_READWRITE,
-                            &(in.local_bulk_handle));
-    if (hg_ret != HG_SUCCESS)
-        PGOTO_ERROR(FAIL,
-                    "PDC_Client_transfer_request_all(): Could not create local bulk data handle @ line %d\n",
-                    __LINE__);
+        if (PDC_Client_try_lookup_server(data_server_id[i]) != SUCCEED) {
+            printf("==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server @ line %d\n", pdc_client_mpi_rank_g,
+                   __LINE__);
+            ret_value = FAIL;
+            break;
+        }
 
-    hg_ret = HG_Forward(client_send_transfer_request_all_handle, client_send_transfer_request_all_rpc_cb,
-                        &transfer_args, &in);
+        hg_ret = HG_Create(send_context_g, pdc_server_info_g[data_server_id[i]].addr,
+                           transfer_request_all_register_id_g, &args->handle);
+        if (hg_ret != HG_SUCCESS) {
+            printf("PDC_Client_transfer_request_all_batch(): Could not create handle @ line %d\n", __LINE__);
+            ret_value = FAIL;
+            break;
+        }
+
+        in.n_objs         = n_objs[i];
+        in.access_type    = access_type;
+        in.total_buf_size = bulk[i].total_size;
+        in.header_size    = bulk[i].header_size;
+
+        // Create bulk handles, the server pulls all segments into one contiguous buffer
+        hg_ret = HG_Bulk_create(hg_class, bulk[i].count, bulk[i].ptrs, bulk[i].sizes, HG_BULK_READWRITE,
+                                &(in.local_bulk_handle));
+        if (hg_ret != HG_SUCCESS) {
+            printf("PDC_Client_transfer_request_all_batch(): Could not create local bulk data handle @ line "
+                   "%d\n",
+                   __LINE__);
+            HG_Destroy(args->handle);
+            ret_value = FAIL;
+            break;
+        }
+
+        hg_ret = HG_Forward(args->handle, client_send_transfer_request_all_rpc_cb, args, &in);
+        if (hg_ret != HG_SUCCESS) {
+            printf("PDC_Client_transfer_request_all_batch(): Could not start HG_Forward() @ line %d\n",
+                   __LINE__);
+            HG_Destroy(args->handle);
+            ret_value = FAIL;
+            break;
+        }
+        n_posted++;
+    }
 #ifdef PDC_TIMING
     if (access_type == PDC_READ) {
         pdc_timings.PDCtransfer_request_start_all_read_rpc += MPI_Wtime() - start;
@@ -2984,11 +3769,25 @@ PDC_Client_transfer_request_all(int n_objs, pdc_access_t access_type, uint32_t d
     start = MPI_Wtime();
 #endif
 
-    if (hg_ret != HG_SUCCESS)
-        PGOTO_ERROR(FAIL, "PDC_Client_send_transfer_request_all(): Could not start HG_Forward() @ line %d\n",
-                    __LINE__);
-    work_todo_g = 1;
-    PDC_Client_check_response(&send_context_g);
+    // The requests of a server that was not posted to are failed, they are reported by their wait
+    if (post_only) {
+        for (i = 0, k = 0; i < n_server; k += n_objs[i], i++) {
+            for (j = 0; j < n_objs[i]; j++) {
+                if (i < n_posted)
+                    (*pending[k + j])++;
+                else
+                    (*failed[k + j])++;
+            }
+        }
+        PDC_Client_progress_add(n_posted);
+        PGOTO_DONE(ret_value);
+    }
+
+    // Each callback decrements the counter, the forwards already posted are drained even after a failure
+    if (n_posted > 0) {
+        work_todo_g = n_posted;
+        PDC_Client_check_response(&send_context_g);
+    }
 
 #ifdef PDC_TIMING
     end = MPI_Wtime();
@@ -3001,19 +3800,20 @@ PDC_Client_transfer_request_all(int n_objs, pdc_access_t access_type, uint32_t d
         pdc_timestamp_register(pdc_client_transfer_request_start_all_write_timestamps, function_start, end);
     }
 #endif
-    /*
-        printf("PDC_Client_transfer_request() checkpoint, first value is %d @ line %d\n", ((int *)buf)[0],
-               __LINE__);
-    */
-    for (i = 0; i < n_objs; ++i) {
-        metadata_id[i] = transfer_args.metadata_id + i;
+    for (i = 0, k = 0; i < n_server; k += n_objs[i], i++) {
+        if (i < n_posted && PDC_Client_transfer_request_all_finish(transfer_args[i]) == SUCCEED)
+            continue;
+        ret_value = FAIL;
+        for (j = 0; failed != NULL && j < n_objs[i]; j++)
+            (*failed[k + j])++;
     }
-    if (transfer_args.ret != 1)
-        PGOTO_ERROR(FAIL, "PDC_CLIENT: transfer request failed... @ line %d\n", __LINE__);
-
-    HG_Destroy(client_send_transfer_request_all_handle);
 done:
-    fflush(stdout);
+    if (transfer_args != NULL) {
+        // Posted requests are freed by their reply callback
+        for (i = post_only ? n_posted : 0; i < n_server; i++)
+            free(transfer_args[i]);
+        free(transfer_args);
+    }
     FUNC_LEAVE(ret_value);
 }
 
@@ -3083,7 +3883,6 @@ PDC_Client_transfer_request_metadata_query2(char *buf, uint64_t total_buf_size,
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3157,7 +3956,6 @@ PDC_Client_transfer_request_metadata_query(char *buf, uint64_t total_buf_size, i
     // fprintf(stderr, "PDC_Client_transfer_request_metadata_query: checkpoint %d\n", __LINE__);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3170,6 +3968,8 @@ PDC_Client_transfer_request_wait_all(int n_objs, pdcid_t *transfer_request_id, u
     hg_class_t *                               hg_class;
     hg_handle_t                                client_send_transfer_request_wait_all_handle;
     struct _pdc_transfer_request_wait_all_args transfer_args;
+    uint64_t                                   metrics_start = PDC_metrics_now();
+    int                                        i;
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -3224,6 +4024,9 @@ PDC_Client_transfer_request_wait_all(int n_objs, pdcid_t *transfer_request_id, u
     */
     if (transfer_args.ret != 1)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: transfer request wait all failed... @ line %d\n", __LINE__);
+    for (i = 0; i < n_objs; ++i)
+        PDC_PROFILE_FLOW("transfer_request", PDC_TRANSFER_FLOW_ID(data_server_id, transfer_request_id[i]),
+                         'f');
 
     HG_Destroy(client_send_transfer_request_wait_all_handle);
 
@@ -3232,9 +4035,9 @@ PDC_Client_transfer_request_wait_all(int n_objs, pdcid_t *transfer_request_id, u
     pdc_timings.PDCtransfer_request_wait_all_rpc_wait += end - start;
     pdc_timestamp_register(pdc_client_transfer_request_wait_all_timestamps, function_start, end);
 #endif
+    PDC_metrics_record(PDC_METRIC_CLIENT_TRANSFER_REQUEST_WAIT_ALL, metrics_start, 0);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3242,17 +4045,19 @@ perr_t
 PDC_Client_transfer_request(void *buf, pdcid_t obj_id, uint32_t data_server_id, int obj_ndim,
                             uint64_t *obj_dims, int remote_ndim, uint64_t *remote_offset,
                             uint64_t *remote_size, size_t unit, pdc_access_t access_type,
-                            pdcid_t *metadata_id)
+                            pdcid_t *metadata_id, int *pending, int *failed)
 {
-    perr_t                            ret_value = SUCCEED;
-    hg_return_t                       hg_ret    = HG_SUCCESS;
-    transfer_request_in_t             in;
-    hg_class_t *                      hg_class;
-    uint32_t                          meta_server_id;
-    hg_size_t                         total_data_size;
-    int                               i;
-    hg_handle_t                       client_send_transfer_request_handle;
-    struct _pdc_transfer_request_args transfer_args;
+    perr_t                             ret_value = SUCCEED;
+    hg_return_t                        hg_ret    = HG_SUCCESS;
+    transfer_request_in_t              in;
+    hg_class_t *                       hg_class;
+    uint32_t                           meta_server_id;
+    hg_size_t                          total_data_size;
+    int                                i;
+    hg_handle_t                        client_send_transfer_request_handle;
+    struct _pdc_transfer_request_args  transfer_args;
+    struct _pdc_transfer_request_args *args          = &transfer_args;
+    uint64_t                           metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -3313,8 +4118,23 @@ PDC_Client_transfer_request(void *buf, pdcid_t obj_id, uint32_t data_server_id,
                     "PDC_Client_transfer_request(): Could not create local bulk data handle @ line %d\n",
                     __LINE__);
 
-    hg_ret = HG_Forward(client_send_transfer_request_handle, client_send_transfer_request_rpc_cb,
-                        &transfer_args, &in);
+    // With the progress thread running, return once the request is posted, the reply callback finishes it
+    if (pending != NULL && progress_thread_enabled_g) {
+        args = (struct _pdc_transfer_request_args *)malloc(sizeof(struct _pdc_transfer_request_args));
+        args->pending         = pending;
+        args->failed          = failed;
+        args->metadata_id_ptr = metadata_id;
+        args->handle          = client_send_transfer_request_handle;
+        args->data_server_id  = data_server_id;
+        args->access_type     = access_type;
+        args->size            = total_data_size;
+        args->metrics_start   = metrics_start;
+    }
+    else
+        args->pending = NULL;
+    args->ret = -1;
+
+    hg_ret = HG_Forward(client_send_transfer_request_handle, client_send_transfer_request_rpc_cb, args, &in);
 
 #ifdef PDC_TIMING
     if (access_type == PDC_READ) {
@@ -3326,9 +4146,17 @@ PDC_Client_transfer_request(void *buf, pdcid_t obj_id, uint32_t data_server_id,
     start = MPI_Wtime();
 #endif
 
-    if (hg_ret != HG_SUCCESS)
+    if (hg_ret != HG_SUCCESS) {
+        if (args != &transfer_args)
+            free(args);
         PGOTO_ERROR(FAIL, "PDC_Client_send_transfer_request(): Could not start HG_Forward() @ line %d\n",
                     __LINE__);
+    }
+    if (args != &transfer_args) {
+        (*pending)++;
+        PDC_Client_progress_add(1);
+        PGOTO_DONE(SUCCEED);
+    }
     work_todo_g = 1;
     PDC_Client_check_response(&send_context_g);
 
@@ -3344,13 +4172,16 @@ PDC_Client_transfer_request(void *buf, pdcid_t obj_id, uint32_t data_server_id,
     }
 #endif
     *metadata_id = transfer_args.metadata_id;
+    PDC_PROFILE_FLOW("transfer_request", PDC_TRANSFER_FLOW_ID(data_server_id, *metadata_id), 't');
 
     if (transfer_args.ret != 1)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: transfer request failed... @ line %d\n", __LINE__);
 
     HG_Destroy(client_send_transfer_request_handle);
+    PDC_metrics_record(access_type == PDC_READ ? PDC_METRIC_CLIENT_TRANSFER_REQUEST_READ
+                                               : PDC_METRIC_CLIENT_TRANSFER_REQUEST_WRITE,
+                       metrics_start, total_data_size);
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3394,7 +4225,6 @@ PDC_Client_transfer_request_status(pdcid_t transfer_request_id, uint32_t data_se
     HG_Destroy(client_send_transfer_request_status_handle);
     *completed = transfer_args.status;
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3407,6 +4237,7 @@ PDC_Client_transfer_request_wait(pdcid_t transfer_request_id, uint32_t data_serv
     transfer_request_wait_in_t             in;
     hg_handle_t                            client_send_transfer_request_wait_handle;
     struct _pdc_transfer_request_wait_args transfer_args;
+    uint64_t                               metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -3464,11 +4295,12 @@ PDC_Client_transfer_request_wait(pdcid_t transfer_request_id, uint32_t data_serv
 
     if (transfer_args.ret != 1)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: transfer request failed... @ line %d\n", __LINE__);
+    PDC_PROFILE_FLOW("transfer_request", PDC_TRANSFER_FLOW_ID(data_server_id, transfer_request_id), 'f');
 
     HG_Destroy(client_send_transfer_request_wait_handle);
+    PDC_metrics_record(PDC_METRIC_CLIENT_TRANSFER_REQUEST_WAIT, metrics_start, 0);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3634,7 +4466,6 @@ PDC_Client_buf_map(pdcid_t local_region_id, pdcid_t remote_obj_id, size_t ndim,
         PGOTO_ERROR(FAIL, "PDC_CLIENT: buf map failed...");
 
 done:
-    fflush(stdout);
     free(data_ptrs);
     free(data_size);
     HG_Destroy(client_send_buf_map_handle);
@@ -3730,7 +4561,6 @@ PDC_Client_region_lock(pdcid_t remote_obj_id, struct _pdc_obj_info *object_info,
     }
 
 done:
-    fflush(stdout);
     HG_Destroy(region_lock_handle);
 
     FUNC_LEAVE(ret_value);
@@ -3840,7 +4670,6 @@ done:
     if (region_release_handle != HG_HANDLE_NULL)
         HG_Destroy(region_release_handle);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3929,7 +4758,6 @@ pdc_region_release_with_server_analysis(struct _pdc_obj_info *  object_info,
     }
 
 done:
-    fflush(stdout);
     if (region_release_handle != HG_HANDLE_NULL)
         HG_Destroy(region_release_handle);
 
@@ -4056,7 +4884,6 @@ done:
     if (region_release_handle != HG_HANDLE_NULL)
         HG_Destroy(region_release_handle);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4256,7 +5083,6 @@ maybe_run_transform(struct _pdc_obj_info *object_info, struct pdc_region_info *r
         }
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 */
@@ -4381,7 +5207,6 @@ PDC_Client_region_release(pdcid_t remote_obj_id, struct _pdc_obj_info *object_in
     }
 
 done:
-    fflush(stdout);
     if (region_release_handle != HG_HANDLE_NULL)
         HG_Destroy(region_release_handle);
 
@@ -4421,7 +5246,6 @@ data_server_read_check_rpc_cb(const struct hg_cb_info *callback_info)
         client_lookup_args->ret_string = NULL;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -4514,7 +5338,6 @@ close:
         PGOTO_ERROR(FAIL, "==PDC_CLIENT: Error removing %s", shm_addr);
 
 done:
-    fflush(stdout);
     work_todo_g--;
 
     FUNC_LEAVE(ret_value);
@@ -4627,7 +5450,6 @@ PDC_Client_data_server_read_check(int server_id, uint32_t client_id, pdc_metadat
     free(lookup_args.ret_string);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4653,7 +5475,6 @@ data_server_read_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -4723,7 +5544,6 @@ PDC_Client_data_server_read(struct pdc_request *request)
         PGOTO_ERROR(FAIL, "PDC_CLIENT: ERROR from server");
 
 done:
-    fflush(stdout);
     HG_Destroy(data_server_read_handle);
 
     FUNC_LEAVE(ret_value);
@@ -4757,8 +5577,6 @@ PDC_Client_close_shm(struct pdc_request *req)
     /*     PGOTO_ERROR(FAIL, "==PDC_CLIENT: Error removing %s", req->shm_addr); */
 
 done:
-
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4786,7 +5604,6 @@ data_server_write_check_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -4855,7 +5672,6 @@ PDC_Client_data_server_write_check(struct pdc_request *request, int *status)
     }
 
 done:
-    fflush(stdout);
     HG_Destroy(data_server_write_check_handle);
 
     FUNC_LEAVE(ret_value);
@@ -4885,7 +5701,6 @@ data_server_write_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->ret = output.ret;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -5016,7 +5831,6 @@ PDC_Client_data_server_write(struct pdc_request *request)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: ERROR from server", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5046,7 +5860,6 @@ PDC_Client_test(struct pdc_request *request, int *completed)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT: error with request access type!");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5083,7 +5896,6 @@ PDC_Client_wait(struct pdc_request *request, unsigned long max_wait_ms, unsigned
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5163,7 +5975,6 @@ PDC_Client_write(pdc_metadata_t *meta, struct pdc_region_info *region, void *buf
         PGOTO_ERROR(FAIL, "==PDC_CLIENT: PDC_Client_write - PDC_Client_wait error");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5202,7 +6013,6 @@ PDC_Client_write_id(pdcid_t local_obj_id, struct pdc_region_info *region, void *
         PGOTO_ERROR(FAIL, "==PDC_CLIENT: PDC_Client_write - PDC_Client_wait error");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5228,7 +6038,6 @@ PDC_Client_iread(pdc_metadata_t *meta, struct pdc_region_info *region, struct pd
         PGOTO_ERROR(FAIL, "==PDC_CLIENT: PDC_Client_iread- PDC_Client_data_server_read error");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5252,7 +6061,6 @@ PDC_Client_read(pdc_metadata_t *meta, struct pdc_region_info *region, void *buf)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: PDC_Client_wait error", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5280,7 +6088,6 @@ PDC_Client_write_wait_notify(pdc_metadata_t *meta, struct pdc_region_info *regio
     fflush(stdout);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5302,7 +6109,6 @@ PDC_Client_read_wait_notify(pdc_metadata_t *meta, struct pdc_region_info *region
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5334,7 +6140,6 @@ PDC_Client_add_del_objects_to_container_cb(const struct hg_cb_info *callback_inf
     HG_Destroy(cb_args->rpc_handle);
 
 done:
-    fflush(stdout);
     work_todo_g--;
 
     FUNC_LEAVE(ret_value);
@@ -5396,7 +6201,6 @@ PDC_Client_add_del_objects_to_container(int nobj, uint64_t *obj_ids, uint64_t co
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5503,7 +6307,6 @@ PDC_Client_add_tags_to_container(pdcid_t cont_id, char *tags)
     ret_value = SUCCEED;
 
 done:
-    fflush(stdout);
     HG_Destroy(rpc_handle);
 
     FUNC_LEAVE(ret_value);
@@ -5529,7 +6332,6 @@ container_query_rpc_cb(const struct hg_cb_info *callback_info)
     client_lookup_args->cont_id = output.cont_id;
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -5581,7 +6383,6 @@ PDC_Client_query_container_name(const char *cont_name, uint64_t *cont_meta_id)
     *cont_meta_id = lookup_args.cont_id;
 
 done:
-    fflush(stdout);
     HG_Destroy(container_query_handle);
 
     FUNC_LEAVE(ret_value);
@@ -5609,7 +6410,6 @@ PDC_Client_query_container_name_col(const char *cont_name, uint64_t *cont_meta_i
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5643,7 +6443,6 @@ PDC_Client_query_read_obj_name_cb(const struct hg_cb_info *callback_info)
     HG_Destroy(cb_args->rpc_handle);
 
 done:
-    fflush(stdout);
     work_todo_g--;
 
     FUNC_LEAVE(ret_value);
@@ -5663,7 +6462,6 @@ PDC_add_request_to_list(struct pdc_request **list_head, struct pdc_request *requ
     DL_PREPEND(*list_head, request);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5681,7 +6479,6 @@ PDC_del_request_from_list(struct pdc_request **list_head, struct pdc_request *re
     DL_DELETE(*list_head, request);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5701,7 +6498,6 @@ PDC_find_request_from_list_by_seq_id(struct pdc_request **list_head, int seq_id)
         ret_value = elt;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5787,7 +6583,6 @@ PDC_Client_query_name_read_entire_obj(int nobj, char **obj_names, void ***out_bu
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5857,7 +6652,6 @@ PDC_Client_complete_read_request(int nbuf, struct pdc_request *req)
     }
 
     // done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5893,7 +6687,6 @@ PDC_Client_query_read_complete(char *shm_addrs, int size, int n_shm, int seq_id)
     PDC_del_request_from_list(&pdc_io_request_list_g, request);
 
 done:
-    fflush(stdout);
     work_todo_g--;
 
     FUNC_LEAVE(ret_value);
@@ -5932,12 +6725,72 @@ PDC_Client_server_checkpoint(uint32_t server_id)
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     HG_Destroy(rpc_handle);
 
     FUNC_LEAVE(ret_value);
 }
 
+static hg_return_t
+pdc_client_server_metrics_cb(const struct hg_cb_info *callback_info)
+{
+    hg_return_t          ret_value = HG_SUCCESS;
+    char **              snapshot  = (char **)callback_info->arg;
+    hg_handle_t          handle    = callback_info->info.forward.handle;
+    server_metrics_out_t output;
+
+    FUNC_ENTER(NULL);
+
+    ret_value = HG_Get_output(handle, &output);
+    if (ret_value != HG_SUCCESS)
+        PGOTO_ERROR(ret_value, "==PDC_CLIENT[%d]: error with HG_Get_output", pdc_client_mpi_rank_g);
+
+    // The output string is freed with the output
+    *snapshot = strdup(output.snapshot);
+    HG_Free_output(handle, &output);
+
+done:
+    work_todo_g--;
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_get_server_metrics(uint32_t server_id, char **snapshot)
+{
+    perr_t         ret_value = SUCCEED;
+    hg_return_t    hg_ret;
+    pdc_int_send_t in;
+    hg_handle_t    rpc_handle = HG_HANDLE_NULL;
+
+    FUNC_ENTER(NULL);
+
+    *snapshot = NULL;
+    if (PDC_Client_try_lookup_server(server_id) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
+
+    hg_ret = HG_Create(send_context_g, pdc_server_info_g[server_id].addr, server_metrics_rpc_register_id_g,
+                       &rpc_handle);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: Could not create handle", pdc_client_mpi_rank_g);
+
+    in.origin = pdc_client_mpi_rank_g;
+    hg_ret    = HG_Forward(rpc_handle, pdc_client_server_metrics_cb, snapshot, &in);
+    if (hg_ret != HG_SUCCESS)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: Could not start forward to server", pdc_client_mpi_rank_g);
+
+    // Wait for response from server
+    work_todo_g = 1;
+    PDC_Client_check_response(&send_context_g);
+
+    if (*snapshot == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: no metrics from server %u", pdc_client_mpi_rank_g, server_id);
+
+done:
+    if (rpc_handle != HG_HANDLE_NULL)
+        HG_Destroy(rpc_handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
 perr_t
 PDC_Client_all_server_checkpoint()
 {
@@ -5957,7 +6810,6 @@ PDC_Client_all_server_checkpoint()
         ret_value = PDC_Client_server_checkpoint(i);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 /*
@@ -6028,7 +6880,6 @@ PDC_Client_send_client_shm_info(uint32_t server_id, char *shm_addr, uint64_t siz
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     HG_Destroy(rpc_handle);
 
     FUNC_LEAVE(ret_value);
@@ -6152,7 +7003,6 @@ PDC_send_region_storage_meta_shm(uint32_t server_id, int n, region_storage_meta_
     PDC_Client_check_response(&send_context_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6502,8 +7352,6 @@ PDC_Client_query_multi_storage_info(int nobj, char **obj_names, region_storage_m
     }
 
 done:
-    fflush(stdout);
-
     if (NULL != obj_names_by_server)
         free(obj_names_by_server);
     if (NULL != n_obj_name_by_server)
@@ -6604,7 +7452,6 @@ PDC_Client_query_name_read_entire_obj_client(int nobj, char **obj_names, void **
             PDC_Client_cp_data_to_local_server(nobj, all_storage_meta, out_buf, (size_t *)out_buf_sizes);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6771,7 +7618,6 @@ PDC_Client_recv_bulk_storage_meta(process_bulk_storage_meta_args_t *process_args
     ret_value = PDC_del_request_from_list(&pdc_io_request_list_g, request);
 
 done:
-    fflush(stdout);
     work_todo_g--;
 
     FUNC_LEAVE(ret_value);
@@ -6951,7 +7797,6 @@ PDC_Client_read_overlap_regions(uint32_t ndim, uint64_t *req_start, uint64_t *re
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: read size error!", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7034,7 +7879,6 @@ PDC_add_kvtag(pdcid_t obj_id, pdc_kvtag_t *kvtag, int is_cont)
         printf("PDC_CLIENT: add kvtag NOT successful ... ret_value = %d\n", lookup_args.ret);
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_add_kvtag_handle);
 
     FUNC_LEAVE(ret_value);
@@ -7065,7 +7909,6 @@ metadata_get_kvtag_rpc_cb(const struct hg_cb_info *callback_info)
     /* PDC_kvtag_dup(&(output.kvtag), &client_lookup_args->kvtag); */
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -7129,7 +7972,6 @@ PDC_get_kvtag(pdcid_t obj_id, char *tag_name, pdc_kvtag_t **kvtag, int is_cont)
         printf("PDC_CLIENT: get kvtag NOT successful ... ret_value = %d\n", lookup_args.ret);
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_get_kvtag_handle);
 
     FUNC_LEAVE(ret_value);
@@ -7178,7 +8020,6 @@ PDCtag_delete(pdcid_t obj_id, char *tag_name)
         printf("PDC_CLIENT: del kvtag NOT successful ... ret_value = %d\n", lookup_args.ret);
 
 done:
-    fflush(stdout);
     HG_Destroy(metadata_del_kvtag_handle);
 
     FUNC_LEAVE(ret_value);
@@ -7224,7 +8065,6 @@ kvtag_query_bulk_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     HG_Destroy(bulk_args->handle);
 
     FUNC_LEAVE(ret_value);
@@ -7286,7 +8126,6 @@ kvtag_query_forward_cb(const struct hg_cb_info *callback_info)
         PGOTO_ERROR(FAIL, "Could not read bulk data");
 
 done:
-    fflush(stdout);
     work_todo_g--;
     HG_Free_output(handle, &output);
 
@@ -7350,7 +8189,6 @@ PDC_Client_query_kvtag_server(uint32_t server_id, const pdc_kvtag_t *kvtag, int
     // TODO: need to be careful when freeing the lookup_args, as it include the results returned to user
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7375,7 +8213,6 @@ PDC_Client_query_kvtag(const pdc_kvtag_t *kvtag, int *n_res, uint64_t **pdc_ids)
     *n_res = nmeta;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7444,7 +8281,6 @@ PDC_Client_query_kvtag_col(const pdc_kvtag_t *kvtag, int *n_res, uint64_t **pdc_
     *n_res = nmeta;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7472,7 +8308,6 @@ PDCcont_put(const char *cont_name, pdcid_t pdc)
         PGOTO_ERROR(0, "==PDC_CLIENT[%d]: error with PDC_Client_create_cont_id", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(cont_id);
 }
 
@@ -7522,7 +8357,6 @@ PDCcont_del(pdcid_t cont_id)
                     pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7540,7 +8374,6 @@ PDCcont_put_objids(pdcid_t cont_id, int nobj, pdcid_t *obj_ids)
                     pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7557,7 +8390,6 @@ PDCcont_del_objids(pdcid_t cont_id, int nobj, pdcid_t *obj_ids)
                     pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7592,7 +8424,6 @@ PDCcont_put_tag(pdcid_t cont_id, char *tag_name, void *tag_value, psize_t value_
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: Error with PDCcont_put_tag", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7612,7 +8443,6 @@ PDCcont_get_tag(pdcid_t cont_id, char *tag_name, void **tag_value, psize_t *valu
     *value_size = kvtag->size;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7628,7 +8458,6 @@ PDCcont_del_tag(pdcid_t cont_id, char *tag_name)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error with PDCobj_del_tag", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7642,6 +8471,8 @@ PDCobj_put_data(const char *obj_name, void *data, uint64_t size, pdcid_t cont_id
     struct _pdc_cont_info *info    = NULL;
     struct _pdc_id_info *  id_info = NULL;
     pdcid_t                transfer_request;
+    pdcid_t                meta_id;
+    uint32_t               server_id;
 
     FUNC_ENTER(NULL);
 
@@ -7655,6 +8486,21 @@ PDCobj_put_data(const char *obj_name, void *data, uint64_t size, pdcid_t cont_id
     PDCprop_set_obj_user_id(obj_prop, getuid());
     PDCprop_set_obj_time_step(obj_prop, 0);
 
+    // Small objects are created and written in one round trip
+    if (size <= pdc_obj_inline_size_g) {
+        PDCprop_set_obj_transfer_region_type(obj_prop, PDC_OBJ_STATIC);
+        if (PDC_Client_obj_put_data(obj_name, info->cont_info_pub->meta_id, obj_prop, data, size, &meta_id,
+                                    &server_id) != SUCCEED)
+            PGOTO_ERROR(0, "==PDC_CLIENT[%d]: Error putting object [%s]", pdc_client_mpi_rank_g, obj_name);
+        obj_id = PDC_obj_create_with_id(cont_id, obj_name, obj_prop, meta_id, server_id, server_id);
+        if (obj_id <= 0)
+            PGOTO_ERROR(0, "==PDC_CLIENT[%d]: Error creating object [%s]", pdc_client_mpi_rank_g, obj_name);
+        if (PDCprop_close(obj_prop) != SUCCEED)
+            PGOTO_ERROR(0, "==PDC_CLIENT[%d]: Error with PDCprop_close for obj [%s]", pdc_client_mpi_rank_g,
+                        obj_name);
+        PGOTO_DONE(obj_id);
+    }
+
     obj_id = PDCobj_create(cont_id, obj_name, obj_prop);
     if (obj_id <= 0)
         PGOTO_ERROR(0, "==PDC_CLIENT[%d]: Error creating object [%s]", pdc_client_mpi_rank_g, obj_name);
@@ -7700,17 +8546,39 @@ PDCobj_put_data(const char *obj_name, void *data, uint64_t size, pdcid_t cont_id
 
     ret_value = obj_id;
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
 perr_t
 PDCobj_get_data(pdcid_t obj_id, void *data, uint64_t size)
 {
-    perr_t   ret_value = SUCCEED;
-    uint64_t offset    = 0;
-    pdcid_t  reg;
-    pdcid_t  transfer_request;
+    perr_t                ret_value = SUCCEED;
+    uint64_t              offset    = 0;
+    pdcid_t               reg;
+    pdcid_t               transfer_request;
+    struct _pdc_id_info * id_info;
+    struct _pdc_obj_info *obj;
+    struct pdc_obj_prop * prop;
+    uint64_t              unit;
+
+    FUNC_ENTER(NULL);
+
+    // Objects stored whole on one server are read in one RPC when they are small enough
+    id_info = PDC_find_id(obj_id);
+    if (id_info != NULL) {
+        obj  = (struct _pdc_obj_info *)(id_info->obj_ptr);
+        prop = obj->obj_pt->obj_prop_pub;
+        unit = PDC_get_var_type_size(prop->type);
+        if (prop->ndim == 1 && prop->region_partition == PDC_OBJ_STATIC && obj->metadata != NULL &&
+            size <= prop->dims[0] && size * unit <= pdc_obj_inline_size_g) {
+            if (obj->write_buffer != NULL)
+                PDC_region_transfer_write_buffer_flush(obj_id);
+            ret_value = PDC_Client_obj_get_data(obj->obj_info_pub->meta_id,
+                                                ((pdc_metadata_t *)obj->metadata)->data_server_id,
+                                                prop->dims[0], unit, data, size);
+            goto done;
+        }
+    }
 
     reg              = PDCregion_create(1, &offset, &size);
     transfer_request = PDCregion_transfer_create(data, PDC_READ, obj_id, reg, reg);
@@ -7737,7 +8605,6 @@ PDCobj_get_data(pdcid_t obj_id, void *data, uint64_t size)
         goto done;
     }
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7766,7 +8633,6 @@ PDC_Client_del_metadata(pdcid_t obj_id, int is_cont)
                     pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7787,7 +8653,6 @@ PDCobj_put_tag(pdcid_t obj_id, char *tag_name, void *tag_value, psize_t value_si
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: Error with PDC_add_kvtag", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7807,7 +8672,6 @@ PDCobj_get_tag(pdcid_t obj_id, char *tag_name, void **tag_value, psize_t *value_
     *value_size = kvtag->size;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7823,7 +8687,6 @@ PDCobj_del_tag(pdcid_t obj_id, char *tag_name)
         PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: Error with PDC_del_kvtag", pdc_client_mpi_rank_g);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7881,8 +8744,7 @@ PDC_recv_nhits(const struct hg_cb_info *callback_info)
 
     FUNC_ENTER(NULL);
 
-    printf("==PDC_CLIENT[%d]: %s - received %" PRIu64 " hits from server\n", pdc_client_mpi_rank_g, __func__,
-           in->nhits);
+    PDC_LOG_DEBUG("%s - received %" PRIu64 " hits from server", __func__, in->nhits);
 
     DL_FOREACH(pdcquery_result_list_head_g, result_elt)
     {
@@ -7895,13 +8757,12 @@ PDC_recv_nhits(const struct hg_cb_info *callback_info)
     work_todo_g--;
     free(in);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
-perr_t
-PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhits, pdc_selection_t *sel,
-                    void *data ATTRIBUTE(unused))
+static perr_t
+PDC_Client_send_query_to_all_servers(pdc_query_t *query, pdc_query_get_op_t get_op,
+                                     struct _pdc_query_result_list *result)
 {
     perr_t                         ret_value      = SUCCEED;
     hg_return_t                    hg_ret         = 0;
@@ -7910,7 +8771,6 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
     hg_handle_t                    handle;
     pdc_query_xfer_t *             query_xfer;
     struct _pdc_client_lookup_args lookup_args;
-    struct _pdc_query_result_list *result;
 
     FUNC_ENTER(NULL);
 
@@ -7927,7 +8787,6 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
     query_xfer->manager      = target_servers[0];
     query_xfer->get_op       = (int)get_op;
 
-    result           = (struct _pdc_query_result_list *)calloc(1, sizeof(struct _pdc_query_result_list));
     result->query_id = query_xfer->query_id;
     DL_APPEND(pdcquery_result_list_head_g, result);
 
@@ -7952,7 +8811,11 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
         if (PDC_Client_try_lookup_server(server_id) != SUCCEED)
             PGOTO_ERROR(FAIL, "==CLIENT[%d]: ERROR with PDC_Client_try_lookup_server", pdc_client_mpi_rank_g);
 
-        HG_Create(send_context_g, pdc_server_info_g[server_id].addr, send_data_query_register_id_g, &handle);
+        hg_ret = HG_Create(send_context_g, pdc_server_info_g[server_id].addr, send_data_query_register_id_g,
+                           &handle);
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: could not create handle to server %d", pdc_client_mpi_rank_g,
+                        server_id);
 
         hg_ret = HG_Forward(handle, pdc_client_check_int_ret_cb, &lookup_args, query_xfer);
         if (hg_ret != HG_SUCCESS)
@@ -7969,6 +8832,26 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
         HG_Destroy(handle);
     }
 
+done:
+    if (target_servers)
+        free(target_servers);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhits, pdc_selection_t *sel,
+                    void *data ATTRIBUTE(unused))
+{
+    perr_t                         ret_value = SUCCEED;
+    struct _pdc_query_result_list *result;
+
+    FUNC_ENTER(NULL);
+
+    result = (struct _pdc_query_result_list *)calloc(1, sizeof(struct _pdc_query_result_list));
+    if (PDC_Client_send_query_to_all_servers(query, get_op, result) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error sending query to servers", pdc_client_mpi_rank_g);
+
     // Wait for server to send query result
     work_todo_g = 1;
     PDC_Client_check_response(&send_context_g);
@@ -7976,7 +8859,7 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
     if (nhits)
         *nhits = result->nhits;
     if (sel) {
-        sel->query_id     = query_xfer->query_id;
+        sel->query_id     = result->query_id;
         sel->nhits        = result->nhits;
         sel->coords       = result->coords;
         sel->ndim         = result->ndim;
@@ -7984,10 +8867,110 @@ PDC_send_data_query(pdc_query_t *query, pdc_query_get_op_t get_op, uint64_t *nhi
     }
 
 done:
-    fflush(stdout);
-    if (target_servers)
-        free(target_servers);
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_query_get_next_batch(pdc_query_t *query, pdc_selection_t *sel)
+{
+    perr_t                         ret_value = SUCCEED;
+    hg_return_t                    hg_ret;
+    struct _pdc_query_result_list *result_elt;
+    pdc_int_ret_t                  out;
+
+    FUNC_ENTER(NULL);
+
+    if (query == NULL || sel == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: NULL input!", pdc_client_mpi_rank_g);
+
+    DL_FOREACH(pdcquery_result_list_head_g, result_elt)
+    {
+        if (result_elt->is_stream == 1 && result_elt->query == query)
+            break;
+    }
+
+    if (result_elt == NULL) {
+        // First call, send the query and wait for the first batch
+        result_elt = (struct _pdc_query_result_list *)calloc(1, sizeof(struct _pdc_query_result_list));
+        result_elt->is_stream = 1;
+        result_elt->query     = query;
+        if (PDC_Client_send_query_to_all_servers(query, PDC_QUERY_GET_SEL_BATCH, result_elt) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: error sending query to servers", pdc_client_mpi_rank_g);
+
+        work_todo_g = 1;
+        PDC_Client_check_response(&send_context_g);
+    }
+    else if (result_elt->batch_handle != NULL) {
+        // Acknowledge the consumed batch so the server sends the next one
+        out.ret = 1;
+        hg_ret  = HG_Respond(result_elt->batch_handle, NULL, NULL, &out);
+        HG_Destroy(result_elt->batch_handle);
+        result_elt->batch_handle = NULL;
+        if (hg_ret != HG_SUCCESS)
+            PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: could not acknowledge query batch", pdc_client_mpi_rank_g);
+
+        work_todo_g = 1;
+        PDC_Client_check_response(&send_context_g);
+    }
+    else {
+        // The last batch has been consumed
+        result_elt->batch_nhits = 0;
+    }
+
+    // Nothing is left to hand out once the server has no more batches and this one is empty, which is also
+    // the case of a query without hits. The stream is dropped so the query can be run again.
+    if (result_elt->batch_handle == NULL && result_elt->batch_nhits == 0) {
+        DL_DELETE(pdcquery_result_list_head_g, result_elt);
+        if (result_elt->coords)
+            free(result_elt->coords);
+        free(result_elt);
+        result_elt = NULL;
+    }
+
+    memset(sel, 0, sizeof(pdc_selection_t));
+    if (result_elt != NULL) {
+        sel->query_id = result_elt->query_id;
+        sel->ndim     = result_elt->ndim;
+        sel->nhits    = result_elt->batch_nhits;
+        sel->coords   = result_elt->coords;
+    }
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Client_query_close_batch(pdc_query_t *query)
+{
+    perr_t                         ret_value = SUCCEED;
+    hg_return_t                    hg_ret;
+    struct _pdc_query_result_list *result_elt;
+    pdc_int_ret_t                  out;
+
+    FUNC_ENTER(NULL);
+
+    DL_FOREACH(pdcquery_result_list_head_g, result_elt)
+    {
+        if (result_elt->is_stream == 1 && result_elt->query == query)
+            break;
+    }
+    if (result_elt == NULL)
+        PGOTO_DONE(SUCCEED);
+
+    DL_DELETE(pdcquery_result_list_head_g, result_elt);
+    if (result_elt->batch_handle != NULL) {
+        // A 0 ack tells the servers to drop the rest of the selection instead of sending the next batch
+        out.ret = 0;
+        hg_ret  = HG_Respond(result_elt->batch_handle, NULL, NULL, &out);
+        HG_Destroy(result_elt->batch_handle);
+        if (hg_ret != HG_SUCCESS)
+            ret_value = FAIL;
+    }
+    if (result_elt->coords)
+        free(result_elt->coords);
+    free(result_elt);
 
+done:
     FUNC_LEAVE(ret_value);
 }
 
@@ -7997,11 +8980,11 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
     hg_return_t                    ret_value         = HG_SUCCESS;
     hg_bulk_t                      local_bulk_handle = callback_info->info.bulk.local_handle;
     struct bulk_args_t *           bulk_args         = (struct bulk_args_t *)callback_info->arg;
-    struct _pdc_query_result_list *result_elt;
-    uint64_t                       nhits = 0;
+    struct _pdc_query_result_list *result_elt        = NULL;
+    uint64_t                       nhits             = 0;
     uint32_t                       ndim;
-    int                            query_id, origin;
-    void *                         buf;
+    int                            query_id, origin, is_deferred = 0;
+    void *                         buf = NULL;
     pdc_int_ret_t                  out;
 
     FUNC_ENTER(NULL);
@@ -8018,8 +9001,7 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
         query_id = bulk_args->query_id;
         origin   = bulk_args->origin;
 
-        printf("==PDC_CLIENT[%d]: %s - received %" PRIu64 " coords from server %d\n", pdc_client_mpi_rank_g,
-               __func__, nhits, origin);
+        PDC_LOG_DEBUG("%s - received %" PRIu64 " coords from server %d", __func__, nhits, origin);
 
         if (nhits > 0) {
             ret_value = HG_Bulk_access(local_bulk_handle, 0, bulk_args->nbytes, HG_BULK_READWRITE, 1,
@@ -8028,33 +9010,60 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
 
         DL_FOREACH(pdcquery_result_list_head_g, result_elt)
         {
-            if (result_elt->query_id == query_id) {
-                result_elt->ndim   = ndim;
-                result_elt->nhits  = nhits;
-                result_elt->coords = (uint64_t *)malloc(nhits * ndim * sizeof(uint64_t));
-                memcpy(result_elt->coords, buf, nhits * ndim * sizeof(uint64_t));
+            if (result_elt->query_id == query_id)
                 break;
-            }
         }
 
         if (result_elt == NULL)
             PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_CLIENT[%d]: Invalid task ID!", pdc_client_mpi_rank_g);
+
+        result_elt->ndim  = ndim;
+        result_elt->nhits = bulk_args->total;
+        if (result_elt->is_stream == 1) {
+            // Only keep the current batch, the previous one has been consumed
+            if (result_elt->coords)
+                free(result_elt->coords);
+            result_elt->coords      = NULL;
+            result_elt->batch_nhits = nhits;
+            if (nhits > 0) {
+                result_elt->coords = (uint64_t *)malloc(nhits * ndim * sizeof(uint64_t));
+                memcpy(result_elt->coords, buf, nhits * ndim * sizeof(uint64_t));
+            }
+        }
+        else {
+            if (result_elt->coords == NULL && bulk_args->total > 0)
+                result_elt->coords = (uint64_t *)malloc(bulk_args->total * ndim * sizeof(uint64_t));
+            if (nhits > 0)
+                memcpy(result_elt->coords + bulk_args->offset * ndim, buf, nhits * ndim * sizeof(uint64_t));
+        }
+        result_elt->recv_coords_nhits += nhits;
+
+        // Hold the ack of a streamed batch until it is consumed, which keeps the server from sending more
+        if (result_elt->is_stream == 1 && result_elt->recv_coords_nhits < result_elt->nhits) {
+            result_elt->batch_handle = bulk_args->handle;
+            is_deferred              = 1;
+        }
     } // End else
 
 done:
-    work_todo_g--;
+    if (result_elt == NULL || result_elt->is_stream == 1 ||
+        result_elt->recv_coords_nhits >= result_elt->nhits)
+        work_todo_g--;
+
     if (nhits > 0) {
         ret_value = HG_Bulk_free(local_bulk_handle);
         if (ret_value != HG_SUCCESS)
             PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
     }
 
-    ret_value = HG_Respond(bulk_args->handle, NULL, NULL, &out);
-    if (ret_value != HG_SUCCESS)
-        PGOTO_ERROR(ret_value, "Could not respond");
+    if (is_deferred == 0) {
+        ret_value = HG_Respond(bulk_args->handle, NULL, NULL, &out);
+        if (ret_value != HG_SUCCESS)
+            PGOTO_ERROR(ret_value, "Could not respond");
+
+        HG_Destroy(bulk_args->handle);
+    }
 
-    fflush(stdout);
-    HG_Destroy(bulk_args->handle);
     free(bulk_args);
 
     FUNC_LEAVE(ret_value);
@@ -8144,7 +9153,6 @@ PDC_Client_get_sel_data(pdcid_t obj_id, pdc_selection_t *sel, void *data)
     }
 
 done:
-    fflush(stdout);
     HG_Destroy(handle);
 
     FUNC_LEAVE(ret_value);
@@ -8157,7 +9165,7 @@ PDC_recv_read_coords_data(const struct hg_cb_info *callback_info)
     hg_bulk_t                      local_bulk_handle = callback_info->info.bulk.local_handle;
     struct bulk_args_t *           bulk_args         = (struct bulk_args_t *)callback_info->arg;
     struct _pdc_query_result_list *result_elt;
-    uint64_t                       nhits = 0;
+    uint64_t                       nhits = 0, unit_size;
     int                            query_id, seq_id;
     void *                         buf;
     pdc_int_ret_t                  out;
@@ -8188,9 +9196,16 @@ PDC_recv_read_coords_data(const struct hg_cb_info *callback_info)
                     result_elt->data_arr_size = calloc(sizeof(uint64_t *), pdc_server_num_g);
                 }
 
-                result_elt->data_arr[seq_id] = malloc(bulk_args->nbytes);
-                memcpy(result_elt->data_arr[seq_id], buf, bulk_args->nbytes);
-                result_elt->data_arr_size[seq_id] = bulk_args->nbytes;
+                // Data from one server may come in several batches, place each at its offset
+                if (nhits > 0) {
+                    unit_size = bulk_args->nbytes / nhits;
+                    if (result_elt->data_arr[seq_id] == NULL) {
+                        result_elt->data_arr[seq_id]      = malloc(bulk_args->total * unit_size);
+                        result_elt->data_arr_size[seq_id] = bulk_args->total * unit_size;
+                    }
+                    memcpy(result_elt->data_arr[seq_id] + bulk_args->offset * unit_size, buf,
+                           bulk_args->nbytes);
+                }
                 result_elt->recv_data_nhits += nhits;
                 break;
             }
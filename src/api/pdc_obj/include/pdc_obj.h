@@ -81,6 +81,21 @@ struct pdc_obj_info {
  */
 pdcid_t PDCobj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_create_prop);
 
+/**
+ * Create many objects with the same property, sending one request to each metadata server involved
+ *
+ * \param cont_id [IN]          ID of the container
+ * \param n_objs [IN]           Number of objects
+ * \param obj_names [IN]        Names of the objects
+ * \param obj_create_prop [IN]  ID of object property,
+ *                              returned by PDCprop_create(PDC_OBJ_CREATE)
+ * \param obj_ids [OUT]         Object ids, zero for the objects that could not be created
+ *
+ * \return Non-negative if all objects are created/Negative on failure
+ */
+perr_t PDCobj_create_batch(pdcid_t cont_id, int n_objs, const char **obj_names, pdcid_t obj_create_prop,
+                           pdcid_t *obj_ids);
+
 /**
  * Open an object within a container
  *
@@ -52,6 +52,10 @@ struct _pdc_obj_info {
     pdc_local_transfer_request *local_transfer_request_head;
     pdc_local_transfer_request *local_transfer_request_end;
     int                         local_transfer_request_size;
+    // Small writes waiting to be coalesced and sent, NULL if nothing was buffered for this object
+    struct pdc_write_buffer *write_buffer;
+    // Extents read from the data servers, NULL if nothing was cached for this object
+    struct pdc_read_cache *read_cache;
 };
 
 /***************************************/
@@ -78,6 +82,21 @@ perr_t PDC_obj_init();
 pdcid_t PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id,
                        _pdc_obj_location_t location);
 
+/**
+ * Create the local structure of a global object that is already created on the metadata server
+ *
+ * \param cont_id [IN]          ID of the container
+ * \param obj_name [IN]         Name of the object
+ * \param obj_prop_id [IN]      ID of object property
+ * \param meta_id [IN]          Metadata ID of the object
+ * \param data_server_id [IN]   Data server ID of the object
+ * \param metadata_server_id [IN]  Metadata server ID of the object
+ *
+ * \return Object id on success/Zero on failure
+ */
+pdcid_t PDC_obj_create_with_id(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, uint64_t meta_id,
+                               uint32_t data_server_id, uint32_t metadata_server_id);
+
 /**
  * Get object information
  *
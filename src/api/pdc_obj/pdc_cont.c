@@ -46,7 +46,6 @@ PDC_cont_init()
         PGOTO_ERROR(FAIL, "unable to initialize container interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -94,7 +93,6 @@ PDCcont_create(const char *cont_name, pdcid_t cont_prop_id)
     ret_value = p->cont_info_pub->local_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -141,7 +139,6 @@ PDCcont_create_col(const char *cont_name, pdcid_t cont_prop_id)
     ret_value                  = p->cont_info_pub->local_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -189,7 +186,6 @@ PDC_cont_create_local(pdcid_t pdc, const char *cont_name, uint64_t cont_meta_id)
     PDCprop_close(cont_prop_id);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -209,7 +205,6 @@ PDC_cont_list_null()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -242,7 +237,6 @@ PDCcont_close(pdcid_t id)
         PGOTO_ERROR(FAIL, "container: problem of freeing id");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -257,7 +251,6 @@ PDC_cont_end()
         PGOTO_ERROR(FAIL, "unable to destroy container interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -278,7 +271,6 @@ PDCcont_open(const char *cont_name, pdcid_t pdc)
     ret_value = cont_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -299,7 +291,6 @@ PDCcont_open_col(const char *cont_name, pdcid_t pdc)
     ret_value = cont_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -344,7 +335,6 @@ PDC_cont_get_info(pdcid_t cont_id)
         PGOTO_ERROR(NULL, "cannot allocate ret_value->cont_pt->pdc");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -368,7 +358,6 @@ PDCcont_get_info(const char *cont_name)
     ret_value = tmp->cont_info_pub;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -388,7 +377,6 @@ PDCcont_iter_start()
     ret_value = conthl;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -419,7 +407,6 @@ PDCcont_iter_next(cont_handle *chandle)
     ret_value = next;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -442,7 +429,6 @@ PDCcont_iter_get_info(cont_handle *chandle)
     ret_value = info->cont_info_pub;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -461,7 +447,6 @@ PDCcont_persist(pdcid_t cont_id)
     ((struct _pdc_cont_info *)info->obj_ptr)->cont_pt->cont_life = PDC_PERSIST;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -479,6 +464,5 @@ PDCprop_set_cont_lifetime(pdcid_t cont_prop, pdc_lifetime_t cont_lifetime)
     ((struct _pdc_cont_prop *)(info->obj_ptr))->cont_life = cont_lifetime;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
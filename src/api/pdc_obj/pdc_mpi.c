@@ -113,6 +113,5 @@ PDCobj_decode(pdcid_t obj_id, pdcid_t meta_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
@@ -30,6 +30,7 @@
 #include "pdc_prop_pkg.h"
 #include "pdc_obj_pkg.h"
 #include "pdc_obj.h"
+#include "pdc_region_pkg.h"
 #include "pdc_interface.h"
 #include "pdc_transforms_pkg.h"
 #include "pdc_analysis_pkg.h"
@@ -52,7 +53,6 @@ PDC_obj_init()
         PGOTO_ERROR(FAIL, "unable to initialize object interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -172,7 +172,6 @@ PDCobj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id)
 #endif
     ret_value = PDC_obj_create(cont_id, obj_name, obj_prop_id, PDC_OBJ_GLOBAL);
     // done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -223,8 +222,23 @@ PDC_Client_attach_metadata_to_local_obj(const char *obj_name, uint64_t obj_id, u
     FUNC_LEAVE(ret_value);
 }
 
-pdcid_t
-PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_obj_location_t location)
+/**
+ * Create the local structure of an object, and the object on the metadata server unless it is created already
+ *
+ * \param cont_id [IN]             ID of the container
+ * \param obj_name [IN]            Name of the object
+ * \param obj_prop_id [IN]         ID of object property
+ * \param location [IN]            PDC_OBJ_GLOBAL/PDC_OBJ_LOCAL
+ * \param created_meta_id [IN]     Metadata ID of an object already created on the server, NULL to create it
+ * \param created_data_server_id [IN]      Data server ID of the created object
+ * \param created_metadata_server_id [IN]  Metadata server ID of the created object
+ *
+ * \return Object id on success/Zero on failure
+ */
+static pdcid_t
+PDC_obj_create_local(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_obj_location_t location,
+                     uint64_t *created_meta_id, uint32_t created_data_server_id,
+                     uint32_t created_metadata_server_id)
 {
     pdcid_t                ret_value = 0;
     struct _pdc_obj_info * p         = NULL;
@@ -327,6 +341,8 @@ PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_
     p->local_transfer_request_head = NULL;
     p->local_transfer_request_end  = NULL;
     p->local_transfer_request_size = 0;
+    p->write_buffer                = NULL;
+    p->read_cache                  = NULL;
     /* struct pdc_obj_info field */
     p->obj_info_pub = PDC_MALLOC(struct pdc_obj_info);
     if (!p->obj_info_pub)
@@ -335,7 +351,12 @@ PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_
     p->obj_info_pub->local_id  = PDC_id_register(PDC_OBJ, p);
     p->obj_info_pub->meta_id   = 0;
     p->obj_info_pub->server_id = 0;
-    if (location == PDC_OBJ_GLOBAL) {
+    if (created_meta_id != NULL) {
+        p->obj_info_pub->meta_id = *created_meta_id;
+        data_server_id           = created_data_server_id;
+        metadata_server_id       = created_metadata_server_id;
+    }
+    else if (location == PDC_OBJ_GLOBAL) {
         ret = PDC_Client_send_name_recv_id(obj_name, p->cont->cont_info_pub->meta_id, obj_prop_id,
                                            &(p->obj_info_pub->meta_id), &data_server_id, &metadata_server_id);
         if (ret == FAIL)
@@ -362,7 +383,80 @@ PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_
     ret_value = p->obj_info_pub->local_id;
 
 done:
-    fflush(stdout);
+    FUNC_LEAVE(ret_value);
+}
+
+pdcid_t
+PDC_obj_create(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, _pdc_obj_location_t location)
+{
+    pdcid_t ret_value = 0;
+
+    FUNC_ENTER(NULL);
+
+    ret_value = PDC_obj_create_local(cont_id, obj_name, obj_prop_id, location, NULL, 0, 0);
+
+    FUNC_LEAVE(ret_value);
+}
+
+pdcid_t
+PDC_obj_create_with_id(pdcid_t cont_id, const char *obj_name, pdcid_t obj_prop_id, uint64_t meta_id,
+                       uint32_t data_server_id, uint32_t metadata_server_id)
+{
+    pdcid_t ret_value = 0;
+
+    FUNC_ENTER(NULL);
+
+    ret_value = PDC_obj_create_local(cont_id, obj_name, obj_prop_id, PDC_OBJ_GLOBAL, &meta_id, data_server_id,
+                                     metadata_server_id);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDCobj_create_batch(pdcid_t cont_id, int n_objs, const char **obj_names, pdcid_t obj_create_prop,
+                    pdcid_t *obj_ids)
+{
+    perr_t                 ret_value = SUCCEED;
+    struct _pdc_id_info *  id_info;
+    struct _pdc_cont_info *cont_info;
+    uint64_t *             meta_ids            = NULL;
+    uint32_t *             metadata_server_ids = NULL;
+    uint32_t               data_server_id;
+    int                    i;
+
+    FUNC_ENTER(NULL);
+
+    if (n_objs <= 0 || obj_names == NULL || obj_ids == NULL)
+        PGOTO_ERROR(FAIL, "Invalid object batch");
+
+    id_info = PDC_find_id(cont_id);
+    if (id_info == NULL)
+        PGOTO_ERROR(FAIL, "Cannot locate container ID");
+    cont_info = (struct _pdc_cont_info *)(id_info->obj_ptr);
+
+    meta_ids            = (uint64_t *)malloc(n_objs * sizeof(uint64_t));
+    metadata_server_ids = (uint32_t *)malloc(n_objs * sizeof(uint32_t));
+    if (meta_ids == NULL || metadata_server_ids == NULL)
+        PGOTO_ERROR(FAIL, "PDC object batch memory allocation failed");
+
+    // Failed objects have zero meta_ids, the others are still created
+    ret_value = PDC_Client_send_names_recv_ids(n_objs, obj_names, cont_info->cont_info_pub->meta_id,
+                                               obj_create_prop, meta_ids, &data_server_id,
+                                               metadata_server_ids);
+
+    for (i = 0; i < n_objs; i++) {
+        obj_ids[i] = 0;
+        if (meta_ids[i] == 0)
+            continue;
+        obj_ids[i] = PDC_obj_create_local(cont_id, obj_names[i], obj_create_prop, PDC_OBJ_GLOBAL,
+                                          &meta_ids[i], data_server_id, metadata_server_ids[i]);
+        if (obj_ids[i] == 0)
+            ret_value = FAIL;
+    }
+
+done:
+    free(meta_ids);
+    free(metadata_server_ids);
     FUNC_LEAVE(ret_value);
 }
 
@@ -382,7 +476,6 @@ PDC_obj_list_null()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -396,6 +489,10 @@ PDC_obj_close(struct _pdc_obj_info *op)
 
     FUNC_ENTER(NULL);
 
+    // Buffered writes are sent and waited for first, they may add requests to the list below
+    PDC_region_transfer_write_buffer_close(op);
+    PDC_region_transfer_read_cache_close(op);
+
     if (op->local_transfer_request_size) {
         transfer_request_id = (pdcid_t *)malloc(sizeof(pdcid_t) * op->local_transfer_request_size);
         temp                = op->local_transfer_request_head;
@@ -450,9 +547,9 @@ PDCobj_flush_start(pdcid_t obj_id)
 
     FUNC_ENTER(NULL);
 
+    PDC_region_transfer_write_buffer_flush(obj_id);
     PDC_Client_flush_obj(obj_id);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -463,20 +560,21 @@ PDCobj_flush_all_start()
 
     FUNC_ENTER(NULL);
 
+    PDC_region_transfer_write_buffer_flush_all();
     PDC_Client_flush_obj_all();
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 #else
 perr_t
-PDCobj_flush_start(pdcid_t obj_id __attribute__((unused)))
+PDCobj_flush_start(pdcid_t obj_id)
 {
     perr_t ret_value = SUCCEED;
 
     FUNC_ENTER(NULL);
 
-    fflush(stdout);
+    PDC_region_transfer_write_buffer_flush(obj_id);
+
     FUNC_LEAVE(ret_value);
 }
 
@@ -487,7 +585,8 @@ PDCobj_flush_all_start()
 
     FUNC_ENTER(NULL);
 
-    fflush(stdout);
+    PDC_region_transfer_write_buffer_flush_all();
+
     FUNC_LEAVE(ret_value);
 }
 #endif
@@ -504,7 +603,6 @@ PDCobj_close(pdcid_t obj_id)
         PGOTO_ERROR(FAIL, "object: problem of freeing id");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -519,7 +617,6 @@ PDC_obj_end()
         PGOTO_ERROR(FAIL, "unable to destroy object interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -617,6 +714,8 @@ PDCobj_open_common(const char *obj_name, pdcid_t pdc, int is_col)
     p->local_transfer_request_head = NULL;
     p->local_transfer_request_end  = NULL;
     p->local_transfer_request_size = 0;
+    p->write_buffer                = NULL;
+    p->read_cache                  = NULL;
     /* struct pdc_obj_info field */
     /* 'obj_name' is a char array */
     if (strlen(out->obj_name) > 0)
@@ -635,7 +734,6 @@ PDCobj_open_common(const char *obj_name, pdcid_t pdc, int is_col)
     ret_value = p->obj_info_pub->local_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -683,7 +781,6 @@ PDCobj_iter_start(pdcid_t cont_id)
     ret_value = objhl;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -720,7 +817,6 @@ PDCobj_iter_next(obj_handle *ohandle, pdcid_t cont_id)
     ret_value = next;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -753,7 +849,6 @@ PDCobj_iter_get_info(obj_handle *ohandle)
         ret_value->obj_pt->dims[i] = info->obj_info_pub->obj_pt->dims[i];
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -771,7 +866,6 @@ PDCprop_set_obj_user_id(pdcid_t obj_prop, uint32_t user_id)
     ((struct _pdc_obj_prop *)(info->obj_ptr))->user_id = user_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -792,7 +886,6 @@ PDCprop_set_obj_app_name(pdcid_t obj_prop, char *app_name)
     ((struct _pdc_obj_prop *)(info->obj_ptr))->app_name = strdup(app_name);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -810,7 +903,6 @@ PDCprop_set_obj_time_step(pdcid_t obj_prop, uint32_t time_step)
     ((struct _pdc_obj_prop *)(info->obj_ptr))->time_step = time_step;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -831,7 +923,6 @@ PDCprop_set_obj_data_loc(pdcid_t obj_prop, char *loc)
     ((struct _pdc_obj_prop *)(info->obj_ptr))->data_loc = strdup(loc);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -852,7 +943,6 @@ PDCprop_set_obj_tags(pdcid_t obj_prop, char *tags)
     ((struct _pdc_obj_prop *)(info->obj_ptr))->tags = strdup(tags);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -879,7 +969,6 @@ PDCprop_set_obj_dims(pdcid_t obj_prop, PDC_int_t ndim, uint64_t *dims)
     memcpy(prop->obj_prop_pub->dims, dims, ndim * sizeof(uint64_t));
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -899,7 +988,6 @@ PDCprop_set_obj_type(pdcid_t obj_prop, pdc_var_type_t type)
     prop->obj_prop_pub->type = type;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -919,7 +1007,6 @@ PDCprop_set_obj_transfer_region_type(pdcid_t obj_prop, pdc_region_partition_t re
     prop->obj_prop_pub->region_partition = region_partition;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -939,7 +1026,6 @@ PDCprop_set_obj_consistency_semantics(pdcid_t obj_prop, pdc_consistency_t consis
     prop->obj_prop_pub->consistency = consistency;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -959,7 +1045,6 @@ PDCprop_set_obj_buf(pdcid_t obj_prop, void *buf)
     prop->buf = buf;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1038,7 +1123,6 @@ PDCobj_buf_retrieve(pdcid_t obj_id)
     ret_value = buffer;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1166,7 +1250,6 @@ PDC_obj_get_info(pdcid_t obj_id)
     ret_value->region_list_head = NULL;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1243,7 +1326,6 @@ PDCobj_get_info(pdcid_t obj_id)
     ret_value = tmp->obj_info_pub;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -49,7 +49,6 @@ PDC_prop_init()
         PGOTO_ERROR(FAIL, "unable to initialize object property interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -120,7 +119,6 @@ PDCprop_create(pdc_prop_type_t type, pdcid_t pdcid)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -176,7 +174,6 @@ PDCprop_obj_dup(pdcid_t prop_id)
     ret_value = new_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -196,7 +193,6 @@ PDC_prop_cont_list_null()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -216,7 +212,6 @@ PDC_prop_obj_list_null()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -267,7 +262,6 @@ PDCprop_close(pdcid_t id)
         PGOTO_ERROR(FAIL, "property: problem of freeing id");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -285,7 +279,6 @@ PDC_prop_end()
         PGOTO_ERROR(FAIL, "unable to destroy object property interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -317,7 +310,6 @@ PDCcont_prop_get_info(pdcid_t cont_prop)
     ret_value->pdc->local_id = info->pdc->local_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -348,7 +340,6 @@ PDCobj_prop_get_info(pdcid_t obj_prop)
         ret_value->dims[i] = info->obj_prop_pub->dims[i];
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -400,7 +391,6 @@ PDC_obj_prop_get_info(pdcid_t obj_prop)
         ret_value->obj_prop_pub->dims[i] = info->obj_prop_pub->dims[i];
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
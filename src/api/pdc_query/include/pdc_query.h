@@ -14,10 +14,11 @@ typedef enum { PDC_OP_NONE = 0, PDC_GT = 1, PDC_LT = 2, PDC_GTE = 3, PDC_LTE = 4
 typedef enum { PDC_QUERY_NONE = 0, PDC_QUERY_AND = 1, PDC_QUERY_OR = 2 } pdc_query_combine_op_t;
 
 typedef enum {
-    PDC_QUERY_GET_NONE  = 0,
-    PDC_QUERY_GET_NHITS = 1,
-    PDC_QUERY_GET_SEL   = 2,
-    PDC_QUERY_GET_DATA  = 3
+    PDC_QUERY_GET_NONE      = 0,
+    PDC_QUERY_GET_NHITS     = 1,
+    PDC_QUERY_GET_SEL       = 2,
+    PDC_QUERY_GET_DATA      = 3,
+    PDC_QUERY_GET_SEL_BATCH = 4
 } pdc_query_get_op_t;
 
 typedef struct pdcquery_selection_t {
@@ -154,6 +155,19 @@ perr_t PDCquery_sel_region(pdc_query_t *query, struct pdc_region_info *obj_regio
  */
 perr_t PDCquery_get_selection(pdc_query_t *query, pdc_selection_t *sel);
 
+/**
+ * Get the selection of a query batch by batch, the first call sends the query to the servers.
+ * Call repeatedly until sel->nhits is 0; the coords of each batch are only valid until the next call.
+ * The batch size is set on the server side with PDC_QUERY_BATCH_NHITS. Freeing the query stops the
+ * servers from sending the remaining batches. The batches cannot be passed to PDCquery_get_data.
+ *
+ * \param query [IN]             Query
+ * \param sel [OUT]              Selection holding the coords of the next batch
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDCquery_get_next_batch(pdc_query_t *query, pdc_selection_t *sel);
+
 /**
  * *********
  *
@@ -54,7 +54,6 @@ PDCquery_create(pdcid_t obj_id, pdc_query_op_t op, pdc_var_type_t type, void *va
     ret_value = query;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -71,7 +70,6 @@ PDCquery_sel_region(pdc_query_t *query, struct pdc_region_info *obj_region)
     query->region = obj_region;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -223,7 +221,6 @@ PDCquery_and(pdc_query_t *q1, pdc_query_t *q2)
     ret_value = query;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -249,7 +246,6 @@ PDCquery_or(pdc_query_t *q1, pdc_query_t *q2)
     ret_value = query;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -266,7 +262,6 @@ PDCquery_get_nhits(pdc_query_t *query, uint64_t *n)
     ret_value = PDC_send_data_query(query, PDC_QUERY_GET_NHITS, n, NULL, NULL);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -284,7 +279,22 @@ PDCquery_get_selection(pdc_query_t *query, pdc_selection_t *sel)
     ret_value = PDC_send_data_query(query, PDC_QUERY_GET_SEL, NULL, sel, NULL);
 
 done:
-    fflush(stdout);
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDCquery_get_next_batch(pdc_query_t *query, pdc_selection_t *sel)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    if (query == NULL || sel == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[] input NULL!");
+
+    ret_value = PDC_Client_query_get_next_batch(query, sel);
+
+done:
     FUNC_LEAVE(ret_value);
 }
 
@@ -310,7 +320,6 @@ PDCquery_get_data(pdcid_t obj_id, pdc_selection_t *sel, void *obj_data)
     ret_value = PDC_Client_get_sel_data(meta_id, sel, obj_data);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -38,6 +38,8 @@ struct region_map_list {
     struct region_map_list *next;
 };
 
+struct _pdc_obj_info;
+
 /***************************************/
 /* Library-private Function Prototypes */
 /***************************************/
@@ -68,4 +70,52 @@ perr_t PDC_region_end();
  */
 perr_t PDC_region_list_null();
 
+/**
+ * Read the write-back buffer settings, buffering is on if PDC_CLIENT_WRITE_BUFFER_SIZE is set
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_write_buffer_init();
+
+/**
+ * Send the buffered writes of an object and wait until the data servers have them
+ *
+ * \param obj_id [IN]           ID of the object
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_write_buffer_flush(pdcid_t obj_id);
+
+/**
+ * Send the buffered writes of all objects and wait until the data servers have them
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_write_buffer_flush_all();
+
+/**
+ * Send the buffered writes of an object that is being closed and free its write-back buffer
+ *
+ * \param obj [IN]              Pointer to the object
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_write_buffer_close(struct _pdc_obj_info *obj);
+
+/**
+ * Read the read cache settings, caching is on if PDC_CLIENT_READ_CACHE_SIZE is set
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_read_cache_init();
+
+/**
+ * Wait for the prefetch of an object that is being closed and free its read cache
+ *
+ * \param obj [IN]              Pointer to the object
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_region_transfer_read_cache_close(struct _pdc_obj_info *obj);
+
 #endif /* PDC_REGION_PKG_H */
@@ -56,7 +56,6 @@ PDC_region_init()
         PGOTO_ERROR(FAIL, "unable to initialize region interface");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -71,8 +70,12 @@ PDC_transfer_request_init()
     if (PDC_register_type(PDC_TRANSFER_REQUEST, (PDC_free_t)pdc_transfer_request_close) < 0)
         PGOTO_ERROR(FAIL, "unable to initialize region interface");
 
+    if (PDC_region_transfer_write_buffer_init() < 0)
+        PGOTO_ERROR(FAIL, "unable to initialize write-back buffer");
+    if (PDC_region_transfer_read_cache_init() < 0)
+        PGOTO_ERROR(FAIL, "unable to initialize read cache");
+
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -92,7 +95,6 @@ PDC_region_list_null()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -134,7 +136,6 @@ PDCregion_close(pdcid_t region_id)
         PGOTO_ERROR(FAIL, "object: problem of freeing id");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -148,7 +149,6 @@ PDC_region_end()
     if (PDC_destroy_type(PDC_REGION) < 0)
         PGOTO_ERROR(FAIL, "unable to destroy region interface");
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -169,7 +169,6 @@ transfer_request_id) { pdc_transfer_status_t ret_value; struct pdc_local_transfe
         temp = temp->next;
     }
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 */
@@ -202,7 +201,6 @@ PDCregion_create(psize_t ndims, uint64_t *offset, uint64_t *size)
     ret_value   = new_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -256,7 +254,6 @@ PDCbuf_obj_map(void *buf, pdc_var_type_t local_type, pdcid_t local_reg, pdcid_t
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -277,7 +274,6 @@ PDCregion_get_info(pdcid_t reg_id)
     ret_value = info;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -312,7 +308,6 @@ PDCbuf_obj_unmap(pdcid_t remote_obj_id, pdcid_t remote_reg_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
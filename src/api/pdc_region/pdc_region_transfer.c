@@ -42,8 +42,14 @@
 #include "pdc_transforms_pkg.h"
 #include "pdc_client_connect.h"
 #include "pdc_analysis_pkg.h"
+#include "pdc_metrics.h"
 #include <mpi.h>
 
+// Writes up to this many bytes go to the write-back buffer, override with PDC_CLIENT_WRITE_BUFFER_MAX_WRITE
+#define PDC_WRITE_BUFFER_MAX_WRITE_DEFAULT 65536
+// Buffered writes older than this many seconds are sent, override with PDC_CLIENT_WRITE_BUFFER_TIMEOUT (ms)
+#define PDC_WRITE_BUFFER_TIMEOUT_DEFAULT 1.0
+
 // pdc region transfer class. Contains essential information for performing non-blocking PDC client I/O
 // perations.
 typedef struct pdc_transfer_request {
@@ -102,8 +108,101 @@ typedef struct pdc_transfer_request {
     uint64_t *obj_dims;
     // Pointer to object info, can be useful sometimes. We do not want to go through PDC ID list many times.
     struct _pdc_obj_info *obj_pointer;
+    // Number of posted requests still waiting for the data server's reply, which fills in metadata_id. Only
+    // nonzero when the client progress thread is running.
+    int n_pending;
+    // Number of posted requests whose reply reported an error, wait and status then return FAIL.
+    int n_failed;
+    // Local ID of the object, the requests sending the write-back buffer are created with it.
+    pdcid_t local_obj_id;
+    // Set when start copied the data to the object's write-back buffer instead of sending it.
+    int write_buffered;
+    // Set on the requests sending the write-back buffer, so they are not buffered again.
+    int write_through;
+    // Set when start copied the data from the object's read cache instead of reading it.
+    int read_cached;
+    // Set on the prefetch requests, which put their data in the read cache themselves.
+    int read_through;
+    // Version of the object's read cache when a cacheable read went to the server, 0 for other requests.
+    uint64_t read_cache_version;
 } pdc_transfer_request;
 
+// A run of buffered data, offset and size are in elements of the object.
+typedef struct pdc_write_buffer_extent {
+    uint64_t                        offset;
+    uint64_t                        size;
+    uint64_t                        capacity;
+    char *                          buf;
+    struct pdc_write_buffer_extent *next;
+} pdc_write_buffer_extent;
+
+// Write-back buffer of an object. Small 1D writes are copied here and coalesced with the adjacent and
+// overlapping writes before them, so many tiny writes are sent as a few larger transfer requests.
+struct pdc_write_buffer {
+    struct _pdc_obj_info *obj;
+    pdcid_t               obj_id;
+    size_t                unit;
+    // Bytes held by the extents
+    uint64_t nbytes;
+    // Time of the oldest write in the extents
+    double first_write;
+    // Sorted by offset, no two extents overlap or touch
+    pdc_write_buffer_extent *extents;
+    // Requests sending the previous flush and their data, waited for before the next flush
+    int                      n_inflight;
+    pdcid_t *                inflight;
+    char **                  inflight_buf;
+    struct pdc_write_buffer *prev;
+    struct pdc_write_buffer *next;
+};
+
+// Buffering is off unless PDC_CLIENT_WRITE_BUFFER_SIZE sets the bytes an object may hold before it is sent
+static uint64_t                 pdc_write_buffer_size_g      = 0;
+static uint64_t                 pdc_write_buffer_max_write_g = PDC_WRITE_BUFFER_MAX_WRITE_DEFAULT;
+static double                   pdc_write_buffer_timeout_g   = PDC_WRITE_BUFFER_TIMEOUT_DEFAULT;
+static struct pdc_write_buffer *pdc_write_buffer_head_g      = NULL;
+
+// A cached extent of an object, offset and size are in elements of the object.
+typedef struct pdc_read_cache_entry {
+    struct pdc_read_cache *      cache;
+    uint64_t                     offset;
+    uint64_t                     size;
+    char *                       buf;
+    struct pdc_read_cache_entry *prev;
+    struct pdc_read_cache_entry *next;
+    // All the entries of all objects, most recently used first
+    struct pdc_read_cache_entry *lru_prev;
+    struct pdc_read_cache_entry *lru_next;
+} pdc_read_cache_entry;
+
+// Read cache of an object. Extents are sorted by offset and do not overlap.
+struct pdc_read_cache {
+    pdcid_t               obj_id;
+    size_t                unit;
+    pdc_read_cache_entry *entries;
+    // Bumped when the object is written, cached data and reads started before that are stale
+    uint64_t version;
+    // Stride detection, nseq counts the reads in a row with the same stride
+    uint64_t last_offset;
+    uint64_t last_size;
+    int64_t  stride;
+    int      nseq;
+    // Read ahead in flight, 0 if none
+    pdcid_t  prefetch_id;
+    uint64_t prefetch_offset;
+    uint64_t prefetch_size;
+    uint64_t prefetch_version;
+    char *   prefetch_buf;
+};
+
+// Caching is off unless PDC_CLIENT_READ_CACHE_SIZE sets the bytes all objects may cache together
+static uint64_t              pdc_read_cache_size_g  = 0;
+static uint64_t              pdc_read_cache_bytes_g = 0;
+static int                   pdc_read_prefetch_g    = 1;
+static pdc_read_cache_entry *pdc_read_cache_lru_g   = NULL;
+
+static perr_t write_buffer_complete(pdc_transfer_request *p);
+
 // We pack all arguments for a start_all call to the same data server in a single structure, so we do not need
 // to many arguments to a function.
 typedef struct pdc_transfer_request_start_all_pkg {
@@ -220,12 +319,20 @@ PDCregion_transfer_create(void *buf, pdc_access_t access_type, pdcid_t obj_id, p
     p->bulk_buf         = NULL;
     p->bulk_buf_ref     = NULL;
     p->output_buf       = NULL;
+    p->n_pending        = 0;
+    p->n_failed         = 0;
+    p->local_obj_id     = obj_id;
+    p->write_buffered   = 0;
+    p->write_through    = 0;
+    p->read_cached      = 0;
+    p->read_through     = 0;
     p->region_partition = ((pdc_metadata_t *)obj2->metadata)->region_partition;
     // p->region_partition   = PDC_REGION_LOCAL;
     p->data_server_id     = ((pdc_metadata_t *)obj2->metadata)->data_server_id;
     p->metadata_server_id = obj2->obj_info_pub->metadata_server_id;
     p->unit               = PDC_get_var_type_size(p->mem_type);
     p->consistency        = obj2->obj_pt->obj_prop_pub->consistency;
+    p->read_cache_version = 0;
     unit                  = p->unit;
 
     /*
@@ -270,7 +377,6 @@ PDCregion_transfer_create(void *buf, pdc_access_t access_type, pdcid_t obj_id, p
     ret_value = PDC_id_register(PDC_TRANSFER_REQUEST, p);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -287,10 +393,16 @@ PDCregion_transfer_close(pdcid_t transfer_request_id)
         goto done;
     }
     transfer_request = (pdc_transfer_request *)(transferinfo->obj_ptr);
+    // A buffered write that was never waited for is completed at close
+    if (transfer_request->write_buffered)
+        ret_value = write_buffer_complete(transfer_request);
     if (transfer_request->metadata_id == NULL) {
         goto done;
     }
 
+    // The reply callbacks of posted requests write to metadata_id and n_pending, wait for them first
+    PDC_Client_transfer_request_wait_posted(&transfer_request->n_pending);
+
     // Check for consistency
     /*
         pdc_consistency_t consistency = transfer_request->consistency;
@@ -307,7 +419,6 @@ PDCregion_transfer_close(pdcid_t transfer_request_id)
     if (PDC_dec_ref(transfer_request_id) < 0)
         PGOTO_ERROR(FAIL, "PDC transfer request: problem of freeing id");
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -337,7 +448,6 @@ attach_local_transfer_request(struct _pdc_obj_info *p, pdcid_t transfer_request_
     }
     p->local_transfer_request_end->local_id = transfer_request_id;
     p->local_transfer_request_size++;
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -375,7 +485,649 @@ remove_local_transfer_request(struct _pdc_obj_info *p, pdcid_t transfer_request_
         temp     = temp->next;
     }
 
-    fflush(stdout);
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_region_transfer_write_buffer_init()
+{
+    perr_t ret_value = SUCCEED;
+    char * env;
+
+    FUNC_ENTER(NULL);
+
+    env = getenv("PDC_CLIENT_WRITE_BUFFER_SIZE");
+    if (env != NULL)
+        pdc_write_buffer_size_g = strtoull(env, NULL, 10);
+    env = getenv("PDC_CLIENT_WRITE_BUFFER_MAX_WRITE");
+    if (env != NULL)
+        pdc_write_buffer_max_write_g = strtoull(env, NULL, 10);
+    env = getenv("PDC_CLIENT_WRITE_BUFFER_TIMEOUT");
+    if (env != NULL)
+        pdc_write_buffer_timeout_g = atof(env) / 1000.0;
+    if (pdc_write_buffer_max_write_g > pdc_write_buffer_size_g)
+        pdc_write_buffer_max_write_g = pdc_write_buffer_size_g;
+
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Only small 1D writes are buffered. POSIX consistency needs the data on the server when start returns, so
+ * those writes are always sent right away.
+ */
+static int
+write_buffer_eligible(pdc_transfer_request *p)
+{
+    return pdc_write_buffer_size_g > 0 && !p->write_through && p->access_type == PDC_WRITE &&
+           p->consistency != PDC_CONSISTENCY_POSIX && p->obj_ndim == 1 && p->local_region_ndim == 1 &&
+           p->remote_region_ndim == 1 && p->total_data_size <= pdc_write_buffer_max_write_g;
+}
+
+static perr_t
+write_buffer_wait_inflight(struct pdc_write_buffer *wb)
+{
+    perr_t ret_value = SUCCEED;
+    int    i;
+
+    FUNC_ENTER(NULL);
+
+    if (wb->n_inflight == 0)
+        goto done;
+
+    ret_value = PDCregion_transfer_wait_all(wb->inflight, wb->n_inflight);
+    for (i = 0; i < wb->n_inflight; ++i) {
+        PDCregion_transfer_close(wb->inflight[i]);
+        free(wb->inflight_buf[i]);
+    }
+    free(wb->inflight);
+    free(wb->inflight_buf);
+    wb->inflight     = NULL;
+    wb->inflight_buf = NULL;
+    wb->n_inflight   = 0;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Send every extent of the buffer as one region transfer with a single start_all. The previous flush is
+ * waited for first, so at most one flush per object is in flight. With wait set, this one is waited for too.
+ * Extents whose request cannot be created stay in the buffer.
+ */
+static perr_t
+write_buffer_send(struct pdc_write_buffer *wb, int wait)
+{
+    perr_t                   ret_value = SUCCEED;
+    pdc_write_buffer_extent *extent, *next;
+    struct _pdc_id_info *    transferinfo;
+    pdcid_t                  local_reg, remote_reg, transfer_request_id;
+    uint64_t                 zero = 0, nbytes, metrics_start;
+    int                      n;
+
+    FUNC_ENTER(NULL);
+
+    if (wb == NULL)
+        goto done;
+    if (write_buffer_wait_inflight(wb) != SUCCEED)
+        PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: failed to wait for the previous write-back flush",
+                    pdc_client_mpi_rank_g);
+
+    if (wb->extents != NULL) {
+        metrics_start = PDC_metrics_now();
+        nbytes        = wb->nbytes;
+        n             = 0;
+        for (extent = wb->extents; extent != NULL; extent = extent->next)
+            n++;
+        wb->inflight     = (pdcid_t *)malloc(sizeof(pdcid_t) * n);
+        wb->inflight_buf = (char **)malloc(sizeof(char *) * n);
+        if (wb->inflight == NULL || wb->inflight_buf == NULL) {
+            free(wb->inflight);
+            free(wb->inflight_buf);
+            wb->inflight     = NULL;
+            wb->inflight_buf = NULL;
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot allocate the write-back flush", pdc_client_mpi_rank_g);
+        }
+        for (extent = wb->extents; extent != NULL; extent = next) {
+            next       = extent->next;
+            local_reg  = PDCregion_create(1, &zero, &extent->size);
+            remote_reg = PDCregion_create(1, &extent->offset, &extent->size);
+            transfer_request_id =
+                PDCregion_transfer_create(extent->buf, PDC_WRITE, wb->obj_id, local_reg, remote_reg);
+            PDCregion_close(local_reg);
+            PDCregion_close(remote_reg);
+            transferinfo = PDC_find_id(transfer_request_id);
+            if (transferinfo == NULL) {
+                ret_value = FAIL;
+                break;
+            }
+            ((pdc_transfer_request *)(transferinfo->obj_ptr))->write_through = 1;
+            wb->inflight[wb->n_inflight]                                      = transfer_request_id;
+            wb->inflight_buf[wb->n_inflight]                                  = extent->buf;
+            wb->n_inflight++;
+            wb->nbytes -= extent->size * wb->unit;
+            free(extent);
+        }
+        wb->extents = extent;
+        // The requests created before a failure are still sent, they are waited for with the next flush
+        if (wb->n_inflight > 0 && PDCregion_transfer_start_all(wb->inflight, wb->n_inflight) != SUCCEED)
+            ret_value = FAIL;
+        PDC_metrics_record(PDC_METRIC_CLIENT_WRITE_BUFFER_FLUSH, metrics_start, nbytes - wb->nbytes);
+        if (ret_value != SUCCEED)
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: failed to send the write-back buffer of object %" PRIu64,
+                        pdc_client_mpi_rank_g, wb->obj_id);
+    }
+
+    if (wait && write_buffer_wait_inflight(wb) != SUCCEED)
+        PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: failed to wait for the write-back flush", pdc_client_mpi_rank_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Copy a write into the object's buffer. The extents it overlaps or touches are merged with it into one
+ * extent, the new data is copied last so it replaces older data at the same offsets.
+ */
+static perr_t
+write_buffer_add(pdc_transfer_request *p)
+{
+    perr_t                    ret_value = SUCCEED;
+    struct pdc_write_buffer * wb        = p->obj_pointer->write_buffer;
+    pdc_write_buffer_extent **pp, *extent, *next;
+    uint64_t                  offset, size, lo, hi, capacity;
+    size_t                    unit = p->unit;
+    char *                    src, *buf;
+
+    FUNC_ENTER(NULL);
+
+    if (wb == NULL) {
+        wb = (struct pdc_write_buffer *)calloc(1, sizeof(struct pdc_write_buffer));
+        if (wb == NULL)
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot allocate a write-back buffer", pdc_client_mpi_rank_g);
+        wb->obj                      = p->obj_pointer;
+        wb->obj_id                   = p->local_obj_id;
+        wb->unit                     = unit;
+        p->obj_pointer->write_buffer = wb;
+        DL_APPEND(pdc_write_buffer_head_g, wb);
+    }
+    offset = p->remote_region_offset[0];
+    size   = p->remote_region_size[0];
+    src    = p->buf + p->local_region_offset[0] * unit;
+    if (wb->extents == NULL)
+        wb->first_write = MPI_Wtime();
+
+    // Skip the extents that end before the write, the next one is the first that can be merged with it
+    pp = &wb->extents;
+    while (*pp != NULL && (*pp)->offset + (*pp)->size < offset)
+        pp = &(*pp)->next;
+    extent = *pp;
+
+    if (extent == NULL || extent->offset > offset + size) {
+        extent = (pdc_write_buffer_extent *)malloc(sizeof(pdc_write_buffer_extent));
+        if (extent == NULL)
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot allocate a write-back extent", pdc_client_mpi_rank_g);
+        extent->buf = (char *)malloc(size * unit);
+        if (extent->buf == NULL) {
+            free(extent);
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot allocate a write-back extent", pdc_client_mpi_rank_g);
+        }
+        extent->offset   = offset;
+        extent->size     = size;
+        extent->capacity = size;
+        extent->next     = *pp;
+        memcpy(extent->buf, src, size * unit);
+        *pp = extent;
+        wb->nbytes += size * unit;
+    }
+    else {
+        lo = extent->offset < offset ? extent->offset : offset;
+        hi = extent->offset + extent->size > offset + size ? extent->offset + extent->size : offset + size;
+        for (next = extent->next; next != NULL && next->offset <= hi; next = next->next) {
+            if (next->offset + next->size > hi)
+                hi = next->offset + next->size;
+        }
+        if (hi - lo > extent->capacity) {
+            // Grow geometrically, so a stream of appends is not copied again on every write
+            capacity = hi - lo > extent->capacity * 2 ? hi - lo : extent->capacity * 2;
+            buf      = (char *)realloc(extent->buf, capacity * unit);
+            if (buf == NULL)
+                PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot grow a write-back extent", pdc_client_mpi_rank_g);
+            extent->buf      = buf;
+            extent->capacity = capacity;
+        }
+        wb->nbytes -= extent->size * unit;
+        if (lo < extent->offset)
+            memmove(extent->buf + (extent->offset - lo) * unit, extent->buf, extent->size * unit);
+        while (extent->next != NULL && extent->next->offset <= hi) {
+            next = extent->next;
+            memcpy(extent->buf + (next->offset - lo) * unit, next->buf, next->size * unit);
+            wb->nbytes -= next->size * unit;
+            extent->next = next->next;
+            free(next->buf);
+            free(next);
+        }
+        extent->offset = lo;
+        extent->size   = hi - lo;
+        memcpy(extent->buf + (offset - lo) * unit, src, size * unit);
+        wb->nbytes += extent->size * unit;
+    }
+    p->write_buffered = 1;
+
+    if (wb->nbytes >= pdc_write_buffer_size_g && write_buffer_send(wb, 0) != SUCCEED)
+        ret_value = FAIL;
+    // Buffers of other objects are checked here too, there is no thread to send them on time
+    DL_FOREACH(pdc_write_buffer_head_g, wb)
+    {
+        if (wb->extents != NULL && MPI_Wtime() - wb->first_write >= pdc_write_buffer_timeout_g &&
+            write_buffer_send(wb, 0) != SUCCEED)
+            ret_value = FAIL;
+    }
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Send and wait for the buffered writes of an object before another request on it starts, so the request
+ * does not overtake them and a read sees them.
+ */
+static perr_t
+write_buffer_sync(struct _pdc_obj_info *obj)
+{
+    perr_t                   ret_value = SUCCEED;
+    struct pdc_write_buffer *wb        = obj->write_buffer;
+
+    FUNC_ENTER(NULL);
+
+    if (wb != NULL && (wb->extents != NULL || wb->n_inflight > 0))
+        ret_value = write_buffer_send(wb, 1);
+
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * A buffered write is complete once its buffer is on the data server. Eventual consistency does not need it
+ * there yet, those buffers are left for the size and time thresholds, a flush or the object close.
+ */
+static perr_t
+write_buffer_complete(pdc_transfer_request *p)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    p->write_buffered = 0;
+    if (p->consistency != PDC_CONSISTENCY_EVENTUAL)
+        ret_value = write_buffer_sync(p->obj_pointer);
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_region_transfer_write_buffer_flush(pdcid_t obj_id)
+{
+    perr_t               ret_value = SUCCEED;
+    struct _pdc_id_info *objinfo;
+
+    FUNC_ENTER(NULL);
+
+    objinfo = PDC_find_id(obj_id);
+    if (objinfo == NULL)
+        PGOTO_ERROR(FAIL, "cannot locate object ID");
+    ret_value = write_buffer_sync((struct _pdc_obj_info *)(objinfo->obj_ptr));
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_region_transfer_write_buffer_flush_all()
+{
+    perr_t                   ret_value = SUCCEED;
+    struct pdc_write_buffer *wb;
+
+    FUNC_ENTER(NULL);
+
+    // Start every flush before waiting for any of them
+    DL_FOREACH(pdc_write_buffer_head_g, wb)
+    {
+        if (write_buffer_send(wb, 0) != SUCCEED)
+            ret_value = FAIL;
+    }
+    DL_FOREACH(pdc_write_buffer_head_g, wb)
+    {
+        if (write_buffer_wait_inflight(wb) != SUCCEED)
+            ret_value = FAIL;
+    }
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_region_transfer_write_buffer_close(struct _pdc_obj_info *obj)
+{
+    perr_t                   ret_value = SUCCEED;
+    struct pdc_write_buffer *wb        = obj->write_buffer;
+
+    FUNC_ENTER(NULL);
+
+    if (wb == NULL)
+        goto done;
+    ret_value = write_buffer_send(wb, 1);
+    DL_DELETE(pdc_write_buffer_head_g, wb);
+    free(wb);
+    obj->write_buffer = NULL;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_region_transfer_read_cache_init()
+{
+    perr_t ret_value = SUCCEED;
+    char * env;
+
+    FUNC_ENTER(NULL);
+
+    env = getenv("PDC_CLIENT_READ_CACHE_SIZE");
+    if (env != NULL)
+        pdc_read_cache_size_g = strtoull(env, NULL, 10);
+    env = getenv("PDC_CLIENT_READ_PREFETCH");
+    if (env != NULL)
+        pdc_read_prefetch_g = atoi(env);
+
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Only 1D reads up to a quarter of the cache are cached. The cache only sees the writes of this client, so
+ * only objects with eventual consistency use it. POSIX, commit and session consistency need reads to see
+ * the writes of other clients once they are done, committed or their session is closed, and those reads
+ * always go to the data server. A read that already missed is not looked up again when start hands it to
+ * start_all.
+ */
+static int
+read_cache_eligible(pdc_transfer_request *p)
+{
+    return pdc_read_cache_size_g > 0 && !p->read_through && p->read_cache_version == 0 &&
+           p->access_type == PDC_READ && p->consistency == PDC_CONSISTENCY_EVENTUAL && p->obj_ndim == 1 &&
+           p->local_region_ndim == 1 && p->remote_region_ndim == 1 &&
+           p->total_data_size <= pdc_read_cache_size_g / 4;
+}
+
+static void
+read_cache_remove(pdc_read_cache_entry *entry)
+{
+    DL_DELETE(entry->cache->entries, entry);
+    DL_DELETE2(pdc_read_cache_lru_g, entry, lru_prev, lru_next);
+    pdc_read_cache_bytes_g -= entry->size * entry->cache->unit;
+    free(entry->buf);
+    free(entry);
+}
+
+/*
+ * Add an extent to the cache of an object, taking over buf. Cached extents overlapping it hold older data
+ * and are dropped, then the least recently used extents of all objects are evicted to stay in the limit.
+ */
+static void
+read_cache_insert(struct pdc_read_cache *rc, uint64_t offset, uint64_t size, char *buf)
+{
+    pdc_read_cache_entry *entry, *tmp, *after = NULL;
+
+    DL_FOREACH_SAFE(rc->entries, entry, tmp)
+    {
+        if (entry->offset < offset + size && offset < entry->offset + entry->size)
+            read_cache_remove(entry);
+        else if (entry->offset > offset && after == NULL)
+            after = entry;
+    }
+
+    entry         = (pdc_read_cache_entry *)malloc(sizeof(pdc_read_cache_entry));
+    entry->cache  = rc;
+    entry->offset = offset;
+    entry->size   = size;
+    entry->buf    = buf;
+    if (after != NULL)
+        DL_PREPEND_ELEM(rc->entries, after, entry);
+    else
+        DL_APPEND(rc->entries, entry);
+    DL_PREPEND2(pdc_read_cache_lru_g, entry, lru_prev, lru_next);
+    pdc_read_cache_bytes_g += size * rc->unit;
+
+    while (pdc_read_cache_bytes_g > pdc_read_cache_size_g && pdc_read_cache_lru_g != NULL)
+        read_cache_remove(pdc_read_cache_lru_g->lru_prev);
+}
+
+static pdc_read_cache_entry *
+read_cache_lookup(struct pdc_read_cache *rc, uint64_t offset, uint64_t size)
+{
+    pdc_read_cache_entry *entry;
+
+    DL_FOREACH(rc->entries, entry)
+    {
+        if (entry->offset > offset)
+            break;
+        if (offset + size <= entry->offset + entry->size)
+            return entry;
+    }
+    return NULL;
+}
+
+/*
+ * Drop the cached data of an object before it is written. The version is bumped, so reads and prefetches
+ * still in flight do not put the old data back when they complete.
+ */
+static void
+read_cache_invalidate(struct _pdc_obj_info *obj)
+{
+    struct pdc_read_cache *rc = obj->read_cache;
+    pdc_read_cache_entry * entry, *tmp;
+
+    if (rc == NULL)
+        return;
+    rc->version++;
+    rc->nseq = 0;
+    DL_FOREACH_SAFE(rc->entries, entry, tmp)
+    {
+        read_cache_remove(entry);
+    }
+}
+
+static perr_t
+read_cache_prefetch_wait(struct pdc_read_cache *rc)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    if (rc->prefetch_id == 0)
+        goto done;
+
+    ret_value = PDCregion_transfer_wait(rc->prefetch_id);
+    PDCregion_transfer_close(rc->prefetch_id);
+    if (ret_value == SUCCEED && rc->prefetch_version == rc->version)
+        read_cache_insert(rc, rc->prefetch_offset, rc->prefetch_size, rc->prefetch_buf);
+    else
+        free(rc->prefetch_buf);
+    rc->prefetch_id  = 0;
+    rc->prefetch_buf = NULL;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Track the stride between the reads of an object. Once two reads in a row have the same stride, the
+ * region one stride past the current read is read ahead into the cache. One prefetch per object is in flight.
+ */
+static perr_t
+read_cache_prefetch(struct pdc_read_cache *rc, pdc_transfer_request *p)
+{
+    perr_t               ret_value = SUCCEED;
+    uint64_t             offset    = p->remote_region_offset[0];
+    uint64_t             size      = p->remote_region_size[0];
+    uint64_t             next, zero = 0;
+    int64_t              stride;
+    pdcid_t              local_reg, remote_reg, prefetch_id;
+    struct _pdc_id_info *transferinfo;
+
+    FUNC_ENTER(NULL);
+
+    stride = (int64_t)(offset - rc->last_offset);
+    if (rc->last_size > 0 && stride != 0 && stride == rc->stride)
+        rc->nseq++;
+    else
+        rc->nseq = 0;
+    rc->stride      = stride;
+    rc->last_offset = offset;
+    rc->last_size   = size;
+    if (!pdc_read_prefetch_g || rc->nseq == 0)
+        goto done;
+
+    next = offset + stride;
+    if ((stride < 0 && offset < (uint64_t)(-stride)) || next + size > p->obj_dims[0])
+        goto done;
+    if (read_cache_lookup(rc, next, size) != NULL)
+        goto done;
+    if (rc->prefetch_id != 0) {
+        if (rc->prefetch_offset == next && rc->prefetch_size == size)
+            goto done;
+        read_cache_prefetch_wait(rc);
+    }
+
+    // Read ahead is best effort, the read that triggered it goes on if it can not be started
+    rc->prefetch_buf = (char *)malloc(size * rc->unit);
+    if (rc->prefetch_buf == NULL)
+        goto done;
+    local_reg   = PDCregion_create(1, &zero, &size);
+    remote_reg  = PDCregion_create(1, &next, &size);
+    prefetch_id = PDCregion_transfer_create(rc->prefetch_buf, PDC_READ, rc->obj_id, local_reg, remote_reg);
+    PDCregion_close(local_reg);
+    PDCregion_close(remote_reg);
+    transferinfo = PDC_find_id(prefetch_id);
+    if (transferinfo == NULL) {
+        free(rc->prefetch_buf);
+        rc->prefetch_buf = NULL;
+        PGOTO_ERROR(FAIL, "==PDC_CLIENT[%d]: cannot create the read ahead of object %" PRIu64,
+                    pdc_client_mpi_rank_g, rc->obj_id);
+    }
+    ((pdc_transfer_request *)(transferinfo->obj_ptr))->read_through = 1;
+
+    rc->prefetch_id      = prefetch_id;
+    rc->prefetch_offset  = next;
+    rc->prefetch_size    = size;
+    rc->prefetch_version = rc->version;
+    ret_value            = PDCregion_transfer_start(rc->prefetch_id);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Serve a read from the cache of its object if one cached extent holds all of it. A prefetch covering the
+ * read is waited for first. On a miss the read goes to the data server and fills the cache when it completes.
+ *
+ * Return 1 if the read was served from the cache/0 otherwise
+ */
+static int
+read_cache_start(pdc_transfer_request *p)
+{
+    struct pdc_read_cache *rc = p->obj_pointer->read_cache;
+    pdc_read_cache_entry * entry;
+    uint64_t               offset = p->remote_region_offset[0];
+    uint64_t               size   = p->remote_region_size[0];
+    uint64_t               metrics_start;
+
+    if (rc == NULL) {
+        rc                        = (struct pdc_read_cache *)calloc(1, sizeof(struct pdc_read_cache));
+        rc->obj_id                = p->local_obj_id;
+        rc->unit                  = p->unit;
+        rc->version               = 1;
+        p->obj_pointer->read_cache = rc;
+    }
+
+    if (rc->prefetch_id != 0 && rc->prefetch_offset <= offset &&
+        offset + size <= rc->prefetch_offset + rc->prefetch_size)
+        read_cache_prefetch_wait(rc);
+
+    entry = read_cache_lookup(rc, offset, size);
+    if (entry != NULL) {
+        metrics_start = PDC_metrics_now();
+        memcpy(p->buf + p->local_region_offset[0] * p->unit, entry->buf + (offset - entry->offset) * p->unit,
+               p->total_data_size);
+        DL_DELETE2(pdc_read_cache_lru_g, entry, lru_prev, lru_next);
+        DL_PREPEND2(pdc_read_cache_lru_g, entry, lru_prev, lru_next);
+        p->read_cached = 1;
+        PDC_metrics_record(PDC_METRIC_CLIENT_READ_CACHE_HIT, metrics_start, p->total_data_size);
+    }
+    else
+        p->read_cache_version = rc->version;
+
+    read_cache_prefetch(rc, p);
+    return p->read_cached;
+}
+
+// Report and clear the failed replies of a request posted without waiting, its read data is not cached
+static perr_t
+transfer_request_posted_result(pdc_transfer_request *p)
+{
+    if (p->n_failed == 0)
+        return SUCCEED;
+    p->n_failed           = 0;
+    p->read_cache_version = 0;
+    return FAIL;
+}
+
+// Copy the data of a completed read to the cache, unless the object was written since the read started
+static void
+read_cache_fill(pdc_transfer_request *p)
+{
+    struct pdc_read_cache *rc = p->obj_pointer->read_cache;
+    char *                 buf;
+
+    if (p->read_cache_version != 0 && rc != NULL && rc->version == p->read_cache_version) {
+        buf = (char *)malloc(p->total_data_size);
+        memcpy(buf, p->buf + p->local_region_offset[0] * p->unit, p->total_data_size);
+        read_cache_insert(rc, p->remote_region_offset[0], p->remote_region_size[0], buf);
+    }
+    p->read_cache_version = 0;
+}
+
+perr_t
+PDC_region_transfer_read_cache_close(struct _pdc_obj_info *obj)
+{
+    perr_t                 ret_value = SUCCEED;
+    struct pdc_read_cache *rc        = obj->read_cache;
+
+    FUNC_ENTER(NULL);
+
+    if (rc == NULL)
+        goto done;
+    // The prefetch is waited for so the object close does not find it, its data is dropped with the rest
+    ret_value = read_cache_prefetch_wait(rc);
+    read_cache_invalidate(obj);
+    free(rc);
+    obj->read_cache = NULL;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Complete a request that start served locally, from the write-back buffer or from the read cache
+ */
+static perr_t
+transfer_request_local_complete(pdc_transfer_request *p)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    p->read_cached = 0;
+    if (p->write_buffered)
+        ret_value = write_buffer_complete(p);
+
     FUNC_LEAVE(ret_value);
 }
 
@@ -508,7 +1260,6 @@ static_region_partition(char *buf, int ndim, uint64_t unit, pdc_access_t access_
         }
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 /*
@@ -563,7 +1314,6 @@ pack_region_buffer(char *buf, uint64_t *obj_dims, size_t total_data_size, int lo
         ret_value = FAIL;
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -580,7 +1330,6 @@ set_obj_server_bufs(pdc_transfer_request *transfer_request)
     if (transfer_request->access_type == PDC_READ) {
         transfer_request->read_bulk_buf = (char **)malloc(sizeof(char *) * transfer_request->n_obj_servers);
     }
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -593,6 +1342,7 @@ pack_region_metadata_query(pdc_transfer_request_start_all_pkg **transfer_request
     char *   ptr;
     uint64_t total_buf_size;
     uint8_t  region_partition;
+    uint32_t data_server_id;
 
     FUNC_ENTER(NULL);
 
@@ -609,9 +1359,15 @@ pack_region_metadata_query(pdc_transfer_request_start_all_pkg **transfer_request
     for (i = 0; i < size; ++i) {
         memcpy(ptr, &(transfer_request[i]->transfer_request->obj_id), sizeof(uint64_t));
         ptr += sizeof(uint64_t);
-        memcpy(ptr, &(transfer_request[i]->data_server_id), sizeof(uint32_t));
-        ptr += sizeof(uint32_t);
         region_partition = (uint8_t)transfer_request[i]->transfer_request->region_partition;
+        // The metadata server places a dynamic region near the data server of the writer, not the one the
+        // object was created with
+        if (region_partition == PDC_REGION_DYNAMIC)
+            data_server_id = PDC_get_client_data_server();
+        else
+            data_server_id = transfer_request[i]->data_server_id;
+        memcpy(ptr, &data_server_id, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
         memcpy(ptr, &region_partition, sizeof(uint8_t));
         ptr += sizeof(uint8_t);
         memcpy(ptr, &(transfer_request[i]->transfer_request->remote_region_ndim), sizeof(int));
@@ -627,7 +1383,6 @@ pack_region_metadata_query(pdc_transfer_request_start_all_pkg **transfer_request
     }
 
     *total_buf_size_ptr = total_buf_size;
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -744,7 +1499,6 @@ unpack_region_metadata_query(char *buf, pdc_transfer_request_start_all_pkg **tra
     *transfer_request_end_ptr  = transfer_request_end;
     *size_ptr += size;
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -894,7 +1648,6 @@ register_metadata(pdc_transfer_request_start_all_pkg **transfer_request_input, i
 
     free(transfer_requests);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1108,14 +1861,18 @@ finish_start_all_requests(pdc_transfer_request_start_all_pkg **write_transfer_re
     return 0;
 }
 
+// Write payloads at least this large are registered as their own bulk segment instead of being copied into
+// the packed buffer, smaller ones are cheaper to copy than to register
+#define PDC_BULK_SEGMENT_MIN_SIZE 65536
+
 static perr_t
 PDC_Client_pack_all_requests(int n_objs, pdc_transfer_request_start_all_pkg **transfer_requests,
-                             pdc_access_t access_type, char **bulk_buf_ptr, size_t *total_buf_size_ptr,
+                             pdc_access_t access_type, char **bulk_buf_ptr, struct _pdc_bulk_segments *bulk,
                              char **read_bulk_buf)
 {
     perr_t ret_value = SUCCEED;
     char * bulk_buf, *ptr, *ptr2;
-    size_t total_buf_size, obj_data_size, total_obj_data_size, unit, data_size, metadata_size;
+    size_t total_buf_size, obj_data_size, total_obj_data_size, unit, data_size, metadata_size, copy_size;
     int    i, j;
 
     FUNC_ENTER(NULL);
@@ -1138,10 +1895,12 @@ PDC_Client_pack_all_requests(int n_objs, pdc_transfer_request_start_all_pkg **tr
      *     remote region offset: size(uint64_t) * remote_ndim
      *     remote region length: size(uint64_t) * remote_ndim
      *     obj_dims: size(uint64_t) * remote_ndim
-     *     buf: computed from region length (summed up)
+     * Followed by the data of all objects for PDC_WRITE, in the same order. Data buffers of at least
+     * PDC_BULK_SEGMENT_MIN_SIZE bytes are not copied, they are registered as extra bulk segments.
      */
     data_size           = 0;
     total_obj_data_size = 0;
+    copy_size           = 0;
     for (i = 0; i < n_objs; ++i) {
         // printf("checkpoint i = %d, remote_region_size = %lu, unit = %lu @ line %d\n", i,
         // transfer_requests[i]->remote_size[0], transfer_requests[i]->transfer_request->unit,  __LINE__);
@@ -1149,18 +1908,14 @@ PDC_Client_pack_all_requests(int n_objs, pdc_transfer_request_start_all_pkg **tr
         for (j = 1; j < transfer_requests[i]->transfer_request->remote_region_ndim; ++j) {
             obj_data_size *= transfer_requests[i]->remote_size[j];
         }
-        if (access_type == PDC_WRITE) {
-            data_size += sizeof(uint64_t) * transfer_requests[i]->transfer_request->remote_region_ndim * 3 +
-                         obj_data_size;
-        }
-        else {
-            total_obj_data_size += obj_data_size;
-            data_size += sizeof(uint64_t) * transfer_requests[i]->transfer_request->remote_region_ndim * 3;
-        }
+        total_obj_data_size += obj_data_size;
+        data_size += sizeof(uint64_t) * transfer_requests[i]->transfer_request->remote_region_ndim * 3;
+        if (obj_data_size < PDC_BULK_SEGMENT_MIN_SIZE)
+            copy_size += obj_data_size;
     }
     // printf("checkpoint @ line %d\n", __LINE__);
     if (access_type == PDC_WRITE) {
-        total_buf_size = metadata_size + data_size;
+        total_buf_size = metadata_size + data_size + copy_size;
     }
     else {
         if (metadata_size + data_size < total_obj_data_size) {
@@ -1211,102 +1966,141 @@ PDC_Client_pack_all_requests(int n_objs, pdc_transfer_request_start_all_pkg **tr
                    sizeof(uint64_t) * transfer_requests[i]->transfer_request->remote_region_ndim);
         MEMCPY_INC(transfer_requests[i]->transfer_request->obj_dims,
                    sizeof(uint64_t) * transfer_requests[i]->transfer_request->obj_ndim);
-        // Note buf is undefined for PDC_READ
-        if (access_type == PDC_WRITE) {
+    }
+
+    // The packed buffer is the first segment. Small write payloads are appended to it, and a payload copied
+    // right after another segment extends that segment instead of starting a new one.
+    bulk->count       = 1;
+    bulk->ptrs        = (void **)malloc(sizeof(void *) * (n_objs + 1));
+    bulk->sizes       = (hg_size_t *)malloc(sizeof(hg_size_t) * (n_objs + 1));
+    bulk->ptrs[0]     = bulk_buf;
+    bulk->sizes[0]    = total_buf_size;
+    bulk->total_size  = total_buf_size;
+    bulk->header_size = metadata_size + data_size;
+    // Note buf is undefined for PDC_READ
+    if (access_type == PDC_WRITE) {
+        bulk->sizes[0]   = ptr - bulk_buf;
+        bulk->total_size = metadata_size + data_size + total_obj_data_size;
+        for (i = 0; i < n_objs; ++i) {
+            unit          = transfer_requests[i]->transfer_request->unit;
+            obj_data_size = transfer_requests[i]->remote_size[0] * unit;
+            for (j = 1; j < transfer_requests[i]->transfer_request->remote_region_ndim; ++j) {
+                obj_data_size *= transfer_requests[i]->remote_size[j];
+            }
+            if (obj_data_size >= PDC_BULK_SEGMENT_MIN_SIZE) {
+                bulk->ptrs[bulk->count]  = transfer_requests[i]->buf;
+                bulk->sizes[bulk->count] = obj_data_size;
+                bulk->count++;
+                continue;
+            }
+            if ((char *)bulk->ptrs[bulk->count - 1] + bulk->sizes[bulk->count - 1] == ptr) {
+                bulk->sizes[bulk->count - 1] += obj_data_size;
+            }
+            else {
+                bulk->ptrs[bulk->count]  = ptr;
+                bulk->sizes[bulk->count] = obj_data_size;
+                bulk->count++;
+            }
             MEMCPY_INC(transfer_requests[i]->buf, obj_data_size);
         }
     }
-    *total_buf_size_ptr = total_buf_size;
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
 static perr_t
 PDC_Client_start_all_requests(pdc_transfer_request_start_all_pkg **transfer_requests, int size)
 {
-    perr_t    ret_value = SUCCEED;
-    int       index, i, j;
-    int       n_objs;
-    uint64_t *metadata_id;
-    char **   read_bulk_buf;
-    char *    bulk_buf;
-    size_t    bulk_buf_size;
-    int *     bulk_buf_ref;
+    perr_t                     ret_value = SUCCEED;
+    int                        index, i, j, n_server;
+    int *                      group_start     = NULL;
+    int *                      n_objs          = NULL;
+    int **                     pending         = NULL;
+    int **                     failed          = NULL;
+    uint32_t *                 server_ids      = NULL;
+    uint64_t **                metadata_id_ptr = NULL;
+    char **                    read_bulk_buf   = NULL;
+    char **                    bulk_bufs       = NULL;
+    struct _pdc_bulk_segments *bulk            = NULL;
+    int *                      bulk_buf_ref;
+    pdc_transfer_request *     request;
 
     FUNC_ENTER(NULL);
-    metadata_id   = (uint64_t *)malloc(sizeof(uint64_t) * size);
-    read_bulk_buf = (char **)malloc(sizeof(char *) * size);
-    index         = 0;
+    if (size == 0)
+        PGOTO_DONE(SUCCEED);
+
+    // Requests are sorted by data server, one group per server
+    n_server = 1;
     for (i = 1; i < size; ++i) {
-        if (transfer_requests[i]->data_server_id != transfer_requests[i - 1]->data_server_id) {
-            // Freed at the wait operation (inside PDC_client_connect call)
-            n_objs = i - index;
-            PDC_Client_pack_all_requests(n_objs, transfer_requests + index,
-                                         transfer_requests[index]->transfer_request->access_type, &bulk_buf,
-                                         &bulk_buf_size, read_bulk_buf + index);
-            bulk_buf_ref    = (int *)malloc(sizeof(int));
-            bulk_buf_ref[0] = n_objs;
-            // printf("checkpoint @ line %d, index = %d, dataserver_id = %d, n_objs = %d\n", __LINE__, index,
-            // transfer_requests[index]->data_server_id, n_objs);
-            PDC_Client_transfer_request_all(n_objs, transfer_requests[index]->transfer_request->access_type,
-                                            transfer_requests[index]->data_server_id, bulk_buf, bulk_buf_size,
-                                            metadata_id + index);
-            // printf("transfer request towards data server %d\n", transfer_requests[index]->data_server_id);
-            for (j = index; j < i; ++j) {
-                // All requests share the same bulk buffer, reference counter is also shared among all
-                // requests.
-                transfer_requests[j]->transfer_request->bulk_buf[transfer_requests[j]->index] = bulk_buf;
-                transfer_requests[j]->transfer_request->bulk_buf_ref[transfer_requests[j]->index] =
-                    bulk_buf_ref;
-                if (transfer_requests[j]->transfer_request->access_type == PDC_READ) {
-                    transfer_requests[j]->transfer_request->read_bulk_buf[transfer_requests[j]->index] =
-                        read_bulk_buf[j];
-                }
-                transfer_requests[j]->transfer_request->metadata_id[transfer_requests[j]->index] =
-                    metadata_id[j];
-                // printf("obj_id = %lu, set transfer_request metadata_id[%d] = %lu\n",
-                // transfer_requests[j]->transfer_request->obj_id, transfer_requests[j]->index,
-                // metadata_id[j]);
-            }
-            index = i;
-        }
-    }
-    if (size) {
+        if (transfer_requests[i]->data_server_id != transfer_requests[i - 1]->data_server_id)
+            n_server++;
+    }
+    metadata_id_ptr = (uint64_t **)malloc(sizeof(uint64_t *) * size);
+    pending         = (int **)malloc(sizeof(int *) * size);
+    failed          = (int **)malloc(sizeof(int *) * size);
+    read_bulk_buf   = (char **)malloc(sizeof(char *) * size);
+    group_start     = (int *)malloc(sizeof(int) * (n_server + 1));
+    n_objs          = (int *)malloc(sizeof(int) * n_server);
+    server_ids      = (uint32_t *)malloc(sizeof(uint32_t) * n_server);
+    bulk_bufs       = (char **)malloc(sizeof(char *) * n_server);
+    bulk            = (struct _pdc_bulk_segments *)calloc(n_server, sizeof(struct _pdc_bulk_segments));
+
+    index = 0;
+    for (i = 0; i < size; ++i) {
+        if (i == 0 || transfer_requests[i]->data_server_id != transfer_requests[i - 1]->data_server_id)
+            group_start[index++] = i;
+        // The reply of the data server fills in the metadata_id of each request directly
+        request            = transfer_requests[i]->transfer_request;
+        metadata_id_ptr[i] = &request->metadata_id[transfer_requests[i]->index];
+        pending[i]         = &request->n_pending;
+        failed[i]          = &request->n_failed;
+    }
+    group_start[n_server] = size;
+
+    // Pack every group first, the forwards to all servers then go out back to back
+    for (index = 0; index < n_server; ++index) {
+        i             = group_start[index];
+        n_objs[index] = group_start[index + 1] - i;
         // Freed at the wait operation (inside PDC_client_connect call)
-        n_objs = size - index;
-        // printf("checkpoint @ line %d\n", __LINE__);
-        PDC_Client_pack_all_requests(n_objs, transfer_requests + index,
-                                     transfer_requests[index]->transfer_request->access_type, &bulk_buf,
-                                     &bulk_buf_size, read_bulk_buf + index);
-        // printf("checkpoint @ line %d\n", __LINE__);
+        PDC_Client_pack_all_requests(n_objs[index], transfer_requests + i,
+                                     transfer_requests[i]->transfer_request->access_type, &bulk_bufs[index],
+                                     &bulk[index], read_bulk_buf + i);
+        server_ids[index] = transfer_requests[i]->data_server_id;
+    }
+    ret_value = PDC_Client_transfer_request_all_batch(n_server, n_objs,
+                                                      transfer_requests[0]->transfer_request->access_type,
+                                                      server_ids, bulk, metadata_id_ptr, pending, failed);
+
+    for (index = 0; index < n_server; ++index) {
         bulk_buf_ref    = (int *)malloc(sizeof(int));
-        bulk_buf_ref[0] = n_objs;
-        // printf("checkpoint @ line %d, index = %d, dataserver_id = %d, n_objs = %d\n", __LINE__, index,
-        // transfer_requests[index]->data_server_id, n_objs);
-        PDC_Client_transfer_request_all(n_objs, transfer_requests[index]->transfer_request->access_type,
-                                        transfer_requests[index]->data_server_id, bulk_buf, bulk_buf_size,
-                                        metadata_id + index);
-        // printf("transfer request towards data server %d\n", transfer_requests[index]->data_server_id);
-        for (j = index; j < size; ++j) {
+        bulk_buf_ref[0] = n_objs[index];
+        for (j = group_start[index]; j < group_start[index + 1]; ++j) {
             // All requests share the same bulk buffer, reference counter is also shared among all
             // requests.
-            // printf("checkpoint @ line %d, j = %d, %d\n", __LINE__, j,
-            // transfer_requests[j]->data_server_id);
-            transfer_requests[j]->transfer_request->bulk_buf[transfer_requests[j]->index]     = bulk_buf;
-            transfer_requests[j]->transfer_request->bulk_buf_ref[transfer_requests[j]->index] = bulk_buf_ref;
-            if (transfer_requests[j]->transfer_request->access_type == PDC_READ) {
-                transfer_requests[j]->transfer_request->read_bulk_buf[transfer_requests[j]->index] =
-                    read_bulk_buf[j];
-            }
-            transfer_requests[j]->transfer_request->metadata_id[transfer_requests[j]->index] = metadata_id[j];
-            // printf("obj_id = %lu, set transfer_request metadata_id[%d] = %lu\n",
-            // transfer_requests[j]->transfer_request->obj_id, transfer_requests[j]->index, metadata_id[j]);
+            request                                            = transfer_requests[j]->transfer_request;
+            request->bulk_buf[transfer_requests[j]->index]     = bulk_bufs[index];
+            request->bulk_buf_ref[transfer_requests[j]->index] = bulk_buf_ref;
+            if (request->access_type == PDC_READ)
+                request->read_bulk_buf[transfer_requests[j]->index] = read_bulk_buf[j];
         }
     }
+done:
+    free(metadata_id_ptr);
+    free(pending);
+    free(failed);
     free(read_bulk_buf);
-    free(metadata_id);
+    free(group_start);
+    free(n_objs);
+    free(server_ids);
+    free(bulk_bufs);
+    if (bulk != NULL) {
+        // The bulk handles keep their own copy of the segment list
+        for (index = 0; index < n_server; ++index) {
+            free(bulk[index].ptrs);
+            free(bulk[index].sizes);
+        }
+        free(bulk);
+    }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1317,8 +2111,42 @@ PDCregion_transfer_start_all(pdcid_t *transfer_request_id, int size)
     int                                  write_size = 0, read_size = 0, posix_size = 0;
     pdc_transfer_request_start_all_pkg **write_transfer_requests = NULL, **read_transfer_requests = NULL;
     pdcid_t *                            posix_transfer_request_id;
+    pdcid_t *                            remote_id = NULL;
+    pdc_transfer_request *               transfer_request;
+    int                                  i, n_remote;
 
     FUNC_ENTER(NULL);
+    // Small writes go to the write-back buffers and cached reads are served locally, the other requests are
+    // started below
+    if (pdc_write_buffer_size_g > 0 || pdc_read_cache_size_g > 0) {
+        remote_id = (pdcid_t *)malloc(sizeof(pdcid_t) * size);
+        if (remote_id == NULL)
+            PGOTO_ERROR(FAIL, "PDC_CLIENT[%d]: cannot allocate %d request IDs", pdc_client_mpi_rank_g, size);
+        n_remote = 0;
+        for (i = 0; i < size; ++i) {
+            transfer_request = (pdc_transfer_request *)(PDC_find_id(transfer_request_id[i])->obj_ptr);
+            if (transfer_request->access_type == PDC_WRITE)
+                read_cache_invalidate(transfer_request->obj_pointer);
+            if (write_buffer_eligible(transfer_request)) {
+                if (write_buffer_add(transfer_request) != SUCCEED)
+                    ret_value = FAIL;
+                continue;
+            }
+            // A request must not overtake the buffered writes before it, it is not started if they fail
+            if (!transfer_request->write_through &&
+                write_buffer_sync(transfer_request->obj_pointer) != SUCCEED) {
+                ret_value = FAIL;
+                continue;
+            }
+            if (read_cache_eligible(transfer_request) && read_cache_start(transfer_request))
+                continue;
+            remote_id[n_remote++] = transfer_request_id[i];
+        }
+        transfer_request_id = remote_id;
+        size                = n_remote;
+        if (size == 0)
+            goto done;
+    }
     // Split write and read requests. Handle them separately.
     // printf("PDCregion_transfer_start_all: checkpoint %d\n", __LINE__);
     prepare_start_all_requests(transfer_request_id, size, &write_transfer_requests, &read_transfer_requests,
@@ -1334,23 +2162,28 @@ PDCregion_transfer_start_all(pdcid_t *transfer_request_id, int size)
     */
 
     // Start write requests
-    PDC_Client_start_all_requests(write_transfer_requests, write_size);
+    if (PDC_Client_start_all_requests(write_transfer_requests, write_size) != SUCCEED)
+        ret_value = FAIL;
     // printf("PDCregion_transfer_start_all: checkpoint %d\n", __LINE__);
     // Start read requests
-    PDC_Client_start_all_requests(read_transfer_requests, read_size);
+    if (PDC_Client_start_all_requests(read_transfer_requests, read_size) != SUCCEED)
+        ret_value = FAIL;
     /*
         fprintf(stderr, "PDCregion_transfer_start_all: checkpoint %d\n", __LINE__);
         MPI_Barrier(MPI_COMM_WORLD);
     */
 
     // For POSIX consistency, we block here until the data is received by the server
-    PDCregion_transfer_wait_all(posix_transfer_request_id, posix_size);
+    if (PDCregion_transfer_wait_all(posix_transfer_request_id, posix_size) != SUCCEED)
+        ret_value = FAIL;
     free(posix_transfer_request_id);
 
     // Clean up memory
     finish_start_all_requests(write_transfer_requests, read_transfer_requests, write_size, read_size);
     // fprintf(stderr, "PDCregion_transfer_start_all: checkpoint %d\n", __LINE__);
     // MPI_Barrier(MPI_COMM_WORLD);
+done:
+    free(remote_id);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1432,12 +2265,22 @@ PDCregion_transfer_start(pdcid_t transfer_request_id)
         ret_value = FAIL;
         goto done;
     }
+    if (transfer_request->access_type == PDC_WRITE)
+        read_cache_invalidate(transfer_request->obj_pointer);
+    if (write_buffer_eligible(transfer_request)) {
+        ret_value = write_buffer_add(transfer_request);
+        goto done;
+    }
+    if (!transfer_request->write_through && write_buffer_sync(transfer_request->obj_pointer) != SUCCEED)
+        PGOTO_ERROR(FAIL, "PDC Client PDCregion_transfer_start failed to send the buffered writes before it");
+    if (read_cache_eligible(transfer_request) && read_cache_start(transfer_request))
+        goto done;
     // Dynamic case is implemented within the the aggregated version. The main reason is that the target data
     // server may not be unique, so we may end up sending multiple requests to the same data server.
     // Aggregated method will take care of this type of operation.
     if (transfer_request->region_partition == PDC_REGION_DYNAMIC ||
         transfer_request->region_partition == PDC_REGION_LOCAL) {
-        PDCregion_transfer_start_all(&transfer_request_id, 1);
+        ret_value = PDCregion_transfer_start_all(&transfer_request_id, 1);
         goto done;
     }
 
@@ -1484,7 +2327,8 @@ PDCregion_transfer_start(pdcid_t transfer_request_id)
                 transfer_request->output_buf[i], transfer_request->obj_id, transfer_request->obj_servers[i],
                 transfer_request->obj_ndim, transfer_request->obj_dims, transfer_request->remote_region_ndim,
                 transfer_request->output_offsets[i], transfer_request->output_sizes[i], unit,
-                transfer_request->access_type, transfer_request->metadata_id + i);
+                transfer_request->access_type, transfer_request->metadata_id + i,
+                &transfer_request->n_pending, &transfer_request->n_failed);
         }
     }
     else if (transfer_request->region_partition == PDC_OBJ_STATIC) {
@@ -1503,7 +2347,8 @@ PDCregion_transfer_start(pdcid_t transfer_request_id)
             transfer_request->new_buf, transfer_request->obj_id, transfer_request->data_server_id,
             transfer_request->obj_ndim, transfer_request->obj_dims, transfer_request->remote_region_ndim,
             transfer_request->remote_region_offset, transfer_request->remote_region_size, unit,
-            transfer_request->access_type, transfer_request->metadata_id);
+            transfer_request->access_type, transfer_request->metadata_id, &transfer_request->n_pending,
+            &transfer_request->n_failed);
     }
 
     // For POSIX consistency, we block here until the data is received by the server
@@ -1512,7 +2357,6 @@ PDCregion_transfer_start(pdcid_t transfer_request_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1571,7 +2415,6 @@ release_region_buffer(char *buf, uint64_t *obj_dims, int local_ndim, uint64_t *l
         free(read_bulk_buf);
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1588,7 +2431,25 @@ PDCregion_transfer_status(pdcid_t transfer_request_id, pdc_transfer_status_t *co
 
     transferinfo     = PDC_find_id(transfer_request_id);
     transfer_request = (pdc_transfer_request *)(transferinfo->obj_ptr);
+    if (transfer_request->write_buffered || transfer_request->read_cached) {
+        ret_value  = transfer_request_local_complete(transfer_request);
+        *completed = PDC_TRANSFER_STATUS_COMPLETE;
+        goto done;
+    }
     if (transfer_request->metadata_id != NULL) {
+        // A request posted in the background is pending until every data server has replied
+        if (transfer_request->n_pending > 0) {
+            PDC_Client_transfer_request_progress();
+            if (transfer_request->n_pending > 0) {
+                *completed = PDC_TRANSFER_STATUS_PENDING;
+                goto done;
+            }
+        }
+        // The request stays failed until wait releases it
+        if (transfer_request->n_failed > 0) {
+            *completed = PDC_TRANSFER_STATUS_COMPLETE;
+            PGOTO_ERROR(FAIL, "PDCregion_transfer_status(): a data server failed the transfer request");
+        }
         unit = transfer_request->unit;
 
         if (transfer_request->region_partition == PDC_REGION_STATIC ||
@@ -1665,6 +2526,7 @@ PDCregion_transfer_status(pdcid_t transfer_request_id, pdc_transfer_status_t *co
                 transfer_request->access_type, transfer_request->n_obj_servers, transfer_request->new_buf,
                 transfer_request->bulk_buf, transfer_request->bulk_buf_ref, transfer_request->read_bulk_buf);
         }
+        read_cache_fill(transfer_request);
         free(transfer_request->metadata_id);
         transfer_request->metadata_id = NULL;
         remove_local_transfer_request(transfer_request->obj_pointer, transfer_request_id);
@@ -1673,7 +2535,6 @@ PDCregion_transfer_status(pdcid_t transfer_request_id, pdc_transfer_status_t *co
         *completed = PDC_TRANSFER_STATUS_NOT_FOUND;
     }
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1690,12 +2551,37 @@ PDCregion_transfer_wait_all(pdcid_t *transfer_request_id, int size)
 
     struct _pdc_id_info * transferinfo;
     pdc_transfer_request *transfer_request;
+    pdcid_t *             unbuffered_id;
 
     FUNC_ENTER(NULL);
     if (!size) {
         goto done;
     }
 
+    // Requests served locally by start are completed here, the other requests are waited for as usual
+    for (i = 0; i < size; ++i) {
+        transfer_request = (pdc_transfer_request *)(PDC_find_id(transfer_request_id[i])->obj_ptr);
+        if (transfer_request->write_buffered || transfer_request->read_cached)
+            break;
+    }
+    if (i < size) {
+        unbuffered_id = (pdcid_t *)malloc(sizeof(pdcid_t) * size);
+        n_objs        = 0;
+        for (i = 0; i < size; ++i) {
+            transfer_request = (pdc_transfer_request *)(PDC_find_id(transfer_request_id[i])->obj_ptr);
+            if (transfer_request->write_buffered || transfer_request->read_cached) {
+                if (transfer_request_local_complete(transfer_request) != SUCCEED)
+                    ret_value = FAIL;
+            }
+            else
+                unbuffered_id[n_objs++] = transfer_request_id[i];
+        }
+        if (PDCregion_transfer_wait_all(unbuffered_id, n_objs) != SUCCEED)
+            ret_value = FAIL;
+        free(unbuffered_id);
+        goto done;
+    }
+
     // printf("entered PDCregion_transfer_wait_all @ line %d\n", __LINE__);
     total_requests        = 0;
     transfer_request_head = NULL;
@@ -1710,6 +2596,7 @@ PDCregion_transfer_wait_all(pdcid_t *transfer_request_id, int size)
             ret_value = FAIL;
             goto done;
         }
+        PDC_Client_transfer_request_wait_posted(&transfer_request->n_pending);
         total_requests += transfer_request->n_obj_servers;
         for (j = 0; j < transfer_request->n_obj_servers; ++j) {
             if (transfer_request_head) {
@@ -1868,6 +2755,9 @@ PDCregion_transfer_wait_all(pdcid_t *transfer_request_id, int size)
             }
             free(transfer_request->obj_servers);
         }
+        if (transfer_request_posted_result(transfer_request) != SUCCEED)
+            ret_value = FAIL;
+        read_cache_fill(transfer_request);
         free(transfer_request->metadata_id);
         transfer_request->metadata_id = NULL;
         remove_local_transfer_request(transfer_request->obj_pointer, transfer_request_id[i]);
@@ -1884,7 +2774,6 @@ PDCregion_transfer_wait_all(pdcid_t *transfer_request_id, int size)
             }
     */
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1901,7 +2790,12 @@ PDCregion_transfer_wait(pdcid_t transfer_request_id)
 
     transferinfo     = PDC_find_id(transfer_request_id);
     transfer_request = (pdc_transfer_request *)(transferinfo->obj_ptr);
+    if (transfer_request->write_buffered || transfer_request->read_cached) {
+        ret_value = transfer_request_local_complete(transfer_request);
+        goto done;
+    }
     if (transfer_request->metadata_id != NULL) {
+        PDC_Client_transfer_request_wait_posted(&transfer_request->n_pending);
         // For region dynamic case, it is implemented in the aggregated version for portability.
         if (transfer_request->region_partition == PDC_REGION_DYNAMIC ||
             transfer_request->region_partition == PDC_REGION_LOCAL) {
@@ -1977,6 +2871,9 @@ PDCregion_transfer_wait(pdcid_t transfer_request_id)
                 transfer_request->access_type, transfer_request->n_obj_servers, transfer_request->new_buf,
                 transfer_request->bulk_buf, transfer_request->bulk_buf_ref, transfer_request->read_bulk_buf);
         }
+        if (transfer_request_posted_result(transfer_request) != SUCCEED)
+            ret_value = FAIL;
+        read_cache_fill(transfer_request);
         free(transfer_request->metadata_id);
         transfer_request->metadata_id = NULL;
         remove_local_transfer_request(transfer_request->obj_pointer, transfer_request_id);
@@ -1991,6 +2888,5 @@ PDCregion_transfer_wait(pdcid_t transfer_request_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
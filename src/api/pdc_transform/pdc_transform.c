@@ -152,7 +152,6 @@ PDCobj_transform_register(char *func, pdcid_t obj_id, int current_state, int nex
     }
 
 done:
-    fflush(stdout);
     if (applicationDir)
         free(applicationDir);
     if (userdefinedftn)
@@ -260,7 +259,6 @@ PDCbuf_map_transform_register(char *func, void *buf, pdcid_t src_region_id, pdci
                                          (int)when, local_regIndex);
 
 done:
-    fflush(stdout);
     if (applicationDir)
         free(applicationDir);
     if (userdefinedftn)
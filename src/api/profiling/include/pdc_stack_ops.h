@@ -8,63 +8,80 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <time.h>
+#include <stdint.h>
 
 typedef void *hash_table_t;
 
-typedef struct profileEntry {
-    struct profileEntry *next;
-    struct profileEntry *prev;
-    const char *         ftnkey;
-    const char *         tags;
-    int64_t              count;
-    int64_t              localTotal;
-    int64_t              CumTotal;
-    int64_t              locmin;
-    int64_t              locmax;
-    double               usecTotal;
-    struct timespec      callTime;
-    struct timespec      startTime;
-    struct timespec      totalTime;
-    struct timespec      selfTime;
+/* Stack depth recorded per thread, deeper calls are counted but not timed */
+#define PROFILE_MAX_DEPTH 256
+/* Trace events per allocation of a thread trace buffer */
+#define PROFILE_TRACE_CHUNK_SIZE 4096
+/* Trace events kept per thread, override with PROFILE_TRACE_MAX_EVENTS */
+#define PROFILE_TRACE_MAX_EVENTS_DEFAULT 4194304
+
+#define PROFILE_HASH_PTR(p) ((size_t)(((uintptr_t)(p) >> 3) * 0x9e3779b97f4a7c15ULL >> 16))
 
-    struct profileEntry *parent;
+/* Merged stats of a function, times in nanoseconds */
+typedef struct profileEntry {
+    const char *ftnkey;
+    int64_t     count;
+    int64_t     totalTime;
+    int64_t     selfTime;
 } profileEntry_t;
 
-// typedef enum _boolean {FALSE = 0, TRUE} bool_t;
-extern pbool_t enableProfiling;
+typedef struct profileFrame {
+    const char *ftnkey;
+    const char *tags;
+    int64_t     startTime;
+    int64_t     callTime; /* time spent in profiled callees */
+} profileFrame_t;
 
-#ifndef RESET_TIMER
-#define RESET_TIMER(x) (x).tv_sec = (x).tv_nsec = 0;
-#endif
+typedef struct profileStat {
+    const char *ftnkey;
+    int64_t     count;
+    int64_t     totalTime;
+    int64_t     selfTime;
+} profileStat_t;
 
-#ifndef TIMER_DIFF
-/* t0 = t1 - t2 */
-#define TIMER_DIFF(t0, t1, t2)                                                                               \
-    {                                                                                                        \
-        if (t2.tv_nsec > (t1).tv_nsec) {                                                                     \
-            (t1).tv_nsec += 1000000000;                                                                      \
-            (t1).tv_sec -= 1;                                                                                \
-        }                                                                                                    \
-        (t0).tv_sec  = (t1).tv_sec - (t2).tv_sec;                                                            \
-        (t0).tv_nsec = (t1).tv_nsec - (t2).tv_nsec;                                                          \
-    }
-#endif
+typedef struct traceEvent {
+    const char *name;
+    const char *tags;
+    int64_t     start;
+    int64_t     dur;
+    uint64_t    id;
+    char        phase; /* 'X' for a call, 's'/'t'/'f' for a request flow */
+} traceEvent_t;
 
-#ifndef TIMER_ADD
-/* t0 += t1 */
-#define TIMER_ADD(t0, t1)                                                                                    \
-    {                                                                                                        \
-        (t0).tv_sec += (t1).tv_sec;                                                                          \
-        if (((t0).tv_nsec += (t1).tv_nsec) > 10000000000) {                                                  \
-            (t0).tv_sec += 1;                                                                                \
-            (t0).tv_nsec -= 10000000000;                                                                     \
-        }                                                                                                    \
-    }
-#endif
+typedef struct traceChunk {
+    struct traceChunk *next;
+    int                n;
+    traceEvent_t       events[PROFILE_TRACE_CHUNK_SIZE];
+} traceChunk_t;
+
+/* Profile state of one thread, only touched by the thread itself until the program exits */
+typedef struct profileThread {
+    struct profileThread *next;
+    int                   tid;
+    int                   depth;
+    int                   sampled; /* the current call tree is recorded */
+    uint64_t              nroot;
+    profileFrame_t        stack[PROFILE_MAX_DEPTH];
+    profileStat_t *       stats; /* open addressing table keyed by ftnkey */
+    size_t                nstat;
+    size_t                statCap;
+    traceChunk_t *        traceHead;
+    traceChunk_t *        traceTail;
+    int64_t               ntrace;
+    int64_t               ndropped;
+} profileThread_t;
+
+// typedef enum _boolean {FALSE = 0, TRUE} bool_t;
+extern pbool_t enableProfiling;
 
 void initialize_profile(void **table, size_t tabsize);
 void finalize_profile();
 void push(const char *ftnkey, const char *tags);
 void pop();
+void profile_flow(const char *name, uint64_t id, char phase);
 
 #endif
@@ -1,12 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include "pdc_stack_ops.h"
 #include "pdc_hashtab.h"
 
-profileEntry_t *calltree = NULL;
-profileEntry_t *freelist = NULL;
-
 static int profilerrors = 0;
 
 hash_table_t hashtable;
@@ -19,6 +17,22 @@ htab_t thisHashTable;
  */
 pbool_t enableProfiling = FALSE;
 
+/* Record one of every sampleRate call trees of a thread, set with PROFILE_SAMPLE_RATE */
+static uint64_t sampleRate = 1;
+
+/* Chrome trace file prefix from PROFILE_TRACE, NULL if no trace is written */
+static char *  traceFilePrefix = NULL;
+static int64_t traceMaxEvents  = PROFILE_TRACE_MAX_EVENTS_DEFAULT;
+
+/* Wall clock minus the profile clock, so traces of different processes line up */
+static int64_t clockOffset = 0;
+
+static profileThread_t *allThreads     = NULL;
+static int              nextThreadId   = 0;
+static pthread_mutex_t  allThreadsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread profileThread_t *thisThread = NULL;
+
 /*
  *  The idea of this implementation is to simulate the call stack
  *  of the running application.  Each function that we care about
@@ -57,17 +71,17 @@ pbool_t enableProfiling = FALSE;
  *  or 3rd party libraries, i.e. the underlying functions will NOT
  *  be profiled.
  *
- *  The implementation of stack_ops will maintain a call tree
- *  that mirrors that of the actual program, i.e. the alltree data
- *  structure will contain something like the following as we enter
- *  the first function contained by a():
+ *  The implementation of stack_ops will maintain a call stack
+ *  per thread that mirrors that of the actual program, i.e. the
+ *  stack of the main thread will contain something like the
+ *  following as we enter the first function contained by a():
  *
  *     ("main") --> ("a") --> ("aa")
  *
  *  The entry for "main" has a /start_time and no /total_time
  *  Similarly, "a" has it's own /start_time and no /total_time
  *  The final entry: "aa" has a start-time and just prior to
- *  the return to it's parent ("a"), we sample the real-time
+ *  the return to it's parent ("a"), we sample the monotonic
  *  clock as part of the POP functionality. Using the current
  *  time minus the start-time we establish the raw total elapsed
  *  time for the current function.
@@ -80,80 +94,191 @@ pbool_t enableProfiling = FALSE;
  *  Ultimately, if were to execute the entire program and then
  *  sum all of the individual profile times, the total should
  *  match the execution time of the program.
+ *
+ *  Each thread adds up the times of its functions in its own
+ *  table without any locking, the tables of all threads are
+ *  merged into the profile hashtable when the program exits.
+ *  With PROFILE_TRACE set, every call also becomes a complete
+ *  event of a Chrome trace (chrome://tracing or Perfetto), and
+ *  profile_flow() links the spans of different processes that
+ *  work on the same request.
  */
 
-void
-push(const char *ftnkey, const char *tags)
+static inline int64_t
+profile_now(void)
+{
+    struct timespec now;
+
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static profileThread_t *
+profile_thread_create(void)
 {
-    profileEntry_t *thisEntry;
-    if (freelist != NULL) {
-        thisEntry = freelist;
-        freelist  = thisEntry->next;
+    profileThread_t *thread;
+
+    if ((thread = (profileThread_t *)calloc(1, sizeof(profileThread_t))) == NULL) {
+        perror("calloc");
+        profilerrors++;
+        return NULL;
     }
-    else {
-        if ((thisEntry = (profileEntry_t *)malloc(sizeof(profileEntry_t))) == NULL) {
-            perror("malloc");
+
+    pthread_mutex_lock(&allThreadsLock);
+    thread->tid  = nextThreadId++;
+    thread->next = allThreads;
+    allThreads   = thread;
+    pthread_mutex_unlock(&allThreadsLock);
+
+    thisThread = thread;
+    return thread;
+}
+
+/* Find the stats of a function in the table of the calling thread, keyed by the
+ * address of its name as the ftnkey is always __func__
+ */
+static profileStat_t *
+profile_stat_lookup(profileThread_t *thread, const char *ftnkey)
+{
+    profileStat_t *old_stats;
+    size_t         i, j, old_cap;
+
+    if (thread->nstat * 2 >= thread->statCap) {
+        old_stats       = thread->stats;
+        old_cap         = thread->statCap;
+        thread->statCap = old_cap == 0 ? 256 : old_cap * 2;
+        if ((thread->stats = (profileStat_t *)calloc(thread->statCap, sizeof(profileStat_t))) == NULL) {
+            thread->stats   = old_stats;
+            thread->statCap = old_cap;
             profilerrors++;
+            return NULL;
+        }
+        for (i = 0; i < old_cap; i++) {
+            if (old_stats[i].ftnkey == NULL)
+                continue;
+            j = PROFILE_HASH_PTR(old_stats[i].ftnkey) & (thread->statCap - 1);
+            while (thread->stats[j].ftnkey != NULL)
+                j = (j + 1) & (thread->statCap - 1);
+            thread->stats[j] = old_stats[i];
+        }
+        free(old_stats);
+    }
+
+    i = PROFILE_HASH_PTR(ftnkey) & (thread->statCap - 1);
+    while (thread->stats[i].ftnkey != ftnkey) {
+        if (thread->stats[i].ftnkey == NULL) {
+            thread->stats[i].ftnkey = ftnkey;
+            thread->nstat++;
+            break;
         }
+        i = (i + 1) & (thread->statCap - 1);
     }
+    return &thread->stats[i];
+}
+
+static void
+profile_trace_add(profileThread_t *thread, char phase, const char *name, const char *tags, int64_t start,
+                  int64_t dur, uint64_t id)
+{
+    traceChunk_t *chunk = thread->traceTail;
+    traceEvent_t *event;
 
-    if (profilerrors)
+    if (thread->ntrace >= traceMaxEvents) {
+        thread->ndropped++;
         return;
-    thisEntry->ftnkey = ftnkey;
-    thisEntry->tags   = tags;
-    thisEntry->prev   = calltree;
-    thisEntry->next   = NULL;
-    calltree          = thisEntry;
+    }
+    if (chunk == NULL || chunk->n == PROFILE_TRACE_CHUNK_SIZE) {
+        if ((chunk = (traceChunk_t *)malloc(sizeof(traceChunk_t))) == NULL) {
+            thread->ndropped++;
+            return;
+        }
+        chunk->n    = 0;
+        chunk->next = NULL;
+        if (thread->traceTail == NULL)
+            thread->traceHead = chunk;
+        else
+            thread->traceTail->next = chunk;
+        thread->traceTail = chunk;
+    }
+
+    event        = &chunk->events[chunk->n++];
+    event->phase = phase;
+    event->name  = name;
+    event->tags  = tags;
+    event->start = start;
+    event->dur   = dur;
+    event->id    = id;
+    thread->ntrace++;
+}
+
+void
+push(const char *ftnkey, const char *tags)
+{
+    profileThread_t *thread = thisThread;
+    profileFrame_t * frame;
+
+    if (thread == NULL && (thread = profile_thread_create()) == NULL)
+        return;
+
+    /* Sampling decides once per call tree, so a recorded tree is always complete */
+    if (thread->depth == 0)
+        thread->sampled = (thread->nroot++ % sampleRate) == 0;
+    if (thread->depth++ >= PROFILE_MAX_DEPTH || !thread->sampled)
+        return;
+
+    frame           = &thread->stack[thread->depth - 1];
+    frame->ftnkey   = ftnkey;
+    frame->tags     = tags;
+    frame->callTime = 0;
 
     /* Timing */
-    clock_gettime(CLOCK_REALTIME, &thisEntry->startTime);
-    RESET_TIMER(thisEntry->callTime);
-    return;
+    frame->startTime = profile_now();
 }
 
 void
 pop()
 {
-    struct timespec current_time;
-    profileEntry_t *master;
-    profileEntry_t *thisEntry    = calltree;
-    int             update_entry = TRUE;
-    if (thisEntry == NULL)
+    profileThread_t *thread = thisThread;
+    profileFrame_t * frame;
+    profileStat_t *  stat;
+    int64_t          totalTime;
+
+    if (thread == NULL || thread->depth == 0)
         return; /* This shouldn't happen */
+    if (--thread->depth >= PROFILE_MAX_DEPTH || !thread->sampled)
+        return;
 
     /* Timing */
-    clock_gettime(CLOCK_REALTIME, &current_time);
-    TIMER_DIFF(thisEntry->totalTime, current_time, thisEntry->startTime);
-    TIMER_DIFF(thisEntry->selfTime, thisEntry->totalTime, thisEntry->callTime);
-    calltree = thisEntry->prev;
-    if (calltree != NULL) {
-        TIMER_ADD(calltree->callTime, thisEntry->totalTime);
-    }
-    /* Check to see if this function has already been added to the hashtable */
-    void **tableEntry = htab_find_slot(thisHashTable, thisEntry, INSERT);
-    if (*tableEntry == NULL) {
-        /* No table entry found so add it now ... */
-        master = (profileEntry_t *)malloc(sizeof(profileEntry_t));
-        if (master) {
-            thisEntry->count = 1;
-            memcpy(master, thisEntry, sizeof(profileEntry_t));
-            *tableEntry = master;
-        }
-        update_entry = FALSE;
-    }
+    frame     = &thread->stack[thread->depth];
+    totalTime = profile_now() - frame->startTime;
+    if (thread->depth > 0)
+        thread->stack[thread->depth - 1].callTime += totalTime;
 
-    if (update_entry) {
-        master = *(profileEntry_t **)tableEntry;
-        master->count++;
-        TIMER_ADD(master->totalTime, thisEntry->totalTime);
-        TIMER_ADD(master->selfTime, thisEntry->selfTime);
+    if ((stat = profile_stat_lookup(thread, frame->ftnkey)) != NULL) {
+        stat->count++;
+        stat->totalTime += totalTime;
+        stat->selfTime += totalTime - frame->callTime;
     }
 
-    /* Rather than freeing the container, we add the
-     * current entry onto the freelist.
-     */
-    thisEntry->next = freelist;
-    freelist        = thisEntry;
+    if (traceFilePrefix != NULL)
+        profile_trace_add(thread, 'X', frame->ftnkey, frame->tags, frame->startTime, totalTime, 0);
+}
+
+void
+profile_flow(const char *name, uint64_t id, char phase)
+{
+    profileThread_t *thread = thisThread;
+
+    if (traceFilePrefix == NULL)
+        return;
+    if (thread == NULL && (thread = profile_thread_create()) == NULL)
+        return;
+
+    profile_trace_add(thread, phase, name, NULL, profile_now(), 0, id);
 }
 
 hashval_t
@@ -187,22 +312,108 @@ show_profile_info(void **ht_live_entry, void *extraInfo ATTRIBUTE(unused))
 {
     static int count     = 0;
     char *     LineBreak = "------------------------------------------------------------------------------";
-    char *     header    = " item  calls Time/call [Sec,nSec]\tftn_name";
+    char *     header    = " item  calls    total [ms]     self [ms]  Time/call [us]\tftn_name";
     const profileEntry_t *thisEntry = *(const profileEntry_t **)ht_live_entry;
 
     if (thisEntry) {
-        struct timespec totalTime;
-        int64_t         totalCalls = thisEntry->count;
+        int64_t totalCalls = thisEntry->count;
         if (count == 0)
             puts(header);
-        totalTime = thisEntry->totalTime;
-        printf("%s\n %d\t%-6" PRId64 " %6" PRId64 ",%6" PRId64 "\t\t %s\n", LineBreak, ++count, totalCalls,
-               totalTime.tv_sec / totalCalls, totalTime.tv_nsec / totalCalls, thisEntry->ftnkey);
+        printf("%s\n %d\t%-6" PRId64 " %13.3f %13.3f %15.3f\t %s\n", LineBreak, ++count, totalCalls,
+               thisEntry->totalTime / 1e6, thisEntry->selfTime / 1e6,
+               thisEntry->totalTime / 1e3 / totalCalls, thisEntry->ftnkey);
     }
 
     return TRUE;
 }
 
+/* Add the function stats of all threads into the profile hashtable */
+static void
+profile_merge_threads(void)
+{
+    profileThread_t *thread;
+    profileEntry_t * master, key;
+    void **          tableEntry;
+    size_t           i;
+
+    pthread_mutex_lock(&allThreadsLock);
+    for (thread = allThreads; thread != NULL; thread = thread->next) {
+        for (i = 0; i < thread->statCap; i++) {
+            if (thread->stats[i].ftnkey == NULL || thread->stats[i].count == 0)
+                continue;
+            key.ftnkey = thread->stats[i].ftnkey;
+            tableEntry = htab_find_slot(thisHashTable, &key, INSERT);
+            if (tableEntry == NULL)
+                continue;
+            if (*tableEntry == NULL) {
+                if ((master = (profileEntry_t *)calloc(1, sizeof(profileEntry_t))) == NULL)
+                    continue;
+                master->ftnkey = thread->stats[i].ftnkey;
+                *tableEntry    = master;
+            }
+            master = *(profileEntry_t **)tableEntry;
+            master->count += thread->stats[i].count;
+            master->totalTime += thread->stats[i].totalTime;
+            master->selfTime += thread->stats[i].selfTime;
+            thread->stats[i].count = 0;
+        }
+    }
+    pthread_mutex_unlock(&allThreadsLock);
+}
+
+/* Write the trace events of all threads to <PROFILE_TRACE>.<pid>.json in the Chrome trace
+ * event format. Timestamps are wall clock microseconds, flow events use the request id.
+ */
+static void
+profile_write_trace(void)
+{
+    profileThread_t *thread;
+    traceChunk_t *   chunk;
+    traceEvent_t *   event;
+    char             fname[1024];
+    FILE *           trace;
+    int              i, pid = (int)getpid();
+    int64_t          ts, ndropped = 0;
+
+    snprintf(fname, sizeof(fname), "%s.%d.json", traceFilePrefix, pid);
+    if ((trace = fopen(fname, "w")) == NULL) {
+        perror("fopen");
+        return;
+    }
+
+    fprintf(trace, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(trace, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"pdc %d\"}}",
+            pid, pid);
+    pthread_mutex_lock(&allThreadsLock);
+    for (thread = allThreads; thread != NULL; thread = thread->next) {
+        ndropped += thread->ndropped;
+        for (chunk = thread->traceHead; chunk != NULL; chunk = chunk->next) {
+            for (i = 0; i < chunk->n; i++) {
+                event = &chunk->events[i];
+                /* Printed as integer and fraction, a double has no nanoseconds left at this epoch */
+                ts = event->start + clockOffset;
+                fprintf(trace,
+                        ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%" PRId64 ".%03d",
+                        event->name, event->phase, pid, thread->tid, ts / 1000, (int)(ts % 1000));
+                if (event->phase == 'X')
+                    fprintf(trace, ",\"dur\":%.3f", event->dur / 1e3);
+                else
+                    fprintf(trace, ",\"cat\":\"request\",\"id\":\"0x%" PRIx64 "\",\"bp\":\"e\"", event->id);
+                if (event->tags != NULL)
+                    fprintf(trace, ",\"args\":{\"tags\":\"%s\"}", event->tags);
+                fprintf(trace, "}");
+            }
+        }
+    }
+    pthread_mutex_unlock(&allThreadsLock);
+    fprintf(trace, "\n]}\n");
+    fclose(trace);
+
+    if (ndropped > 0)
+        fprintf(stderr, "==PDC_PROFILE: %" PRId64 " trace events dropped, raise PROFILE_TRACE_MAX_EVENTS\n",
+                ndropped);
+}
+
 /*  Returns 1 if we set enableProfiling to TRUE
  *  otherwise returns 0.
  */
@@ -253,12 +464,31 @@ void __attribute__((constructor)) profile_init(void)
         }
     }
     initialize_profile(&hashtable, default_HashtableSize);
+
+    char *sample_rate = getenv("PROFILE_SAMPLE_RATE");
+    if (sample_rate != NULL && atoi(sample_rate) > 1)
+        sampleRate = atoi(sample_rate);
+
+    char *max_events = getenv("PROFILE_TRACE_MAX_EVENTS");
+    if (max_events != NULL && atoll(max_events) > 0)
+        traceMaxEvents = atoll(max_events);
+
+    traceFilePrefix = getenv("PROFILE_TRACE");
+    if (traceFilePrefix != NULL && traceFilePrefix[0] == '\0')
+        traceFilePrefix = NULL;
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    clockOffset = (int64_t)wall.tv_sec * 1000000000LL + wall.tv_nsec - profile_now();
 }
 
 void __attribute__((destructor)) finalize_profile(void)
 {
     int count = 1;
     if (thisHashTable != NULL) {
+        profile_merge_threads();
         htab_traverse(thisHashTable, show_profile_info, &count);
     }
+    if (traceFilePrefix != NULL)
+        profile_write_trace();
 }
@@ -0,0 +1,62 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pdc.h"
+#include "pdc_client_connect.h"
+
+int
+main(int argc, char *argv[])
+{
+    pdcid_t pdc;
+    char *  snapshot;
+    int     i, rank = 0;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    pdc = PDCinit("pdc");
+
+    if (rank == 0) {
+        for (i = 0; i < pdc_server_num_g; i++) {
+            if (PDC_Client_get_server_metrics(i, &snapshot) != SUCCEED) {
+                printf("fail to get the metrics of server %d\n", i);
+                continue;
+            }
+            printf("==== server %d\n%s", i, snapshot);
+            free(snapshot);
+        }
+    }
+
+    if (PDCclose(pdc) < 0)
+        printf("fail to close PDC\n");
+
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
@@ -0,0 +1,90 @@
+#ifndef PDC_BLOOM_H
+#define PDC_BLOOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Each block is one 64-byte cache line, a key sets one bit in each of its 8 words
+#define PDC_BLOOM_BLOCK_WORDS 8
+// About 1% false positive rate
+#define PDC_BLOOM_BITS_PER_KEY 12
+
+typedef struct pdc_bloom_t {
+    uint64_t *blocks;
+    uint64_t  nblock;
+    uint64_t  capacity; // number of keys the filter is sized for
+    uint64_t  n_add;
+    uint64_t  n_remove; // removed keys still set in the filter
+} pdc_bloom_t;
+
+/**
+ * Create a blocked bloom filter
+ *
+ * \param capacity [IN]         Number of keys to size the filter for
+ *
+ * \return Pointer to the new filter, NULL on failure
+ */
+pdc_bloom_t *PDC_bloom_new(uint64_t capacity);
+
+/**
+ * Free a bloom filter
+ *
+ * \param bloom [IN]            Pointer to the filter
+ */
+void PDC_bloom_free(pdc_bloom_t *bloom);
+
+/**
+ * Add a key to a bloom filter
+ *
+ * \param bloom [IN]            Pointer to the filter
+ * \param fingerprint [IN]      64-bit hash of the key
+ */
+void PDC_bloom_add(pdc_bloom_t *bloom, uint64_t fingerprint);
+
+/**
+ * Record that a key was removed. Bits are not cleared, the owner should rebuild the filter once
+ * PDC_bloom_need_rebuild says so.
+ *
+ * \param bloom [IN]            Pointer to the filter
+ */
+void PDC_bloom_remove(pdc_bloom_t *bloom);
+
+/**
+ * Check if a key may be in a bloom filter
+ *
+ * \param bloom [IN]            Pointer to the filter
+ * \param fingerprint [IN]      64-bit hash of the key
+ *
+ * \return 1 if the key may be in the filter/0 if it is not
+ */
+int PDC_bloom_check(pdc_bloom_t *bloom, uint64_t fingerprint);
+
+/**
+ * Check if a bloom filter is over its capacity or has too many removed keys
+ *
+ * \param bloom [IN]            Pointer to the filter
+ *
+ * \return 1 if it should be rebuilt/0 otherwise
+ */
+int PDC_bloom_need_rebuild(pdc_bloom_t *bloom);
+
+/**
+ * Get the memory used by a bloom filter
+ *
+ * \param bloom [IN]            Pointer to the filter
+ *
+ * \return Size in bytes
+ */
+size_t PDC_bloom_size(pdc_bloom_t *bloom);
+
+/**
+ * Hash a string and an integer to a 64-bit fingerprint
+ *
+ * \param str [IN]              Null-terminated string
+ * \param value [IN]            Integer mixed into the hash
+ *
+ * \return 64-bit fingerprint
+ */
+uint64_t PDC_bloom_fingerprint(const char *str, int64_t value);
+
+#endif /* PDC_BLOOM_H */
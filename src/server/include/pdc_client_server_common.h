@@ -37,6 +37,8 @@
 #include "mercury_config.h"
 #include "mercury_thread_pool.h"
 #include "pdc_timing.h"
+#include "pdc_metrics.h"
+#include "pdc_interval_tree.h"
 #include "pdc_server_region_transfer_metadata_query.h"
 #include "pdc_server_region_transfer.h"
 
@@ -151,11 +153,12 @@ typedef enum {
 } _pdc_recv_region_op_t;
 
 typedef enum {
-    PDC_BULK_OP_NONE         = 0,
-    PDC_BULK_QUERY_COORDS    = 1,
-    PDC_BULK_READ_COORDS     = 2,
-    PDC_BULK_SEND_QUERY_DATA = 3,
-    PDC_BULK_QUERY_METADATA  = 4
+    PDC_BULK_OP_NONE            = 0,
+    PDC_BULK_QUERY_COORDS       = 1,
+    PDC_BULK_READ_COORDS        = 2,
+    PDC_BULK_SEND_QUERY_DATA    = 3,
+    PDC_BULK_QUERY_METADATA     = 4,
+    PDC_BULK_QUERY_COORDS_BATCH = 5
 } _pdc_bulk_op_t;
 
 typedef struct pdc_metadata_t pdc_metadata_t;
@@ -369,6 +372,8 @@ typedef struct data_server_region_t {
     region_map_t *region_map_head;
     // For region storage
     region_list_t *region_storage_head;
+    // Storage regions keyed by their extent in the first dimension
+    pdc_interval_tree_t region_storage_tree;
     // For non-mapped object analysis
     // Used primarily as a local_temp
     void *                       obj_data_ptr;
@@ -542,6 +547,7 @@ typedef struct {
 /* Define metadata_delete_by_id_in_t */
 typedef struct {
     uint64_t obj_id;
+    int32_t  storage_only; // drop only the data this server stores, the metadata is on another server
 } metadata_delete_by_id_in_t;
 
 /* Define metadata_delete_by_id_out_t */
@@ -662,6 +668,46 @@ typedef struct {
     uint64_t obj_id;
 } gen_obj_id_out_t;
 
+/* Define gen_obj_id_batch_in_t */
+/* The bulk buffer holds n_objs uint64_t object IDs filled by the server, then n_objs uint32_t name hash
+ * values, then the null-terminated object names */
+typedef struct {
+    gen_obj_id_in_t obj; // properties shared by all objects, obj_name and hash_value are ignored
+    hg_bulk_t       bulk_handle;
+    uint64_t        total_buf_size;
+    int32_t         n_objs;
+} gen_obj_id_batch_in_t;
+
+/* Define gen_obj_id_batch_out_t */
+typedef struct {
+    int32_t ret;
+    int32_t n_created;
+} gen_obj_id_batch_out_t;
+
+/* Define obj_put_data_in_t */
+/* Creates a 1D object on its metadata server and writes the data carried in the RPC there */
+typedef struct {
+    gen_obj_id_in_t obj;
+    uint64_t        unit;
+    uint64_t        size; // bytes of data
+    void *          data;
+} obj_put_data_in_t;
+
+/* Define obj_get_data_in_t */
+typedef struct {
+    uint64_t obj_id;
+    uint64_t obj_dim; // size of the 1D object
+    uint64_t unit;
+    uint64_t size; // elements to read from the start of the object
+} obj_get_data_in_t;
+
+/* Define obj_get_data_out_t */
+typedef struct {
+    int32_t  ret;
+    uint64_t size; // bytes of data
+    void *   data;
+} obj_get_data_out_t;
+
 /* Define server_lookup_client_in_t */
 typedef struct {
     int32_t     server_id;
@@ -775,6 +821,9 @@ typedef struct {
     pdc_metadata_transfer_t ret;
 } get_remote_metadata_out_t;
 
+/* Transfer request ids are per data server, the profile traces link client and server spans with both */
+#define PDC_TRANSFER_FLOW_ID(server_id, request_id) (((uint64_t)(server_id) << 48) | (uint64_t)(request_id))
+
 /* Define transfer_request_status_in_t */
 typedef struct {
     uint64_t transfer_request_id;
@@ -833,6 +882,7 @@ typedef struct transfer_request_all_in_t {
     hg_bulk_t local_bulk_handle;
     // hg_bulk_t              local_bulk_handle2;
     uint64_t total_buf_size;
+    uint64_t header_size; // bytes of region descriptors before the data, 0 if unknown
     int32_t  n_objs;
     uint8_t  access_type;
 } transfer_request_all_in_t;
@@ -904,10 +954,14 @@ typedef struct {
     int32_t ret;
 } buf_unmap_out_t;
 
+// total of a streamed query batch whose stream has more batches, the final batch carries the real total
+#define PDC_QUERY_BATCH_MORE UINT64_MAX
+
 /* Define bulk_rpc_in_t */
 typedef struct bulk_rpc_in_t {
     hg_uint64_t cnt;
     hg_uint64_t total;
+    hg_uint64_t offset;
     hg_int32_t  origin;
     hg_int32_t  seq_id;
     hg_int32_t  seq_id2;
@@ -1060,6 +1114,11 @@ typedef struct {
     int ret;
 } pdc_int_ret_t;
 
+/* Define server_metrics_out_t */
+typedef struct {
+    hg_string_t snapshot;
+} server_metrics_out_t;
+
 /* Define pdc_aggregated_io_to_server_t */
 typedef struct {
     hg_string_t             buf;
@@ -1877,6 +1936,11 @@ hg_proc_metadata_delete_by_id_in_t(hg_proc_t proc, void *data)
         // HG_LOG_ERROR("Proc error");
         return ret;
     }
+    ret = hg_proc_int32_t(proc, &struct_data->storage_only);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
     return ret;
 }
 
@@ -2053,6 +2117,159 @@ hg_proc_gen_obj_id_out_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+/* Define hg_proc_gen_obj_id_batch_in_t */
+static HG_INLINE hg_return_t
+hg_proc_gen_obj_id_batch_in_t(hg_proc_t proc, void *data)
+{
+    hg_return_t            ret;
+    gen_obj_id_batch_in_t *struct_data = (gen_obj_id_batch_in_t *)data;
+
+    ret = hg_proc_gen_obj_id_in_t(proc, &struct_data->obj);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_hg_bulk_t(proc, &struct_data->bulk_handle);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->total_buf_size);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_int32_t(proc, &struct_data->n_objs);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    return ret;
+}
+
+/* Define hg_proc_gen_obj_id_batch_out_t */
+static HG_INLINE hg_return_t
+hg_proc_gen_obj_id_batch_out_t(hg_proc_t proc, void *data)
+{
+    hg_return_t             ret;
+    gen_obj_id_batch_out_t *struct_data = (gen_obj_id_batch_out_t *)data;
+
+    ret = hg_proc_int32_t(proc, &struct_data->ret);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_int32_t(proc, &struct_data->n_created);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    return ret;
+}
+
+/* Define hg_proc_obj_put_data_in_t */
+static HG_INLINE hg_return_t
+hg_proc_obj_put_data_in_t(hg_proc_t proc, void *data)
+{
+    hg_return_t        ret;
+    obj_put_data_in_t *struct_data = (obj_put_data_in_t *)data;
+
+    ret = hg_proc_gen_obj_id_in_t(proc, &struct_data->obj);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->unit);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->size);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    if (struct_data->size) {
+        switch (hg_proc_get_op(proc)) {
+            case HG_DECODE:
+                struct_data->data = malloc(struct_data->size);
+                /* FALLTHRU */
+            case HG_ENCODE:
+                ret = hg_proc_raw(proc, struct_data->data, struct_data->size);
+                break;
+            case HG_FREE:
+                free(struct_data->data);
+            default:
+                break;
+        }
+    }
+    return ret;
+}
+
+/* Define hg_proc_obj_get_data_in_t */
+static HG_INLINE hg_return_t
+hg_proc_obj_get_data_in_t(hg_proc_t proc, void *data)
+{
+    hg_return_t        ret;
+    obj_get_data_in_t *struct_data = (obj_get_data_in_t *)data;
+
+    ret = hg_proc_uint64_t(proc, &struct_data->obj_id);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->obj_dim);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->unit);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->size);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    return ret;
+}
+
+/* Define hg_proc_obj_get_data_out_t */
+static HG_INLINE hg_return_t
+hg_proc_obj_get_data_out_t(hg_proc_t proc, void *data)
+{
+    hg_return_t         ret;
+    obj_get_data_out_t *struct_data = (obj_get_data_out_t *)data;
+
+    ret = hg_proc_int32_t(proc, &struct_data->ret);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    ret = hg_proc_uint64_t(proc, &struct_data->size);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    if (struct_data->size) {
+        switch (hg_proc_get_op(proc)) {
+            case HG_DECODE:
+                struct_data->data = malloc(struct_data->size);
+                /* FALLTHRU */
+            case HG_ENCODE:
+                ret = hg_proc_raw(proc, struct_data->data, struct_data->size);
+                break;
+            case HG_FREE:
+                free(struct_data->data);
+            default:
+                break;
+        }
+    }
+    return ret;
+}
+
 /* Define hg_proc_server_lookup_remote_server_in_t */
 static HG_INLINE hg_return_t
 hg_proc_server_lookup_remote_server_in_t(hg_proc_t proc, void *data)
@@ -2417,6 +2634,11 @@ hg_proc_bulk_rpc_in_t(hg_proc_t proc, void *data)
         // HG_LOG_ERROR("Proc error");
         return ret;
     }
+    ret = hg_proc_uint64_t(proc, &struct_data->offset);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
     ret = hg_proc_int32_t(proc, &struct_data->seq_id);
     if (ret != HG_SUCCESS) {
         // HG_LOG_ERROR("Proc error");
@@ -2750,6 +2972,11 @@ hg_proc_transfer_request_all_in_t(hg_proc_t proc, void *data)
         // HG_LOG_ERROR("Proc error");
         return ret;
     }
+    ret = hg_proc_uint64_t(proc, &struct_data->header_size);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
     ret = hg_proc_int32_t(proc, &struct_data->n_objs);
     if (ret != HG_SUCCESS) {
         // HG_LOG_ERROR("Proc error");
@@ -3422,6 +3649,21 @@ hg_proc_pdc_int_ret_t(hg_proc_t proc, void *data)
     return ret;
 }
 
+/* Define hg_proc_server_metrics_out_t */
+static HG_INLINE hg_return_t
+hg_proc_server_metrics_out_t(hg_proc_t proc, void *data)
+{
+    hg_return_t           ret;
+    server_metrics_out_t *struct_data = (server_metrics_out_t *)data;
+
+    ret = hg_proc_hg_string_t(proc, &struct_data->snapshot);
+    if (ret != HG_SUCCESS) {
+        // HG_LOG_ERROR("Proc error");
+        return ret;
+    }
+    return ret;
+}
+
 /* Define hg_proc_pdc_aggregated_io_to_server_t */
 static HG_INLINE hg_return_t
 hg_proc_pdc_aggregated_io_to_server_t(hg_proc_t proc, void *data)
@@ -3779,6 +4021,7 @@ struct bulk_args_t {
     uint32_t  ndim;
     uint64_t *coords;
     uint64_t  total;
+    uint64_t  offset;
     uint32_t  data_type;
 
     hg_atomic_int32_t completed_transfers;
@@ -3887,6 +4130,7 @@ struct transfer_request_all_local_bulk_args {
     transfer_request_all_in_t in;
     uint64_t *                transfer_request_id;
     void *                    data_buf;
+    uint64_t                  metrics_start; // PDC_metrics_now() when the request arrived
 #ifdef PDC_TIMING
     double start_time;
 #endif
@@ -3898,6 +4142,40 @@ struct transfer_request_all_local_bulk_args2 {
     hg_bulk_t                 bulk_handle;
     uint64_t *                transfer_request_id;
     void *                    data_buf;
+    uint64_t                  metrics_start;
+#ifdef PDC_TIMING
+    double start_time;
+#endif
+};
+
+struct transfer_request_all_pipeline;
+
+// One staging buffer of a pipelined transfer_request_all
+struct transfer_request_all_pipeline_slot {
+    struct transfer_request_all_pipeline *pipeline;
+    char *                                buf;
+    hg_bulk_t                             bulk_handle;
+    int                                   chunk; // chunk currently held by the buffer
+};
+
+// A transfer_request_all whose data is moved in chunks, see transfer_request_all_pipeline_start
+struct transfer_request_all_pipeline {
+    hg_handle_t                                handle;
+    transfer_request_all_in_t                  in;
+    transfer_request_all_data                  request_data;
+    void *                                     header_buf;
+    uint64_t *                                 transfer_request_id;
+    uint64_t *                                 data_offset;  // n_objs + 1 offsets of object data
+    uint64_t *                                 row_size;     // bytes of one row along the first dimension
+    uint64_t *                                 chunk_offset; // n_chunk + 1 offsets, at row boundaries
+    int                                        n_chunk;
+    hg_atomic_int32_t                          next_chunk; // next chunk to put in flight
+    hg_atomic_int32_t                          n_done;
+    hg_atomic_int32_t                          failed; // set when a chunk could not be moved
+    int                                        n_slot;
+    struct transfer_request_all_pipeline_slot *slot;
+    data_server_region_t **                    region_ptrs;
+    uint64_t                                   metrics_start;
 #ifdef PDC_TIMING
     double start_time;
 #endif
@@ -3913,6 +4191,14 @@ struct transfer_request_metadata_query_local_bulk_args {
 #endif
 };
 
+struct gen_obj_id_batch_local_bulk_args {
+    hg_handle_t            handle;
+    hg_bulk_t              bulk_handle;
+    gen_obj_id_batch_in_t  in;
+    gen_obj_id_batch_out_t out;
+    void *                 data_buf;
+};
+
 struct transfer_request_metadata_query2_local_bulk_args {
     hg_handle_t handle;
     hg_bulk_t   bulk_handle;
@@ -3929,6 +4215,7 @@ struct transfer_request_local_bulk_args {
     uint64_t              transfer_request_id;
     void *                data_buf;
     size_t                total_mem_size;
+    uint64_t              metrics_start; // PDC_metrics_now() when the request arrived
 
 #ifdef PDC_TIMING
     double start_time;
@@ -4008,6 +4295,9 @@ typedef struct storage_regions_args_t {
 /* Library-private Function Prototypes */
 /***************************************/
 hg_id_t PDC_gen_obj_id_register(hg_class_t *hg_class);
+hg_id_t PDC_gen_obj_id_batch_register(hg_class_t *hg_class);
+hg_id_t PDC_obj_put_data_register(hg_class_t *hg_class);
+hg_id_t PDC_obj_get_data_register(hg_class_t *hg_class);
 hg_id_t PDC_client_test_connect_register(hg_class_t *hg_class);
 hg_id_t PDC_get_remote_metadata_register(hg_class_t *hg_class_g);
 hg_id_t PDC_server_lookup_client_register(hg_class_t *hg_class);
@@ -4054,6 +4344,7 @@ hg_id_t PDC_gen_cont_id_register(hg_class_t *hg_class);
 hg_id_t PDC_cont_add_del_objs_rpc_register(hg_class_t *hg_class);
 hg_id_t PDC_query_read_obj_name_rpc_register(hg_class_t *hg_class);
 hg_id_t PDC_server_checkpoint_rpc_register(hg_class_t *hg_class);
+hg_id_t PDC_server_metrics_rpc_register(hg_class_t *hg_class);
 hg_id_t PDC_send_shm_register(hg_class_t *hg_class);
 hg_id_t PDC_send_shm_bulk_rpc_register(hg_class_t *hg_class);
 hg_id_t PDC_query_read_obj_name_client_rpc_register(hg_class_t *hg_class);
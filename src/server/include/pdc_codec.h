@@ -0,0 +1,91 @@
+#ifndef PDC_CODEC_H
+#define PDC_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Codecs of stored chunks
+#define PDC_CODEC_NONE 0
+// Byte shuffle by element size followed by an LZ77 pass with the LZ4 block format
+#define PDC_CODEC_SHUFFLE_LZ 1
+
+/**
+ * Compress a buffer with an LZ77 pass. Matches are found with a single-entry hash table over a 64 KB
+ * window, the output is an LZ4 block.
+ *
+ * \param src [IN]              Input buffer
+ * \param size [IN]             Size of the input in bytes
+ * \param dst [OUT]             Output buffer
+ * \param dst_size [IN]         Size of the output buffer in bytes
+ *
+ * \return Compressed size in bytes, 0 if the output does not fit in dst_size
+ */
+size_t PDC_codec_compress(const void *src, size_t size, void *dst, size_t dst_size);
+
+/**
+ * Decompress a buffer made by PDC_codec_compress. The input is checked, a corrupted block makes it fail
+ * rather than read or write out of bounds.
+ *
+ * \param src [IN]              Compressed buffer
+ * \param csize [IN]            Size of the compressed buffer in bytes
+ * \param dst [OUT]             Output buffer
+ * \param size [IN]             Size of the output buffer in bytes
+ *
+ * \return Decompressed size in bytes, 0 on a corrupted block
+ */
+size_t PDC_codec_decompress(const void *src, size_t csize, void *dst, size_t size);
+
+/**
+ * Group the bytes of the elements of a buffer by their position in the element, so the slowly changing
+ * sign and exponent bytes of floats end up next to each other
+ *
+ * \param src [IN]              Input buffer
+ * \param dst [OUT]             Output buffer, must not overlap src
+ * \param size [IN]             Size of the buffers in bytes, trailing bytes of a partial element are copied
+ * \param unit [IN]             Size of an element in bytes
+ */
+void PDC_codec_shuffle(const void *src, void *dst, size_t size, size_t unit);
+
+/**
+ * Undo PDC_codec_shuffle
+ *
+ * \param src [IN]              Shuffled buffer
+ * \param dst [OUT]             Output buffer, must not overlap src
+ * \param size [IN]             Size of the buffers in bytes
+ * \param unit [IN]             Size of an element in bytes
+ */
+void PDC_codec_unshuffle(const void *src, void *dst, size_t size, size_t unit);
+
+/**
+ * Encode a buffer with a codec, falling back to PDC_CODEC_NONE when it does not shrink the data
+ *
+ * \param codec [IN]            Codec to try
+ * \param src [IN]              Input buffer
+ * \param size [IN]             Size of the input in bytes
+ * \param unit [IN]             Size of an element in bytes
+ * \param dst [OUT]             Output buffer of size bytes
+ * \param tmp [IN]              Scratch buffer of size bytes
+ * \param csize [OUT]           Size of the encoded data in bytes
+ *
+ * \return Codec used
+ */
+int PDC_codec_encode(int codec, const void *src, size_t size, size_t unit, void *dst, void *tmp,
+                     size_t *csize);
+
+/**
+ * Decode a buffer made by PDC_codec_encode
+ *
+ * \param codec [IN]            Codec returned by PDC_codec_encode
+ * \param src [IN]              Encoded buffer
+ * \param csize [IN]            Size of the encoded data in bytes
+ * \param unit [IN]             Size of an element in bytes
+ * \param dst [OUT]             Output buffer
+ * \param size [IN]             Size of the decoded data in bytes
+ * \param tmp [IN]              Scratch buffer of size bytes
+ *
+ * \return 0 on success, -1 if the data is corrupted
+ */
+int PDC_codec_decode(int codec, const void *src, size_t csize, size_t unit, void *dst, size_t size,
+                     void *tmp);
+
+#endif /* PDC_CODEC_H */
@@ -45,6 +45,9 @@
 #include "mpi.h"
 #endif
 
+// Seconds to wait for the addrs of all other servers at startup, override with PDC_SERVER_LOOKUP_TIMEOUT
+#define PDC_SERVER_LOOKUP_TIMEOUT_DEFAULT 300
+
 #ifdef ENABLE_FASTBIT
 #include "iapi.h"
 #endif
@@ -59,9 +62,7 @@
 /*****************************/
 /* Library-private Variables */
 /*****************************/
-hg_thread_mutex_t hash_table_new_mutex_g;
 hg_thread_mutex_t pdc_client_addr_mutex_g;
-hg_thread_mutex_t pdc_metadata_hash_table_mutex_g;
 hg_thread_mutex_t pdc_container_hash_table_mutex_g;
 hg_thread_mutex_t pdc_time_mutex_g;
 hg_thread_mutex_t pdc_bloom_time_mutex_g;
@@ -74,7 +75,6 @@ hg_thread_mutex_t region_struct_mutex_g;
 hg_thread_mutex_t data_buf_map_mutex_g;
 hg_thread_mutex_t data_buf_unmap_mutex_g;
 hg_thread_mutex_t data_obj_map_mutex_g;
-hg_thread_mutex_t insert_hash_table_mutex_g;
 hg_thread_mutex_t lock_request_mutex_g;
 hg_thread_mutex_t addr_valid_mutex_g;
 hg_thread_mutex_t update_remote_server_addr_mutex_g;
@@ -31,6 +31,9 @@
 #include "mercury_macros.h"
 #include "mercury_proc_string.h"
 #include "mercury_atomic.h"
+#ifdef ENABLE_MULTITHREAD
+#include "mercury_thread_rwlock.h"
+#endif
 
 #include "pdc_hash-table.h"
 
@@ -38,6 +41,8 @@
 #include "pdc_client_server_common.h"
 
 #define CREATE_BLOOM_THRESHOLD 64
+// Number of shards of the metadata hash table with multithread, override with PDC_SERVER_METADATA_SHARDS
+#define PDC_METADATA_SHARD_DEFAULT 16
 
 /*****************************/
 /* Library-private Variables */
@@ -46,7 +51,6 @@ extern int           pdc_server_rank_g;
 extern int           pdc_server_size_g;
 extern char          pdc_server_tmp_dir_g[ADDR_MAX];
 extern uint32_t      n_metadata_g;
-extern HashTable *   metadata_hash_table_g;
 extern HashTable *   container_hash_table_g;
 extern hg_class_t *  hg_class_g;
 extern hg_context_t *hg_context_g;
@@ -80,6 +84,17 @@ typedef struct pdc_cont_hash_table_entry_t {
     pdc_kvtag_list_t *kvtag_list_head;
 } pdc_cont_hash_table_entry_t;
 
+// An object is kept in the shard picked by its name hash, each shard has its own table and lock
+typedef struct pdc_metadata_shard_t {
+    HashTable *table;
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_rwlock_t lock;
+#endif
+} pdc_metadata_shard_t;
+
+extern pdc_metadata_shard_t *metadata_shards_g;
+extern int                   n_metadata_shard_g;
+
 /***************************************/
 /* Library-private Function Prototypes */
 /***************************************/
@@ -93,6 +108,21 @@ typedef struct pdc_cont_hash_table_entry_t {
  */
 perr_t PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out);
 
+/**
+ * Insert a batch of objects that share the same properties to the hash table
+ *
+ * \param in [IN]               Input structure with the properties of all objects
+ * \param n_objs [IN]           Number of objects
+ * \param obj_names [IN]        Names of the objects
+ * \param hash_values [IN]      Hash values of the object names
+ * \param obj_ids [OUT]         IDs of the created objects, 0 for the ones that already exist
+ * \param n_created [OUT]       Number of objects created
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_insert_metadata_batch_to_hash_table(gen_obj_id_in_t *in, int32_t n_objs, char **obj_names,
+                                               uint32_t *hash_values, uint64_t *obj_ids, int32_t *n_created);
+
 /**
  * Metadata server process buffer map
  *
@@ -292,7 +322,31 @@ perr_t PDC_Server_metadata_duplicate_check();
 perr_t PDC_Server_init_hash_table();
 
 /**
- * Init a metadata list (doubly linked) under the given hash table entry
+ * Free the metadata hash table shards and their locks
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_free_hash_table();
+
+/**
+ * Get the shard of the metadata hash table that holds a name hash
+ *
+ * \param hash_value [IN]       Hash value of the object name
+ *
+ * \return Pointer to the shard
+ */
+pdc_metadata_shard_t *PDC_Server_metadata_shard(uint32_t hash_value);
+
+/**
+ * Get the number of entries in all shards of the metadata hash table
+ *
+ * \return Number of entries
+ */
+int PDC_Server_metadata_num_entries();
+
+/**
+ * Init a metadata list (doubly linked) under the given hash table entry, the entry is inserted to the
+ * shard of its hash key and the caller holds the write lock of that shard with multithread
  *
  * \param entry [IN]            An entry pointer of the hash table
  * \param hash_key [IN]         Hash key of the entry
@@ -0,0 +1,122 @@
+/* Blocked bloom filter, see Putze, Sanders and Singler, "Cache-, hash- and space-efficient bloom filters" */
+
+#include <stdlib.h>
+#include <string.h>
+#include "pdc_bloom.h"
+
+// Odd multipliers that pick one bit in each word of a block
+static const uint32_t pdc_bloom_salt_g[PDC_BLOOM_BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                                                 0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                                                 0x9efc4947U, 0x5c6bfb31U};
+
+static inline uint64_t *
+pdc_bloom_block(pdc_bloom_t *bloom, uint64_t fingerprint)
+{
+    // Map the high 32 bits to [0, nblock) without a division
+    uint64_t idx = ((fingerprint >> 32) * bloom->nblock) >> 32;
+
+    return bloom->blocks + idx * PDC_BLOOM_BLOCK_WORDS;
+}
+
+pdc_bloom_t *
+PDC_bloom_new(uint64_t capacity)
+{
+    pdc_bloom_t *bloom;
+    uint64_t     nbits;
+    size_t       size;
+
+    bloom = (pdc_bloom_t *)calloc(1, sizeof(pdc_bloom_t));
+    if (bloom == NULL)
+        return NULL;
+
+    if (capacity == 0)
+        capacity = 1;
+    nbits         = capacity * PDC_BLOOM_BITS_PER_KEY;
+    bloom->nblock = (nbits + 64 * PDC_BLOOM_BLOCK_WORDS - 1) / (64 * PDC_BLOOM_BLOCK_WORDS);
+    if (bloom->nblock > UINT32_MAX)
+        bloom->nblock = UINT32_MAX;
+    bloom->capacity = capacity;
+
+    size = bloom->nblock * PDC_BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+    if (posix_memalign((void **)&bloom->blocks, 64, size) != 0) {
+        free(bloom);
+        return NULL;
+    }
+    memset(bloom->blocks, 0, size);
+
+    return bloom;
+}
+
+void
+PDC_bloom_free(pdc_bloom_t *bloom)
+{
+    if (bloom == NULL)
+        return;
+    free(bloom->blocks);
+    free(bloom);
+}
+
+void
+PDC_bloom_add(pdc_bloom_t *bloom, uint64_t fingerprint)
+{
+    uint64_t *block = pdc_bloom_block(bloom, fingerprint);
+    uint32_t  key   = (uint32_t)fingerprint;
+    int       i;
+
+    for (i = 0; i < PDC_BLOOM_BLOCK_WORDS; i++)
+        block[i] |= 1ULL << ((key * pdc_bloom_salt_g[i]) >> 26);
+    bloom->n_add++;
+}
+
+void
+PDC_bloom_remove(pdc_bloom_t *bloom)
+{
+    bloom->n_remove++;
+}
+
+int
+PDC_bloom_check(pdc_bloom_t *bloom, uint64_t fingerprint)
+{
+    uint64_t *block = pdc_bloom_block(bloom, fingerprint);
+    uint32_t  key   = (uint32_t)fingerprint;
+    int       i;
+
+    for (i = 0; i < PDC_BLOOM_BLOCK_WORDS; i++) {
+        if ((block[i] & (1ULL << ((key * pdc_bloom_salt_g[i]) >> 26))) == 0)
+            return 0;
+    }
+    return 1;
+}
+
+int
+PDC_bloom_need_rebuild(pdc_bloom_t *bloom)
+{
+    return bloom->n_add > bloom->capacity || bloom->n_remove * 2 > bloom->n_add;
+}
+
+size_t
+PDC_bloom_size(pdc_bloom_t *bloom)
+{
+    return sizeof(pdc_bloom_t) + bloom->nblock * PDC_BLOOM_BLOCK_WORDS * sizeof(uint64_t);
+}
+
+uint64_t
+PDC_bloom_fingerprint(const char *str, int64_t value)
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    // FNV-1a over the string, then the murmur3 finalizer to spread the bits
+    while (*str) {
+        h ^= (unsigned char)*str++;
+        h *= 1099511628211ULL;
+    }
+    h ^= (uint64_t)value * 0x9e3779b97f4a7c15ULL;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return h;
+}
@@ -171,7 +171,6 @@ hg_proc_send_shm_in_t(hg_proc_t proc, void *data)
         PGOTO_ERROR(ret_value, "Proc error");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -289,7 +288,6 @@ PDC_get_var_type_size(pdc_var_type_t dtype)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -443,7 +441,6 @@ PDC_print_metadata(pdc_metadata_t *a)
     fflush(stdout);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE_VOID;
 }
 
@@ -484,7 +481,6 @@ PDC_metadata_init(pdc_metadata_t *a)
     a->bloom                    = NULL;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -529,7 +525,6 @@ PDC_is_same_region_shape(region_list_t *a, size_t extent_a, region_list_t *b, si
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -557,7 +552,6 @@ PDC_is_same_region_list(region_list_t *a, region_list_t *b)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -592,7 +586,6 @@ PDC_is_same_region_transfer(region_info_transfer_t *a, region_info_transfer_t *b
             PGOTO_DONE(-1);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -625,7 +618,6 @@ PDC_print_storage_region_list(region_list_t *a)
     fflush(stdout);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE_VOID;
 }
 
@@ -662,8 +654,6 @@ PDC_print_region_list(region_list_t *a)
     printf("\n  =================\n");
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE_VOID;
 }
 
@@ -710,7 +700,6 @@ PDC_region_list_t_deep_cp(region_list_t *from, region_list_t *to)
     to->next = NULL;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -756,7 +745,6 @@ PDC_region_transfer_t_to_list_t(region_info_transfer_t *transfer, region_list_t
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -782,7 +770,6 @@ PDC_region_info_to_list_t(struct pdc_region_info *region, region_list_t *list)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -842,7 +829,6 @@ PDC_region_info_t_to_transfer(struct pdc_region_info *region, region_info_transf
         transfer->count_3 = 0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -903,7 +889,6 @@ PDC_region_info_t_to_transfer_unit(struct pdc_region_info *region, region_info_t
         transfer->count_3 = 0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -944,7 +929,6 @@ PDC_region_transfer_t_to_region_info(region_info_transfer_t *transfer)
     ret_value = region;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -970,7 +954,6 @@ PDC_region_list_t_to_transfer(region_list_t *region, region_info_transfer_t *tra
     transfer->count_3 = region->count[3];
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1013,7 +996,6 @@ PDC_metadata_t_to_transfer_t(pdc_metadata_t *meta, pdc_metadata_transfer_t *tran
     transfer->t_meta_index     = meta->current_state.meta_index;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1061,7 +1043,6 @@ PDC_transfer_t_to_metadata_t(pdc_metadata_transfer_t *transfer, pdc_metadata_t *
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1085,6 +1066,16 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in   ATTRIBUTE(unused),
     return SUCCEED;
 }
 perr_t
+PDC_insert_metadata_batch_to_hash_table(gen_obj_id_in_t *in      ATTRIBUTE(unused),
+                                        int32_t n_objs           ATTRIBUTE(unused),
+                                        char **obj_names         ATTRIBUTE(unused),
+                                        uint32_t *hash_values    ATTRIBUTE(unused),
+                                        uint64_t *obj_ids        ATTRIBUTE(unused),
+                                        int32_t *n_created       ATTRIBUTE(unused))
+{
+    return SUCCEED;
+}
+perr_t
 PDC_Server_search_with_name_hash(const char *obj_name ATTRIBUTE(unused), uint32_t hash_key ATTRIBUTE(unused),
                                  pdc_metadata_t **out ATTRIBUTE(unused))
 {
@@ -1526,7 +1517,8 @@ PDC_recv_read_coords_data(const struct hg_cb_info *callback_info ATTRIBUTE(unuse
 /* gen_obj_id_cb(hg_handle_t handle) */
 HG_TEST_RPC_CB(gen_obj_id, handle)
 {
-    perr_t ret_value = HG_SUCCESS;
+    perr_t   ret_value     = HG_SUCCESS;
+    uint64_t metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 
@@ -1549,6 +1541,237 @@ HG_TEST_RPC_CB(gen_obj_id, handle)
 #endif
     HG_Respond(handle, NULL, NULL, &out);
 
+    HG_Free_input(handle, &in);
+    HG_Destroy(handle);
+    PDC_metrics_record(PDC_METRIC_SERVER_OBJ_CREATE, metrics_start, 0);
+
+    FUNC_LEAVE(ret_value);
+}
+
+// Respond once the object IDs are in the client buffer
+static hg_return_t
+gen_obj_id_batch_push_cb(const struct hg_cb_info *info)
+{
+    struct gen_obj_id_batch_local_bulk_args *local_bulk_args = info->arg;
+
+    FUNC_ENTER(NULL);
+
+    if (info->ret != HG_SUCCESS)
+        local_bulk_args->out.ret = 0;
+    HG_Respond(local_bulk_args->handle, NULL, NULL, &local_bulk_args->out);
+
+    free(local_bulk_args->data_buf);
+    HG_Bulk_free(local_bulk_args->bulk_handle);
+    HG_Free_input(local_bulk_args->handle, &local_bulk_args->in);
+    HG_Destroy(local_bulk_args->handle);
+    free(local_bulk_args);
+
+    FUNC_LEAVE(HG_SUCCESS);
+}
+
+static hg_return_t
+gen_obj_id_batch_pull_cb(const struct hg_cb_info *info)
+{
+    struct gen_obj_id_batch_local_bulk_args *local_bulk_args = info->arg;
+    gen_obj_id_batch_in_t *                  in              = &local_bulk_args->in;
+    const struct hg_info *                   hg_info;
+    struct hg_cb_info                        push_info;
+    hg_return_t                              ret_value = HG_SUCCESS;
+    char *                                   buf, *name, *buf_end;
+    char **                                  obj_names = NULL;
+    uint64_t *                               obj_ids;
+    uint32_t *                               hash_values;
+    int32_t                                  i;
+
+    FUNC_ENTER(NULL);
+
+    local_bulk_args->out.ret       = 0;
+    local_bulk_args->out.n_created = 0;
+    if (info->ret != HG_SUCCESS)
+        PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_SERVER: error pulling object names");
+    if (in->n_objs <= 0 || in->total_buf_size <= in->n_objs * (sizeof(uint64_t) + sizeof(uint32_t)))
+        PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_SERVER: malformed object name buffer");
+
+    buf         = (char *)local_bulk_args->data_buf;
+    buf_end     = buf + in->total_buf_size;
+    obj_ids     = (uint64_t *)buf;
+    hash_values = (uint32_t *)(buf + in->n_objs * sizeof(uint64_t));
+    name        = buf + in->n_objs * (sizeof(uint64_t) + sizeof(uint32_t));
+
+    obj_names = (char **)malloc(in->n_objs * sizeof(char *));
+    for (i = 0; i < in->n_objs; i++) {
+        if (name >= buf_end)
+            PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_SERVER: malformed object name buffer");
+        obj_names[i] = name;
+        name += strnlen(name, buf_end - name) + 1;
+    }
+    if (name > buf_end)
+        PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_SERVER: malformed object name buffer");
+
+    if (PDC_insert_metadata_batch_to_hash_table(&in->obj, in->n_objs, obj_names, hash_values, obj_ids,
+                                                &local_bulk_args->out.n_created) != SUCCEED)
+        PGOTO_ERROR(HG_OTHER_ERROR, "==PDC_SERVER: error inserting object batch");
+    local_bulk_args->out.ret = 1;
+
+    // Send the object IDs back to the front of the client buffer
+    hg_info   = HG_Get_info(local_bulk_args->handle);
+    ret_value = HG_Bulk_transfer(hg_info->context, gen_obj_id_batch_push_cb, local_bulk_args, HG_BULK_PUSH,
+                                 hg_info->addr, in->bulk_handle, 0, local_bulk_args->bulk_handle, 0,
+                                 in->n_objs * sizeof(uint64_t), HG_OP_ID_IGNORE);
+
+done:
+    free(obj_names);
+    if (ret_value != HG_SUCCESS) {
+        // Nothing is pushed, respond with the error right away
+        push_info.arg = local_bulk_args;
+        push_info.ret = ret_value;
+        gen_obj_id_batch_push_cb(&push_info);
+    }
+
+    FUNC_LEAVE(ret_value);
+}
+
+/* static hg_return_t */
+/* gen_obj_id_batch_cb(hg_handle_t handle) */
+HG_TEST_RPC_CB(gen_obj_id_batch, handle)
+{
+    struct gen_obj_id_batch_local_bulk_args *local_bulk_args;
+    const struct hg_info *                   info;
+    struct hg_cb_info                        push_info;
+    hg_size_t                                buf_size;
+    hg_return_t                              ret_value = HG_SUCCESS;
+
+    FUNC_ENTER(NULL);
+
+    local_bulk_args = (struct gen_obj_id_batch_local_bulk_args *)calloc(1, sizeof(*local_bulk_args));
+    HG_Get_input(handle, &local_bulk_args->in);
+    local_bulk_args->handle = handle;
+    info                    = HG_Get_info(handle);
+
+    // The input is freed after the IDs are sent back, the object properties are used until then
+    buf_size                  = local_bulk_args->in.total_buf_size;
+    local_bulk_args->data_buf = malloc(buf_size);
+    ret_value = HG_Bulk_create(info->hg_class, 1, &local_bulk_args->data_buf, &buf_size, HG_BULK_READWRITE,
+                               &local_bulk_args->bulk_handle);
+    if (ret_value != HG_SUCCESS)
+        PGOTO_ERROR(ret_value, "==PDC_SERVER: error with HG_Bulk_create");
+
+    ret_value = HG_Bulk_transfer(info->context, gen_obj_id_batch_pull_cb, local_bulk_args, HG_BULK_PULL,
+                                 info->addr, local_bulk_args->in.bulk_handle, 0, local_bulk_args->bulk_handle,
+                                 0, buf_size, HG_OP_ID_IGNORE);
+    if (ret_value != HG_SUCCESS)
+        PGOTO_ERROR(ret_value, "==PDC_SERVER: error with HG_Bulk_transfer");
+
+done:
+    if (ret_value != HG_SUCCESS) {
+        push_info.arg = local_bulk_args;
+        push_info.ret = ret_value;
+        gen_obj_id_batch_push_cb(&push_info);
+    }
+
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Write or read the first size elements of a 1D object on this data server
+ *
+ * \param obj_id [IN]           Object ID
+ * \param obj_dim [IN]          Size of the object
+ * \param unit [IN]             Element size in bytes
+ * \param size [IN]             Number of elements
+ * \param buf [IN/OUT]          Data to write, or buffer to read into
+ * \param is_write [IN]         1 to write, 0 to read
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Server_obj_data_io(uint64_t obj_id, uint64_t obj_dim, uint64_t unit, uint64_t size, void *buf,
+                       int is_write)
+{
+    perr_t                 ret_value = SUCCEED;
+    struct pdc_region_info region_info;
+    uint64_t               offset = 0;
+#ifndef PDC_SERVER_CACHE
+    data_server_region_t *region_ptr;
+#endif
+
+    FUNC_ENTER(NULL);
+
+    region_info.ndim   = 1;
+    region_info.offset = &offset;
+    region_info.size   = &size;
+#ifdef PDC_SERVER_CACHE
+    if (is_write)
+        ret_value = PDC_transfer_request_data_write_out(obj_id, 1, &obj_dim, &region_info, buf, unit);
+    else
+        ret_value = PDC_transfer_request_data_read_from(obj_id, 1, &obj_dim, &region_info, buf, unit);
+#else
+    region_ptr = PDC_Server_get_obj_region(obj_id);
+    PDC_Server_register_obj_region_by_pointer(&region_ptr, obj_id, 1);
+    ret_value = PDC_Server_transfer_request_io(obj_id, 1, &obj_dim, &region_info, buf, unit, is_write);
+    PDC_Server_unregister_obj_region_by_pointer(region_ptr, 1);
+#endif
+
+    FUNC_LEAVE(ret_value);
+}
+
+/* static hg_return_t */
+/* obj_put_data_cb(hg_handle_t handle) */
+HG_TEST_RPC_CB(obj_put_data, handle)
+{
+    hg_return_t       ret_value     = HG_SUCCESS;
+    uint64_t          metrics_start = PDC_metrics_now();
+    obj_put_data_in_t in;
+    gen_obj_id_out_t  out;
+
+    FUNC_ENTER(NULL);
+
+    HG_Get_input(handle, &in);
+
+    // The object is created with this server as its data server, so its data is written here as well
+    out.obj_id = 0;
+    if (PDC_insert_metadata_to_hash_table(&in.obj, &out) == SUCCEED && out.obj_id != 0 && in.size > 0) {
+        if (PDC_Server_obj_data_io(out.obj_id, in.size / in.unit, in.unit, in.size / in.unit, in.data, 1) !=
+            SUCCEED) {
+            printf("==PDC_SERVER[%d]: error writing data of object %" PRIu64 "\n", pdc_server_rank_g,
+                   out.obj_id);
+            out.obj_id = 0;
+        }
+    }
+    HG_Respond(handle, NULL, NULL, &out);
+
+    PDC_metrics_record(PDC_METRIC_SERVER_OBJ_PUT_DATA, metrics_start, in.size);
+    HG_Free_input(handle, &in);
+    HG_Destroy(handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
+/* static hg_return_t */
+/* obj_get_data_cb(hg_handle_t handle) */
+HG_TEST_RPC_CB(obj_get_data, handle)
+{
+    hg_return_t        ret_value     = HG_SUCCESS;
+    uint64_t           metrics_start = PDC_metrics_now();
+    obj_get_data_in_t  in;
+    obj_get_data_out_t out;
+
+    FUNC_ENTER(NULL);
+
+    HG_Get_input(handle, &in);
+
+    out.size = in.size * in.unit;
+    out.data = malloc(out.size);
+    out.ret  = 1;
+    if (out.data == NULL ||
+        PDC_Server_obj_data_io(in.obj_id, in.obj_dim, in.unit, in.size, out.data, 0) != SUCCEED) {
+        out.ret  = 0;
+        out.size = 0;
+    }
+    HG_Respond(handle, NULL, NULL, &out);
+
+    PDC_metrics_record(PDC_METRIC_SERVER_OBJ_GET_DATA, metrics_start, out.size);
+    free(out.data);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
@@ -1559,7 +1782,8 @@ HG_TEST_RPC_CB(gen_obj_id, handle)
 /* gen_cont_id_cb(hg_handle_t handle) */
 HG_TEST_RPC_CB(gen_cont_id, handle)
 {
-    perr_t ret_value = HG_SUCCESS;
+    perr_t   ret_value     = HG_SUCCESS;
+    uint64_t metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 
@@ -1577,9 +1801,9 @@ HG_TEST_RPC_CB(gen_cont_id, handle)
     HG_Respond(handle, NULL, NULL, &out);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
+    PDC_metrics_record(PDC_METRIC_SERVER_CONT_CREATE, metrics_start, 0);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1944,7 +2168,6 @@ HG_TEST_RPC_CB(notify_io_complete, handle)
     }
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
@@ -2024,7 +2247,6 @@ HG_TEST_RPC_CB(flush_obj_all, handle)
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2059,7 +2281,6 @@ HG_TEST_RPC_CB(flush_obj, handle)
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2084,7 +2305,6 @@ HG_TEST_RPC_CB(close_server, handle)
         PGOTO_ERROR(ret_value, "==PDC_SERVER[x]: Error with HG_Destroy");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 /*
@@ -2131,7 +2351,6 @@ pdc_region_write_out_progress(void *arg)
     free(remote_reg_info);
 
 done:
-    fflush(stdout);
     HG_Bulk_free(bulk_args->remote_bulk_handle);
     HG_Free_input(bulk_args->handle, &(bulk_args->in));
     HG_Destroy(bulk_args->handle);
@@ -2174,7 +2393,6 @@ obj_map_region_release_bulk_transfer_thread_cb(const struct hg_cb_info *hg_cb_in
     PDC_Server_release_lock_request(bulk_args->remote_obj_id, bulk_args->remote_reg_info);
 
 done:
-    fflush(stdout);
     free(bulk_args->remote_reg_info->offset);
     free(bulk_args->remote_reg_info->size);
     free(bulk_args->remote_reg_info);
@@ -2227,7 +2445,6 @@ pdc_region_read_from_progress(void *arg)
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         fflush(stdout);
         HG_Bulk_free(bulk_args->remote_bulk_handle);
@@ -2417,8 +2634,6 @@ transform_and_region_release_bulk_transfer_cb(const struct hg_cb_info *hg_cb_inf
 #endif
 
 done:
-    fflush(stdout);
-
 #ifndef ENABLE_MULTITHREAD
     if (remote_reg_info) {
         free(remote_reg_info->offset);
@@ -2587,8 +2802,6 @@ analysis_and_region_release_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info
 #endif
 
 done:
-    fflush(stdout);
-
 #ifndef ENABLE_MULTITHREAD
     free(remote_reg_info->offset);
     free(remote_reg_info->size);
@@ -2721,8 +2934,6 @@ buf_map_region_release_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
 #endif
 
 done:
-    fflush(stdout);
-
 #ifndef ENABLE_MULTITHREAD
     free(remote_reg_info->offset);
     free(remote_reg_info->size);
@@ -2779,7 +2990,6 @@ obj_map_region_release_bulk_transfer_cb(const struct hg_cb_info *hg_cb_info)
 #endif
 
 done:
-    fflush(stdout);
     free(bulk_args->remote_reg_info);
     HG_Free_input(bulk_args->handle, &(bulk_args->in));
     HG_Destroy(bulk_args->handle);
@@ -2844,8 +3054,9 @@ HG_TEST_RPC_CB(region_release, handle)
     struct pdc_region_info *             remote_reg_info;
     region_buf_map_t *                   eltt, *eltt2, *eltt_tmp;
     hg_uint32_t /*k, m, */               remote_count;
-    void **                              data_ptrs_to = NULL;
-    size_t *                             data_size_to = NULL;
+    void **                              data_ptrs_to  = NULL;
+    size_t *                             data_size_to  = NULL;
+    uint64_t                             metrics_start = PDC_metrics_now();
     // size_t                               type_size    = 0;
     // size_t                               dims[4]      = {0, 0, 0, 0};
 #ifdef PDC_TIMING
@@ -3316,6 +3527,7 @@ done:
     }
 
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_REGION_RELEASE, metrics_start, 0);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3633,7 +3845,6 @@ HG_TEST_RPC_CB(transform_region_release, handle)
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         out.ret = 0;
         HG_Respond(handle, NULL, NULL, &out);
@@ -3795,7 +4006,6 @@ HG_TEST_RPC_CB(region_transform_release, handle)
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         out.ret = 0;
         HG_Respond(handle, NULL, NULL, &out);
@@ -4164,7 +4374,6 @@ HG_TEST_RPC_CB(region_analysis_release, handle)
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         out.ret = 0;
         HG_Respond(handle, NULL, NULL, &out);
@@ -4178,8 +4387,9 @@ done:
 // region_lock_cb
 HG_TEST_RPC_CB(region_lock, handle)
 {
-    hg_return_t       ret_value = HG_SUCCESS;
-    perr_t            ret       = SUCCEED;
+    hg_return_t       ret_value     = HG_SUCCESS;
+    perr_t            ret           = SUCCEED;
+    uint64_t          metrics_start = PDC_metrics_now();
     region_lock_in_t  in;
     region_lock_out_t out;
 #ifdef PDC_TIMING
@@ -4212,6 +4422,7 @@ HG_TEST_RPC_CB(region_lock, handle)
         pdc_timestamp_register(pdc_obtain_lock_write_timestamps, start, end);
     }
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_REGION_LOCK, metrics_start, 0);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4219,7 +4430,8 @@ HG_TEST_RPC_CB(region_lock, handle)
 // buf_unmap_cb(hg_handle_t handle)
 HG_TEST_RPC_CB(buf_unmap, handle)
 {
-    hg_return_t           ret_value = HG_SUCCESS;
+    hg_return_t           ret_value     = HG_SUCCESS;
+    uint64_t              metrics_start = PDC_metrics_now();
     perr_t                ret;
     buf_unmap_in_t        in;
     buf_unmap_out_t       out;
@@ -4259,12 +4471,12 @@ HG_TEST_RPC_CB(buf_unmap, handle)
             "===PDC_DATA_SERVER: HG_TEST_RPC_CB(buf_unmap, handle) - PDC_Meta_Server_buf_unmap() failed");
 
 done:
-    fflush(stdout);
 #ifdef PDC_TIMING
     end = MPI_Wtime();
     pdc_server_timings->PDCbuf_obj_unmap_rpc += end - start;
     pdc_timestamp_register(pdc_buf_obj_unmap_timestamps, start, end);
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_BUF_UNMAP, metrics_start, 0);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4344,7 +4556,6 @@ HG_TEST_RPC_CB(buf_unmap_server, handle)
 #endif
 
 done:
-    fflush(stdout);
     HG_Respond(handle, NULL, NULL, &out);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
@@ -4408,7 +4619,6 @@ HG_TEST_RPC_CB(buf_map_server, handle)
     free(request_region);
 
 done:
-    fflush(stdout);
     HG_Respond(handle, NULL, NULL, &out);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
@@ -4419,7 +4629,8 @@ done:
 // buf_map_cb(hg_handle_t handle)
 HG_TEST_RPC_CB(buf_map, handle)
 {
-    hg_return_t           ret_value = HG_SUCCESS;
+    hg_return_t           ret_value     = HG_SUCCESS;
+    uint64_t              metrics_start = PDC_metrics_now();
     perr_t                ret;
     buf_map_in_t          in;
     buf_map_out_t         out;
@@ -4491,7 +4702,7 @@ HG_TEST_RPC_CB(buf_map, handle)
     pdc_timestamp_register(pdc_buf_obj_map_timestamps, start, end);
 #endif
 done:
-    fflush(stdout);
+    PDC_metrics_record(PDC_METRIC_SERVER_BUF_MAP, metrics_start, 0);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4579,7 +4790,6 @@ HG_TEST_RPC_CB(query_partial, handle)
     ret_value = HG_Respond(handle, NULL, NULL, &out);
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
@@ -4627,7 +4837,6 @@ HG_TEST_RPC_CB(query_kvtag, handle)
     ret_value = HG_Respond(handle, NULL, NULL, &out);
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
@@ -4687,7 +4896,6 @@ update_storage_meta_bulk_cb(const struct hg_cb_info *hg_cb_info)
     } // end of else
 
 done:
-    fflush(stdout);
     HG_Bulk_free(local_bulk_handle);
     HG_Respond(bulk_args->handle, NULL, NULL, &out_struct);
     HG_Destroy(bulk_args->handle);
@@ -4749,7 +4957,6 @@ HG_TEST_RPC_CB(bulk_rpc, handle)
     HG_Free_input(handle, &in_struct);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4796,7 +5003,6 @@ HG_TEST_RPC_CB(data_server_read, handle)
         PGOTO_ERROR(ret_value, "==PDC_SERVER: data_server_read_cb - Error with HG_Destroy");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4841,7 +5047,6 @@ HG_TEST_RPC_CB(data_server_write, handle)
         PGOTO_ERROR(ret_value, "==PDC_SERVER: data_server_write_cb - Error with HG_Destroy");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4944,7 +5149,6 @@ HG_TEST_RPC_CB(update_region_loc, handle)
     free(input_region);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5107,7 +5311,6 @@ PDC_find_in_path(char *workingDir, char *application)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5163,7 +5366,6 @@ done:
     HG_Respond(bulk_args->handle, NULL, NULL, &out_struct);
     HG_Destroy(bulk_args->handle);
     free(bulk_args);
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -5218,7 +5420,6 @@ HG_TEST_RPC_CB(cont_add_del_objs_rpc, handle)
     HG_Free_input(handle, &in_struct);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5303,7 +5504,6 @@ query_read_obj_name_bulk_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     HG_Destroy(bulk_args->handle);
     free(bulk_args);
 
@@ -5357,7 +5557,6 @@ HG_TEST_RPC_CB(query_read_obj_name_rpc, handle)
     HG_Free_input(handle, &in_struct);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5409,7 +5608,6 @@ PDC_check_int_ret_cb(const struct hg_cb_info *callback_info)
         PGOTO_ERROR(ret_value, "== Return value [%d] is NOT expected", output.ret);
 
 done:
-    fflush(stdout);
     HG_Free_output(handle, &output);
 
     FUNC_LEAVE(ret_value);
@@ -5488,7 +5686,6 @@ get_storage_meta_bulk_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     HG_Destroy(bulk_args->handle);
     free(bulk_args);
 
@@ -5541,7 +5738,6 @@ HG_TEST_RPC_CB(get_storage_meta_name_query_bulk_result_rpc, handle)
     HG_Free_input(handle, &in_struct);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5585,7 +5781,6 @@ notify_client_multi_io_complete_bulk_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     HG_Destroy(bulk_args->handle);
     free(bulk_args);
 
@@ -5629,7 +5824,6 @@ HG_TEST_RPC_CB(notify_client_multi_io_complete_rpc, handle)
         PGOTO_ERROR(ret_value, "Could not read bulk data");
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in_struct);
 
     FUNC_LEAVE(ret_value);
@@ -5675,7 +5869,6 @@ PDC_add_task_to_list(pdc_task_list_t **target_list, perr_t (*cb)(), void *cb_arg
     ret_value = new_task->task_id;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5711,7 +5904,6 @@ PDC_del_task_from_list(pdc_task_list_t **target_list, pdc_task_list_t *del,
     free(tmp);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5728,7 +5920,6 @@ PDC_is_valid_task_id(int id)
     ret_value = 1;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5767,7 +5958,6 @@ PDC_find_task_from_list(pdc_task_list_t **target_list, int id,
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5796,7 +5986,6 @@ PDC_del_task_from_list_id(pdc_task_list_t **target_list, int id, hg_thread_mutex
     free(tmp);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5813,7 +6002,6 @@ PDC_is_valid_obj_id(uint64_t id)
     ret_value = 1;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5837,6 +6025,30 @@ HG_TEST_RPC_CB(server_checkpoint_rpc, handle)
     FUNC_LEAVE(ret_value);
 }
 
+/* server_metrics_rpc_cb(hg_handle_t handle) */
+HG_TEST_RPC_CB(server_metrics_rpc, handle)
+{
+    hg_return_t          ret_value = HG_SUCCESS;
+    pdc_int_send_t       in;
+    server_metrics_out_t out;
+    char *               snapshot;
+
+    FUNC_ENTER(NULL);
+
+    HG_Get_input(handle, &in);
+
+    snapshot = (char *)malloc(PDC_METRICS_SNAPSHOT_SIZE);
+    PDC_metrics_snapshot(snapshot, PDC_METRICS_SNAPSHOT_SIZE);
+    out.snapshot = snapshot;
+    ret_value    = HG_Respond(handle, NULL, NULL, &out);
+    free(snapshot);
+
+    HG_Free_input(handle, &in);
+    HG_Destroy(handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
 /* send_shm_cb(hg_handle_t handle) */
 HG_TEST_RPC_CB(send_shm, handle)
 {
@@ -5919,7 +6131,6 @@ query_read_obj_name_client_bulk_cb(const struct hg_cb_info *hg_cb_info)
         PGOTO_ERROR(ret_value, "Could not free HG bulk handle");
 
 done:
-    fflush(stdout);
     HG_Destroy(bulk_args->handle);
     free(bulk_args);
 
@@ -5971,7 +6182,6 @@ HG_TEST_RPC_CB(query_read_obj_name_client_rpc, handle)
     HG_Free_input(handle, &in_struct);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6011,7 +6221,6 @@ send_client_storage_meta_bulk_cb(const struct hg_cb_info *hg_cb_info)
     PDC_Client_recv_bulk_storage_meta(process_args);
 
 done:
-    fflush(stdout);
     /* Free bulk handle */
     HG_Bulk_free(local_bulk_handle);
     HG_Destroy(bulk_args->handle);
@@ -6078,7 +6287,6 @@ HG_TEST_RPC_CB(send_client_storage_meta_rpc, handle)
         PGOTO_ERROR(ret_value, "Could not respond");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6109,7 +6317,6 @@ server_recv_shm_bulk_cb(const struct hg_cb_info *hg_cb_info)
     } // end else
 
 done:
-    fflush(stdout);
     /* Free bulk handle */
     HG_Bulk_free(local_bulk_handle);
     HG_Destroy(bulk_args->handle);
@@ -6175,7 +6382,6 @@ HG_TEST_RPC_CB(send_shm_bulk_rpc, handle)
         PGOTO_ERROR(ret_value, "Could not respond");
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6307,6 +6513,7 @@ HG_TEST_RPC_CB(send_bulk_rpc, handle)
     bulk_arg                = (struct bulk_args_t *)calloc(1, sizeof(struct bulk_args_t));
     bulk_arg->cnt           = in_struct.cnt;
     bulk_arg->total         = in_struct.total;
+    bulk_arg->offset        = in_struct.offset;
     bulk_arg->origin        = in_struct.origin;
     bulk_arg->query_id      = in_struct.seq_id;
     bulk_arg->client_seq_id = in_struct.seq_id2;
@@ -6318,7 +6525,7 @@ HG_TEST_RPC_CB(send_bulk_rpc, handle)
 
     bulk_arg->handle = handle;
 
-    if (in_struct.op_id == PDC_BULK_QUERY_COORDS) {
+    if (in_struct.op_id == PDC_BULK_QUERY_COORDS || in_struct.op_id == PDC_BULK_QUERY_COORDS_BATCH) {
         func_ptr = &PDC_recv_coords;
     }
     else if (in_struct.op_id == PDC_BULK_READ_COORDS) {
@@ -6352,7 +6559,6 @@ HG_TEST_RPC_CB(send_bulk_rpc, handle)
     }
 
 done:
-    fflush(stdout);
     HG_Free_input(handle, &in_struct);
 
     FUNC_LEAVE(ret_value);
@@ -6360,6 +6566,9 @@ done:
 
 HG_TEST_THREAD_CB(server_lookup_client)
 HG_TEST_THREAD_CB(gen_obj_id)
+HG_TEST_THREAD_CB(gen_obj_id_batch)
+HG_TEST_THREAD_CB(obj_put_data)
+HG_TEST_THREAD_CB(obj_get_data)
 HG_TEST_THREAD_CB(gen_cont_id)
 HG_TEST_THREAD_CB(cont_add_del_objs_rpc)
 HG_TEST_THREAD_CB(cont_add_tags_rpc)
@@ -6368,6 +6577,7 @@ HG_TEST_THREAD_CB(storage_meta_name_query_rpc)
 HG_TEST_THREAD_CB(get_storage_meta_name_query_bulk_result_rpc)
 HG_TEST_THREAD_CB(notify_client_multi_io_complete_rpc)
 HG_TEST_THREAD_CB(server_checkpoint_rpc)
+HG_TEST_THREAD_CB(server_metrics_rpc)
 HG_TEST_THREAD_CB(send_shm)
 HG_TEST_THREAD_CB(client_test_connect)
 HG_TEST_THREAD_CB(metadata_query)
@@ -6444,6 +6654,9 @@ HG_TEST_THREAD_CB(send_read_sel_obj_id_rpc)
     }
 
 PDC_FUNC_DECLARE_REGISTER(gen_obj_id)
+PDC_FUNC_DECLARE_REGISTER(gen_obj_id_batch)
+PDC_FUNC_DECLARE_REGISTER_IN_OUT(obj_put_data, obj_put_data_in_t, gen_obj_id_out_t)
+PDC_FUNC_DECLARE_REGISTER(obj_get_data)
 PDC_FUNC_DECLARE_REGISTER(gen_cont_id)
 PDC_FUNC_DECLARE_REGISTER(server_lookup_client)
 PDC_FUNC_DECLARE_REGISTER(server_lookup_remote_server)
@@ -6501,6 +6714,7 @@ PDC_FUNC_DECLARE_REGISTER_IN_OUT(storage_meta_name_query_rpc, storage_meta_name_
 PDC_FUNC_DECLARE_REGISTER_IN_OUT(get_storage_meta_name_query_bulk_result_rpc, bulk_rpc_in_t, pdc_int_ret_t)
 
 PDC_FUNC_DECLARE_REGISTER_IN_OUT(server_checkpoint_rpc, pdc_int_send_t, pdc_int_ret_t)
+PDC_FUNC_DECLARE_REGISTER_IN_OUT(server_metrics_rpc, pdc_int_send_t, server_metrics_out_t)
 PDC_FUNC_DECLARE_REGISTER_IN_OUT(send_shm, send_shm_in_t, pdc_int_ret_t)
 PDC_FUNC_DECLARE_REGISTER_IN_OUT(cont_add_tags_rpc, cont_add_tags_rpc_in_t, pdc_int_ret_t)
 PDC_FUNC_DECLARE_REGISTER_IN_OUT(notify_client_multi_io_complete_rpc, bulk_rpc_in_t, pdc_int_ret_t)
@@ -6645,7 +6859,6 @@ PDC_is_contiguous_region_overlap(region_list_t *a, region_list_t *b)
             is_overlap_3D(xmin1, xmax1, ymin1, ymax1, zmin1, zmax1, xmin2, xmax2, ymin2, ymax2, zmin2, zmax2);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6693,7 +6906,6 @@ PDC_is_contiguous_start_count_overlap(uint32_t ndim, uint64_t *a_start, uint64_t
             is_overlap_3D(xmin1, xmax1, ymin1, ymax1, zmin1, zmax1, xmin2, xmax2, ymin2, ymax2, zmin2, zmax2);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6777,7 +6989,6 @@ PDC_create_shm_segment_ind(uint64_t size, char *shm_addr, void **buf)
     // close and shm_unlink?
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -6824,7 +7035,6 @@ PDC_create_shm_segment(region_list_t *region)
     // close and shm_unlink?
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7076,7 +7286,6 @@ PDCquery_print(pdc_query_t *query)
     }
     printf("\n");
 
-    fflush(stdout);
     FUNC_LEAVE_VOID;
 }
 
@@ -7113,8 +7322,6 @@ PDC_serialize_query(pdc_query_t *query)
     ret_value = query_xfer;
 
 done:
-
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7137,7 +7344,6 @@ PDC_deserialize_query(pdc_query_xfer_t *query_xfer)
     ret_value = new_root;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -7148,6 +7354,9 @@ PDCquery_free(pdc_query_t *query)
 
     if (NULL == query)
         PGOTO_DONE_VOID;
+#ifndef IS_PDC_SERVER
+    PDC_Client_query_close_batch(query);
+#endif
     if (query->constraint)
         free(query->constraint);
     free(query);
@@ -7163,6 +7372,9 @@ PDCquery_free_all(pdc_query_t *root)
 
     if (NULL == root)
         PGOTO_DONE_VOID;
+#ifndef IS_PDC_SERVER
+    PDC_Client_query_close_batch(root);
+#endif
 
     if (root->sel && root->sel->coords_alloc > 0 && root->sel->coords != NULL) {
         free(root->sel->coords);
@@ -0,0 +1,368 @@
+/* Byte shuffle as in Blosc, followed by an LZ77 pass that writes the LZ4 block format */
+
+#include <stdlib.h>
+#include <string.h>
+#include "pdc_codec.h"
+
+#define CODEC_MIN_MATCH 4
+#define CODEC_MAX_OFFSET 65535
+#define CODEC_HASH_LOG 13
+// The last match must start this many bytes before the end, and the last bytes are always literals
+#define CODEC_MATCH_LIMIT 12
+#define CODEC_LAST_LITERALS 5
+// Skip ahead faster after this many misses in a row, incompressible data is not scanned byte by byte
+#define CODEC_SKIP_TRIGGER 6
+
+static inline uint32_t
+codec_read32(const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t
+codec_read64(const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t
+codec_hash(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - CODEC_HASH_LOG);
+}
+
+// Write the 255-continued tail of a length that did not fit in its 4-bit token field
+static inline uint8_t *
+codec_write_length(uint8_t *op, size_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+static inline int
+codec_read_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+    uint8_t b;
+
+    do {
+        if (*ip >= iend)
+            return -1;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    return 0;
+}
+
+size_t
+PDC_codec_compress(const void *src, size_t size, void *dst, size_t dst_size)
+{
+    const uint8_t *base   = (const uint8_t *)src;
+    const uint8_t *ip     = base;
+    const uint8_t *anchor = base;
+    const uint8_t *iend   = base + size;
+    const uint8_t *mlimit, *ilimit, *ref;
+    uint8_t *      op   = (uint8_t *)dst;
+    uint8_t *      oend = op + dst_size;
+    uint8_t *      token;
+    uint32_t *     table;
+    uint32_t       seq, h, nmiss = 0;
+    size_t         nlit, mlen;
+
+    if (size > UINT32_MAX)
+        return 0;
+
+    table = (uint32_t *)calloc(1 << CODEC_HASH_LOG, sizeof(uint32_t));
+    if (table == NULL)
+        return 0;
+
+    if (size > CODEC_MATCH_LIMIT) {
+        mlimit = iend - CODEC_LAST_LITERALS;
+        ilimit = iend - CODEC_MATCH_LIMIT;
+        ip++;
+        while (ip < ilimit) {
+            seq      = codec_read32(ip);
+            h        = codec_hash(seq);
+            ref      = base + table[h];
+            table[h] = (uint32_t)(ip - base);
+            if (ip - ref > CODEC_MAX_OFFSET || codec_read32(ref) != seq) {
+                ip += 1 + (nmiss++ >> CODEC_SKIP_TRIGGER);
+                continue;
+            }
+            nmiss = 0;
+
+            // Extend the match backwards into the pending literals, then forwards
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+            }
+            mlen = CODEC_MIN_MATCH;
+            while (ip + mlen + 8 <= mlimit && codec_read64(ip + mlen) == codec_read64(ref + mlen))
+                mlen += 8;
+            while (ip + mlen < mlimit && ip[mlen] == ref[mlen])
+                mlen++;
+
+            nlit = ip - anchor;
+            if ((size_t)(oend - op) < 1 + nlit / 255 + 1 + nlit + 2 + mlen / 255 + 1) {
+                free(table);
+                return 0;
+            }
+            token = op++;
+            if (nlit >= 15) {
+                *token = 15 << 4;
+                op     = codec_write_length(op, nlit - 15);
+            }
+            else
+                *token = (uint8_t)(nlit << 4);
+            memcpy(op, anchor, nlit);
+            op += nlit;
+
+            *op++ = (uint8_t)((ip - ref) & 0xff);
+            *op++ = (uint8_t)((ip - ref) >> 8);
+            if (mlen - CODEC_MIN_MATCH >= 15) {
+                *token |= 15;
+                op = codec_write_length(op, mlen - CODEC_MIN_MATCH - 15);
+            }
+            else
+                *token |= (uint8_t)(mlen - CODEC_MIN_MATCH);
+
+            ip += mlen;
+            anchor = ip;
+            // Index a position inside the match so the next lookup has a recent candidate
+            if (ip < ilimit)
+                table[codec_hash(codec_read32(ip - 2))] = (uint32_t)(ip - 2 - base);
+        }
+    }
+    free(table);
+
+    // Last sequence, literals only
+    nlit = iend - anchor;
+    if ((size_t)(oend - op) < 1 + nlit / 255 + 1 + nlit)
+        return 0;
+    token = op++;
+    if (nlit >= 15) {
+        *token = 15 << 4;
+        op     = codec_write_length(op, nlit - 15);
+    }
+    else
+        *token = (uint8_t)(nlit << 4);
+    memcpy(op, anchor, nlit);
+    op += nlit;
+
+    return op - (uint8_t *)dst;
+}
+
+size_t
+PDC_codec_decompress(const void *src, size_t csize, void *dst, size_t size)
+{
+    const uint8_t *ip   = (const uint8_t *)src;
+    const uint8_t *iend = ip + csize;
+    uint8_t *      base = (uint8_t *)dst;
+    uint8_t *      op   = base;
+    uint8_t *      oend = base + size;
+    const uint8_t *match;
+    size_t         nlit, mlen, offset, i;
+    uint8_t        token;
+
+    while (ip < iend) {
+        token = *ip++;
+        nlit  = token >> 4;
+        if (nlit == 15 && codec_read_length(&ip, iend, &nlit) != 0)
+            return 0;
+        if (nlit > (size_t)(iend - ip) || nlit > (size_t)(oend - op))
+            return 0;
+        // Short runs are copied with a fixed 16-byte copy when both buffers have room for it
+        if (nlit <= 16 && iend - ip >= 16 && oend - op >= 16)
+            memcpy(op, ip, 16);
+        else
+            memcpy(op, ip, nlit);
+        op += nlit;
+        ip += nlit;
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return 0;
+        offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - base))
+            return 0;
+        mlen = token & 15;
+        if (mlen == 15 && codec_read_length(&ip, iend, &mlen) != 0)
+            return 0;
+        mlen += CODEC_MIN_MATCH;
+        if (mlen > (size_t)(oend - op))
+            return 0;
+
+        match = op - offset;
+        if (offset >= 8 && (size_t)(oend - op) >= mlen + 8) {
+            // Copy 8 bytes at a time, the bytes written past the match are overwritten later
+            for (i = 0; i < mlen; i += 8)
+                memcpy(op + i, match + i, 8);
+        }
+        else if (offset >= mlen)
+            memcpy(op, match, mlen);
+        else {
+            // Overlapping match repeats the last offset bytes
+            for (i = 0; i < mlen; i++)
+                op[i] = match[i];
+        }
+        op += mlen;
+    }
+
+    return op - base;
+}
+
+// Four and eight byte elements get one store per byte stream in the loop body, which the compiler vectorizes
+static void
+codec_shuffle4(const uint8_t *in, uint8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        out[i]         = in[4 * i];
+        out[n + i]     = in[4 * i + 1];
+        out[2 * n + i] = in[4 * i + 2];
+        out[3 * n + i] = in[4 * i + 3];
+    }
+}
+
+static void
+codec_unshuffle4(const uint8_t *in, uint8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        out[4 * i]     = in[i];
+        out[4 * i + 1] = in[n + i];
+        out[4 * i + 2] = in[2 * n + i];
+        out[4 * i + 3] = in[3 * n + i];
+    }
+}
+
+static void
+codec_shuffle8(const uint8_t *in, uint8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        out[i]         = in[8 * i];
+        out[n + i]     = in[8 * i + 1];
+        out[2 * n + i] = in[8 * i + 2];
+        out[3 * n + i] = in[8 * i + 3];
+        out[4 * n + i] = in[8 * i + 4];
+        out[5 * n + i] = in[8 * i + 5];
+        out[6 * n + i] = in[8 * i + 6];
+        out[7 * n + i] = in[8 * i + 7];
+    }
+}
+
+static void
+codec_unshuffle8(const uint8_t *in, uint8_t *out, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        out[8 * i]     = in[i];
+        out[8 * i + 1] = in[n + i];
+        out[8 * i + 2] = in[2 * n + i];
+        out[8 * i + 3] = in[3 * n + i];
+        out[8 * i + 4] = in[4 * n + i];
+        out[8 * i + 5] = in[5 * n + i];
+        out[8 * i + 6] = in[6 * n + i];
+        out[8 * i + 7] = in[7 * n + i];
+    }
+}
+
+void
+PDC_codec_shuffle(const void *src, void *dst, size_t size, size_t unit)
+{
+    const uint8_t *in  = (const uint8_t *)src;
+    uint8_t *      out = (uint8_t *)dst;
+    size_t         n, i, b;
+
+    if (unit <= 1) {
+        memcpy(dst, src, size);
+        return;
+    }
+    n = size / unit;
+    if (unit == 4)
+        codec_shuffle4(in, out, n);
+    else if (unit == 8)
+        codec_shuffle8(in, out, n);
+    else {
+        for (b = 0; b < unit; b++)
+            for (i = 0; i < n; i++)
+                out[b * n + i] = in[i * unit + b];
+    }
+    memcpy(out + n * unit, in + n * unit, size - n * unit);
+}
+
+void
+PDC_codec_unshuffle(const void *src, void *dst, size_t size, size_t unit)
+{
+    const uint8_t *in  = (const uint8_t *)src;
+    uint8_t *      out = (uint8_t *)dst;
+    size_t         n, i, b;
+
+    if (unit <= 1) {
+        memcpy(dst, src, size);
+        return;
+    }
+    n = size / unit;
+    if (unit == 4)
+        codec_unshuffle4(in, out, n);
+    else if (unit == 8)
+        codec_unshuffle8(in, out, n);
+    else {
+        for (b = 0; b < unit; b++)
+            for (i = 0; i < n; i++)
+                out[i * unit + b] = in[b * n + i];
+    }
+    memcpy(out + n * unit, in + n * unit, size - n * unit);
+}
+
+int
+PDC_codec_encode(int codec, const void *src, size_t size, size_t unit, void *dst, void *tmp, size_t *csize)
+{
+    size_t n = 0;
+
+    if (codec == PDC_CODEC_SHUFFLE_LZ) {
+        PDC_codec_shuffle(src, tmp, size, unit);
+        n = PDC_codec_compress(tmp, size, dst, size);
+    }
+    if (n == 0 || n >= size) {
+        memcpy(dst, src, size);
+        *csize = size;
+        return PDC_CODEC_NONE;
+    }
+    *csize = n;
+    return codec;
+}
+
+int
+PDC_codec_decode(int codec, const void *src, size_t csize, size_t unit, void *dst, size_t size, void *tmp)
+{
+    if (codec == PDC_CODEC_NONE) {
+        if (csize != size)
+            return -1;
+        memcpy(dst, src, size);
+        return 0;
+    }
+    if (codec == PDC_CODEC_SHUFFLE_LZ) {
+        if (PDC_codec_decompress(src, csize, tmp, size) != size)
+            return -1;
+        PDC_codec_unshuffle(tmp, dst, size, unit);
+        return 0;
+    }
+    return -1;
+}
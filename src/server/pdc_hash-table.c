@@ -295,20 +295,13 @@ hash_table_insert(HashTable *hash_table, HashTableKey key, HashTableValue value)
     newentry->pair.value = value;
 
     /* Link into the list */
-    newentry->next = hash_table->table[index];
-#ifdef ENABLE_MULTITHREAD
-    hg_thread_mutex_lock(&hash_table_new_mutex_g);
-#endif
+    newentry->next           = hash_table->table[index];
     hash_table->table[index] = newentry;
 
     /* Maintain the count of the number of entries */
     ++hash_table->entries;
 
     /* Added successfully */
-#ifdef ENABLE_MULTITHREAD
-    hg_thread_mutex_unlock(&hash_table_new_mutex_g);
-#endif
-
     return 1;
 }
 
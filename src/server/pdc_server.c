@@ -56,6 +56,10 @@
 #include "pdc_timing.h"
 #include "pdc_server_region_cache.h"
 #include "pdc_server_region_transfer_metadata_query.h"
+#include "pdc_server_query_cache.h"
+#include "pdc_server_read_cache.h"
+#include "pdc_server_chunk.h"
+#include "pdc_server_segment.h"
 
 #ifdef PDC_HAS_CRAY_DRC
 #include <rdmacred.h>
@@ -101,6 +105,7 @@ hg_id_t storage_meta_name_query_register_id_g;
 hg_id_t get_storage_meta_name_query_bulk_result_rpc_register_id_g;
 hg_id_t notify_client_multi_io_complete_rpc_register_id_g;
 hg_id_t server_checkpoint_rpc_register_id_g;
+hg_id_t server_metrics_rpc_register_id_g;
 hg_id_t send_shm_register_id_g;
 hg_id_t send_client_storage_meta_rpc_register_id_g;
 hg_id_t send_read_sel_obj_id_rpc_register_id_g;
@@ -132,6 +137,7 @@ int               read_from_bb_size_g          = 0;
 int               gen_hist_g                   = 0;
 int               gen_fastbit_idx_g            = 0;
 int               use_fastbit_idx_g            = 0;
+uint64_t          pdc_query_batch_nhits_g      = PDC_QUERY_BATCH_NHITS_DEFAULT;
 char *            gBinningOption               = NULL;
 
 double server_write_time_g                  = 0.0;
@@ -383,6 +389,12 @@ done:
     FUNC_LEAVE(ret_value);
 }
 
+// Number of remote server addrs resolved so far
+static int n_remote_server_lookup_done_g = 0;
+// Seconds spent in the startup phases of this server
+static double startup_init_sec_g   = 0;
+static double startup_lookup_sec_g = 0;
+
 /*
  * Callback function of the server to lookup other servers via Mercury RPC
  *
@@ -407,6 +419,7 @@ lookup_remote_server_cb(const struct hg_cb_info *callback_info)
 #endif
     pdc_remote_server_info_g[server_id].addr       = callback_info->info.lookup.addr;
     pdc_remote_server_info_g[server_id].addr_valid = 1;
+    n_remote_server_lookup_done_g++;
 #ifdef ENABLE_MULTITHREAD
     hg_thread_mutex_unlock(&update_remote_server_addr_mutex_g);
 #endif
@@ -425,75 +438,112 @@ done:
 }
 
 /*
- * Test connection to another server, and stores the remote server's addr into
- * pdc_remote_server_info_g
+ * Start the lookup of another server's addr, lookup_remote_server_cb stores it when it completes
+ *
+ * \param  remote_server_id[IN]     ID of the remote server
  *
  * \return Non-negative on success/Negative on failure
  */
-perr_t
-PDC_Server_lookup_server_id(int remote_server_id)
+static perr_t
+PDC_Server_post_lookup_server_id(int remote_server_id)
 {
     perr_t                ret_value = SUCCEED;
     hg_return_t           hg_ret    = HG_SUCCESS;
     server_lookup_args_t *lookup_args;
-    unsigned              actual_count;
 
     FUNC_ENTER(NULL);
 
-    if (remote_server_id == pdc_server_rank_g || pdc_remote_server_info_g[remote_server_id].addr_valid == 1)
-        return SUCCEED;
-
     lookup_args = (server_lookup_args_t *)calloc(1, sizeof(server_lookup_args_t));
 
     lookup_args->server_id = remote_server_id;
     hg_ret                 = HG_Addr_lookup(hg_context_g, lookup_remote_server_cb, lookup_args,
                             pdc_remote_server_info_g[remote_server_id].addr_string, HG_OP_ID_IGNORE);
     if (hg_ret != HG_SUCCESS) {
+        free(lookup_args);
         printf("==PDC_SERVER: Connection to remote server FAILED!\n");
         ret_value = FAIL;
-        goto done;
     }
 
-    hg_ret = HG_Trigger(hg_context_g, 0 /* timeout */, 1 /* max count */, &actual_count);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Test connection to another server, and stores the remote server's addr into
+ * pdc_remote_server_info_g
+ *
+ * \param  remote_server_id[IN]     ID of the remote server
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t
+PDC_Server_lookup_server_id(int remote_server_id)
+{
+    perr_t   ret_value = SUCCEED;
+    unsigned actual_count;
+
+    FUNC_ENTER(NULL);
+
+    if (remote_server_id == pdc_server_rank_g || pdc_remote_server_info_g[remote_server_id].addr_valid == 1)
+        return SUCCEED;
+
+    ret_value = PDC_Server_post_lookup_server_id(remote_server_id);
+    if (ret_value != SUCCEED)
+        goto done;
+
+    // Run the callback now if the lookup already completed, otherwise a later progress call runs it
+    HG_Trigger(hg_context_g, 0 /* timeout */, 1 /* max count */, &actual_count);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
 /*
- * Test connection to all other servers
+ * Test connection to all other servers. All servers post the lookups of all others at the same time and
+ * wait for them to complete, instead of taking turns.
  *
  * \return Non-negative on success/Negative on failure
  */
 perr_t
 PDC_Server_lookup_all_servers()
 {
-    int    i, j;
-    perr_t ret_value = SUCCEED;
+    int            i, n_posted, n_done_start;
+    perr_t         ret_value = SUCCEED;
+    hg_return_t    hg_ret;
+    unsigned       actual_count;
+    double         timeout;
+    char *         timeout_env;
+    struct timeval start_time, now;
 
     FUNC_ENTER(NULL);
 
-    // Lookup and fill the remote server info
-    for (j = 0; j < pdc_server_size_g; j++) {
+    timeout     = PDC_SERVER_LOOKUP_TIMEOUT_DEFAULT;
+    timeout_env = getenv("PDC_SERVER_LOOKUP_TIMEOUT");
+    if (timeout_env != NULL && atof(timeout_env) > 0)
+        timeout = atof(timeout_env);
 
-#ifdef ENABLE_MPI
-        MPI_Barrier(MPI_COMM_WORLD);
-#endif
-
-        if (j == pdc_server_rank_g) {
-            // It's my turn, I will connect to all other servers
-            for (i = 0; i < pdc_server_size_g; i++) {
-                if (i == pdc_server_rank_g)
-                    continue;
+    // Lookup and fill the remote server info
+    gettimeofday(&start_time, 0);
+    n_done_start = n_remote_server_lookup_done_g;
+    n_posted     = 0;
+    for (i = 0; i < pdc_server_size_g; i++) {
+        if (i == pdc_server_rank_g || pdc_remote_server_info_g[i].addr_valid == 1)
+            continue;
+        if (PDC_Server_post_lookup_server_id(i) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: ERROR when lookup remote server %d!", pdc_server_rank_g, i);
+        n_posted++;
+    }
 
-                if (PDC_Server_lookup_server_id(i) != SUCCEED) {
-                    printf("==PDC_SERVER[%d]: ERROR when lookup remote server %d!\n", pdc_server_rank_g, i);
-                    ret_value = FAIL;
-                    goto done;
-                }
-            }
-        }
+    while (n_remote_server_lookup_done_g - n_done_start < n_posted) {
+        do {
+            hg_ret = HG_Trigger(hg_context_g, 0, n_posted, &actual_count);
+        } while (hg_ret == HG_SUCCESS && actual_count > 0);
+        if (n_remote_server_lookup_done_g - n_done_start >= n_posted)
+            break;
+        gettimeofday(&now, 0);
+        if (PDC_get_elapsed_time_double(&start_time, &now) > timeout)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: timeout with %d of %d remote server lookups done",
+                        pdc_server_rank_g, n_remote_server_lookup_done_g - n_done_start, n_posted);
+        HG_Progress(hg_context_g, 100);
     }
 
     if (pdc_server_rank_g == 0) {
@@ -534,7 +584,6 @@ PDC_Server_lookup_client_cb(const struct hg_cb_info *callback_info)
     pdc_client_info_g[client_id].addr_valid = 1;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -584,7 +633,6 @@ PDC_Server_lookup_client(uint32_t client_id)
     hg_ret = HG_Trigger(hg_context_g, 0 /* timeout */, 1 /* max count */, &actual_count);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -695,6 +743,9 @@ PDC_Server_init(int port, hg_class_t **hg_class, hg_context_t **hg_context)
     char                na_info_string[ADDR_MAX];
     char                hostname[1024];
     struct hg_init_info init_info = {0};
+    struct timeval      init_start, init_end;
+
+    gettimeofday(&init_start, 0);
 
     /* Set the default mercury transport
      * but enable overriding that to any of:
@@ -704,6 +755,7 @@ PDC_Server_init(int port, hg_class_t **hg_class, hg_context_t **hg_context)
      */
     char *default_hg_transport = "ofi+tcp";
     char *hg_transport;
+    char *auto_sm_env;
 #ifdef PDC_HAS_CRAY_DRC
     uint32_t          credential = 0, cookie;
     drc_info_handle_t credential_info;
@@ -772,14 +824,23 @@ drc_access_again:
     init_info.na_init_info.progress_mode = NA_NO_BLOCK; // busy mode
 #endif
 
-#ifdef PDC_HAS_SHARED_SERVER
-    init_info.auto_sm = HG_TRUE;
-#endif
+    // Clients on the same node reach this server through na+sm, its address then carries both the sm and
+    // the network address. PDC_HG_AUTO_SM=0 turns sm off.
+    auto_sm_env = getenv("PDC_HG_AUTO_SM");
+    if (auto_sm_env == NULL || atoi(auto_sm_env) != 0)
+        init_info.auto_sm = HG_TRUE;
     *hg_class = HG_Init_opt(na_info_string, HG_TRUE, &init_info);
+    if (*hg_class == NULL && init_info.auto_sm) {
+        // Mercury built without the na+sm plugin, or no usable shared memory, use the network only
+        init_info.auto_sm = HG_FALSE;
+        *hg_class         = HG_Init_opt(na_info_string, HG_TRUE, &init_info);
+    }
     if (*hg_class == NULL) {
         printf("Error with HG_Init()\n");
         return FAIL;
     }
+    if (pdc_server_rank_g == 0 && init_info.auto_sm)
+        printf("==PDC_SERVER[%d]: using na+sm for clients on the same node\n", pdc_server_rank_g);
 
     /* Attach handle created for worker thread */
     HG_Class_set_handle_create_callback(*hg_class, PDC_hg_handle_create_cb, NULL);
@@ -833,9 +894,7 @@ drc_access_again:
     hg_thread_pool_init(1, &hg_test_thread_pool_fs_g);
     if (pdc_server_rank_g == 0)
         printf("\n==PDC_SERVER[%d]: Starting server with %d threads...\n", pdc_server_rank_g, n_thread);
-    hg_thread_mutex_init(&hash_table_new_mutex_g);
     hg_thread_mutex_init(&pdc_client_info_mutex_g);
-    hg_thread_mutex_init(&pdc_metadata_hash_table_mutex_g);
     hg_thread_mutex_init(&pdc_container_hash_table_mutex_g);
     hg_thread_mutex_init(&pdc_client_addr_mutex_g);
     hg_thread_mutex_init(&pdc_time_mutex_g);
@@ -853,7 +912,6 @@ drc_access_again:
     hg_thread_mutex_init(&data_obj_map_mutex_g);
     hg_thread_mutex_init(&meta_obj_map_mutex_g);
     hg_thread_mutex_init(&lock_list_mutex_g);
-    hg_thread_mutex_init(&insert_hash_table_mutex_g);
     hg_thread_mutex_init(&lock_request_mutex_g);
     hg_thread_mutex_init(&addr_valid_mutex_g);
     hg_thread_mutex_init(&update_remote_server_addr_mutex_g);
@@ -906,14 +964,46 @@ drc_access_again:
 
     // PDC transfer_request infrastructures
     PDC_server_transfer_request_init();
+    PDC_Server_query_cache_init();
+    PDC_Server_read_cache_init();
+    PDC_Server_chunk_init();
+    PDC_Server_segment_init();
 #ifdef PDC_SERVER_CACHE
     PDC_region_server_cache_init();
 #endif
 
 done:
+    gettimeofday(&init_end, 0);
+    startup_init_sec_g = PDC_get_elapsed_time_double(&init_start, &init_end);
     FUNC_LEAVE(ret_value);
 }
 
+/*
+ * Print the slowest startup phases over all servers, on server 0
+ *
+ * \param  total_sec[IN]        Seconds from the start of this server to ready
+ */
+static void
+PDC_Server_report_startup_time(double total_sec)
+{
+    double startup_sec[3], startup_max_sec[3];
+
+    startup_sec[0] = startup_init_sec_g;
+    startup_sec[1] = startup_lookup_sec_g;
+    startup_sec[2] = total_sec;
+#ifdef ENABLE_MPI
+    MPI_Reduce(startup_sec, startup_max_sec, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#else
+    memcpy(startup_max_sec, startup_sec, sizeof(startup_sec));
+#endif
+    if (pdc_server_rank_g == 0) {
+        printf("==PDC_SERVER[%d]: startup time of %d servers: init %.3fs, server lookup %.3fs, total %.3fs\n",
+               pdc_server_rank_g, pdc_server_size_g, startup_max_sec[0], startup_max_sec[1],
+               startup_max_sec[2]);
+        fflush(stdout);
+    }
+}
+
 /*
  * Destroy the remote server info structures, free the allocated space
  *
@@ -984,8 +1074,7 @@ PDC_Server_finalize()
         io_elt->region_list_head = NULL;
     }
     // Free hash table
-    if (metadata_hash_table_g != NULL)
-        hash_table_free(metadata_hash_table_g);
+    PDC_Server_free_hash_table();
 
     ret_value = PDC_Server_destroy_client_info(pdc_client_info_g);
     if (ret_value != SUCCEED) {
@@ -1041,10 +1130,8 @@ PDC_Server_finalize()
     // Destory pool
     hg_thread_pool_destroy(hg_test_thread_pool_fs_g);
 
-    hg_thread_mutex_destroy(&hash_table_new_mutex_g);
     hg_thread_mutex_destroy(&pdc_client_info_mutex_g);
     hg_thread_mutex_destroy(&pdc_time_mutex_g);
-    hg_thread_mutex_destroy(&pdc_metadata_hash_table_mutex_g);
     hg_thread_mutex_destroy(&pdc_container_hash_table_mutex_g);
     hg_thread_mutex_destroy(&pdc_client_addr_mutex_g);
     hg_thread_mutex_destroy(&pdc_bloom_time_mutex_g);
@@ -1060,7 +1147,6 @@ PDC_Server_finalize()
     hg_thread_mutex_destroy(&meta_buf_map_mutex_g);
     hg_thread_mutex_destroy(&data_obj_map_mutex_g);
     hg_thread_mutex_destroy(&meta_obj_map_mutex_g);
-    hg_thread_mutex_destroy(&insert_hash_table_mutex_g);
     hg_thread_mutex_destroy(&lock_list_mutex_g);
     hg_thread_mutex_destroy(&lock_request_mutex_g);
     hg_thread_mutex_destroy(&addr_valid_mutex_g);
@@ -1069,6 +1155,10 @@ PDC_Server_finalize()
     PDC_Server_clear_obj_region();
 
     PDC_server_transfer_request_finalize();
+    PDC_Server_query_cache_finalize();
+    PDC_Server_read_cache_finalize();
+    PDC_Server_chunk_finalize();
+    PDC_Server_segment_finalize();
 
     if (pdc_server_rank_g == 0)
         PDC_Server_rm_config_file();
@@ -1130,12 +1220,14 @@ PDC_Server_checkpoint()
     pdc_cont_hash_table_entry_t *cont_head;
     int n_entry, metadata_size = 0, region_count = 0, n_region, n_objs, n_write_region = 0, n_kvtag, key_len;
     uint32_t          hash_key;
+    int               i_shard;
     HashTablePair     pair;
     char              checkpoint_file[ADDR_MAX], checkpoint_file_local[ADDR_MAX], cmd[4096];
     HashTableIterator hash_table_iter;
     char *            checkpoint;
     char *            env_char;
     uint64_t          checkpoint_size;
+    long              n_entry_pos;
     bool              use_tmpfs = false;
     FILE *            file;
 
@@ -1194,87 +1286,106 @@ PDC_Server_checkpoint()
         fwrite(cont_head, sizeof(pdc_cont_hash_table_entry_t), 1, file);
     }
 
-    // DHT
-    n_entry = hash_table_num_entries(metadata_hash_table_g);
+    // DHT, entries of all shards are written as one table so the shard count may change on restart.
+    // Shards are locked one at a time, so the entries are counted as they are written and the count is
+    // patched in afterwards.
+    n_entry     = 0;
+    n_entry_pos = ftell(file);
     fwrite(&n_entry, sizeof(int), 1, file);
 
-    hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
+    for (i_shard = 0; i_shard < n_metadata_shard_g; i_shard++) {
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_rdlock(&metadata_shards_g[i_shard].lock);
+#endif
+        hash_table_iterate(metadata_shards_g[i_shard].table, &hash_table_iter);
 
-    while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
-        pair = hash_table_iter_next(&hash_table_iter);
-        head = pair.value;
+        while (hash_table_iter_has_more(&hash_table_iter)) {
+            pair = hash_table_iter_next(&hash_table_iter);
+            head = pair.value;
+            n_entry++;
 
-        fwrite(&head->n_obj, sizeof(int), 1, file);
-        hash_key = PDC_get_hash_by_name(head->metadata->obj_name);
-        fwrite(&hash_key, sizeof(uint32_t), 1, file);
+            fwrite(&head->n_obj, sizeof(int), 1, file);
+            hash_key = PDC_get_hash_by_name(head->metadata->obj_name);
+            fwrite(&hash_key, sizeof(uint32_t), 1, file);
 
-        // Iterate every metadata structure in current entry
-        DL_FOREACH(head->metadata, elt)
-        {
-            // Write entire metadata structure
-            fwrite(elt, sizeof(pdc_metadata_t), 1, file);
-
-            // Write kv tags
-            DL_COUNT(elt->kvtag_list_head, kvlist_elt, n_kvtag);
-            fwrite(&n_kvtag, sizeof(int), 1, file);
-            DL_FOREACH(elt->kvtag_list_head, kvlist_elt)
+            // Iterate every metadata structure in current entry
+            DL_FOREACH(head->metadata, elt)
             {
-                key_len = strlen(kvlist_elt->kvtag->name) + 1;
-                fwrite(&key_len, sizeof(int), 1, file);
-                fwrite(kvlist_elt->kvtag->name, key_len, 1, file);
-                fwrite(&kvlist_elt->kvtag->size, sizeof(uint32_t), 1, file);
-                fwrite(kvlist_elt->kvtag->value, kvlist_elt->kvtag->size, 1, file);
-            }
+                // Write entire metadata structure
+                fwrite(elt, sizeof(pdc_metadata_t), 1, file);
 
-            // Write region info
-            n_region = 0;
-            DL_COUNT(elt->storage_region_list_head, region_elt, n_region);
-            fwrite(&n_region, sizeof(int), 1, file);
-            if (n_region > 0) {
-                n_write_region = 0;
-                DL_FOREACH(elt->storage_region_list_head, region_elt)
+                // Write kv tags
+                DL_COUNT(elt->kvtag_list_head, kvlist_elt, n_kvtag);
+                fwrite(&n_kvtag, sizeof(int), 1, file);
+                DL_FOREACH(elt->kvtag_list_head, kvlist_elt)
                 {
-                    fwrite(region_elt, sizeof(region_list_t), 1, file);
-                    n_write_region++;
-                    int has_hist = 0;
-                    if (region_elt->region_hist != NULL)
-                        has_hist = 1;
-                    fwrite(&has_hist, sizeof(int), 1, file);
-                    if (has_hist == 1) {
-                        fwrite(&region_elt->region_hist->dtype, sizeof(int), 1, file);
-                        fwrite(&region_elt->region_hist->nbin, sizeof(int), 1, file);
-                        fwrite(region_elt->region_hist->range, sizeof(double),
-                               region_elt->region_hist->nbin * 2, file);
-                        fwrite(region_elt->region_hist->bin, sizeof(uint64_t), region_elt->region_hist->nbin,
-                               file);
-                        fwrite(&region_elt->region_hist->incr, sizeof(double), 1, file);
-                    }
+                    key_len = strlen(kvlist_elt->kvtag->name) + 1;
+                    fwrite(&key_len, sizeof(int), 1, file);
+                    fwrite(kvlist_elt->kvtag->name, key_len, 1, file);
+                    fwrite(&kvlist_elt->kvtag->size, sizeof(uint32_t), 1, file);
+                    fwrite(kvlist_elt->kvtag->value, kvlist_elt->kvtag->size, 1, file);
                 }
 
-                if (n_write_region != n_region)
-                    fprintf(stderr, "==PDC_SERVER[%d]: %s - ERROR with number of regions", pdc_server_rank_g,
-                            __func__);
-            }
-#if 0
-            // Write storage region info
-            data_server_region_t *region = NULL;
-            region                       = PDC_Server_get_obj_region(elt->obj_id);
-            if (region) {
-                DL_COUNT(region->region_storage_head, region_elt, n_region);
+                // Write region info
+                n_region = 0;
+                DL_COUNT(elt->storage_region_list_head, region_elt, n_region);
                 fwrite(&n_region, sizeof(int), 1, file);
-                DL_FOREACH(region->region_storage_head, region_elt)
-                {
-                    fwrite(region_elt, sizeof(region_list_t), 1, file);
+                if (n_region > 0) {
+                    n_write_region = 0;
+                    DL_FOREACH(elt->storage_region_list_head, region_elt)
+                    {
+                        fwrite(region_elt, sizeof(region_list_t), 1, file);
+                        n_write_region++;
+                        int has_hist = 0;
+                        if (region_elt->region_hist != NULL)
+                            has_hist = 1;
+                        fwrite(&has_hist, sizeof(int), 1, file);
+                        if (has_hist == 1) {
+                            fwrite(&region_elt->region_hist->dtype, sizeof(int), 1, file);
+                            fwrite(&region_elt->region_hist->nbin, sizeof(int), 1, file);
+                            fwrite(region_elt->region_hist->range, sizeof(double),
+                                   region_elt->region_hist->nbin * 2, file);
+                            fwrite(region_elt->region_hist->bin, sizeof(uint64_t),
+                                   region_elt->region_hist->nbin, file);
+                            fwrite(&region_elt->region_hist->incr, sizeof(double), 1, file);
+                        }
+                    }
+
+                    if (n_write_region != n_region)
+                        fprintf(stderr, "==PDC_SERVER[%d]: %s - ERROR with number of regions",
+                                pdc_server_rank_g, __func__);
+                }
+#if 0
+                // Write storage region info
+                data_server_region_t *region = NULL;
+                region                       = PDC_Server_get_obj_region(elt->obj_id);
+                if (region) {
+                    DL_COUNT(region->region_storage_head, region_elt, n_region);
+                    fwrite(&n_region, sizeof(int), 1, file);
+                    DL_FOREACH(region->region_storage_head, region_elt)
+                    {
+                        fwrite(region_elt, sizeof(region_list_t), 1, file);
+                    }
+                }
+                else {
+                    fwrite(&n_region, sizeof(int), 1, file);
                 }
-            }
-            else {
-                fwrite(&n_region, sizeof(int), 1, file);
-            }
 #endif
-            metadata_size++;
-            region_count += n_region;
-        } // End for metadata entry linked list
-    }     // End for hash table metadata entry
+                metadata_size++;
+                region_count += n_region;
+            } // End for metadata entry linked list
+        }     // End for hash table metadata entry
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_release_rdlock(&metadata_shards_g[i_shard].lock);
+#endif
+    } // End for metadata hash table shard
+
+    if (fseek(file, n_entry_pos, SEEK_SET) != 0 || fwrite(&n_entry, sizeof(int), 1, file) != 1 ||
+        fseek(file, 0, SEEK_END) != 0) {
+        // Keep going so that the other servers are not left waiting in the reductions below
+        printf("==PDC_SERVER[%d]: %s - Checkpoint file write error", pdc_server_rank_g, __func__);
+        ret_value = FAIL;
+    }
 
     // Note data server region are managed by data server instead of metadata server
     data_server_region_t *region = NULL;
@@ -1297,6 +1408,9 @@ PDC_Server_checkpoint()
 
     fclose(file);
 
+    // The segment index is saved next to the segment files, it is only needed by this server
+    PDC_Server_segment_checkpoint();
+
     if (use_tmpfs) {
 #ifdef PDC_TIMING
         gettimeofday(&pdc_timer_end_rank, 0);
@@ -1341,7 +1455,6 @@ PDC_Server_checkpoint()
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 } // End Checkpoint
 
@@ -1629,13 +1742,13 @@ PDC_Server_restart(char *filename)
         if (fread(&n_region, sizeof(int), 1, file) != 1) {
             printf("Read failed for n_region\n");
         }
-        DL_APPEND(dataserver_region_g, new_obj_reg);
+        PDC_Server_add_obj_region(new_obj_reg);
         for (j = 0; j < n_region; j++) {
             region_list_t *new_region_list = (region_list_t *)malloc(sizeof(region_list_t));
             if (fread(new_region_list, sizeof(region_list_t), 1, file) != 1) {
                 printf("Read failed for new_region_list\n");
             }
-            DL_APPEND(new_obj_reg->region_storage_head, new_region_list);
+            PDC_Server_add_storage_region(new_obj_reg, new_region_list);
         }
     }
 
@@ -1672,7 +1785,6 @@ done:
     pdc_server_timings->PDCserver_restart += MPI_Wtime() - start;
 #endif
 
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -1810,6 +1922,31 @@ PDC_print_IO_stats()
     double get_info_time_max, get_info_time_min, get_info_time_avg;
     double io_elapsed_time_max, io_elapsed_time_min, io_elapsed_time_avg;
 
+    pdc_read_cache_stats_t read_cache_stats;
+    uint64_t               read_cache_counts[4], read_cache_total[4];
+    pdc_chunk_stats_t      chunk_stats;
+    uint64_t               chunk_counts[4], chunk_total[4];
+    pdc_segment_stats_t    segment_stats;
+    uint64_t               segment_counts[4], segment_total[4];
+
+    PDC_Server_read_cache_get_stats(&read_cache_stats);
+    read_cache_counts[0] = read_cache_stats.nhit;
+    read_cache_counts[1] = read_cache_stats.nmiss;
+    read_cache_counts[2] = read_cache_stats.nreadahead_hit;
+    read_cache_counts[3] = read_cache_stats.nevict;
+
+    PDC_Server_chunk_get_stats(&chunk_stats);
+    chunk_counts[0] = chunk_stats.nchunk_write;
+    chunk_counts[1] = chunk_stats.nchunk_read;
+    chunk_counts[2] = chunk_stats.raw_bytes;
+    chunk_counts[3] = chunk_stats.stored_bytes;
+
+    PDC_Server_segment_get_stats(&segment_stats);
+    segment_counts[0] = segment_stats.nobj_write;
+    segment_counts[1] = segment_stats.nobj_read;
+    segment_counts[2] = segment_stats.ncompact;
+    segment_counts[3] = segment_stats.compact_bytes;
+
 #ifdef ENABLE_MPI
     MPI_Reduce(&server_write_time_g, &write_time_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     MPI_Reduce(&server_write_time_g, &write_time_min, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
@@ -1857,6 +1994,9 @@ PDC_print_IO_stats()
                MPI_COMM_WORLD);
     get_info_time_avg /= pdc_server_size_g;
 
+    MPI_Reduce(read_cache_counts, read_cache_total, 4, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(chunk_counts, chunk_total, 4, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(segment_counts, segment_total, 4, MPI_UINT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
 #else
     write_time_avg = write_time_max = write_time_min = server_write_time_g;
     read_time_avg = read_time_max = read_time_min = server_read_time_g;
@@ -1866,7 +2006,9 @@ PDC_print_IO_stats()
     update_time_avg = update_time_max = update_time_min = server_update_region_location_time_g;
     get_info_time_avg = get_info_time_max = get_info_time_min = server_get_storage_info_time_g;
     io_elapsed_time_avg = io_elapsed_time_max = io_elapsed_time_min = server_io_elapsed_time_g;
-
+    memcpy(read_cache_total, read_cache_counts, sizeof(read_cache_counts));
+    memcpy(chunk_total, chunk_counts, sizeof(chunk_counts));
+    memcpy(segment_total, segment_counts, sizeof(segment_counts));
 #endif
 
     if (pdc_server_rank_g == 0) {
@@ -1879,13 +2021,21 @@ PDC_print_IO_stats()
                "              Ttotal_IO_elapsed     (%6.2f, %6.2f, %6.2f)\n"
                "              Tregion_update        (%6.2f, %6.2f, %6.2f)\n"
                "              Tget_region           (%6.2f, %6.2f, %6.2f)\n"
-               "              #read_bb %4d, size %d MB\n",
+               "              #read_bb %4d, size %d MB\n"
+               "              read cache #hit %" PRIu64 ", #miss %" PRIu64 ", #readahead_hit %" PRIu64
+               ", #evict %" PRIu64 "\n"
+               "              chunks #write %" PRIu64 ", #read %" PRIu64 ", %.0f MB stored in %.0f MB\n"
+               "              segments #write %" PRIu64 ", #read %" PRIu64 ", #compact %" PRIu64
+               ", %.0f MB moved\n",
                n_fwrite_g, write_time_min, write_time_avg, write_time_max, fwrite_total_MB, n_fread_g,
                read_time_min, read_time_avg, read_time_max, fread_total_MB, n_fopen_g, open_time_min,
                open_time_avg, open_time_max, fsync_time_min, fsync_time_avg, fsync_time_max, total_io_min,
                total_io_avg, total_io_max, io_elapsed_time_min, io_elapsed_time_avg, io_elapsed_time_max,
                update_time_min, update_time_avg, update_time_max, get_info_time_min, get_info_time_avg,
-               get_info_time_max, n_read_from_bb_g, read_from_bb_size_g);
+               get_info_time_max, n_read_from_bb_g, read_from_bb_size_g, read_cache_total[0],
+               read_cache_total[1], read_cache_total[2], read_cache_total[3], chunk_total[0], chunk_total[1],
+               chunk_total[2] / 1048576.0, chunk_total[3] / 1048576.0, segment_total[0], segment_total[1],
+               segment_total[2], segment_total[3] / 1048576.0);
     }
 }
 #endif
@@ -1896,6 +2046,9 @@ PDC_Server_mercury_register()
     // Register RPC, metadata related
     PDC_client_test_connect_register(hg_class_g);
     PDC_gen_obj_id_register(hg_class_g);
+    PDC_gen_obj_id_batch_register(hg_class_g);
+    PDC_obj_put_data_register(hg_class_g);
+    PDC_obj_get_data_register(hg_class_g);
     PDC_close_server_register(hg_class_g);
     PDC_flush_obj_register(hg_class_g);
     PDC_flush_obj_all_register(hg_class_g);
@@ -1972,6 +2125,7 @@ PDC_Server_mercury_register()
     notify_client_multi_io_complete_rpc_register_id_g =
         PDC_notify_client_multi_io_complete_rpc_register(hg_class_g);
     server_checkpoint_rpc_register_id_g        = PDC_server_checkpoint_rpc_register(hg_class_g);
+    server_metrics_rpc_register_id_g           = PDC_server_metrics_rpc_register(hg_class_g);
     send_shm_register_id_g                     = PDC_send_shm_register(hg_class_g);
     send_client_storage_meta_rpc_register_id_g = PDC_send_client_storage_meta_rpc_register(hg_class_g);
     send_read_sel_obj_id_rpc_register_id_g     = PDC_send_read_sel_obj_id_rpc_register(hg_class_g);
@@ -2063,6 +2217,27 @@ PDC_Server_get_env()
     if (tmp_env_char != NULL)
         use_fastbit_idx_g = 1;
 
+    // Get the max number of query results sent to a client in one batch
+    tmp_env_char = getenv("PDC_QUERY_BATCH_NHITS");
+    if (tmp_env_char != NULL) {
+        pdc_query_batch_nhits_g = strtoull(tmp_env_char, NULL, 10);
+        if (pdc_query_batch_nhits_g == 0)
+            pdc_query_batch_nhits_g = PDC_QUERY_BATCH_NHITS_DEFAULT;
+    }
+
+    // Move transfer_request_all data in chunks through a bounded set of staging buffers
+    transfer_request_pipeline_chunk_size_g = 0;
+    tmp_env_char                           = getenv("PDC_TRANSFER_PIPELINE_CHUNK_SIZE");
+    if (tmp_env_char != NULL)
+        transfer_request_pipeline_chunk_size_g = strtoull(tmp_env_char, NULL, 10);
+    transfer_request_pipeline_depth_g = PDC_TRANSFER_PIPELINE_DEPTH_DEFAULT;
+    tmp_env_char                      = getenv("PDC_TRANSFER_PIPELINE_DEPTH");
+    if (tmp_env_char != NULL && atoi(tmp_env_char) > 0)
+        transfer_request_pipeline_depth_g = atoi(tmp_env_char);
+    if (pdc_server_rank_g == 0 && transfer_request_pipeline_chunk_size_g > 0)
+        printf("==PDC_SERVER[%d]: transfer pipeline with %d buffers of %" PRIu64 " bytes\n",
+               pdc_server_rank_g, transfer_request_pipeline_depth_g, transfer_request_pipeline_chunk_size_g);
+
     if (pdc_server_rank_g == 0) {
         printf("\n==PDC_SERVER[%d]: using [%s] as tmp dir, %d OSTs, %d OSTs per data file, %d%% to BB\n",
                pdc_server_rank_g, pdc_server_tmp_dir_g, lustre_total_ost_g, pdc_nost_per_file_g,
@@ -2092,6 +2267,10 @@ main(int argc, char *argv[])
     pdc_server_rank_g = 0;
     pdc_server_size_g = 1;
 #endif
+    PDC_log_init("PDC_SERVER", pdc_server_rank_g);
+
+    struct timeval startup_start, startup_end, lookup_start;
+    gettimeofday(&startup_start, 0);
 
 #ifdef PDC_TIMING
     struct timeval start_time;
@@ -2134,13 +2313,19 @@ main(int argc, char *argv[])
         if (pdc_server_rank_g == 0)
             printf("==PDC_SERVER[0]: will lookup other PDC servers on demand\n");
     }
-    else
+    else {
+        gettimeofday(&lookup_start, 0);
         PDC_Server_lookup_all_servers();
+        gettimeofday(&startup_end, 0);
+        startup_lookup_sec_g = PDC_get_elapsed_time_double(&lookup_start, &startup_end);
+    }
 
     // Write server addrs to the config file for client to read from
     if (pdc_server_rank_g == 0)
         if (PDC_Server_write_addr_to_file(all_addr_strings_g, pdc_server_size_g) != SUCCEED)
             printf("==PDC_SERVER[%d]: Error with write config file\n", pdc_server_rank_g);
+    gettimeofday(&startup_end, 0);
+    PDC_Server_report_startup_time(PDC_get_elapsed_time_double(&startup_start, &startup_end));
 #ifdef PDC_TIMING
 #ifdef ENABLE_MPI
     pdc_server_timings->PDCserver_start_total += MPI_Wtime() - start;
@@ -2178,6 +2363,7 @@ done:
     PDC_server_timing_report();
 #endif
     PDC_Server_finalize();
+    PDC_log_finalize();
 #ifdef ENABLE_MPI
     MPI_Finalize();
 #endif
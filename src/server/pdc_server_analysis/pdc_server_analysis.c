@@ -52,7 +52,6 @@
 #endif
 
 #include "pdc_utlist.h"
-#include "pdc_dablooms.h"
 #include "pdc_interface.h"
 #include "pdc_client_server_common.h"
 #include "pdc_server.h"
@@ -63,13 +62,6 @@
 #include <rdmacred.h>
 #endif
 
-#define BLOOM_TYPE_T counting_bloom_t
-#define BLOOM_NEW    new_counting_bloom
-#define BLOOM_CHECK  counting_bloom_check
-#define BLOOM_ADD    counting_bloom_add
-#define BLOOM_REMOVE counting_bloom_remove
-#define BLOOM_FREE   free_counting_bloom
-
 #ifdef ENABLE_MULTITHREAD
 hg_thread_mutex_t insert_iterator_mutex_g = HG_THREAD_MUTEX_INITIALIZER;
 #endif
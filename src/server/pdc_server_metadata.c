@@ -43,22 +43,17 @@
 
 #include "pdc_utlist.h"
 #include "pdc_hash-table.h"
-#include "pdc_dablooms.h"
+#include "pdc_bloom.h"
 #include "pdc_interface.h"
 #include "pdc_client_server_common.h"
 #include "pdc_server_metadata.h"
 #include "pdc_server.h"
+#include "pdc_server_segment.h"
 
-#define BLOOM_TYPE_T counting_bloom_t
-#define BLOOM_NEW    new_counting_bloom
-#define BLOOM_CHECK  counting_bloom_check
-#define BLOOM_ADD    counting_bloom_add
-#define BLOOM_REMOVE counting_bloom_remove
-#define BLOOM_FREE   free_counting_bloom
-
-// Global hash table for storing metadata
-HashTable *metadata_hash_table_g  = NULL;
-HashTable *container_hash_table_g = NULL;
+// Global hash tables for storing metadata, the metadata one is split into shards by name hash
+pdc_metadata_shard_t *metadata_shards_g      = NULL;
+int                   n_metadata_shard_g     = 1;
+HashTable *           container_hash_table_g = NULL;
 
 // Debug statistics var
 int      n_bloom_total_g            = 0;
@@ -161,7 +156,7 @@ PDC_Server_metadata_hash_value_free(void *value)
 
     // Free bloom filter
     if (head->bloom != NULL) {
-        BLOOM_FREE(head->bloom);
+        PDC_bloom_free((pdc_bloom_t *)head->bloom);
     }
 
     // Free metadata list
@@ -229,18 +224,16 @@ PDC_Server_metadata_init(pdc_metadata_t *a)
 // ^ hash table
 
 /*
- * Concatenate the metadata's obj_name and time_step to one char array
+ * Hash the name and timestep of an object for the bloom filter of its hash table bucket
  *
- * \param  metadata [IN]        PDC metadata structure pointer
- * \param  output   [OUT]       Concatenated char array pointer
+ * \param  metadata[IN]     Pointer to metadata
  *
- * \return void
+ * \return 64-bit fingerprint of the object
  */
-static inline void
-combine_obj_info_to_string(pdc_metadata_t *metadata, char *output)
+static uint64_t
+PDC_Server_metadata_fingerprint(pdc_metadata_t *metadata)
 {
-    FUNC_ENTER(NULL);
-    snprintf(output, TAG_LEN_MAX, "%s%d", metadata->obj_name, metadata->time_step);
+    return PDC_bloom_fingerprint(metadata->obj_name, metadata->time_step);
 }
 
 /*
@@ -280,35 +273,44 @@ pdc_metadata_t *
 find_metadata_by_id(uint64_t obj_id)
 {
     pdc_metadata_t *           ret_value = NULL;
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *head;
     pdc_metadata_t *           elt;
     HashTableIterator          hash_table_iter;
     HashTablePair              pair;
-    int                        n_entry;
+    int                        n_entry, i;
 
     FUNC_ENTER(NULL);
 
-    if (metadata_hash_table_g != NULL) {
-        // Since we only have the obj id, need to iterate the entire hash table
-        n_entry = hash_table_num_entries(metadata_hash_table_g);
-        hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
+    if (metadata_shards_g == NULL) {
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
+        goto done;
+    }
 
-        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
+    // Since we only have the obj id, need to iterate all shards of the hash table
+    for (i = 0; i < n_metadata_shard_g && ret_value == NULL; i++) {
+        shard = &metadata_shards_g[i];
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_rdlock(&shard->lock);
+#endif
+        n_entry = hash_table_num_entries(shard->table);
+        hash_table_iterate(shard->table, &hash_table_iter);
 
+        while (n_entry != 0 && ret_value == NULL && hash_table_iter_has_more(&hash_table_iter)) {
             pair = hash_table_iter_next(&hash_table_iter);
             head = pair.value;
             // Now iterate the list under this entry
             DL_FOREACH(head->metadata, elt)
             {
                 if (elt->obj_id == obj_id) {
-                    return elt;
+                    ret_value = elt;
+                    break;
                 }
             }
         }
-    } // if (metadata_hash_table_g != NULL)
-    else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
-        goto done;
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_release_rdlock(&shard->lock);
+#endif
     }
 
 done:
@@ -347,17 +349,17 @@ static pdc_metadata_t *
 find_identical_metadata(pdc_hash_table_entry_head *entry, pdc_metadata_t *a)
 {
     pdc_metadata_t *ret_value = NULL;
-    BLOOM_TYPE_T *  bloom;
+    pdc_bloom_t *   bloom;
     int             bloom_check;
-    char            combined_string[TAG_LEN_MAX];
+    uint64_t        fingerprint;
     pdc_metadata_t *elt;
 
     FUNC_ENTER(NULL);
 
     // Use bloom filter to quick check if current metadata is in the list
     if (entry->bloom != NULL && a->user_id != 0 && a->app_name[0] != 0) {
-        bloom = entry->bloom;
-        combine_obj_info_to_string(a, combined_string);
+        bloom       = (pdc_bloom_t *)entry->bloom;
+        fingerprint = PDC_Server_metadata_fingerprint(a);
 
 #ifdef ENABLE_TIMING
         struct timeval pdc_timer_start;
@@ -367,7 +369,7 @@ find_identical_metadata(pdc_hash_table_entry_head *entry, pdc_metadata_t *a)
         gettimeofday(&pdc_timer_start, 0);
 #endif
 
-        bloom_check = BLOOM_CHECK(bloom, combined_string, strlen(combined_string));
+        bloom_check = PDC_bloom_check(bloom, fingerprint);
 
 #ifdef ENABLE_TIMING
         gettimeofday(&pdc_timer_end, 0);
@@ -447,17 +449,45 @@ perr_t
 PDC_Server_init_hash_table()
 {
     perr_t ret_value = SUCCEED;
+    char * env;
+    int    i;
 
     FUNC_ENTER(NULL);
 
-    // Metadata hash table
-    metadata_hash_table_g = hash_table_new(PDC_Server_metadata_int_hash, PDC_Server_metadata_int_equal);
-    if (metadata_hash_table_g == NULL) {
-        printf("==PDC_SERVER: metadata_hash_table_g init error! Exit...\n");
+    if (is_hash_table_init_g == 1)
         goto done;
+
+    // Metadata hash table, threads working on objects in different shards do not contend
+#ifdef ENABLE_MULTITHREAD
+    n_metadata_shard_g = PDC_METADATA_SHARD_DEFAULT;
+#endif
+    env = getenv("PDC_SERVER_METADATA_SHARDS");
+    if (env != NULL && atoi(env) > 0)
+        n_metadata_shard_g = atoi(env);
+
+    metadata_shards_g = (pdc_metadata_shard_t *)calloc(n_metadata_shard_g, sizeof(pdc_metadata_shard_t));
+    if (metadata_shards_g == NULL) {
+        printf("==PDC_SERVER: metadata hash table shards init error! Exit...\n");
+        ret_value = FAIL;
+        goto done;
+    }
+    for (i = 0; i < n_metadata_shard_g; i++) {
+        metadata_shards_g[i].table =
+            hash_table_new(PDC_Server_metadata_int_hash, PDC_Server_metadata_int_equal);
+        if (metadata_shards_g[i].table == NULL) {
+            printf("==PDC_SERVER: metadata hash table init error! Exit...\n");
+            ret_value = FAIL;
+            goto done;
+        }
+        hash_table_register_free_functions(metadata_shards_g[i].table, PDC_Server_metadata_int_hash_key_free,
+                                           PDC_Server_metadata_hash_value_free);
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_init(&metadata_shards_g[i].lock);
+#endif
     }
-    hash_table_register_free_functions(metadata_hash_table_g, PDC_Server_metadata_int_hash_key_free,
-                                       PDC_Server_metadata_hash_value_free);
+    if (pdc_server_rank_g == 0 && n_metadata_shard_g > 1)
+        printf("==PDC_SERVER[%d]: metadata hash table has %d shards\n", pdc_server_rank_g,
+               n_metadata_shard_g);
 
     // Container hash table
     container_hash_table_g = hash_table_new(PDC_Server_metadata_int_hash, PDC_Server_metadata_int_equal);
@@ -474,16 +504,59 @@ done:
     FUNC_LEAVE(ret_value);
 }
 
+perr_t
+PDC_Server_free_hash_table()
+{
+    perr_t ret_value = SUCCEED;
+    int    i;
+
+    FUNC_ENTER(NULL);
+
+    if (metadata_shards_g == NULL)
+        goto done;
+
+    for (i = 0; i < n_metadata_shard_g; i++) {
+        if (metadata_shards_g[i].table != NULL)
+            hash_table_free(metadata_shards_g[i].table);
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_destroy(&metadata_shards_g[i].lock);
+#endif
+    }
+    free(metadata_shards_g);
+    metadata_shards_g = NULL;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+pdc_metadata_shard_t *
+PDC_Server_metadata_shard(uint32_t hash_value)
+{
+    // Servers are picked by the low bits of the hash, so use the high bits to spread over shards
+    return &metadata_shards_g[(hash_value >> 16) % n_metadata_shard_g];
+}
+
+int
+PDC_Server_metadata_num_entries()
+{
+    int n_entry = 0;
+    int i;
+
+    for (i = 0; i < n_metadata_shard_g; i++)
+        n_entry += hash_table_num_entries(metadata_shards_g[i].table);
+
+    return n_entry;
+}
+
 /*
  * Remove a metadata from bloom filter
  *
- * \param  metadata[IN]     Metadata pointer of the remove target
  * \param  bloom[IN]        Bloom filter's pointer
  *
  * \return Non-negative on success/Negative on failure
  */
 static perr_t
-PDC_Server_remove_from_bloom(pdc_metadata_t *metadata, BLOOM_TYPE_T *bloom)
+PDC_Server_remove_from_bloom(pdc_bloom_t *bloom)
 {
     perr_t ret_value = SUCCEED;
 
@@ -495,14 +568,8 @@ PDC_Server_remove_from_bloom(pdc_metadata_t *metadata, BLOOM_TYPE_T *bloom)
         goto done;
     }
 
-    char combined_string[TAG_LEN_MAX];
-    combine_obj_info_to_string(metadata, combined_string);
-
-    ret_value = BLOOM_REMOVE(bloom, combined_string, strlen(combined_string));
-    if (ret_value != SUCCEED) {
-        printf("==PDC_SERVER[%d]: PDC_Server_remove_from_bloom() - error\n", pdc_server_rank_g);
-        goto done;
-    }
+    // Bits can not be cleared, the filter is rebuilt at the next insert if too many were removed
+    PDC_bloom_remove(bloom);
 
 done:
     FUNC_LEAVE(ret_value);
@@ -517,10 +584,9 @@ done:
  * \return Non-negative on success/Negative on failure
  */
 static perr_t
-PDC_Server_add_to_bloom(pdc_metadata_t *metadata, BLOOM_TYPE_T *bloom)
+PDC_Server_add_to_bloom(pdc_metadata_t *metadata, pdc_bloom_t *bloom)
 {
     perr_t ret_value = SUCCEED;
-    char   combined_string[TAG_LEN_MAX];
 
     FUNC_ENTER(NULL);
 
@@ -528,20 +594,14 @@ PDC_Server_add_to_bloom(pdc_metadata_t *metadata, BLOOM_TYPE_T *bloom)
         goto done;
     }
 
-    combine_obj_info_to_string(metadata, combined_string);
-
-    ret_value = BLOOM_ADD(bloom, combined_string, strlen(combined_string));
-    if (ret_value != SUCCEED) {
-        printf("==PDC_SERVER[%d]: PDC_Server_add_to_bloom() - error \n", pdc_server_rank_g);
-        goto done;
-    }
+    PDC_bloom_add(bloom, PDC_Server_metadata_fingerprint(metadata));
 
 done:
     FUNC_LEAVE(ret_value);
 }
 
 /*
- * Init a bloom filter
+ * Build the bloom filter of a hash table entry from its metadata list, sized to the list length
  *
  * \param  entry[IN]     Entry of the metadata hash table
  *
@@ -550,16 +610,11 @@ done:
 static perr_t
 PDC_Server_bloom_init(pdc_hash_table_entry_head *entry)
 {
-    perr_t ret_value  = 0;
-    int    capacity   = 500000;
-    double error_rate = 0.05;
+    perr_t          ret_value = 0;
+    pdc_metadata_t *elt;
 
     FUNC_ENTER(NULL);
 
-    // Init bloom filter
-    n_bloom_maybe_g = 0;
-    n_bloom_total_g = 0;
-
 #ifdef ENABLE_TIMING
     // Timing
     struct timeval pdc_timer_start;
@@ -569,13 +624,22 @@ PDC_Server_bloom_init(pdc_hash_table_entry_head *entry)
     gettimeofday(&pdc_timer_start, 0);
 #endif
 
-    entry->bloom = (BLOOM_TYPE_T *)BLOOM_NEW(capacity, error_rate);
+    if (entry->bloom != NULL)
+        PDC_bloom_free((pdc_bloom_t *)entry->bloom);
+
+    // Leave room for the list to double before the next rebuild
+    entry->bloom = PDC_bloom_new(2 * ((uint64_t)entry->n_obj + 1));
     if (!entry->bloom) {
         fprintf(stderr, "ERROR: Could not create bloom filter\n");
         ret_value = -1;
         goto done;
     }
 
+    DL_FOREACH(entry->metadata, elt)
+    {
+        PDC_Server_add_to_bloom(elt, (pdc_bloom_t *)entry->bloom);
+    }
+
 #ifdef ENABLE_TIMING
     // Timing
     gettimeofday(&pdc_timer_end, 0);
@@ -591,27 +655,17 @@ done:
 perr_t
 PDC_Server_hash_table_list_insert(pdc_hash_table_entry_head *head, pdc_metadata_t *new)
 {
-    perr_t          ret_value = SUCCEED;
-    pdc_metadata_t *elt;
+    perr_t ret_value = SUCCEED;
 
     FUNC_ENTER(NULL);
 
-    // add to bloom filter
-    if (head->n_obj == CREATE_BLOOM_THRESHOLD) {
+    // Create the bloom filter once the list is long, rebuild it when full or after many removals
+    if (head->n_obj >= CREATE_BLOOM_THRESHOLD &&
+        (head->bloom == NULL || PDC_bloom_need_rebuild((pdc_bloom_t *)head->bloom)))
         PDC_Server_bloom_init(head);
-        DL_FOREACH(head->metadata, elt)
-        {
-            PDC_Server_add_to_bloom(elt, head->bloom);
-        }
-        ret_value = PDC_Server_add_to_bloom(new, head->bloom);
-        if (ret_value != SUCCEED) {
-            printf("==PDC_SERVER[%d]: PDC_Server_hash_table_list_insert() - error add to bloom\n",
-                   pdc_server_rank_g);
-            goto done;
-        }
-    }
-    else if (head->n_obj >= CREATE_BLOOM_THRESHOLD || head->bloom != NULL) {
-        ret_value = PDC_Server_add_to_bloom(new, head->bloom);
+
+    if (head->bloom != NULL) {
+        ret_value = PDC_Server_add_to_bloom(new, (pdc_bloom_t *)head->bloom);
         if (ret_value != SUCCEED) {
             printf("==PDC_SERVER[%d]: PDC_Server_hash_table_list_insert() - error add to bloom\n",
                    pdc_server_rank_g);
@@ -619,17 +673,10 @@ PDC_Server_hash_table_list_insert(pdc_hash_table_entry_head *head, pdc_metadata_
         }
     }
 
-#ifdef ENABLE_MULTITHREAD
-    hg_thread_mutex_lock(&insert_hash_table_mutex_g);
-#endif
-    // Currently $metadata is unique, insert to linked list
+    // Currently $metadata is unique, insert to linked list, the caller holds the write lock of the shard
     DL_APPEND(head->metadata, new);
     head->n_obj++;
 
-#ifdef ENABLE_MULTITHREAD
-    hg_thread_mutex_unlock(&insert_hash_table_mutex_g);
-#endif
-
 done:
 
     FUNC_LEAVE(ret_value);
@@ -653,8 +700,8 @@ PDC_Server_hash_table_list_init(pdc_hash_table_entry_head *entry, uint32_t *hash
     gettimeofday(&pdc_timer_start, 0);
 #endif
 
-    // Insert to hash table
-    ret = hash_table_insert(metadata_hash_table_g, hash_key, entry);
+    // Insert to the shard of the hash key
+    ret = hash_table_insert(PDC_Server_metadata_shard(*hash_key)->table, hash_key, entry);
     if (ret != 1) {
         fprintf(stderr, "PDC_Server_hash_table_list_init(): Error with hash table insert!\n");
         ret_value = FAIL;
@@ -677,10 +724,11 @@ perr_t
 PDC_Server_add_tag_metadata(metadata_add_tag_in_t *in, metadata_add_tag_out_t *out)
 {
 
-    perr_t    ret_value = SUCCEED;
-    uint32_t *hash_key  = NULL;
+    perr_t                ret_value = SUCCEED;
+    uint32_t *            hash_key  = NULL;
+    pdc_metadata_shard_t *shard     = NULL;
 #ifdef ENABLE_MULTITHREAD
-    int unlocked = 0;
+    int unlocked = 1;
 #endif
 
     FUNC_ENTER(NULL);
@@ -705,15 +753,16 @@ PDC_Server_add_tag_metadata(metadata_add_tag_in_t *in, metadata_add_tag_out_t *o
 
     pdc_hash_table_entry_head *lookup_value;
 
+    shard = PDC_Server_metadata_shard(*hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
+    // Obtain write lock for the shard
     unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
-    if (metadata_hash_table_g != NULL) {
+    if (shard->table != NULL) {
         // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, hash_key);
+        lookup_value = hash_table_lookup(shard->table, hash_key);
 
         // Is this hash value exist in the Hash table?
         if (lookup_value != NULL) {
@@ -747,9 +796,9 @@ PDC_Server_add_tag_metadata(metadata_add_tag_in_t *in, metadata_add_tag_out_t *o
             out->ret = -1;
         }
 
-    } // if (metadata_hash_table_g != NULL)
+    } // if (shard->table != NULL)
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initilized!\n");
+        printf("==PDC_SERVER: metadata hash table not initilized!\n");
         ret_value = FAIL;
         out->ret  = -1;
         goto done;
@@ -761,8 +810,8 @@ PDC_Server_add_tag_metadata(metadata_add_tag_in_t *in, metadata_add_tag_out_t *o
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -787,9 +836,8 @@ PDC_Server_add_tag_metadata(metadata_add_tag_in_t *in, metadata_add_tag_out_t *o
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
 #endif
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -802,6 +850,10 @@ PDC_Server_update_metadata(metadata_update_in_t *in, metadata_update_out_t *out)
     pdc_hash_table_entry_head *lookup_value;
     uint32_t *                 hash_key = NULL;
     pdc_metadata_t *           target;
+    pdc_metadata_shard_t *     shard = NULL;
+#ifdef ENABLE_MULTITHREAD
+    int unlocked = 1;
+#endif
 
     FUNC_ENTER(NULL);
 
@@ -823,15 +875,16 @@ PDC_Server_update_metadata(metadata_update_in_t *in, metadata_update_out_t *out)
     *hash_key = in->hash_value;
     obj_id    = in->obj_id;
 
+    shard = PDC_Server_metadata_shard(*hash_key);
 #ifdef ENABLE_MULTITHREAD
-    int unlocked = 0;
-    // Obtain lock for hash table
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    // Obtain write lock for the shard
+    unlocked = 0;
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
-    if (metadata_hash_table_g != NULL) {
+    if (shard->table != NULL) {
         // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, hash_key);
+        lookup_value = hash_table_lookup(shard->table, hash_key);
 
         // Is this hash value exist in the Hash table?
         if (lookup_value != NULL) {
@@ -880,17 +933,17 @@ PDC_Server_update_metadata(metadata_update_in_t *in, metadata_update_out_t *out)
             out->ret  = -1;
         }
 
-    } // if (metadata_hash_table_g != NULL)
+    } // if (shard->table != NULL)
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
         ret_value = -1;
         out->ret  = -1;
         goto done;
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -915,26 +968,33 @@ PDC_Server_update_metadata(metadata_update_in_t *in, metadata_update_out_t *out)
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
 #endif
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
 perr_t
 PDC_Server_delete_metadata_by_id(metadata_delete_by_id_in_t *in, metadata_delete_by_id_out_t *out)
 {
-    perr_t            ret_value = FAIL;
-    pdc_metadata_t *  elt;
-    HashTableIterator hash_table_iter;
-    HashTablePair     pair;
-    uint64_t          target_obj_id;
-    int               n_entry;
+    perr_t                ret_value = FAIL;
+    pdc_metadata_t *      elt;
+    pdc_metadata_shard_t *shard;
+    HashTableIterator     hash_table_iter;
+    HashTablePair         pair;
+    uint64_t              target_obj_id;
+    int                   n_entry, i;
 
     FUNC_ENTER(NULL);
 
     out->ret = -1;
 
+    // The metadata server already deleted the object, drop the data this server stores for it
+    if (in->storage_only) {
+        ret_value = PDC_Server_segment_delete(in->obj_id);
+        out->ret  = ret_value == SUCCEED ? 1 : -1;
+        FUNC_LEAVE(ret_value);
+    }
+
 #ifdef ENABLE_TIMING
     // Timing
     struct timeval pdc_timer_start;
@@ -947,11 +1007,8 @@ PDC_Server_delete_metadata_by_id(metadata_delete_by_id_in_t *in, metadata_delete
     target_obj_id = in->obj_id;
 
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
-    int unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_mutex_lock(&pdc_container_hash_table_mutex_g);
 #endif
-
     if (container_hash_table_g != NULL) {
         pdc_cont_hash_table_entry_t *cont_entry;
 
@@ -969,33 +1026,43 @@ PDC_Server_delete_metadata_by_id(metadata_delete_by_id_in_t *in, metadata_delete
                 hash_table_remove(container_hash_table_g, &pair.key);
                 out->ret  = 1;
                 ret_value = SUCCEED;
-                goto done;
+                break;
             }
         }
     }
-    if (out->ret == -1 && metadata_hash_table_g != NULL) {
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_unlock(&pdc_container_hash_table_mutex_g);
+#endif
+    if (out->ret == 1)
+        goto done;
 
-        // Since we only have the obj id, need to iterate the entire hash table
+    if (metadata_shards_g != NULL) {
         pdc_hash_table_entry_head *head;
 
-        n_entry = hash_table_num_entries(metadata_hash_table_g);
-        hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
-
-        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
+        // Since we only have the obj id, need to iterate all shards of the hash table
+        for (i = 0; i < n_metadata_shard_g && out->ret == -1; i++) {
+            shard = &metadata_shards_g[i];
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_wrlock(&shard->lock);
+#endif
+            n_entry = hash_table_num_entries(shard->table);
+            hash_table_iterate(shard->table, &hash_table_iter);
 
-            pair = hash_table_iter_next(&hash_table_iter);
-            head = pair.value;
-            // Now iterate the list under this entry
-            DL_FOREACH(head->metadata, elt)
-            {
+            while (n_entry != 0 && out->ret == -1 && hash_table_iter_has_more(&hash_table_iter)) {
+                pair = hash_table_iter_next(&hash_table_iter);
+                head = pair.value;
+                // Now iterate the list under this entry
+                DL_FOREACH(head->metadata, elt)
+                {
+                    if (elt->obj_id != target_obj_id)
+                        continue;
 
-                if (elt->obj_id == target_obj_id) {
                     // We found the delete target
                     // Check if there are more objects in this list
                     if (head->n_obj > 1) {
                         // Remove from bloom filter
                         if (head->bloom != NULL) {
-                            PDC_Server_remove_from_bloom(elt, head->bloom);
+                            PDC_Server_remove_from_bloom((pdc_bloom_t *)head->bloom);
                         }
 
                         // Remove from linked list
@@ -1005,28 +1072,26 @@ PDC_Server_delete_metadata_by_id(metadata_delete_by_id_in_t *in, metadata_delete
                     else {
                         // This is the last item under the current entry, remove the hash entry
                         uint32_t hash_key = PDC_get_hash_by_name(elt->obj_name);
-                        hash_table_remove(metadata_hash_table_g, &hash_key);
+                        hash_table_remove(shard->table, &hash_key);
                     }
                     out->ret  = 1;
                     ret_value = SUCCEED;
-                }
-            } // DL_FOREACH
-        }     // while
-    }         // if (metadata_hash_table_g != NULL)
+                    break;
+                } // DL_FOREACH
+            }     // while
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_release_wrlock(&shard->lock);
+#endif
+        } // for each shard
+    }
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
         ret_value = FAIL;
         out->ret  = -1;
         goto done;
     }
 
 done:
-#ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
-    unlocked = 1;
-#endif
-
 #ifdef ENABLE_TIMING
     // Timing
     gettimeofday(&pdc_timer_end, 0);
@@ -1045,6 +1110,10 @@ done:
     hg_thread_mutex_unlock(&pdc_time_mutex_g);
 #endif
 
+    // Drop the data this server stores, the client sends the delete to the other servers
+    if (ret_value == SUCCEED)
+        PDC_Server_segment_delete(target_obj_id);
+
     // Decrement total metadata count
 #ifdef ENABLE_MULTITHREAD
     hg_thread_mutex_lock(&n_metadata_mutex_g);
@@ -1054,20 +1123,19 @@ done:
     hg_thread_mutex_unlock(&n_metadata_mutex_g);
 #endif
 
-#ifdef ENABLE_MULTITHREAD
-    if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
-#endif
-
     FUNC_LEAVE(ret_value);
 }
 
 perr_t
 PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_out_t *out)
 {
-    perr_t          ret_value = SUCCEED;
-    uint32_t *      hash_key  = NULL;
-    pdc_metadata_t *target;
+    perr_t                ret_value = SUCCEED;
+    uint32_t *            hash_key  = NULL;
+    pdc_metadata_t *      target;
+    pdc_metadata_shard_t *shard = NULL;
+#ifdef ENABLE_MULTITHREAD
+    int unlocked = 1;
+#endif
 
     FUNC_ENTER(NULL);
 
@@ -1096,15 +1164,16 @@ PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_ou
     metadata.user_id     = -1;
     metadata.obj_id      = 0;
 
+    shard = PDC_Server_metadata_shard(*hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
-    int unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    // Obtain write lock for the shard
+    unlocked = 0;
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
-    if (metadata_hash_table_g != NULL) {
+    if (shard->table != NULL) {
         // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, hash_key);
+        lookup_value = hash_table_lookup(shard->table, hash_key);
 
         // Is this hash value exist in the Hash table?
         if (lookup_value != NULL) {
@@ -1114,7 +1183,7 @@ PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_ou
                 if (lookup_value->n_obj > 1) {
                     // Remove from bloom filter
                     if (lookup_value->bloom != NULL) {
-                        PDC_Server_remove_from_bloom(target, lookup_value->bloom);
+                        PDC_Server_remove_from_bloom((pdc_bloom_t *)lookup_value->bloom);
                     }
 
                     // Remove from linked list
@@ -1123,7 +1192,7 @@ PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_ou
                 }
                 else {
                     // Remove from hash
-                    hash_table_remove(metadata_hash_table_g, hash_key);
+                    hash_table_remove(shard->table, hash_key);
                 }
                 out->ret = 1;
 
@@ -1142,17 +1211,17 @@ PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_ou
             out->ret  = -1;
         }
 
-    } // if (metadata_hash_table_g != NULL)
+    } // if (shard->table != NULL)
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
         ret_value = -1;
         out->ret  = -1;
         goto done;
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -1185,22 +1254,55 @@ PDC_delete_metadata_from_hash_table(metadata_delete_in_t *in, metadata_delete_ou
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
 #endif
 
     FUNC_LEAVE(ret_value);
 }
 
+/*
+ * Fill a new metadata from the object creation input
+ *
+ * \param  in[IN]           Input structure received from client
+ * \param  obj_name[IN]     Name of the object
+ * \param  metadata[OUT]    Metadata to fill
+ */
+static void
+PDC_Server_metadata_from_input(gen_obj_id_in_t *in, const char *obj_name, pdc_metadata_t *metadata)
+{
+    int i;
+
+    PDC_metadata_init(metadata);
+    metadata->cont_id          = in->data.cont_id;
+    metadata->data_type        = in->data_type;
+    metadata->user_id          = in->data.user_id;
+    metadata->data_server_id   = in->data.data_server_id;
+    metadata->region_partition = in->data.region_partition;
+    metadata->consistency      = in->data.consistency;
+    metadata->time_step        = in->data.time_step;
+    metadata->ndim             = in->data.ndim;
+    metadata->dims[0]          = in->data.dims0;
+    metadata->dims[1]          = in->data.dims1;
+    metadata->dims[2]          = in->data.dims2;
+    metadata->dims[3]          = in->data.dims3;
+    for (i = metadata->ndim; i < DIM_MAX; i++)
+        metadata->dims[i] = 0;
+
+    strcpy(metadata->obj_name, obj_name);
+    strcpy(metadata->app_name, in->data.app_name);
+    strcpy(metadata->tags, in->data.tags);
+    strcpy(metadata->data_location, in->data.data_location);
+}
+
 perr_t
 PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
 {
-    perr_t          ret_value = SUCCEED;
-    pdc_metadata_t *metadata;
-    uint32_t *      hash_key, i;
+    perr_t                ret_value = SUCCEED;
+    pdc_metadata_t *      metadata;
+    uint32_t *            hash_key;
+    pdc_metadata_shard_t *shard = NULL;
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
-    int unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    int unlocked = 1;
 #endif
     // DEBUG
     int debug_flag = 0;
@@ -1230,26 +1332,7 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
     hg_thread_mutex_unlock(&total_mem_usage_mutex_g);
 #endif
 
-    PDC_metadata_init(metadata);
-    metadata->cont_id          = in->data.cont_id;
-    metadata->data_type        = in->data_type;
-    metadata->user_id          = in->data.user_id;
-    metadata->data_server_id   = in->data.data_server_id;
-    metadata->region_partition = in->data.region_partition;
-    metadata->consistency      = in->data.consistency;
-    metadata->time_step        = in->data.time_step;
-    metadata->ndim             = in->data.ndim;
-    metadata->dims[0]          = in->data.dims0;
-    metadata->dims[1]          = in->data.dims1;
-    metadata->dims[2]          = in->data.dims2;
-    metadata->dims[3]          = in->data.dims3;
-    for (i = metadata->ndim; i < DIM_MAX; i++)
-        metadata->dims[i] = 0;
-
-    strcpy(metadata->obj_name, in->data.obj_name);
-    strcpy(metadata->app_name, in->data.app_name);
-    strcpy(metadata->tags, in->data.tags);
-    strcpy(metadata->data_location, in->data.data_location);
+    PDC_Server_metadata_from_input(in, in->data.obj_name, metadata);
 
     hash_key = (uint32_t *)malloc(sizeof(uint32_t));
     if (hash_key == NULL) {
@@ -1262,18 +1345,19 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
     pdc_hash_table_entry_head *lookup_value;
     pdc_metadata_t *           found_identical;
 
+    shard = PDC_Server_metadata_shard(*hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
+    // Obtain write lock for the shard
     unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
     if (debug_flag == 1)
         printf("checking hash table with key=%d\n", *hash_key);
 
-    if (metadata_hash_table_g != NULL) {
+    if (shard->table != NULL) {
         // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, hash_key);
+        lookup_value = hash_table_lookup(shard->table, hash_key);
 
         // Is this hash value exist in the Hash table?
         if (lookup_value != NULL) {
@@ -1311,7 +1395,7 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
         }
     }
     else {
-        printf("metadata_hash_table_g not initialized!\n");
+        printf("metadata hash table not initialized!\n");
         goto done;
     }
 
@@ -1319,8 +1403,8 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
     metadata->obj_id = PDC_Server_gen_obj_id();
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -1356,9 +1440,134 @@ PDC_insert_metadata_to_hash_table(gen_obj_id_in_t *in, gen_obj_id_out_t *out)
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
+#endif
+
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_insert_metadata_batch_to_hash_table(gen_obj_id_in_t *in, int32_t n_objs, char **obj_names,
+                                        uint32_t *hash_values, uint64_t *obj_ids, int32_t *n_created)
+{
+    perr_t                     ret_value = SUCCEED;
+    pdc_metadata_t *           metadata;
+    pdc_metadata_shard_t *     shard;
+    pdc_hash_table_entry_head *lookup_value, *entry;
+    uint32_t *                 hash_key;
+    uint64_t                   mem_usage = 0;
+    int32_t                    i;
+
+    FUNC_ENTER(NULL);
+
+#ifdef ENABLE_TIMING
+    // Timing
+    struct timeval pdc_timer_start;
+    struct timeval pdc_timer_end;
+    double         ht_total_sec;
+
+    gettimeofday(&pdc_timer_start, 0);
+#endif
+
+    *n_created = 0;
+    if (metadata_shards_g == NULL) {
+        printf("metadata hash table not initialized!\n");
+        ret_value = FAIL;
+        goto done;
+    }
+
+    for (i = 0; i < n_objs; i++) {
+        obj_ids[i] = 0;
+
+        metadata = (pdc_metadata_t *)malloc(sizeof(pdc_metadata_t));
+        if (metadata == NULL) {
+            printf("Cannot allocate pdc_metadata_t!\n");
+            ret_value = FAIL;
+            break;
+        }
+        PDC_Server_metadata_from_input(in, obj_names[i], metadata);
+
+        // Objects of a batch are spread over shards, lock the shard of each object in turn
+        shard = PDC_Server_metadata_shard(hash_values[i]);
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_wrlock(&shard->lock);
+#endif
+        lookup_value = hash_table_lookup(shard->table, &hash_values[i]);
+        if (lookup_value != NULL) {
+            if (find_identical_metadata(lookup_value, metadata) != NULL) {
+#ifdef ENABLE_MULTITHREAD
+                hg_thread_rwlock_release_wrlock(&shard->lock);
+#endif
+                printf("==PDC_SERVER[%d]: Found identical metadata with name %s!\n", pdc_server_rank_g,
+                       metadata->obj_name);
+                free(metadata);
+                continue;
+            }
+            PDC_Server_hash_table_list_insert(lookup_value, metadata);
+        }
+        else {
+            // First entry for current hash value, init linked list, and insert to hash table
+            entry    = (pdc_hash_table_entry_head *)calloc(1, sizeof(pdc_hash_table_entry_head));
+            hash_key = (uint32_t *)malloc(sizeof(uint32_t));
+            if (entry == NULL || hash_key == NULL) {
+#ifdef ENABLE_MULTITHREAD
+                hg_thread_rwlock_release_wrlock(&shard->lock);
+#endif
+                printf("Cannot allocate hash table entry!\n");
+                free(entry);
+                free(hash_key);
+                free(metadata);
+                ret_value = FAIL;
+                break;
+            }
+            *hash_key = hash_values[i];
+            mem_usage += sizeof(pdc_hash_table_entry_head) + sizeof(uint32_t);
+
+            PDC_Server_hash_table_list_init(entry, hash_key);
+            PDC_Server_hash_table_list_insert(entry, metadata);
+        }
+        mem_usage += sizeof(pdc_metadata_t);
+
+        metadata->obj_id = PDC_Server_gen_obj_id();
+        obj_ids[i]       = metadata->obj_id;
+        (*n_created)++;
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_rwlock_release_wrlock(&shard->lock);
+#endif
+    }
+
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_lock(&n_metadata_mutex_g);
+#endif
+    n_metadata_g += *n_created;
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_unlock(&n_metadata_mutex_g);
+    hg_thread_mutex_lock(&total_mem_usage_mutex_g);
+#endif
+    total_mem_usage_g += mem_usage;
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_unlock(&total_mem_usage_mutex_g);
+#endif
+
+#ifdef ENABLE_TIMING
+    // Timing
+    gettimeofday(&pdc_timer_end, 0);
+    ht_total_sec = PDC_get_elapsed_time_double(&pdc_timer_start, &pdc_timer_end);
 #endif
 
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_lock(&pdc_time_mutex_g);
+#endif
+
+#ifdef ENABLE_TIMING
+    server_insert_time_g += ht_total_sec;
+#endif
+
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_mutex_unlock(&pdc_time_mutex_g);
+#endif
+
+done:
     FUNC_LEAVE(ret_value);
 }
 
@@ -1370,16 +1579,19 @@ PDC_Server_print_all_metadata()
     pdc_metadata_t *           elt;
     pdc_hash_table_entry_head *head;
     HashTablePair              pair;
+    int                        i;
 
     FUNC_ENTER(NULL);
 
-    hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
-    while (hash_table_iter_has_more(&hash_table_iter)) {
-        pair = hash_table_iter_next(&hash_table_iter);
-        head = pair.value;
-        DL_FOREACH(head->metadata, elt)
-        {
-            PDC_print_metadata(elt);
+    for (i = 0; i < n_metadata_shard_g; i++) {
+        hash_table_iterate(metadata_shards_g[i].table, &hash_table_iter);
+        while (hash_table_iter_has_more(&hash_table_iter)) {
+            pair = hash_table_iter_next(&hash_table_iter);
+            head = pair.value;
+            DL_FOREACH(head->metadata, elt)
+            {
+                PDC_print_metadata(elt);
+            }
         }
     }
     FUNC_LEAVE(ret_value);
@@ -1418,7 +1630,7 @@ PDC_Server_metadata_duplicate_check()
     perr_t                     ret_value = SUCCEED;
     HashTableIterator          hash_table_iter;
     HashTablePair              pair;
-    int                        n_entry, count = 0;
+    int                        n_entry, count = 0, i;
     int                        all_maybe, all_total, all_entry;
     int                        has_dup_obj = 0;
     int                        all_dup_obj = 0;
@@ -1427,7 +1639,7 @@ PDC_Server_metadata_duplicate_check()
 
     FUNC_ENTER(NULL);
 
-    n_entry = hash_table_num_entries(metadata_hash_table_g);
+    n_entry = PDC_Server_metadata_num_entries();
 
 #ifdef ENABLE_MPI
     MPI_Reduce(&n_bloom_maybe_g, &all_maybe, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
@@ -1446,25 +1658,27 @@ PDC_Server_metadata_duplicate_check()
 
     fflush(stdout);
 
-    hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
+    for (i = 0; i < n_metadata_shard_g; i++) {
+        hash_table_iterate(metadata_shards_g[i].table, &hash_table_iter);
 
-    while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
-        pair = hash_table_iter_next(&hash_table_iter);
-        head = pair.value;
-        DL_SORT(head->metadata, PDC_metadata_cmp);
-        // With sorted list, just compare each one with its next
-        DL_FOREACH(head->metadata, elt)
-        {
-            elt_next = elt->next;
-            if (elt_next != NULL) {
-                if (PDC_metadata_cmp(elt, elt_next) == 0) {
-                    has_dup_obj = 1;
-                    ret_value   = FAIL;
-                    goto done;
+        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
+            pair = hash_table_iter_next(&hash_table_iter);
+            head = pair.value;
+            DL_SORT(head->metadata, PDC_metadata_cmp);
+            // With sorted list, just compare each one with its next
+            DL_FOREACH(head->metadata, elt)
+            {
+                elt_next = elt->next;
+                if (elt_next != NULL) {
+                    if (PDC_metadata_cmp(elt, elt_next) == 0) {
+                        has_dup_obj = 1;
+                        ret_value   = FAIL;
+                        goto done;
+                    }
                 }
             }
+            count++;
         }
-        count++;
     }
 
     fflush(stdout);
@@ -1540,10 +1754,11 @@ PDC_Server_get_partial_query_result(metadata_query_transfer_in_t *in, uint32_t *
     perr_t                     ret_value = FAIL;
     uint32_t                   i;
     uint32_t                   n_buf, iter = 0;
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *head;
     pdc_metadata_t *           elt;
     HashTableIterator          hash_table_iter;
-    int                        n_entry;
+    int                        n_entry, i_shard;
     HashTablePair              pair;
 
     FUNC_ENTER(NULL);
@@ -1555,30 +1770,38 @@ PDC_Server_get_partial_query_result(metadata_query_transfer_in_t *in, uint32_t *
         (*buf_ptrs)[i] = (void *)calloc(1, sizeof(void *));
     }
     // TODO: free buf_ptrs
-    if (metadata_hash_table_g != NULL) {
-
-        n_entry = hash_table_num_entries(metadata_hash_table_g);
-        hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
+    if (metadata_shards_g != NULL) {
+        for (i_shard = 0; i_shard < n_metadata_shard_g; i_shard++) {
+            shard = &metadata_shards_g[i_shard];
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_rdlock(&shard->lock);
+#endif
+            n_entry = hash_table_num_entries(shard->table);
+            hash_table_iterate(shard->table, &hash_table_iter);
 
-        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
-            pair = hash_table_iter_next(&hash_table_iter);
-            head = pair.value;
-            DL_FOREACH(head->metadata, elt)
-            {
-                // List all objects, no need to check other constraints
-                if (in->is_list_all == 1) {
-                    (*buf_ptrs)[iter++] = elt;
-                }
-                // check if current metadata matches search constraint
-                else if (is_metadata_satisfy_constraint(elt, in) == 1) {
-                    (*buf_ptrs)[iter++] = elt;
+            while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
+                pair = hash_table_iter_next(&hash_table_iter);
+                head = pair.value;
+                DL_FOREACH(head->metadata, elt)
+                {
+                    // List all objects, no need to check other constraints
+                    if (in->is_list_all == 1) {
+                        (*buf_ptrs)[iter++] = elt;
+                    }
+                    // check if current metadata matches search constraint
+                    else if (is_metadata_satisfy_constraint(elt, in) == 1) {
+                        (*buf_ptrs)[iter++] = elt;
+                    }
                 }
             }
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_release_rdlock(&shard->lock);
+#endif
         }
         *n_meta = iter;
-    } // if (metadata_hash_table_g != NULL)
+    } // if (metadata_shards_g != NULL)
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
         ret_value = FAIL;
         goto done;
     }
@@ -1594,11 +1817,12 @@ PDC_Server_get_kvtag_query_result(pdc_kvtag_t *in, uint32_t *n_meta, uint64_t **
 {
     perr_t                     ret_value = SUCCEED;
     uint32_t                   iter      = 0;
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *head;
     pdc_metadata_t *           elt;
     pdc_kvtag_list_t *         kvtag_list_elt;
     HashTableIterator          hash_table_iter;
-    int                        n_entry, is_name_match, is_value_match;
+    int                        n_entry, i_shard, is_name_match, is_value_match;
     HashTablePair              pair;
     uint32_t                   alloc_size = 100;
 
@@ -1608,61 +1832,67 @@ PDC_Server_get_kvtag_query_result(pdc_kvtag_t *in, uint32_t *n_meta, uint64_t **
     // TODO: free obj_ids
     *obj_ids = (void *)calloc(alloc_size, sizeof(uint64_t));
 
-    if (metadata_hash_table_g != NULL) {
-
-        n_entry = hash_table_num_entries(metadata_hash_table_g);
-        hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
+    if (metadata_shards_g != NULL) {
+        for (i_shard = 0; i_shard < n_metadata_shard_g; i_shard++) {
+            shard = &metadata_shards_g[i_shard];
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_rdlock(&shard->lock);
+#endif
+            n_entry = hash_table_num_entries(shard->table);
+            hash_table_iterate(shard->table, &hash_table_iter);
 
-        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
-            pair = hash_table_iter_next(&hash_table_iter);
-            head = pair.value;
-            DL_FOREACH(head->metadata, elt)
-            {
-                DL_FOREACH(elt->kvtag_list_head, kvtag_list_elt)
+            while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
+                pair = hash_table_iter_next(&hash_table_iter);
+                head = pair.value;
+                DL_FOREACH(head->metadata, elt)
                 {
-                    is_name_match  = 0;
-                    is_value_match = 0;
-                    if (in->name[0] != ' ') {
-                        if (strcmp(in->name, kvtag_list_elt->kvtag->name) == 0)
-                            is_name_match = 1;
+                    DL_FOREACH(elt->kvtag_list_head, kvtag_list_elt)
+                    {
+                        is_name_match  = 0;
+                        is_value_match = 0;
+                        if (in->name[0] != ' ') {
+                            if (strcmp(in->name, kvtag_list_elt->kvtag->name) == 0)
+                                is_name_match = 1;
+                            else
+                                continue;
+                        }
                         else
-                            continue;
-                    }
-                    else
-                        is_name_match = 1;
+                            is_name_match = 1;
 
-                    if (((char *)(in->value))[0] != ' ') {
-                        if (memcmp(in->value, kvtag_list_elt->kvtag->value, in->size) == 0)
-                            is_value_match = 1;
+                        if (((char *)(in->value))[0] != ' ') {
+                            if (memcmp(in->value, kvtag_list_elt->kvtag->value, in->size) == 0)
+                                is_value_match = 1;
+                            else
+                                continue;
+                        }
                         else
-                            continue;
-                    }
-                    else
-                        is_value_match = 1;
+                            is_value_match = 1;
 
-                    if (is_name_match == 1 && is_value_match == 1) {
-                        if (iter >= alloc_size) {
-                            alloc_size *= 2;
-                            *obj_ids = (void *)realloc(*obj_ids, alloc_size * sizeof(uint64_t));
+                        if (is_name_match == 1 && is_value_match == 1) {
+                            if (iter >= alloc_size) {
+                                alloc_size *= 2;
+                                *obj_ids = (void *)realloc(*obj_ids, alloc_size * sizeof(uint64_t));
+                            }
+                            (*obj_ids)[iter++] = elt->obj_id;
+                            break;
                         }
-                        (*obj_ids)[iter++] = elt->obj_id;
-                        break;
-                    }
 
-                } // End for each kvtag
-            }     // End for each metadata
-        }         // End while
+                    } // End for each kvtag
+                }     // End for each metadata
+            }         // End while
+#ifdef ENABLE_MULTITHREAD
+            hg_thread_rwlock_release_rdlock(&shard->lock);
+#endif
+        }
         *n_meta = iter;
-    } // if (metadata_hash_table_g != NULL)
+    } // if (metadata_shards_g != NULL)
     else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
         ret_value = FAIL;
         goto done;
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -1671,6 +1901,7 @@ PDC_Server_search_with_name_timestep(const char *obj_name, uint32_t hash_key, ui
                                      pdc_metadata_t **out)
 {
     perr_t                     ret_value = SUCCEED;
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *lookup_value;
     pdc_metadata_t             metadata;
     const char *               name;
@@ -1687,26 +1918,28 @@ PDC_Server_search_with_name_timestep(const char *obj_name, uint32_t hash_key, ui
     strcpy(metadata.obj_name, name);
     metadata.time_step = ts;
 
-    if (metadata_hash_table_g != NULL) {
-        // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, &hash_key);
+    if (metadata_shards_g == NULL) {
+        printf("metadata hash table not initialized!\n");
+        ret_value = -1;
+        goto done;
+    }
 
-        // Is this hash value exist in the Hash table?
-        if (lookup_value != NULL) {
-            *out = find_identical_metadata(lookup_value, &metadata);
+    // Lookups only take the read lock of the shard and run in parallel with each other
+    shard = PDC_Server_metadata_shard(hash_key);
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_rwlock_rdlock(&shard->lock);
+#endif
+    lookup_value = hash_table_lookup(shard->table, &hash_key);
 
-            if (*out == NULL) {
-                ret_value = FAIL;
-                goto done;
-            }
-        }
-        else {
-            *out = NULL;
-        }
-    }
-    else {
-        printf("metadata_hash_table_g not initialized!\n");
-        ret_value = -1;
+    // Is this hash value exist in the Hash table?
+    if (lookup_value != NULL)
+        *out = find_identical_metadata(lookup_value, &metadata);
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_rwlock_release_rdlock(&shard->lock);
+#endif
+
+    if (lookup_value != NULL && *out == NULL) {
+        ret_value = FAIL;
         goto done;
     }
 
@@ -1714,7 +1947,6 @@ PDC_Server_search_with_name_timestep(const char *obj_name, uint32_t hash_key, ui
         printf("==PDC_SERVER[%d]: Queried object with name [%s] not found! \n", pdc_server_rank_g, name);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1722,6 +1954,7 @@ perr_t
 PDC_Server_search_with_name_hash(const char *obj_name, uint32_t hash_key, pdc_metadata_t **out)
 {
     perr_t                     ret_value = SUCCEED;
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *lookup_value;
     pdc_metadata_t             metadata;
     const char *               name;
@@ -1739,26 +1972,27 @@ PDC_Server_search_with_name_hash(const char *obj_name, uint32_t hash_key, pdc_me
     // TODO: currently PDC_Client_query_metadata_name_timestep is not taking timestep for querying
     metadata.time_step = 0;
 
-    if (metadata_hash_table_g != NULL) {
-        // lookup
-        lookup_value = hash_table_lookup(metadata_hash_table_g, &hash_key);
+    if (metadata_shards_g == NULL) {
+        printf("metadata hash table not initialized!\n");
+        ret_value = -1;
+        goto done;
+    }
 
-        // Is this hash value exist in the Hash table?
-        if (lookup_value != NULL) {
-            *out = find_identical_metadata(lookup_value, &metadata);
+    shard = PDC_Server_metadata_shard(hash_key);
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_rwlock_rdlock(&shard->lock);
+#endif
+    lookup_value = hash_table_lookup(shard->table, &hash_key);
 
-            if (*out == NULL) {
-                ret_value = FAIL;
-                goto done;
-            }
-        }
-        else {
-            *out = NULL;
-        }
-    }
-    else {
-        printf("metadata_hash_table_g not initialized!\n");
-        ret_value = -1;
+    // Is this hash value exist in the Hash table?
+    if (lookup_value != NULL)
+        *out = find_identical_metadata(lookup_value, &metadata);
+#ifdef ENABLE_MULTITHREAD
+    hg_thread_rwlock_release_rdlock(&shard->lock);
+#endif
+
+    if (lookup_value != NULL && *out == NULL) {
+        ret_value = FAIL;
         goto done;
     }
 
@@ -1766,7 +2000,6 @@ PDC_Server_search_with_name_hash(const char *obj_name, uint32_t hash_key, pdc_me
         printf("==PDC_SERVER[%d]: Queried object with name [%s] not found! \n", pdc_server_rank_g, name);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1775,41 +2008,19 @@ PDC_Server_get_local_metadata_by_id(uint64_t obj_id, pdc_metadata_t **res_meta_p
 {
     perr_t ret_value = SUCCEED;
 
-    pdc_hash_table_entry_head *head;
-    pdc_metadata_t *           elt;
-    HashTableIterator          hash_table_iter;
-    int                        n_entry;
-    HashTablePair              pair;
-
     FUNC_ENTER(NULL);
 
     *res_meta_ptr = NULL;
 
-    if (metadata_hash_table_g != NULL) {
-        // Since we only have the obj id, need to iterate the entire hash table
-        n_entry = hash_table_num_entries(metadata_hash_table_g);
-        hash_table_iterate(metadata_hash_table_g, &hash_table_iter);
-
-        while (n_entry != 0 && hash_table_iter_has_more(&hash_table_iter)) {
-            pair = hash_table_iter_next(&hash_table_iter);
-            head = pair.value;
-            // Now iterate the list under this entry
-            DL_FOREACH(head->metadata, elt)
-            {
-                if (elt->obj_id == obj_id) {
-                    *res_meta_ptr = elt;
-                    goto done;
-                }
-            }
-        }
-    }
-    else {
-        printf("==PDC_SERVER: metadata_hash_table_g not initialized!\n");
-        ret_value     = FAIL;
-        *res_meta_ptr = NULL;
+    if (metadata_shards_g == NULL) {
+        printf("==PDC_SERVER: metadata hash table not initialized!\n");
+        ret_value = FAIL;
         goto done;
     }
 
+    // Since we only have the obj id, need to iterate all shards of the hash table
+    *res_meta_ptr = find_metadata_by_id(obj_id);
+
 done:
     FUNC_LEAVE(ret_value);
 }
@@ -1924,8 +2135,6 @@ PDC_Server_get_metadata_by_id_with_cb(uint64_t obj_id, perr_t (*cb)(), void *arg
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -2124,7 +2333,6 @@ PDC_Server_find_container_by_name(const char *cont_name, pdc_cont_hash_table_ent
         printf("==PDC_SERVER[%d]: container [%s] not found! \n", pdc_server_rank_g, cont_name);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2179,8 +2387,6 @@ PDC_Server_find_container_by_id(uint64_t cont_id, pdc_cont_hash_table_entry_t **
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -2244,7 +2450,6 @@ PDC_Server_container_add_objs(int n_obj, uint64_t *obj_ids, uint64_t cont_id)
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2286,8 +2491,6 @@ PDC_Server_container_del_objs(int n_obj, uint64_t *obj_ids, uint64_t cont_id)
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -2314,8 +2517,6 @@ PDC_Server_container_add_tags(uint64_t cont_id, char *tags)
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -2477,8 +2678,6 @@ PDC_Server_get_storage_meta_by_names(query_read_names_args_t *args)
     HG_Destroy(rpc_handle);
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -2526,7 +2725,6 @@ PDC_add_kvtag_to_list(pdc_kvtag_list_t **list_head, pdc_kvtag_t *tag)
     new_list_item->kvtag = newtag;
     DL_APPEND(*list_head, new_list_item);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2540,6 +2738,7 @@ PDC_Server_add_kvtag(metadata_add_kvtag_in_t *in, metadata_add_tag_out_t *out)
 #ifdef ENABLE_MULTITHREAD
     int unlocked;
 #endif
+    pdc_metadata_shard_t *       shard;
     pdc_hash_table_entry_head *  lookup_value;
     pdc_cont_hash_table_entry_t *cont_lookup_value;
 
@@ -2557,13 +2756,14 @@ PDC_Server_add_kvtag(metadata_add_kvtag_in_t *in, metadata_add_tag_out_t *out)
 
     // printf("==SERVER[%d]: PDC_add_kvtag::in.obj_id = %llu \n ", pdc_server_rank_g, obj_id);
 
+    shard = PDC_Server_metadata_shard(hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
+    // Obtain lock for the shard
     unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
-    lookup_value = hash_table_lookup(metadata_hash_table_g, &hash_key);
+    lookup_value = hash_table_lookup(shard->table, &hash_key);
     if (lookup_value != NULL) {
         pdc_metadata_t *target;
         target = find_metadata_by_id_from_list(lookup_value->metadata, obj_id);
@@ -2579,6 +2779,9 @@ PDC_Server_add_kvtag(metadata_add_kvtag_in_t *in, metadata_add_tag_out_t *out)
 
     }      // if lookup_value != NULL
     else { // look for containers
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_mutex_lock(&pdc_container_hash_table_mutex_g);
+#endif
         cont_lookup_value = hash_table_lookup(container_hash_table_g, &hash_key);
         if (cont_lookup_value != NULL) {
             PDC_add_kvtag_to_list(&cont_lookup_value->kvtag_list_head, &in->kvtag);
@@ -2589,11 +2792,14 @@ PDC_Server_add_kvtag(metadata_add_kvtag_in_t *in, metadata_add_tag_out_t *out)
             ret_value = FAIL;
             out->ret  = -1;
         }
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_mutex_unlock(&pdc_container_hash_table_mutex_g);
+#endif
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -2617,9 +2823,8 @@ PDC_Server_add_kvtag(metadata_add_kvtag_in_t *in, metadata_add_tag_out_t *out)
 
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
 #endif
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2642,7 +2847,6 @@ PDC_get_kvtag_value_from_list(pdc_kvtag_list_t **list_head, char *key, metadata_
         }
     }
 
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2657,6 +2861,7 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
 #ifdef ENABLE_MULTITHREAD
     int unlocked;
 #endif
+    pdc_metadata_shard_t *       shard;
     pdc_hash_table_entry_head *  lookup_value;
     pdc_cont_hash_table_entry_t *cont_lookup_value;
 
@@ -2672,13 +2877,14 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
     hash_key = in->hash_value;
     obj_id   = in->obj_id;
 
+    shard = PDC_Server_metadata_shard(hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
+    // Obtain lock for the shard
     unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_rwlock_rdlock(&shard->lock);
 #endif
 
-    lookup_value = hash_table_lookup(metadata_hash_table_g, &hash_key);
+    lookup_value = hash_table_lookup(shard->table, &hash_key);
     if (lookup_value != NULL) {
         pdc_metadata_t *target;
         target = find_metadata_by_id_from_list(lookup_value->metadata, obj_id);
@@ -2693,6 +2899,9 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
     }
     else {
 
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_mutex_lock(&pdc_container_hash_table_mutex_g);
+#endif
         cont_lookup_value = hash_table_lookup(container_hash_table_g, &hash_key);
         if (cont_lookup_value != NULL) {
             PDC_get_kvtag_value_from_list(&cont_lookup_value->kvtag_list_head, in->key, out);
@@ -2702,6 +2911,9 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
             ret_value = FAIL;
             out->ret  = -1;
         }
+#ifdef ENABLE_MULTITHREAD
+        hg_thread_mutex_unlock(&pdc_container_hash_table_mutex_g);
+#endif
     }
 
     if (ret_value != SUCCEED) {
@@ -2710,8 +2922,8 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_rdlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -2736,9 +2948,8 @@ PDC_Server_get_kvtag(metadata_get_kvtag_in_t *in, metadata_get_kvtag_out_t *out)
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_rdlock(&shard->lock);
 #endif
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2763,7 +2974,6 @@ PDC_del_kvtag_value_from_list(pdc_kvtag_list_t **list_head, char *key)
         }
     }
 
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2778,6 +2988,7 @@ PDC_Server_del_kvtag(metadata_get_kvtag_in_t *in, metadata_add_tag_out_t *out)
 #ifdef ENABLE_MULTITHREAD
     int unlocked;
 #endif
+    pdc_metadata_shard_t *     shard;
     pdc_hash_table_entry_head *lookup_value;
 
     FUNC_ENTER(NULL);
@@ -2792,13 +3003,14 @@ PDC_Server_del_kvtag(metadata_get_kvtag_in_t *in, metadata_add_tag_out_t *out)
     hash_key = in->hash_value;
     obj_id   = in->obj_id;
 
+    shard = PDC_Server_metadata_shard(hash_key);
 #ifdef ENABLE_MULTITHREAD
-    // Obtain lock for hash table
+    // Obtain lock for the shard
     unlocked = 0;
-    hg_thread_mutex_lock(&pdc_metadata_hash_table_mutex_g);
+    hg_thread_rwlock_wrlock(&shard->lock);
 #endif
 
-    lookup_value = hash_table_lookup(metadata_hash_table_g, &hash_key);
+    lookup_value = hash_table_lookup(shard->table, &hash_key);
     if (lookup_value != NULL) {
         pdc_metadata_t *target;
         target = find_metadata_by_id_from_list(lookup_value->metadata, obj_id);
@@ -2822,8 +3034,8 @@ PDC_Server_del_kvtag(metadata_get_kvtag_in_t *in, metadata_add_tag_out_t *out)
     }
 
 #ifdef ENABLE_MULTITHREAD
-    // ^ Release hash table lock
-    hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+    // ^ Release shard lock
+    hg_thread_rwlock_release_wrlock(&shard->lock);
     unlocked = 1;
 #endif
 
@@ -2848,9 +3060,8 @@ PDC_Server_del_kvtag(metadata_get_kvtag_in_t *in, metadata_add_tag_out_t *out)
 done:
 #ifdef ENABLE_MULTITHREAD
     if (unlocked == 0)
-        hg_thread_mutex_unlock(&pdc_metadata_hash_table_mutex_g);
+        hg_thread_rwlock_release_wrlock(&shard->lock);
 #endif
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -0,0 +1,83 @@
+#ifndef PDC_SERVER_CHUNK_H
+#define PDC_SERVER_CHUNK_H
+
+#include "pdc_public.h"
+#include "pdc_region.h"
+
+// Default size of a chunk before compression, override with PDC_CHUNK_SIZE
+#define PDC_CHUNK_SIZE_DEFAULT 1048576
+// Default number of threads that encode and decode chunks, override with PDC_CHUNK_NTHREAD
+#define PDC_CHUNK_NTHREAD_DEFAULT 4
+
+typedef struct pdc_chunk_stats_t {
+    uint64_t nchunk_write;
+    uint64_t nchunk_read;
+    uint64_t raw_bytes;    // size of the written chunks before compression
+    uint64_t stored_bytes; // size of the written chunks in the data files
+    double   encode_sec;   // summed over the threads
+    double   decode_sec;   // summed over the threads
+} pdc_chunk_stats_t;
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init chunked storage and start its threads if PDC_CHUNK_STORAGE is set
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_chunk_init();
+
+/**
+ * Stop the chunk threads and close all chunk files
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_chunk_finalize();
+
+/**
+ * Check if the data of an object is stored in chunks
+ *
+ * \param ndim [IN]             Number of dimensions of the object
+ * \param dims [IN]             Dimensions of the object
+ *
+ * \return 1 if chunked storage is on and the object has 1 to 3 fixed dimensions/0 otherwise
+ */
+int PDC_Server_chunk_enabled(int ndim, const uint64_t *dims);
+
+/**
+ * Check if an object has chunk files on this server
+ *
+ * \param obj_id [IN]           ID of the object
+ *
+ * \return 1 if chunked storage is on and the object has a chunk index/0 otherwise
+ */
+int PDC_Server_chunk_has_obj(uint64_t obj_id);
+
+/**
+ * Read or write a region of an object stored in chunks. Only the chunks the region touches are decoded,
+ * the chunks are encoded and decoded by the chunk threads. Rewritten chunks are appended to the data
+ * file, the chunk index points at the newest copy. An object written with other dims or unit is moved to
+ * the chunk layout of the new dims first.
+ *
+ * \param obj_id [IN]           ID of the object
+ * \param ndim [IN]             Number of dimensions of the object
+ * \param dims [IN]             Dimensions of the object
+ * \param region_info [IN]      Region to read or write
+ * \param buf [IN/OUT]          Data of the region in row-major order
+ * \param unit [IN]             Size of an element in bytes
+ * \param is_write [IN]         1 to write the region/0 to read it
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_chunk_io(uint64_t obj_id, int ndim, const uint64_t *dims,
+                           struct pdc_region_info *region_info, void *buf, size_t unit, int is_write);
+
+/**
+ * Get the counters of chunked storage
+ *
+ * \param stats [OUT]           Counters of chunked storage
+ */
+void PDC_Server_chunk_get_stats(pdc_chunk_stats_t *stats);
+
+#endif /* PDC_SERVER_CHUNK_H */
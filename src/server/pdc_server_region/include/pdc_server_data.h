@@ -39,6 +39,9 @@
 #define PDC_MAX_OVERLAP_REGION_NUM 8 // max number of regions for PDC_Server_get_storage_location_of_region()
 #define PDC_BULK_XFER_INIT_NALLOC  128
 
+// Default max number of query results sent to a client in one batch, override with PDC_QUERY_BATCH_NHITS
+#define PDC_QUERY_BATCH_NHITS_DEFAULT 1048576
+
 int data_sieving_g;
 /***************************/
 /* Library Private Structs */
@@ -217,6 +220,18 @@ typedef struct query_task_t {
     uint64_t **coords_arr;
     uint64_t * n_hits_from_server;
 
+    // Streamed selection (PDC_QUERY_GET_SEL_BATCH), evaluated one slab of the queried space at a time
+    // along the slowest dimension while the batches are sent
+    region_list_t *       stream_constraint; // region constraint of the query itself
+    region_list_t *       stream_window;     // slab being evaluated, in elements
+    uint64_t              stream_lo[DIM_MAX];
+    uint64_t              stream_hi[DIM_MAX];
+    uint64_t              stream_next;
+    uint64_t              stream_step;
+    int                   stream_closed; // stream finished or abandoned by the client
+    struct query_batch_t *stream_batch;
+    struct query_relay_t *relay_head; // manager: worker batches waiting to be relayed to the client
+
     // Data read
     int       n_read_data_region;
     void **   data_arr;
@@ -230,6 +245,48 @@ typedef struct query_task_t {
     struct query_task_t *next;
 } query_task_t;
 
+typedef enum {
+    PDC_QUERY_BATCH_BUF   = 0, // cut from a complete result buffer
+    PDC_QUERY_BATCH_EVAL  = 1, // produced by evaluating the query slab by slab
+    PDC_QUERY_BATCH_RELAY = 2  // manager: relayed from the batches of the worker servers
+} query_batch_mode_t;
+
+// Query results (coords or data) are sent to the client in batches of at most
+// pdc_query_batch_nhits_g elements, the next batch is only sent after the client
+// has acknowledged the previous one. Streamed batches carry PDC_QUERY_BATCH_MORE as
+// total and end with an empty batch.
+typedef struct query_batch_t {
+    query_batch_mode_t    mode;
+    int                   client_id;
+    int                   to_manager; // send to the manager server instead of the client
+    int                   manager;
+    int                   query_id;
+    int                   client_seq_id;
+    int                   op_id;
+    uint32_t              ndim;
+    size_t                elem_size; // bytes per element
+    uint64_t              total;     // number of elements to send, BUF mode only
+    uint64_t              offset;    // number of elements sent so far
+    void *                buf;       // elements being sent
+    uint64_t              buf_nelem;
+    uint64_t              buf_off;
+    int                   in_flight;
+    int                   is_last;
+    query_task_t *        task;  // streamed modes only
+    struct query_relay_t *relay; // worker batch being relayed
+    hg_bulk_t             bulk_handle;
+} query_batch_t;
+
+// A batch received by the manager from a worker, the worker is acknowledged once it is relayed
+typedef struct query_relay_t {
+    uint64_t *  coords;
+    uint64_t    nhits;
+    hg_handle_t handle;
+
+    struct query_relay_t *prev;
+    struct query_relay_t *next;
+} query_relay_t;
+
 typedef struct cache_storage_region_t {
     uint64_t       obj_id;
     pdc_var_type_t data_type;
@@ -282,6 +339,7 @@ extern int                       is_debug_g;
 extern int                       n_read_from_bb_g;
 extern int                       read_from_bb_size_g;
 extern int                       gen_hist_g;
+extern uint64_t                  pdc_query_batch_nhits_g;
 
 extern pdc_data_server_io_list_t * pdc_data_server_read_list_head_g;
 extern pdc_data_server_io_list_t * pdc_data_server_write_list_head_g;
@@ -408,6 +466,41 @@ perr_t PDC_Server_regions_io(region_list_t *region_list_head, _pdc_io_plugin_t p
  * \return Region struct/NULL on failure
  */
 data_server_region_t *PDC_Server_get_obj_region(pdcid_t obj_id);
+
+/**
+ * Append a region struct to the object list of the data server and index it by object ID
+ *
+ * \param new_obj_reg [IN]      Region struct of an object
+ *
+ * \return SUCCEED/FAIL
+ */
+perr_t PDC_Server_add_obj_region(data_server_region_t *new_obj_reg);
+/**
+ * Append a storage region to the storage list of an object and index it
+ *
+ * \param region [IN]           Region struct of the object
+ * \param storage_region [IN]   Storage region to add
+ *
+ * \return SUCCEED/FAIL
+ */
+perr_t PDC_Server_add_storage_region(data_server_region_t *region, region_list_t *storage_region);
+
+/**
+ * Get the storage regions of an object that overlap a region, in the order they were written
+ *
+ * \param region [IN]           Region struct of the object
+ * \param ndim [IN]             Number of dimensions
+ * \param offset [IN]           Offset of the region
+ * \param size [IN]             Size of the region
+ * \param overlap_regions [OUT] Array of the overlapping storage regions, to be freed by the caller
+ * \param n_overlap [OUT]       Number of overlapping storage regions
+ *
+ * \return SUCCEED/FAIL
+ */
+perr_t PDC_Server_get_overlap_storage_regions(data_server_region_t *region, int ndim, uint64_t *offset,
+                                              uint64_t *size, region_list_t ***overlap_regions,
+                                              int *n_overlap);
+
 /**
  * Server register region struct by object ID, if not existing.
  *
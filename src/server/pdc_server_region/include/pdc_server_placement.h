@@ -0,0 +1,108 @@
+#ifndef PDC_SERVER_PLACEMENT_H
+#define PDC_SERVER_PLACEMENT_H
+
+#include <stdint.h>
+
+// Default rate at which a data server is assumed to absorb writes, override with PDC_PLACEMENT_DRAIN_RATE
+#define PDC_PLACEMENT_DRAIN_RATE_DEFAULT 1073741824.0
+// How much longer a server takes to write data sent from another node, override with
+// PDC_PLACEMENT_REMOTE_COST
+#define PDC_PLACEMENT_REMOTE_COST_DEFAULT 1.5
+// Extra seconds of write time accepted to keep a region on the client's node, override with
+// PDC_PLACEMENT_LOCALITY_SLACK
+#define PDC_PLACEMENT_LOCALITY_SLACK_DEFAULT 0.01
+
+/* How the metadata server picks a data server for a PDC_REGION_DYNAMIC region, set with
+ * PDC_PLACEMENT_POLICY */
+typedef enum {
+    PDC_PLACEMENT_LEAST_BYTES  = 0, // "bytes": fewest bytes placed so far
+    PDC_PLACEMENT_ROUND_ROBIN  = 1, // "round_robin"
+    PDC_PLACEMENT_LEAST_LOADED = 2, // "least_loaded": smallest estimated write backlog
+    PDC_PLACEMENT_LOCALITY     = 3  // "locality": node-local server unless another one finishes first
+} pdc_placement_policy_t;
+
+typedef struct pdc_placement_server_t {
+    uint64_t bytes;    // total bytes placed on the server
+    double   busy_end; // time at which the server is estimated to have written its backlog
+    double   key;      // heap key, depends on the policy
+    int      heap_pos;
+    uint64_t n_regions;
+} pdc_placement_server_t;
+
+typedef struct pdc_placement_t {
+    pdc_placement_policy_t  policy;
+    int                     n_servers;
+    pdc_placement_server_t *servers;
+    int *                   heap; // min-heap of server IDs ordered by key
+    uint32_t                rr_next;
+    double                  drain_rate;
+    double                  remote_cost;
+    double                  locality_slack;
+    uint64_t                n_placed;
+    uint64_t                n_local;
+} pdc_placement_t;
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init a placement engine
+ *
+ * \param placement [IN]        Pointer to the engine
+ * \param n_servers [IN]        Number of data servers
+ * \param policy [IN]           Placement policy
+ * \param drain_rate [IN]       Bytes per second a server is assumed to write, 0 for the default
+ * \param remote_cost [IN]      Write time factor of data from another node, 0 for the default
+ * \param locality_slack [IN]   Seconds of extra write time accepted to stay local, negative for the default
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+int PDC_placement_init(pdc_placement_t *placement, int n_servers, pdc_placement_policy_t policy,
+                       double drain_rate, double remote_cost, double locality_slack);
+
+/**
+ * Free a placement engine
+ *
+ * \param placement [IN]        Pointer to the engine
+ */
+void PDC_placement_finalize(pdc_placement_t *placement);
+
+/**
+ * Parse a policy name
+ *
+ * \param name [IN]             One of "bytes", "round_robin", "least_loaded" and "locality"
+ *
+ * \return The policy, or -1 if the name is unknown
+ */
+int PDC_placement_policy_from_name(const char *name);
+
+/**
+ * Pick the data server of a new region and account its bytes on it
+ *
+ * \param placement [IN]        Pointer to the engine
+ * \param local_server [IN]     Data server on the node of the writing client
+ * \param bytes [IN]            Size of the region in bytes
+ * \param now [IN]              Current time in seconds, see PDC_placement_now
+ *
+ * \return ID of the selected data server
+ */
+uint32_t PDC_placement_select(pdc_placement_t *placement, uint32_t local_server, uint64_t bytes, double now);
+
+/**
+ * Account the bytes of a region whose data server was chosen by the client
+ *
+ * \param placement [IN]        Pointer to the engine
+ * \param server [IN]           Data server of the region
+ * \param bytes [IN]            Size of the region in bytes
+ * \param now [IN]              Current time in seconds, see PDC_placement_now
+ */
+void PDC_placement_charge(pdc_placement_t *placement, uint32_t server, uint64_t bytes, double now);
+
+/**
+ * Get a monotonic time in seconds
+ *
+ * \return Current time
+ */
+double PDC_placement_now();
+
+#endif /* PDC_SERVER_PLACEMENT_H */
@@ -0,0 +1,79 @@
+#ifndef PDC_SERVER_QUERY_CACHE_H
+#define PDC_SERVER_QUERY_CACHE_H
+
+#include "pdc_public.h"
+#include "pdc_query.h"
+#include "pdc_client_server_common.h"
+
+// Default memory budget of the query result cache, override with PDC_QUERY_CACHE_MAX_SIZE (0 disables it)
+#define PDC_QUERY_CACHE_MAX_SIZE_DEFAULT 268435456
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init the query result and histogram cache
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_query_cache_init();
+
+/**
+ * Free all cached query results and histograms
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_query_cache_finalize();
+
+/**
+ * Build the canonical key of a query, including the current version and attached storage regions of each
+ * queried object. Operands of AND/OR are ordered, so equivalent query trees get the same key.
+ *
+ * \param query [IN]            Query with storage regions attached to its leaves
+ *
+ * \return Key string that should be freed by the caller, NULL if the cache is disabled
+ */
+char *PDC_Server_query_cache_key(pdc_query_t *query);
+
+/**
+ * Look up a cached query result and copy it to a selection
+ *
+ * \param key [IN]              Key from PDC_Server_query_cache_key
+ * \param sel [OUT]             Selection to copy the cached coords to
+ * \param ndim [OUT]            Number of dimensions of the coords
+ *
+ * \return 1 on hit/0 on miss
+ */
+int PDC_Server_query_cache_lookup(const char *key, pdc_selection_t *sel, int *ndim);
+
+/**
+ * Insert a query result to the cache, evicting the least recently used entries if over budget. The result
+ * is dropped if any queried object has been written since the key was built.
+ *
+ * \param key [IN]              Key from PDC_Server_query_cache_key
+ * \param query [IN]            Query the result belongs to
+ * \param sel [IN]              Selection with the result coords
+ * \param ndim [IN]             Number of dimensions of the coords
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_query_cache_insert(const char *key, pdc_query_t *query, pdc_selection_t *sel, int ndim);
+
+/**
+ * Get the histogram of an object aggregated over its storage regions, computed on first use
+ *
+ * \param obj_id [IN]           Object ID
+ * \param region_head [IN]      Storage regions of the object
+ *
+ * \return Copy of the aggregated histogram that should be freed by the caller, NULL if not available
+ */
+pdc_histogram_t *PDC_Server_query_cache_get_hist(uint64_t obj_id, region_list_t *region_head);
+
+/**
+ * Invalidate all cached results and histograms of an object, called when the object is written
+ *
+ * \param obj_id [IN]           Object ID
+ */
+void PDC_Server_query_cache_invalidate(uint64_t obj_id);
+
+#endif /* PDC_SERVER_QUERY_CACHE_H */
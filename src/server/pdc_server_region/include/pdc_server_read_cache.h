@@ -0,0 +1,73 @@
+#ifndef PDC_SERVER_READ_CACHE_H
+#define PDC_SERVER_READ_CACHE_H
+
+#include "pdc_public.h"
+
+// Default memory budget of the region read cache, override with PDC_READ_CACHE_MAX_SIZE (0 disables it)
+#define PDC_READ_CACHE_MAX_SIZE_DEFAULT 536870912
+// Default read-ahead size for sequential region scans, override with PDC_READ_CACHE_READAHEAD
+#define PDC_READ_CACHE_READAHEAD_DEFAULT 8388608
+
+typedef struct pdc_read_cache_stats_t {
+    uint64_t nhit;
+    uint64_t nmiss;
+    uint64_t nreadahead_hit;
+    uint64_t nevict;
+    uint64_t size;
+} pdc_read_cache_stats_t;
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init the region read cache
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_read_cache_init();
+
+/**
+ * Free all cached region buffers
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_read_cache_finalize();
+
+/**
+ * Get the data of a storage region from the read cache, reading it from the file on a miss. The buffer
+ * stays valid until the returned handle is released.
+ *
+ * \param path [IN]             Path of the file the region is stored in
+ * \param fd [IN]               Opened file descriptor of the path, negative to open the path
+ * \param offset [IN]           Offset of the region in the file
+ * \param size [IN]             Size of the region in bytes
+ * \param handle [OUT]          Handle of the cache entry to release
+ *
+ * \return Buffer with the region data, NULL if the region can not be cached or the read failed
+ */
+void *PDC_Server_read_cache_acquire(const char *path, int fd, uint64_t offset, uint64_t size, void **handle);
+
+/**
+ * Release a buffer returned by PDC_Server_read_cache_acquire
+ *
+ * \param handle [IN]           Handle from PDC_Server_read_cache_acquire
+ */
+void PDC_Server_read_cache_release(void *handle);
+
+/**
+ * Drop cached data of a file range that is being overwritten
+ *
+ * \param path [IN]             Path of the file
+ * \param offset [IN]           Start of the range in the file
+ * \param size [IN]             Size of the range in bytes
+ */
+void PDC_Server_read_cache_invalidate(const char *path, uint64_t offset, uint64_t size);
+
+/**
+ * Get the hit/miss counters of the read cache
+ *
+ * \param stats [OUT]           Counters of the read cache
+ */
+void PDC_Server_read_cache_get_stats(pdc_read_cache_stats_t *stats);
+
+#endif /* PDC_SERVER_READ_CACHE_H */
@@ -16,8 +16,9 @@ typedef struct pdc_transfer_request_status {
     hg_handle_t                         handle;
     uint64_t                            transfer_request_id;
     uint32_t                            status;
-    int *                               handle_ref;
+    int *                               handle_ref; // [0] requests the wait RPC waits for, [1] one failed
     int                                 out_type;
+    int                                 failed;
     struct pdc_transfer_request_status *next;
 } pdc_transfer_request_status;
 
@@ -27,6 +28,12 @@ pthread_mutex_t              transfer_request_status_mutex;
 pthread_mutex_t              transfer_request_id_mutex;
 uint64_t                     transfer_request_id_g;
 
+// Number of staging buffers a pipelined transfer_request_all keeps in flight
+#define PDC_TRANSFER_PIPELINE_DEPTH_DEFAULT 4
+// Size of the chunks a transfer_request_all is pipelined in, 0 moves the whole request at once
+uint64_t transfer_request_pipeline_chunk_size_g;
+int      transfer_request_pipeline_depth_g;
+
 perr_t PDC_server_transfer_request_init();
 
 perr_t PDC_server_transfer_request_finalize();
@@ -48,13 +55,19 @@ perr_t PDC_commit_request(uint64_t transfer_request_id);
  */
 perr_t PDC_finish_request(uint64_t transfer_request_id);
 
+/*
+ * Search a linked list for a transfer request and mark it failed, the wait for it then returns an error.
+ * PDC_finish_request still has to be called. Thread-safe function, lock required ahead of time.
+ */
+perr_t PDC_fail_request(uint64_t transfer_request_id);
+
 /*
  * Search a linked list for a region transfer request.
  * Remove the linked list node and free its memory.
- * Return the status of the region transfer request.
+ * Return the status of the region transfer request, *failed is set when a completed request failed.
  * Thread-safe function, lock required ahead of time.
  */
-pdc_transfer_status_t PDC_check_request(uint64_t transfer_request_id);
+pdc_transfer_status_t PDC_check_request(uint64_t transfer_request_id, int *failed);
 
 /*
  * Search a linked list for a region transfer request.
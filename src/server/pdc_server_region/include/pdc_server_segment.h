@@ -0,0 +1,103 @@
+#ifndef PDC_SERVER_SEGMENT_H
+#define PDC_SERVER_SEGMENT_H
+
+#include "pdc_public.h"
+#include "pdc_region.h"
+
+// Objects up to this many bytes are packed into the segment files, override with PDC_SEGMENT_OBJ_SIZE
+#define PDC_SEGMENT_OBJ_SIZE_DEFAULT 1048576
+// A segment is sealed and a new one started past this size, override with PDC_SEGMENT_FILE_SIZE
+#define PDC_SEGMENT_FILE_SIZE_DEFAULT 268435456
+// Sealed segments with less live data than this percent are compacted, override with PDC_SEGMENT_COMPACT_PCT
+#define PDC_SEGMENT_COMPACT_PCT_DEFAULT 50
+
+typedef struct pdc_segment_stats_t {
+    uint64_t nobj_write;
+    uint64_t nobj_read;
+    uint64_t write_bytes;   // object data appended by writes
+    uint64_t ncompact;      // segments compacted and removed
+    uint64_t compact_bytes; // live object data moved by compaction
+} pdc_segment_stats_t;
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init segment storage if PDC_SEGMENT_STORAGE is set. The index saved by the last checkpoint is loaded
+ * and the records appended after it are replayed from the segment files.
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_segment_init();
+
+/**
+ * Stop the compaction thread, save the index and close the segment files
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_segment_finalize();
+
+/**
+ * Check if the data of an object is packed into the segment files
+ *
+ * \param ndim [IN]             Number of dimensions of the object
+ * \param dims [IN]             Dimensions of the object
+ * \param unit [IN]             Size of an element in bytes
+ *
+ * \return 1 if segment storage is on and the object has 1 to 3 fixed dimensions and is small enough/0
+ *         otherwise
+ */
+int PDC_Server_segment_enabled(int ndim, const uint64_t *dims, size_t unit);
+
+/**
+ * Check if an object has data in the segment files. Such an object stays there even if PDCobj_set_dims
+ * makes it too large for PDC_Server_segment_enabled.
+ *
+ * \param obj_id [IN]           ID of the object
+ *
+ * \return 1 if the segment index has the object/0 otherwise
+ */
+int PDC_Server_segment_has_obj(uint64_t obj_id);
+
+/**
+ * Read or write a region of an object packed into the segment files. A write appends only the region to the
+ * active segment and adds it to the extents of the object in the index, the extents it hides are left for
+ * compaction. Parts of the object no write covered read as zeros.
+ *
+ * \param obj_id [IN]           ID of the object
+ * \param ndim [IN]             Number of dimensions of the object
+ * \param dims [IN]             Dimensions of the object
+ * \param region_info [IN]      Region to read or write
+ * \param buf [IN/OUT]          Data of the region in row-major order
+ * \param unit [IN]             Size of an element in bytes
+ * \param is_write [IN]         1 to write the region/0 to read it
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_segment_io(uint64_t obj_id, int ndim, const uint64_t *dims,
+                             struct pdc_region_info *region_info, void *buf, size_t unit, int is_write);
+
+/**
+ * Drop the data of a deleted object from the segment index, nothing is done if the object is not in it
+ *
+ * \param obj_id [IN]           ID of the object
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_segment_delete(uint64_t obj_id);
+
+/**
+ * Save the segment index next to the segment files, called with the metadata checkpoint
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+perr_t PDC_Server_segment_checkpoint();
+
+/**
+ * Get the counters of segment storage
+ *
+ * \param stats [OUT]           Counters of segment storage
+ */
+void PDC_Server_segment_get_stats(pdc_segment_stats_t *stats);
+
+#endif /* PDC_SERVER_SEGMENT_H */
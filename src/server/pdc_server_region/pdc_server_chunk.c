@@ -0,0 +1,953 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "pdc_config.h"
+#include "pdc_utlist.h"
+#include "pdc_hash-table.h"
+#include "pdc_client_server_common.h"
+#include "pdc_codec.h"
+#include "pdc_server_chunk.h"
+
+#define PDC_CHUNK_MAGIC "PDCCHK01"
+
+/*
+ * Each server keeps two files per object next to the flat data file, s%04d.chk with the encoded chunks
+ * and s%04d.idx with this header followed by one entry per chunk in row-major chunk order. Objects of
+ * fewer than 3 dimensions are stored as 3-D objects with leading dimensions of 1.
+ */
+typedef struct pdc_chunk_header_t {
+    char     magic[8];
+    uint64_t unit;
+    uint64_t dims[3];
+    uint64_t chunk_dims[3];
+} pdc_chunk_header_t;
+
+typedef struct pdc_chunk_entry_t {
+    uint64_t offset; // offset of the encoded chunk in the data file
+    uint64_t csize;  // encoded size, 0 if the chunk was never written
+    uint64_t codec;
+} pdc_chunk_entry_t;
+
+typedef struct pdc_chunk_obj_t {
+    uint64_t           obj_id;
+    pdc_chunk_header_t header;
+    uint64_t           nchunk[3];
+    pdc_chunk_entry_t *index;
+    int                data_fd;
+    int                index_fd;
+    uint64_t           data_end;
+    pthread_rwlock_t   rwlock; // readers share the index, a writer holds it until the index is updated
+} pdc_chunk_obj_t;
+
+// A chunk touched by a request
+typedef struct pdc_chunk_task_t {
+    uint64_t idx;
+    uint64_t start[3];
+    uint64_t count[3]; // smaller than the chunk dims at the object edge
+    char *   data;     // encoded chunk, set by writes
+    size_t   csize;
+    int      codec;
+    perr_t   ret;
+} pdc_chunk_task_t;
+
+typedef struct pdc_chunk_request_t {
+    pdc_chunk_obj_t * obj;
+    pdc_chunk_task_t *tasks;
+    uint64_t          offset[3];
+    uint64_t          size[3];
+    char *            buf;
+} pdc_chunk_request_t;
+
+typedef void (*pdc_chunk_func_t)(pdc_chunk_request_t *req, pdc_chunk_task_t *task);
+
+typedef struct pdc_chunk_job_t {
+    pdc_chunk_func_t     func;
+    pdc_chunk_request_t *req;
+    uint64_t             ntask;
+    uint64_t             next_task; // next task to run, taken with an atomic add
+    uint64_t             ndone;     // atomic
+    int                  nworker;   // workers running tasks of this job, protected by the pool mutex
+
+    struct pdc_chunk_job_t *prev;
+    struct pdc_chunk_job_t *next;
+} pdc_chunk_job_t;
+
+static int               chunk_enabled_g   = 0;
+static uint64_t          chunk_size_g      = PDC_CHUNK_SIZE_DEFAULT;
+static HashTable *       chunk_obj_table_g = NULL; // obj_id -> pdc_chunk_obj_t
+static pthread_mutex_t   chunk_obj_mutex_g;
+static pthread_t *       chunk_workers_g = NULL;
+static int               chunk_nworker_g = 0;
+static int               chunk_running_g = 0;
+static pdc_chunk_job_t * chunk_jobs_g    = NULL;
+static pthread_mutex_t   chunk_pool_mutex_g;
+static pthread_cond_t    chunk_pool_cond_g; // a job was posted or the pool is stopping
+static pthread_cond_t    chunk_done_cond_g; // a worker left a job
+static pthread_mutex_t   chunk_stats_mutex_g;
+static pdc_chunk_stats_t chunk_stats_g;
+
+static unsigned int
+chunk_obj_hash(HashTableKey key)
+{
+    uint64_t obj_id = *((uint64_t *)key);
+
+    return (unsigned int)(obj_id ^ (obj_id >> 32));
+}
+
+static int
+chunk_obj_equal(HashTableKey key1, HashTableKey key2)
+{
+    return *((uint64_t *)key1) == *((uint64_t *)key2);
+}
+
+static void
+chunk_obj_free(HashTableValue value)
+{
+    pdc_chunk_obj_t *obj = (pdc_chunk_obj_t *)value;
+
+    if (obj->data_fd >= 0)
+        close(obj->data_fd);
+    if (obj->index_fd >= 0)
+        close(obj->index_fd);
+    pthread_rwlock_destroy(&obj->rwlock);
+    free(obj->index);
+    free(obj);
+}
+
+static perr_t
+chunk_pread(int fd, void *buf, uint64_t size, uint64_t offset)
+{
+    uint64_t done = 0;
+    ssize_t  ret;
+
+    while (done < size) {
+        ret = pread(fd, (char *)buf + done, size - done, offset + done);
+        if (ret <= 0)
+            return FAIL;
+        done += ret;
+    }
+    return SUCCEED;
+}
+
+static perr_t
+chunk_pwrite(int fd, const void *buf, uint64_t size, uint64_t offset)
+{
+    uint64_t done = 0;
+    ssize_t  ret;
+
+    while (done < size) {
+        ret = pwrite(fd, (const char *)buf + done, size - done, offset + done);
+        if (ret <= 0)
+            return FAIL;
+        done += ret;
+    }
+    return SUCCEED;
+}
+
+/*
+ * Fill the innermost dimension first, so a chunk is a run of whole rows or planes when they fit in
+ * chunk_size_g and reading a range of rows decodes as few chunks as possible
+ */
+static void
+chunk_set_dims(pdc_chunk_header_t *header)
+{
+    uint64_t target = chunk_size_g / header->unit, inner = 1, n;
+    int      d;
+
+    if (target == 0)
+        target = 1;
+    for (d = 2; d >= 0; d--) {
+        n = target / inner;
+        if (n == 0)
+            n = 1;
+        header->chunk_dims[d] = header->dims[d] < n ? header->dims[d] : n;
+        inner *= header->chunk_dims[d];
+    }
+}
+
+// Path of a chunk file of an object, ext is "idx" or "chk"
+static void
+chunk_obj_path(uint64_t obj_id, const char *ext, char *path)
+{
+    char *data_path;
+
+    data_path = getenv("PDC_DATA_LOC");
+    if (data_path == NULL)
+        data_path = getenv("SCRATCH");
+    if (data_path == NULL)
+        data_path = ".";
+    snprintf(path, ADDR_MAX, "%.200s/pdc_data/%" PRIu64 "/server%d/s%04d.%s", data_path, obj_id,
+             pdc_server_rank_g, pdc_server_rank_g, ext);
+}
+
+static int
+chunk_obj_match(pdc_chunk_obj_t *obj, const uint64_t *dims, size_t unit)
+{
+    return obj->header.unit == unit && memcmp(obj->header.dims, dims, sizeof(obj->header.dims)) == 0;
+}
+
+/*
+ * Open or create the chunk files of an object, chunk_obj_mutex_g must be held. An existing object keeps
+ * the header it was written with, chunk_obj_get resizes it if dims or unit changed.
+ */
+static pdc_chunk_obj_t *
+chunk_obj_open(uint64_t obj_id, const uint64_t *dims, size_t unit)
+{
+    pdc_chunk_obj_t *  ret_value = NULL;
+    pdc_chunk_obj_t *  obj       = NULL;
+    pdc_chunk_header_t header;
+    char               path[ADDR_MAX];
+    struct stat        st;
+    uint64_t           nentry, index_size;
+    int                d;
+
+    FUNC_ENTER(NULL);
+
+    obj = (pdc_chunk_obj_t *)calloc(1, sizeof(pdc_chunk_obj_t));
+    if (obj == NULL)
+        PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot allocate chunk object", pdc_server_rank_g);
+    obj->obj_id   = obj_id;
+    obj->data_fd  = -1;
+    obj->index_fd = -1;
+    pthread_rwlock_init(&obj->rwlock, NULL);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PDC_CHUNK_MAGIC, sizeof(header.magic));
+    header.unit = unit;
+    for (d = 0; d < 3; d++)
+        header.dims[d] = dims[d];
+    chunk_set_dims(&header);
+
+    chunk_obj_path(obj_id, "idx", path);
+    PDC_mkdir(path);
+    obj->index_fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (obj->index_fd < 0 || fstat(obj->index_fd, &st) != 0)
+        PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot open chunk index [%s]", pdc_server_rank_g, path);
+
+    if (st.st_size == 0) {
+        obj->header = header;
+        if (chunk_pwrite(obj->index_fd, &header, sizeof(header), 0) != SUCCEED)
+            PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot write chunk index [%s]", pdc_server_rank_g, path);
+    }
+    else {
+        // Keep the chunk dims the object was first written with, PDC_CHUNK_SIZE may have changed since
+        if (chunk_pread(obj->index_fd, &obj->header, sizeof(header), 0) != SUCCEED ||
+            memcmp(obj->header.magic, PDC_CHUNK_MAGIC, sizeof(header.magic)) != 0)
+            PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: bad chunk index [%s]", pdc_server_rank_g, path);
+    }
+
+    nentry = 1;
+    for (d = 0; d < 3; d++) {
+        obj->nchunk[d] = (obj->header.dims[d] + obj->header.chunk_dims[d] - 1) / obj->header.chunk_dims[d];
+        nentry *= obj->nchunk[d];
+    }
+    index_size = nentry * sizeof(pdc_chunk_entry_t);
+    obj->index = (pdc_chunk_entry_t *)calloc(nentry, sizeof(pdc_chunk_entry_t));
+    if (obj->index == NULL)
+        PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot allocate chunk index", pdc_server_rank_g);
+    // Entries past the end of a short file were never written
+    if ((uint64_t)st.st_size > sizeof(header)) {
+        if ((uint64_t)st.st_size - sizeof(header) < index_size)
+            index_size = st.st_size - sizeof(header);
+        if (chunk_pread(obj->index_fd, obj->index, index_size, sizeof(header)) != SUCCEED)
+            PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot read chunk index [%s]", pdc_server_rank_g, path);
+    }
+
+    chunk_obj_path(obj_id, "chk", path);
+    obj->data_fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (obj->data_fd < 0 || fstat(obj->data_fd, &st) != 0)
+        PGOTO_ERROR(NULL, "==PDC_SERVER[%d]: cannot open chunk data [%s]", pdc_server_rank_g, path);
+    obj->data_end = st.st_size;
+
+    ret_value = obj;
+
+done:
+    if (ret_value == NULL && obj != NULL)
+        chunk_obj_free(obj);
+    FUNC_LEAVE(ret_value);
+}
+
+static uint64_t
+chunk_task_size(pdc_chunk_obj_t *obj, pdc_chunk_task_t *task)
+{
+    return task->count[0] * task->count[1] * task->count[2] * obj->header.unit;
+}
+
+static int
+chunk_task_covered(pdc_chunk_request_t *req, pdc_chunk_task_t *task)
+{
+    int d;
+
+    for (d = 0; d < 3; d++) {
+        if (task->start[d] < req->offset[d] ||
+            task->start[d] + task->count[d] > req->offset[d] + req->size[d])
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * Copy the part of the request region inside a chunk between the chunk buffer and the request buffer.
+ * A NULL chunk zero fills the region part, for chunks that were never written.
+ */
+static void
+chunk_copy(pdc_chunk_request_t *req, pdc_chunk_task_t *task, char *chunk, int to_chunk)
+{
+    uint64_t unit = req->obj->header.unit;
+    uint64_t lo[3], hi[3], i, j, row;
+    char *   c, *r;
+    int      d;
+
+    for (d = 0; d < 3; d++) {
+        lo[d] = task->start[d] > req->offset[d] ? task->start[d] : req->offset[d];
+        hi[d] = task->start[d] + task->count[d];
+        if (hi[d] > req->offset[d] + req->size[d])
+            hi[d] = req->offset[d] + req->size[d];
+    }
+    row = (hi[2] - lo[2]) * unit;
+
+    for (i = lo[0]; i < hi[0]; i++) {
+        for (j = lo[1]; j < hi[1]; j++) {
+            r = req->buf + (((i - req->offset[0]) * req->size[1] + (j - req->offset[1])) * req->size[2] +
+                            (lo[2] - req->offset[2])) *
+                               unit;
+            if (chunk == NULL) {
+                memset(r, 0, row);
+                continue;
+            }
+            c = chunk + (((i - task->start[0]) * task->count[1] + (j - task->start[1])) * task->count[2] +
+                         (lo[2] - task->start[2])) *
+                            unit;
+            if (to_chunk)
+                memcpy(c, r, row);
+            else
+                memcpy(r, c, row);
+        }
+    }
+}
+
+// Read and decode a stored chunk into raw, tmp is scratch space of the same size
+static perr_t
+chunk_load(pdc_chunk_obj_t *obj, pdc_chunk_task_t *task, char *raw, char *tmp)
+{
+    pdc_chunk_entry_t *entry = &obj->index[task->idx];
+    uint64_t           size  = chunk_task_size(obj, task);
+    char *             enc;
+    perr_t             ret_value = SUCCEED;
+
+    enc = (char *)malloc(entry->csize);
+    if (enc == NULL)
+        return FAIL;
+    if (chunk_pread(obj->data_fd, enc, entry->csize, entry->offset) != SUCCEED ||
+        PDC_codec_decode((int)entry->codec, enc, entry->csize, obj->header.unit, raw, size, tmp) != 0) {
+        printf("==PDC_SERVER[%d]: %s - chunk %" PRIu64 " of object %" PRIu64 " is corrupted\n",
+               pdc_server_rank_g, __func__, task->idx, obj->obj_id);
+        ret_value = FAIL;
+    }
+    free(enc);
+
+    return ret_value;
+}
+
+static void
+chunk_read_task(pdc_chunk_request_t *req, pdc_chunk_task_t *task)
+{
+    pdc_chunk_obj_t *obj  = req->obj;
+    uint64_t         size = chunk_task_size(obj, task);
+    char *           raw, *tmp;
+    struct timeval   start, end;
+
+    if (obj->index[task->idx].csize == 0) {
+        chunk_copy(req, task, NULL, 0);
+        return;
+    }
+
+    gettimeofday(&start, 0);
+    raw = (char *)malloc(size);
+    tmp = (char *)malloc(size);
+    if (raw == NULL || tmp == NULL || chunk_load(obj, task, raw, tmp) != SUCCEED)
+        task->ret = FAIL;
+    else
+        chunk_copy(req, task, raw, 0);
+    free(raw);
+    free(tmp);
+    gettimeofday(&end, 0);
+
+    pthread_mutex_lock(&chunk_stats_mutex_g);
+    chunk_stats_g.nchunk_read++;
+    chunk_stats_g.decode_sec += PDC_get_elapsed_time_double(&start, &end);
+    pthread_mutex_unlock(&chunk_stats_mutex_g);
+}
+
+static void
+chunk_write_task(pdc_chunk_request_t *req, pdc_chunk_task_t *task)
+{
+    pdc_chunk_obj_t *obj  = req->obj;
+    uint64_t         size = chunk_task_size(obj, task);
+    char *           raw, *tmp;
+    struct timeval   start, end;
+
+    gettimeofday(&start, 0);
+    raw        = (char *)malloc(size);
+    tmp        = (char *)malloc(size);
+    task->data = (char *)malloc(size);
+    if (raw == NULL || tmp == NULL || task->data == NULL) {
+        task->ret = FAIL;
+        goto done;
+    }
+
+    // A partly written chunk keeps the rest of its stored data
+    if (!chunk_task_covered(req, task)) {
+        if (obj->index[task->idx].csize == 0)
+            memset(raw, 0, size);
+        else if (chunk_load(obj, task, raw, tmp) != SUCCEED) {
+            task->ret = FAIL;
+            goto done;
+        }
+    }
+    chunk_copy(req, task, raw, 1);
+    task->codec = PDC_codec_encode(PDC_CODEC_SHUFFLE_LZ, raw, size, obj->header.unit, task->data, tmp,
+                                   &task->csize);
+
+done:
+    free(raw);
+    free(tmp);
+    gettimeofday(&end, 0);
+
+    pthread_mutex_lock(&chunk_stats_mutex_g);
+    chunk_stats_g.encode_sec += PDC_get_elapsed_time_double(&start, &end);
+    pthread_mutex_unlock(&chunk_stats_mutex_g);
+}
+
+static void
+chunk_job_run(pdc_chunk_job_t *job)
+{
+    uint64_t i;
+
+    while ((i = __atomic_fetch_add(&job->next_task, 1, __ATOMIC_RELAXED)) < job->ntask) {
+        job->func(job->req, &job->req->tasks[i]);
+        __atomic_fetch_add(&job->ndone, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void *
+chunk_worker(void *arg)
+{
+    pdc_chunk_job_t *job;
+
+    (void)arg;
+    pthread_mutex_lock(&chunk_pool_mutex_g);
+    while (1) {
+        DL_FOREACH(chunk_jobs_g, job)
+        {
+            if (__atomic_load_n(&job->next_task, __ATOMIC_RELAXED) < job->ntask)
+                break;
+        }
+        if (job == NULL) {
+            if (!chunk_running_g)
+                break;
+            pthread_cond_wait(&chunk_pool_cond_g, &chunk_pool_mutex_g);
+            continue;
+        }
+
+        job->nworker++;
+        pthread_mutex_unlock(&chunk_pool_mutex_g);
+        chunk_job_run(job);
+        pthread_mutex_lock(&chunk_pool_mutex_g);
+        job->nworker--;
+        pthread_cond_broadcast(&chunk_done_cond_g);
+    }
+    pthread_mutex_unlock(&chunk_pool_mutex_g);
+
+    return NULL;
+}
+
+// Run func on all tasks of a request with the chunk threads, the caller runs tasks too
+static void
+chunk_run(pdc_chunk_request_t *req, uint64_t ntask, pdc_chunk_func_t func)
+{
+    pdc_chunk_job_t job;
+
+    memset(&job, 0, sizeof(job));
+    job.func  = func;
+    job.req   = req;
+    job.ntask = ntask;
+
+    if (chunk_nworker_g > 0 && ntask > 1) {
+        pthread_mutex_lock(&chunk_pool_mutex_g);
+        DL_APPEND(chunk_jobs_g, &job);
+        pthread_cond_broadcast(&chunk_pool_cond_g);
+        pthread_mutex_unlock(&chunk_pool_mutex_g);
+    }
+
+    chunk_job_run(&job);
+
+    if (chunk_nworker_g > 0 && ntask > 1) {
+        pthread_mutex_lock(&chunk_pool_mutex_g);
+        while (__atomic_load_n(&job.ndone, __ATOMIC_ACQUIRE) < job.ntask || job.nworker > 0)
+            pthread_cond_wait(&chunk_done_cond_g, &chunk_pool_mutex_g);
+        DL_DELETE(chunk_jobs_g, &job);
+        pthread_mutex_unlock(&chunk_pool_mutex_g);
+    }
+}
+
+// Append the encoded chunks to the data file and point the index at them, the write lock must be held
+static perr_t
+chunk_commit(pdc_chunk_obj_t *obj, pdc_chunk_task_t *tasks, uint64_t ntask)
+{
+    pdc_chunk_entry_t *entry;
+    uint64_t           i, raw_bytes = 0, stored_bytes = 0;
+    perr_t             ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    for (i = 0; i < ntask; i++) {
+        if (chunk_pwrite(obj->data_fd, tasks[i].data, tasks[i].csize, obj->data_end) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write chunk data of object %" PRIu64,
+                        pdc_server_rank_g, obj->obj_id);
+        entry         = &obj->index[tasks[i].idx];
+        entry->offset = obj->data_end;
+        entry->csize  = tasks[i].csize;
+        entry->codec  = tasks[i].codec;
+        if (chunk_pwrite(obj->index_fd, entry, sizeof(pdc_chunk_entry_t),
+                         sizeof(pdc_chunk_header_t) + tasks[i].idx * sizeof(pdc_chunk_entry_t)) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write chunk index of object %" PRIu64,
+                        pdc_server_rank_g, obj->obj_id);
+        obj->data_end += tasks[i].csize;
+        raw_bytes += chunk_task_size(obj, &tasks[i]);
+        stored_bytes += tasks[i].csize;
+    }
+
+done:
+    pthread_mutex_lock(&chunk_stats_mutex_g);
+    chunk_stats_g.nchunk_write += i;
+    chunk_stats_g.raw_bytes += raw_bytes;
+    chunk_stats_g.stored_bytes += stored_bytes;
+    pthread_mutex_unlock(&chunk_stats_mutex_g);
+    FUNC_LEAVE(ret_value);
+}
+
+// Set up the tasks of the chunks a request touches, returns the number of tasks or 0 if out of memory
+static uint64_t
+chunk_plan(pdc_chunk_request_t *req)
+{
+    pdc_chunk_obj_t * obj = req->obj;
+    pdc_chunk_task_t *task;
+    uint64_t          lo[3], hi[3], ntask = 1, i, j, k;
+    int               d;
+
+    for (d = 0; d < 3; d++) {
+        lo[d] = req->offset[d] / obj->header.chunk_dims[d];
+        hi[d] = (req->offset[d] + req->size[d] - 1) / obj->header.chunk_dims[d];
+        ntask *= hi[d] - lo[d] + 1;
+    }
+    req->tasks = (pdc_chunk_task_t *)calloc(ntask, sizeof(pdc_chunk_task_t));
+    if (req->tasks == NULL)
+        return 0;
+    task = req->tasks;
+    for (i = lo[0]; i <= hi[0]; i++) {
+        for (j = lo[1]; j <= hi[1]; j++) {
+            for (k = lo[2]; k <= hi[2]; k++) {
+                task->idx      = (i * obj->nchunk[1] + j) * obj->nchunk[2] + k;
+                task->start[0] = i * obj->header.chunk_dims[0];
+                task->start[1] = j * obj->header.chunk_dims[1];
+                task->start[2] = k * obj->header.chunk_dims[2];
+                for (d = 0; d < 3; d++) {
+                    task->count[d] = obj->header.chunk_dims[d];
+                    if (task->start[d] + task->count[d] > obj->header.dims[d])
+                        task->count[d] = obj->header.dims[d] - task->start[d];
+                }
+                task++;
+            }
+        }
+    }
+
+    return ntask;
+}
+
+/*
+ * Move an object to the chunk layout of new dims, the write lock must be held. Each new chunk is read
+ * from the old chunks it overlaps and appended to the data file, then a new index replaces the old one.
+ * Data outside the new dims is dropped. A new unit size drops all data, the old elements cannot be
+ * converted.
+ */
+static perr_t
+chunk_obj_resize(pdc_chunk_obj_t *obj, const uint64_t *dims, size_t unit)
+{
+    perr_t              ret_value = SUCCEED;
+    pdc_chunk_header_t  header;
+    pdc_chunk_entry_t * index = NULL;
+    pdc_chunk_request_t req;
+    pdc_chunk_task_t    task;
+    uint64_t            nchunk[3], coord[3], nentry = 1, max_size = unit, size, idx, ntask, i;
+    size_t              csize;
+    char                path[ADDR_MAX], tmp_path[ADDR_MAX + 4];
+    char *              raw = NULL, *tmp = NULL, *enc = NULL, *buf = NULL;
+    int                 fd = -1, d, codec, written;
+
+    FUNC_ENTER(NULL);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PDC_CHUNK_MAGIC, sizeof(header.magic));
+    header.unit = unit;
+    for (d = 0; d < 3; d++)
+        header.dims[d] = dims[d];
+    chunk_set_dims(&header);
+    for (d = 0; d < 3; d++) {
+        nchunk[d] = (header.dims[d] + header.chunk_dims[d] - 1) / header.chunk_dims[d];
+        nentry *= nchunk[d];
+        max_size *= header.chunk_dims[d];
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.obj = obj;
+    index   = (pdc_chunk_entry_t *)calloc(nentry, sizeof(pdc_chunk_entry_t));
+    raw     = (char *)malloc(max_size);
+    tmp     = (char *)malloc(max_size);
+    enc     = (char *)malloc(max_size);
+    req.buf = buf = (char *)malloc(max_size);
+    if (index == NULL || raw == NULL || tmp == NULL || enc == NULL || buf == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate the new chunks of object %" PRIu64,
+                    pdc_server_rank_g, obj->obj_id);
+
+    for (idx = 0; idx < nentry && obj->header.unit == unit; idx++) {
+        coord[2] = idx % nchunk[2];
+        coord[1] = idx / nchunk[2] % nchunk[1];
+        coord[0] = idx / nchunk[2] / nchunk[1];
+        memset(&task, 0, sizeof(task));
+        size = unit;
+        for (d = 0; d < 3; d++) {
+            task.start[d] = coord[d] * header.chunk_dims[d];
+            task.count[d] = header.chunk_dims[d];
+            if (task.start[d] + task.count[d] > header.dims[d])
+                task.count[d] = header.dims[d] - task.start[d];
+            size *= task.count[d];
+            // The part of the new chunk inside the old dims
+            req.offset[d] = task.start[d];
+            req.size[d]   = 0;
+            if (task.start[d] < obj->header.dims[d])
+                req.size[d] = obj->header.dims[d] - task.start[d];
+            if (req.size[d] > task.count[d])
+                req.size[d] = task.count[d];
+        }
+        if (req.size[0] == 0 || req.size[1] == 0 || req.size[2] == 0)
+            continue;
+
+        ntask = chunk_plan(&req);
+        if (ntask == 0)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate chunk tasks", pdc_server_rank_g);
+        written = 0;
+        for (i = 0; i < ntask; i++) {
+            if (obj->index[req.tasks[i].idx].csize != 0)
+                written = 1;
+        }
+        if (written) {
+            chunk_run(&req, ntask, chunk_read_task);
+            for (i = 0; i < ntask; i++) {
+                if (req.tasks[i].ret != SUCCEED)
+                    ret_value = FAIL;
+            }
+        }
+        free(req.tasks);
+        req.tasks = NULL;
+        if (ret_value != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot read the chunks of object %" PRIu64,
+                        pdc_server_rank_g, obj->obj_id);
+        // Chunks that were never written stay unwritten
+        if (!written)
+            continue;
+
+        memset(raw, 0, size);
+        chunk_copy(&req, &task, raw, 1);
+        codec = PDC_codec_encode(PDC_CODEC_SHUFFLE_LZ, raw, size, unit, enc, tmp, &csize);
+        if (chunk_pwrite(obj->data_fd, enc, csize, obj->data_end) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write chunk data of object %" PRIu64,
+                        pdc_server_rank_g, obj->obj_id);
+        index[idx].offset = obj->data_end;
+        index[idx].csize  = csize;
+        index[idx].codec  = codec;
+        obj->data_end += csize;
+    }
+
+    // Write the new index next to the old one and rename it over, a crash keeps the old layout
+    chunk_obj_path(obj->obj_id, "idx", path);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0 || chunk_pwrite(fd, &header, sizeof(header), 0) != SUCCEED ||
+        chunk_pwrite(fd, index, nentry * sizeof(pdc_chunk_entry_t), sizeof(header)) != SUCCEED ||
+        fsync(fd) != 0 || rename(tmp_path, path) != 0)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write chunk index [%s]", pdc_server_rank_g, tmp_path);
+
+    close(obj->index_fd);
+    obj->index_fd = fd;
+    fd            = -1;
+    obj->header   = header;
+    for (d = 0; d < 3; d++)
+        obj->nchunk[d] = nchunk[d];
+    free(obj->index);
+    obj->index = index;
+    index      = NULL;
+
+done:
+    if (fd >= 0) {
+        close(fd);
+        unlink(tmp_path);
+    }
+    free(index);
+    free(raw);
+    free(tmp);
+    free(enc);
+    free(buf);
+    FUNC_LEAVE(ret_value);
+}
+
+static pdc_chunk_obj_t *
+chunk_obj_get(uint64_t obj_id, const uint64_t *dims, size_t unit)
+{
+    pdc_chunk_obj_t *obj;
+
+    pthread_mutex_lock(&chunk_obj_mutex_g);
+    obj = (pdc_chunk_obj_t *)hash_table_lookup(chunk_obj_table_g, &obj_id);
+    if (obj == NULL) {
+        obj = chunk_obj_open(obj_id, dims, unit);
+        if (obj != NULL && hash_table_insert(chunk_obj_table_g, &obj->obj_id, obj) != 1) {
+            chunk_obj_free(obj);
+            obj = NULL;
+        }
+    }
+    pthread_mutex_unlock(&chunk_obj_mutex_g);
+
+    return obj;
+}
+
+perr_t
+PDC_Server_chunk_init()
+{
+    perr_t ret_value = SUCCEED;
+    char * p;
+    int    i;
+
+    FUNC_ENTER(NULL);
+
+    p = getenv("PDC_CHUNK_STORAGE");
+    if (p == NULL || atoi(p) == 0)
+        PGOTO_DONE(SUCCEED);
+    p = getenv("PDC_CHUNK_SIZE");
+    if (p != NULL && strtoull(p, NULL, 10) > 0)
+        chunk_size_g = strtoull(p, NULL, 10);
+    chunk_nworker_g = PDC_CHUNK_NTHREAD_DEFAULT;
+    p               = getenv("PDC_CHUNK_NTHREAD");
+    if (p != NULL && atoi(p) >= 0)
+        chunk_nworker_g = atoi(p);
+
+    memset(&chunk_stats_g, 0, sizeof(pdc_chunk_stats_t));
+    pthread_mutex_init(&chunk_obj_mutex_g, NULL);
+    pthread_mutex_init(&chunk_stats_mutex_g, NULL);
+    pthread_mutex_init(&chunk_pool_mutex_g, NULL);
+    pthread_cond_init(&chunk_pool_cond_g, NULL);
+    pthread_cond_init(&chunk_done_cond_g, NULL);
+
+    chunk_obj_table_g = hash_table_new(chunk_obj_hash, chunk_obj_equal);
+    if (chunk_obj_table_g == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: error creating chunk object table", pdc_server_rank_g);
+    // Keys point into their values, only free the values
+    hash_table_register_free_functions(chunk_obj_table_g, NULL, chunk_obj_free);
+
+    chunk_running_g = 1;
+    if (chunk_nworker_g > 0) {
+        chunk_workers_g = (pthread_t *)calloc(chunk_nworker_g, sizeof(pthread_t));
+        for (i = 0; i < chunk_nworker_g; i++) {
+            if (pthread_create(&chunk_workers_g[i], NULL, chunk_worker, NULL) != 0) {
+                chunk_nworker_g = i;
+                break;
+            }
+        }
+    }
+    chunk_enabled_g = 1;
+
+    if (pdc_server_rank_g == 0)
+        printf("==PDC_SERVER[0]: chunked storage on, chunk size %" PRIu64 " bytes, %d threads\n",
+               chunk_size_g, chunk_nworker_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_chunk_finalize()
+{
+    int i;
+
+    FUNC_ENTER(NULL);
+
+    if (!chunk_enabled_g)
+        FUNC_LEAVE(SUCCEED);
+
+    pthread_mutex_lock(&chunk_pool_mutex_g);
+    chunk_running_g = 0;
+    pthread_cond_broadcast(&chunk_pool_cond_g);
+    pthread_mutex_unlock(&chunk_pool_mutex_g);
+    for (i = 0; i < chunk_nworker_g; i++)
+        pthread_join(chunk_workers_g[i], NULL);
+    free(chunk_workers_g);
+    chunk_workers_g = NULL;
+    chunk_nworker_g = 0;
+
+    if (chunk_stats_g.nchunk_write > 0)
+        PDC_LOG_INFO("chunked storage wrote %" PRIu64 " chunks, %.1f MB in %.1f MB, ratio %.2f",
+                     chunk_stats_g.nchunk_write, chunk_stats_g.raw_bytes / 1048576.0,
+                     chunk_stats_g.stored_bytes / 1048576.0,
+                     (double)chunk_stats_g.raw_bytes / chunk_stats_g.stored_bytes);
+
+    pthread_mutex_lock(&chunk_obj_mutex_g);
+    hash_table_free(chunk_obj_table_g);
+    chunk_obj_table_g = NULL;
+    chunk_enabled_g   = 0;
+    pthread_mutex_unlock(&chunk_obj_mutex_g);
+
+    pthread_mutex_destroy(&chunk_obj_mutex_g);
+    pthread_mutex_destroy(&chunk_stats_mutex_g);
+    pthread_mutex_destroy(&chunk_pool_mutex_g);
+    pthread_cond_destroy(&chunk_pool_cond_g);
+    pthread_cond_destroy(&chunk_done_cond_g);
+
+    FUNC_LEAVE(SUCCEED);
+}
+
+int
+PDC_Server_chunk_enabled(int ndim, const uint64_t *dims)
+{
+    int d;
+
+    if (!chunk_enabled_g || ndim < 1 || ndim > 3 || dims == NULL)
+        return 0;
+    for (d = 0; d < ndim; d++) {
+        if (dims[d] == 0)
+            return 0;
+    }
+    return 1;
+}
+
+int
+PDC_Server_chunk_has_obj(uint64_t obj_id)
+{
+    char path[ADDR_MAX];
+    int  ret_value;
+
+    if (!chunk_enabled_g)
+        return 0;
+    pthread_mutex_lock(&chunk_obj_mutex_g);
+    ret_value = hash_table_lookup(chunk_obj_table_g, &obj_id) != NULL;
+    pthread_mutex_unlock(&chunk_obj_mutex_g);
+    if (!ret_value) {
+        chunk_obj_path(obj_id, "idx", path);
+        ret_value = access(path, F_OK) == 0;
+    }
+
+    return ret_value;
+}
+
+perr_t
+PDC_Server_chunk_io(uint64_t obj_id, int ndim, const uint64_t *dims, struct pdc_region_info *region_info,
+                    void *buf, size_t unit, int is_write)
+{
+    perr_t              ret_value = SUCCEED;
+    pdc_chunk_obj_t *   obj;
+    pdc_chunk_request_t req;
+    uint64_t            obj_dims[3], ntask, i;
+    int                 d, pad = 3 - ndim;
+
+    FUNC_ENTER(NULL);
+
+    if ((int)region_info->ndim != ndim)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: region ndim %zu does not match object ndim %d",
+                    pdc_server_rank_g, region_info->ndim, ndim);
+
+    memset(&req, 0, sizeof(req));
+    req.buf = (char *)buf;
+    for (d = 0; d < 3; d++) {
+        obj_dims[d]   = d < pad ? 1 : dims[d - pad];
+        req.offset[d] = d < pad ? 0 : region_info->offset[d - pad];
+        req.size[d]   = d < pad ? 1 : region_info->size[d - pad];
+        if (req.size[d] == 0)
+            PGOTO_DONE(SUCCEED);
+        if (req.offset[d] + req.size[d] > obj_dims[d])
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: region is outside object %" PRIu64, pdc_server_rank_g,
+                        obj_id);
+    }
+
+    obj = chunk_obj_get(obj_id, obj_dims, unit);
+    if (obj == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot open chunks of object %" PRIu64, pdc_server_rank_g,
+                    obj_id);
+    req.obj = obj;
+
+    // Resize the object if it was written with other dims or unit, then check again under the request lock
+    while (1) {
+        if (is_write)
+            pthread_rwlock_wrlock(&obj->rwlock);
+        else
+            pthread_rwlock_rdlock(&obj->rwlock);
+        if (chunk_obj_match(obj, obj_dims, unit))
+            break;
+        pthread_rwlock_unlock(&obj->rwlock);
+
+        pthread_rwlock_wrlock(&obj->rwlock);
+        if (!chunk_obj_match(obj, obj_dims, unit))
+            ret_value = chunk_obj_resize(obj, obj_dims, unit);
+        pthread_rwlock_unlock(&obj->rwlock);
+        if (ret_value != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot resize chunks of object %" PRIu64, pdc_server_rank_g,
+                        obj_id);
+    }
+
+    ntask = chunk_plan(&req);
+    if (ntask == 0) {
+        pthread_rwlock_unlock(&obj->rwlock);
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate chunk tasks", pdc_server_rank_g);
+    }
+
+    if (is_write) {
+        chunk_run(&req, ntask, chunk_write_task);
+        for (i = 0; i < ntask; i++) {
+            if (req.tasks[i].ret != SUCCEED)
+                ret_value = FAIL;
+        }
+        if (ret_value == SUCCEED)
+            ret_value = chunk_commit(obj, req.tasks, ntask);
+        pthread_rwlock_unlock(&obj->rwlock);
+        for (i = 0; i < ntask; i++)
+            free(req.tasks[i].data);
+    }
+    else {
+        chunk_run(&req, ntask, chunk_read_task);
+        pthread_rwlock_unlock(&obj->rwlock);
+        for (i = 0; i < ntask; i++) {
+            if (req.tasks[i].ret != SUCCEED)
+                ret_value = FAIL;
+        }
+    }
+    free(req.tasks);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+void
+PDC_Server_chunk_get_stats(pdc_chunk_stats_t *stats)
+{
+    if (!chunk_enabled_g) {
+        memset(stats, 0, sizeof(pdc_chunk_stats_t));
+        return;
+    }
+    pthread_mutex_lock(&chunk_stats_mutex_g);
+    *stats = chunk_stats_g;
+    pthread_mutex_unlock(&chunk_stats_mutex_g);
+}
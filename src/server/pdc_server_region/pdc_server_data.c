@@ -37,6 +37,7 @@
 #include <math.h>
 #include <sys/shm.h>
 #include <sys/mman.h>
+#include <pthread.h>
 
 #include "pdc_config.h"
 
@@ -55,10 +56,16 @@
 #include "pdc_hist_pkg.h"
 #include "pdc_timing.h"
 #include "pdc_region.h"
+#include "pdc_server_query_cache.h"
+#include "pdc_server_read_cache.h"
+#include "pdc_hash-table.h"
 
 // Global object region info list in local data server
 data_server_region_t *      dataserver_region_g     = NULL;
 data_server_region_unmap_t *dataserver_region_unmap = NULL;
+// Index of dataserver_region_g by object ID, keys point to the obj_id of each region struct
+static HashTable *      obj_region_table_g        = NULL;
+static pthread_rwlock_t obj_region_table_rwlock_g = PTHREAD_RWLOCK_INITIALIZER;
 
 int pdc_buffered_bulk_update_total_g = 0;
 int pdc_nbuffered_bulk_update_g      = 0;
@@ -169,7 +176,6 @@ PDC_Server_set_lustre_stripe(const char *path, int stripe_count, int stripe_size
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -228,9 +234,7 @@ PDC_Server_local_region_lock_status(PDC_mapping_info_t *mapped_region, int *lock
     PDC_region_transfer_t_to_list_t(&(mapped_region->remote_region), request_region);
     res_meta = find_metadata_by_id(mapped_region->remote_obj_id);
     if (res_meta == NULL || res_meta->region_lock_head == NULL) {
-        printf("==PDC_SERVER[%d]: PDC_Server_region_lock_status - metadata/region_lock is NULL!\n",
-               pdc_server_rank_g);
-        fflush(stdout);
+        PDC_LOG_ERROR("%s - metadata/region_lock is NULL", __func__);
         ret_value = FAIL;
         goto done;
     }
@@ -272,8 +276,7 @@ PDC_Server_region_lock_status(PDC_mapping_info_t *mapped_region, int *lock_statu
         PDC_Server_local_region_lock_status(mapped_region, lock_status);
     }
     else {
-        printf("lock is located in a different server, work not finished yet\n");
-        fflush(stdout);
+        PDC_LOG_WARNING("%s - lock is located in a different server, work not finished yet", __func__);
     }
 
     FUNC_LEAVE(ret_value);
@@ -283,18 +286,56 @@ data_server_region_t *
 PDC_Server_get_obj_region(pdcid_t obj_id)
 {
     data_server_region_t *ret_value = NULL;
-    data_server_region_t *elt       = NULL;
 
     FUNC_ENTER(NULL);
 
-    if (dataserver_region_g != NULL) {
-        DL_FOREACH(dataserver_region_g, elt)
-        {
-            if (elt->obj_id == obj_id)
-                ret_value = elt;
+    pthread_rwlock_rdlock(&obj_region_table_rwlock_g);
+    if (obj_region_table_g != NULL)
+        ret_value = (data_server_region_t *)hash_table_lookup(obj_region_table_g, &obj_id);
+    pthread_rwlock_unlock(&obj_region_table_rwlock_g);
+
+    FUNC_LEAVE(ret_value);
+}
+
+static unsigned int
+PDC_Server_obj_region_hash(void *key)
+{
+    uint64_t obj_id = *((uint64_t *)key);
+
+    return (unsigned int)(obj_id ^ (obj_id >> 32));
+}
+
+static int
+PDC_Server_obj_region_equal(void *key1, void *key2)
+{
+    return *((uint64_t *)key1) == *((uint64_t *)key2);
+}
+
+perr_t
+PDC_Server_add_obj_region(data_server_region_t *new_obj_reg)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+
+    pthread_rwlock_wrlock(&obj_region_table_rwlock_g);
+    if (obj_region_table_g == NULL) {
+        obj_region_table_g = hash_table_new(PDC_Server_obj_region_hash, PDC_Server_obj_region_equal);
+        if (obj_region_table_g == NULL) {
+            pthread_rwlock_unlock(&obj_region_table_rwlock_g);
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: failed to create object region table", pdc_server_rank_g);
         }
     }
+    DL_APPEND(dataserver_region_g, new_obj_reg);
+    // A region struct added again for the same object replaces the old one in lookups, as the list walk did
+    if (hash_table_insert(obj_region_table_g, &new_obj_reg->obj_id, new_obj_reg) != 1)
+        ret_value = FAIL;
+    pthread_rwlock_unlock(&obj_region_table_rwlock_g);
+    if (ret_value != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: failed to index object %" PRIu64, pdc_server_rank_g,
+                    new_obj_reg->obj_id);
 
+done:
     FUNC_LEAVE(ret_value);
 }
 
@@ -306,6 +347,12 @@ PDC_Server_clear_obj_region()
     region_list_t *       elt2, *tmp2;
 
     FUNC_ENTER(NULL);
+    pthread_rwlock_wrlock(&obj_region_table_rwlock_g);
+    if (obj_region_table_g != NULL) {
+        hash_table_free(obj_region_table_g);
+        obj_region_table_g = NULL;
+    }
+    pthread_rwlock_unlock(&obj_region_table_rwlock_g);
     if (dataserver_region_g != NULL) {
         DL_FOREACH_SAFE(dataserver_region_g, elt, tmp)
         {
@@ -314,6 +361,7 @@ PDC_Server_clear_obj_region()
                 // DL_DELETE(elt->region_storage_head, elt2);
                 free(elt2);
             }
+            PDC_interval_tree_destroy(&elt->region_storage_tree, NULL);
             free(elt->storage_location);
             free(elt);
         }
@@ -321,6 +369,81 @@ PDC_Server_clear_obj_region()
     FUNC_LEAVE(ret_value);
 }
 
+perr_t
+PDC_Server_add_storage_region(data_server_region_t *region, region_list_t *storage_region)
+{
+    perr_t ret_value = SUCCEED;
+
+    FUNC_ENTER(NULL);
+    DL_APPEND(region->region_storage_head, storage_region);
+    if (PDC_interval_tree_insert(&region->region_storage_tree, storage_region->start[0],
+                                 storage_region->start[0] + storage_region->count[0], storage_region) < 0)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: failed to index storage region", pdc_server_rank_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+typedef struct storage_region_overlap_args {
+    int             ndim;
+    uint64_t *      offset;
+    uint64_t *      size;
+    region_list_t **regions;
+    int             n_regions;
+    int             n_alloc;
+} storage_region_overlap_args;
+
+static int
+storage_region_overlap_cb(void *data, void *arg)
+{
+    region_list_t *              storage_region = (region_list_t *)data;
+    storage_region_overlap_args *args           = (storage_region_overlap_args *)arg;
+
+    if (!check_overlap(args->ndim, args->offset, args->size, storage_region->start, storage_region->count))
+        return 0;
+    if (args->n_regions == args->n_alloc) {
+        args->n_alloc = args->n_alloc ? args->n_alloc * 2 : 8;
+        args->regions = (region_list_t **)realloc(args->regions, sizeof(region_list_t *) * args->n_alloc);
+    }
+    args->regions[args->n_regions++] = storage_region;
+    return 0;
+}
+
+// Storage regions are appended to the end of the file, so their file offsets follow the write order
+static int
+storage_region_offset_cmp(const void *a, const void *b)
+{
+    const region_list_t *r1 = *(region_list_t *const *)a;
+    const region_list_t *r2 = *(region_list_t *const *)b;
+
+    return r1->offset < r2->offset ? -1 : (r1->offset > r2->offset);
+}
+
+perr_t
+PDC_Server_get_overlap_storage_regions(data_server_region_t *region, int ndim, uint64_t *offset,
+                                       uint64_t *size, region_list_t ***overlap_regions, int *n_overlap)
+{
+    perr_t                      ret_value = SUCCEED;
+    storage_region_overlap_args args;
+
+    FUNC_ENTER(NULL);
+    args.ndim      = ndim;
+    args.offset    = offset;
+    args.size      = size;
+    args.regions   = NULL;
+    args.n_regions = 0;
+    args.n_alloc   = 0;
+    PDC_interval_tree_query_overlap(&region->region_storage_tree, offset[0], offset[0] + size[0],
+                                    storage_region_overlap_cb, &args);
+    if (args.n_regions > 1)
+        qsort(args.regions, args.n_regions, sizeof(region_list_t *), storage_region_offset_cmp);
+
+    *overlap_regions = args.regions;
+    *n_overlap       = args.n_regions;
+
+    FUNC_LEAVE(ret_value);
+}
+
 perr_t
 PDC_Server_register_obj_region_by_pointer(data_server_region_t **new_obj_reg_ptr, pdcid_t obj_id,
                                           int close_flag)
@@ -340,6 +463,7 @@ PDC_Server_register_obj_region_by_pointer(data_server_region_t **new_obj_reg_ptr
         new_obj_reg->region_buf_map_head      = NULL;
         new_obj_reg->region_lock_request_head = NULL;
         new_obj_reg->region_storage_head      = NULL;
+        PDC_interval_tree_init(&new_obj_reg->region_storage_tree);
         new_obj_reg->close_flag               = close_flag;
         new_obj_reg->storage_location         = (char *)malloc(sizeof(char) * ADDR_MAX);
 
@@ -347,7 +471,7 @@ PDC_Server_register_obj_region_by_pointer(data_server_region_t **new_obj_reg_ptr
         if (new_obj_reg->fd < 0) {
             goto done;
         }
-        DL_APPEND(dataserver_region_g, new_obj_reg);
+        PDC_Server_add_obj_region(new_obj_reg);
     }
     else {
         if (new_obj_reg->fd == -1) {
@@ -471,7 +595,8 @@ PDC_Data_Server_region_lock(region_lock_in_t *in, region_lock_out_t *out, hg_han
         new_obj_reg->region_buf_map_head      = NULL;
         new_obj_reg->region_lock_request_head = NULL;
         new_obj_reg->region_storage_head      = NULL;
-        DL_APPEND(dataserver_region_g, new_obj_reg);
+        PDC_interval_tree_init(&new_obj_reg->region_storage_tree);
+        PDC_Server_add_obj_region(new_obj_reg);
     }
 #ifdef ENABLE_MULTITHREAD
     hg_thread_mutex_unlock(&region_struct_mutex_g);
@@ -574,7 +699,6 @@ PDC_Server_release_lock_request(uint64_t obj_id, struct pdc_region_info *region)
     free(request_region);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -1010,7 +1134,6 @@ PDC_Server_buf_unmap_lookup_server_id(int remote_server_id, struct transfer_buf_
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         HG_Free_input(handle, &(transfer_args->in));
         HG_Destroy(handle);
@@ -1152,6 +1275,7 @@ perr_t register_data_server_region (pdcid_t obj_id) {
         new_obj_reg->region_buf_map_head      = NULL;
         new_obj_reg->region_lock_request_head = NULL;
         new_obj_reg->region_storage_head      = NULL;
+        PDC_interval_tree_init(&new_obj_reg->region_storage_tree);
 
         // Generate a location for data storage for data server to write
         user_specified_data_path = getenv("PDC_DATA_LOC");
@@ -1229,6 +1353,7 @@ PDC_Data_Server_buf_map(const struct hg_info *info, buf_map_in_t *in, region_lis
         new_obj_reg->region_buf_map_head      = NULL;
         new_obj_reg->region_lock_request_head = NULL;
         new_obj_reg->region_storage_head      = NULL;
+        PDC_interval_tree_init(&new_obj_reg->region_storage_tree);
 
         new_obj_reg->fd = server_open_storage(storage_location, in->remote_obj_id);
         // Generate a location for data storage for data server to write
@@ -1264,7 +1389,7 @@ PDC_Data_Server_buf_map(const struct hg_info *info, buf_map_in_t *in, region_lis
             goto done;
         }
         new_obj_reg->storage_location = strdup(storage_location);
-        DL_APPEND(dataserver_region_g, new_obj_reg);
+        PDC_Server_add_obj_region(new_obj_reg);
     }
 #ifdef ENABLE_MULTITHREAD
     hg_thread_mutex_unlock(&region_struct_mutex_g);
@@ -1395,18 +1520,14 @@ void *
 PDC_Server_maybe_allocate_region_buf_ptr(pdcid_t obj_id, region_info_transfer_t region, size_t type_size)
 {
     void *                ret_value  = NULL;
-    data_server_region_t *target_obj = NULL, *elt = NULL;
+    data_server_region_t *target_obj = NULL;
     region_buf_map_t *    tmp;
 
     FUNC_ENTER(NULL);
 
     if (dataserver_region_g == NULL)
         PGOTO_ERROR(NULL, "===PDC SERVER: PDC_Server_get_region_buf_ptr() - object list is NULL");
-    DL_FOREACH(dataserver_region_g, elt)
-    {
-        if (obj_id == elt->obj_id)
-            target_obj = elt;
-    }
+    target_obj = PDC_Server_get_obj_region(obj_id);
     if (target_obj == NULL)
         PGOTO_ERROR(NULL, "===PDC SERVER: PDC_Server_get_region_buf_ptr() - cannot locate object");
 
@@ -1456,18 +1577,14 @@ void *
 PDC_Server_get_region_buf_ptr(pdcid_t obj_id, region_info_transfer_t region)
 {
     void *                ret_value  = NULL;
-    data_server_region_t *target_obj = NULL, *elt = NULL;
+    data_server_region_t *target_obj = NULL;
     region_buf_map_t *    tmp;
 
     FUNC_ENTER(NULL);
 
     if (dataserver_region_g == NULL)
         PGOTO_ERROR(NULL, "===PDC SERVER: PDC_Server_get_region_buf_ptr() - object list is NULL");
-    DL_FOREACH(dataserver_region_g, elt)
-    {
-        if (obj_id == elt->obj_id)
-            target_obj = elt;
-    }
+    target_obj = PDC_Server_get_obj_region(obj_id);
     if (target_obj == NULL)
         PGOTO_ERROR(NULL, "===PDC SERVER: PDC_Server_get_region_buf_ptr() - cannot locate object");
 
@@ -1595,7 +1712,6 @@ PDC_Server_buf_map_lookup_server_id(int remote_server_id, struct transfer_buf_ma
     }
 
 done:
-    fflush(stdout);
     if (error == 1) {
         HG_Free_input(handle, &(transfer_args->in));
         HG_Destroy(handle);
@@ -1830,7 +1946,6 @@ static perr_t PDC_Server_merge_region_list_naive(region_list_t *list, region_lis
     ret_value = SUCCEED;
 
 done:
-    fflush(stdout);
     free(is_merged);
     FUNC_LEAVE(ret_value);
 }
@@ -1976,7 +2091,6 @@ PDC_Server_close_shm(region_list_t *region, int is_remove)
     total_mem_cache_size_mb_g -= (region->data_size / 1048576);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2081,7 +2195,6 @@ static perr_t PDC_Server_notify_io_complete_to_client(uint32_t client_id, uint64
     }
 
 done:
-    fflush(stdout);
     hg_ret = HG_Destroy(notify_io_complete_handle);
     if (hg_ret != HG_SUCCESS)
         printf("==PDC_SERVER[%d]: %s - HG_Destroy failed\n", pdc_server_rank_g, __func__);
@@ -2209,7 +2322,6 @@ PDC_Server_notify_client_multi_io_complete(uint32_t client_id, int client_seq_id
     }
 
 done:
-    fflush(stdout);
     HG_Destroy(rpc_handle);
 
     FUNC_LEAVE(ret_value);
@@ -2316,7 +2428,6 @@ PDC_Server_cache_region_to_BB(region_list_t *region)
     region->is_io_done    = 0;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2425,7 +2536,6 @@ PDC_Server_read_check(data_server_read_check_in_t *in, server_read_check_out_t *
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2496,7 +2606,6 @@ PDC_Server_write_check(data_server_write_check_in_t *in, data_server_write_check
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2532,7 +2641,6 @@ PDC_Server_data_read_to_shm(region_list_t *region_list_head)
     ret_value = SUCCEED;
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2682,7 +2790,6 @@ done:
 
     if (write_ret)
         free(write_ret);
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -2748,10 +2855,8 @@ PDC_Server_get_storage_location_of_region_mpi(region_list_t *regions_head)
             // nrequest_per_server should be less than PDC_SERVER_MAX_PROC_PER_NODE
             // and should be the same across all servers.
             if (nrequest_per_server > PDC_SERVER_MAX_PROC_PER_NODE) {
-                printf("==PDC_SERVER[%d]: %s - more requests than expected! "
-                       "Increase PDC_SERVER_MAX_PROC_PER_NODE!\n",
-                       pdc_server_rank_g, __func__);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - more requests than expected! Increase PDC_SERVER_MAX_PROC_PER_NODE",
+                              __func__);
             }
             else {
                 // After saninty check, add the current request to gather send buffer
@@ -2819,11 +2924,9 @@ PDC_Server_get_storage_location_of_region_mpi(region_list_t *regions_head)
             }
 
             if (overlap_cnt > PDC_MAX_OVERLAP_REGION_NUM) {
-                printf("==PDC_SERVER[%d]: %s - found %d storage locations than PDC_MAX_OVERLAP_REGION_NUM!\n",
-                       pdc_server_rank_g, __func__, overlap_cnt);
+                PDC_LOG_WARNING("%s - found %d storage locations than PDC_MAX_OVERLAP_REGION_NUM", __func__,
+                                overlap_cnt);
                 overlap_cnt = PDC_MAX_OVERLAP_REGION_NUM;
-
-                fflush(stdout);
             }
 
             // Record how many overlap regions for each request
@@ -2919,7 +3022,6 @@ done:
     if (request_overlap_cnt)
         free(request_overlap_cnt);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -2960,8 +3062,6 @@ PDC_Server_regions_io(region_list_t *region_list_head, _pdc_io_plugin_t plugin)
 #endif
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -3026,8 +3126,6 @@ PDC_Server_data_write_from_shm(region_list_t *region_list_head)
     }
 
 done:
-    fflush(stdout);
-
     // TODO: keep the shared memory for now and close them later?
     DL_FOREACH(region_list_head, region_elt)
     {
@@ -3035,7 +3133,6 @@ done:
             ret_value = PDC_Server_close_shm(region_elt, 1);
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3078,11 +3175,10 @@ PDC_Server_data_io_via_shm(const struct hg_cb_info *callback_info)
         buffer_read_request_num_g++;
     }
     else {
-        printf("==PDC_SERVER: PDC_Server_data_io_via_shm - invalid IO type received from client!\n");
+        PDC_LOG_ERROR("%s - invalid IO type received from client", __func__);
         ret_value = FAIL;
         goto done;
     }
-    fflush(stdout);
 
 #ifdef ENABLE_MULTITHREAD
     if (io_info->io_type == PDC_WRITE)
@@ -3163,7 +3259,6 @@ PDC_Server_data_io_via_shm(const struct hg_cb_info *callback_info)
         printf("==PDC_SERVER[%d]: received %d/%d data %s requests of [%s]\n", pdc_server_rank_g,
                io_list_target->count, io_list_target->total, io_info->io_type == PDC_READ ? "read" : "write",
                io_info->meta.obj_name);
-        fflush(stdout);
     }
 
     int has_read_cache = 0;
@@ -3210,7 +3305,6 @@ PDC_Server_data_io_via_shm(const struct hg_cb_info *callback_info)
         if (is_debug_g) {
             printf("==PDC_SERVER[%d]: received all %d requests, starts writing.\n", pdc_server_rank_g,
                    buffer_write_request_total_g);
-            fflush(stdout);
         }
 
         // Perform IO for all requests in each io_list (of unique obj_id)
@@ -3322,7 +3416,6 @@ PDC_Server_data_io_via_shm(const struct hg_cb_info *callback_info)
 #endif
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3343,6 +3436,9 @@ PDC_Server_update_local_region_storage_loc(region_list_t *region, uint64_t obj_i
         goto done;
     }
 
+    // Storage regions of this object changed, cached query results are stale
+    PDC_Server_query_cache_invalidate(obj_id);
+
     // Find object metadata
     target_meta = find_metadata_by_id(obj_id);
     if (target_meta == NULL) {
@@ -3400,8 +3496,6 @@ PDC_Server_update_local_region_storage_loc(region_list_t *region, uint64_t obj_i
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -3506,7 +3600,6 @@ PDC_Server_update_region_storagelocation_offset(region_list_t *region, int type)
         if (is_debug_g == 1) {
             printf("==PDC_SERVER[%d]: Sending updated region loc to server %d\n", pdc_server_rank_g,
                    server_id);
-            fflush(stdout);
         }
 
         in.obj_id           = region->meta->obj_id;
@@ -3540,8 +3633,6 @@ PDC_Server_update_region_storagelocation_offset(region_list_t *region, int type)
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -3697,9 +3788,7 @@ PDC_Server_update_region_storage_meta_bulk_local(update_region_storage_meta_bulk
                     region_elt->offset = new_region->offset;
                     update_success     = 1;
 
-                    printf("==PDC_SERVER[%d]: overwrite existing region location/offset\n",
-                           pdc_server_rank_g);
-                    fflush(stdout);
+                    PDC_LOG_DEBUG("%s - overwrite existing region location/offset", __func__);
                     free(new_region);
                     break;
                 }
@@ -3733,9 +3822,7 @@ update_storage_meta_bulk_rpc_cb(const struct hg_cb_info *callback_info)
 
     /* Get output parameters, 9999 corresponds to the one set in update_storage_meta_bulk_cb */
     if (bulk_rpc_ret.ret != 9999)
-        printf("==PDC_SERVER[%d]: update storage meta bulk rpc returned value error!\n", pdc_server_rank_g);
-
-    fflush(stdout);
+        PDC_LOG_ERROR("%s - update storage meta bulk rpc returned value error", __func__);
 
     ret = HG_Free_output(handle, &bulk_rpc_ret);
     if (ret != HG_SUCCESS) {
@@ -3814,7 +3901,6 @@ done:
 #else
     printf("%s - is not supposed to be called without MPI enabled!\n", __func__);
 #endif
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -3904,8 +3990,6 @@ PDC_Server_update_region_storage_meta_bulk_with_cb(bulk_xfer_data_t *          b
     } // end of else
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -4023,7 +4107,6 @@ all_select:
         if (is_debug_g) {
             printf("==PDC_SERVER[%d]: fseek + fread %" PRIu64 " bytes, %.2fs\n", pdc_server_rank_g,
                    read_bytes, region_read_time1);
-            fflush(stdout);
         }
 #endif
 
@@ -4109,8 +4192,6 @@ all_select:
     }
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -4184,9 +4265,8 @@ PDC_Server_read_one_region(region_list_t *read_region)
         }
 
         if (region_elt->storage_location[0] == 0) {
-            printf("==PDC_SERVER[%d]: empty overlapping storage location \n", pdc_server_rank_g);
+            PDC_LOG_WARNING("%s - empty overlapping storage location", __func__);
             PDC_print_storage_region_list(region_elt);
-            fflush(stdout);
             continue;
         }
 
@@ -4240,7 +4320,6 @@ PDC_Server_read_one_region(region_list_t *read_region)
     if (is_debug_g == 1) {
         printf("==PDC_SERVER[%d]: Read data total size %" PRIu64 ", fopen time: %.3f\n", pdc_server_rank_g,
                total_read_bytes, fopen_time);
-        fflush(stdout);
     }
 #endif
 
@@ -4254,7 +4333,6 @@ done:
         read_region->is_data_ready = 0;
         read_region->is_io_done    = 0;
     }
-    fflush(stdout);
 
     FUNC_LEAVE(ret_value);
 }
@@ -4461,14 +4539,12 @@ PDC_Server_posix_one_file_io(region_list_t *region_list_head)
                 if (is_debug_g == 1) {
                     printf("==PDC_SERVER[%d]: Read data total size %zu\n", pdc_server_rank_g,
                            total_read_bytes);
-                    fflush(stdout);
                 }
                 offset += total_read_bytes;
 
             } // end else read from storage
             if (is_debug_g == 1) {
                 printf("==PDC_SERVER[%d]: Read data total size %zu\n", pdc_server_rank_g, total_read_bytes);
-                fflush(stdout);
             }
             region_elt->is_data_ready = 1;
             region_elt->is_io_done    = 1;
@@ -4613,7 +4689,6 @@ done:
     if (ret_value != SUCCEED)
         region_elt->is_data_ready = -1;
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4678,7 +4753,6 @@ PDC_Server_data_io_direct(pdc_access_t io_type, uint64_t obj_id, struct pdc_regi
     // Need to get the metadata
     ret_value = PDC_Server_get_metadata_by_id_with_cb(obj_id, PDC_Server_regions_io, io_region);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -4727,6 +4801,9 @@ PDC_Server_data_write_out(uint64_t obj_id, struct pdc_region_info *region_info,
     uint64_t              i, j, pos;
     uint64_t *            overlap_offset, *overlap_size;
     char *                tmp_buf;
+    region_list_t **      overlap_regions = NULL;
+    int                   n_overlap, k;
+    uint64_t              metrics_start = PDC_metrics_now();
 #if 0
     size_t                total_write_size = 0, local_write_size;
     int is_overlap;
@@ -4736,6 +4813,8 @@ PDC_Server_data_write_out(uint64_t obj_id, struct pdc_region_info *region_info,
     double start = MPI_Wtime(), start_posix;
 #endif
 
+    PDC_Server_query_cache_invalidate(obj_id);
+
     uint64_t write_size;
     if (region_info->ndim >= 1)
         write_size = unit * region_info->size[0];
@@ -4762,17 +4841,18 @@ PDC_Server_data_write_out(uint64_t obj_id, struct pdc_region_info *region_info,
 #endif
 
     // Detect overwrite
-    region_list_t *elt;
-
-    DL_FOREACH(region->region_storage_head, elt)
-    {
-        overlap_region = elt;
+    PDC_Server_get_overlap_storage_regions(region, region_info->ndim, region_info->offset, region_info->size,
+                                           &overlap_regions, &n_overlap);
+    for (k = 0; k < n_overlap; k++) {
+        overlap_region = overlap_regions[k];
         PDC_region_overlap_detect(region_info->ndim, region_info->offset, region_info->size,
                                   overlap_region->start, overlap_region->count, &overlap_offset,
                                   &overlap_size);
 
         if (overlap_offset) {
             // is_overlap = 1;
+            PDC_Server_read_cache_invalidate(region->storage_location, overlap_region->offset,
+                                             overlap_region->data_size);
             if (!is_contained &&
                 detect_region_contained(region_info->offset, region_info->size, overlap_region->start,
                                         overlap_region->count, region_info->ndim)) {
@@ -5027,7 +5107,7 @@ PDC_Server_data_write_out(uint64_t obj_id, struct pdc_region_info *region_info,
 
         // Store storage information
         request_region->data_size = write_size;
-        DL_APPEND(region->region_storage_head, request_region);
+        PDC_Server_add_storage_region(region, request_region);
         PDC_Server_unregister_obj_region_by_pointer(region, 0);
     }
     else {
@@ -5038,17 +5118,16 @@ PDC_Server_data_write_out(uint64_t obj_id, struct pdc_region_info *region_info,
 #ifdef ENABLE_TIMING
     gettimeofday(&pdc_timer_end, 0);
     write_total_sec = PDC_get_elapsed_time_double(&pdc_timer_start, &pdc_timer_end);
-    printf("==PDC_SERVER[%d]: write region time: %.4f, %llu bytes\n", pdc_server_rank_g, write_total_sec,
-           write_size);
-    fflush(stdout);
+    PDC_LOG_DEBUG("write region time: %.4f, %llu bytes", write_total_sec, write_size);
 #endif
 
 #ifdef PDC_TIMING
     pdc_server_timings->PDCdata_server_write_out += MPI_Wtime() - start;
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_DATA_WRITE_OUT, metrics_start, write_size);
     /* printf("==PDC_SERVER[%d]: write region %llu bytes\n", pdc_server_rank_g, request_region->data_size); */
 done:
-    fflush(stdout);
+    free(overlap_regions);
     FUNC_LEAVE(ret_value);
 } // End PDC_Server_data_write_out
 
@@ -5059,10 +5138,13 @@ PDC_Server_data_read_from(uint64_t obj_id, struct pdc_region_info *region_info,
     perr_t                ret_value     = SUCCEED;
     ssize_t               request_bytes = unit;
     data_server_region_t *region        = NULL;
-    region_list_t *       elt;
     uint64_t              i, j, pos;
     uint64_t *            overlap_offset, *overlap_size;
     char *                tmp_buf;
+    void *                cache_handle;
+    region_list_t **      overlap_regions = NULL;
+    int                   n_overlap, k;
+    uint64_t              metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -5092,14 +5174,28 @@ PDC_Server_data_read_from(uint64_t obj_id, struct pdc_region_info *region_info,
 
     region_list_t *overlap_region = NULL;
 
-    DL_FOREACH(region->region_storage_head, elt)
-    {
-        overlap_region = elt;
+    PDC_Server_get_overlap_storage_regions(region, region_info->ndim, region_info->offset, region_info->size,
+                                           &overlap_regions, &n_overlap);
+    for (k = 0; k < n_overlap; k++) {
+        overlap_region = overlap_regions[k];
         PDC_region_overlap_detect(region_info->ndim, region_info->offset, region_info->size,
                                   overlap_region->start, overlap_region->count, &overlap_offset,
                                   &overlap_size);
 
         if (overlap_offset) {
+            // Copy from the read cache when the whole storage region fits in it
+            tmp_buf = (char *)PDC_Server_read_cache_acquire(region->storage_location, region->fd,
+                                                            overlap_region->offset, overlap_region->data_size,
+                                                            &cache_handle);
+            if (tmp_buf != NULL) {
+                memcpy_overlap_subregion(region_info->ndim, unit, tmp_buf, overlap_region->start,
+                                         overlap_region->count, buf, region_info->offset, region_info->size,
+                                         overlap_offset, overlap_size);
+                PDC_Server_read_cache_release(cache_handle);
+                free(overlap_offset);
+                continue;
+            }
+
             if (region_info->ndim == 1) {
                 // 1D can overwrite data in region directly
                 pos = (overlap_offset[0] - overlap_region->start[0]) * unit;
@@ -5112,8 +5208,10 @@ PDC_Server_data_read_from(uint64_t obj_id, struct pdc_region_info *region_info,
 #ifdef PDC_TIMING
                 start_posix = MPI_Wtime();
 #endif
-                printf("POSIX read from file offset %lu, region start = %lu, region size = %lu\n",
-                       overlap_region->offset, overlap_region->start[0], overlap_region->count[0]);
+                PDC_LOG_DEBUG("%s - POSIX read from file offset %" PRIu64 ", region start = %" PRIu64
+                              ", region size = %" PRIu64,
+                              __func__, overlap_region->offset, overlap_region->start[0],
+                              overlap_region->count[0]);
                 if (pread(region->fd, buf + (overlap_offset[0] - region_info->offset[0]) * unit,
                           overlap_size[0] * unit,
                           overlap_region->offset + pos) != (ssize_t)(overlap_size[0] * unit)) {
@@ -5311,17 +5409,16 @@ PDC_Server_data_read_from(uint64_t obj_id, struct pdc_region_info *region_info,
 #ifdef ENABLE_TIMING
     gettimeofday(&pdc_timer_end, 0);
     read_total_sec = PDC_get_elapsed_time_double(&pdc_timer_start, &pdc_timer_end);
-    printf("==PDC_SERVER[%d]: read region time: %.4f, %llu bytes\n", pdc_server_rank_g, read_total_sec,
-           total_read_bytes);
-    fflush(stdout);
+    PDC_LOG_DEBUG("read region time: %.4f, %llu bytes", read_total_sec, total_read_bytes);
 #endif
 
 #ifdef PDC_TIMING
     pdc_server_timings->PDCdata_server_read_from += MPI_Wtime() - start;
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_DATA_READ_FROM, metrics_start, request_bytes);
 
 done:
-    fflush(stdout);
+    free(overlap_regions);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5340,7 +5437,6 @@ PDC_Server_data_write_direct(uint64_t obj_id, struct pdc_region_info *region_inf
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5359,7 +5455,6 @@ PDC_Server_data_read_direct(uint64_t obj_id, struct pdc_region_info *region_info
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5406,7 +5501,6 @@ PDC_Server_get_local_storage_meta_with_one_name(storage_meta_query_one_name_args
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5451,7 +5545,6 @@ PDC_Server_get_all_storage_meta_with_one_name(storage_meta_query_one_name_args_t
         if (is_debug_g == 1) {
             printf("==PDC_SERVER[%d]: %s - will get storage meta from remote server %d\n", pdc_server_rank_g,
                    __func__, server_id);
-            fflush(stdout);
         }
 
         if (PDC_Server_lookup_server_id(server_id) != SUCCEED) {
@@ -5485,7 +5578,6 @@ PDC_Server_get_all_storage_meta_with_one_name(storage_meta_query_one_name_args_t
     } // end else
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5569,10 +5661,8 @@ PDC_Server_accumulate_storage_meta_then_read(storage_meta_query_one_name_args_t
 #ifdef ENABLE_TIMING
         gettimeofday(&pdc_timer_end, 0);
         read_total_sec = PDC_get_elapsed_time_double(&pdc_timer_start, &pdc_timer_end);
-        printf("==PDC_SERVER[%d]: read %d objects time: %.4f, n_fread: %d, n_fopen: %d, is_sort_read: %d\n",
-               pdc_server_rank_g, accu_meta->n_accumulated, read_total_sec, n_fread_g, n_fopen_g,
-               is_sort_read);
-        fflush(stdout);
+        PDC_LOG_DEBUG("read %d objects time: %.4f, n_fread: %d, n_fopen: %d, is_sort_read: %d",
+                      accu_meta->n_accumulated, read_total_sec, n_fread_g, n_fopen_g, is_sort_read);
 #endif
 
         // send all shm info to client
@@ -5581,7 +5671,6 @@ PDC_Server_accumulate_storage_meta_then_read(storage_meta_query_one_name_args_t
     } // End if
 
     // TODO free many things
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5629,7 +5718,6 @@ PDC_Server_query_read_names(query_read_names_args_t *query_read_args)
     // When all storage metadata have been collected, the read operation will be triggered
     // in PDC_Server_accumulate_storage_meta_then_read().
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5775,7 +5863,6 @@ PDC_Server_storage_meta_name_query_bulk_respond(const struct hg_cb_info *callbac
     }
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(hg_ret);
 }
 
@@ -5813,8 +5900,6 @@ PDC_Server_proc_storage_meta_bulk(int task_id, int n_regions, region_list_t *reg
     PDC_del_task_from_list(&pdc_server_s2s_task_head_g, task, &pdc_server_task_mutex_g);
 
 done:
-    fflush(stdout);
-
     FUNC_LEAVE(ret_value);
 }
 
@@ -5891,7 +5976,6 @@ done:
 #ifdef ENABLE_MULTITHREAD
     hg_thread_mutex_unlock(&data_read_list_mutex_g);
 #endif
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -5940,7 +6024,7 @@ PDC_Server_data_read_to_buf_1_region(region_list_t *region)
     uint64_t offset, read_bytes;
     FILE *   fp_read = NULL;
 
-    if (region->is_data_ready == 1)
+    if (region->is_data_ready == 1 && region->buf != NULL)
         return SUCCEED;
 
     fp_read = fopen(region->storage_location, "rb");
@@ -5982,6 +6066,25 @@ done:
     return ret_value;
 }
 
+// Get the data of a storage region, from the read cache unless the region keeps its own buffer. *handle is
+// set when the buffer is from the read cache and must be released with PDC_Server_read_cache_release.
+static char *
+PDC_Server_get_region_buf(region_list_t *region, void **handle)
+{
+    char *buf;
+
+    *handle = NULL;
+    if (region->buf != NULL)
+        return region->buf;
+
+    buf = (char *)PDC_Server_read_cache_acquire(region->storage_location, -1, region->offset,
+                                                region->data_size, handle);
+    if (buf == NULL && PDC_Server_data_read_to_buf_1_region(region) == SUCCEED)
+        buf = region->buf;
+
+    return buf;
+}
+
 static perr_t
 PDC_Server_data_read_to_buf(region_list_t *region_list_head)
 {
@@ -5989,7 +6092,8 @@ PDC_Server_data_read_to_buf(region_list_t *region_list_head)
     region_list_t *region_elt;
     char *         prev_path = NULL;
     uint64_t       offset, read_bytes;
-    FILE *         fp_read = NULL;
+    FILE *         fp_read      = NULL;
+    void *         cache_handle = NULL;
 
     int read_count = 0;
 
@@ -6004,6 +6108,16 @@ PDC_Server_data_read_to_buf(region_list_t *region_list_head)
         if (region_elt->is_data_ready == 1)
             continue;
 
+        // Load the region to the read cache, only regions too large for it keep their own buffer
+        if (PDC_Server_read_cache_acquire(region_elt->storage_location, -1, region_elt->offset,
+                                          region_elt->data_size, &cache_handle) != NULL) {
+            PDC_Server_read_cache_release(cache_handle);
+            read_count++;
+            region_elt->is_data_ready = 1;
+            region_elt->is_io_done    = 1;
+            continue;
+        }
+
         if (prev_path == NULL || strcmp(region_elt->storage_location, prev_path) != 0) {
             if (fp_read != NULL)
                 fclose(fp_read);
@@ -6048,14 +6162,13 @@ PDC_Server_data_read_to_buf(region_list_t *region_list_head)
     double read_time = PDC_get_elapsed_time_double(&pdc_timer_start1, &pdc_timer_end1);
     server_read_time_g += read_time;
     if (region_list_head != NULL) {
-        printf("==PDC_SERVER[%d]: %s finished reading obj %" PRIu64 " of %d regions, %.2f seconds!\n",
-               pdc_server_rank_g, __func__, region_list_head->obj_id, read_count, read_time);
+        PDC_LOG_DEBUG("%s - finished reading obj %" PRIu64 " of %d regions, %.2f seconds", __func__,
+                      region_list_head->obj_id, read_count, read_time);
     }
     else
-        printf("==PDC_SERVER[%d]: %s no regions have been read!\n", pdc_server_rank_g, __func__);
+        PDC_LOG_DEBUG("%s - no regions have been read", __func__);
 #endif
 
-    fflush(stdout);
     return ret_value;
 }
 
@@ -6354,8 +6467,7 @@ PDC_Server_load_query_data(query_task_t *task, pdc_query_t *query, pdc_query_com
         if (gen_hist_g == 1) {
 
             if (req_region->region_hist->nbin == 0) {
-                printf("==PDC_SERVER[%d]: %s -  ERROR histogram is empty!\n", pdc_server_rank_g, __func__);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - histogram is empty", __func__);
             }
 
             if (PDC_region_has_hits_from_hist(constraint, req_region->region_hist) == 0) {
@@ -6418,7 +6530,6 @@ PDC_Server_load_query_data(query_task_t *task, pdc_query_t *query, pdc_query_com
     }
 
 done:
-    fflush(stdout);
     return ret_value;
 }
 
@@ -6494,23 +6605,30 @@ is_coord_within_region(int ndim, uint64_t *coords, region_list_t *region_constra
     return 1;
 }
 
+// Check if element idx of a region is inside the constraint, the first dimension varies fastest and the
+// constraint end is exclusive so that adjacent constraints do not select the same element twice
 static int
 is_idx_within_region(uint64_t idx, region_list_t *region, region_list_t *region_constraint, int unit_size)
 {
     size_t   i, ndim;
-    uint64_t coord[DIM_MAX];
+    uint64_t coord, count;
 
     if (region == NULL || region_constraint == NULL)
         return -1;
 
     ndim = region->ndim;
-    region_index_to_coord(ndim, idx, region->count, (uint64_t *)&coord);
-
     for (i = 0; i < ndim; i++) {
-        coord[i] *= unit_size;
-        coord[i] += region->start[i];
-        if (coord[i] < region_constraint->start[i] ||
-            coord[i] > region_constraint->start[i] + region_constraint->count[i]) {
+        count = region->count[i] / unit_size;
+        if (i < ndim - 1 && count > 0) {
+            coord = idx % count;
+            idx /= count;
+        }
+        else
+            coord = idx;
+
+        coord = coord * unit_size + region->start[i];
+        if (coord < region_constraint->start[i] ||
+            coord >= region_constraint->start[i] + region_constraint->count[i]) {
             return -1;
         }
     }
@@ -7261,9 +7379,10 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
     uint64_t         ui64lo = 0, ui64hi = 0;
     void *           value = NULL, *buf = NULL;
     int              n_eval_region = 0, can_skip, region_iter = 0;
+    pdc_histogram_t *obj_hist     = NULL;
+    void *           cache_handle = NULL;
 
-    printf("==PDC_SERVER[%d]: %s - start query evaluation!\n", pdc_server_rank_g, __func__);
-    fflush(stdout);
+    PDC_LOG_DEBUG("%s - start query evaluation", __func__);
 
 #ifdef ENABLE_TIMING
     struct timeval pdc_timer_start, pdc_timer_end;
@@ -7273,14 +7392,14 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
 
     // query is guarenteed to be non-leaf nodes
     if (query == NULL) {
-        printf("==PDC_SERVER[%d]: %s - input query NULL!\n", pdc_server_rank_g, __func__);
+        PDC_LOG_ERROR("%s - input query NULL", __func__);
         goto done;
     }
 
     // Need to go through each region for query evaluation, so get region head
     region_list_head = (region_list_t *)query->constraint->storage_region_list_head;
     if (NULL == region_list_head) {
-        printf("==PDC_SERVER[%d]: %s - error with storage_region_list_head!\n", pdc_server_rank_g, __func__);
+        PDC_LOG_ERROR("%s - error with storage_region_list_head", __func__);
         ret_value = FAIL;
         goto done;
     }
@@ -7291,7 +7410,7 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
 
     ndim = task->ndim;
     if (ndim <= 0 || ndim > 3) {
-        printf("==PDC_SERVER[%d]: %s - error with ndim = %d!\n", pdc_server_rank_g, __func__, ndim);
+        PDC_LOG_ERROR("%s - error with ndim = %d", __func__, ndim);
         ret_value = FAIL;
         goto done;
     }
@@ -7384,7 +7503,7 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
                 ui64hi = (uint64_t)query->constraint->value2;
                 break;
             default:
-                printf("==PDC_SERVER[%d]: %s - error with operator type!\n", pdc_server_rank_g, __func__);
+                PDC_LOG_ERROR("%s - error with operator type", __func__);
                 ret_value = FAIL;
                 goto done;
         } // End switch
@@ -7397,6 +7516,23 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
         value = &(query->constraint->value);
     }
 
+    // Skip the whole object if its aggregated histogram shows there is no hit
+    if (gen_hist_g == 1) {
+        obj_hist = PDC_Server_query_cache_get_hist(query->constraint->obj_id, region_list_head);
+        if (obj_hist != NULL && PDC_region_has_hits_from_hist(query->constraint, obj_hist) == 0) {
+            if (combine_op == PDC_QUERY_AND && sel->nhits > 0) {
+                sel->nhits = 0;
+                free(sel->coords);
+                sel->coords_alloc = 0;
+                sel->coords       = NULL;
+            }
+            PDC_free_hist(obj_hist);
+            goto done;
+        }
+        if (obj_hist != NULL)
+            PDC_free_hist(obj_hist);
+    }
+
     DL_COUNT(region_list_head, region_elt, count);
     if (use_fastbit_idx_g == 1) {
 #ifdef ENABLE_FASTBIT
@@ -7448,8 +7584,7 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
             uint64_t idx_nhits = 0, *idx_coords = NULL, tmp_coord[DIM_MAX];
             PDC_query_fastbit_idx(region_elt, query->constraint, &idx_nhits, &idx_coords);
             if (idx_nhits > region_elt->data_size / unit_size) {
-                printf("==PDC_SERVER[%d]: %s - idx_nhits = %" PRIu64 " may be too large!\n",
-                       pdc_server_rank_g, __func__, idx_nhits);
+                PDC_LOG_WARNING("%s - idx_nhits = %" PRIu64 " may be too large", __func__, idx_nhits);
             }
 
             if (idx_nhits > 0) {
@@ -7468,8 +7603,8 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
                     for (j = 0; j < ndim; j++) {
                         tmp = (sel->nhits + iter) * ndim + j;
                         if (tmp > sel->coords_alloc) {
-                            printf("==PDC_SERVER[%d]: %s - coord array overflow %" PRIu64 "/ %" PRIu64 "!\n",
-                                   pdc_server_rank_g, __func__, tmp, sel->coords_alloc);
+                            PDC_LOG_WARNING("%s - coord array overflow %" PRIu64 "/ %" PRIu64, __func__, tmp,
+                                            sel->coords_alloc);
                         }
                         else
                             sel->coords[tmp] = tmp_coord[j] + region_elt->start[j] / unit_size;
@@ -7487,8 +7622,7 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
     } // End if use fastbit
     else {
         // Load data
-        printf("==PDC_SERVER[%d]: %s - start loading data!\n", pdc_server_rank_g, __func__);
-        fflush(stdout);
+        PDC_LOG_DEBUG("%s - start loading data", __func__);
         PDC_Server_load_query_data(task, query, combine_op);
 
         region_iter = -1;
@@ -7544,13 +7678,19 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
                 }
             }
 
+            buf = PDC_Server_get_region_buf(cache_region, &cache_handle);
+            if (buf == NULL)
+                continue;
+
 #ifdef ENABLE_FASTBIT
             if (gen_fastbit_idx_g == 1) {
+                cache_region->buf = buf;
                 PDC_gen_fastbit_idx(cache_region, query->constraint->type);
+                if (cache_handle != NULL)
+                    cache_region->buf = NULL;
             }
 #endif
 
-            buf   = cache_region->buf;
             nelem = cache_region->count[0];
             for (i = 1; i < cache_region->ndim; i++)
                 nelem *= cache_region->count[i];
@@ -7624,11 +7764,13 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
                     }
                     break;
                 default:
-                    printf("==PDC_SERVER[%d]: %s - error with operator type!\n", pdc_server_rank_g, __func__);
+                    PDC_LOG_ERROR("%s - error with operator type", __func__);
                     ret_value = FAIL;
                     goto done;
             } // End switch
 
+            PDC_Server_read_cache_release(cache_handle);
+            cache_handle = NULL;
             n_eval_region++;
         } // End DL_FOREACH
     }     // End not use fastbit
@@ -7676,21 +7818,19 @@ PDC_Server_query_evaluate_merge_opt(pdc_query_t *query, query_task_t *task, pdc_
     if (pdc_server_rank_g == 0 || pdc_server_rank_g == 1) {
         gettimeofday(&pdc_timer_end1, 0);
         double rm_dup_time = PDC_get_elapsed_time_double(&pdc_timer_start1, &pdc_timer_end1);
-        printf("==PDC_SERVER[%d]: remove duplicate time %.4fs\n", pdc_server_rank_g, rm_dup_time);
+        PDC_LOG_INFO("remove duplicate time %.4fs", rm_dup_time);
     }
 #endif
 
 done:
+    PDC_Server_read_cache_release(cache_handle);
 #ifdef ENABLE_TIMING
     gettimeofday(&pdc_timer_end, 0);
     double query_eval_time = PDC_get_elapsed_time_double(&pdc_timer_start, &pdc_timer_end);
-    printf("==PDC_SERVER[%d]: evaluated %d regions of %" PRIu64 ": %" PRIu64 "/ %" PRIu64
-           " hits, time %.4fs\n",
-           pdc_server_rank_g, n_eval_region, query->constraint->obj_id, sel->nhits, task->total_elem,
-           query_eval_time);
+    PDC_LOG_INFO("evaluated %d regions of %" PRIu64 ": %" PRIu64 "/ %" PRIu64 " hits, time %.4fs",
+                 n_eval_region, query->constraint->obj_id, sel->nhits, task->total_elem, query_eval_time);
 #endif
 
-    fflush(stdout);
     return ret_value;
 }
 
@@ -7915,10 +8055,7 @@ PDC_Server_send_nhits_to_client(query_task_t *task)
     in.nhits    = task->nhits;
     in.query_id = task->query_id;
 
-    printf("==PDC_SERVER[%d]: %s - sending %" PRIu64 " nhits to client!\n", pdc_server_rank_g, __func__,
-           in.nhits);
-
-    fflush(stdout);
+    PDC_LOG_DEBUG("%s - sending %" PRIu64 " nhits to client", __func__, in.nhits);
 
     hg_ret = HG_Forward(handle, PDC_check_int_ret_cb, NULL, &in);
     if (hg_ret != HG_SUCCESS) {
@@ -7963,60 +8100,281 @@ PDC_recv_nhits(const struct hg_cb_info *callback_info)
     return ret;
 }
 
+static perr_t PDC_Server_query_batch_next(query_batch_t *batch);
+
+// Grow the bounding box of a streamed query by the storage regions of a query leaf, in elements
+static void
+PDC_Server_query_stream_bound(pdc_query_t *query, void *arg)
+{
+    query_task_t * task = (query_task_t *)arg;
+    region_list_t *region_head, *region_elt;
+    uint64_t       lo, hi;
+    size_t         unit_size;
+    int            i;
+
+    if (query == NULL || query->constraint == NULL)
+        return;
+
+    unit_size   = PDC_get_var_type_size(query->constraint->type);
+    region_head = (region_list_t *)query->constraint->storage_region_list_head;
+    DL_FOREACH(region_head, region_elt)
+    {
+        if (task->ndim <= 0 || task->ndim > 3)
+            task->ndim = region_elt->ndim;
+        if (task->stream_step == 0)
+            task->stream_step = region_elt->count[task->ndim - 1] / unit_size;
+
+        for (i = 0; i < task->ndim; i++) {
+            lo = region_elt->start[i] / unit_size;
+            hi = lo + region_elt->count[i] / unit_size;
+            if (lo < task->stream_lo[i])
+                task->stream_lo[i] = lo;
+            if (hi > task->stream_hi[i])
+                task->stream_hi[i] = hi;
+        }
+    }
+}
+
+/*
+ * Set up the evaluation of a streamed selection. The bounding box of the queried storage regions, limited
+ * by the region constraint of the query, is cut along its slowest dimension into slabs as thick as a
+ * storage region, each slab is evaluated when the batches of the previous one have been sent.
+ *
+ * \param  task [IN]            Query task
+ *
+ * \return Non-negative on success/Negative on failure
+ */
 static perr_t
-PDC_Server_send_coords_to_client(query_task_t *task)
+PDC_Server_query_stream_init(query_task_t *task)
 {
-    perr_t        ret_value = SUCCEED;
-    hg_return_t   hg_ret;
-    hg_handle_t   handle;
-    hg_bulk_t     bulk_handle;
-    bulk_rpc_in_t in;
-    hg_size_t     buf_sizes;
-    void *        buf;
-    int           client_id;
+    perr_t         ret_value  = SUCCEED;
+    region_list_t *constraint = task->region_constraint;
+    int            i, last, is_empty = 0;
 
     FUNC_ENTER(NULL);
 
-    client_id = task->client_id;
-    if (client_id >= pdc_client_num_g) {
-        printf("==PDC_SERVER[%d]: %s - client_id %d invalid!\n", pdc_server_rank_g, __func__, client_id);
-        ret_value = FAIL;
-        goto done;
+    for (i = 0; i < DIM_MAX; i++) {
+        task->stream_lo[i] = UINT64_MAX;
+        task->stream_hi[i] = 0;
+    }
+    task->stream_step = 0;
+    PDC_query_visit_leaf_with_cb_arg(task->query, PDC_Server_query_stream_bound, task);
+    if (task->ndim <= 0 || task->ndim > 3) {
+        task->ndim = 1;
+        is_empty   = 1;
     }
 
-    if (pdc_client_info_g == NULL) {
-        fprintf(stderr, "==PDC_SERVER[%d]: %s - pdc_client_info_g is NULL\n", pdc_server_rank_g, __func__);
-        ret_value = FAIL;
-        goto done;
+    for (i = 0; i < task->ndim; i++) {
+        if (constraint != NULL && constraint->ndim > 0) {
+            if (constraint->start[i] > task->stream_lo[i])
+                task->stream_lo[i] = constraint->start[i];
+            if (constraint->start[i] + constraint->count[i] < task->stream_hi[i])
+                task->stream_hi[i] = constraint->start[i] + constraint->count[i];
+        }
+        if (task->stream_lo[i] >= task->stream_hi[i])
+            is_empty = 1;
     }
 
-    if (pdc_client_info_g[client_id].addr_valid == 0) {
-        ret_value = PDC_Server_lookup_client(client_id);
-        if (ret_value != SUCCEED) {
-            fprintf(stderr, "==PDC_SERVER[%d]: %s - PDC_Server_lookup_client failed!\n", pdc_server_rank_g,
-                    __func__);
-            ret_value = FAIL;
-            goto done;
+    last = task->ndim - 1;
+    if (is_empty == 1) {
+        task->stream_lo[last] = 0;
+        task->stream_hi[last] = 0;
+    }
+
+    // Fastbit hits are only filtered by region overlap, evaluate them in one slab to not select any twice
+    if (use_fastbit_idx_g == 1 || task->stream_step == 0)
+        task->stream_step = task->stream_hi[last] - task->stream_lo[last];
+    task->stream_next = task->stream_lo[last];
+
+    task->stream_window = (region_list_t *)calloc(1, sizeof(region_list_t));
+    if (task->stream_window == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: error allocating stream window", pdc_server_rank_g);
+    task->stream_window->ndim = task->ndim;
+
+    task->stream_constraint = task->region_constraint;
+    task->region_constraint = task->stream_window;
+    task->stream_closed     = 0;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+// Evaluate the query on the next slab that has hits, return the number of hits or 0 after the last slab
+static uint64_t
+PDC_Server_query_stream_next(query_task_t *task)
+{
+    pdc_selection_t *sel    = task->query->sel;
+    region_list_t *  window = task->stream_window;
+    int              i, last;
+
+    if (window == NULL)
+        return 0;
+
+    last = task->ndim - 1;
+    while (task->stream_next < task->stream_hi[last]) {
+        for (i = 0; i < last; i++) {
+            window->start[i] = task->stream_lo[i];
+            window->count[i] = task->stream_hi[i] - task->stream_lo[i];
+        }
+        window->start[last] = task->stream_next;
+        window->count[last] = task->stream_hi[last] - task->stream_next;
+        if (window->count[last] > task->stream_step)
+            window->count[last] = task->stream_step;
+        task->stream_next += window->count[last];
+
+        // The coords of the previous slab have been sent, AND without hits may have freed the buffer
+        sel->nhits = 0;
+        if (sel->coords == NULL || sel->coords_alloc == 0) {
+            sel->coords_alloc = 8192;
+            sel->coords       = (uint64_t *)calloc(sel->coords_alloc, sizeof(uint64_t));
+            if (sel->coords == NULL) {
+                PDC_LOG_ERROR("%s - error allocating coords", __func__);
+                return 0;
+            }
         }
+        if (task->invalid_region_ids != NULL) {
+            free(task->invalid_region_ids);
+            task->invalid_region_ids = NULL;
+            task->ninvalid_region    = 0;
+        }
+
+        PDC_query_visit(task->query, PDC_Server_query_evaluate_merge_opt, task, NULL, PDC_QUERY_NONE);
+        if (sel->nhits > 0)
+            return sel->nhits;
     }
 
-    if (pdc_server_size_g == 1) {
-        buf       = task->query->sel->coords;
-        buf_sizes = task->query->sel->nhits * sizeof(uint64_t) * task->ndim;
-        in.ndim   = task->ndim;
-        in.cnt    = task->query->sel->nhits;
+    return 0;
+}
+
+// Acknowledge a worker batch held by the manager, the worker sends its next batch after ret 1 and stops
+// after ret 0
+static void
+PDC_Server_query_relay_release(query_relay_t *relay, int ret)
+{
+    pdc_int_ret_t out;
+
+    out.ret = ret;
+    if (HG_Respond(relay->handle, NULL, NULL, &out) != HG_SUCCESS)
+        PDC_LOG_ERROR("%s - could not respond to worker batch", __func__);
+    HG_Destroy(relay->handle);
+    free(relay->coords);
+    free(relay);
+}
+
+// Free the state of a streamed selection: its slab, the coords of the last slab and the worker batches
+// that have not been relayed
+static void
+PDC_Server_query_stream_free(query_task_t *task)
+{
+    query_relay_t *relay, *relay_tmp;
+
+    if (task->stream_window != NULL) {
+        task->region_constraint = task->stream_constraint;
+        free(task->stream_window);
+        task->stream_window = NULL;
+    }
+
+    if (task->query && task->query->sel && task->query->sel->coords) {
+        free(task->query->sel->coords);
+        task->query->sel->coords       = NULL;
+        task->query->sel->coords_alloc = 0;
+        task->query->sel->nhits        = 0;
+    }
+
+    DL_FOREACH_SAFE(task->relay_head, relay, relay_tmp)
+    {
+        DL_DELETE(task->relay_head, relay);
+        PDC_Server_query_relay_release(relay, 0);
+    }
+
+    task->stream_batch  = NULL;
+    task->stream_closed = 1;
+}
+
+// Free a batch state after its last batch, abandoned is set when the receiver stopped the transfer
+static void
+PDC_Server_query_batch_free(query_batch_t *batch, int abandoned)
+{
+    if (batch->relay != NULL)
+        PDC_Server_query_relay_release(batch->relay, abandoned == 1 ? 0 : 1);
+    if (batch->task != NULL)
+        PDC_Server_query_stream_free(batch->task);
+    free(batch);
+}
+
+/*
+ * Send the next batch once the receiver acknowledged the previous one, so at most one batch of a
+ * query result is in flight per receiver
+ */
+static hg_return_t
+PDC_Server_send_query_batch_cb(const struct hg_cb_info *callback_info)
+{
+    hg_return_t    ret   = HG_SUCCESS;
+    query_batch_t *batch = (query_batch_t *)callback_info->arg;
+    hg_handle_t    handle;
+    pdc_int_ret_t  output;
+    int            abandoned = 0;
+
+    FUNC_ENTER(NULL);
+
+    handle = callback_info->info.forward.handle;
+    ret    = HG_Get_output(handle, &output);
+    if (ret != HG_SUCCESS) {
+        PDC_LOG_WARNING("%s - no response to query %d batch, stop sending", __func__, batch->query_id);
+        abandoned = 1;
     }
     else {
-        buf       = task->coords;
-        buf_sizes = task->nhits * sizeof(uint64_t) * task->ndim;
-        in.ndim   = task->ndim;
-        in.cnt    = task->nhits;
+        // The client answers 0 when it closed the query before reading all batches
+        if (output.ret != 1) {
+            PDC_LOG_DEBUG("%s - receiver stopped reading query %d batches", __func__, batch->query_id);
+            abandoned = 1;
+        }
+        HG_Free_output(handle, &output);
+    }
+
+    if (batch->bulk_handle != HG_BULK_NULL) {
+        HG_Bulk_free(batch->bulk_handle);
+        batch->bulk_handle = HG_BULK_NULL;
     }
 
+    batch->in_flight = 0;
+    if (abandoned == 1 || batch->is_last == 1)
+        PDC_Server_query_batch_free(batch, abandoned);
+    else if (PDC_Server_query_batch_next(batch) != SUCCEED)
+        PDC_Server_query_batch_free(batch, 1);
+
+    FUNC_LEAVE(ret);
+}
+
+/*
+ * Send the elements of batch->buf from batch->buf_off on, at most pdc_query_batch_nhits_g of them
+ *
+ * \param  batch [IN]           Batch state of the query result
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Server_send_query_batch(query_batch_t *batch)
+{
+    perr_t        ret_value = SUCCEED;
+    hg_return_t   hg_ret;
+    hg_handle_t   handle = NULL;
+    hg_addr_t     addr;
+    bulk_rpc_in_t in;
+    hg_size_t     buf_sizes;
+    void *        buf;
+
+    FUNC_ENTER(NULL);
+
+    in.cnt = batch->buf_nelem - batch->buf_off;
+    if (in.cnt > pdc_query_batch_nhits_g)
+        in.cnt = pdc_query_batch_nhits_g;
+
+    batch->bulk_handle = HG_BULK_NULL;
     if (in.cnt > 0) {
-        hg_ret = HG_Bulk_create(hg_class_g, 1, &buf, &buf_sizes, HG_BULK_READ_ONLY, &bulk_handle);
-        /* printf("==PDC_SERVER[%d]: %s - created bulk handle %p!\n", pdc_server_rank_g, __func__,
-         * bulk_handle); */
+        buf       = (char *)batch->buf + batch->buf_off * batch->elem_size;
+        buf_sizes = in.cnt * batch->elem_size;
+        hg_ret    = HG_Bulk_create(hg_class_g, 1, &buf, &buf_sizes, HG_BULK_READ_ONLY, &batch->bulk_handle);
         if (hg_ret != HG_SUCCESS) {
             fprintf(stderr, "Could not create bulk data handle\n");
             ret_value = FAIL;
@@ -8024,26 +8382,314 @@ PDC_Server_send_coords_to_client(query_task_t *task)
         }
     }
 
-    in.seq_id      = task->query_id;
+    // The total of a stream is only known with its final, empty batch
+    if (batch->mode == PDC_QUERY_BATCH_BUF) {
+        if (batch->offset + in.cnt >= batch->total)
+            batch->is_last = 1;
+        in.total = batch->total;
+    }
+    else
+        in.total = batch->is_last == 1 ? batch->offset : PDC_QUERY_BATCH_MORE;
+
+    in.ndim        = batch->ndim;
+    in.offset      = batch->offset;
+    in.seq_id      = batch->query_id;
+    in.seq_id2     = batch->client_seq_id;
     in.origin      = pdc_server_rank_g;
-    in.op_id       = PDC_BULK_QUERY_COORDS;
-    in.bulk_handle = bulk_handle;
+    in.op_id       = batch->op_id;
+    in.bulk_handle = batch->bulk_handle;
 
-    hg_ret = HG_Create(hg_context_g, pdc_client_info_g[client_id].addr, send_bulk_rpc_register_id_g, &handle);
+    if (batch->to_manager == 1)
+        addr = pdc_remote_server_info_g[batch->manager].addr;
+    else
+        addr = pdc_client_info_g[batch->client_id].addr;
+    hg_ret = HG_Create(hg_context_g, addr, send_bulk_rpc_register_id_g, &handle);
     if (hg_ret != HG_SUCCESS) {
         ret_value = FAIL;
         goto done;
     }
 
-    hg_ret = HG_Forward(handle, PDC_check_int_ret_cb, NULL, &in);
+    // Advance the cursor before forwarding, the callback may send the next batch
+    batch->buf_off += in.cnt;
+    batch->offset += in.cnt;
+    batch->in_flight = 1;
+
+    hg_ret = HG_Forward(handle, PDC_Server_send_query_batch_cb, batch, &in);
     if (hg_ret != HG_SUCCESS) {
         fprintf(stderr, "==PDC_SERVER[%d]: %s - HG_Forward failed!\n", pdc_server_rank_g, __func__);
+        batch->in_flight = 0;
+        ret_value        = FAIL;
+        goto done;
+    }
+
+done:
+    if (ret_value != SUCCEED && batch->bulk_handle != HG_BULK_NULL) {
+        HG_Bulk_free(batch->bulk_handle);
+        batch->bulk_handle = HG_BULK_NULL;
+    }
+    if (handle)
+        HG_Destroy(handle);
+
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Send the next batch of a query result. A streamed batch is refilled once its elements are sent, from
+ * the next slab with hits or, on the manager, from the next worker batch. The manager waits when no
+ * worker batch is queued and some workers have not finished.
+ *
+ * \param  batch [IN]           Batch state of the query result
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Server_query_batch_next(query_batch_t *batch)
+{
+    perr_t        ret_value = SUCCEED;
+    query_task_t *task      = batch->task;
+
+    FUNC_ENTER(NULL);
+
+    if (batch->mode != PDC_QUERY_BATCH_BUF && batch->buf_off >= batch->buf_nelem) {
+        batch->buf       = NULL;
+        batch->buf_off   = 0;
+        batch->buf_nelem = 0;
+
+        if (batch->mode == PDC_QUERY_BATCH_EVAL) {
+            batch->buf_nelem = PDC_Server_query_stream_next(task);
+            batch->buf       = task->query->sel->coords;
+        }
+        else {
+            // The relayed worker batch has been sent, let the worker send its next one
+            if (batch->relay != NULL) {
+                PDC_Server_query_relay_release(batch->relay, 1);
+                batch->relay = NULL;
+            }
+
+            if (task->relay_head != NULL) {
+                batch->relay = task->relay_head;
+                DL_DELETE(task->relay_head, batch->relay);
+                batch->buf       = batch->relay->coords;
+                batch->buf_nelem = batch->relay->nhits;
+            }
+            else if (task->n_recv < task->n_sent_server)
+                goto done;
+        }
+
+        if (batch->buf_nelem == 0)
+            batch->is_last = 1;
+    }
+
+    ret_value = PDC_Server_send_query_batch(batch);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Allocate the batch state of a query result sent to a client, or to the manager server
+ *
+ * \param  client_id [IN]       Client ID
+ * \param  manager [IN]         Manager server ID, negative to send to the client
+ * \param  op_id [IN]           Bulk op of the batches
+ * \param  ndim [IN]            Number of dimensions
+ * \param  elem_size [IN]       Size of each result element
+ * \param  query_id [IN]        Query ID
+ * \param  client_seq_id [IN]   Sequence ID used by the client to place the result
+ *
+ * \return Batch state on success/NULL on failure
+ */
+static query_batch_t *
+PDC_Server_query_batch_create(int client_id, int manager, int op_id, size_t ndim, size_t elem_size,
+                              int query_id, int client_seq_id)
+{
+    query_batch_t *batch = NULL;
+
+    FUNC_ENTER(NULL);
+
+    if (manager >= 0) {
+        if (manager >= pdc_server_size_g || pdc_remote_server_info_g == NULL) {
+            PDC_LOG_ERROR("%s - invalid manager server %d", __func__, manager);
+            goto done;
+        }
+        if (pdc_remote_server_info_g[manager].addr_valid == 0 &&
+            PDC_Server_lookup_server_id(manager) != SUCCEED) {
+            PDC_LOG_ERROR("%s - PDC_Server_lookup_server_id failed", __func__);
+            goto done;
+        }
+    }
+    else {
+        if (client_id >= pdc_client_num_g) {
+            printf("==PDC_SERVER[%d]: %s - client_id %d invalid!\n", pdc_server_rank_g, __func__, client_id);
+            goto done;
+        }
+
+        if (pdc_client_info_g == NULL) {
+            fprintf(stderr, "==PDC_SERVER[%d]: %s - pdc_client_info_g is NULL\n", pdc_server_rank_g,
+                    __func__);
+            goto done;
+        }
+
+        if (pdc_client_info_g[client_id].addr_valid == 0 && PDC_Server_lookup_client(client_id) != SUCCEED) {
+            fprintf(stderr, "==PDC_SERVER[%d]: %s - PDC_Server_lookup_client failed!\n", pdc_server_rank_g,
+                    __func__);
+            goto done;
+        }
+    }
+
+    batch = (query_batch_t *)calloc(1, sizeof(query_batch_t));
+    if (batch == NULL)
+        goto done;
+    batch->client_id     = client_id;
+    batch->to_manager    = manager >= 0 ? 1 : 0;
+    batch->manager       = manager;
+    batch->query_id      = query_id;
+    batch->client_seq_id = client_seq_id;
+    batch->op_id         = op_id;
+    batch->ndim          = ndim;
+    batch->elem_size     = elem_size;
+
+done:
+    FUNC_LEAVE(batch);
+}
+
+/*
+ * Start sending query results to a client in batches of pdc_query_batch_nhits_g elements
+ *
+ * \param  client_id [IN]       Client ID
+ * \param  op_id [IN]           PDC_BULK_QUERY_COORDS or PDC_BULK_SEND_QUERY_DATA
+ * \param  buf [IN]             Result buffer, must be valid until all batches are sent
+ * \param  ndim [IN]            Number of dimensions
+ * \param  elem_size [IN]       Size of each result element
+ * \param  count [IN]           Number of result elements
+ * \param  query_id [IN]        Query ID
+ * \param  client_seq_id [IN]   Sequence ID used by the client to place the result
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Server_send_query_result_batches(int client_id, int op_id, void *buf, size_t ndim, size_t elem_size,
+                                     uint64_t count, int query_id, int client_seq_id)
+{
+    perr_t         ret_value = SUCCEED;
+    query_batch_t *batch;
+
+    FUNC_ENTER(NULL);
+
+    batch = PDC_Server_query_batch_create(client_id, -1, op_id, ndim, elem_size, query_id, client_seq_id);
+    if (batch == NULL) {
         ret_value = FAIL;
         goto done;
     }
+    batch->mode      = PDC_QUERY_BATCH_BUF;
+    batch->total     = buf == NULL ? 0 : count;
+    batch->buf       = buf;
+    batch->buf_nelem = batch->total;
+
+    ret_value = PDC_Server_send_query_batch(batch);
+    if (ret_value != SUCCEED)
+        free(batch);
 
 done:
-    HG_Destroy(handle);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Start sending a streamed selection, to the client or, with several servers, to the manager that relays
+ * the batches of all workers
+ *
+ * \param  task [IN]            Query task set up by PDC_Server_query_stream_init
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+static perr_t
+PDC_Server_send_coords_stream(query_task_t *task)
+{
+    perr_t         ret_value = SUCCEED;
+    query_batch_t *batch;
+    int            manager = -1, op_id = PDC_BULK_QUERY_COORDS;
+
+    FUNC_ENTER(NULL);
+
+    if (pdc_server_size_g > 1) {
+        manager = task->manager;
+        op_id   = PDC_BULK_QUERY_COORDS_BATCH;
+    }
+
+    batch = PDC_Server_query_batch_create(task->client_id, manager, op_id, task->ndim,
+                                          task->ndim * sizeof(uint64_t), task->query_id, 0);
+    if (batch == NULL) {
+        PDC_Server_query_stream_free(task);
+        ret_value = FAIL;
+        goto done;
+    }
+    batch->mode        = PDC_QUERY_BATCH_EVAL;
+    batch->task        = task;
+    task->stream_batch = batch;
+
+    ret_value = PDC_Server_query_batch_next(batch);
+    if (ret_value != SUCCEED)
+        PDC_Server_query_batch_free(batch, 1);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+// Relay the queued worker batches of a streamed selection to the client, called when a worker batch
+// arrives and once the query of the client is known
+static perr_t
+PDC_Server_query_relay_progress(query_task_t *task)
+{
+    perr_t         ret_value = SUCCEED;
+    query_batch_t *batch;
+
+    FUNC_ENTER(NULL);
+
+    if (task->query == NULL || task->stream_closed == 1)
+        goto done;
+
+    if (task->stream_batch == NULL) {
+        batch = PDC_Server_query_batch_create(task->client_id, -1, PDC_BULK_QUERY_COORDS, task->ndim,
+                                              task->ndim * sizeof(uint64_t), task->query_id, 0);
+        if (batch == NULL) {
+            ret_value = FAIL;
+            goto done;
+        }
+        batch->mode        = PDC_QUERY_BATCH_RELAY;
+        batch->task        = task;
+        task->stream_batch = batch;
+    }
+    else if (task->stream_batch->in_flight == 1)
+        goto done;
+
+    ret_value = PDC_Server_query_batch_next(task->stream_batch);
+    if (ret_value != SUCCEED)
+        PDC_Server_query_batch_free(task->stream_batch, 1);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+static perr_t
+PDC_Server_send_coords_to_client(query_task_t *task)
+{
+    perr_t   ret_value = SUCCEED;
+    void *   buf;
+    uint64_t nhits;
+
+    FUNC_ENTER(NULL);
+
+    if (pdc_server_size_g == 1) {
+        buf   = task->query->sel->coords;
+        nhits = task->query->sel->nhits;
+    }
+    else {
+        buf   = task->coords;
+        nhits = task->nhits;
+    }
+
+    ret_value = PDC_Server_send_query_result_batches(task->client_id, PDC_BULK_QUERY_COORDS, buf, task->ndim,
+                                                     task->ndim * sizeof(uint64_t), nhits, task->query_id, 0);
 
     FUNC_LEAVE(ret_value);
 }
@@ -8100,7 +8746,10 @@ PDC_Server_send_coords_to_server(query_task_t *task)
     // Fill input structure
     in.ndim        = task->ndim;
     in.cnt         = task->query->sel->nhits;
+    in.total       = task->query->sel->nhits;
+    in.offset      = 0;
     in.seq_id      = task->query_id;
+    in.seq_id2     = 0;
     in.origin      = pdc_server_rank_g;
     in.op_id       = PDC_BULK_QUERY_COORDS;
     in.bulk_handle = bulk_handle;
@@ -8192,73 +8841,15 @@ perr_t
 PDC_send_data_to_client(int client_id, void *buf, size_t ndim, size_t unit_size, uint64_t count, int id,
                         int client_seq_id)
 {
-    perr_t        ret_value = SUCCEED;
-    hg_return_t   hg_ret;
-    hg_handle_t   handle;
-    hg_bulk_t     bulk_handle;
-    bulk_rpc_in_t in;
-    hg_size_t     buf_sizes;
+    perr_t ret_value = SUCCEED;
 
     FUNC_ENTER(NULL);
 
-    if (client_id >= pdc_client_num_g) {
-        printf("==PDC_SERVER[%d]: %s - client_id %d invalid!\n", pdc_server_rank_g, __func__, client_id);
-        ret_value = FAIL;
-        goto done;
-    }
-
-    if (pdc_client_info_g == NULL) {
-        fprintf(stderr, "==PDC_SERVER[%d]: %s - pdc_client_info_g is NULL\n", pdc_server_rank_g, __func__);
-        ret_value = FAIL;
-        goto done;
-    }
-
-    if (pdc_client_info_g[client_id].addr_valid == 0) {
-        ret_value = PDC_Server_lookup_client(client_id);
-        if (ret_value != SUCCEED) {
-            fprintf(stderr, "==PDC_SERVER[%d]: %s - PDC_Server_lookup_client failed!\n", pdc_server_rank_g,
-                    __func__);
-            ret_value = FAIL;
-            goto done;
-        }
-    }
-
-    buf_sizes = count * unit_size;
-
-    if (buf != NULL && buf_sizes != 0) {
-        hg_ret = HG_Bulk_create(hg_class_g, 1, &buf, &buf_sizes, HG_BULK_READ_ONLY, &bulk_handle);
-        /* printf("==PDC_SERVER[%d]: %s - created bulk handle %p!\n", pdc_server_rank_g, __func__,
-         * bulk_handle); */
-        if (hg_ret != HG_SUCCESS) {
-            fprintf(stderr, "Could not create bulk data handle\n");
-            ret_value = FAIL;
-            goto done;
-        }
-    }
-
-    in.ndim        = ndim;
-    in.cnt         = count;
-    in.seq_id2     = client_seq_id;
-    in.seq_id      = id;
-    in.origin      = pdc_server_rank_g;
-    in.op_id       = PDC_BULK_SEND_QUERY_DATA;
-    in.bulk_handle = bulk_handle;
+    if (count * unit_size == 0)
+        buf = NULL;
 
-    hg_ret = HG_Create(hg_context_g, pdc_client_info_g[client_id].addr, send_bulk_rpc_register_id_g, &handle);
-    if (hg_ret != HG_SUCCESS) {
-        ret_value = FAIL;
-        goto done;
-    }
-
-    hg_ret = HG_Forward(handle, PDC_check_int_ret_cb, NULL, &in);
-    if (hg_ret != HG_SUCCESS) {
-        fprintf(stderr, "==PDC_SERVER[%d]: %s - HG_Forward failed!\n", pdc_server_rank_g, __func__);
-        ret_value = FAIL;
-        goto done;
-    }
-
-done:
-    HG_Destroy(handle);
+    ret_value = PDC_Server_send_query_result_batches(client_id, PDC_BULK_SEND_QUERY_DATA, buf, ndim,
+                                                     unit_size, count, id, client_seq_id);
 
     FUNC_LEAVE(ret_value);
 }
@@ -8270,9 +8861,11 @@ PDC_Server_read_coords(const struct hg_cb_info *callback_info)
     hg_return_t             ret  = HG_SUCCESS;
     query_task_t *          task = (query_task_t *)callback_info->arg;
     pdc_query_constraint_t *constraint;
-    region_list_t *         storage_region_head, *region_elt, *cache_region;
+    region_list_t *         storage_region_head, *region_elt, *cache_region, *buf_region = NULL;
     size_t                  ndim, unit_size;
     uint64_t                i, *coord, data_off, buf_off, my_size;
+    char *                  region_buf   = NULL;
+    void *                  cache_handle = NULL;
 
     // We will read task->my_read_coords, from task->my_read_obj_id
     constraint = PDC_Server_get_constraint_from_query(task->query, task->my_read_obj_id);
@@ -8300,16 +8893,19 @@ PDC_Server_read_coords(const struct hg_cb_info *callback_info)
                     if (region_elt->io_cache_region != NULL)
                         cache_region = region_elt->io_cache_region;
 
-                    if (cache_region->is_io_done != 1) {
-                        PDC_Server_data_read_to_buf_1_region(cache_region);
+                    if (cache_region != buf_region) {
+                        PDC_Server_read_cache_release(cache_handle);
+                        region_buf = PDC_Server_get_region_buf(cache_region, &cache_handle);
+                        buf_region = cache_region;
                     }
-                    /* float *tmp = cache_region->buf + buf_off; */
-                    memcpy(task->my_data + data_off, cache_region->buf + buf_off, unit_size);
+                    if (region_buf != NULL)
+                        memcpy(task->my_data + data_off, region_buf + buf_off, unit_size);
                     data_off += unit_size;
                     break;
                 }
             }
         } // End for
+        PDC_Server_read_cache_release(cache_handle);
 
         PDC_send_data_to_client(task->client_id, task->my_data, ndim, unit_size, task->my_nread_coords,
                                 task->query_id, task->client_seq_id);
@@ -8324,8 +8920,6 @@ PDC_Server_read_coords(const struct hg_cb_info *callback_info)
     }
 
 done:
-    fflush(stdout);
-
     return ret;
 }
 
@@ -8421,9 +9015,10 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
     hg_bulk_t           local_bulk_handle = callback_info->info.bulk.local_handle;
     struct bulk_args_t *bulk_args         = (struct bulk_args_t *)callback_info->arg;
     query_task_t *      task_elt;
+    query_relay_t *     relay;
     uint64_t            nhits = 0, total_hits;
     size_t              ndim, unit_size;
-    int                 i, query_id, origin, found_task;
+    int                 i, query_id, origin, found_task, is_deferred = 0;
 
     void *buf;
 
@@ -8470,6 +9065,30 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
             DL_APPEND(query_task_list_head_g, task_elt);
         }
 
+        if (bulk_args->op == PDC_BULK_QUERY_COORDS_BATCH) {
+            // A batch of the streamed selection of a worker, held until it is relayed to the client
+            if (task_elt->stream_closed == 1) {
+                out.ret = 0;
+                goto done;
+            }
+            if (task_elt->ndim <= 0)
+                task_elt->ndim = ndim;
+            if (nhits > 0) {
+                relay         = (query_relay_t *)calloc(1, sizeof(query_relay_t));
+                relay->coords = (uint64_t *)malloc(bulk_args->nbytes);
+                memcpy(relay->coords, buf, bulk_args->nbytes);
+                relay->nhits  = nhits;
+                relay->handle = bulk_args->handle;
+                DL_APPEND(task_elt->relay_head, relay);
+                is_deferred = 1;
+            }
+            if (bulk_args->total != PDC_QUERY_BATCH_MORE)
+                task_elt->n_recv++;
+
+            PDC_Server_query_relay_progress(task_elt);
+            goto done;
+        }
+
         if (NULL == task_elt->coords_arr)
             task_elt->coords_arr = (uint64_t **)calloc(pdc_server_size_g, sizeof(uint64_t *));
         if (NULL == task_elt->n_hits_from_server)
@@ -8512,7 +9131,6 @@ PDC_recv_coords(const struct hg_cb_info *callback_info)
     } // End else
 
 done:
-    fflush(stdout);
     if (nhits > 0) {
         ret = HG_Bulk_free(local_bulk_handle);
         if (ret != HG_SUCCESS) {
@@ -8521,13 +9139,15 @@ done:
         }
     }
 
-    ret = HG_Respond(bulk_args->handle, NULL, NULL, &out);
-    if (ret != HG_SUCCESS)
-        fprintf(stderr, "Could not respond\n");
+    if (is_deferred == 0) {
+        ret = HG_Respond(bulk_args->handle, NULL, NULL, &out);
+        if (ret != HG_SUCCESS)
+            fprintf(stderr, "Could not respond\n");
 
-    ret = HG_Destroy(bulk_args->handle);
-    if (ret != HG_SUCCESS)
-        fprintf(stderr, "Could not destroy handle\n");
+        ret = HG_Destroy(bulk_args->handle);
+        if (ret != HG_SUCCESS)
+            fprintf(stderr, "Could not destroy handle\n");
+    }
 
     free(bulk_args);
 
@@ -8545,6 +9165,9 @@ PDC_Server_send_query_result_to_client(query_task_t *task)
     else if (task->get_op == PDC_QUERY_GET_SEL) {
         ret_value = PDC_Server_send_coords_to_client(task);
     }
+    else if (task->get_op == PDC_QUERY_GET_SEL_BATCH) {
+        ret_value = PDC_Server_send_coords_stream(task);
+    }
     else if (task->get_op == PDC_QUERY_GET_DATA) {
     }
     else {
@@ -8583,6 +9206,13 @@ PDC_Server_send_query_result_to_manager(query_task_t *task)
             goto done;
         }
     }
+    else if (task->get_op == PDC_QUERY_GET_SEL_BATCH) {
+        ret_value = PDC_Server_send_coords_stream(task);
+        if (ret_value != SUCCEED) {
+            PDC_LOG_ERROR("%s - error with PDC_Server_send_coords_stream", __func__);
+            goto done;
+        }
+    }
     else {
         printf("==PDC_SERVER[%d]: %s - Invalid get_op type!\n", pdc_server_rank_g, __func__);
         ret_value = FAIL;
@@ -8591,10 +9221,8 @@ PDC_Server_send_query_result_to_manager(query_task_t *task)
 
     // TODO: free the task_list at close time
 
-    printf("==PDC_SERVER[%d]: sent query results to manager %d!\n", pdc_server_rank_g, task->manager);
+    PDC_LOG_DEBUG("%s - sent query results to manager %d", __func__, task->manager);
 done:
-    fflush(stdout);
-
     return ret_value;
 }
 
@@ -8602,18 +9230,33 @@ perr_t
 PDC_Server_do_query(query_task_t *task)
 {
     perr_t ret_value = SUCCEED;
+    char * cache_key = NULL;
 
     if (task == NULL || task->is_done == 1) {
         goto done;
     }
 
+    // A streamed selection is evaluated slab by slab while its batches are sent
+    if (task->get_op == PDC_QUERY_GET_SEL_BATCH) {
+        ret_value     = PDC_Server_query_stream_init(task);
+        task->is_done = 1;
+        goto done;
+    }
+
 #ifdef ENABLE_TIMING
     struct timeval pdc_timer_start, pdc_timer_end;
     gettimeofday(&pdc_timer_start, 0);
 #endif
 
-    // Evaluate query
-    PDC_query_visit(task->query, PDC_Server_query_evaluate_merge_opt, task, NULL, PDC_QUERY_NONE);
+    // Reuse the result of an identical query if none of its objects has been written since
+    cache_key = PDC_Server_query_cache_key(task->query);
+    if (PDC_Server_query_cache_lookup(cache_key, task->query->sel, &task->ndim) != 1) {
+        // Evaluate query
+        PDC_query_visit(task->query, PDC_Server_query_evaluate_merge_opt, task, NULL, PDC_QUERY_NONE);
+        PDC_Server_query_cache_insert(cache_key, task->query, task->query->sel, task->ndim);
+    }
+    if (cache_key)
+        free(cache_key);
 
     // No need to store the coords for nhits
     if (task->get_op == PDC_QUERY_GET_NHITS) {
@@ -8804,9 +9447,7 @@ PDC_send_query_metadata_bulk(bulk_rpc_in_t *in, void *buf, uint64_t buf_sizes, i
         goto done;
     }
 
-    printf("==PDC_SERVER[%d]: %s - sending %" PRIu64 " meta to server %d!\n", pdc_server_rank_g, __func__,
-           in->cnt, server_id);
-    fflush(stdout);
+    PDC_LOG_DEBUG("%s - sending %" PRIu64 " meta to server %d", __func__, in->cnt, server_id);
 
     hg_ret = HG_Forward(handle, PDC_check_int_ret_cb, NULL, in);
     if (hg_ret != HG_SUCCESS) {
@@ -8911,9 +9552,8 @@ PDC_Server_distribute_query_storage_info(query_task_t *task, uint64_t obj_id, in
             }
 
             if (nsent > count) {
-                printf("==PDC_SERVER[%d]: ERROR sending more storage meta (%d) than expected (%d)!\n",
-                       pdc_server_rank_g, nsent, count);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - sending more storage meta (%d) than expected (%d)", __func__, nsent,
+                              count);
             }
 
             if (server_id == pdc_server_rank_g) {
@@ -8954,14 +9594,12 @@ PDC_Server_distribute_query_storage_info(query_task_t *task, uint64_t obj_id, in
             }
         } // End DL_FOREACH
 
-        printf("==PDC_SERVER[%d]: distributed all storage meta of %" PRIu64 "!\n", pdc_server_rank_g, obj_id);
-        fflush(stdout);
+        PDC_LOG_DEBUG("%s - distributed all storage meta of %" PRIu64, __func__, obj_id);
         meta->all_storage_region_distributed = 1;
 
     } // end if (NULL != meta)
 
 done:
-    fflush(stdout);
     return;
 }
 
@@ -9000,9 +9638,7 @@ PDC_recv_query_metadata_bulk(const struct hg_cb_info *callback_info)
     pdc_int_ret_t out;
     out.ret = 1;
 
-    printf("==PDC_SERVER[%d]: %s - received %d query metadata from %d!\n", pdc_server_rank_g, __func__,
-           bulk_args->cnt, bulk_args->origin);
-    fflush(stdout);
+    PDC_LOG_DEBUG("%s - received %d query metadata from %d", __func__, bulk_args->cnt, bulk_args->origin);
 
     // TODO: test
     if (callback_info->ret != HG_SUCCESS) {
@@ -9027,8 +9663,7 @@ PDC_recv_query_metadata_bulk(const struct hg_cb_info *callback_info)
         buf_off = 0;
         for (i = 0; i < nregion; i++) {
             if (buf_off > bulk_args->nbytes) {
-                printf("==PDC_SERVER[%d]: %s - ERROR! buf overflow %d! 1\n", pdc_server_rank_g, __func__, i);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - buf overflow %d! 1", __func__, i);
             }
             loc_len_ptr = (int *)(buf + buf_off);
             buf_off += sizeof(int);
@@ -9053,8 +9688,7 @@ PDC_recv_query_metadata_bulk(const struct hg_cb_info *callback_info)
             buf_off += sizeof(int);
 
             if (buf_off > bulk_args->nbytes) {
-                printf("==PDC_SERVER[%d]: %s - ERROR! buf overflow %d!2\n", pdc_server_rank_g, __func__, i);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - buf overflow %d! 2", __func__, i);
             }
 
             if (*has_hist_ptr == 1) {
@@ -9075,16 +9709,14 @@ PDC_recv_query_metadata_bulk(const struct hg_cb_info *callback_info)
             }
 
             if (buf_off > bulk_args->nbytes) {
-                printf("==PDC_SERVER[%d]: %s - ERROR! buf overflow %d! 3\n", pdc_server_rank_g, __func__, i);
-                fflush(stdout);
+                PDC_LOG_ERROR("%s - buf overflow %d! 3", __func__, i);
             }
             regions[i].obj_id = bulk_args->obj_id;
             regions[i].ndim   = bulk_args->ndim;
         }
 
         if (buf_off > bulk_args->nbytes) {
-            printf("==PDC_SERVER[%d]: %s - ERROR! buf overflow after!\n", pdc_server_rank_g, __func__);
-            fflush(stdout);
+            PDC_LOG_ERROR("%s - buf overflow after", __func__);
         }
 
         found_task = 0;
@@ -9193,8 +9825,7 @@ PDC_Server_recv_data_query(const struct hg_cb_info *callback_info)
         if (task_elt->query_id == query_xfer->query_id) {
             query_id_exist = 1;
             new_task       = task_elt;
-            printf("==PDC_SERVER[%d]: %s - query id already exist!\n", pdc_server_rank_g, __func__);
-            fflush(stdout);
+            PDC_LOG_DEBUG("%s - query id already exist", __func__);
             break;
         }
     }
@@ -9241,6 +9872,10 @@ PDC_Server_recv_data_query(const struct hg_cb_info *callback_info)
             PDC_Server_distribute_query_workload(new_task, query, &obj_idx, obj_ids,
                                                  PDC_RECV_REGION_DO_QUERY);
             free(obj_ids);
+
+            // Worker batches of a streamed selection may have arrived before the query
+            if (new_task->get_op == PDC_QUERY_GET_SEL_BATCH)
+                PDC_Server_query_relay_progress(new_task);
             goto done;
         }
 
@@ -9258,7 +9893,6 @@ PDC_Server_recv_data_query(const struct hg_cb_info *callback_info)
 done:
     if (query_xfer)
         PDC_query_xfer_free(query_xfer);
-    fflush(stdout);
 
     return ret;
 }
@@ -9379,8 +10013,6 @@ PDC_Server_send_query_obj_read_to_all_server(query_task_t *task, uint64_t obj_id
     }
 
 done:
-    fflush(stdout);
-
     return ret_value;
 }
 
@@ -9393,8 +10025,10 @@ PDC_Server_recv_read_sel_obj_data(const struct hg_cb_info *callback_info)
     uint64_t                nhits, *coord, *coords = NULL, obj_id, buf_off, my_size, data_off, i;
     size_t                  ndim, unit_size;
     cache_storage_region_t *cache_region_elt;
-    region_list_t *         storage_region_head = NULL, *cache_region, *region_elt;
+    region_list_t *         storage_region_head = NULL, *cache_region, *region_elt, *buf_region = NULL;
     pdc_var_type_t          data_type;
+    char *                  region_buf   = NULL;
+    void *                  cache_handle = NULL;
 
     // find task
     DL_FOREACH(query_task_list_head_g, task_elt)
@@ -9457,22 +10091,24 @@ PDC_Server_recv_read_sel_obj_data(const struct hg_cb_info *callback_info)
                 cache_region = region_elt;
                 if (region_elt->io_cache_region != NULL)
                     cache_region = region_elt->io_cache_region;
-                if (cache_region->is_io_done != 1) {
-                    PDC_Server_data_read_to_buf_1_region(cache_region);
+                if (cache_region != buf_region) {
+                    PDC_Server_read_cache_release(cache_handle);
+                    region_buf = PDC_Server_get_region_buf(cache_region, &cache_handle);
+                    buf_region = cache_region;
                 }
-                memcpy(task->my_data + data_off, cache_region->buf + buf_off, unit_size);
+                if (region_buf != NULL)
+                    memcpy(task->my_data + data_off, region_buf + buf_off, unit_size);
                 data_off += unit_size;
                 break;
             }
         }
     } // End for
+    PDC_Server_read_cache_release(cache_handle);
 
     // Send read data back to client
     PDC_send_data_to_client(task->client_id, task->my_data, ndim, unit_size, nhits, task->query_id,
                             pdc_server_rank_g);
 done:
-    fflush(stdout);
-
     return ret;
 }
 
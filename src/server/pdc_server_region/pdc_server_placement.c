@@ -0,0 +1,160 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pdc_server_placement.h"
+
+static const char *pdc_placement_names_g[] = {"bytes", "round_robin", "least_loaded", "locality"};
+
+static double
+placement_key(pdc_placement_t *placement, pdc_placement_server_t *server)
+{
+    if (placement->policy == PDC_PLACEMENT_LEAST_BYTES)
+        return (double)server->bytes;
+    // Servers that are idle keep their old busy_end, so the one idle the longest comes first
+    return server->busy_end;
+}
+
+static inline double
+heap_key(pdc_placement_t *placement, int pos)
+{
+    return placement->servers[placement->heap[pos]].key;
+}
+
+// Keys only grow, so a server only ever moves down
+static void
+heap_sift_down(pdc_placement_t *placement, int pos)
+{
+    int child, tmp;
+
+    while ((child = 2 * pos + 1) < placement->n_servers) {
+        if (child + 1 < placement->n_servers && heap_key(placement, child + 1) < heap_key(placement, child))
+            child++;
+        if (heap_key(placement, pos) <= heap_key(placement, child))
+            break;
+        tmp                                                 = placement->heap[pos];
+        placement->heap[pos]                                = placement->heap[child];
+        placement->heap[child]                              = tmp;
+        placement->servers[placement->heap[pos]].heap_pos   = pos;
+        placement->servers[placement->heap[child]].heap_pos = child;
+        pos                                                 = child;
+    }
+}
+
+int
+PDC_placement_init(pdc_placement_t *placement, int n_servers, pdc_placement_policy_t policy,
+                   double drain_rate, double remote_cost, double locality_slack)
+{
+    int i;
+
+    memset(placement, 0, sizeof(pdc_placement_t));
+    if (n_servers <= 0)
+        return -1;
+    placement->policy         = policy;
+    placement->n_servers      = n_servers;
+    placement->drain_rate     = drain_rate > 0 ? drain_rate : PDC_PLACEMENT_DRAIN_RATE_DEFAULT;
+    placement->remote_cost    = remote_cost > 0 ? remote_cost : PDC_PLACEMENT_REMOTE_COST_DEFAULT;
+    placement->locality_slack = locality_slack >= 0 ? locality_slack : PDC_PLACEMENT_LOCALITY_SLACK_DEFAULT;
+    placement->servers        = (pdc_placement_server_t *)calloc(n_servers, sizeof(pdc_placement_server_t));
+    placement->heap           = (int *)malloc(sizeof(int) * n_servers);
+    if (placement->servers == NULL || placement->heap == NULL) {
+        PDC_placement_finalize(placement);
+        return -1;
+    }
+    // All keys are 0, server IDs in order form a valid heap
+    for (i = 0; i < n_servers; i++) {
+        placement->heap[i]             = i;
+        placement->servers[i].heap_pos = i;
+    }
+    return 0;
+}
+
+void
+PDC_placement_finalize(pdc_placement_t *placement)
+{
+    free(placement->servers);
+    free(placement->heap);
+    placement->servers   = NULL;
+    placement->heap      = NULL;
+    placement->n_servers = 0;
+}
+
+int
+PDC_placement_policy_from_name(const char *name)
+{
+    int i;
+
+    for (i = 0; i < (int)(sizeof(pdc_placement_names_g) / sizeof(pdc_placement_names_g[0])); i++) {
+        if (strcmp(name, pdc_placement_names_g[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void
+placement_add(pdc_placement_t *placement, uint32_t server_id, uint64_t bytes, double write_time, double now)
+{
+    pdc_placement_server_t *server = placement->servers + server_id;
+
+    server->bytes += bytes;
+    server->n_regions++;
+    if (server->busy_end < now)
+        server->busy_end = now;
+    server->busy_end += write_time;
+    server->key = placement_key(placement, server);
+    heap_sift_down(placement, server->heap_pos);
+}
+
+void
+PDC_placement_charge(pdc_placement_t *placement, uint32_t server_id, uint64_t bytes, double now)
+{
+    if (server_id >= (uint32_t)placement->n_servers)
+        return;
+    placement_add(placement, server_id, bytes, bytes / placement->drain_rate, now);
+}
+
+uint32_t
+PDC_placement_select(pdc_placement_t *placement, uint32_t local_server, uint64_t bytes, double now)
+{
+    uint32_t server_id;
+    double   local_time, remote_time, local_end, remote_end;
+
+    local_time  = bytes / placement->drain_rate;
+    remote_time = local_time * placement->remote_cost;
+
+    switch (placement->policy) {
+        case PDC_PLACEMENT_ROUND_ROBIN:
+            server_id          = placement->rr_next;
+            placement->rr_next = (placement->rr_next + 1) % placement->n_servers;
+            break;
+        case PDC_PLACEMENT_LOCALITY:
+            // Stay local unless the least busy server would still finish this region earlier
+            server_id = placement->heap[0];
+            if (local_server < (uint32_t)placement->n_servers && server_id != local_server) {
+                local_end  = placement->servers[local_server].busy_end;
+                remote_end = placement->servers[server_id].busy_end;
+                local_end  = (local_end > now ? local_end : now) + local_time;
+                remote_end = (remote_end > now ? remote_end : now) + remote_time;
+                if (local_end <= remote_end + placement->locality_slack)
+                    server_id = local_server;
+            }
+            break;
+        default:
+            server_id = placement->heap[0];
+            break;
+    }
+
+    placement->n_placed++;
+    if (server_id == local_server)
+        placement->n_local++;
+    placement_add(placement, server_id, bytes, server_id == local_server ? local_time : remote_time, now);
+    return server_id;
+}
+
+double
+PDC_placement_now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,647 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "mercury_thread_mutex.h"
+#include "pdc_config.h"
+#include "pdc_utlist.h"
+#include "pdc_hash-table.h"
+#include "pdc_hist_pkg.h"
+#include "pdc_server_query_cache.h"
+#include "pdc_timing.h"
+
+struct pdc_query_cache_entry_t;
+struct pdc_query_cache_obj_t;
+
+// Links an entry into the entry list of one of the objects it depends on
+typedef struct pdc_query_cache_link_t {
+    struct pdc_query_cache_entry_t *entry;
+    struct pdc_query_cache_obj_t *  obj;
+
+    struct pdc_query_cache_link_t *prev;
+    struct pdc_query_cache_link_t *next;
+} pdc_query_cache_link_t;
+
+typedef struct pdc_query_cache_entry_t {
+    char *                  key;
+    int                     ndim;
+    uint64_t                nhits;
+    uint64_t *              coords; // query result, NULL for histogram entries
+    pdc_histogram_t *       hist;   // aggregated histogram, NULL for query result entries
+    int                     nobj;
+    uint64_t *              obj_ids;
+    pdc_query_cache_link_t *links; // one per obj_ids element
+    size_t                  size;  // bytes held by this entry
+
+    struct pdc_query_cache_entry_t *prev;
+    struct pdc_query_cache_entry_t *next;
+} pdc_query_cache_entry_t;
+
+/*
+ * Per object write version and the cached entries that depend on the object. A record is created when a
+ * key of the object is built, with a version never handed out before. So a record that was evicted and
+ * created again does not match the keys built with the old one.
+ */
+typedef struct pdc_query_cache_obj_t {
+    uint64_t                obj_id;
+    uint64_t                version;
+    pdc_query_cache_link_t *entries;
+
+    // Records without entries, most recently used first
+    struct pdc_query_cache_obj_t *prev;
+    struct pdc_query_cache_obj_t *next;
+} pdc_query_cache_obj_t;
+
+static HashTable *              query_cache_table_g    = NULL; // key string -> entry
+static HashTable *              query_cache_obj_g      = NULL; // obj_id -> pdc_query_cache_obj_t
+static pdc_query_cache_obj_t *  query_cache_idle_g     = NULL; // records without entries, can be evicted
+static pdc_query_cache_entry_t *query_cache_lru_g      = NULL; // most recently used first
+static hg_thread_mutex_t        query_cache_mutex_g;
+static size_t                   query_cache_size_g     = 0;
+static size_t                   query_cache_max_size_g = PDC_QUERY_CACHE_MAX_SIZE_DEFAULT;
+static uint64_t                 query_cache_version_g  = 0; // last version handed out
+static uint64_t                 query_cache_nhit_g     = 0;
+static uint64_t                 query_cache_nmiss_g    = 0;
+
+static unsigned int
+query_cache_str_hash(HashTableKey key)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    unsigned int         h = 2166136261u;
+
+    while (*p) {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int
+query_cache_str_equal(HashTableKey key1, HashTableKey key2)
+{
+    return strcmp((const char *)key1, (const char *)key2) == 0;
+}
+
+static unsigned int
+query_cache_obj_hash(HashTableKey key)
+{
+    uint64_t id = *(uint64_t *)key;
+    return (unsigned int)(id ^ (id >> 32));
+}
+
+static int
+query_cache_obj_equal(HashTableKey key1, HashTableKey key2)
+{
+    return *(uint64_t *)key1 == *(uint64_t *)key2;
+}
+
+static void query_cache_remove(pdc_query_cache_entry_t *entry);
+
+// Lock must be held. Evict records without entries, then entries, least recently used first, until size
+// more bytes fit.
+static void
+query_cache_evict(size_t size)
+{
+    pdc_query_cache_obj_t *obj;
+    uint64_t               obj_id;
+
+    while (query_cache_size_g + size > query_cache_max_size_g) {
+        if (query_cache_idle_g != NULL) {
+            obj    = query_cache_idle_g->prev;
+            obj_id = obj->obj_id;
+            DL_DELETE(query_cache_idle_g, obj);
+            // Frees the record
+            hash_table_remove(query_cache_obj_g, &obj_id);
+            query_cache_size_g -= sizeof(pdc_query_cache_obj_t);
+        }
+        else if (query_cache_lru_g != NULL)
+            query_cache_remove(query_cache_lru_g->prev);
+        else
+            break;
+    }
+}
+
+// Lock must be held. Get the record of an object, a new record gets a new version. NULL if out of memory.
+static pdc_query_cache_obj_t *
+query_cache_get_obj(uint64_t obj_id)
+{
+    pdc_query_cache_obj_t *obj;
+
+    obj = (pdc_query_cache_obj_t *)hash_table_lookup(query_cache_obj_g, &obj_id);
+    if (obj == NULL) {
+        query_cache_evict(sizeof(pdc_query_cache_obj_t));
+        obj = (pdc_query_cache_obj_t *)calloc(1, sizeof(pdc_query_cache_obj_t));
+        if (obj == NULL)
+            return NULL;
+        obj->obj_id  = obj_id;
+        obj->version = ++query_cache_version_g;
+        if (hash_table_insert(query_cache_obj_g, &obj->obj_id, obj) != 1) {
+            free(obj);
+            return NULL;
+        }
+        DL_PREPEND(query_cache_idle_g, obj);
+        query_cache_size_g += sizeof(pdc_query_cache_obj_t);
+    }
+    else if (obj->entries == NULL) {
+        DL_DELETE(query_cache_idle_g, obj);
+        DL_PREPEND(query_cache_idle_g, obj);
+    }
+    return obj;
+}
+
+// Lock must be held. Version 0 is never handed out, a key with it does not match once memory is back.
+static uint64_t
+query_cache_get_version(uint64_t obj_id)
+{
+    pdc_query_cache_obj_t *obj;
+
+    obj = query_cache_get_obj(obj_id);
+    return obj == NULL ? 0 : obj->version;
+}
+
+static void
+query_cache_entry_free(pdc_query_cache_entry_t *entry)
+{
+    if (entry->coords)
+        free(entry->coords);
+    if (entry->hist)
+        PDC_free_hist(entry->hist);
+    free(entry->obj_ids);
+    free(entry->links);
+    free(entry->key);
+    free(entry);
+}
+
+// Lock must be held
+static void
+query_cache_remove(pdc_query_cache_entry_t *entry)
+{
+    int i;
+
+    for (i = 0; i < entry->nobj; i++) {
+        DL_DELETE(entry->links[i].obj->entries, &entry->links[i]);
+        if (entry->links[i].obj->entries == NULL)
+            DL_PREPEND(query_cache_idle_g, entry->links[i].obj);
+    }
+    hash_table_remove(query_cache_table_g, entry->key);
+    DL_DELETE(query_cache_lru_g, entry);
+    query_cache_size_g -= entry->size;
+    query_cache_entry_free(entry);
+}
+
+// Lock must be held. The entry is freed if it cannot be added.
+static void
+query_cache_add(pdc_query_cache_entry_t *entry)
+{
+    pdc_query_cache_entry_t *old;
+    pdc_query_cache_obj_t *  obj;
+    int                      i;
+
+    old = (pdc_query_cache_entry_t *)hash_table_lookup(query_cache_table_g, entry->key);
+    if (old != NULL)
+        query_cache_remove(old);
+
+    // Link the entry first, a record with entries is not evicted to make room for it
+    for (i = 0; i < entry->nobj; i++) {
+        obj = query_cache_get_obj(entry->obj_ids[i]);
+        if (obj == NULL)
+            goto fail;
+        if (obj->entries == NULL)
+            DL_DELETE(query_cache_idle_g, obj);
+        entry->links[i].entry = entry;
+        entry->links[i].obj   = obj;
+        DL_APPEND(obj->entries, &entry->links[i]);
+    }
+
+    query_cache_evict(entry->size);
+    if (hash_table_insert(query_cache_table_g, entry->key, entry) != 1)
+        goto fail;
+    DL_PREPEND(query_cache_lru_g, entry);
+    query_cache_size_g += entry->size;
+    return;
+
+fail:
+    for (i = 0; i < entry->nobj; i++) {
+        obj = entry->links[i].obj;
+        if (obj == NULL)
+            break;
+        DL_DELETE(obj->entries, &entry->links[i]);
+        if (obj->entries == NULL)
+            DL_PREPEND(query_cache_idle_g, obj);
+    }
+    query_cache_entry_free(entry);
+}
+
+// Order independent digest of the storage regions attached to a query leaf
+static uint64_t
+query_cache_region_digest(region_list_t *region_head, int *nregion)
+{
+    region_list_t *region_elt;
+    uint64_t       digest = 0, h;
+    size_t         i;
+    const char *   p;
+
+    *nregion = 0;
+    DL_FOREACH(region_head, region_elt)
+    {
+        h = 1469598103934665603ULL;
+        for (i = 0; i < region_elt->ndim; i++) {
+            h = (h ^ region_elt->start[i]) * 1099511628211ULL;
+            h = (h ^ region_elt->count[i]) * 1099511628211ULL;
+        }
+        h = (h ^ region_elt->offset) * 1099511628211ULL;
+        for (p = region_elt->storage_location; *p; p++)
+            h = (h ^ (unsigned char)*p) * 1099511628211ULL;
+        digest += h;
+        (*nregion)++;
+    }
+
+    return digest;
+}
+
+static char *
+query_cache_serialize(pdc_query_t *query)
+{
+    pdc_query_constraint_t *c;
+    char *                  left, *right, *ret;
+    uint64_t                v1, v2, digest;
+    size_t                  len;
+    int                     nregion;
+
+    if (query == NULL)
+        return strdup("");
+
+    if (query->left == NULL && query->right == NULL) {
+        c      = query->constraint;
+        digest = query_cache_region_digest((region_list_t *)c->storage_region_list_head, &nregion);
+        memcpy(&v1, &c->value, sizeof(uint64_t));
+        memcpy(&v2, &c->value2, sizeof(uint64_t));
+        len = 256;
+        ret = (char *)malloc(len);
+        snprintf(ret, len,
+                 "{%" PRIu64 "v%" PRIu64 ",%d,%d,%016" PRIx64 ",%d,%016" PRIx64 "#%d:%016" PRIx64 "}",
+                 (uint64_t)c->obj_id, query_cache_get_version(c->obj_id), (int)c->type, (int)c->op, v1,
+                 c->is_range ? (int)c->op2 : -1, c->is_range ? v2 : 0, nregion, digest);
+        return ret;
+    }
+
+    left  = query_cache_serialize(query->left);
+    right = query_cache_serialize(query->right);
+    len   = strlen(left) + strlen(right) + 4;
+    ret   = (char *)malloc(len);
+    // AND and OR are commutative, order the operands so equivalent trees match
+    if (strcmp(left, right) <= 0)
+        snprintf(ret, len, "(%c%s%s)", query->combine_op == PDC_QUERY_AND ? '&' : '|', left, right);
+    else
+        snprintf(ret, len, "(%c%s%s)", query->combine_op == PDC_QUERY_AND ? '&' : '|', right, left);
+
+    free(left);
+    free(right);
+    return ret;
+}
+
+static void
+query_cache_collect_obj(pdc_query_t *query, uint64_t *obj_ids, int *nobj, int max_obj)
+{
+    int i;
+
+    if (query == NULL)
+        return;
+
+    if (query->left == NULL && query->right == NULL && query->constraint != NULL) {
+        for (i = 0; i < *nobj; i++) {
+            if (obj_ids[i] == (uint64_t)query->constraint->obj_id)
+                return;
+        }
+        if (*nobj < max_obj)
+            obj_ids[(*nobj)++] = query->constraint->obj_id;
+        return;
+    }
+
+    query_cache_collect_obj(query->left, obj_ids, nobj, max_obj);
+    query_cache_collect_obj(query->right, obj_ids, nobj, max_obj);
+}
+
+static int
+query_cache_count_leaf(pdc_query_t *query)
+{
+    if (query == NULL)
+        return 0;
+    if (query->left == NULL && query->right == NULL)
+        return 1;
+    return query_cache_count_leaf(query->left) + query_cache_count_leaf(query->right);
+}
+
+// Lock must be held
+static char *
+query_cache_build_key(pdc_query_t *query)
+{
+    region_list_t *region = (region_list_t *)query->region_constraint;
+    char *         key, *ret;
+    size_t         len;
+    int            i;
+
+    key = query_cache_serialize(query);
+
+    // Append the region constraint of the query, if any
+    if (region == NULL || region->ndim == 0)
+        return key;
+    len = strlen(key) + region->ndim * 42 + 4;
+    ret = (char *)malloc(len);
+    snprintf(ret, len, "%s@", key);
+    for (i = 0; i < (int)region->ndim; i++)
+        snprintf(ret + strlen(ret), len - strlen(ret), "%" PRIu64 ":%" PRIu64 ",", region->start[i],
+                 region->count[i]);
+    free(key);
+
+    return ret;
+}
+
+perr_t
+PDC_Server_query_cache_init()
+{
+    perr_t ret_value = SUCCEED;
+    char * p;
+
+    FUNC_ENTER(NULL);
+
+    p = getenv("PDC_QUERY_CACHE_MAX_SIZE");
+    if (p != NULL)
+        query_cache_max_size_g = strtoull(p, NULL, 10);
+
+    hg_thread_mutex_init(&query_cache_mutex_g);
+    query_cache_table_g = hash_table_new(query_cache_str_hash, query_cache_str_equal);
+    query_cache_obj_g   = hash_table_new(query_cache_obj_hash, query_cache_obj_equal);
+    if (query_cache_table_g == NULL || query_cache_obj_g == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: error creating query cache tables", pdc_server_rank_g);
+    hash_table_register_free_functions(query_cache_obj_g, NULL, free);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_query_cache_finalize()
+{
+    pdc_query_cache_entry_t *entry, *tmp;
+
+    FUNC_ENTER(NULL);
+
+    if (query_cache_table_g == NULL)
+        FUNC_LEAVE(SUCCEED);
+
+    if (query_cache_nhit_g + query_cache_nmiss_g > 0)
+        printf("==PDC_SERVER[%d]: query cache %" PRIu64 " hits, %" PRIu64 " misses, %.2f%% hit rate\n",
+               pdc_server_rank_g, query_cache_nhit_g, query_cache_nmiss_g,
+               100.0 * query_cache_nhit_g / (query_cache_nhit_g + query_cache_nmiss_g));
+
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    DL_FOREACH_SAFE(query_cache_lru_g, entry, tmp)
+    {
+        DL_DELETE(query_cache_lru_g, entry);
+        query_cache_entry_free(entry);
+    }
+    // Frees the object records
+    hash_table_free(query_cache_table_g);
+    hash_table_free(query_cache_obj_g);
+    query_cache_table_g = NULL;
+    query_cache_obj_g   = NULL;
+    query_cache_idle_g  = NULL;
+    query_cache_size_g  = 0;
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+    hg_thread_mutex_destroy(&query_cache_mutex_g);
+
+    FUNC_LEAVE(SUCCEED);
+}
+
+char *
+PDC_Server_query_cache_key(pdc_query_t *query)
+{
+    char *ret_value = NULL;
+
+    FUNC_ENTER(NULL);
+
+    if (query_cache_table_g == NULL || query_cache_max_size_g == 0 || query == NULL)
+        PGOTO_DONE(NULL);
+
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    ret_value = query_cache_build_key(query);
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+int
+PDC_Server_query_cache_lookup(const char *key, pdc_selection_t *sel, int *ndim)
+{
+    int                      ret_value = 0;
+    pdc_query_cache_entry_t *entry;
+
+    FUNC_ENTER(NULL);
+
+    if (key == NULL || sel == NULL || query_cache_table_g == NULL)
+        PGOTO_DONE(0);
+
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    entry = (pdc_query_cache_entry_t *)hash_table_lookup(query_cache_table_g, (HashTableKey)key);
+    if (entry != NULL) {
+        // Move to the front of the LRU list
+        DL_DELETE(query_cache_lru_g, entry);
+        DL_PREPEND(query_cache_lru_g, entry);
+
+        if (sel->coords_alloc > 0 && sel->coords)
+            free(sel->coords);
+        sel->nhits        = entry->nhits;
+        sel->coords_alloc = entry->nhits * entry->ndim;
+        sel->coords       = NULL;
+        if (entry->nhits > 0) {
+            sel->coords = (uint64_t *)malloc(sel->coords_alloc * sizeof(uint64_t));
+            memcpy(sel->coords, entry->coords, sel->coords_alloc * sizeof(uint64_t));
+        }
+        *ndim = entry->ndim;
+        query_cache_nhit_g++;
+        ret_value = 1;
+    }
+    else
+        query_cache_nmiss_g++;
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+
+#ifdef PDC_TIMING
+    if (ret_value == 1)
+        pdc_server_timings->PDCquery_cache_hit += 1;
+    else
+        pdc_server_timings->PDCquery_cache_miss += 1;
+#endif
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_query_cache_insert(const char *key, pdc_query_t *query, pdc_selection_t *sel, int ndim)
+{
+    perr_t                   ret_value = SUCCEED;
+    pdc_query_cache_entry_t *entry     = NULL;
+    char *                   cur_key   = NULL;
+    size_t                   size;
+    int                      max_obj;
+
+    FUNC_ENTER(NULL);
+
+    if (key == NULL || sel == NULL || query_cache_table_g == NULL)
+        PGOTO_DONE(SUCCEED);
+
+    size = sizeof(pdc_query_cache_entry_t) + strlen(key) + 1 + sel->nhits * ndim * sizeof(uint64_t);
+    if (size > query_cache_max_size_g)
+        PGOTO_DONE(SUCCEED);
+
+    entry        = (pdc_query_cache_entry_t *)calloc(1, sizeof(pdc_query_cache_entry_t));
+    entry->key   = strdup(key);
+    entry->ndim  = ndim;
+    entry->nhits = sel->nhits;
+    entry->size  = size;
+    if (sel->nhits > 0) {
+        entry->coords = (uint64_t *)malloc(sel->nhits * ndim * sizeof(uint64_t));
+        if (entry->coords == NULL) {
+            query_cache_entry_free(entry);
+            PGOTO_DONE(SUCCEED);
+        }
+        memcpy(entry->coords, sel->coords, sel->nhits * ndim * sizeof(uint64_t));
+    }
+    max_obj        = query_cache_count_leaf(query);
+    entry->obj_ids = (uint64_t *)calloc(max_obj + 1, sizeof(uint64_t));
+    query_cache_collect_obj(query, entry->obj_ids, &entry->nobj, max_obj);
+    entry->links = (pdc_query_cache_link_t *)calloc(entry->nobj + 1, sizeof(pdc_query_cache_link_t));
+    entry->size += entry->nobj * sizeof(pdc_query_cache_link_t);
+
+    // Drop the result if an object was written during the evaluation, checked under the lock the writes
+    // bump the versions with
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    cur_key = query_cache_build_key(query);
+    if (cur_key != NULL && strcmp(cur_key, key) == 0)
+        query_cache_add(entry);
+    else
+        query_cache_entry_free(entry);
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+
+done:
+    if (cur_key)
+        free(cur_key);
+    FUNC_LEAVE(ret_value);
+}
+
+pdc_histogram_t *
+PDC_Server_query_cache_get_hist(uint64_t obj_id, region_list_t *region_head)
+{
+    pdc_histogram_t *        ret_value = NULL;
+    pdc_query_cache_entry_t *entry;
+    pdc_histogram_t **       hists = NULL, *merged;
+    region_list_t *          region_elt;
+    char                     key[128];
+    int                      nregion, i;
+    uint64_t                 digest, version;
+
+    FUNC_ENTER(NULL);
+
+    if (region_head == NULL || query_cache_table_g == NULL || query_cache_max_size_g == 0)
+        PGOTO_DONE(NULL);
+
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    digest  = query_cache_region_digest(region_head, &nregion);
+    version = query_cache_get_version(obj_id);
+    snprintf(key, sizeof(key), "H%" PRIu64 "v%" PRIu64 "#%d:%016" PRIx64, obj_id, version, nregion,
+             digest);
+
+    entry = (pdc_query_cache_entry_t *)hash_table_lookup(query_cache_table_g, key);
+    if (entry != NULL) {
+        DL_DELETE(query_cache_lru_g, entry);
+        DL_PREPEND(query_cache_lru_g, entry);
+        ret_value = PDC_dup_hist(entry->hist);
+        query_cache_nhit_g++;
+        hg_thread_mutex_unlock(&query_cache_mutex_g);
+#ifdef PDC_TIMING
+        pdc_server_timings->PDCquery_cache_hit += 1;
+#endif
+        PGOTO_DONE(ret_value);
+    }
+    query_cache_nmiss_g++;
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+#ifdef PDC_TIMING
+    pdc_server_timings->PDCquery_cache_miss += 1;
+#endif
+
+    // All regions need a histogram to aggregate
+    hists = (pdc_histogram_t **)calloc(nregion, sizeof(pdc_histogram_t *));
+    i     = 0;
+    DL_FOREACH(region_head, region_elt)
+    {
+        if (region_elt->region_hist == NULL || region_elt->region_hist->nbin == 0)
+            PGOTO_DONE(NULL);
+        hists[i++] = region_elt->region_hist;
+    }
+
+    merged = PDC_merge_hist(nregion, hists);
+    if (merged == NULL)
+        PGOTO_DONE(NULL);
+
+    entry             = (pdc_query_cache_entry_t *)calloc(1, sizeof(pdc_query_cache_entry_t));
+    entry->key        = strdup(key);
+    entry->hist       = merged;
+    entry->nobj       = 1;
+    entry->obj_ids    = (uint64_t *)malloc(sizeof(uint64_t));
+    entry->obj_ids[0] = obj_id;
+    entry->links      = (pdc_query_cache_link_t *)calloc(1, sizeof(pdc_query_cache_link_t));
+    entry->size       = sizeof(pdc_query_cache_entry_t) + sizeof(pdc_query_cache_link_t) +
+                  sizeof(pdc_histogram_t) + strlen(key) + 1 +
+                  merged->nbin * (2 * sizeof(double) + sizeof(uint64_t));
+    ret_value = PDC_dup_hist(merged);
+
+    // The object may have been written while the histograms were merged
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+    if (query_cache_get_version(obj_id) == version)
+        query_cache_add(entry);
+    else
+        query_cache_entry_free(entry);
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+
+done:
+    if (hists)
+        free(hists);
+    FUNC_LEAVE(ret_value);
+}
+
+void
+PDC_Server_query_cache_invalidate(uint64_t obj_id)
+{
+    pdc_query_cache_obj_t *obj;
+
+    FUNC_ENTER(NULL);
+
+    // Nothing is ever cached when the cache is disabled
+    if (query_cache_table_g == NULL || query_cache_max_size_g == 0)
+        FUNC_LEAVE_VOID;
+
+    hg_thread_mutex_lock(&query_cache_mutex_g);
+
+    // Without a record no key of the object is cached or being evaluated with a version that would still
+    // match, a new record gets a new version
+    obj = (pdc_query_cache_obj_t *)hash_table_lookup(query_cache_obj_g, &obj_id);
+    if (obj != NULL) {
+        // Bump the version so results being evaluated concurrently are not inserted
+        obj->version = ++query_cache_version_g;
+
+        // Only the entries that depend on this object are visited
+        while (obj->entries != NULL) {
+            query_cache_remove(obj->entries->entry);
+#ifdef PDC_TIMING
+            pdc_server_timings->PDCquery_cache_invalidate += 1;
+#endif
+        }
+    }
+
+    hg_thread_mutex_unlock(&query_cache_mutex_g);
+
+    FUNC_LEAVE_VOID;
+}
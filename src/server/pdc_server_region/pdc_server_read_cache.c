@@ -0,0 +1,488 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "pdc_config.h"
+#include "pdc_utlist.h"
+#include "pdc_hash-table.h"
+#include "pdc_client_server_common.h"
+#include "pdc_server_data.h"
+#include "pdc_server_read_cache.h"
+
+struct pdc_read_cache_file_t;
+
+typedef struct pdc_read_cache_entry_t {
+    struct pdc_read_cache_file_t *file;
+    uint64_t                      offset;
+    uint64_t                      size;
+    char *                        buf;
+    int                           refcount;
+    // Removed from the index, freed when the last reference is released
+    int is_stale;
+
+    struct pdc_read_cache_entry_t *prev;
+    struct pdc_read_cache_entry_t *next;
+    // Entries of the same file, so invalidation does not scan the whole cache
+    struct pdc_read_cache_entry_t *file_prev;
+    struct pdc_read_cache_entry_t *file_next;
+} pdc_read_cache_entry_t;
+
+/*
+ * Cache state of one storage file: its entries, the end of the last read to detect a sequential scan, and
+ * the data read ahead of that scan that has not been requested yet. The record is freed once it has no
+ * entries, no read-ahead data and no read in flight.
+ */
+typedef struct pdc_read_cache_file_t {
+    char *                  path;
+    pdc_read_cache_entry_t *entries;
+    uint64_t                last_end;
+    uint64_t                version; // bumped by invalidation, reads started before do not fill the cache
+    int                     nreader; // reads in flight without the lock
+    uint64_t                window_offset;
+    uint64_t                window_size;
+    char *                  window_buf;
+} pdc_read_cache_file_t;
+
+static HashTable *             read_cache_table_g = NULL; // (file, offset, size) -> entry
+static HashTable *             read_cache_files_g = NULL; // path -> file
+static pdc_read_cache_entry_t *read_cache_lru_g   = NULL; // most recently used first
+static pthread_mutex_t         read_cache_mutex_g;
+static uint64_t                read_cache_size_g      = 0;
+static uint64_t                read_cache_max_size_g  = PDC_READ_CACHE_MAX_SIZE_DEFAULT;
+static uint64_t                read_cache_readahead_g = PDC_READ_CACHE_READAHEAD_DEFAULT;
+static pdc_read_cache_stats_t  read_cache_stats_g;
+
+static unsigned int
+read_cache_hash(HashTableKey key)
+{
+    pdc_read_cache_entry_t *entry = (pdc_read_cache_entry_t *)key;
+    uint64_t                h;
+
+    h = (uint64_t)(uintptr_t)entry->file ^ (entry->offset * 0x9e3779b97f4a7c15ULL);
+    return (unsigned int)(h ^ (h >> 32));
+}
+
+static int
+read_cache_equal(HashTableKey key1, HashTableKey key2)
+{
+    pdc_read_cache_entry_t *a = (pdc_read_cache_entry_t *)key1;
+    pdc_read_cache_entry_t *b = (pdc_read_cache_entry_t *)key2;
+
+    return a->file == b->file && a->offset == b->offset && a->size == b->size;
+}
+
+static unsigned int
+read_cache_path_hash(HashTableKey key)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    unsigned int         h = 2166136261u;
+
+    while (*p) {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int
+read_cache_path_equal(HashTableKey key1, HashTableKey key2)
+{
+    return strcmp((const char *)key1, (const char *)key2) == 0;
+}
+
+static void
+read_cache_entry_free(pdc_read_cache_entry_t *entry)
+{
+    free(entry->buf);
+    free(entry);
+}
+
+// Free the record of a file nothing refers to anymore, lock must be held
+static void
+read_cache_file_put(pdc_read_cache_file_t *file)
+{
+    if (file->entries != NULL || file->window_buf != NULL || file->nreader > 0)
+        return;
+    hash_table_remove(read_cache_files_g, file->path);
+    free(file->path);
+    free(file);
+}
+
+// Lock must be held
+static void
+read_cache_remove(pdc_read_cache_entry_t *entry)
+{
+    pdc_read_cache_file_t *file = entry->file;
+
+    hash_table_remove(read_cache_table_g, entry);
+    DL_DELETE(read_cache_lru_g, entry);
+    DL_DELETE2(file->entries, entry, file_prev, file_next);
+    read_cache_size_g -= entry->size;
+    if (entry->refcount > 0)
+        entry->is_stale = 1;
+    else
+        read_cache_entry_free(entry);
+    read_cache_file_put(file);
+}
+
+// Evict unreferenced entries from the tail of the list until size more bytes fit, lock must be held
+static void
+read_cache_evict(uint64_t size)
+{
+    pdc_read_cache_entry_t *entry, *prev;
+
+    if (read_cache_lru_g == NULL)
+        return;
+
+    entry = read_cache_lru_g->prev;
+    while (entry != NULL && read_cache_size_g + size > read_cache_max_size_g) {
+        // The head's prev is the tail, stop after visiting the head
+        prev = entry == read_cache_lru_g ? NULL : entry->prev;
+        if (entry->refcount == 0) {
+            read_cache_remove(entry);
+            read_cache_stats_g.nevict++;
+        }
+        entry = prev;
+    }
+}
+
+static perr_t
+read_cache_pread(const char *path, int fd, char *buf, uint64_t size, uint64_t offset, uint64_t *nread)
+{
+    perr_t  ret_value = SUCCEED;
+    int     opened    = 0;
+    ssize_t ret;
+
+    *nread = 0;
+    if (fd < 0) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            printf("==PDC_SERVER[%d]: %s - open failed [%s]\n", pdc_server_rank_g, __func__, path);
+            return FAIL;
+        }
+        opened = 1;
+    }
+
+    while (*nread < size) {
+        ret = pread(fd, buf + *nread, size - *nread, offset + *nread);
+        if (ret <= 0)
+            break;
+        *nread += ret;
+    }
+
+    if (opened)
+        close(fd);
+    return ret_value;
+}
+
+/*
+ * Read a region into buf on a miss, lock must NOT be held. A read continuing the last read of its file
+ * also reads the following bytes, ra_buf returns them with the region in front for the caller to keep as
+ * the read-ahead window of the file.
+ */
+static perr_t
+read_cache_fill(const char *path, int fd, uint64_t offset, uint64_t size, char *buf, int sequential,
+                char **ra_buf, uint64_t *ra_nread)
+{
+    perr_t   ret_value = SUCCEED;
+    uint64_t nread, ra_size;
+
+    FUNC_ENTER(NULL);
+
+    *ra_buf   = NULL;
+    *ra_nread = 0;
+    if (sequential) {
+        ra_size = size + read_cache_readahead_g;
+        *ra_buf = (char *)malloc(ra_size);
+        if (*ra_buf == NULL || read_cache_pread(path, fd, *ra_buf, ra_size, offset, &nread) != SUCCEED ||
+            nread < size) {
+            free(*ra_buf);
+            *ra_buf = NULL;
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: read-ahead of [%s] failed", pdc_server_rank_g, path);
+        }
+        memcpy(buf, *ra_buf, size);
+        *ra_nread = nread;
+    }
+    else {
+        if (read_cache_pread(path, fd, buf, size, offset, &nread) != SUCCEED || nread != size)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: read %" PRIu64 " of %" PRIu64 " bytes from [%s]",
+                        pdc_server_rank_g, nread, size, path);
+    }
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_read_cache_init()
+{
+    perr_t ret_value = SUCCEED;
+    char * p;
+
+    FUNC_ENTER(NULL);
+
+    p = getenv("PDC_READ_CACHE_MAX_SIZE");
+    if (p != NULL)
+        read_cache_max_size_g = strtoull(p, NULL, 10);
+    p = getenv("PDC_READ_CACHE_READAHEAD");
+    if (p != NULL)
+        read_cache_readahead_g = strtoull(p, NULL, 10);
+
+    memset(&read_cache_stats_g, 0, sizeof(pdc_read_cache_stats_t));
+
+    pthread_mutex_init(&read_cache_mutex_g, NULL);
+    read_cache_table_g = hash_table_new(read_cache_hash, read_cache_equal);
+    read_cache_files_g = hash_table_new(read_cache_path_hash, read_cache_path_equal);
+    if (read_cache_table_g == NULL || read_cache_files_g == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: error creating read cache table", pdc_server_rank_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_read_cache_finalize()
+{
+    pdc_read_cache_entry_t *entry, *tmp;
+    pdc_read_cache_file_t * file;
+    HashTableIterator       iter;
+
+    FUNC_ENTER(NULL);
+
+    if (read_cache_table_g == NULL)
+        FUNC_LEAVE(SUCCEED);
+
+    pthread_mutex_lock(&read_cache_mutex_g);
+    DL_FOREACH_SAFE(read_cache_lru_g, entry, tmp)
+    {
+        DL_DELETE(read_cache_lru_g, entry);
+        read_cache_entry_free(entry);
+    }
+    hash_table_iterate(read_cache_files_g, &iter);
+    while (hash_table_iter_has_more(&iter)) {
+        file = (pdc_read_cache_file_t *)hash_table_iter_next(&iter).value;
+        free(file->window_buf);
+        free(file->path);
+        free(file);
+    }
+    hash_table_free(read_cache_table_g);
+    hash_table_free(read_cache_files_g);
+    read_cache_table_g = NULL;
+    read_cache_files_g = NULL;
+    read_cache_size_g  = 0;
+    pthread_mutex_unlock(&read_cache_mutex_g);
+    pthread_mutex_destroy(&read_cache_mutex_g);
+
+    FUNC_LEAVE(SUCCEED);
+}
+
+/*
+ * The file is read without the lock, so reads of other regions go on. Reading the same missed region twice
+ * at once is rare, the second read to finish uses the entry of the first one.
+ */
+void *
+PDC_Server_read_cache_acquire(const char *path, int fd, uint64_t offset, uint64_t size, void **handle)
+{
+    void *                  ret_value = NULL;
+    pdc_read_cache_entry_t  key, *entry, *found;
+    pdc_read_cache_file_t * file;
+    uint64_t                version, ra_nread;
+    char *                  ra_buf;
+    int                     sequential;
+
+    FUNC_ENTER(NULL);
+
+    *handle = NULL;
+    // Regions larger than a quarter of the budget would flush everything else, leave them to the caller
+    if (read_cache_table_g == NULL || path == NULL || path[0] == 0 || size == 0 ||
+        size > read_cache_max_size_g / 4)
+        PGOTO_DONE(NULL);
+
+    pthread_mutex_lock(&read_cache_mutex_g);
+    file = (pdc_read_cache_file_t *)hash_table_lookup(read_cache_files_g, (HashTableKey)path);
+    if (file == NULL) {
+        file = (pdc_read_cache_file_t *)calloc(1, sizeof(pdc_read_cache_file_t));
+        if (file != NULL)
+            file->path = strdup(path);
+        if (file == NULL || file->path == NULL ||
+            hash_table_insert(read_cache_files_g, file->path, file) != 1) {
+            if (file != NULL)
+                free(file->path);
+            free(file);
+            pthread_mutex_unlock(&read_cache_mutex_g);
+            PGOTO_DONE(NULL);
+        }
+    }
+
+    key.file   = file;
+    key.offset = offset;
+    key.size   = size;
+    entry      = (pdc_read_cache_entry_t *)hash_table_lookup(read_cache_table_g, &key);
+    if (entry != NULL) {
+        DL_DELETE(read_cache_lru_g, entry);
+        DL_PREPEND(read_cache_lru_g, entry);
+        read_cache_stats_g.nhit++;
+        entry->refcount++;
+        pthread_mutex_unlock(&read_cache_mutex_g);
+        *handle = entry;
+        PGOTO_DONE(entry->buf);
+    }
+
+    read_cache_stats_g.nmiss++;
+    entry = (pdc_read_cache_entry_t *)calloc(1, sizeof(pdc_read_cache_entry_t));
+    if (entry != NULL)
+        entry->buf = (char *)malloc(size);
+    if (entry == NULL || entry->buf == NULL) {
+        if (entry != NULL)
+            read_cache_entry_free(entry);
+        read_cache_file_put(file);
+        pthread_mutex_unlock(&read_cache_mutex_g);
+        PGOTO_DONE(NULL);
+    }
+    entry->file   = file;
+    entry->offset = offset;
+    entry->size   = size;
+
+    if (file->window_buf != NULL && offset >= file->window_offset &&
+        offset + size <= file->window_offset + file->window_size) {
+        memcpy(entry->buf, file->window_buf + (offset - file->window_offset), size);
+        read_cache_stats_g.nreadahead_hit++;
+        file->last_end = offset + size;
+    }
+    else {
+        // A sequential scan of this file reads the following bytes together with this region
+        sequential     = read_cache_readahead_g > 0 && offset == file->last_end && offset > 0;
+        file->last_end = offset + size;
+        version        = file->version;
+        file->nreader++;
+        pthread_mutex_unlock(&read_cache_mutex_g);
+
+        if (read_cache_fill(path, fd, offset, size, entry->buf, sequential, &ra_buf, &ra_nread) == SUCCEED)
+            ret_value = entry->buf;
+
+        pthread_mutex_lock(&read_cache_mutex_g);
+        file->nreader--;
+        // The server I/O counters are shared, update them under the lock
+        if (fd < 0)
+            n_fopen_g++;
+        n_fread_g++;
+        fread_total_MB += (ra_buf != NULL ? ra_nread : size) / 1048576.0;
+        // An invalidation while reading means the data may be older than the write, do not keep it
+        if (ra_buf != NULL && ret_value != NULL && file->version == version) {
+            free(file->window_buf);
+            file->window_offset = offset;
+            file->window_size   = ra_nread;
+            file->window_buf    = ra_buf;
+        }
+        else
+            free(ra_buf);
+        if (ret_value == NULL) {
+            read_cache_entry_free(entry);
+            read_cache_file_put(file);
+            pthread_mutex_unlock(&read_cache_mutex_g);
+            PGOTO_DONE(NULL);
+        }
+        if (file->version != version) {
+            // Serve this read with the data it got, but keep it out of the index
+            entry->is_stale = 1;
+            entry->refcount = 1;
+            read_cache_file_put(file);
+            entry->file = NULL;
+            pthread_mutex_unlock(&read_cache_mutex_g);
+            *handle = entry;
+            PGOTO_DONE(entry->buf);
+        }
+        found = (pdc_read_cache_entry_t *)hash_table_lookup(read_cache_table_g, &key);
+        if (found != NULL) {
+            read_cache_entry_free(entry);
+            entry = found;
+            DL_DELETE(read_cache_lru_g, entry);
+            DL_PREPEND(read_cache_lru_g, entry);
+            entry->refcount++;
+            pthread_mutex_unlock(&read_cache_mutex_g);
+            *handle = entry;
+            PGOTO_DONE(entry->buf);
+        }
+    }
+
+    read_cache_evict(size);
+    hash_table_insert(read_cache_table_g, entry, entry);
+    DL_PREPEND(read_cache_lru_g, entry);
+    DL_APPEND2(file->entries, entry, file_prev, file_next);
+    read_cache_size_g += size;
+    entry->refcount++;
+    pthread_mutex_unlock(&read_cache_mutex_g);
+
+    *handle   = entry;
+    ret_value = entry->buf;
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+void
+PDC_Server_read_cache_release(void *handle)
+{
+    pdc_read_cache_entry_t *entry = (pdc_read_cache_entry_t *)handle;
+
+    FUNC_ENTER(NULL);
+
+    if (entry == NULL)
+        FUNC_LEAVE_VOID;
+
+    pthread_mutex_lock(&read_cache_mutex_g);
+    entry->refcount--;
+    if (entry->refcount == 0 && entry->is_stale == 1)
+        read_cache_entry_free(entry);
+    pthread_mutex_unlock(&read_cache_mutex_g);
+
+    FUNC_LEAVE_VOID;
+}
+
+void
+PDC_Server_read_cache_invalidate(const char *path, uint64_t offset, uint64_t size)
+{
+    pdc_read_cache_entry_t *entry, *tmp;
+    pdc_read_cache_file_t * file;
+
+    FUNC_ENTER(NULL);
+
+    if (read_cache_table_g == NULL || path == NULL)
+        FUNC_LEAVE_VOID;
+
+    pthread_mutex_lock(&read_cache_mutex_g);
+    file = (pdc_read_cache_file_t *)hash_table_lookup(read_cache_files_g, (HashTableKey)path);
+    if (file != NULL) {
+        file->version++;
+        if (file->window_buf != NULL && file->window_offset < offset + size &&
+            offset < file->window_offset + file->window_size) {
+            free(file->window_buf);
+            file->window_buf = NULL;
+        }
+        // Removing the last entry may free the file record
+        file->nreader++;
+        DL_FOREACH_SAFE2(file->entries, entry, tmp, file_next)
+        {
+            if (entry->offset < offset + size && offset < entry->offset + entry->size)
+                read_cache_remove(entry);
+        }
+        file->nreader--;
+        read_cache_file_put(file);
+    }
+    pthread_mutex_unlock(&read_cache_mutex_g);
+
+    FUNC_LEAVE_VOID;
+}
+
+void
+PDC_Server_read_cache_get_stats(pdc_read_cache_stats_t *stats)
+{
+    pthread_mutex_lock(&read_cache_mutex_g);
+    *stats      = read_cache_stats_g;
+    stats->size = read_cache_size_g;
+    pthread_mutex_unlock(&read_cache_mutex_g);
+}
@@ -1,5 +1,6 @@
 #include "pdc_server_region_cache.h"
 #include "pdc_timing.h"
+#include "pdc_metrics.h"
 
 #ifdef PDC_SERVER_CACHE
 
@@ -505,7 +506,8 @@ PDC_transfer_request_data_write_out(uint64_t obj_id, int obj_ndim, const uint64_
     // uint64_t *        offset_merged, size_merged;
     // int               merge_status;
 
-    perr_t ret_value = SUCCEED;
+    perr_t   ret_value     = SUCCEED;
+    uint64_t metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -580,9 +582,9 @@ PDC_transfer_request_data_write_out(uint64_t obj_id, int obj_ndim, const uint64_
 #ifdef PDC_TIMING
     pdc_server_timings->PDCcache_write += MPI_Wtime() - start;
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_CACHE_WRITE, metrics_start, write_size);
 
     // done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -663,7 +665,8 @@ PDC_region_cache_flush_by_pointer(uint64_t obj_id, pdc_obj_cache *obj_cache)
     int                      i, nflush = 0;
     pdc_region_cache *       region_cache_iter, *region_cache_temp;
     struct pdc_region_info * region_cache_info;
-    uint64_t                 write_size = 0;
+    uint64_t                 write_size = 0, flush_size = 0;
+    uint64_t                 metrics_start = PDC_metrics_now();
     char **                  buf, **new_buf, *buf_ptr = NULL;
     uint64_t *               start, *end, *new_start, *new_end;
     int                      merged_request_size = 0;
@@ -753,6 +756,7 @@ PDC_region_cache_flush_by_pointer(uint64_t obj_id, pdc_obj_cache *obj_cache)
             write_size *= region_cache_info->size[2];
 
         total_cache_size -= write_size;
+        flush_size += write_size;
         free(region_cache_info->offset);
         if (obj_cache->ndim > 1) {
             free(region_cache_info->buf);
@@ -772,6 +776,7 @@ PDC_region_cache_flush_by_pointer(uint64_t obj_id, pdc_obj_cache *obj_cache)
 #ifdef PDC_TIMING
     pdc_server_timings->PDCcache_flush += MPI_Wtime() - start_time;
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_CACHE_FLUSH, metrics_start, flush_size);
     return nflush;
 }
 
@@ -882,7 +887,10 @@ perr_t
 PDC_transfer_request_data_read_from(uint64_t obj_id, int obj_ndim, const uint64_t *obj_dims,
                                     struct pdc_region_info *region_info, void *buf, size_t unit)
 {
-    perr_t ret_value = SUCCEED;
+    perr_t   ret_value     = SUCCEED;
+    uint64_t metrics_start = PDC_metrics_now();
+    uint64_t read_size     = unit;
+    int      i;
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
     double start = MPI_Wtime();
@@ -895,8 +903,10 @@ PDC_transfer_request_data_read_from(uint64_t obj_id, int obj_ndim, const uint64_
 #ifdef PDC_TIMING
     pdc_server_timings->PDCcache_read += MPI_Wtime() - start;
 #endif
+    for (i = 0; i < region_info->ndim; ++i)
+        read_size *= region_info->size[i];
+    PDC_metrics_record(PDC_METRIC_SERVER_CACHE_READ, metrics_start, read_size);
     // done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
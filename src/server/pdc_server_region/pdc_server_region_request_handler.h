@@ -13,15 +13,13 @@ transfer_request_all_bulk_transfer_read_cb2(const struct hg_cb_info *info)
     pthread_mutex_lock(&transfer_request_status_mutex);
     for (i = 0; i < local_bulk_args2->request_data.n_objs; ++i) {
         PDC_finish_request(local_bulk_args2->transfer_request_id[i]);
+        PDC_PROFILE_FLOW(
+            "transfer_request",
+            PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, local_bulk_args2->transfer_request_id[i]), 't');
     }
     pthread_mutex_unlock(&transfer_request_status_mutex);
-    clean_write_bulk_data(&(local_bulk_args2->request_data));
-    free(local_bulk_args2->data_buf);
-    free(local_bulk_args2->transfer_request_id);
-    HG_Bulk_free(local_bulk_args2->bulk_handle);
-    HG_Destroy(local_bulk_args2->handle);
-    free(local_bulk_args2);
-    // printf("finishing transfer_request_all_bulk_transfer_read_cb2\n");
+    PDC_metrics_record(PDC_METRIC_SERVER_READ_BULK, local_bulk_args2->metrics_start,
+                       HG_Bulk_get_size(local_bulk_args2->bulk_handle));
 
 #ifdef PDC_TIMING
     // transfer_request_inner_read_all_bulk is purely for transferring read data from server to client.
@@ -31,6 +29,14 @@ transfer_request_all_bulk_transfer_read_cb2(const struct hg_cb_info *info)
     pdc_timestamp_register(pdc_transfer_request_inner_read_all_bulk_timestamps, start, end);
 #endif
 
+    clean_write_bulk_data(&(local_bulk_args2->request_data));
+    free(local_bulk_args2->data_buf);
+    free(local_bulk_args2->transfer_request_id);
+    HG_Bulk_free(local_bulk_args2->bulk_handle);
+    HG_Destroy(local_bulk_args2->handle);
+    free(local_bulk_args2);
+    // printf("finishing transfer_request_all_bulk_transfer_read_cb2\n");
+
     FUNC_LEAVE(ret);
 }
 
@@ -130,6 +136,7 @@ transfer_request_all_bulk_transfer_read_cb(const struct hg_cb_info *info)
     local_bulk_args2->handle              = local_bulk_args->handle;
     local_bulk_args2->transfer_request_id = local_bulk_args->transfer_request_id;
     local_bulk_args2->request_data        = request_data;
+    local_bulk_args2->metrics_start       = local_bulk_args->metrics_start;
 
     ret = HG_Bulk_create(handle_info->hg_class, 1, &(local_bulk_args2->data_buf), &total_mem_size,
                          HG_BULK_READWRITE, &(local_bulk_args2->bulk_handle));
@@ -219,6 +226,9 @@ transfer_request_all_bulk_transfer_write_cb(const struct hg_cb_info *info)
         pthread_mutex_lock(&transfer_request_status_mutex);
         PDC_finish_request(local_bulk_args->transfer_request_id[i]);
         pthread_mutex_unlock(&transfer_request_status_mutex);
+        PDC_PROFILE_FLOW(
+            "transfer_request",
+            PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, local_bulk_args->transfer_request_id[i]), 't');
     }
 #ifndef PDC_SERVER_CACHE
     for (i = 0; i < request_data.n_objs; ++i) {
@@ -226,6 +236,8 @@ transfer_request_all_bulk_transfer_write_cb(const struct hg_cb_info *info)
     }
     free(temp_ptrs);
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_WRITE_BULK, local_bulk_args->metrics_start,
+                       local_bulk_args->in.total_buf_size);
 
     clean_write_bulk_data(&request_data);
     free(local_bulk_args->transfer_request_id);
@@ -256,7 +268,7 @@ transfer_request_wait_all_bulk_transfer_cb(const struct hg_cb_info *info)
 
     pdcid_t               transfer_request_id;
     hg_return_t           ret = HG_SUCCESS;
-    int                   i, fast_return;
+    int                   i, fast_return, failed = 0;
     char *                ptr;
     int *                 handle_ref;
     pdc_transfer_status_t status;
@@ -265,13 +277,13 @@ transfer_request_wait_all_bulk_transfer_cb(const struct hg_cb_info *info)
 
     // free is in PDC_finish_request
     fast_return = 1;
-    handle_ref  = (int *)calloc(1, sizeof(int));
+    handle_ref  = (int *)calloc(2, sizeof(int));
     pthread_mutex_lock(&transfer_request_status_mutex);
     ptr = local_bulk_args->data_buf;
     for (i = 0; i < local_bulk_args->in.n_objs; ++i) {
         transfer_request_id = *((pdcid_t *)ptr);
         ptr += sizeof(pdcid_t);
-        status = PDC_check_request(transfer_request_id);
+        status = PDC_check_request(transfer_request_id, &failed);
         // printf("processing transfer_id = %llu, pdc_server_rank = %d\n", (long long
         // unsigned)transfer_request_id, get_server_rank());
         if (status == PDC_TRANSFER_STATUS_PENDING) {
@@ -290,7 +302,7 @@ transfer_request_wait_all_bulk_transfer_cb(const struct hg_cb_info *info)
     */
     if (fast_return) {
         free(handle_ref);
-        out.ret = 1;
+        out.ret = failed ? -1 : 1;
         ret     = HG_Respond(local_bulk_args->handle, NULL, NULL, &out);
         HG_Free_input(local_bulk_args->handle, &(local_bulk_args->in));
         HG_Destroy(local_bulk_args->handle);
@@ -299,12 +311,6 @@ transfer_request_wait_all_bulk_transfer_cb(const struct hg_cb_info *info)
         HG_Free_input(local_bulk_args->handle, &(local_bulk_args->in));
     }
 
-    free(local_bulk_args->data_buf);
-
-    HG_Bulk_free(local_bulk_args->bulk_handle);
-
-    free(local_bulk_args);
-
 #ifdef PDC_TIMING
     double end = MPI_Wtime();
 
@@ -312,6 +318,12 @@ transfer_request_wait_all_bulk_transfer_cb(const struct hg_cb_info *info)
     pdc_timestamp_register(pdc_transfer_request_wait_all_timestamps, local_bulk_args->start_time, end);
 #endif
 
+    free(local_bulk_args->data_buf);
+
+    HG_Bulk_free(local_bulk_args->bulk_handle);
+
+    free(local_bulk_args);
+
     FUNC_LEAVE(ret);
 }
 
@@ -370,7 +382,11 @@ transfer_request_bulk_transfer_write_cb(const struct hg_cb_info *info)
 #endif
     pthread_mutex_lock(&transfer_request_status_mutex);
     PDC_finish_request(local_bulk_args->transfer_request_id);
+    PDC_PROFILE_FLOW("transfer_request",
+                     PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, local_bulk_args->transfer_request_id), 't');
     pthread_mutex_unlock(&transfer_request_status_mutex);
+    PDC_metrics_record(PDC_METRIC_SERVER_WRITE_BULK, local_bulk_args->metrics_start,
+                       local_bulk_args->total_mem_size);
     free(local_bulk_args->data_buf);
     free(remote_reg_info);
 
@@ -401,7 +417,11 @@ transfer_request_bulk_transfer_read_cb(const struct hg_cb_info *info)
 
     pthread_mutex_lock(&transfer_request_status_mutex);
     PDC_finish_request(local_bulk_args->transfer_request_id);
+    PDC_PROFILE_FLOW("transfer_request",
+                     PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, local_bulk_args->transfer_request_id), 't');
     pthread_mutex_unlock(&transfer_request_status_mutex);
+    PDC_metrics_record(PDC_METRIC_SERVER_READ_BULK, local_bulk_args->metrics_start,
+                       local_bulk_args->total_mem_size);
 
     ret = HG_SUCCESS;
 
@@ -428,14 +448,13 @@ HG_TEST_RPC_CB(transfer_request_status, handle)
 
     // printf("entering the status function at server side @ line %d\n", __LINE__);
     pthread_mutex_lock(&transfer_request_status_mutex);
-    out.status = PDC_check_request(in.transfer_request_id);
+    out.status = PDC_check_request(in.transfer_request_id, NULL);
     pthread_mutex_unlock(&transfer_request_status_mutex);
     out.ret   = 1;
     ret_value = HG_Respond(handle, NULL, NULL, &out);
     HG_Free_input(handle, &in);
     HG_Destroy(handle);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -447,8 +466,9 @@ HG_TEST_RPC_CB(transfer_request_wait, handle)
     transfer_request_wait_in_t  in;
     transfer_request_wait_out_t out;
     pdc_transfer_status_t       status;
-    int                         fast_return = 0;
+    int                         fast_return = 0, failed = 0;
     int *                       handle_ref;
+    uint64_t                    metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 #ifdef PDC_TIMING
@@ -462,9 +482,9 @@ HG_TEST_RPC_CB(transfer_request_wait, handle)
                __LINE__);
     */
     pthread_mutex_lock(&transfer_request_status_mutex);
-    status = PDC_check_request(in.transfer_request_id);
+    status = PDC_check_request(in.transfer_request_id, &failed);
     if (status == PDC_TRANSFER_STATUS_PENDING) {
-        handle_ref = (int *)calloc(1, sizeof(int));
+        handle_ref = (int *)calloc(2, sizeof(int));
         PDC_try_finish_request(in.transfer_request_id, handle, handle_ref, 0);
     }
     else {
@@ -477,7 +497,7 @@ HG_TEST_RPC_CB(transfer_request_wait, handle)
                __LINE__);
     */
     if (fast_return) {
-        out.ret   = 1;
+        out.ret   = failed ? -1 : 1;
         ret_value = HG_Respond(handle, NULL, NULL, &out);
         HG_Free_input(handle, &in);
         HG_Destroy(handle);
@@ -497,8 +517,8 @@ HG_TEST_RPC_CB(transfer_request_wait, handle)
         pdc_timestamp_register(pdc_transfer_request_wait_write_timestamps, start, end);
     }
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_TRANSFER_REQUEST_WAIT, metrics_start, 0);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -509,7 +529,8 @@ HG_TEST_RPC_CB(transfer_request_wait_all, handle)
     struct transfer_request_wait_all_local_bulk_args *local_bulk_args;
     const struct hg_info *                            info;
     transfer_request_wait_all_in_t                    in;
-    hg_return_t                                       ret_value = HG_SUCCESS;
+    hg_return_t                                       ret_value     = HG_SUCCESS;
+    uint64_t                                          metrics_start = PDC_metrics_now();
     FUNC_ENTER(NULL);
     HG_Get_input(handle, &in);
 
@@ -534,11 +555,359 @@ HG_TEST_RPC_CB(transfer_request_wait_all, handle)
                          HG_BULK_PULL, info->addr, in.local_bulk_handle, 0, local_bulk_args->bulk_handle, 0,
 
                          local_bulk_args->in.total_buf_size, HG_OP_ID_IGNORE);
+    PDC_metrics_record(PDC_METRIC_SERVER_TRANSFER_REQUEST_WAIT_ALL, metrics_start, 0);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
+/*
+ * Split the data of a pipelined transfer_request_all into chunks of about
+ * transfer_request_pipeline_chunk_size_g bytes. Chunks end at row boundaries of the first region dimension,
+ * so the part of an object inside a chunk is a region itself. A row larger than the chunk size gets a chunk
+ * of its own.
+ */
+static void
+transfer_request_all_pipeline_split(struct transfer_request_all_pipeline *pipeline)
+{
+    transfer_request_all_data *request_data = &(pipeline->request_data);
+    uint64_t                   chunk_size   = transfer_request_pipeline_chunk_size_g;
+    uint64_t                   pos, used, rows, fit;
+    int                        i, j, n, pass;
+
+    pipeline->data_offset    = (uint64_t *)malloc(sizeof(uint64_t) * (request_data->n_objs + 1) * 2);
+    pipeline->row_size       = pipeline->data_offset + request_data->n_objs + 1;
+    pipeline->data_offset[0] = 0;
+    for (i = 0; i < request_data->n_objs; ++i) {
+        pipeline->row_size[i] = request_data->unit[i];
+        for (j = 1; j < request_data->remote_ndim[i]; ++j) {
+            pipeline->row_size[i] *= request_data->remote_length[i][j];
+        }
+        pipeline->data_offset[i + 1] =
+            pipeline->data_offset[i] + pipeline->row_size[i] * request_data->remote_length[i][0];
+    }
+
+    // The first pass counts the chunks, the second one records where they end
+    n = 0;
+    for (pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            pipeline->n_chunk         = n;
+            pipeline->chunk_offset    = (uint64_t *)malloc(sizeof(uint64_t) * (n + 1));
+            pipeline->chunk_offset[0] = 0;
+        }
+        n    = 0;
+        pos  = 0;
+        used = 0;
+        for (i = 0; i < request_data->n_objs; ++i) {
+            rows = pipeline->data_offset[i + 1] > pipeline->data_offset[i] ? request_data->remote_length[i][0]
+                                                                             : 0;
+            while (rows > 0) {
+                fit = used < chunk_size ? (chunk_size - used) / pipeline->row_size[i] : 0;
+                if (fit == 0 && used > 0) {
+                    n++;
+                    if (pass == 1)
+                        pipeline->chunk_offset[n] = pos;
+                    used = 0;
+                    continue;
+                }
+                if (fit == 0)
+                    fit = 1;
+                if (fit > rows)
+                    fit = rows;
+                pos += fit * pipeline->row_size[i];
+                used += fit * pipeline->row_size[i];
+                rows -= fit;
+            }
+        }
+        if (used > 0) {
+            n++;
+            if (pass == 1)
+                pipeline->chunk_offset[n] = pos;
+        }
+    }
+}
+
+/*
+ * Write a chunk that was pulled into buf to storage, or read a chunk from storage into buf
+ */
+static void
+transfer_request_all_pipeline_io(struct transfer_request_all_pipeline *pipeline, int chunk, char *buf)
+{
+    transfer_request_all_data *request_data = &(pipeline->request_data);
+    struct pdc_region_info     region_info;
+    uint64_t                   offset[DIM_MAX], size[DIM_MAX], start, end, lo, hi;
+    int                        i;
+
+    start = pipeline->chunk_offset[chunk];
+    end   = pipeline->chunk_offset[chunk + 1];
+    for (i = 0; i < request_data->n_objs; ++i) {
+        if (pipeline->data_offset[i + 1] <= start || pipeline->data_offset[i] >= end)
+            continue;
+        lo = start > pipeline->data_offset[i] ? start : pipeline->data_offset[i];
+        hi = end < pipeline->data_offset[i + 1] ? end : pipeline->data_offset[i + 1];
+
+        // The rows of the object inside this chunk
+        memcpy(offset, request_data->remote_offset[i], sizeof(uint64_t) * request_data->remote_ndim[i]);
+        memcpy(size, request_data->remote_length[i], sizeof(uint64_t) * request_data->remote_ndim[i]);
+        offset[0] += (lo - pipeline->data_offset[i]) / pipeline->row_size[i];
+        size[0]            = (hi - lo) / pipeline->row_size[i];
+        region_info.ndim   = request_data->remote_ndim[i];
+        region_info.offset = offset;
+        region_info.size   = size;
+#ifdef PDC_SERVER_CACHE
+        if (pipeline->in.access_type == PDC_WRITE)
+            PDC_transfer_request_data_write_out(request_data->obj_id[i], request_data->obj_ndim[i],
+                                                request_data->obj_dims[i], &region_info,
+                                                (void *)(buf + lo - start), request_data->unit[i]);
+        else
+            PDC_transfer_request_data_read_from(request_data->obj_id[i], request_data->obj_ndim[i],
+                                                request_data->obj_dims[i], &region_info,
+                                                (void *)(buf + lo - start), request_data->unit[i]);
+#else
+        PDC_Server_transfer_request_io(request_data->obj_id[i], request_data->obj_ndim[i],
+                                       request_data->obj_dims[i], &region_info, (void *)(buf + lo - start),
+                                       request_data->unit[i], pipeline->in.access_type == PDC_WRITE);
+#endif
+    }
+}
+
+static void
+transfer_request_all_pipeline_finish(struct transfer_request_all_pipeline *pipeline)
+{
+    int i;
+
+#ifdef PDC_TIMING
+    double end = MPI_Wtime();
+    if (pipeline->in.access_type == PDC_WRITE) {
+        pdc_server_timings->PDCreg_transfer_request_start_all_write_bulk_rpc += end - pipeline->start_time;
+        pdc_timestamp_register(pdc_transfer_request_start_all_write_bulk_timestamps, pipeline->start_time,
+                               end);
+    }
+    else {
+        pdc_server_timings->PDCreg_transfer_request_start_all_read_bulk_rpc += end - pipeline->start_time;
+        pdc_timestamp_register(pdc_transfer_request_start_all_read_bulk_timestamps, pipeline->start_time,
+                               end);
+    }
+#endif
+    pthread_mutex_lock(&transfer_request_status_mutex);
+    for (i = 0; i < pipeline->request_data.n_objs; ++i) {
+        if (hg_atomic_get32(&pipeline->failed))
+            PDC_fail_request(pipeline->transfer_request_id[i]);
+        PDC_finish_request(pipeline->transfer_request_id[i]);
+        PDC_PROFILE_FLOW("transfer_request",
+                         PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, pipeline->transfer_request_id[i]), 't');
+    }
+    pthread_mutex_unlock(&transfer_request_status_mutex);
+    PDC_metrics_record(pipeline->in.access_type == PDC_WRITE ? PDC_METRIC_SERVER_WRITE_BULK
+                                                             : PDC_METRIC_SERVER_READ_BULK,
+                       pipeline->metrics_start, pipeline->data_offset[pipeline->request_data.n_objs]);
+
+#ifndef PDC_SERVER_CACHE
+    for (i = 0; i < pipeline->request_data.n_objs; ++i) {
+        PDC_Server_unregister_obj_region_by_pointer(pipeline->region_ptrs[i], 1);
+    }
+    free(pipeline->region_ptrs);
+#endif
+    for (i = 0; i < pipeline->n_slot; ++i) {
+        if (pipeline->slot[i].bulk_handle != HG_BULK_NULL)
+            HG_Bulk_free(pipeline->slot[i].bulk_handle);
+        free(pipeline->slot[i].buf);
+    }
+    free(pipeline->slot);
+    clean_write_bulk_data(&(pipeline->request_data));
+    free(pipeline->header_buf);
+    free(pipeline->transfer_request_id);
+    free(pipeline->data_offset);
+    free(pipeline->chunk_offset);
+
+    HG_Free_input(pipeline->handle, &(pipeline->in));
+    HG_Destroy(pipeline->handle);
+    free(pipeline);
+}
+
+static hg_return_t transfer_request_all_pipeline_chunk_cb(const struct hg_cb_info *info);
+
+/*
+ * Count the chunk a staging buffer held as done when done is nonzero, then give the buffer the next chunk.
+ * Returns 1 when the buffer got a chunk. *last is set when every chunk is done, the caller then finishes the
+ * pipeline. The callbacks of the buffers can run concurrently on the server thread pool.
+ */
+static int
+transfer_request_all_pipeline_next(struct transfer_request_all_pipeline_slot *slot, int done, int failed,
+                                   int *last)
+{
+    struct transfer_request_all_pipeline *pipeline = slot->pipeline;
+
+    if (failed)
+        hg_atomic_set32(&pipeline->failed, 1);
+    *last = done && hg_atomic_incr32(&pipeline->n_done) == pipeline->n_chunk;
+    // A chunk taken here is not done yet, so the pipeline cannot be finished under the caller
+    slot->chunk = hg_atomic_incr32(&pipeline->next_chunk) - 1;
+    return slot->chunk < pipeline->n_chunk;
+}
+
+/*
+ * Put the chunk of a staging buffer in flight. A write pulls the chunk from the client, a read reads it from
+ * storage and pushes it to the client. A chunk that cannot be started is counted as a failed one and the
+ * buffer goes on with the next chunk.
+ */
+static void
+transfer_request_all_pipeline_post(struct transfer_request_all_pipeline_slot *slot)
+{
+    struct transfer_request_all_pipeline *pipeline    = slot->pipeline;
+    const struct hg_info *                handle_info = HG_Get_info(pipeline->handle);
+    hg_return_t                           ret;
+    uint64_t                              offset, size;
+    int                                   last = 0;
+
+    do {
+        offset = pipeline->chunk_offset[slot->chunk];
+        size   = pipeline->chunk_offset[slot->chunk + 1] - offset;
+        if (pipeline->in.access_type == PDC_WRITE) {
+            // Write data follows the region descriptors in the client buffer
+            ret = HG_Bulk_transfer(handle_info->context, transfer_request_all_pipeline_chunk_cb, slot,
+                                   HG_BULK_PULL, handle_info->addr, pipeline->in.local_bulk_handle,
+                                   pipeline->in.header_size + offset, slot->bulk_handle, 0, size,
+                                   HG_OP_ID_IGNORE);
+        }
+        else {
+            // Read data goes to the start of the client buffer
+            transfer_request_all_pipeline_io(pipeline, slot->chunk, slot->buf);
+            ret = HG_Bulk_transfer(handle_info->context, transfer_request_all_pipeline_chunk_cb, slot,
+                                   HG_BULK_PUSH, handle_info->addr, pipeline->in.local_bulk_handle, offset,
+                                   slot->bulk_handle, 0, size, HG_OP_ID_IGNORE);
+        }
+        if (ret == HG_SUCCESS)
+            return;
+        printf("==PDC_SERVER[%d]: transfer_request_all_pipeline_post(): could not start chunk %d\n",
+               pdc_server_rank_g, slot->chunk);
+    } while (transfer_request_all_pipeline_next(slot, 1, 1, &last));
+
+    if (last)
+        transfer_request_all_pipeline_finish(pipeline);
+}
+
+/*
+ * A chunk of a pipelined transfer_request_all has arrived (write) or has been delivered (read). The other
+ * staging buffers stay in flight while this one is written to storage, then it takes the next chunk.
+ */
+static hg_return_t
+transfer_request_all_pipeline_chunk_cb(const struct hg_cb_info *info)
+{
+    struct transfer_request_all_pipeline_slot *slot     = info->arg;
+    struct transfer_request_all_pipeline *     pipeline = slot->pipeline;
+    hg_return_t                                ret      = HG_SUCCESS;
+    int                                        failed   = info->ret != HG_SUCCESS;
+    int                                        last     = 0;
+
+    FUNC_ENTER(NULL);
+
+    if (failed)
+        printf("==PDC_SERVER[%d]: transfer_request_all_pipeline_chunk_cb(): chunk %d failed\n",
+               pdc_server_rank_g, slot->chunk);
+    else if (pipeline->in.access_type == PDC_WRITE)
+        transfer_request_all_pipeline_io(pipeline, slot->chunk, slot->buf);
+    if (transfer_request_all_pipeline_next(slot, 1, failed, &last))
+        transfer_request_all_pipeline_post(slot);
+    else if (last)
+        transfer_request_all_pipeline_finish(pipeline);
+
+    FUNC_LEAVE(ret);
+}
+
+/*
+ * The region descriptors of a pipelined transfer_request_all have arrived. Split its data into chunks and
+ * put the first transfer_request_pipeline_depth_g of them in flight, so the server never holds more than
+ * that many chunks of a request in memory.
+ */
+static hg_return_t
+transfer_request_all_pipeline_start(const struct hg_cb_info *info)
+{
+    struct transfer_request_all_local_bulk_args *local_bulk_args = info->arg;
+    struct transfer_request_all_pipeline *       pipeline;
+    const struct hg_info *                       handle_info;
+    hg_return_t                                  ret = HG_SUCCESS;
+    hg_size_t                                    max_size;
+    int                                          i, n_slot, last;
+
+    FUNC_ENTER(NULL);
+
+    handle_info = HG_Get_info(local_bulk_args->handle);
+    pipeline =
+        (struct transfer_request_all_pipeline *)calloc(1, sizeof(struct transfer_request_all_pipeline));
+    pipeline->handle              = local_bulk_args->handle;
+    pipeline->in                  = local_bulk_args->in;
+    pipeline->header_buf          = local_bulk_args->data_buf;
+    pipeline->transfer_request_id = local_bulk_args->transfer_request_id;
+    pipeline->metrics_start       = local_bulk_args->metrics_start;
+#ifdef PDC_TIMING
+    pipeline->start_time = local_bulk_args->start_time;
+#endif
+    HG_Bulk_free(local_bulk_args->bulk_handle);
+    free(local_bulk_args);
+
+    // Only the descriptors are in the header, so parse it the way a read request is parsed
+    pipeline->request_data.n_objs = pipeline->in.n_objs;
+    parse_bulk_data(pipeline->header_buf, &(pipeline->request_data), PDC_READ);
+    transfer_request_all_pipeline_split(pipeline);
+#ifndef PDC_SERVER_CACHE
+    pipeline->region_ptrs =
+        (data_server_region_t **)malloc(sizeof(data_server_region_t *) * pipeline->request_data.n_objs);
+    for (i = 0; i < pipeline->request_data.n_objs; ++i) {
+        pipeline->region_ptrs[i] = PDC_Server_get_obj_region(pipeline->request_data.obj_id[i]);
+        PDC_Server_register_obj_region_by_pointer(pipeline->region_ptrs + i, pipeline->request_data.obj_id[i],
+                                                  1);
+    }
+#endif
+    hg_atomic_init32(&pipeline->next_chunk, 0);
+    hg_atomic_init32(&pipeline->n_done, 0);
+    hg_atomic_init32(&pipeline->failed, 0);
+    if (pipeline->n_chunk == 0) {
+        transfer_request_all_pipeline_finish(pipeline);
+        FUNC_LEAVE(ret);
+    }
+
+    max_size = 0;
+    for (i = 0; i < pipeline->n_chunk; ++i) {
+        if (pipeline->chunk_offset[i + 1] - pipeline->chunk_offset[i] > max_size)
+            max_size = pipeline->chunk_offset[i + 1] - pipeline->chunk_offset[i];
+    }
+    pipeline->n_slot = transfer_request_pipeline_depth_g;
+    if (pipeline->n_slot > pipeline->n_chunk)
+        pipeline->n_slot = pipeline->n_chunk;
+    pipeline->slot = (struct transfer_request_all_pipeline_slot *)calloc(
+        pipeline->n_slot, sizeof(struct transfer_request_all_pipeline_slot));
+    for (i = 0; i < pipeline->n_slot; ++i) {
+        pipeline->slot[i].pipeline    = pipeline;
+        pipeline->slot[i].bulk_handle = HG_BULK_NULL;
+        pipeline->slot[i].buf         = (char *)malloc(max_size);
+        if (pipeline->slot[i].buf == NULL ||
+            HG_Bulk_create(handle_info->hg_class, 1, (void **)&(pipeline->slot[i].buf), &max_size,
+                           HG_BULK_READWRITE, &(pipeline->slot[i].bulk_handle)) != HG_SUCCESS) {
+            printf("==PDC_SERVER[%d]: transfer_request_all_pipeline_start(): could not create staging buffer "
+                   "%d\n",
+                   pdc_server_rank_g, i);
+            free(pipeline->slot[i].buf);
+            pipeline->slot[i].buf = NULL;
+            break;
+        }
+    }
+    // The buffers that could be created carry the request, without any of them it fails at once
+    n_slot           = i;
+    pipeline->n_slot = n_slot;
+    if (n_slot == 0) {
+        hg_atomic_set32(&pipeline->failed, 1);
+        transfer_request_all_pipeline_finish(pipeline);
+        FUNC_LEAVE(ret);
+    }
+    // Every buffer takes its first chunk before any is posted, a finished pipeline is freed by its callback
+    for (i = 0; i < n_slot; ++i)
+        transfer_request_all_pipeline_next(pipeline->slot + i, 0, 0, &last);
+    for (i = 0; i < n_slot; ++i)
+        transfer_request_all_pipeline_post(pipeline->slot + i);
+
+    FUNC_LEAVE(ret);
+}
+
 /* static hg_return_t */
 // transfer_request_all_cb(hg_handle_t handle)
 HG_TEST_RPC_CB(transfer_request_all, handle)
@@ -547,8 +916,9 @@ HG_TEST_RPC_CB(transfer_request_all, handle)
     const struct hg_info *                       info;
     transfer_request_all_in_t                    in;
     transfer_request_all_out_t                   out;
-    hg_return_t                                  ret_value = HG_SUCCESS;
-    int                                          i;
+    hg_return_t                                  ret_value     = HG_SUCCESS;
+    uint64_t                                     metrics_start = PDC_metrics_now();
+    int                                          i, pipelined;
 
     FUNC_ENTER(NULL);
 
@@ -561,12 +931,16 @@ HG_TEST_RPC_CB(transfer_request_all, handle)
     info            = HG_Get_info(handle);
     local_bulk_args = (struct transfer_request_all_local_bulk_args *)malloc(
         sizeof(struct transfer_request_all_local_bulk_args));
+    // A large request only pulls its region descriptors here, its data is moved in chunks afterwards
+    pipelined = transfer_request_pipeline_chunk_size_g > 0 && in.header_size > 0 &&
+                in.total_buf_size > in.header_size + transfer_request_pipeline_chunk_size_g;
 
     // Read will return to client in the first call back (after metadata for region request is received)
     local_bulk_args->handle              = handle;
-    local_bulk_args->data_buf            = malloc(in.total_buf_size);
+    local_bulk_args->data_buf            = malloc(pipelined ? in.header_size : in.total_buf_size);
     local_bulk_args->in                  = in;
     local_bulk_args->transfer_request_id = (uint64_t *)malloc(sizeof(uint64_t) * in.n_objs);
+    local_bulk_args->metrics_start       = metrics_start;
 
     pthread_mutex_lock(&transfer_request_id_mutex);
     for (i = 0; i < in.n_objs; ++i) {
@@ -578,6 +952,9 @@ HG_TEST_RPC_CB(transfer_request_all, handle)
     // Metadata ID is in ascending order. We only need to return the first value, the client knows the size.
     for (i = 0; i < in.n_objs; ++i) {
         PDC_commit_request(local_bulk_args->transfer_request_id[i]);
+        PDC_PROFILE_FLOW(
+            "transfer_request",
+            PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, local_bulk_args->transfer_request_id[i]), 's');
     }
     out.metadata_id = local_bulk_args->transfer_request_id[0];
     pthread_mutex_unlock(&transfer_request_status_mutex);
@@ -585,7 +962,16 @@ HG_TEST_RPC_CB(transfer_request_all, handle)
 #ifdef PDC_TIMING
     local_bulk_args->start_time = MPI_Wtime();
 #endif
-    if (in.access_type == PDC_WRITE) {
+    if (pipelined) {
+        ret_value = HG_Bulk_create(info->hg_class, 1, &(local_bulk_args->data_buf),
+                                   &(local_bulk_args->in.header_size), HG_BULK_READWRITE,
+                                   &(local_bulk_args->bulk_handle));
+        ret_value =
+            HG_Bulk_transfer(info->context, transfer_request_all_pipeline_start, local_bulk_args,
+                             HG_BULK_PULL, info->addr, in.local_bulk_handle, 0, local_bulk_args->bulk_handle,
+                             0, local_bulk_args->in.header_size, HG_OP_ID_IGNORE);
+    }
+    else if (in.access_type == PDC_WRITE) {
         // Write operation receives everything in the callback, so we can free the handle and respond to user
         // here.
         ret_value = HG_Bulk_create(info->hg_class, 1, &(local_bulk_args->data_buf),
@@ -622,8 +1008,8 @@ HG_TEST_RPC_CB(transfer_request_all, handle)
         pdc_timestamp_register(pdc_transfer_request_start_all_write_timestamps, start, end);
     }
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_TRANSFER_REQUEST_ALL, metrics_start, 0);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -659,7 +1045,8 @@ HG_TEST_RPC_CB(transfer_request_metadata_query, handle)
     const struct hg_info *                                  info;
     transfer_request_metadata_query_in_t                    in;
 
-    hg_return_t ret_value = HG_SUCCESS;
+    hg_return_t ret_value     = HG_SUCCESS;
+    uint64_t    metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
     HG_Get_input(handle, &in);
@@ -684,8 +1071,8 @@ HG_TEST_RPC_CB(transfer_request_metadata_query, handle)
                                  local_bulk_args->bulk_handle, 0, in.total_buf_size, HG_OP_ID_IGNORE);
 
     HG_Free_input(handle, &in);
+    PDC_metrics_record(PDC_METRIC_SERVER_TRANSFER_REQUEST_METADATA_QUERY, metrics_start, 0);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -747,7 +1134,6 @@ HG_TEST_RPC_CB(transfer_request_metadata_query2, handle)
 
     HG_Free_input(handle, &in);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -764,6 +1150,7 @@ HG_TEST_RPC_CB(transfer_request, handle)
     const struct hg_info *                   info;
     struct pdc_region_info *                 remote_reg_info;
     uint64_t                                 obj_dims[3];
+    uint64_t                                 metrics_start = PDC_metrics_now();
 
     FUNC_ENTER(NULL);
 
@@ -791,6 +1178,7 @@ HG_TEST_RPC_CB(transfer_request, handle)
     pthread_mutex_lock(&transfer_request_status_mutex);
     PDC_commit_request(out.metadata_id);
     pthread_mutex_unlock(&transfer_request_status_mutex);
+    PDC_PROFILE_FLOW("transfer_request", PDC_TRANSFER_FLOW_ID(pdc_server_rank_g, out.metadata_id), 's');
 
     local_bulk_args =
         (struct transfer_request_local_bulk_args *)malloc(sizeof(struct transfer_request_local_bulk_args));
@@ -799,6 +1187,7 @@ HG_TEST_RPC_CB(transfer_request, handle)
     local_bulk_args->data_buf            = malloc(total_mem_size);
     local_bulk_args->in                  = in;
     local_bulk_args->transfer_request_id = out.metadata_id;
+    local_bulk_args->metrics_start       = metrics_start;
 #ifdef PDC_TIMING
     local_bulk_args->start_time = MPI_Wtime();
 #endif
@@ -912,7 +1301,7 @@ HG_TEST_RPC_CB(transfer_request, handle)
         pdc_timestamp_register(pdc_transfer_request_start_write_timestamps, start, end);
     }
 #endif
+    PDC_metrics_record(PDC_METRIC_SERVER_TRANSFER_REQUEST, metrics_start, 0);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
@@ -1,5 +1,8 @@
 #include "pdc_client_server_common.h"
 #include "pdc_server_data.h"
+#include "pdc_server_query_cache.h"
+#include "pdc_server_chunk.h"
+#include "pdc_server_segment.h"
 static int io_by_region_g = 1;
 
 int
@@ -61,6 +64,7 @@ PDC_commit_request(uint64_t transfer_request_id)
         transfer_request_status_list->status              = PDC_TRANSFER_STATUS_PENDING;
         transfer_request_status_list->handle_ref          = NULL;
         transfer_request_status_list->out_type            = -1;
+        transfer_request_status_list->failed              = 0;
         transfer_request_status_list->transfer_request_id = transfer_request_id;
         transfer_request_status_list->next                = NULL;
         transfer_request_status_list_end                  = transfer_request_status_list;
@@ -71,12 +75,12 @@ PDC_commit_request(uint64_t transfer_request_id)
         ptr->next->status     = PDC_TRANSFER_STATUS_PENDING;
         ptr->next->handle_ref = NULL;
         ptr->next->out_type   = -1;
+        ptr->next->failed     = 0;
         ptr->next->transfer_request_id   = transfer_request_id;
         ptr->next->next                  = NULL;
         transfer_request_status_list_end = ptr->next;
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -103,16 +107,17 @@ PDC_finish_request(uint64_t transfer_request_id)
                 /* Wait request is going to be returned, so we are not expecting any further checks for the
                  * current request. Immediately eject the current transfer request out of the list.*/
                 ptr->handle_ref[0]--;
+                ptr->handle_ref[1] |= ptr->failed;
                 if (!ptr->handle_ref[0]) {
                     if (ptr->out_type == -1) {
                         printf("PDC SERVER PDC_finish_request out type unset error %d\n", __LINE__);
                     }
                     if (ptr->out_type) {
-                        out_all.ret = 1;
+                        out_all.ret = ptr->handle_ref[1] ? -1 : 1;
                         ret_value   = HG_Respond(ptr->handle, NULL, NULL, &out_all);
                     }
                     else {
-                        out.ret   = 1;
+                        out.ret   = ptr->handle_ref[1] ? -1 : 1;
                         ret_value = HG_Respond(ptr->handle, NULL, NULL, &out);
                     }
                     HG_Destroy(ptr->handle);
@@ -144,18 +149,40 @@ PDC_finish_request(uint64_t transfer_request_id)
         ptr = ptr->next;
     }
 
-    fflush(stdout);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Search a linked list for a transfer request and mark it failed.
+ * Thread-safe function, lock required ahead of time.
+ */
+perr_t
+PDC_fail_request(uint64_t transfer_request_id)
+{
+    pdc_transfer_request_status *ptr;
+    perr_t                       ret_value = FAIL;
+
+    FUNC_ENTER(NULL);
+
+    for (ptr = transfer_request_status_list; ptr != NULL; ptr = ptr->next) {
+        if (ptr->transfer_request_id == transfer_request_id) {
+            ptr->failed = 1;
+            ret_value   = SUCCEED;
+            break;
+        }
+    }
+
     FUNC_LEAVE(ret_value);
 }
 
 /*
  * Search a linked list for a region transfer request.
  * Remove the linked list node and free its memory.
- * Return the status of the region transfer request.
+ * Return the status of the region transfer request, *failed is set when a completed request failed.
  * Thread-safe function, lock required ahead of time.
  */
 pdc_transfer_status_t
-PDC_check_request(uint64_t transfer_request_id)
+PDC_check_request(uint64_t transfer_request_id, int *failed)
 {
     pdc_transfer_request_status *ptr, *tmp = NULL;
     pdc_transfer_status_t        ret_value = PDC_TRANSFER_STATUS_NOT_FOUND;
@@ -170,6 +197,8 @@ PDC_check_request(uint64_t transfer_request_id)
                 return ret_value;
             }
             if (ret_value == PDC_TRANSFER_STATUS_COMPLETE) {
+                if (failed != NULL)
+                    *failed |= ptr->failed;
                 if (tmp != NULL) {
                     /* Case for removing the any nodes but the first one. */
                     tmp->next = ptr->next;
@@ -196,7 +225,6 @@ PDC_check_request(uint64_t transfer_request_id)
         ptr = ptr->next;
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -224,7 +252,6 @@ PDC_try_finish_request(uint64_t transfer_request_id, hg_handle_t handle, int *ha
         ptr = ptr->next;
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -246,12 +273,13 @@ PDC_transfer_request_id_register()
     ret_value = transfer_request_id_g;
     transfer_request_id_g++;
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
 /*
  * Core I/O functions for region transfer request.
+ * Objects with fixed dims are stored in compressed chunks when PDC_CHUNK_STORAGE is set, unless they
+ * already have a flat file.
  * Nonzero io_by_region_g will trigger region by region storage. Otherwise file flatten strategy is used
  */
 #define PDC_POSIX_IO(fd, buf, io_size, is_write)                                                             \
@@ -266,22 +294,64 @@ PDC_transfer_request_id_register()
         }                                                                                                    \
     }
 
+// Data path prefix will be $SCRATCH/pdc_data/$obj_id/
+static void
+transfer_request_flat_path(uint64_t obj_id, char *storage_location)
+{
+    char *data_path                = NULL;
+    char *user_specified_data_path = NULL;
+    int   server_rank              = get_server_rank();
+
+    user_specified_data_path = getenv("PDC_DATA_LOC");
+    if (user_specified_data_path != NULL) {
+        data_path = user_specified_data_path;
+    }
+    else {
+        data_path = getenv("SCRATCH");
+        if (data_path == NULL)
+            data_path = ".";
+    }
+    snprintf(storage_location, ADDR_MAX, "%.200s/pdc_data/%" PRIu64 "/server%d/s%04d.bin", data_path, obj_id,
+             server_rank, server_rank);
+}
+
+// Check if an object was written to its flat file before segment or chunk storage was turned on
+static int
+transfer_request_has_flat_file(uint64_t obj_id)
+{
+    char storage_location[ADDR_MAX];
+
+    transfer_request_flat_path(obj_id, storage_location);
+    return access(storage_location, F_OK) == 0;
+}
+
 perr_t
 PDC_Server_transfer_request_io(uint64_t obj_id, int obj_ndim, const uint64_t *obj_dims,
                                struct pdc_region_info *region_info, void *buf, size_t unit, int is_write)
 {
     perr_t   ret_value = SUCCEED;
     int      fd;
-    char *   data_path                = NULL;
-    char *   user_specified_data_path = NULL;
     char     storage_location[ADDR_MAX];
     ssize_t  io_size;
     uint64_t i, j;
 
-    int server_rank = get_server_rank();
-
     FUNC_ENTER(NULL);
 
+    if (is_write)
+        PDC_Server_query_cache_invalidate(obj_id);
+
+    // Small objects share a few segment files instead of one file each, objects that already have a flat
+    // file keep it
+    if (PDC_Server_segment_has_obj(obj_id) ||
+        (PDC_Server_segment_enabled(obj_ndim, obj_dims, unit) && !transfer_request_has_flat_file(obj_id))) {
+        ret_value = PDC_Server_segment_io(obj_id, obj_ndim, obj_dims, region_info, buf, unit, is_write);
+        goto done;
+    }
+    if (PDC_Server_chunk_enabled(obj_ndim, obj_dims) &&
+        (PDC_Server_chunk_has_obj(obj_id) || !transfer_request_has_flat_file(obj_id))) {
+        ret_value = PDC_Server_chunk_io(obj_id, obj_ndim, obj_dims, region_info, buf, unit, is_write);
+        goto done;
+    }
     if (io_by_region_g || obj_ndim == 0) {
         // PDC_Server_register_obj_region(obj_id);
         if (is_write) {
@@ -298,18 +368,7 @@ PDC_Server_transfer_request_io(uint64_t obj_id, int obj_ndim, const uint64_t *ob
         goto done;
     }
 
-    user_specified_data_path = getenv("PDC_DATA_LOC");
-    if (user_specified_data_path != NULL) {
-        data_path = user_specified_data_path;
-    }
-    else {
-        data_path = getenv("SCRATCH");
-        if (data_path == NULL)
-            data_path = ".";
-    }
-    // Data path prefix will be $SCRATCH/pdc_data/$obj_id/
-    snprintf(storage_location, ADDR_MAX, "%.200s/pdc_data/%" PRIu64 "/server%d/s%04d.bin", data_path, obj_id,
-             server_rank, server_rank);
+    transfer_request_flat_path(obj_id, storage_location);
     PDC_mkdir(storage_location);
 
     fd = open(storage_location, O_RDWR | O_CREAT, 0666);
@@ -394,7 +453,6 @@ PDC_Server_transfer_request_io(uint64_t obj_id, int obj_ndim, const uint64_t *ob
     close(fd);
 
 done:
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -468,7 +526,6 @@ parse_bulk_data(void *buf, transfer_request_all_data *request_data, pdc_access_t
      *     remote region offset: size(uint64_t) * region_ndim
      *     remote region length: size(uint64_t) * region_ndim
      *     obj_dims: size(uint64_t) * remote_ndim
-     *     buf: computed from region length (summed up)
      */
     for (i = 0; i < request_data->n_objs; ++i) {
         request_data->remote_offset[i] = (uint64_t *)ptr;
@@ -477,7 +534,13 @@ parse_bulk_data(void *buf, transfer_request_all_data *request_data, pdc_access_t
         ptr += request_data->remote_ndim[i] * sizeof(uint64_t);
         request_data->obj_dims[i] = (uint64_t *)ptr;
         ptr += request_data->obj_ndim[i] * sizeof(uint64_t);
-        if (access_type == PDC_WRITE) {
+    }
+    /*
+     * For PDC_WRITE, the data of all objects follows in the same order, each one computed from its region
+     * length. The client may send it as separate bulk segments, they arrive back to back.
+     */
+    if (access_type == PDC_WRITE) {
+        for (i = 0; i < request_data->n_objs; ++i) {
             data_size = request_data->remote_length[i][0] * request_data->unit[i];
             for (j = 1; j < request_data->remote_ndim[i]; ++j) {
                 data_size *= request_data->remote_length[i][j];
@@ -3,11 +3,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include "pdc_region.h"
+#include "pdc_interval_tree.h"
+#include "pdc_server_placement.h"
+
+// Initial number of buckets of the object table, doubled when it holds more objects than buckets
+#define PDC_METADATA_QUERY_OBJ_TABLE_SIZE 1024
 
 typedef struct pdc_region_metadata_pkg {
     uint64_t *                      reg_offset;
     uint64_t *                      reg_size;
     uint32_t                        data_server_id;
+    uint64_t                        seq; // position in the region list of the object
     struct pdc_region_metadata_pkg *next;
 } pdc_region_metadata_pkg;
 
@@ -16,6 +22,10 @@ typedef struct pdc_obj_metadata_pkg {
     uint64_t                     obj_id;
     pdc_region_metadata_pkg *    regions;
     pdc_region_metadata_pkg *    regions_end;
+    uint64_t                     n_regions;
+    // Regions keyed by their extent [offset, offset + size] in the first dimension
+    pdc_interval_tree_t          region_tree;
+    struct pdc_obj_metadata_pkg *hash_next;
     struct pdc_obj_metadata_pkg *next;
 } pdc_obj_metadata_pkg;
 
@@ -34,7 +44,10 @@ typedef struct pdc_metadata_query_buf {
 
 static pdc_obj_metadata_pkg *  metadata_server_objs;
 static pdc_obj_metadata_pkg *  metadata_server_objs_end;
-static uint64_t *              data_server_bytes;
+static pdc_obj_metadata_pkg ** metadata_server_obj_table;
+static uint64_t                metadata_server_obj_table_size;
+static uint64_t                metadata_server_obj_count;
+static pdc_placement_t         data_server_placement;
 static int                     pdc_server_size;
 static uint64_t                query_id_g;
 static pdc_metadata_query_buf *metadata_query_buf_head;
@@ -50,6 +63,150 @@ static uint64_t transfer_request_metadata_query_append(uint64_t obj_id, int ndim
 static uint64_t metadata_query_buf_create(pdc_obj_region_metadata *regions, int size,
                                           uint64_t *total_buf_size_ptr);
 
+static inline uint64_t
+metadata_query_obj_hash(uint64_t obj_id)
+{
+    return (obj_id * 0x9e3779b97f4a7c15ULL) >> 17;
+}
+
+static pdc_obj_metadata_pkg *
+metadata_query_obj_lookup(uint64_t obj_id)
+{
+    pdc_obj_metadata_pkg *obj;
+
+    obj = metadata_server_obj_table[metadata_query_obj_hash(obj_id) % metadata_server_obj_table_size];
+    while (obj && obj->obj_id != obj_id)
+        obj = obj->hash_next;
+    return obj;
+}
+
+/*
+ * Create an object entry, append it to the object list and insert it into the object table.
+ */
+static pdc_obj_metadata_pkg *
+metadata_query_obj_create(uint64_t obj_id, int ndim)
+{
+    pdc_obj_metadata_pkg * obj, *next, **table;
+    uint64_t               i, table_size, bucket;
+
+    if (metadata_server_obj_count >= metadata_server_obj_table_size) {
+        table_size = metadata_server_obj_table_size * 2;
+        table      = (pdc_obj_metadata_pkg **)calloc(table_size, sizeof(pdc_obj_metadata_pkg *));
+        for (i = 0; i < metadata_server_obj_table_size; ++i) {
+            for (obj = metadata_server_obj_table[i]; obj; obj = next) {
+                next           = obj->hash_next;
+                bucket         = metadata_query_obj_hash(obj->obj_id) % table_size;
+                obj->hash_next = table[bucket];
+                table[bucket]  = obj;
+            }
+        }
+        free(metadata_server_obj_table);
+        metadata_server_obj_table      = table;
+        metadata_server_obj_table_size = table_size;
+    }
+
+    obj              = (pdc_obj_metadata_pkg *)malloc(sizeof(pdc_obj_metadata_pkg));
+    obj->obj_id      = obj_id;
+    obj->ndim        = ndim;
+    obj->regions     = NULL;
+    obj->regions_end = NULL;
+    obj->n_regions   = 0;
+    obj->next        = NULL;
+    PDC_interval_tree_init(&obj->region_tree);
+
+    bucket                            = metadata_query_obj_hash(obj_id) % metadata_server_obj_table_size;
+    obj->hash_next                    = metadata_server_obj_table[bucket];
+    metadata_server_obj_table[bucket] = obj;
+    metadata_server_obj_count++;
+
+    if (metadata_server_objs) {
+        metadata_server_objs_end->next = obj;
+        metadata_server_objs_end       = obj;
+    }
+    else {
+        metadata_server_objs     = obj;
+        metadata_server_objs_end = obj;
+    }
+    return obj;
+}
+
+/*
+ * Append a region to the region list of an object and index it. reg_offset and reg_size of the region must
+ * be set already.
+ */
+static void
+metadata_query_obj_add_region(pdc_obj_metadata_pkg *obj, pdc_region_metadata_pkg *region)
+{
+    region->next = NULL;
+    region->seq  = obj->n_regions++;
+    if (obj->regions) {
+        obj->regions_end->next = region;
+        obj->regions_end       = region;
+    }
+    else {
+        obj->regions     = region;
+        obj->regions_end = region;
+    }
+    PDC_interval_tree_insert(&obj->region_tree, region->reg_offset[0],
+                             region->reg_offset[0] + region->reg_size[0], region);
+}
+
+typedef struct metadata_query_contain_args {
+    int                      ndim;
+    uint64_t *               reg_offset;
+    uint64_t *               reg_size;
+    pdc_region_metadata_pkg *found;
+} metadata_query_contain_args;
+
+// Keep the earliest stored region that contains the request, as the list scan used to return
+static int
+metadata_query_contain_cb(void *data, void *arg)
+{
+    pdc_region_metadata_pkg *    region = (pdc_region_metadata_pkg *)data;
+    metadata_query_contain_args *args   = (metadata_query_contain_args *)arg;
+
+    if ((args->found == NULL || region->seq < args->found->seq) &&
+        detect_region_contained(args->reg_offset, args->reg_size, region->reg_offset, region->reg_size,
+                                args->ndim))
+        args->found = region;
+    return 0;
+}
+
+typedef struct metadata_query_overlap_args {
+    int                       ndim;
+    uint64_t *                reg_offset;
+    uint64_t *                reg_size;
+    pdc_region_metadata_pkg **matches;
+    int                       n_matches;
+    int                       n_alloc;
+} metadata_query_overlap_args;
+
+static int
+metadata_query_overlap_cb(void *data, void *arg)
+{
+    pdc_region_metadata_pkg *    region = (pdc_region_metadata_pkg *)data;
+    metadata_query_overlap_args *args   = (metadata_query_overlap_args *)arg;
+
+    if (!check_overlap(args->ndim, region->reg_offset, region->reg_size, args->reg_offset, args->reg_size))
+        return 0;
+    if (args->n_matches == args->n_alloc) {
+        args->n_alloc = args->n_alloc ? args->n_alloc * 2 : 8;
+        args->matches = (pdc_region_metadata_pkg **)realloc(args->matches, sizeof(pdc_region_metadata_pkg *) *
+                                                                               args->n_alloc);
+    }
+    args->matches[args->n_matches++] = region;
+    return 0;
+}
+
+static int
+metadata_query_region_seq_cmp(const void *a, const void *b)
+{
+    const pdc_region_metadata_pkg *r1 = *(pdc_region_metadata_pkg *const *)a;
+    const pdc_region_metadata_pkg *r2 = *(pdc_region_metadata_pkg *const *)b;
+
+    return r1->seq < r2->seq ? -1 : (r1->seq > r2->seq);
+}
+
 /**
  * Entry function for this class. Should be only called once at the beginning of Server init.
  * If checkpoint is not NULL, then load previously checkpointed metadata to static variables.
@@ -57,78 +214,78 @@ static uint64_t metadata_query_buf_create(pdc_obj_region_metadata *regions, int
 perr_t
 transfer_request_metadata_query_init(int pdc_server_size_input, char *checkpoint)
 {
-    hg_return_t ret_value = HG_SUCCESS;
-    char *      ptr;
-    int         n_objs, reg_count;
-    int         i, j;
+    hg_return_t              ret_value = HG_SUCCESS;
+    char *                   ptr;
+    int                      n_objs, reg_count, ndim;
+    int                      i, j;
+    uint64_t                 obj_id;
+    pdc_obj_metadata_pkg *   obj;
+    pdc_region_metadata_pkg *region;
+    char *                   env;
+    int                      policy;
+    double                   drain_rate, remote_cost, locality_slack;
     FUNC_ENTER(NULL);
 
-    metadata_server_objs     = NULL;
-    metadata_server_objs_end = NULL;
-    metadata_query_buf_head  = NULL;
-    metadata_query_buf_end   = NULL;
-    pdc_server_size          = pdc_server_size_input;
-    data_server_bytes        = (uint64_t *)calloc(pdc_server_size, sizeof(uint64_t));
-    query_id_g               = 100000;
-    ptr                      = checkpoint;
+    metadata_server_objs           = NULL;
+    metadata_server_objs_end       = NULL;
+    metadata_server_obj_table_size = PDC_METADATA_QUERY_OBJ_TABLE_SIZE;
+    metadata_server_obj_table =
+        (pdc_obj_metadata_pkg **)calloc(metadata_server_obj_table_size, sizeof(pdc_obj_metadata_pkg *));
+    metadata_server_obj_count = 0;
+    metadata_query_buf_head   = NULL;
+    metadata_query_buf_end    = NULL;
+    pdc_server_size           = pdc_server_size_input;
+    query_id_g                = 100000;
+    ptr                       = checkpoint;
     pthread_mutex_init(&metadata_query_mutex, NULL);
 
+    // Placement of PDC_REGION_DYNAMIC regions on data servers
+    policy = PDC_PLACEMENT_LEAST_BYTES;
+    if ((env = getenv("PDC_PLACEMENT_POLICY")) != NULL) {
+        policy = PDC_placement_policy_from_name(env);
+        if (policy < 0) {
+            printf("==PDC_SERVER: unknown PDC_PLACEMENT_POLICY %s, use bytes\n", env);
+            policy = PDC_PLACEMENT_LEAST_BYTES;
+        }
+    }
+    drain_rate     = 0;
+    remote_cost    = 0;
+    locality_slack = -1;
+    if ((env = getenv("PDC_PLACEMENT_DRAIN_RATE")) != NULL)
+        drain_rate = atof(env);
+    if ((env = getenv("PDC_PLACEMENT_REMOTE_COST")) != NULL)
+        remote_cost = atof(env);
+    if ((env = getenv("PDC_PLACEMENT_LOCALITY_SLACK")) != NULL)
+        locality_slack = atof(env);
+    PDC_placement_init(&data_server_placement, pdc_server_size, (pdc_placement_policy_t)policy, drain_rate,
+                       remote_cost, locality_slack);
+
     if (checkpoint) {
         n_objs = *(int *)ptr;
         ptr += sizeof(int);
         for (i = 0; i < n_objs; ++i) {
-            if (metadata_server_objs) {
-                metadata_server_objs_end->next =
-                    (pdc_obj_metadata_pkg *)malloc(sizeof(pdc_obj_region_metadata));
-                metadata_server_objs_end = metadata_server_objs_end->next;
-            }
-            else {
-                metadata_server_objs     = (pdc_obj_metadata_pkg *)malloc(sizeof(pdc_obj_region_metadata));
-                metadata_server_objs_end = metadata_server_objs;
-            }
-
-            metadata_server_objs_end->obj_id = *(uint64_t *)ptr;
+            obj_id = *(uint64_t *)ptr;
             ptr += sizeof(uint64_t);
-            metadata_server_objs_end->ndim = *(int *)ptr;
+            ndim = *(int *)ptr;
             ptr += sizeof(int);
             reg_count = *(int *)ptr;
             ptr += sizeof(int);
 
-            metadata_server_objs_end->regions =
-                (pdc_region_metadata_pkg *)malloc(sizeof(pdc_region_metadata_pkg));
-            metadata_server_objs_end->regions_end = metadata_server_objs_end->regions;
-
-            metadata_server_objs_end->regions_end->next = NULL;
-            metadata_server_objs_end->regions_end->reg_offset =
-                (uint64_t *)malloc(sizeof(uint64_t) * metadata_server_objs_end->ndim * 2);
-            metadata_server_objs_end->regions_end->reg_size =
-                metadata_server_objs_end->regions_end->reg_offset + metadata_server_objs_end->ndim;
-            metadata_server_objs_end->regions_end->data_server_id = *(uint32_t *)ptr;
-            ptr += sizeof(uint32_t);
-            memcpy(metadata_server_objs_end->regions_end->reg_offset, ptr,
-                   sizeof(uint64_t) * metadata_server_objs_end->ndim * 2);
-            ptr += sizeof(uint64_t) * metadata_server_objs_end->ndim * 2;
-
-            for (j = 1; j < reg_count; ++j) {
-                metadata_server_objs_end->regions->next =
-                    (pdc_region_metadata_pkg *)malloc(sizeof(pdc_region_metadata_pkg));
-                metadata_server_objs_end->regions_end = metadata_server_objs_end->regions_end->next;
-
-                metadata_server_objs_end->regions_end->next = NULL;
-                metadata_server_objs_end->regions_end->reg_offset =
-                    (uint64_t *)malloc(sizeof(uint64_t) * metadata_server_objs_end->ndim * 2);
-                metadata_server_objs_end->regions_end->reg_size =
-                    metadata_server_objs_end->regions_end->reg_offset + metadata_server_objs_end->ndim;
-                metadata_server_objs_end->regions_end->data_server_id = *(uint32_t *)ptr;
+            obj = metadata_query_obj_create(obj_id, ndim);
+            // The region indexes are not checkpointed, they are rebuilt from the region lists.
+            for (j = 0; j < reg_count; ++j) {
+                region                 = (pdc_region_metadata_pkg *)malloc(sizeof(pdc_region_metadata_pkg));
+                region->reg_offset     = (uint64_t *)malloc(sizeof(uint64_t) * ndim * 2);
+                region->reg_size       = region->reg_offset + ndim;
+                region->data_server_id = *(uint32_t *)ptr;
                 ptr += sizeof(uint32_t);
-                memcpy(metadata_server_objs_end->regions_end->reg_offset, ptr,
-                       sizeof(uint64_t) * metadata_server_objs_end->ndim * 2);
-                ptr += sizeof(uint64_t) * metadata_server_objs_end->ndim * 2;
+                memcpy(region->reg_offset, ptr, sizeof(uint64_t) * ndim * 2);
+                ptr += sizeof(uint64_t) * ndim * 2;
+                metadata_query_obj_add_region(obj, region);
             }
         }
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -152,15 +309,20 @@ transfer_request_metadata_query_finalize()
             free(region_temp2->reg_offset);
             free(region_temp2);
         }
+        PDC_interval_tree_destroy(&obj_temp->region_tree, NULL);
         obj_temp2 = obj_temp;
         obj_temp  = obj_temp->next;
         free(obj_temp2);
     }
-    metadata_server_objs = NULL;
+    metadata_server_objs     = NULL;
+    metadata_server_objs_end = NULL;
+    free(metadata_server_obj_table);
+    metadata_server_obj_table = NULL;
+    metadata_server_obj_count = 0;
+    PDC_placement_finalize(&data_server_placement);
 
     pthread_mutex_destroy(&metadata_query_mutex);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -213,12 +375,7 @@ transfer_request_metadata_query_checkpoint(char **checkpoint, uint64_t *checkpoi
         memcpy(ptr, &(obj_temp->ndim), sizeof(int));
         ptr += sizeof(int);
 
-        reg_count   = 0;
-        region_temp = obj_temp->regions;
-        while (region_temp) {
-            reg_count++;
-            region_temp = region_temp->next;
-        }
+        reg_count = (int)obj_temp->n_regions;
         memcpy(ptr, &reg_count, sizeof(int));
         ptr += sizeof(int);
 
@@ -226,7 +383,7 @@ transfer_request_metadata_query_checkpoint(char **checkpoint, uint64_t *checkpoi
         while (region_temp) {
             memcpy(ptr, &(region_temp->data_server_id), sizeof(uint32_t));
             ptr += sizeof(uint32_t);
-            memcpy(ptr, &(region_temp->reg_offset), sizeof(uint64_t) * obj_temp->ndim * 2);
+            memcpy(ptr, region_temp->reg_offset, sizeof(uint64_t) * obj_temp->ndim * 2);
             ptr += sizeof(uint64_t) * obj_temp->ndim * 2;
             region_temp = region_temp->next;
         }
@@ -234,7 +391,6 @@ transfer_request_metadata_query_checkpoint(char **checkpoint, uint64_t *checkpoi
     }
     pthread_mutex_unlock(&metadata_query_mutex);
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -245,45 +401,40 @@ transfer_request_metadata_query_checkpoint(char **checkpoint, uint64_t *checkpoi
 static uint64_t
 metadata_query_buf_create(pdc_obj_region_metadata *regions, int size, uint64_t *total_buf_size_ptr)
 {
-    pdc_obj_metadata_pkg *   temp;
-    pdc_region_metadata_pkg *region_metadata;
-    int                      i;
-    uint64_t                 total_data_size;
-    pdc_metadata_query_buf * query_buf;
-    uint64_t                 query_id;
-    uint64_t *               overlap_offset, *overlap_size;
-    char *                   ptr;
-    int *                    transfer_request_counters;
-    int                      transfer_request_counter_total;
+    pdc_obj_metadata_pkg *       temp;
+    pdc_region_metadata_pkg *    region_metadata;
+    int                          i, j;
+    uint64_t                     total_data_size;
+    pdc_metadata_query_buf *     query_buf;
+    uint64_t                     query_id;
+    uint64_t *                   overlap_offset, *overlap_size;
+    char *                       ptr;
+    int                          transfer_request_counter_total;
+    metadata_query_overlap_args *overlaps;
 
     FUNC_ENTER(NULL);
-    // Iterate through all input regions. We compute the total buf size in this loop
+    // Iterate through all input regions. We collect the overlapping regions and compute the total buf size in
+    // this loop, so the second loop does not need to search again.
     total_data_size                = sizeof(int);
     transfer_request_counter_total = 0;
-    transfer_request_counters      = (int *)calloc(size, sizeof(int));
+    overlaps = (metadata_query_overlap_args *)calloc(size, sizeof(metadata_query_overlap_args));
     for (i = 0; i < size; ++i) {
-        temp = metadata_server_objs;
-        // First check which obj list
-        while (temp) {
-            if (temp->obj_id == regions[i].obj_id) {
-                break;
-            }
-            temp = temp->next;
-        }
-        // IF found, we compare all regions and see if there are any overlaps.
+        temp = metadata_query_obj_lookup(regions[i].obj_id);
+        // IF found, we search the region index for overlaps.
         if (temp) {
-            region_metadata = temp->regions;
-            while (region_metadata) {
-                if (check_overlap(regions[i].ndim, region_metadata->reg_offset, region_metadata->reg_size,
-                                  regions[i].reg_offset, regions[i].reg_size)) {
-                    // How many regions this transfer request overlaps with.
-                    transfer_request_counters[i]++;
-                }
-                // Data server ID + region offset + region size
-                region_metadata = region_metadata->next;
-            }
-            transfer_request_counter_total += transfer_request_counters[i];
-            total_data_size += sizeof(int) + transfer_request_counters[i] *
+            overlaps[i].ndim       = regions[i].ndim;
+            overlaps[i].reg_offset = regions[i].reg_offset;
+            overlaps[i].reg_size   = regions[i].reg_size;
+            PDC_interval_tree_query_overlap(&temp->region_tree, regions[i].reg_offset[0],
+                                            regions[i].reg_offset[0] + regions[i].reg_size[0],
+                                            metadata_query_overlap_cb, overlaps + i);
+            // Keep the order in which the regions were stored
+            if (overlaps[i].n_matches > 1)
+                qsort(overlaps[i].matches, overlaps[i].n_matches, sizeof(pdc_region_metadata_pkg *),
+                      metadata_query_region_seq_cmp);
+            transfer_request_counter_total += overlaps[i].n_matches;
+            // Data server ID + region offset + region size
+            total_data_size += sizeof(int) + overlaps[i].n_matches *
                                                  (sizeof(uint32_t) + sizeof(uint64_t) * regions[i].ndim * 2);
         }
         else {
@@ -303,46 +454,26 @@ metadata_query_buf_create(pdc_obj_region_metadata *regions, int size, uint64_t *
     query_buf->id   = query_id_g;
     query_id_g++;
     ptr = query_buf->buf;
-    // printf("metadata_query_buf_create query_id = %lu, size of buf = %lu, buf address = %lld @ line %d\n",
-    // query_buf->id, total_data_size, (long long int)query_buf, __LINE__);
     memcpy(ptr, &transfer_request_counter_total, sizeof(int));
     ptr += sizeof(int);
-    // printf("metadata_query_buf_create transfer_request_counter_total = %d @ %d\n",
-    // transfer_request_counter_total, __LINE__);
     // Iterate through all input regions. We fill in the buffer.
     for (i = 0; i < size; ++i) {
-        temp = metadata_server_objs;
-        // First check which obj list
-        while (temp) {
-            if (temp->obj_id == regions[i].obj_id) {
-                break;
-            }
-            temp = temp->next;
-        }
-        // IF found, we compare all regions and see if there are any overlaps.
-        memcpy(ptr, transfer_request_counters + i, sizeof(int));
+        memcpy(ptr, &(overlaps[i].n_matches), sizeof(int));
         ptr += sizeof(int);
-        if (temp) {
-            region_metadata = temp->regions;
-            while (region_metadata) {
-                PDC_region_overlap_detect(regions[i].ndim, region_metadata->reg_offset,
-                                          region_metadata->reg_size, regions[i].reg_offset,
-                                          regions[i].reg_size, &overlap_offset, &overlap_size);
-                if (overlap_offset) {
-                    // data_server_id + region offset + region size
-                    memcpy(ptr, &(region_metadata->data_server_id), sizeof(uint32_t));
-                    ptr += sizeof(uint32_t);
-                    memcpy(ptr, overlap_offset, sizeof(uint64_t) * regions[i].ndim);
-                    ptr += sizeof(uint64_t) * regions[i].ndim;
-                    memcpy(ptr, overlap_size, sizeof(uint64_t) * regions[i].ndim);
-                    ptr += sizeof(uint64_t) * regions[i].ndim;
-                    // printf("overlapping offset = %lu, overlapping size = %lu\n", overlap_offset[0],
-                    // overlap_size[0]);
-                }
-                // overlap_size is freed together.
-                free(overlap_offset);
-                region_metadata = region_metadata->next;
-            }
+        for (j = 0; j < overlaps[i].n_matches; ++j) {
+            region_metadata = overlaps[i].matches[j];
+            PDC_region_overlap_detect(regions[i].ndim, region_metadata->reg_offset, region_metadata->reg_size,
+                                      regions[i].reg_offset, regions[i].reg_size, &overlap_offset,
+                                      &overlap_size);
+            // data_server_id + region offset + region size
+            memcpy(ptr, &(region_metadata->data_server_id), sizeof(uint32_t));
+            ptr += sizeof(uint32_t);
+            memcpy(ptr, overlap_offset, sizeof(uint64_t) * regions[i].ndim);
+            ptr += sizeof(uint64_t) * regions[i].ndim;
+            memcpy(ptr, overlap_size, sizeof(uint64_t) * regions[i].ndim);
+            ptr += sizeof(uint64_t) * regions[i].ndim;
+            // overlap_size is freed together.
+            free(overlap_offset);
         }
     }
     if (metadata_query_buf_head) {
@@ -357,7 +488,9 @@ metadata_query_buf_create(pdc_obj_region_metadata *regions, int size, uint64_t *
 done:
     *total_buf_size_ptr = total_data_size;
 
-    free(transfer_request_counters);
+    for (i = 0; i < size; ++i)
+        free(overlaps[i].matches);
+    free(overlaps);
     FUNC_LEAVE(query_id);
 }
 
@@ -399,7 +532,6 @@ transfer_request_metadata_query_lookup_query_buf(uint64_t query_id, char **buf_p
     *buf_ptr = NULL;
 done:
     pthread_mutex_unlock(&metadata_query_mutex);
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -452,7 +584,6 @@ transfer_request_metadata_query_parse(int32_t n_objs, char *buf, uint8_t is_writ
     // printf("transfer_request_metadata_query_parse: checkpoint %d\n", __LINE__);
 
     pthread_mutex_unlock(&metadata_query_mutex);
-    fflush(stdout);
     FUNC_LEAVE(query_id);
 }
 
@@ -462,8 +593,6 @@ transfer_request_metadata_reg_append(pdc_region_metadata_pkg *regions, int ndim,
                                      uint8_t region_partition)
 {
     hg_return_t ret_value = HG_SUCCESS;
-    uint64_t    min_bytes;
-    uint64_t    min_bytes_server;
     int         i;
     uint64_t    total_reg_size;
     FUNC_ENTER(NULL);
@@ -476,32 +605,21 @@ transfer_request_metadata_reg_append(pdc_region_metadata_pkg *regions, int ndim,
     memcpy(regions->reg_offset, reg_offset, sizeof(uint64_t) * ndim);
     memcpy(regions->reg_size, reg_size, sizeof(uint64_t) * ndim);
 
+    total_reg_size = unit;
+    for (i = 0; i < ndim; ++i) {
+        total_reg_size *= reg_size[i];
+    }
+    // For dynamic regions data_server_id is PDC_CLIENT_DATA_SERVER() of the writer, the locality policy
+    // prefers it. Other regions are already placed, they are only charged.
     if (region_partition == PDC_REGION_DYNAMIC) {
-        // printf("transfer_request_metadata_reg_append: checkpoint @ line %d, pdc_server_size = %d, ndim =
-        // %d\n", __LINE__, pdc_server_size, ndim);
-        min_bytes        = data_server_bytes[0];
-        min_bytes_server = 0;
-
-        for (i = 1; i < pdc_server_size; ++i) {
-            if (min_bytes > data_server_bytes[i]) {
-                min_bytes        = data_server_bytes[i];
-                min_bytes_server = i;
-            }
-        }
-        regions->data_server_id = min_bytes_server;
-        total_reg_size          = unit;
-        for (i = 0; i < ndim; ++i) {
-            total_reg_size *= reg_size[i];
-        }
-        data_server_bytes[min_bytes_server] += total_reg_size;
-        // printf("transfer_request_metadata_reg_append: checkpoint @ line %d, pdc_server_size = %d, ndim =
-        // %d, data_server_id = %d\n", __LINE__, pdc_server_size, ndim, (int) regions->data_server_id);
+        regions->data_server_id =
+            PDC_placement_select(&data_server_placement, data_server_id, total_reg_size, PDC_placement_now());
     }
     else {
         regions->data_server_id = data_server_id;
+        PDC_placement_charge(&data_server_placement, data_server_id, total_reg_size, PDC_placement_now());
     }
 
-    fflush(stdout);
     FUNC_LEAVE(ret_value);
 }
 
@@ -509,62 +627,30 @@ static uint64_t
 transfer_request_metadata_query_append(uint64_t obj_id, int ndim, uint64_t *reg_offset, uint64_t *reg_size,
                                        size_t unit, uint32_t data_server_id, uint8_t region_partition)
 {
-    pdc_obj_metadata_pkg *   temp;
-    pdc_region_metadata_pkg *region_metadata;
-    pdc_region_metadata_pkg *temp_region_metadata;
+    pdc_obj_metadata_pkg *      temp;
+    pdc_region_metadata_pkg *   temp_region_metadata;
+    metadata_query_contain_args contain_args;
 
     FUNC_ENTER(NULL);
-    // printf("transfer_request_metadata_query_append: checkpoint %d\n", __LINE__);
-    temp = metadata_server_objs;
-    while (temp) {
-        if (temp->obj_id == obj_id) {
-            break;
-        }
-        temp = temp->next;
-    }
-    // printf("transfer_request_metadata_query_append: checkpoint %d\n", __LINE__);
-    if (temp == NULL) {
-        temp = (pdc_obj_metadata_pkg *)malloc(sizeof(pdc_obj_metadata_pkg));
-        if (metadata_server_objs) {
-            metadata_server_objs_end->next = temp;
-            metadata_server_objs_end       = temp;
-        }
-        else {
-            metadata_server_objs     = temp;
-            metadata_server_objs_end = temp;
-        }
-        metadata_server_objs_end->regions     = NULL;
-        metadata_server_objs_end->regions_end = NULL;
-        metadata_server_objs_end->next        = NULL;
-        metadata_server_objs_end->obj_id      = obj_id;
-        metadata_server_objs_end->ndim        = ndim;
-    }
-    // printf("transfer_request_metadata_query_append: checkpoint %d\n", __LINE__);
-    region_metadata = temp->regions;
-    while (region_metadata) {
-        if (detect_region_contained(reg_offset, reg_size, region_metadata->reg_offset,
-                                    region_metadata->reg_size, ndim)) {
-            // printf("%lu, %lu, %lu ,%lu\n", reg_offset[0], reg_size[0], region_metadata->reg_offset[0],
-            //       region_metadata->reg_size[0]);
-            // printf("---------------transfer_request_metadata_query_append: detected repeated requests\n");
-            FUNC_LEAVE(region_metadata->data_server_id);
-        }
-        region_metadata = region_metadata->next;
-    }
+    temp = metadata_query_obj_lookup(obj_id);
+    if (temp == NULL)
+        temp = metadata_query_obj_create(obj_id, ndim);
+
+    // Repeated requests are answered with the data server of the region that already covers them.
+    contain_args.ndim       = ndim;
+    contain_args.reg_offset = reg_offset;
+    contain_args.reg_size   = reg_size;
+    contain_args.found      = NULL;
+    PDC_interval_tree_query_contain(&temp->region_tree, reg_offset[0], reg_offset[0] + reg_size[0],
+                                    metadata_query_contain_cb, &contain_args);
+    if (contain_args.found)
+        FUNC_LEAVE(contain_args.found->data_server_id);
+
     // Reaching this line means that we are creating a new region and append it to the end of the object list.
-    // printf("transfer_request_metadata_query_append: checkpoint %d\n", __LINE__);
     temp_region_metadata = (pdc_region_metadata_pkg *)malloc(sizeof(pdc_region_metadata_pkg));
-    if (temp->regions) {
-        temp->regions_end->next = temp_region_metadata;
-        temp->regions_end       = temp_region_metadata;
-    }
-    else {
-        temp->regions     = temp_region_metadata;
-        temp->regions_end = temp_region_metadata;
-    }
     transfer_request_metadata_reg_append(temp_region_metadata, ndim, reg_offset, reg_size, unit,
                                          data_server_id, region_partition);
-    // printf("transfer_request_metadata_query_append: checkpoint %d\n", __LINE__);
-    fflush(stdout);
-    FUNC_LEAVE(temp->regions_end->data_server_id);
+    metadata_query_obj_add_region(temp, temp_region_metadata);
+
+    FUNC_LEAVE(temp_region_metadata->data_server_id);
 }
@@ -0,0 +1,1136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include "pdc_config.h"
+#include "pdc_hash-table.h"
+#include "pdc_client_server_common.h"
+#include "pdc_server_segment.h"
+
+#define PDC_SEGMENT_MAGIC        "PDCSEG02"
+#define PDC_SEGMENT_RECORD_MAGIC 0x44434553U
+#define PDC_SEGMENT_TOMBSTONE    UINT64_MAX
+// An object with more extents than this is rewritten as one extent
+#define PDC_SEGMENT_MAX_EXTENT 16
+
+/*
+ * Each server appends small objects to its own segment files pdc_data/segments/server%d/seg%06d.log instead
+ * of one directory and file per object. A record is this header followed by the written extent of the
+ * object in row-major order, with the dimensions padded to 3 with leading dimensions of 1. Where extents
+ * overlap the one with the larger sequence number wins, and a record with size PDC_SEGMENT_TOMBSTONE
+ * deletes the extents written before it.
+ */
+typedef struct pdc_segment_record_t {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t obj_id;
+    uint64_t seq;      // order of the write, kept when compaction moves the record
+    uint64_t size;     // bytes of data after the header
+    uint64_t dims[3];  // dimensions of the object at the write
+    uint64_t start[3]; // the extent in elements
+    uint64_t count[3];
+} pdc_segment_record_t;
+
+typedef struct pdc_segment_extent_t {
+    uint64_t segment;
+    uint64_t offset; // offset of the record header in the segment
+    uint64_t size;   // bytes of data of the record
+    uint64_t seq;
+    uint64_t start[3];
+    uint64_t count[3];
+} pdc_segment_extent_t;
+
+typedef struct pdc_segment_entry_t {
+    uint64_t              obj_id;
+    uint64_t              dims[3]; // dimensions of the object at the last write
+    uint64_t              nextent;
+    pdc_segment_extent_t *extents; // sorted by seq
+} pdc_segment_entry_t;
+
+typedef struct pdc_segment_file_t {
+    int      fd;   // -1 once the segment is compacted and removed
+    uint64_t size; // end of the last record
+    uint64_t live; // bytes of the records the index points at
+} pdc_segment_file_t;
+
+/*
+ * The index file starts with this header, followed by the size of each segment at the checkpoint and
+ * the index entries, each one its obj_id, dims and nextent followed by its extents. Records past those
+ * sizes were appended after the checkpoint and are replayed.
+ */
+typedef struct pdc_segment_index_header_t {
+    char     magic[8];
+    uint64_t nsegment;
+    uint64_t nentry;
+    uint64_t seq;
+} pdc_segment_index_header_t;
+
+static int                 segment_enabled_g     = 0;
+static uint64_t            segment_obj_size_g    = PDC_SEGMENT_OBJ_SIZE_DEFAULT;
+static uint64_t            segment_file_size_g   = PDC_SEGMENT_FILE_SIZE_DEFAULT;
+static uint64_t            segment_compact_pct_g = PDC_SEGMENT_COMPACT_PCT_DEFAULT;
+static char                segment_dir_g[ADDR_MAX];
+static HashTable *         segment_table_g  = NULL; // obj_id -> pdc_segment_entry_t
+static pdc_segment_file_t *segment_files_g  = NULL; // the last one is the active segment
+static uint64_t            segment_nfile_g  = 0;
+static uint64_t            segment_nalloc_g = 0;
+static uint64_t            segment_seq_g    = 0; // sequence number of the last record
+static pthread_rwlock_t    segment_rwlock_g;    // reads share it, appends and compaction moves hold it alone
+static pthread_t           segment_compact_thread_g;
+static int                 segment_running_g        = 0;
+static int                 segment_compact_pending_g = 0;
+static pthread_mutex_t     segment_compact_mutex_g;
+static pthread_mutex_t     segment_checkpoint_mutex_g; // only one writer of index.tmp at a time
+static pthread_cond_t      segment_compact_cond_g;
+static pthread_mutex_t     segment_stats_mutex_g;
+static pdc_segment_stats_t segment_stats_g;
+
+static unsigned int
+segment_obj_hash(HashTableKey key)
+{
+    uint64_t obj_id = *((uint64_t *)key);
+
+    return (unsigned int)(obj_id ^ (obj_id >> 32));
+}
+
+static int
+segment_obj_equal(HashTableKey key1, HashTableKey key2)
+{
+    return *((uint64_t *)key1) == *((uint64_t *)key2);
+}
+
+static void
+segment_entry_free(HashTableValue value)
+{
+    pdc_segment_entry_t *entry = (pdc_segment_entry_t *)value;
+
+    free(entry->extents);
+    free(entry);
+}
+
+static perr_t
+segment_pread(int fd, void *buf, uint64_t size, uint64_t offset)
+{
+    uint64_t done = 0;
+    ssize_t  ret;
+
+    while (done < size) {
+        ret = pread(fd, (char *)buf + done, size - done, offset + done);
+        if (ret <= 0)
+            return FAIL;
+        done += ret;
+    }
+    return SUCCEED;
+}
+
+static perr_t
+segment_pwrite(int fd, const void *buf, uint64_t size, uint64_t offset)
+{
+    uint64_t done = 0;
+    ssize_t  ret;
+
+    while (done < size) {
+        ret = pwrite(fd, (const char *)buf + done, size - done, offset + done);
+        if (ret <= 0)
+            return FAIL;
+        done += ret;
+    }
+    return SUCCEED;
+}
+
+static uint64_t
+segment_record_size(uint64_t size)
+{
+    return sizeof(pdc_segment_record_t) + (size == PDC_SEGMENT_TOMBSTONE ? 0 : size);
+}
+
+static void
+segment_file_path(char *path, uint64_t segment)
+{
+    snprintf(path, ADDR_MAX, "%.200s/seg%06" PRIu64 ".log", segment_dir_g, segment);
+}
+
+// Wake up the compaction thread, it checks all sealed segments
+static void
+segment_compact_signal()
+{
+    pthread_mutex_lock(&segment_compact_mutex_g);
+    segment_compact_pending_g = 1;
+    pthread_cond_signal(&segment_compact_cond_g);
+    pthread_mutex_unlock(&segment_compact_mutex_g);
+}
+
+static int
+segment_need_compact(uint64_t segment)
+{
+    pdc_segment_file_t *file = &segment_files_g[segment];
+
+    return segment + 1 < segment_nfile_g && file->fd >= 0 && file->size > 0 &&
+           file->live * 100 < file->size * segment_compact_pct_g;
+}
+
+// Make room for segment id nfile in the segment table
+static perr_t
+segment_files_reserve(uint64_t nfile)
+{
+    pdc_segment_file_t *files;
+    uint64_t            nalloc;
+
+    if (nfile <= segment_nalloc_g)
+        return SUCCEED;
+    nalloc = segment_nalloc_g == 0 ? 16 : segment_nalloc_g;
+    while (nalloc < nfile)
+        nalloc *= 2;
+    files = (pdc_segment_file_t *)realloc(segment_files_g, nalloc * sizeof(pdc_segment_file_t));
+    if (files == NULL)
+        return FAIL;
+    memset(files + segment_nalloc_g, 0, (nalloc - segment_nalloc_g) * sizeof(pdc_segment_file_t));
+    segment_files_g  = files;
+    segment_nalloc_g = nalloc;
+
+    return SUCCEED;
+}
+
+// Seal the active segment and start a new one, the write lock must be held
+static perr_t
+segment_add_file()
+{
+    perr_t ret_value = SUCCEED;
+    char   path[ADDR_MAX];
+    int    fd;
+
+    FUNC_ENTER(NULL);
+
+    if (segment_files_reserve(segment_nfile_g + 1) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate segment table", pdc_server_rank_g);
+    segment_file_path(path, segment_nfile_g);
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot create segment [%s]", pdc_server_rank_g, path);
+
+    segment_files_g[segment_nfile_g].fd   = fd;
+    segment_files_g[segment_nfile_g].size = 0;
+    segment_files_g[segment_nfile_g].live = 0;
+    segment_nfile_g++;
+    // The sealed segment may already be mostly dead
+    if (segment_nfile_g > 1 && segment_need_compact(segment_nfile_g - 2))
+        segment_compact_signal();
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+// Fill the header of a record of an extent, or of a tombstone if count is NULL
+static void
+segment_record_init(pdc_segment_record_t *record, uint64_t obj_id, const uint64_t *dims,
+                    const uint64_t *start, const uint64_t *count, size_t unit)
+{
+    int d;
+
+    memset(record, 0, sizeof(*record));
+    record->magic  = PDC_SEGMENT_RECORD_MAGIC;
+    record->obj_id = obj_id;
+    record->size   = count == NULL ? PDC_SEGMENT_TOMBSTONE : unit;
+    for (d = 0; d < 3 && count != NULL; d++) {
+        record->dims[d]  = dims[d];
+        record->start[d] = start[d];
+        record->count[d] = count[d];
+        record->size *= count[d];
+    }
+}
+
+/*
+ * Append a record to the active segment, the write lock must be held. The record gets the next sequence
+ * number unless it already has one.
+ */
+static perr_t
+segment_append(pdc_segment_record_t *record, const void *buf, uint64_t *segment, uint64_t *offset)
+{
+    perr_t              ret_value = SUCCEED;
+    pdc_segment_file_t *file;
+
+    FUNC_ENTER(NULL);
+
+    file = &segment_files_g[segment_nfile_g - 1];
+    if (file->size > 0 && file->size + segment_record_size(record->size) > segment_file_size_g) {
+        if (segment_add_file() != SUCCEED)
+            PGOTO_DONE(FAIL);
+        file = &segment_files_g[segment_nfile_g - 1];
+    }
+
+    if (record->seq == 0)
+        record->seq = ++segment_seq_g;
+    // Data first, so a record cut short by a crash has no valid header past the end of the last one
+    if (buf != NULL && segment_pwrite(file->fd, buf, record->size, file->size + sizeof(*record)) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write object %" PRIu64 " to segment %" PRIu64,
+                    pdc_server_rank_g, record->obj_id, segment_nfile_g - 1);
+    if (segment_pwrite(file->fd, record, sizeof(*record), file->size) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write record of object %" PRIu64 " to segment %" PRIu64,
+                    pdc_server_rank_g, record->obj_id, segment_nfile_g - 1);
+
+    *segment = segment_nfile_g - 1;
+    *offset  = file->size;
+    file->size += segment_record_size(record->size);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+// Check if the box start/count covers the box in_start/in_count
+static int
+segment_box_covers(const uint64_t *start, const uint64_t *count, const uint64_t *in_start,
+                   const uint64_t *in_count)
+{
+    int d;
+
+    for (d = 0; d < 3; d++) {
+        if (in_start[d] < start[d] || in_start[d] + in_count[d] > start[d] + count[d])
+            return 0;
+    }
+    return 1;
+}
+
+// Intersect two boxes, return 0 if they do not overlap
+static int
+segment_box_intersect(const uint64_t *start1, const uint64_t *count1, const uint64_t *start2,
+                      const uint64_t *count2, uint64_t *start, uint64_t *count)
+{
+    uint64_t end1, end2;
+    int      d;
+
+    for (d = 0; d < 3; d++) {
+        end1     = start1[d] + count1[d];
+        end2     = start2[d] + count2[d];
+        start[d] = start1[d] > start2[d] ? start1[d] : start2[d];
+        if (start[d] >= end1 || start[d] >= end2)
+            return 0;
+        count[d] = (end1 < end2 ? end1 : end2) - start[d];
+    }
+    return 1;
+}
+
+// Copy a box from one row-major buffer to another, each buffer holds the box given by its start and count
+static void
+segment_copy_box(const uint64_t *src_start, const uint64_t *src_count, const char *src,
+                 const uint64_t *dst_start, const uint64_t *dst_count, char *dst, const uint64_t *start,
+                 const uint64_t *count, size_t unit)
+{
+    uint64_t i, j, src_row, dst_row, row = count[2] * unit;
+
+    for (i = 0; i < count[0]; i++) {
+        for (j = 0; j < count[1]; j++) {
+            src_row = (start[0] + i - src_start[0]) * src_count[1] + start[1] + j - src_start[1];
+            dst_row = (start[0] + i - dst_start[0]) * dst_count[1] + start[1] + j - dst_start[1];
+            memcpy(dst + (dst_row * dst_count[2] + start[2] - dst_start[2]) * unit,
+                   src + (src_row * src_count[2] + start[2] - src_start[2]) * unit, row);
+        }
+    }
+}
+
+// Drop an extent of an object from the index, the write lock must be held
+static void
+segment_drop_extent(pdc_segment_entry_t *entry, uint64_t i)
+{
+    pdc_segment_extent_t *extent = &entry->extents[i];
+
+    segment_files_g[extent->segment].live -= segment_record_size(extent->size);
+    if (segment_need_compact(extent->segment))
+        segment_compact_signal();
+    entry->nextent--;
+    memmove(extent, extent + 1, (entry->nextent - i) * sizeof(pdc_segment_extent_t));
+}
+
+/*
+ * Add a record to the index, the write lock must be held. The extents older than the record that it covers
+ * are dropped, and so is the record if a newer extent covers it. A tombstone drops all the older extents.
+ */
+static perr_t
+segment_index_apply(const pdc_segment_record_t *record, uint64_t segment, uint64_t offset)
+{
+    pdc_segment_entry_t * entry;
+    pdc_segment_extent_t *extent, *extents;
+    uint64_t              i, pos;
+
+    if (record->seq >= segment_seq_g)
+        segment_seq_g = record->seq;
+
+    entry = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, (HashTableKey)&record->obj_id);
+    if (record->size == PDC_SEGMENT_TOMBSTONE) {
+        if (entry == NULL)
+            return SUCCEED;
+        for (i = entry->nextent; i > 0; i--) {
+            if (entry->extents[i - 1].seq < record->seq)
+                segment_drop_extent(entry, i - 1);
+        }
+        if (entry->nextent == 0)
+            hash_table_remove(segment_table_g, (HashTableKey)&record->obj_id);
+        return SUCCEED;
+    }
+
+    if (entry == NULL) {
+        entry = (pdc_segment_entry_t *)calloc(1, sizeof(pdc_segment_entry_t));
+        if (entry == NULL)
+            return FAIL;
+        entry->obj_id = record->obj_id;
+        if (hash_table_insert(segment_table_g, &entry->obj_id, entry) != 1) {
+            free(entry);
+            return FAIL;
+        }
+    }
+    for (i = 0; i < entry->nextent; i++) {
+        extent = &entry->extents[i];
+        if (extent->seq > record->seq &&
+            segment_box_covers(extent->start, extent->count, record->start, record->count))
+            return SUCCEED;
+    }
+    for (i = entry->nextent; i > 0; i--) {
+        if (entry->extents[i - 1].seq < record->seq &&
+            segment_box_covers(record->start, record->count, entry->extents[i - 1].start,
+                               entry->extents[i - 1].count))
+            segment_drop_extent(entry, i - 1);
+    }
+
+    extents = (pdc_segment_extent_t *)realloc(entry->extents,
+                                              (entry->nextent + 1) * sizeof(pdc_segment_extent_t));
+    if (extents == NULL)
+        return FAIL;
+    entry->extents = extents;
+    // Compaction moves old records behind newer ones, keep the extents in write order
+    for (pos = entry->nextent; pos > 0 && extents[pos - 1].seq > record->seq; pos--)
+        ;
+    memmove(&extents[pos + 1], &extents[pos], (entry->nextent - pos) * sizeof(pdc_segment_extent_t));
+    if (pos == entry->nextent)
+        memcpy(entry->dims, record->dims, sizeof(entry->dims));
+    extents[pos].segment = segment;
+    extents[pos].offset  = offset;
+    extents[pos].size    = record->size;
+    extents[pos].seq     = record->seq;
+    memcpy(extents[pos].start, record->start, sizeof(record->start));
+    memcpy(extents[pos].count, record->count, sizeof(record->count));
+    entry->nextent++;
+    segment_files_g[segment].live += segment_record_size(record->size);
+
+    return SUCCEED;
+}
+
+/*
+ * Read a box of an object into buf, the lock must be held. The extents are applied in write order, and the
+ * parts no extent covers are zero.
+ */
+static perr_t
+segment_read_box(pdc_segment_entry_t *entry, const uint64_t *start, const uint64_t *count, char *buf,
+                 size_t unit)
+{
+    perr_t                ret_value = SUCCEED;
+    pdc_segment_extent_t *extent;
+    uint64_t              i, box_start[3], box_count[3], data_size = 0;
+    char *                data = NULL;
+
+    FUNC_ENTER(NULL);
+
+    memset(buf, 0, count[0] * count[1] * count[2] * unit);
+    for (i = 0; i < entry->nextent; i++) {
+        extent = &entry->extents[i];
+        if (!segment_box_intersect(extent->start, extent->count, start, count, box_start, box_count))
+            continue;
+        if (extent->size != extent->count[0] * extent->count[1] * extent->count[2] * unit)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: extent of object %" PRIu64 " does not match the type size",
+                        pdc_server_rank_g, entry->obj_id);
+        // An extent that is the whole box is read in place
+        if (memcmp(extent->start, start, sizeof(box_start)) == 0 &&
+            memcmp(extent->count, count, sizeof(box_count)) == 0) {
+            if (segment_pread(segment_files_g[extent->segment].fd, buf, extent->size,
+                              extent->offset + sizeof(pdc_segment_record_t)) != SUCCEED)
+                PGOTO_DONE(FAIL);
+            continue;
+        }
+        if (extent->size > data_size) {
+            free(data);
+            data_size = extent->size;
+            data      = (char *)malloc(data_size);
+            if (data == NULL)
+                PGOTO_DONE(FAIL);
+        }
+        if (segment_pread(segment_files_g[extent->segment].fd, data, extent->size,
+                          extent->offset + sizeof(pdc_segment_record_t)) != SUCCEED)
+            PGOTO_DONE(FAIL);
+        segment_copy_box(extent->start, extent->count, data, start, count, buf, box_start, box_count, unit);
+    }
+
+done:
+    free(data);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Replace all the extents of an object with one record holding the part of them inside dims, the write lock
+ * must be held. The entry is freed, and a tombstone first keeps the old extents dropped when the records are
+ * replayed.
+ */
+static perr_t
+segment_rewrite(pdc_segment_entry_t *entry, const uint64_t *dims, size_t unit)
+{
+    perr_t               ret_value = SUCCEED;
+    pdc_segment_record_t record;
+    uint64_t             i, start[3], end[3], count[3], box_start[3], box_count[3], obj_id = entry->obj_id;
+    uint64_t             segment, offset, zero[3] = {0, 0, 0};
+    int                  d, nbox = 0;
+    char *               buf = NULL;
+
+    FUNC_ENTER(NULL);
+
+    // Bounding box of the extents inside dims
+    for (i = 0; i < entry->nextent; i++) {
+        if (!segment_box_intersect(entry->extents[i].start, entry->extents[i].count, zero, dims, box_start,
+                                   box_count))
+            continue;
+        for (d = 0; d < 3; d++) {
+            if (nbox == 0 || box_start[d] < start[d])
+                start[d] = box_start[d];
+            if (nbox == 0 || box_start[d] + box_count[d] > end[d])
+                end[d] = box_start[d] + box_count[d];
+        }
+        nbox++;
+    }
+    if (nbox > 0) {
+        for (d = 0; d < 3; d++)
+            count[d] = end[d] - start[d];
+        buf = (char *)malloc(count[0] * count[1] * count[2] * unit);
+        if (buf == NULL)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate object %" PRIu64, pdc_server_rank_g, obj_id);
+        if (segment_read_box(entry, start, count, buf, unit) != SUCCEED)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot read object %" PRIu64 " from its segment",
+                        pdc_server_rank_g, obj_id);
+    }
+
+    segment_record_init(&record, obj_id, NULL, NULL, NULL, unit);
+    if (segment_append(&record, NULL, &segment, &offset) != SUCCEED)
+        PGOTO_DONE(FAIL);
+    segment_index_apply(&record, segment, offset);
+    if (nbox > 0) {
+        segment_record_init(&record, obj_id, dims, start, count, unit);
+        if (segment_append(&record, buf, &segment, &offset) != SUCCEED)
+            PGOTO_DONE(FAIL);
+        ret_value = segment_index_apply(&record, segment, offset);
+    }
+
+done:
+    free(buf);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Follow a change of the dimensions of an object made with PDCobj_set_dims, the write lock must be held.
+ * Extents keep their place when the object grows, the data cut off when it shrinks is dropped so it does
+ * not come back if the object grows again.
+ */
+static perr_t
+segment_resize(pdc_segment_entry_t *entry, const uint64_t *dims, size_t unit)
+{
+    int d;
+
+    for (d = 0; d < 3; d++) {
+        if (dims[d] < entry->dims[d])
+            return segment_rewrite(entry, dims, unit);
+    }
+    memcpy(entry->dims, dims, sizeof(entry->dims));
+
+    return SUCCEED;
+}
+
+/*
+ * Move one record of a sealed segment to the active segment if the index still points at it. The record
+ * keeps its sequence number, so it still loses to newer extents when it is replayed after them.
+ */
+static void
+segment_compact_record(uint64_t victim, uint64_t offset, pdc_segment_record_t *record, char *data)
+{
+    pdc_segment_entry_t * entry;
+    pdc_segment_extent_t *extent = NULL;
+    uint64_t              i, segment, new_offset;
+
+    pthread_rwlock_wrlock(&segment_rwlock_g);
+    entry = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, &record->obj_id);
+    for (i = 0; entry != NULL && i < entry->nextent; i++) {
+        if (entry->extents[i].segment == victim && entry->extents[i].offset == offset)
+            extent = &entry->extents[i];
+    }
+    if (extent != NULL &&
+        segment_pread(segment_files_g[victim].fd, data, record->size, offset + sizeof(*record)) == SUCCEED &&
+        segment_append(record, data, &segment, &new_offset) == SUCCEED) {
+        segment_files_g[victim].live -= segment_record_size(record->size);
+        segment_files_g[segment].live += segment_record_size(record->size);
+        extent->segment = segment;
+        extent->offset  = new_offset;
+
+        pthread_mutex_lock(&segment_stats_mutex_g);
+        segment_stats_g.compact_bytes += record->size;
+        pthread_mutex_unlock(&segment_stats_mutex_g);
+    }
+    pthread_rwlock_unlock(&segment_rwlock_g);
+}
+
+/*
+ * Copy the live records of a sealed segment to the active segment and remove it. The lock is taken for
+ * each record, so reads and writes go on while a segment is compacted. Tombstones are not copied. An
+ * older segment can still hold a record one of them deletes, so the index is checkpointed before a segment
+ * with tombstones is removed, and neither the index nor the replay brings the object back after a crash.
+ */
+static void
+segment_compact(uint64_t victim)
+{
+    pdc_segment_record_t record;
+    uint64_t             offset = 0, end;
+    char *               data   = NULL;
+    char                 path[ADDR_MAX];
+    int                  fd, ntombstone = 0;
+
+    // Only this thread removes segments, and sealed segments do not grow
+    pthread_rwlock_rdlock(&segment_rwlock_g);
+    fd  = segment_files_g[victim].fd;
+    end = segment_files_g[victim].size;
+    pthread_rwlock_unlock(&segment_rwlock_g);
+    if (fd < 0)
+        return;
+
+    while (offset < end) {
+        if (segment_pread(fd, &record, sizeof(record), offset) != SUCCEED ||
+            record.magic != PDC_SEGMENT_RECORD_MAGIC)
+            break;
+        if (record.size != PDC_SEGMENT_TOMBSTONE) {
+            data = (char *)malloc(record.size);
+            if (data == NULL)
+                break;
+            segment_compact_record(victim, offset, &record, data);
+            free(data);
+        }
+        else
+            ntombstone++;
+        offset += segment_record_size(record.size);
+    }
+    if (ntombstone > 0 && PDC_Server_segment_checkpoint() != SUCCEED)
+        return;
+
+    pthread_rwlock_wrlock(&segment_rwlock_g);
+    if (segment_files_g[victim].live == 0) {
+        close(segment_files_g[victim].fd);
+        segment_files_g[victim].fd = -1;
+        segment_file_path(path, victim);
+        unlink(path);
+
+        pthread_mutex_lock(&segment_stats_mutex_g);
+        segment_stats_g.ncompact++;
+        pthread_mutex_unlock(&segment_stats_mutex_g);
+    }
+    pthread_rwlock_unlock(&segment_rwlock_g);
+}
+
+static void *
+segment_compact_worker(void *arg)
+{
+    uint64_t i, nfile;
+
+    (void)arg;
+    pthread_mutex_lock(&segment_compact_mutex_g);
+    while (segment_running_g) {
+        if (!segment_compact_pending_g) {
+            pthread_cond_wait(&segment_compact_cond_g, &segment_compact_mutex_g);
+            continue;
+        }
+        segment_compact_pending_g = 0;
+        pthread_mutex_unlock(&segment_compact_mutex_g);
+
+        pthread_rwlock_rdlock(&segment_rwlock_g);
+        nfile = segment_nfile_g;
+        pthread_rwlock_unlock(&segment_rwlock_g);
+        for (i = 0; i + 1 < nfile && segment_running_g; i++) {
+            pthread_rwlock_rdlock(&segment_rwlock_g);
+            if (!segment_need_compact(i)) {
+                pthread_rwlock_unlock(&segment_rwlock_g);
+                continue;
+            }
+            pthread_rwlock_unlock(&segment_rwlock_g);
+            segment_compact(i);
+        }
+
+        pthread_mutex_lock(&segment_compact_mutex_g);
+    }
+    pthread_mutex_unlock(&segment_compact_mutex_g);
+
+    return NULL;
+}
+
+// Load the index saved by the last checkpoint and open the segments it knows about
+static perr_t
+segment_load_index()
+{
+    perr_t                     ret_value = SUCCEED;
+    pdc_segment_index_header_t header;
+    pdc_segment_entry_t *      entry;
+    uint64_t *                 sizes = NULL;
+    uint64_t                   i, j, segment;
+    char                       path[ADDR_MAX];
+    FILE *                     file;
+
+    FUNC_ENTER(NULL);
+
+    snprintf(path, ADDR_MAX, "%.200s/index", segment_dir_g);
+    file = fopen(path, "r");
+    if (file == NULL)
+        PGOTO_DONE(SUCCEED);
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, PDC_SEGMENT_MAGIC, sizeof(header.magic)) != 0)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: bad segment index [%s]", pdc_server_rank_g, path);
+
+    sizes = (uint64_t *)malloc((header.nsegment + 1) * sizeof(uint64_t));
+    if (sizes == NULL || segment_files_reserve(header.nsegment) != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate segment table", pdc_server_rank_g);
+    if (fread(sizes, sizeof(uint64_t), header.nsegment, file) != header.nsegment)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot read segment index [%s]", pdc_server_rank_g, path);
+    for (i = 0; i < header.nsegment; i++) {
+        segment_file_path(path, i);
+        segment_files_g[i].fd   = open(path, O_RDWR);
+        segment_files_g[i].size = segment_files_g[i].fd < 0 ? 0 : sizes[i];
+    }
+    segment_nfile_g = header.nsegment;
+    segment_seq_g   = header.seq;
+
+    for (i = 0; i < header.nentry; i++) {
+        entry = (pdc_segment_entry_t *)calloc(1, sizeof(pdc_segment_entry_t));
+        if (entry == NULL)
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot allocate segment index", pdc_server_rank_g);
+        if (fread(&entry->obj_id, sizeof(uint64_t), 1, file) == 1 &&
+            fread(entry->dims, sizeof(uint64_t), 3, file) == 3 &&
+            fread(&entry->nextent, sizeof(uint64_t), 1, file) == 1 && entry->nextent > 0)
+            entry->extents = (pdc_segment_extent_t *)malloc(entry->nextent * sizeof(pdc_segment_extent_t));
+        if (entry->extents == NULL ||
+            fread(entry->extents, sizeof(pdc_segment_extent_t), entry->nextent, file) != entry->nextent) {
+            segment_entry_free(entry);
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: segment index is cut short", pdc_server_rank_g);
+        }
+        for (j = 0; j < entry->nextent; j++) {
+            segment = entry->extents[j].segment;
+            if (segment >= segment_nfile_g || segment_files_g[segment].fd < 0)
+                break;
+        }
+        if (j < entry->nextent || hash_table_insert(segment_table_g, &entry->obj_id, entry) != 1)
+            segment_entry_free(entry);
+    }
+
+done:
+    if (file != NULL)
+        fclose(file);
+    free(sizes);
+    FUNC_LEAVE(ret_value);
+}
+
+/*
+ * Open the segments created after the last checkpoint and apply the records appended after it, in the
+ * order they were written. A record cut short by a crash ends its segment.
+ */
+static perr_t
+segment_replay()
+{
+    pdc_segment_record_t record;
+    pdc_segment_file_t * file;
+    HashTableIterator    iter;
+    pdc_segment_entry_t *entry;
+    struct stat          st;
+    struct dirent *      dent;
+    DIR *                dir;
+    char                 path[ADDR_MAX];
+    uint64_t             i, j, offset, segment, nfile = segment_nfile_g;
+
+    FUNC_ENTER(NULL);
+
+    // Compaction leaves gaps in the segment ids, so look for the last one in the directory
+    dir = opendir(segment_dir_g);
+    while (dir != NULL && (dent = readdir(dir)) != NULL) {
+        if (sscanf(dent->d_name, "seg%" SCNu64 ".log", &segment) == 1 && segment >= nfile)
+            nfile = segment + 1;
+    }
+    if (dir != NULL)
+        closedir(dir);
+    if (segment_files_reserve(nfile) != SUCCEED)
+        FUNC_LEAVE(FAIL);
+    for (i = segment_nfile_g; i < nfile; i++) {
+        segment_file_path(path, i);
+        segment_files_g[i].fd   = open(path, O_RDWR);
+        segment_files_g[i].size = 0;
+    }
+    segment_nfile_g = nfile;
+
+    for (i = 0; i < segment_nfile_g; i++) {
+        file = &segment_files_g[i];
+        if (file->fd < 0 || fstat(file->fd, &st) != 0)
+            continue;
+        offset = file->size;
+        while (offset + sizeof(record) <= (uint64_t)st.st_size) {
+            if (segment_pread(file->fd, &record, sizeof(record), offset) != SUCCEED ||
+                record.magic != PDC_SEGMENT_RECORD_MAGIC ||
+                offset + segment_record_size(record.size) > (uint64_t)st.st_size)
+                break;
+            segment_index_apply(&record, i, offset);
+            offset += segment_record_size(record.size);
+        }
+        if (offset < (uint64_t)st.st_size && ftruncate(file->fd, offset) != 0)
+            printf("==PDC_SERVER[%d]: cannot truncate segment %" PRIu64 "\n", pdc_server_rank_g, i);
+        file->size = offset;
+    }
+
+    // Recount the live bytes of every segment from the index
+    for (i = 0; i < segment_nfile_g; i++)
+        segment_files_g[i].live = 0;
+    hash_table_iterate(segment_table_g, &iter);
+    while (hash_table_iter_has_more(&iter)) {
+        entry = (pdc_segment_entry_t *)hash_table_iter_next(&iter).value;
+        for (j = 0; j < entry->nextent; j++)
+            segment_files_g[entry->extents[j].segment].live += segment_record_size(entry->extents[j].size);
+    }
+
+    FUNC_LEAVE(SUCCEED);
+}
+
+perr_t
+PDC_Server_segment_init()
+{
+    perr_t ret_value = SUCCEED;
+    char   path[ADDR_MAX];
+    char * p;
+
+    FUNC_ENTER(NULL);
+
+    p = getenv("PDC_SEGMENT_STORAGE");
+    if (p == NULL || atoi(p) == 0)
+        PGOTO_DONE(SUCCEED);
+    p = getenv("PDC_SEGMENT_OBJ_SIZE");
+    if (p != NULL && strtoull(p, NULL, 10) > 0)
+        segment_obj_size_g = strtoull(p, NULL, 10);
+    p = getenv("PDC_SEGMENT_FILE_SIZE");
+    if (p != NULL && strtoull(p, NULL, 10) > 0)
+        segment_file_size_g = strtoull(p, NULL, 10);
+    p = getenv("PDC_SEGMENT_COMPACT_PCT");
+    if (p != NULL)
+        segment_compact_pct_g = strtoull(p, NULL, 10);
+
+    p = getenv("PDC_DATA_LOC");
+    if (p == NULL)
+        p = getenv("SCRATCH");
+    if (p == NULL)
+        p = ".";
+    snprintf(segment_dir_g, ADDR_MAX, "%.200s/pdc_data/segments/server%d", p, pdc_server_rank_g);
+    // PDC_mkdir creates the directories of a file path
+    snprintf(path, ADDR_MAX, "%.250s/index", segment_dir_g);
+    PDC_mkdir(path);
+
+    memset(&segment_stats_g, 0, sizeof(pdc_segment_stats_t));
+    pthread_rwlock_init(&segment_rwlock_g, NULL);
+    pthread_mutex_init(&segment_compact_mutex_g, NULL);
+    pthread_mutex_init(&segment_checkpoint_mutex_g, NULL);
+    pthread_cond_init(&segment_compact_cond_g, NULL);
+    pthread_mutex_init(&segment_stats_mutex_g, NULL);
+
+    segment_table_g = hash_table_new(segment_obj_hash, segment_obj_equal);
+    if (segment_table_g == NULL)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: error creating segment index", pdc_server_rank_g);
+    // Keys point into their values, only free the values
+    hash_table_register_free_functions(segment_table_g, NULL, segment_entry_free);
+
+    if (segment_load_index() != SUCCEED || segment_replay() != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot recover segment storage", pdc_server_rank_g);
+    if (segment_nfile_g == 0 || segment_files_g[segment_nfile_g - 1].fd < 0) {
+        if (segment_add_file() != SUCCEED)
+            PGOTO_DONE(FAIL);
+    }
+
+    segment_running_g = 1;
+    if (pthread_create(&segment_compact_thread_g, NULL, segment_compact_worker, NULL) != 0) {
+        segment_running_g = 0;
+        printf("==PDC_SERVER[%d]: cannot start the segment compaction thread\n", pdc_server_rank_g);
+    }
+    segment_enabled_g = 1;
+    // Segments left mostly dead by the last run
+    segment_compact_signal();
+
+    if (pdc_server_rank_g == 0)
+        printf("==PDC_SERVER[0]: segment storage on for objects up to %" PRIu64 " bytes, %" PRIu64
+               " byte segments, %" PRIu64 " objects recovered\n",
+               segment_obj_size_g, segment_file_size_g, (uint64_t)hash_table_num_entries(segment_table_g));
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_segment_finalize()
+{
+    uint64_t i;
+
+    FUNC_ENTER(NULL);
+
+    if (!segment_enabled_g)
+        FUNC_LEAVE(SUCCEED);
+
+    if (segment_running_g) {
+        pthread_mutex_lock(&segment_compact_mutex_g);
+        segment_running_g = 0;
+        pthread_cond_signal(&segment_compact_cond_g);
+        pthread_mutex_unlock(&segment_compact_mutex_g);
+        pthread_join(segment_compact_thread_g, NULL);
+    }
+
+    PDC_Server_segment_checkpoint();
+    if (segment_stats_g.nobj_write > 0)
+        PDC_LOG_INFO("segment storage wrote %" PRIu64 " objects, %.1f MB, compacted %" PRIu64
+                     " segments moving %.1f MB",
+                     segment_stats_g.nobj_write, segment_stats_g.write_bytes / 1048576.0,
+                     segment_stats_g.ncompact, segment_stats_g.compact_bytes / 1048576.0);
+
+    pthread_rwlock_wrlock(&segment_rwlock_g);
+    segment_enabled_g = 0;
+    hash_table_free(segment_table_g);
+    segment_table_g = NULL;
+    for (i = 0; i < segment_nfile_g; i++) {
+        if (segment_files_g[i].fd >= 0)
+            close(segment_files_g[i].fd);
+    }
+    free(segment_files_g);
+    segment_files_g  = NULL;
+    segment_nfile_g  = 0;
+    segment_nalloc_g = 0;
+    pthread_rwlock_unlock(&segment_rwlock_g);
+
+    pthread_rwlock_destroy(&segment_rwlock_g);
+    pthread_mutex_destroy(&segment_compact_mutex_g);
+    pthread_mutex_destroy(&segment_checkpoint_mutex_g);
+    pthread_cond_destroy(&segment_compact_cond_g);
+    pthread_mutex_destroy(&segment_stats_mutex_g);
+
+    FUNC_LEAVE(SUCCEED);
+}
+
+int
+PDC_Server_segment_enabled(int ndim, const uint64_t *dims, size_t unit)
+{
+    uint64_t size = unit;
+    int      d;
+
+    if (!segment_enabled_g || ndim < 1 || ndim > 3 || dims == NULL)
+        return 0;
+    for (d = 0; d < ndim; d++) {
+        if (dims[d] == 0 || dims[d] > segment_obj_size_g)
+            return 0;
+        size *= dims[d];
+        if (size > segment_obj_size_g)
+            return 0;
+    }
+    return 1;
+}
+
+int
+PDC_Server_segment_has_obj(uint64_t obj_id)
+{
+    int ret_value;
+
+    if (!segment_enabled_g)
+        return 0;
+    pthread_rwlock_rdlock(&segment_rwlock_g);
+    ret_value = hash_table_lookup(segment_table_g, &obj_id) != NULL;
+    pthread_rwlock_unlock(&segment_rwlock_g);
+
+    return ret_value;
+}
+
+perr_t
+PDC_Server_segment_io(uint64_t obj_id, int ndim, const uint64_t *dims, struct pdc_region_info *region_info,
+                      void *buf, size_t unit, int is_write)
+{
+    perr_t               ret_value = SUCCEED;
+    pdc_segment_entry_t *entry;
+    pdc_segment_record_t record;
+    uint64_t             obj_dims[3], offset[3], size[3], region_size, segment, record_offset;
+    int                  d, pad = 3 - ndim, write_locked = is_write;
+
+    FUNC_ENTER(NULL);
+
+    if ((int)region_info->ndim != ndim)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: region ndim %zu does not match object ndim %d",
+                    pdc_server_rank_g, region_info->ndim, ndim);
+
+    region_size = unit;
+    for (d = 0; d < 3; d++) {
+        obj_dims[d] = d < pad ? 1 : dims[d - pad];
+        offset[d]   = d < pad ? 0 : region_info->offset[d - pad];
+        size[d]     = d < pad ? 1 : region_info->size[d - pad];
+        if (size[d] == 0)
+            PGOTO_DONE(SUCCEED);
+        if (offset[d] + size[d] > obj_dims[d])
+            PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: region is outside object %" PRIu64, pdc_server_rank_g,
+                        obj_id);
+        region_size *= size[d];
+    }
+
+    if (write_locked)
+        pthread_rwlock_wrlock(&segment_rwlock_g);
+    else
+        pthread_rwlock_rdlock(&segment_rwlock_g);
+    entry = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, &obj_id);
+    // A read after PDCobj_set_dims waits for the write lock to follow the new dims first
+    if (!write_locked && entry != NULL && memcmp(entry->dims, obj_dims, sizeof(obj_dims)) != 0) {
+        pthread_rwlock_unlock(&segment_rwlock_g);
+        pthread_rwlock_wrlock(&segment_rwlock_g);
+        write_locked = 1;
+        entry        = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, &obj_id);
+    }
+    if (entry != NULL && memcmp(entry->dims, obj_dims, sizeof(obj_dims)) != 0) {
+        ret_value = segment_resize(entry, obj_dims, unit);
+        entry     = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, &obj_id);
+    }
+
+    if (ret_value == SUCCEED && is_write) {
+        // Only the written extent is appended, the index keeps the parts of older extents outside it
+        segment_record_init(&record, obj_id, obj_dims, offset, size, unit);
+        ret_value = segment_append(&record, buf, &segment, &record_offset);
+        if (ret_value == SUCCEED)
+            ret_value = segment_index_apply(&record, segment, record_offset);
+        entry = (pdc_segment_entry_t *)hash_table_lookup(segment_table_g, &obj_id);
+        if (ret_value == SUCCEED && entry != NULL && entry->nextent > PDC_SEGMENT_MAX_EXTENT)
+            ret_value = segment_rewrite(entry, obj_dims, unit);
+    }
+    else if (ret_value == SUCCEED && entry == NULL)
+        memset(buf, 0, region_size);
+    else if (ret_value == SUCCEED)
+        ret_value = segment_read_box(entry, offset, size, (char *)buf, unit);
+    pthread_rwlock_unlock(&segment_rwlock_g);
+    if (ret_value != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot %s object %" PRIu64 " in its segment", pdc_server_rank_g,
+                    is_write ? "write" : "read", obj_id);
+
+    pthread_mutex_lock(&segment_stats_mutex_g);
+    if (is_write) {
+        segment_stats_g.nobj_write++;
+        segment_stats_g.write_bytes += region_size;
+    }
+    else
+        segment_stats_g.nobj_read++;
+    pthread_mutex_unlock(&segment_stats_mutex_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_segment_delete(uint64_t obj_id)
+{
+    perr_t               ret_value = SUCCEED;
+    pdc_segment_record_t record;
+    uint64_t             segment, offset;
+
+    FUNC_ENTER(NULL);
+
+    if (!segment_enabled_g)
+        PGOTO_DONE(SUCCEED);
+
+    pthread_rwlock_wrlock(&segment_rwlock_g);
+    if (hash_table_lookup(segment_table_g, &obj_id) != NULL) {
+        // The tombstone keeps the object deleted when records after the checkpoint are replayed
+        segment_record_init(&record, obj_id, NULL, NULL, NULL, 0);
+        ret_value = segment_append(&record, NULL, &segment, &offset);
+        if (ret_value == SUCCEED)
+            segment_index_apply(&record, segment, offset);
+    }
+    pthread_rwlock_unlock(&segment_rwlock_g);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+perr_t
+PDC_Server_segment_checkpoint()
+{
+    perr_t                     ret_value = SUCCEED;
+    pdc_segment_index_header_t header;
+    HashTableIterator          iter;
+    pdc_segment_entry_t *      entry;
+    char                       path[ADDR_MAX], tmp_path[ADDR_MAX];
+    uint64_t                   i;
+    FILE *                     file = NULL;
+
+    FUNC_ENTER(NULL);
+
+    if (!segment_enabled_g)
+        PGOTO_DONE(SUCCEED);
+
+    snprintf(path, ADDR_MAX, "%.200s/index", segment_dir_g);
+    snprintf(tmp_path, ADDR_MAX, "%.200s/index.tmp", segment_dir_g);
+
+    // The server and the compaction thread both checkpoint, only one of them writes index.tmp at a time
+    pthread_mutex_lock(&segment_checkpoint_mutex_g);
+    // Readers go on, appends and compaction wait until the index is written
+    pthread_rwlock_rdlock(&segment_rwlock_g);
+    file = fopen(tmp_path, "w");
+    if (file == NULL) {
+        pthread_rwlock_unlock(&segment_rwlock_g);
+        pthread_mutex_unlock(&segment_checkpoint_mutex_g);
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot create segment index [%s]", pdc_server_rank_g, tmp_path);
+    }
+
+    // The records the index points at must reach the disk before the index does
+    for (i = 0; i < segment_nfile_g; i++) {
+        if (segment_files_g[i].fd >= 0)
+            fsync(segment_files_g[i].fd);
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PDC_SEGMENT_MAGIC, sizeof(header.magic));
+    header.nsegment = segment_nfile_g;
+    header.nentry   = hash_table_num_entries(segment_table_g);
+    header.seq      = segment_seq_g;
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+        ret_value = FAIL;
+    for (i = 0; i < segment_nfile_g && ret_value == SUCCEED; i++) {
+        if (fwrite(&segment_files_g[i].size, sizeof(uint64_t), 1, file) != 1)
+            ret_value = FAIL;
+    }
+    hash_table_iterate(segment_table_g, &iter);
+    while (ret_value == SUCCEED && hash_table_iter_has_more(&iter)) {
+        entry = (pdc_segment_entry_t *)hash_table_iter_next(&iter).value;
+        if (fwrite(&entry->obj_id, sizeof(uint64_t), 1, file) != 1 ||
+            fwrite(entry->dims, sizeof(uint64_t), 3, file) != 3 ||
+            fwrite(&entry->nextent, sizeof(uint64_t), 1, file) != 1 ||
+            fwrite(entry->extents, sizeof(pdc_segment_extent_t), entry->nextent, file) != entry->nextent)
+            ret_value = FAIL;
+    }
+    if (fflush(file) != 0 || fsync(fileno(file)) != 0)
+        ret_value = FAIL;
+    fclose(file);
+    if (ret_value == SUCCEED && rename(tmp_path, path) != 0)
+        ret_value = FAIL;
+    pthread_rwlock_unlock(&segment_rwlock_g);
+    pthread_mutex_unlock(&segment_checkpoint_mutex_g);
+
+    if (ret_value != SUCCEED)
+        PGOTO_ERROR(FAIL, "==PDC_SERVER[%d]: cannot write segment index [%s]", pdc_server_rank_g, path);
+
+done:
+    FUNC_LEAVE(ret_value);
+}
+
+void
+PDC_Server_segment_get_stats(pdc_segment_stats_t *stats)
+{
+    if (!segment_enabled_g) {
+        memset(stats, 0, sizeof(pdc_segment_stats_t));
+        return;
+    }
+    pthread_mutex_lock(&segment_stats_mutex_g);
+    *stats = segment_stats_g;
+    pthread_mutex_unlock(&segment_stats_mutex_g);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Compare the dablooms counting bloom filter the metadata server used to keep per hash table bucket with
+ * the blocked bloom filter that replaced it: memory per million objects and lookup throughput.
+ *
+ * Usage: ./bloom_bench [nobj] [bucket_size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "pdc_dablooms.h"
+#include "pdc_bloom.h"
+
+// Settings of the dablooms filter in the metadata server
+#define DABLOOMS_CAPACITY   500000
+#define DABLOOMS_ERROR_RATE 0.05
+#define NAME_LEN            64
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+static size_t
+dablooms_size(counting_bloom_t *bloom)
+{
+    return sizeof(counting_bloom_t) + bloom->num_bytes + bloom->nfuncs * sizeof(uint32_t);
+}
+
+// The metadata server keys dablooms on the object name followed by the timestep
+static void
+combine_key(char *key, const char *name, int ts)
+{
+    snprintf(key, NAME_LEN, "%s%d", name, ts);
+}
+
+int
+main(int argc, char **argv)
+{
+    int               nobj = 1000000, bucket_size = 128, nbucket, i, found;
+    char              key[NAME_LEN], *names, *name;
+    counting_bloom_t *dab;
+    pdc_bloom_t *     blk;
+    struct timeval    start, end;
+    double            dab_sec, blk_sec;
+    size_t            dab_bytes, blk_bytes;
+    int               dab_fp = 0, blk_fp = 0;
+
+    if (argc > 1)
+        nobj = atoi(argv[1]);
+    if (argc > 2)
+        bucket_size = atoi(argv[2]);
+    if (nobj <= 0 || bucket_size <= 0) {
+        printf("Usage: %s [nobj] [bucket_size]\n", argv[0]);
+        return 1;
+    }
+    nbucket = (nobj + bucket_size - 1) / bucket_size;
+
+    // Memory: the server allocates one filter per bucket once it holds CREATE_BLOOM_THRESHOLD objects
+    dab = new_counting_bloom(DABLOOMS_CAPACITY, DABLOOMS_ERROR_RATE);
+    blk = PDC_bloom_new(2 * ((uint64_t)bucket_size + 1));
+    if (dab == NULL || blk == NULL) {
+        printf("Error creating bloom filters\n");
+        return 1;
+    }
+    dab_bytes = dablooms_size(dab);
+    blk_bytes = PDC_bloom_size(blk);
+    printf("%d objects in %d buckets of %d\n", nobj, nbucket, bucket_size);
+    printf("dablooms: %zu bytes per bucket, %.2f MB per million objects\n", dab_bytes,
+           (double)dab_bytes * nbucket / 1048576.0 * 1000000.0 / nobj);
+    printf("blocked : %zu bytes per bucket, %.2f MB per million objects\n", blk_bytes,
+           (double)blk_bytes * nbucket / 1048576.0 * 1000000.0 / nobj);
+    free_counting_bloom(dab);
+    PDC_bloom_free(blk);
+
+    // Half of the lookups are for objects that do not exist
+    names = malloc(2 * (size_t)nobj * NAME_LEN);
+    if (names == NULL) {
+        printf("Error allocating object names\n");
+        return 1;
+    }
+    for (i = 0; i < 2 * nobj; i++)
+        snprintf(names + (size_t)i * NAME_LEN, NAME_LEN, "/obj_%d", i);
+
+    // Throughput and false positives: one filter holding all objects, each sized the way it is used
+    dab = new_counting_bloom(nobj > DABLOOMS_CAPACITY ? nobj : DABLOOMS_CAPACITY, DABLOOMS_ERROR_RATE);
+    blk = PDC_bloom_new(2 * ((uint64_t)nobj + 1));
+    if (dab == NULL || blk == NULL) {
+        printf("Error creating bloom filters\n");
+        return 1;
+    }
+    for (i = 0; i < nobj; i++) {
+        name = names + (size_t)i * NAME_LEN;
+        combine_key(key, name, i % 10);
+        counting_bloom_add(dab, key, strlen(key));
+        PDC_bloom_add(blk, PDC_bloom_fingerprint(name, i % 10));
+    }
+
+    // Include building the key, as find_identical_metadata does on every lookup
+    gettimeofday(&start, 0);
+    for (i = 0; i < 2 * nobj; i++) {
+        combine_key(key, names + (size_t)i * NAME_LEN, i % 10);
+        found = counting_bloom_check(dab, key, strlen(key));
+        if (i >= nobj && found)
+            dab_fp++;
+    }
+    gettimeofday(&end, 0);
+    dab_sec = elapsed_sec(&start, &end);
+
+    gettimeofday(&start, 0);
+    for (i = 0; i < 2 * nobj; i++) {
+        found = PDC_bloom_check(blk, PDC_bloom_fingerprint(names + (size_t)i * NAME_LEN, i % 10));
+        if (i >= nobj && found)
+            blk_fp++;
+        else if (i < nobj && !found) {
+            printf("Error: object %d not found in blocked bloom filter\n", i);
+            return 1;
+        }
+    }
+    gettimeofday(&end, 0);
+    blk_sec = elapsed_sec(&start, &end);
+
+    printf("dablooms: %.2f M lookups/s, %.3f%% false positives, %.2f MB\n", 2 * nobj / dab_sec / 1e6,
+           100.0 * dab_fp / nobj, dablooms_size(dab) / 1048576.0);
+    printf("blocked : %.2f M lookups/s, %.3f%% false positives, %.2f MB\n", 2 * nobj / blk_sec / 1e6,
+           100.0 * blk_fp / nobj, PDC_bloom_size(blk) / 1048576.0);
+
+    free_counting_bloom(dab);
+    PDC_bloom_free(blk);
+    free(names);
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Measure the chunk codec of the data server on VPIC-like particle data: positions sorted by cell with
+ * a random offset inside the cell, thermal momenta, the energy derived from them and a constant weight.
+ * Each variable is cut in chunks that are encoded and decoded by several threads, as the server does.
+ *
+ * Usage: ./chunk_bench [nparticle] [nthread] [chunk_size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "pdc_codec.h"
+
+#define NVAR 8
+
+typedef struct bench_var_t {
+    const char *name;
+    float *     data;
+    char *      enc;   // encoded chunks, each at its chunk offset
+    size_t *    csize; // encoded size of each chunk
+    int *       codec;
+    char *      out;   // decoded data
+} bench_var_t;
+
+static bench_var_t vars_g[NVAR];
+static size_t      size_g;
+static size_t      chunk_size_g = 1048576;
+static size_t      nchunk_g;
+static int         nthread_g = 4;
+static int         decode_g;
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+static double
+gaussian()
+{
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+static void
+gen_vpic(size_t n)
+{
+    const char *names[NVAR] = {"x", "y", "z", "ux", "uy", "uz", "energy", "w"};
+    size_t      i, c;
+    int         v, ncell = 64;
+    float       cell = 1.0f / ncell, *ux, *uy, *uz;
+
+    for (v = 0; v < NVAR; v++) {
+        vars_g[v].name = names[v];
+        vars_g[v].data = (float *)malloc(n * sizeof(float));
+    }
+    for (i = 0; i < n; i++) {
+        // Particles are kept sorted by cell, the cells are walked in x, y, z order
+        c                 = i * ((size_t)ncell * ncell * ncell) / n;
+        vars_g[0].data[i] = (c % ncell + (float)rand() / RAND_MAX) * cell;
+        vars_g[1].data[i] = (c / ncell % ncell + (float)rand() / RAND_MAX) * cell;
+        vars_g[2].data[i] = (c / ncell / ncell + (float)rand() / RAND_MAX) * cell;
+        vars_g[3].data[i] = 0.1f * gaussian();
+        vars_g[4].data[i] = 0.1f * gaussian();
+        vars_g[5].data[i] = 0.1f * gaussian();
+        ux                = &vars_g[3].data[i];
+        uy                = &vars_g[4].data[i];
+        uz                = &vars_g[5].data[i];
+        vars_g[6].data[i] = sqrtf(1 + *ux * *ux + *uy * *uy + *uz * *uz) - 1;
+        vars_g[7].data[i] = 1.0f;
+    }
+}
+
+static void *
+bench_thread(void *arg)
+{
+    size_t rank = (size_t)arg, task, c, off, len;
+    char * tmp  = (char *)malloc(chunk_size_g);
+    int    v;
+
+    // Chunks of all variables are dealt round robin
+    for (task = rank; task < NVAR * nchunk_g; task += nthread_g) {
+        v   = task / nchunk_g;
+        c   = task % nchunk_g;
+        off = c * chunk_size_g;
+        len = size_g - off < chunk_size_g ? size_g - off : chunk_size_g;
+        if (decode_g) {
+            if (PDC_codec_decode(vars_g[v].codec[c], vars_g[v].enc + off, vars_g[v].csize[c], sizeof(float),
+                                 vars_g[v].out + off, len, tmp) != 0)
+                fprintf(stderr, "chunk %zu of %s is corrupted\n", c, vars_g[v].name);
+        }
+        else
+            vars_g[v].codec[c] =
+                PDC_codec_encode(PDC_CODEC_SHUFFLE_LZ, (char *)vars_g[v].data + off, len, sizeof(float),
+                                 vars_g[v].enc + off, tmp, &vars_g[v].csize[c]);
+    }
+    free(tmp);
+    return NULL;
+}
+
+static double
+run(int decode)
+{
+    pthread_t      threads[256];
+    struct timeval start, end;
+    int            i;
+
+    decode_g = decode;
+    gettimeofday(&start, 0);
+    for (i = 0; i < nthread_g; i++)
+        pthread_create(&threads[i], NULL, bench_thread, (void *)(size_t)i);
+    for (i = 0; i < nthread_g; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&end, 0);
+
+    return elapsed_sec(&start, &end);
+}
+
+int
+main(int argc, char **argv)
+{
+    size_t n = 8 * 1048576, c, stored, total_stored = 0;
+    double enc_sec, dec_sec;
+    int    v;
+
+    if (argc > 1)
+        n = strtoull(argv[1], NULL, 10);
+    if (argc > 2)
+        nthread_g = atoi(argv[2]);
+    if (argc > 3)
+        chunk_size_g = strtoull(argv[3], NULL, 10);
+    if (n == 0 || nthread_g <= 0 || nthread_g > 256 || chunk_size_g < sizeof(float)) {
+        fprintf(stderr, "Usage: %s [nparticle] [nthread] [chunk_size]\n", argv[0]);
+        return 1;
+    }
+
+    srand(42);
+    gen_vpic(n);
+    size_g   = n * sizeof(float);
+    nchunk_g = (size_g + chunk_size_g - 1) / chunk_size_g;
+    for (v = 0; v < NVAR; v++) {
+        vars_g[v].enc   = (char *)malloc(size_g);
+        vars_g[v].out   = (char *)malloc(size_g);
+        vars_g[v].csize = (size_t *)calloc(nchunk_g, sizeof(size_t));
+        vars_g[v].codec = (int *)calloc(nchunk_g, sizeof(int));
+        // Fault the pages in so the timed runs only measure the codec
+        memset(vars_g[v].enc, 0, size_g);
+        memset(vars_g[v].out, 0, size_g);
+    }
+
+    enc_sec = run(0);
+    dec_sec = run(1);
+
+    printf("%zu particles, %d threads, %zu byte chunks\n", n, nthread_g, chunk_size_g);
+    for (v = 0; v < NVAR; v++) {
+        stored = 0;
+        for (c = 0; c < nchunk_g; c++)
+            stored += vars_g[v].csize[c];
+        total_stored += stored;
+        if (memcmp(vars_g[v].data, vars_g[v].out, size_g) != 0)
+            printf("%-7s decoded data does not match\n", vars_g[v].name);
+        printf("%-7s ratio %5.2f\n", vars_g[v].name, (double)size_g / stored);
+    }
+    printf("total   ratio %5.2f, encode %.2f GB/s, decode %.2f GB/s\n", (double)size_g * NVAR / total_stored,
+           size_g * NVAR / enc_sec / 1e9, size_g * NVAR / dec_sec / 1e9);
+
+    for (v = 0; v < NVAR; v++) {
+        free(vars_g[v].data);
+        free(vars_g[v].enc);
+        free(vars_g[v].out);
+        free(vars_g[v].csize);
+        free(vars_g[v].codec);
+    }
+    return 0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Unit test of the interval tree that indexes the regions of an object on the data server. Random inserts,
+ * removes and queries are checked against a brute force scan, and the AVL invariants are checked after
+ * every change. Sorted inserts and removes check that the tree stays balanced.
+ *
+ * Usage: ./interval_tree [n_intervals] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "pdc_interval_tree.h"
+
+#define INTERVAL_MAX_COORD 1000
+
+typedef struct interval_t {
+    uint64_t lo;
+    uint64_t hi;
+    int      in_tree;
+} interval_t;
+
+typedef struct visit_t {
+    interval_t **found;
+    int          nfound;
+    int          stop_after; // stop the query after this many intervals, 0 to visit all
+} visit_t;
+
+static int
+visit_cb(void *data, void *arg)
+{
+    visit_t *visit = (visit_t *)arg;
+
+    visit->found[visit->nfound++] = (interval_t *)data;
+    return visit->stop_after > 0 && visit->nfound == visit->stop_after;
+}
+
+// Check the order, heights, balance and max_hi of a subtree, return its node count or -1 on error
+static int
+check_node(pdc_interval_node_t *node, int *height)
+{
+    int      lh, rh, ln, rn;
+    uint64_t max_hi;
+
+    if (node == NULL) {
+        *height = 0;
+        return 0;
+    }
+    if ((ln = check_node(node->left, &lh)) < 0 || (rn = check_node(node->right, &rh)) < 0)
+        return -1;
+    if (node->left != NULL && node->left->lo > node->lo) {
+        printf("left child %" PRIu64 " starts after %" PRIu64 "\n", node->left->lo, node->lo);
+        return -1;
+    }
+    if (node->right != NULL && node->right->lo < node->lo) {
+        printf("right child %" PRIu64 " starts before %" PRIu64 "\n", node->right->lo, node->lo);
+        return -1;
+    }
+    *height = (lh > rh ? lh : rh) + 1;
+    if (node->height != *height || lh - rh > 1 || rh - lh > 1) {
+        printf("node %" PRIu64 " has height %d, subtrees %d and %d\n", node->lo, node->height, lh, rh);
+        return -1;
+    }
+    max_hi = node->hi;
+    if (node->left != NULL && node->left->max_hi > max_hi)
+        max_hi = node->left->max_hi;
+    if (node->right != NULL && node->right->max_hi > max_hi)
+        max_hi = node->right->max_hi;
+    if (node->max_hi != max_hi) {
+        printf("node %" PRIu64 " has max_hi %" PRIu64 ", expected %" PRIu64 "\n", node->lo, node->max_hi,
+               max_hi);
+        return -1;
+    }
+    return ln + rn + 1;
+}
+
+static int
+check_tree(pdc_interval_tree_t *tree)
+{
+    int height, n;
+
+    n = check_node(tree->root, &height);
+    if (n < 0)
+        return -1;
+    if ((uint64_t)n != tree->count) {
+        printf("tree has %d nodes, count is %" PRIu64 "\n", n, tree->count);
+        return -1;
+    }
+    return height;
+}
+
+static int
+cmp_lo(const void *a, const void *b)
+{
+    const interval_t *x = *(interval_t *const *)a, *y = *(interval_t *const *)b;
+
+    return x->lo < y->lo ? -1 : x->lo > y->lo;
+}
+
+// Run a query and compare it with a scan of all intervals, in order of their start
+static int
+check_query(pdc_interval_tree_t *tree, interval_t *intervals, int n, uint64_t lo, uint64_t hi, int contain,
+            interval_t **found, interval_t **expected)
+{
+    visit_t visit;
+    int     nexpected = 0, i;
+
+    visit.found      = found;
+    visit.nfound     = 0;
+    visit.stop_after = 0;
+    if (contain)
+        PDC_interval_tree_query_contain(tree, lo, hi, visit_cb, &visit);
+    else
+        PDC_interval_tree_query_overlap(tree, lo, hi, visit_cb, &visit);
+
+    for (i = 0; i < n; i++) {
+        if (!intervals[i].in_tree)
+            continue;
+        if (contain ? intervals[i].lo <= lo && intervals[i].hi >= hi
+                    : intervals[i].lo <= hi && intervals[i].hi >= lo)
+            expected[nexpected++] = &intervals[i];
+    }
+    qsort(expected, nexpected, sizeof(interval_t *), cmp_lo);
+
+    if (visit.nfound != nexpected) {
+        printf("%s query [%" PRIu64 ", %" PRIu64 "] found %d intervals, expected %d\n",
+               contain ? "contain" : "overlap", lo, hi, visit.nfound, nexpected);
+        return -1;
+    }
+    for (i = 0; i < visit.nfound; i++) {
+        if (i > 0 && found[i]->lo < found[i - 1]->lo) {
+            printf("query results are not ordered by start\n");
+            return -1;
+        }
+        if (!found[i]->in_tree || (contain ? found[i]->lo > lo || found[i]->hi < hi
+                                           : found[i]->lo > hi || found[i]->hi < lo)) {
+            printf("query result %d [%" PRIu64 ", %" PRIu64 "] does not match\n", i, found[i]->lo,
+                   found[i]->hi);
+            return -1;
+        }
+        // Ties may come in another order, compare the starts
+        if (found[i]->lo != expected[i]->lo) {
+            printf("query result %d starts at %" PRIu64 ", expected %" PRIu64 "\n", i, found[i]->lo,
+                   expected[i]->lo);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    pdc_interval_tree_t tree;
+    interval_t *        intervals;
+    interval_t **       found, **expected, **sorted;
+    visit_t             visit;
+    int                 n = 2000, i, j, k, height, ret_value = 1;
+    uint64_t            lo, hi;
+    unsigned int        seed = 1;
+
+    if (argc > 1)
+        n = atoi(argv[1]);
+    if (argc > 2)
+        seed = (unsigned int)atoi(argv[2]);
+    srand(seed);
+
+    intervals = (interval_t *)calloc(n, sizeof(interval_t));
+    found     = (interval_t **)malloc(sizeof(interval_t *) * n);
+    expected  = (interval_t **)malloc(sizeof(interval_t *) * n);
+    sorted    = (interval_t **)malloc(sizeof(interval_t *) * n);
+    PDC_interval_tree_init(&tree);
+
+    // Random inserts and removes, with duplicate starts
+    for (i = 0; i < n; i++) {
+        intervals[i].lo = rand() % INTERVAL_MAX_COORD;
+        intervals[i].hi = intervals[i].lo + rand() % 50;
+        if (PDC_interval_tree_insert(&tree, intervals[i].lo, intervals[i].hi, &intervals[i]) != 0) {
+            printf("insert %d failed\n", i);
+            goto done;
+        }
+        intervals[i].in_tree = 1;
+        if (i % 3 == 2) {
+            j = rand() % (i + 1);
+            if (intervals[j].in_tree) {
+                if (PDC_interval_tree_remove(&tree, intervals[j].lo, &intervals[j]) != 0) {
+                    printf("remove %d failed\n", j);
+                    goto done;
+                }
+                intervals[j].in_tree = 0;
+            }
+        }
+        if (check_tree(&tree) < 0)
+            goto done;
+    }
+
+    // Removing an interval that is not in the tree fails and changes nothing
+    for (j = 0; j < n && intervals[j].in_tree; j++)
+        ;
+    if (j < n && PDC_interval_tree_remove(&tree, intervals[j].lo, &intervals[j]) == 0) {
+        printf("removed an interval that is not in the tree\n");
+        goto done;
+    }
+
+    for (i = 0; i < 1000; i++) {
+        lo = rand() % (INTERVAL_MAX_COORD + 100);
+        hi = lo + rand() % 20;
+        if (check_query(&tree, intervals, n, lo, hi, 0, found, expected) != 0 ||
+            check_query(&tree, intervals, n, lo, hi, 1, found, expected) != 0)
+            goto done;
+    }
+
+    // A non-zero callback return stops the query and is passed back
+    visit.found      = found;
+    visit.nfound     = 0;
+    visit.stop_after = 3;
+    if (tree.count >= 3 &&
+        (PDC_interval_tree_query_overlap(&tree, 0, INTERVAL_MAX_COORD * 2, visit_cb, &visit) != 1 ||
+         visit.nfound != 3)) {
+        printf("query did not stop after 3 intervals\n");
+        goto done;
+    }
+
+    // Remove the rest in order of their start, the tree stays balanced while it shrinks
+    k = 0;
+    for (i = 0; i < n; i++) {
+        if (intervals[i].in_tree)
+            sorted[k++] = &intervals[i];
+    }
+    qsort(sorted, k, sizeof(interval_t *), cmp_lo);
+    for (i = 0; i < k; i++) {
+        if (PDC_interval_tree_remove(&tree, sorted[i]->lo, sorted[i]) != 0) {
+            printf("remove of a sorted interval failed\n");
+            goto done;
+        }
+        sorted[i]->in_tree = 0;
+        if (check_tree(&tree) < 0)
+            goto done;
+    }
+    if (tree.root != NULL || tree.count != 0) {
+        printf("tree is not empty after removing everything\n");
+        goto done;
+    }
+
+    // Sorted inserts need rotations at every level, an AVL tree of n nodes is below 1.45 log2(n + 2)
+    for (i = 0; i < n; i++) {
+        intervals[i].lo      = i;
+        intervals[i].hi      = i + 10;
+        intervals[i].in_tree = 1;
+        if (PDC_interval_tree_insert(&tree, intervals[i].lo, intervals[i].hi, &intervals[i]) != 0) {
+            printf("sorted insert %d failed\n", i);
+            goto done;
+        }
+    }
+    height = check_tree(&tree);
+    for (i = 0, k = 1; (1 << i) < n + 2; i++)
+        k = i + 1;
+    if (height < 0 || height * 100 > 145 * k) {
+        printf("tree of %d sorted intervals has height %d\n", n, height);
+        goto done;
+    }
+    if (check_query(&tree, intervals, n, n / 2, n / 2 + 5, 0, found, expected) != 0 ||
+        check_query(&tree, intervals, n, n / 2, n / 2 + 5, 1, found, expected) != 0)
+        goto done;
+
+    printf("interval tree test passed\n");
+    ret_value = 0;
+
+done:
+    PDC_interval_tree_destroy(&tree, NULL);
+    free(intervals);
+    free(found);
+    free(expected);
+    free(sorted);
+    return ret_value;
+}
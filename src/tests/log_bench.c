@@ -0,0 +1,150 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Compare the cost of printf followed by fflush(stdout), as the RPC handlers used to do, with the
+ * asynchronous logger. Each thread logs the same message in a loop and the time per call is printed to
+ * stderr. The rate limit is off unless PDC_LOG_RATE_LIMIT is set. A full ring drops messages, which is
+ * cheaper than writing them, so the logger threads log in bursts of a quarter ring and drain the rings
+ * between bursts. Only the calls are timed, the drains are reported separately with the number of
+ * dropped messages, which must be 0 for the timing to mean anything.
+ *
+ * Usage: ./log_bench [ncall] [nthread] > /dev/null
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "pdc_logger.h"
+
+#define LOG_BENCH_BURST (PDC_LOG_RING_SIZE / 4)
+
+static int    ncall_g;
+static double call_sec_g[1024]; // time spent in PDC_LOG_INFO by each logger thread
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+static void *
+bench_printf(void *arg)
+{
+    int rank = *(int *)arg, i;
+
+    for (i = 0; i < ncall_g; i++) {
+        printf("==PDC_SERVER[%d]: transfer request %d done\n", rank, i);
+        fflush(stdout);
+    }
+    return NULL;
+}
+
+static void *
+bench_logger(void *arg)
+{
+    int            rank = *(int *)arg, i, j;
+    struct timeval start, end;
+
+    call_sec_g[rank] = 0;
+    for (i = 0; i < ncall_g; i += LOG_BENCH_BURST) {
+        gettimeofday(&start, 0);
+        for (j = i; j < ncall_g && j < i + LOG_BENCH_BURST; j++)
+            PDC_LOG_INFO("transfer request %d done", j);
+        gettimeofday(&end, 0);
+        call_sec_g[rank] += elapsed_sec(&start, &end);
+        // Empty the rings before the next burst so no message is dropped
+        PDC_log_flush();
+    }
+    return NULL;
+}
+
+static double
+run(void *(*func)(void *), int nthread)
+{
+    pthread_t *    threads = (pthread_t *)malloc(nthread * sizeof(pthread_t));
+    int *          ranks   = (int *)malloc(nthread * sizeof(int));
+    struct timeval start, end;
+    int            i;
+
+    gettimeofday(&start, 0);
+    for (i = 0; i < nthread; i++) {
+        ranks[i] = i;
+        pthread_create(&threads[i], NULL, func, &ranks[i]);
+    }
+    for (i = 0; i < nthread; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&end, 0);
+
+    free(threads);
+    free(ranks);
+    return elapsed_sec(&start, &end);
+}
+
+int
+main(int argc, char **argv)
+{
+    int            nthread = 4, i;
+    double         printf_sec, logger_sec, call_sec = 0, drain_sec;
+    uint64_t       dropped;
+    struct timeval start, end;
+
+    ncall_g = 100000;
+    if (argc > 1)
+        ncall_g = atoi(argv[1]);
+    if (argc > 2)
+        nthread = atoi(argv[2]);
+    if (ncall_g <= 0 || nthread <= 0 || nthread > 1024) {
+        fprintf(stderr, "Usage: %s [ncall] [nthread]\n", argv[0]);
+        return 1;
+    }
+    setenv("PDC_LOG_RATE_LIMIT", "0", 0);
+
+    printf_sec = run(bench_printf, nthread);
+
+    PDC_log_init("PDC_SERVER", 0);
+    logger_sec = run(bench_logger, nthread);
+    dropped    = PDC_log_dropped();
+    gettimeofday(&start, 0);
+    PDC_log_finalize();
+    gettimeofday(&end, 0);
+    drain_sec = elapsed_sec(&start, &end);
+    // The threads run concurrently, the slowest one is compared with the printf wall time
+    for (i = 0; i < nthread; i++) {
+        if (call_sec_g[i] > call_sec)
+            call_sec = call_sec_g[i];
+    }
+
+    fprintf(stderr, "%d threads, %d calls each\n", nthread, ncall_g);
+    fprintf(stderr, "printf+fflush: %8.1f ns/call, %.3fs\n", printf_sec * 1e9 / ncall_g, printf_sec);
+    fprintf(stderr,
+            "PDC_LOG_INFO:  %8.1f ns/call, %.3fs in calls, %.3fs with the drains between bursts, "
+            "%.3fs to drain at finalize, %" PRIu64 " dropped\n",
+            call_sec * 1e9 / ncall_g, call_sec, logger_sec, drain_sec, dropped);
+
+    return dropped != 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "pdc.h"
+
+#define NAME_LEN 64
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+int
+main(int argc, char **argv)
+{
+    pdcid_t        pdc, cont_prop, cont, obj_prop, obj, open1;
+    pdcid_t *      obj_ids;
+    int            rank = 0, size = 1;
+    int            ret_value = 0;
+    int            count = 1000, batch_size = 100, i, j, n;
+    char           cont_name[128];
+    char *         names;
+    const char **  name_ptrs;
+    struct timeval start, end;
+    double         single_sec, batch_sec;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+    if (argc > 1)
+        count = atoi(argv[1]);
+    if (argc > 2)
+        batch_size = atoi(argv[2]);
+
+    names     = (char *)malloc((size_t)count * NAME_LEN);
+    name_ptrs = (const char **)malloc(count * sizeof(char *));
+    obj_ids   = (pdcid_t *)malloc(count * sizeof(pdcid_t));
+
+    // create a pdc
+    pdc = PDCinit("pdc");
+
+    // create a container property
+    cont_prop = PDCprop_create(PDC_CONT_CREATE, pdc);
+    if (cont_prop <= 0) {
+        printf("Rank %d Fail to create container property @ line  %d!\n", rank, __LINE__);
+        ret_value = 1;
+    }
+    // create a container
+    sprintf(cont_name, "c%d", rank);
+    cont = PDCcont_create(cont_name, cont_prop);
+    if (cont <= 0) {
+        printf("Rank %d Fail to create container @ line  %d!\n", rank, __LINE__);
+        ret_value = 1;
+    }
+    // create an object property
+    obj_prop = PDCprop_create(PDC_OBJ_CREATE, pdc);
+    if (obj_prop <= 0) {
+        printf("Rank %d Fail to create object property @ line  %d!\n", rank, __LINE__);
+        ret_value = 1;
+    }
+
+    // create objects one at a time
+    gettimeofday(&start, 0);
+    for (i = 0; i < count; i++) {
+        sprintf(names + i * NAME_LEN, "single_%d_%d", rank, i);
+        obj = PDCobj_create(cont, names + i * NAME_LEN, obj_prop);
+        if (obj <= 0) {
+            printf("Rank %d Fail to create object %s @ line  %d!\n", rank, names + i * NAME_LEN, __LINE__);
+            ret_value = 1;
+            break;
+        }
+        PDCobj_close(obj);
+    }
+    gettimeofday(&end, 0);
+    single_sec = elapsed_sec(&start, &end);
+
+    // create the same number of objects in batches
+    for (i = 0; i < count; i++) {
+        sprintf(names + i * NAME_LEN, "batch_%d_%d", rank, i);
+        name_ptrs[i] = names + i * NAME_LEN;
+    }
+    gettimeofday(&start, 0);
+    for (i = 0; i < count; i += batch_size) {
+        n = count - i < batch_size ? count - i : batch_size;
+        if (PDCobj_create_batch(cont, n, name_ptrs + i, obj_prop, obj_ids + i) < 0) {
+            printf("Rank %d Fail to create object batch @ line  %d!\n", rank, __LINE__);
+            ret_value = 1;
+            break;
+        }
+    }
+    gettimeofday(&end, 0);
+    batch_sec = elapsed_sec(&start, &end);
+
+    for (i = 0; i < count; i++) {
+        if (obj_ids[i] == 0) {
+            printf("Rank %d object %s was not created\n", rank, name_ptrs[i]);
+            ret_value = 1;
+            break;
+        }
+    }
+
+    // objects created in a batch can be opened by name
+    open1 = PDCobj_open(name_ptrs[count - 1], pdc);
+    if (open1 == 0) {
+        printf("Rank %d Fail to open object %s\n", rank, name_ptrs[count - 1]);
+        ret_value = 1;
+    }
+    else
+        PDCobj_close(open1);
+
+    for (i = 0; i < count; i++) {
+        if (obj_ids[i] > 0)
+            PDCobj_close(obj_ids[i]);
+    }
+
+    // an existing name in a batch fails alone
+    j            = count > 1 ? 1 : 0;
+    name_ptrs[0] = "batch_new_object";
+    name_ptrs[j] = names + j * NAME_LEN;
+    if (PDCobj_create_batch(cont, j + 1, name_ptrs, obj_prop, obj_ids) >= 0 || obj_ids[j] != 0 ||
+        (j > 0 && obj_ids[0] == 0)) {
+        printf("Rank %d Creating an existing object in a batch should fail @ line  %d!\n", rank, __LINE__);
+        ret_value = 1;
+    }
+    for (i = 0; i <= j; i++) {
+        if (obj_ids[i] > 0)
+            PDCobj_close(obj_ids[i]);
+    }
+
+    if (rank == 0)
+        printf("Created %d objects: %.0f objects/s one at a time, %.0f objects/s in batches of %d\n", count,
+               count / single_sec, count / batch_sec, batch_size);
+
+    // close a container
+    if (PDCcont_close(cont) < 0) {
+        printf("Rank %d Fail to close container c1\n", rank);
+        ret_value = 1;
+    }
+    // close a container property
+    if (PDCprop_close(obj_prop) < 0) {
+        printf("Rank %d Fail to close property @ line %d\n", rank, __LINE__);
+        ret_value = 1;
+    }
+    if (PDCprop_close(cont_prop) < 0) {
+        printf("Rank %d Fail to close property @ line %d\n", rank, __LINE__);
+        ret_value = 1;
+    }
+    // close pdc
+    if (PDCclose(pdc) < 0) {
+        printf("Rank %d Fail to close PDC\n", rank);
+        ret_value = 1;
+    }
+    free(names);
+    free(name_ptrs);
+    free(obj_ids);
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+    return ret_value;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Time PDCobj_put_data and PDCobj_get_data on 1 KB to 64 KB objects and report the operations per second.
+ * Objects up to PDC_OBJ_INLINE_SIZE bytes take the one RPC path, run again with PDC_OBJ_INLINE_SIZE=0 to
+ * compare against the region transfer path.
+ *
+ * Usage: obj_put_get_bench [n_objects_per_size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "pdc.h"
+
+#define N_SIZES 7
+
+int
+main(int argc, char **argv)
+{
+    pdcid_t  pdc, cont_prop, cont;
+    pdcid_t *obj;
+    char     cont_name[128], obj_name[128];
+    int      rank = 0, size = 1, i, s, n_objects = 100, ret_value = 0;
+    uint64_t obj_sizes[N_SIZES] = {1024, 2048, 4096, 8192, 16384, 32768, 65536};
+    char *   data, *read_buf;
+    double   start, put_time, get_time, max_put, max_get;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+    if (argc >= 2)
+        n_objects = atoi(argv[1]);
+
+    data     = (char *)malloc(obj_sizes[N_SIZES - 1]);
+    read_buf = (char *)malloc(obj_sizes[N_SIZES - 1]);
+    obj      = (pdcid_t *)malloc(sizeof(pdcid_t) * n_objects);
+
+    pdc       = PDCinit("pdc");
+    cont_prop = PDCprop_create(PDC_CONT_CREATE, pdc);
+    sprintf(cont_name, "c%d", rank);
+    cont = PDCcont_create(cont_name, cont_prop);
+    if (cont <= 0) {
+        printf("Fail to create container @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+
+    for (s = 0; s < N_SIZES; ++s) {
+        memset(data, s + 1, obj_sizes[s]);
+
+#ifdef ENABLE_MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        start = MPI_Wtime();
+        for (i = 0; i < n_objects; ++i) {
+            sprintf(obj_name, "o%d_%d_%d", s, i, rank);
+            obj[i] = PDCobj_put_data(obj_name, data, obj_sizes[s], cont);
+            if (obj[i] <= 0) {
+                printf("Fail to put data into object @ line  %d!\n", __LINE__);
+                ret_value = 1;
+            }
+        }
+        put_time = MPI_Wtime() - start;
+
+#ifdef ENABLE_MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        start = MPI_Wtime();
+        for (i = 0; i < n_objects; ++i) {
+            if (PDCobj_get_data(obj[i], read_buf, obj_sizes[s]) != SUCCEED) {
+                printf("Fail to get data from object @ line  %d!\n", __LINE__);
+                ret_value = 1;
+            }
+        }
+        get_time = MPI_Wtime() - start;
+
+        if (memcmp(read_buf, data, obj_sizes[s]) != 0) {
+            printf("Wrong data read back for %" PRIu64 " byte objects\n", obj_sizes[s]);
+            ret_value = 1;
+        }
+        for (i = 0; i < n_objects; ++i)
+            PDCobj_close(obj[i]);
+
+#ifdef ENABLE_MPI
+        MPI_Reduce(&put_time, &max_put, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&get_time, &max_get, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+#else
+        max_put = put_time;
+        max_get = get_time;
+#endif
+        if (rank == 0 && n_objects > 0)
+            printf("obj_put_get_bench: %d clients, %6" PRIu64 " bytes, put %.0f ops/s, get %.0f ops/s\n",
+                   size, obj_sizes[s], n_objects * size / max_put, n_objects * size / max_get);
+    }
+
+    PDCcont_close(cont);
+    PDCprop_close(cont_prop);
+    PDCclose(pdc);
+
+    free(data);
+    free(read_buf);
+    free(obj);
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+    return ret_value;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Compare a walk over a list of region structs against a hash table lookup under a reader lock, also with
+ * several reader threads. This is a model of the data server object region lookup, it uses a stand-in
+ * struct and the same hash and key compare as PDC_Server_get_obj_region but does not call it, so the
+ * numbers only show the cost of the data structures and the lock.
+ *
+ * Usage: ./obj_region_lookup_bench [nobj] [nthread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "pdc_utlist.h"
+#include "pdc_hash-table.h"
+
+#define N_LIST_LOOKUP 2000
+#define N_HASH_LOOKUP 2000000
+
+// Stand-in for data_server_region_t with only the fields used by the lookup
+typedef struct bench_region_t {
+    uint64_t               obj_id;
+    struct bench_region_t *prev;
+    struct bench_region_t *next;
+} bench_region_t;
+
+static bench_region_t *  region_list_g = NULL;
+static HashTable *       region_table_g;
+static pthread_rwlock_t  region_table_rwlock_g = PTHREAD_RWLOCK_INITIALIZER;
+static uint64_t          nobj_g;
+static volatile uint64_t sink_g;
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+// Same hash and key compare as the data server
+static unsigned int
+obj_region_hash(void *key)
+{
+    uint64_t obj_id = *((uint64_t *)key);
+
+    return (unsigned int)(obj_id ^ (obj_id >> 32));
+}
+
+static int
+obj_region_equal(void *key1, void *key2)
+{
+    return *((uint64_t *)key1) == *((uint64_t *)key2);
+}
+
+// Object IDs are spread like the ones the metadata servers hand out
+static inline uint64_t
+bench_obj_id(uint64_t i)
+{
+    return 1000000 + i * 7919;
+}
+
+static bench_region_t *
+list_lookup(uint64_t obj_id)
+{
+    bench_region_t *elt, *ret = NULL;
+
+    DL_FOREACH(region_list_g, elt)
+    {
+        if (elt->obj_id == obj_id)
+            ret = elt;
+    }
+    return ret;
+}
+
+static bench_region_t *
+hash_lookup(uint64_t obj_id)
+{
+    bench_region_t *ret;
+
+    pthread_rwlock_rdlock(&region_table_rwlock_g);
+    ret = (bench_region_t *)hash_table_lookup(region_table_g, &obj_id);
+    pthread_rwlock_unlock(&region_table_rwlock_g);
+    return ret;
+}
+
+static void *
+hash_lookup_thread(void *arg)
+{
+    unsigned int seed = (unsigned int)(uintptr_t)arg;
+    uint64_t     i, found = 0;
+
+    for (i = 0; i < N_HASH_LOOKUP; i++)
+        found += hash_lookup(bench_obj_id(rand_r(&seed) % nobj_g)) != NULL;
+    sink_g += found;
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    int             nthread = argc > 2 ? atoi(argv[2]) : 4;
+    uint64_t        i, found;
+    bench_region_t *regions;
+    pthread_t *     threads;
+    struct timeval  start, end;
+    double          list_ns, hash_ns, mt_sec;
+
+    nobj_g = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000;
+    if (nobj_g == 0 || nthread <= 0) {
+        printf("Usage: %s [nobj] [nthread]\n", argv[0]);
+        return 1;
+    }
+
+    regions        = (bench_region_t *)calloc(nobj_g, sizeof(bench_region_t));
+    region_table_g = hash_table_new(obj_region_hash, obj_region_equal);
+    for (i = 0; i < nobj_g; i++) {
+        regions[i].obj_id = bench_obj_id(i);
+        DL_APPEND(region_list_g, regions + i);
+        hash_table_insert(region_table_g, &regions[i].obj_id, regions + i);
+    }
+
+    srand(1);
+    found = 0;
+    gettimeofday(&start, 0);
+    for (i = 0; i < N_LIST_LOOKUP; i++)
+        found += list_lookup(bench_obj_id(rand() % nobj_g)) != NULL;
+    gettimeofday(&end, 0);
+    list_ns = elapsed_sec(&start, &end) * 1e9 / N_LIST_LOOKUP;
+
+    gettimeofday(&start, 0);
+    for (i = 0; i < N_HASH_LOOKUP; i++)
+        found += hash_lookup(bench_obj_id(rand() % nobj_g)) != NULL;
+    gettimeofday(&end, 0);
+    hash_ns = elapsed_sec(&start, &end) * 1e9 / N_HASH_LOOKUP;
+
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * nthread);
+    gettimeofday(&start, 0);
+    for (i = 0; i < (uint64_t)nthread; i++)
+        pthread_create(&threads[i], NULL, hash_lookup_thread, (void *)(uintptr_t)(i + 1));
+    for (i = 0; i < (uint64_t)nthread; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&end, 0);
+    mt_sec = elapsed_sec(&start, &end);
+
+    printf("%" PRIu64 " objects, %" PRIu64 " found\n", nobj_g, found);
+    printf("list walk:   %12.1f ns/lookup\n", list_ns);
+    printf("hash lookup: %12.1f ns/lookup, %.0fx faster\n", hash_ns, list_ns / hash_ns);
+    printf("hash lookup: %12.2f M lookups/s with %d reader threads\n", nthread * N_HASH_LOOKUP / mt_sec / 1e6,
+           nthread);
+
+    free(threads);
+    hash_table_free(region_table_g);
+    free(regions);
+    return 0;
+}
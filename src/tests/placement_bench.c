@@ -0,0 +1,125 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Simulate clients writing dynamic regions through the placement policies of the metadata server and report
+ * how evenly the bytes and the write time are spread over the data servers. Each node runs one data server,
+ * clients on the first quarter of the nodes write 8 times larger regions. A server writes at DRAIN_RATE, data
+ * from another node costs remote_cost times more to write, and clients offer load times the aggregate rate.
+ *
+ * Usage: ./placement_bench [n_nodes] [clients_per_node] [n_steps] [remote_cost] [load]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "pdc_server_placement.h"
+
+#define REGION_SIZE (4 * 1048576ULL)
+#define DRAIN_RATE  1073741824.0
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+static void
+run_policy(int policy, int n_nodes, int clients_per_node, int n_steps, double remote_cost, double load)
+{
+    pdc_placement_t placement;
+    double *        finish, now, step_time, makespan, select_time, latency;
+    uint64_t        total_bytes, max_bytes, bytes;
+    int             step, node, client;
+    uint32_t        server;
+    struct timeval  start, end;
+    const char *    names[] = {"bytes", "round_robin", "least_loaded", "locality"};
+
+    PDC_placement_init(&placement, n_nodes, (pdc_placement_policy_t)policy, DRAIN_RATE, remote_cost, -1);
+    finish = (double *)calloc(n_nodes, sizeof(double));
+
+    total_bytes = 0;
+    for (node = 0; node < n_nodes; node++)
+        total_bytes += (node < (n_nodes + 3) / 4 ? 8 : 1) * REGION_SIZE * clients_per_node;
+    step_time   = total_bytes / (DRAIN_RATE * n_nodes * load);
+    total_bytes = 0;
+
+    select_time = 0;
+    latency     = 0;
+    for (step = 0; step < n_steps; step++) {
+        now = step * step_time;
+        for (node = 0; node < n_nodes; node++) {
+            bytes = (node < (n_nodes + 3) / 4 ? 8 : 1) * REGION_SIZE;
+            for (client = 0; client < clients_per_node; client++) {
+                gettimeofday(&start, 0);
+                server = PDC_placement_select(&placement, node, bytes, now);
+                gettimeofday(&end, 0);
+                select_time += elapsed_sec(&start, &end);
+
+                if (finish[server] < now)
+                    finish[server] = now;
+                finish[server] += bytes * (server == (uint32_t)node ? 1 : remote_cost) / DRAIN_RATE;
+                latency += finish[server] - now;
+                total_bytes += bytes;
+            }
+        }
+    }
+
+    makespan  = 0;
+    max_bytes = 0;
+    for (node = 0; node < n_nodes; node++) {
+        if (finish[node] > makespan)
+            makespan = finish[node];
+        if (placement.servers[node].bytes > max_bytes)
+            max_bytes = placement.servers[node].bytes;
+    }
+    printf("%-13s %14.2f %9.1f%% %12.3f %12.2f %12.1f %12.1f\n", names[policy],
+           (double)max_bytes * n_nodes / total_bytes, 100.0 * placement.n_local / placement.n_placed,
+           makespan, total_bytes / makespan / 1073741824.0, latency * 1e3 / placement.n_placed,
+           select_time * 1e9 / placement.n_placed);
+
+    free(finish);
+    PDC_placement_finalize(&placement);
+}
+
+int
+main(int argc, char **argv)
+{
+    int    n_nodes          = argc > 1 ? atoi(argv[1]) : 64;
+    int    clients_per_node = argc > 2 ? atoi(argv[2]) : 16;
+    int    n_steps          = argc > 3 ? atoi(argv[3]) : 100;
+    double remote_cost      = argc > 4 ? atof(argv[4]) : 1.5;
+    double load             = argc > 5 ? atof(argv[5]) : 0.9;
+    int    policy;
+
+    printf("%d nodes, %d clients per node, %d steps, remote cost %.2f, load %.2f\n", n_nodes,
+           clients_per_node, n_steps, remote_cost, load);
+    printf("%-13s %14s %10s %12s %12s %12s %12s\n", "policy", "max/mean bytes", "local", "makespan (s)",
+           "write GiB/s", "latency (ms)", "select ns");
+    for (policy = PDC_PLACEMENT_LEAST_BYTES; policy <= PDC_PLACEMENT_LOCALITY; policy++)
+        run_policy(policy, n_nodes, clients_per_node, n_steps, remote_cost, load);
+
+    return 0;
+}
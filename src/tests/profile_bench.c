@@ -0,0 +1,112 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Measure the cost of the profiler push/pop with several threads. Each thread runs call trees of three
+ * nested functions, the per-function table is printed at exit. Run with PROFILE_TRACE=<prefix> to also
+ * write a Chrome trace, and with PROFILE_SAMPLE_RATE=<n> to record one of every n call trees.
+ *
+ * Usage: ./profile_bench [ncall] [nthread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "pdc_stack_ops.h"
+
+static uint64_t ncall_g;
+
+static double
+elapsed_sec(struct timeval *start, struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+static void
+bench_leaf()
+{
+    push(__func__, NULL);
+    pop();
+}
+
+static void
+bench_inner()
+{
+    push(__func__, NULL);
+    bench_leaf();
+    bench_leaf();
+    pop();
+}
+
+static void *
+bench_thread(void *arg)
+{
+    uint64_t i;
+
+    (void)arg;
+    for (i = 0; i < ncall_g; i++) {
+        push("bench_root", NULL);
+        bench_inner();
+        if (i % 1024 == 0)
+            profile_flow("bench_request", i, 's');
+        pop();
+    }
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    int            nthread = argc > 2 ? atoi(argv[2]) : 4;
+    int            i;
+    pthread_t *    threads;
+    struct timeval start, end;
+    double         sec;
+
+    ncall_g = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    if (ncall_g == 0 || nthread <= 0) {
+        printf("Usage: %s [ncall] [nthread]\n", argv[0]);
+        return 1;
+    }
+    enableProfiling = TRUE;
+
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * nthread);
+    gettimeofday(&start, 0);
+    for (i = 0; i < nthread; i++)
+        pthread_create(&threads[i], NULL, bench_thread, NULL);
+    for (i = 0; i < nthread; i++)
+        pthread_join(threads[i], NULL);
+    gettimeofday(&end, 0);
+
+    // 4 push/pop pairs per call tree
+    sec = elapsed_sec(&start, &end);
+    printf("%d threads, %" PRIu64 " call trees each: %.3f s, %.1f ns per push/pop of each thread\n", nthread,
+           ncall_g, sec, sec * 1e9 / (ncall_g * 4.0));
+
+    free(threads);
+    return 0;
+}
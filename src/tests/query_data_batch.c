@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/time.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include "pdc.h"
+#include "pdc_client_connect.h"
+#include "pdc_client_server_common.h"
+
+void
+print_usage()
+{
+    printf("Usage: srun -n ./query_data_batch obj_name size_MB\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    int                    rank = 0, size = 1;
+    uint64_t               size_MB;
+    pdcid_t                obj_id = -1;
+    struct pdc_region_info region;
+    uint64_t               i, dims[1], nhits = 0, batch_nhits = 0;
+    pdc_selection_t        sel;
+    char *                 obj_name;
+    int                    my_data_count, nbatch = 0;
+    pdc_metadata_t *       metadata;
+    pdcid_t                pdc, cont_prop, cont, obj_prop;
+    int                    ndim = 1;
+    int *                  mydata;
+    int                    lo = 1000, hi = 200000;
+    pdc_query_t *          ql, *qh, *q;
+    int                    ret_value = 0;
+    uint32_t               metadata_server_id;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+
+    if (argc < 3) {
+        print_usage();
+#ifdef ENABLE_MPI
+        MPI_Finalize();
+#endif
+        return 1;
+    }
+
+    obj_name = argv[1];
+    size_MB  = atoi(argv[2]);
+
+    if (rank == 0) {
+        printf("Writing a %" PRIu64 " MB object [%s] with %d clients.\n", size_MB, obj_name, size);
+    }
+    size_MB *= 1048576;
+
+    // create a pdc
+    pdc = PDCinit("pdc");
+
+    // create a container property
+    cont_prop = PDCprop_create(PDC_CONT_CREATE, pdc);
+    if (cont_prop <= 0) {
+        printf("Fail to create container property @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+    // create a container
+    cont = PDCcont_create("c1", cont_prop);
+    if (cont <= 0) {
+        printf("Fail to create container @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+    // create an object property
+    obj_prop = PDCprop_create(PDC_OBJ_CREATE, pdc);
+    if (obj_prop <= 0) {
+        printf("Fail to create object property @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+    my_data_count = size_MB / size;
+    dims[0]       = my_data_count;
+    PDCprop_set_obj_dims(obj_prop, 1, dims);
+    PDCprop_set_obj_user_id(obj_prop, getuid());
+    PDCprop_set_obj_time_step(obj_prop, 0);
+    PDCprop_set_obj_app_name(obj_prop, "DataServerTest");
+    PDCprop_set_obj_tags(obj_prop, "tag0=1");
+    PDCprop_set_obj_type(obj_prop, PDC_INT);
+
+    // Create a object with only rank 0
+    if (rank == 0) {
+        obj_id = PDCobj_create(cont, obj_name, obj_prop);
+        if (obj_id <= 0) {
+            printf("Error getting an object id of %s from server, exit...\n", obj_name);
+            ret_value = 1;
+        }
+    }
+
+#ifdef ENABLE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+    // Query the created object
+    PDC_Client_query_metadata_name_timestep(obj_name, 0, &metadata, &metadata_server_id);
+    if (metadata == NULL || metadata->obj_id == 0) {
+        printf("Error with metadata!\n");
+        ret_value = 1;
+    }
+
+    region.ndim      = ndim;
+    region.offset    = (uint64_t *)malloc(sizeof(uint64_t) * ndim);
+    region.size      = (uint64_t *)malloc(sizeof(uint64_t) * ndim);
+    region.offset[0] = rank * my_data_count;
+    region.size[0]   = my_data_count;
+
+    mydata = (int *)malloc(my_data_count);
+    for (i = 0; i < my_data_count / sizeof(int); i++)
+        mydata[i] = i + rank * 1000;
+
+    PDC_Client_write(metadata, &region, mydata);
+
+#ifdef ENABLE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+    if (rank == 0) {
+        ql = PDCquery_create(obj_id, PDC_GTE, PDC_INT, &lo);
+        qh = PDCquery_create(obj_id, PDC_LT, PDC_INT, &hi);
+        q  = PDCquery_and(ql, qh);
+
+        PDCquery_get_nhits(q, &nhits);
+
+        // Consume the selection batch by batch, the total must match the number of hits
+        while (PDCquery_get_next_batch(q, &sel) == SUCCEED && sel.nhits > 0) {
+            for (i = 0; i < sel.nhits; i++) {
+                if (sel.coords[i] >= dims[0] * size) {
+                    printf("Batch %d has invalid coord %" PRIu64 "\n", nbatch, sel.coords[i]);
+                    ret_value = 1;
+                    break;
+                }
+            }
+            batch_nhits += sel.nhits;
+            nbatch++;
+        }
+
+        printf("Query has %" PRIu64 " hits, received %" PRIu64 " coords in %d batches\n", nhits, batch_nhits,
+               nbatch);
+        if (batch_nhits != nhits) {
+            printf("Number of coords received in batches does not match the number of hits!\n");
+            ret_value = 1;
+        }
+
+        PDCquery_free_all(q);
+
+        // Stop after the first batch, freeing the query tells the servers to drop the rest
+        ql = PDCquery_create(obj_id, PDC_GTE, PDC_INT, &lo);
+        qh = PDCquery_create(obj_id, PDC_LT, PDC_INT, &hi);
+        q  = PDCquery_and(ql, qh);
+        if (PDCquery_get_next_batch(q, &sel) != SUCCEED || (nhits > 0 && sel.nhits == 0)) {
+            printf("Fail to get the first batch of the second query!\n");
+            ret_value = 1;
+        }
+        PDCquery_free_all(q);
+
+        // The servers still answer after a stream has been abandoned
+        ql = PDCquery_create(obj_id, PDC_GTE, PDC_INT, &lo);
+        qh = PDCquery_create(obj_id, PDC_LT, PDC_INT, &hi);
+        q  = PDCquery_and(ql, qh);
+
+        batch_nhits = 0;
+        PDCquery_get_nhits(q, &batch_nhits);
+        if (batch_nhits != nhits) {
+            printf("Number of hits after an abandoned query is %" PRIu64 ", expected %" PRIu64 "\n",
+                   batch_nhits, nhits);
+            ret_value = 1;
+        }
+        PDCquery_free_all(q);
+    }
+
+    PDCregion_free(&region);
+    free(mydata);
+    // close a container
+    if (PDCcont_close(cont) < 0) {
+        printf("fail to close container c1\n");
+        ret_value = 1;
+    }
+    // close a container property
+    if (PDCprop_close(cont_prop) < 0) {
+        printf("Fail to close property @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCclose(pdc) < 0) {
+        printf("fail to close PDC\n");
+        ret_value = 1;
+    }
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+
+    return ret_value;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+/*
+ * Time PDCregion_transfer_start_all against the number of data servers. Each object is statically
+ * partitioned over all servers, so every start_all sends one packed request per server. Run with
+ * mpi_test.sh under different server counts and compare the start times. The write throughput and the
+ * peak resident size of the clients are reported as well, to see what packing the requests costs.
+ *
+ * Usage: region_transfer_all_bench [n_objects] [ints_per_object] [n_iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "pdc.h"
+
+int
+main(int argc, char **argv)
+{
+    pdcid_t       pdc, cont_prop, cont, obj_prop, reg, reg_global;
+    pdcid_t *     obj, *transfer_request;
+    perr_t        ret;
+    char          cont_name[128], obj_name[128];
+    int           rank = 0, size = 1, i, iter, ret_value = 0;
+    int           n_objects = 8, n_iter = 5;
+    int *         data;
+    uint64_t      obj_len = 1048576, offset[1], offset_length[1], dims[1];
+    double        start, start_time = 0, wait_time = 0, max_start, max_wait;
+    long          max_rss;
+    struct rusage usage;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+    if (argc >= 2)
+        n_objects = atoi(argv[1]);
+    if (argc >= 3)
+        obj_len = strtoull(argv[2], NULL, 10);
+    if (argc >= 4)
+        n_iter = atoi(argv[3]);
+
+    data             = (int *)malloc(sizeof(int) * obj_len * n_objects);
+    obj              = (pdcid_t *)malloc(sizeof(pdcid_t) * n_objects);
+    transfer_request = (pdcid_t *)malloc(sizeof(pdcid_t) * n_objects);
+    for (i = 0; i < n_objects; ++i)
+        memset(data + obj_len * i, i, sizeof(int) * obj_len);
+
+    pdc       = PDCinit("pdc");
+    cont_prop = PDCprop_create(PDC_CONT_CREATE, pdc);
+    sprintf(cont_name, "c%d", rank);
+    cont = PDCcont_create(cont_name, cont_prop);
+    if (cont <= 0) {
+        printf("Fail to create container @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+
+    dims[0]  = obj_len;
+    obj_prop = PDCprop_create(PDC_OBJ_CREATE, pdc);
+    PDCprop_set_obj_type(obj_prop, PDC_INT);
+    PDCprop_set_obj_dims(obj_prop, 1, dims);
+    PDCprop_set_obj_user_id(obj_prop, getuid());
+    PDCprop_set_obj_app_name(obj_prop, "RegionTransferAllBench");
+    PDCprop_set_obj_transfer_region_type(obj_prop, PDC_REGION_STATIC);
+
+    for (i = 0; i < n_objects; ++i) {
+        sprintf(obj_name, "o%d_%d", i, rank);
+        obj[i] = PDCobj_create(cont, obj_name, obj_prop);
+        if (obj[i] <= 0) {
+            printf("Fail to create object @ line  %d!\n", __LINE__);
+            ret_value = 1;
+        }
+    }
+
+    offset[0]        = 0;
+    offset_length[0] = obj_len;
+    reg              = PDCregion_create(1, offset, offset_length);
+    reg_global       = PDCregion_create(1, offset, offset_length);
+
+    for (iter = 0; iter < n_iter; ++iter) {
+        for (i = 0; i < n_objects; ++i)
+            transfer_request[i] =
+                PDCregion_transfer_create(data + obj_len * i, PDC_WRITE, obj[i], reg, reg_global);
+
+#ifdef ENABLE_MPI
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        start = MPI_Wtime();
+        ret   = PDCregion_transfer_start_all(transfer_request, n_objects);
+        start_time += MPI_Wtime() - start;
+        if (ret != SUCCEED) {
+            printf("Fail to region transfer start @ line %d\n", __LINE__);
+            ret_value = 1;
+        }
+
+        start = MPI_Wtime();
+        ret   = PDCregion_transfer_wait_all(transfer_request, n_objects);
+        wait_time += MPI_Wtime() - start;
+        if (ret != SUCCEED) {
+            printf("Fail to region transfer wait @ line %d\n", __LINE__);
+            ret_value = 1;
+        }
+
+        for (i = 0; i < n_objects; ++i) {
+            if (PDCregion_transfer_close(transfer_request[i]) != SUCCEED) {
+                printf("Fail to region transfer close @ line %d\n", __LINE__);
+                ret_value = 1;
+            }
+        }
+    }
+
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef ENABLE_MPI
+    MPI_Reduce(&start_time, &max_start, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&wait_time, &max_wait, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&usage.ru_maxrss, &max_rss, 1, MPI_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+#else
+    max_start = start_time;
+    max_wait  = wait_time;
+    max_rss   = usage.ru_maxrss;
+#endif
+    if (rank == 0 && n_iter > 0)
+        printf("region_transfer_all_bench: %d clients, %d objects x %" PRIu64 " ints, start_all %.3f ms, "
+               "wait_all %.3f ms per iteration, %.1f MB/s, peak RSS %ld KB\n",
+               size, n_objects, obj_len, max_start * 1000.0 / n_iter, max_wait * 1000.0 / n_iter,
+               sizeof(int) * obj_len * n_objects * size * n_iter / 1048576.0 / (max_start + max_wait),
+               max_rss);
+
+    PDCregion_close(reg);
+    PDCregion_close(reg_global);
+    for (i = 0; i < n_objects; ++i)
+        PDCobj_close(obj[i]);
+    PDCprop_close(obj_prop);
+    PDCcont_close(cont);
+    PDCprop_close(cont_prop);
+    PDCclose(pdc);
+
+    free(data);
+    free(obj);
+    free(transfer_request);
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+    return ret_value;
+}
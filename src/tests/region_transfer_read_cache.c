@@ -0,0 +1,165 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pdc.h"
+#define BUF_LEN   4096
+#define CHUNK_LEN 256
+
+/*
+ * Write or read a region of the object and wait for it
+ */
+static int
+transfer_region(pdcid_t obj, int *buf, pdc_access_t access_type, uint64_t offset, uint64_t length)
+{
+    pdcid_t  reg, reg_global, transfer_request;
+    uint64_t local_offset = 0;
+    int      ret_value    = 0;
+
+    reg              = PDCregion_create(1, &local_offset, &length);
+    reg_global       = PDCregion_create(1, &offset, &length);
+    transfer_request = PDCregion_transfer_create(buf, access_type, obj, reg, reg_global);
+    if (PDCregion_transfer_start(transfer_request) != SUCCEED) {
+        printf("Fail to region transfer start @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCregion_transfer_wait(transfer_request) != SUCCEED) {
+        printf("Fail to region transfer wait @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    PDCregion_transfer_close(transfer_request);
+    PDCregion_close(reg);
+    PDCregion_close(reg_global);
+    return ret_value;
+}
+
+/*
+ * Read the object in chunks from the start and check every value, value i of the object should be i + base
+ * except in the chunk starting at changed, where it should be i + changed_base
+ */
+static int
+read_chunks(pdcid_t obj, int base, uint64_t changed, int changed_base)
+{
+    int      data_read[CHUNK_LEN];
+    uint64_t offset;
+    int      i, expected, ret_value = 0;
+
+    for (offset = 0; offset < BUF_LEN; offset += CHUNK_LEN) {
+        memset(data_read, 0, sizeof(data_read));
+        ret_value |= transfer_region(obj, data_read, PDC_READ, offset, CHUNK_LEN);
+        for (i = 0; i < CHUNK_LEN; ++i) {
+            expected = (int)(offset + i) + (offset == changed ? changed_base : base);
+            if (data_read[i] != expected) {
+                printf("wrong value %d != %d at %d @ line %d\n", data_read[i], expected, (int)offset + i,
+                       __LINE__);
+                ret_value = 1;
+                break;
+            }
+        }
+    }
+    return ret_value;
+}
+
+int
+main(int argc, char **argv)
+{
+    pdcid_t  pdc, cont_prop, cont, obj_prop, obj;
+    char     cont_name[128], obj_name[128];
+    int      rank = 0, i, ret_value = 0;
+    int *    data = (int *)malloc(sizeof(int) * BUF_LEN);
+    uint64_t dims[1];
+
+    dims[0] = BUF_LEN;
+
+#ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    pdc = PDCinit("pdc");
+
+    cont_prop = PDCprop_create(PDC_CONT_CREATE, pdc);
+    sprintf(cont_name, "c%d", rank);
+    cont = PDCcont_create(cont_name, cont_prop);
+    if (cont <= 0) {
+        printf("Fail to create container @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+    obj_prop = PDCprop_create(PDC_OBJ_CREATE, pdc);
+    PDCprop_set_obj_type(obj_prop, PDC_INT);
+    PDCprop_set_obj_dims(obj_prop, 1, dims);
+    PDCprop_set_obj_user_id(obj_prop, getuid());
+    PDCprop_set_obj_time_step(obj_prop, 0);
+    PDCprop_set_obj_app_name(obj_prop, "DataServerTest");
+    PDCprop_set_obj_tags(obj_prop, "tag0=1");
+
+    sprintf(obj_name, "o_read_cache_%d", rank);
+    obj = PDCobj_create(cont, obj_name, obj_prop);
+    if (obj <= 0) {
+        printf("Fail to create object @ line  %d!\n", __LINE__);
+        ret_value = 1;
+    }
+
+    for (i = 0; i < BUF_LEN; ++i)
+        data[i] = i;
+    ret_value |= transfer_region(obj, data, PDC_WRITE, 0, BUF_LEN);
+
+    // The first pass is sequential and can be prefetched, the second pass reads the same chunks again
+    ret_value |= read_chunks(obj, 0, BUF_LEN, 0);
+    ret_value |= read_chunks(obj, 0, BUF_LEN, 0);
+
+    // A write must not leave stale data in the cache
+    for (i = 0; i < CHUNK_LEN; ++i)
+        data[i] = CHUNK_LEN * 3 + i + 1000;
+    ret_value |= transfer_region(obj, data, PDC_WRITE, CHUNK_LEN * 3, CHUNK_LEN);
+    ret_value |= read_chunks(obj, 0, CHUNK_LEN * 3, 1000);
+
+    if (PDCobj_close(obj) < 0) {
+        printf("fail to close object @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCcont_close(cont) < 0) {
+        printf("fail to close container @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCprop_close(obj_prop) < 0) {
+        printf("Fail to close property @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCprop_close(cont_prop) < 0) {
+        printf("Fail to close property @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    if (PDCclose(pdc) < 0) {
+        printf("fail to close PDC @ line %d\n", __LINE__);
+        ret_value = 1;
+    }
+    free(data);
+#ifdef ENABLE_MPI
+    MPI_Finalize();
+#endif
+    return ret_value;
+}
@@ -44,7 +44,7 @@ uniform_random_number()
 void
 print_usage()
 {
-    printf("Usage: srun -n ./vpicio #particles #steps sleep_time(s)\n");
+    printf("Usage: srun -n ./vpicio #particles #steps sleep_time(s) [overlap]\n");
 }
 
 int
@@ -76,7 +76,7 @@ main(int argc, char **argv)
     uint64_t *offset_remote;
     uint64_t *mysize;
     double    t0, t1;
-    int       steps = 1, sleeptime = 0;
+    int       steps = 1, sleeptime = 0, overlap = 0;
 
     pdcid_t transfer_request_x, transfer_request_y, transfer_request_z, transfer_request_px,
         transfer_request_py, transfer_request_pz, transfer_request_id1, transfer_request_id2;
@@ -89,11 +89,15 @@ main(int argc, char **argv)
 #endif
 
     numparticles = NPARTICLES;
-    if (argc == 4) {
+    if (argc >= 4) {
         numparticles = atoll(argv[1]);
         steps        = atoi(argv[2]);
         sleeptime    = atoi(argv[3]);
     }
+    // Sleep between transfer start and wait instead of after the wait, the transfers then overlap the
+    // compute when PDC_CLIENT_PROGRESS_THREAD=1
+    if (argc >= 5)
+        overlap = atoi(argv[4]);
     if (rank == 0)
         printf("Writing %" PRIu64 " number of particles for %d steps with %d clients.\n", numparticles, steps,
                size);
@@ -362,6 +366,16 @@ main(int argc, char **argv)
         }
 #endif
 
+        if (overlap) {
+            sleep(sleeptime);
+            if (rank == 0) {
+                printf("Sleep time (overlapped): %d.00\n", sleeptime);
+            }
+#ifdef ENABLE_MPI
+            t1 = MPI_Wtime();
+#endif
+        }
+
         ret = PDCregion_transfer_wait(transfer_request_x);
         if (ret != SUCCEED) {
             printf("Failed to transfer wait for region_xx\n");
@@ -501,7 +515,7 @@ main(int argc, char **argv)
             printf("Obj close time: %.2f\n", t0 - t1);
         }
 #endif
-        if (i != steps - 1) {
+        if (!overlap && i != steps - 1) {
             sleep(sleeptime);
             if (rank == 0) {
                 printf("Sleep time: %d.00\n", sleeptime);
@@ -0,0 +1,119 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#ifndef PDC_INTERVAL_TREE_H
+#define PDC_INTERVAL_TREE_H
+
+#include <stdint.h>
+
+/* Balanced interval tree over closed ranges [lo, hi], each carrying a user pointer. Used to index the
+ * extents of regions along one dimension, queries return candidates that callers check in all dims. */
+typedef struct pdc_interval_node_t {
+    uint64_t                    lo;
+    uint64_t                    hi;
+    uint64_t                    max_hi; // largest hi in the subtree
+    void *                      data;
+    int                         height;
+    struct pdc_interval_node_t *left;
+    struct pdc_interval_node_t *right;
+} pdc_interval_node_t;
+
+typedef struct pdc_interval_tree_t {
+    pdc_interval_node_t *root;
+    uint64_t             count;
+} pdc_interval_tree_t;
+
+/* Called for each interval found by a query, a non-zero return value stops the query */
+typedef int (*pdc_interval_cb_t)(void *data, void *arg);
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Init an empty interval tree
+ *
+ * \param tree [IN]             Pointer to the tree
+ */
+void PDC_interval_tree_init(pdc_interval_tree_t *tree);
+
+/**
+ * Free all nodes of an interval tree
+ *
+ * \param tree [IN]             Pointer to the tree
+ * \param free_data [IN]        Function to free the data of each node, NULL to keep the data
+ */
+void PDC_interval_tree_destroy(pdc_interval_tree_t *tree, void (*free_data)(void *));
+
+/**
+ * Insert an interval
+ *
+ * \param tree [IN]             Pointer to the tree
+ * \param lo [IN]               Start of the interval
+ * \param hi [IN]               End of the interval, included
+ * \param data [IN]             User pointer, must be unique in the tree
+ *
+ * \return Non-negative on success/Negative on failure
+ */
+int PDC_interval_tree_insert(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, void *data);
+
+/**
+ * Remove an interval inserted before
+ *
+ * \param tree [IN]             Pointer to the tree
+ * \param lo [IN]               Start of the interval, as inserted
+ * \param data [IN]             User pointer of the interval
+ *
+ * \return Non-negative on success/Negative if the interval is not in the tree
+ */
+int PDC_interval_tree_remove(pdc_interval_tree_t *tree, uint64_t lo, void *data);
+
+/**
+ * Visit the intervals that intersect [lo, hi], in increasing order of their start
+ *
+ * \param tree [IN]             Pointer to the tree
+ * \param lo [IN]               Start of the query range
+ * \param hi [IN]               End of the query range, included
+ * \param cb [IN]               Function called with the data of each interval found
+ * \param arg [IN]              Argument passed to cb
+ *
+ * \return Zero if all intervals were visited/The non-zero value returned by cb
+ */
+int PDC_interval_tree_query_overlap(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb,
+                                    void *arg);
+
+/**
+ * Visit the intervals that contain [lo, hi], in increasing order of their start
+ *
+ * \param tree [IN]             Pointer to the tree
+ * \param lo [IN]               Start of the query range
+ * \param hi [IN]               End of the query range, included
+ * \param cb [IN]               Function called with the data of each interval found
+ * \param arg [IN]              Argument passed to cb
+ *
+ * \return Zero if all intervals were visited/The non-zero value returned by cb
+ */
+int PDC_interval_tree_query_contain(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb,
+                                    void *arg);
+
+#endif /* PDC_INTERVAL_TREE_H */
@@ -0,0 +1,125 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#ifndef PDC_LOGGER_H
+#define PDC_LOGGER_H
+
+#include <stdint.h>
+
+typedef enum {
+    PDC_LOG_LEVEL_NONE    = 0,
+    PDC_LOG_LEVEL_ERROR   = 1,
+    PDC_LOG_LEVEL_WARNING = 2,
+    PDC_LOG_LEVEL_INFO    = 3,
+    PDC_LOG_LEVEL_DEBUG   = 4
+} pdc_log_level_t;
+
+/* Most verbose level compiled in, set with the PDC_LOG_LEVEL CMake option. Calls above it are removed by
+ * the compiler, calls up to it are checked against the runtime level from the PDC_LOG_LEVEL env var. */
+#ifndef PDC_LOG_LEVEL_MAX
+#define PDC_LOG_LEVEL_MAX PDC_LOG_LEVEL_INFO
+#endif
+
+// Messages are truncated to fit a ring slot
+#define PDC_LOG_MSG_SIZE 232
+// Slots in each thread's ring, must be a power of two
+#define PDC_LOG_RING_SIZE 512
+// Default messages per second a thread may log, override with PDC_LOG_RATE_LIMIT (0 is unlimited)
+#define PDC_LOG_RATE_LIMIT_DEFAULT 1000
+// Default interval of the background writer in ms, override with PDC_LOG_FLUSH_INTERVAL
+#define PDC_LOG_FLUSH_INTERVAL_DEFAULT 50
+
+typedef struct pdc_log_record_t {
+    uint64_t    time;  // ns since the logger was initialized
+    const char *file;  // __FILE__ of the call site, a string literal
+    int         line;  // __LINE__ of the call site
+    int         level; // pdc_log_level_t
+    char        msg[PDC_LOG_MSG_SIZE];
+} pdc_log_record_t;
+
+/* Single producer/single consumer ring, the owning thread writes at tail and the writer thread reads at
+ * head */
+typedef struct pdc_log_ring_t {
+    pdc_log_record_t       records[PDC_LOG_RING_SIZE];
+    uint64_t               head;
+    uint64_t               tail;
+    uint64_t               dropped;  // records lost to a full ring or the rate limit
+    uint64_t               reported; // dropped count already reported by the writer
+    uint64_t               window;   // second of the current rate limit window
+    uint64_t               nwindow;  // records logged in the current window
+    struct pdc_log_ring_t *next;
+} pdc_log_ring_t;
+
+extern int pdc_log_level_g;
+
+#define PDC_LOG(level, ...)                                                                                  \
+    do {                                                                                                     \
+        if ((level) <= PDC_LOG_LEVEL_MAX && (level) <= pdc_log_level_g)                                      \
+            PDC_log((level), __FILE__, __LINE__, __VA_ARGS__);                                               \
+    } while (0)
+
+#define PDC_LOG_ERROR(...)   PDC_LOG(PDC_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define PDC_LOG_WARNING(...) PDC_LOG(PDC_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define PDC_LOG_INFO(...)    PDC_LOG(PDC_LOG_LEVEL_INFO, __VA_ARGS__)
+#define PDC_LOG_DEBUG(...)   PDC_LOG(PDC_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Read the PDC_LOG_* env vars and start the background writer. Before this is called messages are
+ * written to stderr directly.
+ *
+ * \param name [IN]             Name of the process printed on each line, e.g. "PDC_SERVER"
+ * \param rank [IN]             MPI rank printed after the name
+ */
+void PDC_log_init(const char *name, int rank);
+
+/**
+ * Write out all queued messages and stop the background writer
+ */
+void PDC_log_finalize();
+
+/**
+ * Write out all messages queued so far, e.g. before the process aborts
+ */
+void PDC_log_flush();
+
+/**
+ * Number of messages lost to full rings or the rate limit since the logger was initialized
+ */
+uint64_t PDC_log_dropped();
+
+/**
+ * Queue a message on the calling thread's ring, use the PDC_LOG_* macros instead
+ *
+ * \param level [IN]            Level of the message
+ * \param file [IN]             Source file of the call site
+ * \param line [IN]             Source line of the call site
+ * \param fmt [IN]              printf format of the message
+ */
+void PDC_log(pdc_log_level_t level, const char *file, int line, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#endif /* PDC_LOGGER_H */
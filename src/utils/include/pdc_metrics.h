@@ -0,0 +1,147 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#ifndef PDC_METRICS_H
+#define PDC_METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Log-linear latency histograms: values below 2^PDC_METRICS_SUB_BITS ns get a bucket each, above that
+ * every power of two is split in 2^PDC_METRICS_SUB_BITS buckets, so a bucket is within 1/16 of its value.
+ * Values from 2^PDC_METRICS_MAX_BITS ns (about 18 minutes) on go in the last bucket. */
+#define PDC_METRICS_SUB_BITS    4
+#define PDC_METRICS_SUB_BUCKETS (1 << PDC_METRICS_SUB_BITS)
+#define PDC_METRICS_MAX_BITS    40
+#define PDC_METRICS_NBUCKET     ((PDC_METRICS_MAX_BITS - PDC_METRICS_SUB_BITS + 1) * PDC_METRICS_SUB_BUCKETS)
+
+/* Timed operations, each process only records the ones on its side */
+typedef enum {
+    /* Server RPC handlers */
+    PDC_METRIC_SERVER_TRANSFER_REQUEST = 0,
+    PDC_METRIC_SERVER_TRANSFER_REQUEST_ALL,
+    PDC_METRIC_SERVER_TRANSFER_REQUEST_WAIT,
+    PDC_METRIC_SERVER_TRANSFER_REQUEST_WAIT_ALL,
+    PDC_METRIC_SERVER_TRANSFER_REQUEST_METADATA_QUERY,
+    PDC_METRIC_SERVER_BUF_MAP,
+    PDC_METRIC_SERVER_BUF_UNMAP,
+    PDC_METRIC_SERVER_REGION_LOCK,
+    PDC_METRIC_SERVER_REGION_RELEASE,
+    PDC_METRIC_SERVER_OBJ_CREATE,
+    PDC_METRIC_SERVER_CONT_CREATE,
+    /* Server I/O paths, also count bytes */
+    PDC_METRIC_SERVER_WRITE_BULK,
+    PDC_METRIC_SERVER_READ_BULK,
+    PDC_METRIC_SERVER_DATA_WRITE_OUT,
+    PDC_METRIC_SERVER_DATA_READ_FROM,
+    PDC_METRIC_SERVER_CACHE_WRITE,
+    PDC_METRIC_SERVER_CACHE_READ,
+    PDC_METRIC_SERVER_CACHE_FLUSH,
+    PDC_METRIC_SERVER_OBJ_PUT_DATA,
+    PDC_METRIC_SERVER_OBJ_GET_DATA,
+    /* Client RPCs, from send to response */
+    PDC_METRIC_CLIENT_TRANSFER_REQUEST_WRITE,
+    PDC_METRIC_CLIENT_TRANSFER_REQUEST_READ,
+    PDC_METRIC_CLIENT_TRANSFER_REQUEST_ALL,
+    PDC_METRIC_CLIENT_TRANSFER_REQUEST_WAIT,
+    PDC_METRIC_CLIENT_TRANSFER_REQUEST_WAIT_ALL,
+    PDC_METRIC_CLIENT_OBJ_CREATE,
+    PDC_METRIC_CLIENT_CONT_CREATE,
+    PDC_METRIC_CLIENT_OBJ_PUT_DATA,
+    PDC_METRIC_CLIENT_OBJ_GET_DATA,
+    PDC_METRIC_CLIENT_WRITE_BUFFER_FLUSH,
+    PDC_METRIC_CLIENT_READ_CACHE_HIT,
+    PDC_METRIC_COUNT
+} pdc_metric_t;
+
+typedef struct pdc_latency_hist_t {
+    uint64_t count;
+    uint64_t sum;   // ns
+    uint64_t max;   // ns
+    uint64_t bytes; // bytes moved by the recorded operations
+    uint64_t buckets[PDC_METRICS_NBUCKET];
+} pdc_latency_hist_t;
+
+/***************************************/
+/* Library-private Function Prototypes */
+/***************************************/
+/**
+ * Get a monotonic timestamp for PDC_metrics_record
+ *
+ * \return Nanoseconds since an arbitrary point
+ */
+uint64_t PDC_metrics_now();
+
+/**
+ * Record the latency of an operation that started at a PDC_metrics_now() timestamp, lock-free and
+ * safe to call from any thread
+ *
+ * \param metric [IN]           Metric of the operation
+ * \param start [IN]            PDC_metrics_now() when the operation started
+ * \param bytes [IN]            Bytes moved by the operation, 0 if it moves no data
+ */
+void PDC_metrics_record(pdc_metric_t metric, uint64_t start, uint64_t bytes);
+
+/**
+ * Get the value below which a fraction of the recorded latencies fall
+ *
+ * \param hist [IN]             Pointer to the histogram
+ * \param quantile [IN]         Fraction in [0, 1], e.g. 0.99
+ *
+ * \return Latency in nanoseconds, 0 if nothing was recorded
+ */
+uint64_t PDC_metrics_percentile(const pdc_latency_hist_t *hist, double quantile);
+
+/**
+ * Get the histogram of a metric. The counters keep changing while other threads record.
+ *
+ * \param metric [IN]           Metric to get
+ *
+ * \return Pointer to the histogram
+ */
+const pdc_latency_hist_t *PDC_metrics_get(pdc_metric_t metric);
+
+/**
+ * Get the name of a metric
+ *
+ * \param metric [IN]           Metric to get the name of
+ *
+ * \return Null-terminated name
+ */
+const char *PDC_metrics_name(pdc_metric_t metric);
+
+/**
+ * Write a text snapshot of all metrics that recorded something, one line per metric with the count,
+ * total time, p50/p99/p999/max latency and throughput
+ *
+ * \param buf [OUT]             Buffer to write to
+ * \param size [IN]             Size of the buffer, PDC_METRICS_SNAPSHOT_SIZE is always enough
+ *
+ * \return Length of the snapshot without the null terminator
+ */
+size_t PDC_metrics_snapshot(char *buf, size_t size);
+
+#define PDC_METRICS_SNAPSHOT_SIZE ((PDC_METRIC_COUNT + 2) * 160)
+
+#endif /* PDC_METRICS_H */
@@ -27,6 +27,7 @@
 
 #include "pdc_config.h"
 #include "pdc_public.h"
+#include "pdc_logger.h"
 #include <stdio.h>
 // #include <sys/time.h>			/* gettimeofday() */
 
@@ -146,7 +147,7 @@ extern pbool_t err_occurred;
 
 /* Include a basic profiling interface */
 #ifdef ENABLE_PROFILING
-#include "stack_ops.h"
+#include "pdc_stack_ops.h"
 
 #define FUNC_ENTER(X)                                                                                        \
     do {                                                                                                     \
@@ -168,6 +169,14 @@ extern pbool_t err_occurred;
         return;                                                                                              \
     } while (0)
 
+/* Link the trace spans of a request across processes, phase is 's' at the start, 't' in between and 'f'
+ * at the end */
+#define PDC_PROFILE_FLOW(name, id, phase)                                                                    \
+    do {                                                                                                     \
+        if (enableProfiling)                                                                                 \
+            profile_flow((name), (id), (phase));                                                             \
+    } while (0)
+
 #else
 /* #define FUNC_ENTER(X) \ */
 /*     do { \ */
@@ -197,6 +206,10 @@ extern pbool_t err_occurred;
     do {                                                                                                     \
         return;                                                                                              \
     } while (0)
+
+#define PDC_PROFILE_FLOW(name, id, phase)                                                                    \
+    do {                                                                                                     \
+    } while (0)
 #endif
 
 #endif /* PDC_PRIVATE_H */
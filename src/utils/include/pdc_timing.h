@@ -114,6 +114,10 @@ typedef struct pdc_server_timing {
     double PDCdata_server_write_posix;
     double PDCdata_server_read_posix;
 
+    double PDCquery_cache_hit;
+    double PDCquery_cache_miss;
+    double PDCquery_cache_invalidate;
+
     double PDCserver_obj_create_rpc;
     double PDCserver_cont_create_rpc;
 
@@ -0,0 +1,262 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#include <stdlib.h>
+#include "pdc_interval_tree.h"
+
+/* Nodes are ordered by lo, then by the data pointer so that equal starts stay distinct */
+static int
+interval_cmp(uint64_t lo, void *data, pdc_interval_node_t *node)
+{
+    if (lo != node->lo)
+        return lo < node->lo ? -1 : 1;
+    if (data != node->data)
+        return (uintptr_t)data < (uintptr_t)node->data ? -1 : 1;
+    return 0;
+}
+
+static inline int
+node_height(pdc_interval_node_t *node)
+{
+    return node ? node->height : 0;
+}
+
+static void
+node_update(pdc_interval_node_t *node)
+{
+    int lh = node_height(node->left), rh = node_height(node->right);
+
+    node->height = (lh > rh ? lh : rh) + 1;
+    node->max_hi = node->hi;
+    if (node->left && node->left->max_hi > node->max_hi)
+        node->max_hi = node->left->max_hi;
+    if (node->right && node->right->max_hi > node->max_hi)
+        node->max_hi = node->right->max_hi;
+}
+
+static pdc_interval_node_t *
+rotate_right(pdc_interval_node_t *node)
+{
+    pdc_interval_node_t *left = node->left;
+
+    node->left  = left->right;
+    left->right = node;
+    node_update(node);
+    node_update(left);
+    return left;
+}
+
+static pdc_interval_node_t *
+rotate_left(pdc_interval_node_t *node)
+{
+    pdc_interval_node_t *right = node->right;
+
+    node->right = right->left;
+    right->left = node;
+    node_update(node);
+    node_update(right);
+    return right;
+}
+
+static pdc_interval_node_t *
+rebalance(pdc_interval_node_t *node)
+{
+    int balance;
+
+    node_update(node);
+    balance = node_height(node->left) - node_height(node->right);
+    if (balance > 1) {
+        if (node_height(node->left->left) < node_height(node->left->right))
+            node->left = rotate_left(node->left);
+        return rotate_right(node);
+    }
+    if (balance < -1) {
+        if (node_height(node->right->right) < node_height(node->right->left))
+            node->right = rotate_right(node->right);
+        return rotate_left(node);
+    }
+    return node;
+}
+
+static pdc_interval_node_t *
+node_insert(pdc_interval_node_t *node, pdc_interval_node_t *new_node)
+{
+    if (node == NULL)
+        return new_node;
+    if (interval_cmp(new_node->lo, new_node->data, node) < 0)
+        node->left = node_insert(node->left, new_node);
+    else
+        node->right = node_insert(node->right, new_node);
+    return rebalance(node);
+}
+
+static pdc_interval_node_t *
+node_remove_min(pdc_interval_node_t *node, pdc_interval_node_t **min)
+{
+    if (node->left == NULL) {
+        *min = node;
+        return node->right;
+    }
+    node->left = node_remove_min(node->left, min);
+    return rebalance(node);
+}
+
+static pdc_interval_node_t *
+node_remove(pdc_interval_node_t *node, uint64_t lo, void *data, int *found)
+{
+    pdc_interval_node_t *min;
+    int                  cmp;
+
+    if (node == NULL)
+        return NULL;
+    cmp = interval_cmp(lo, data, node);
+    if (cmp < 0)
+        node->left = node_remove(node->left, lo, data, found);
+    else if (cmp > 0)
+        node->right = node_remove(node->right, lo, data, found);
+    else {
+        *found = 1;
+        if (node->right == NULL) {
+            min = node->left;
+            free(node);
+            return min;
+        }
+        node->right = node_remove_min(node->right, &min);
+        min->left   = node->left;
+        min->right  = node->right;
+        free(node);
+        node = min;
+    }
+    return rebalance(node);
+}
+
+static void
+node_destroy(pdc_interval_node_t *node, void (*free_data)(void *))
+{
+    if (node == NULL)
+        return;
+    node_destroy(node->left, free_data);
+    node_destroy(node->right, free_data);
+    if (free_data)
+        free_data(node->data);
+    free(node);
+}
+
+static int
+node_query_overlap(pdc_interval_node_t *node, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb, void *arg)
+{
+    int ret;
+
+    // Nothing in this subtree ends at or after lo
+    if (node == NULL || node->max_hi < lo)
+        return 0;
+    if ((ret = node_query_overlap(node->left, lo, hi, cb, arg)) != 0)
+        return ret;
+    // This node and everything to its right start after hi
+    if (node->lo > hi)
+        return 0;
+    if (node->hi >= lo && (ret = cb(node->data, arg)) != 0)
+        return ret;
+    return node_query_overlap(node->right, lo, hi, cb, arg);
+}
+
+static int
+node_query_contain(pdc_interval_node_t *node, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb, void *arg)
+{
+    int ret;
+
+    // Nothing in this subtree reaches hi
+    if (node == NULL || node->max_hi < hi)
+        return 0;
+    if ((ret = node_query_contain(node->left, lo, hi, cb, arg)) != 0)
+        return ret;
+    // This node and everything to its right start after lo
+    if (node->lo > lo)
+        return 0;
+    if (node->hi >= hi && (ret = cb(node->data, arg)) != 0)
+        return ret;
+    return node_query_contain(node->right, lo, hi, cb, arg);
+}
+
+void
+PDC_interval_tree_init(pdc_interval_tree_t *tree)
+{
+    tree->root  = NULL;
+    tree->count = 0;
+}
+
+void
+PDC_interval_tree_destroy(pdc_interval_tree_t *tree, void (*free_data)(void *))
+{
+    node_destroy(tree->root, free_data);
+    tree->root  = NULL;
+    tree->count = 0;
+}
+
+int
+PDC_interval_tree_insert(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, void *data)
+{
+    pdc_interval_node_t *node;
+
+    node = (pdc_interval_node_t *)malloc(sizeof(pdc_interval_node_t));
+    if (node == NULL)
+        return -1;
+    node->lo     = lo;
+    node->hi     = hi;
+    node->max_hi = hi;
+    node->data   = data;
+    node->height = 1;
+    node->left   = NULL;
+    node->right  = NULL;
+
+    tree->root = node_insert(tree->root, node);
+    tree->count++;
+    return 0;
+}
+
+int
+PDC_interval_tree_remove(pdc_interval_tree_t *tree, uint64_t lo, void *data)
+{
+    int found = 0;
+
+    tree->root = node_remove(tree->root, lo, data, &found);
+    if (!found)
+        return -1;
+    tree->count--;
+    return 0;
+}
+
+int
+PDC_interval_tree_query_overlap(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb,
+                                void *arg)
+{
+    return node_query_overlap(tree->root, lo, hi, cb, arg);
+}
+
+int
+PDC_interval_tree_query_contain(pdc_interval_tree_t *tree, uint64_t lo, uint64_t hi, pdc_interval_cb_t cb,
+                                void *arg)
+{
+    return node_query_contain(tree->root, lo, hi, cb, arg);
+}
@@ -0,0 +1,350 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <inttypes.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "pdc_logger.h"
+
+int pdc_log_level_g = PDC_LOG_LEVEL_INFO;
+
+static const char *pdc_log_level_names_g[] = {"NONE", "ERROR", "WARNING", "INFO", "DEBUG"};
+
+// Rings are replaced when the logger is initialized again, the generation tells a thread its ring is gone
+static __thread pdc_log_ring_t *pdc_log_ring_g     = NULL;
+static __thread uint64_t        pdc_log_ring_gen_g = 0;
+
+static pdc_log_ring_t *pdc_log_rings_g       = NULL;
+static uint64_t        pdc_log_generation_g  = 0;
+static int             pdc_log_running_g     = 0;
+static int             pdc_log_fd_g          = STDOUT_FILENO;
+static uint64_t        pdc_log_rate_limit_g  = PDC_LOG_RATE_LIMIT_DEFAULT;
+static int             pdc_log_interval_ms_g = PDC_LOG_FLUSH_INTERVAL_DEFAULT;
+static uint64_t        pdc_log_start_g       = 0;
+static int             pdc_log_rank_g        = 0;
+static char            pdc_log_name_g[64]    = "PDC";
+static pthread_t       pdc_log_writer_g;
+
+// Guards the ring list and the output buffer
+static pthread_mutex_t pdc_log_mutex_g = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pdc_log_cond_g  = PTHREAD_COND_INITIALIZER;
+static char            pdc_log_buf_g[65536];
+
+static inline uint64_t
+log_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void
+log_write_all(int fd, const char *buf, size_t size)
+{
+    ssize_t n;
+
+    while (size > 0) {
+        n = write(fd, buf, size);
+        if (n <= 0)
+            return;
+        buf += n;
+        size -= (size_t)n;
+    }
+}
+
+// Format one line, returns its length
+static size_t
+log_format(char *buf, size_t size, uint64_t time, int level, const char *file, int line, const char *msg)
+{
+    const char *base = strrchr(file, '/');
+    size_t      len, msg_len = strlen(msg);
+
+    // Most messages carried over from printf end with a newline already
+    while (msg_len > 0 && msg[msg_len - 1] == '\n')
+        msg_len--;
+
+    len = (size_t)snprintf(buf, size, "[%.6f] %s[%d] %s %s:%d: %.*s\n", time / 1e9, pdc_log_name_g,
+                           pdc_log_rank_g, pdc_log_level_names_g[level], base ? base + 1 : file, line,
+                           (int)msg_len, msg);
+    return len < size ? len : size - 1;
+}
+
+// Write out all queued records, called with pdc_log_mutex_g held
+static void
+log_drain()
+{
+    pdc_log_ring_t *  ring;
+    pdc_log_record_t *rec;
+    uint64_t          head, tail, dropped;
+    size_t            len = 0;
+
+    for (ring = pdc_log_rings_g; ring != NULL; ring = ring->next) {
+        head = ring->head;
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            if (sizeof(pdc_log_buf_g) - len < PDC_LOG_MSG_SIZE + 256) {
+                log_write_all(pdc_log_fd_g, pdc_log_buf_g, len);
+                len = 0;
+            }
+            rec = &ring->records[head & (PDC_LOG_RING_SIZE - 1)];
+            len += log_format(pdc_log_buf_g + len, sizeof(pdc_log_buf_g) - len, rec->time, rec->level,
+                              rec->file, rec->line, rec->msg);
+        }
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+        dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if (dropped != ring->reported) {
+            len += (size_t)snprintf(pdc_log_buf_g + len, sizeof(pdc_log_buf_g) - len,
+                                    "[%.6f] %s[%d] WARNING: dropped %" PRIu64 " log messages\n",
+                                    (log_now() - pdc_log_start_g) / 1e9, pdc_log_name_g, pdc_log_rank_g,
+                                    dropped - ring->reported);
+            ring->reported = dropped;
+        }
+    }
+
+    // Let plain printf output show up without a flush on every call
+    fflush(stdout);
+    if (len > 0)
+        log_write_all(pdc_log_fd_g, pdc_log_buf_g, len);
+}
+
+static void *
+log_writer(void *arg)
+{
+    struct timespec deadline;
+
+    (void)arg;
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    while (pdc_log_running_g) {
+        log_drain();
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)pdc_log_interval_ms_g * 1000000L;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&pdc_log_cond_g, &pdc_log_mutex_g, &deadline);
+    }
+    log_drain();
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+
+    return NULL;
+}
+
+static pdc_log_ring_t *
+log_get_ring()
+{
+    pdc_log_ring_t *ring;
+
+    if (pdc_log_ring_g != NULL &&
+        pdc_log_ring_gen_g == __atomic_load_n(&pdc_log_generation_g, __ATOMIC_RELAXED))
+        return pdc_log_ring_g;
+
+    ring = (pdc_log_ring_t *)calloc(1, sizeof(pdc_log_ring_t));
+    if (ring == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    ring->next         = pdc_log_rings_g;
+    pdc_log_rings_g    = ring;
+    pdc_log_ring_gen_g = pdc_log_generation_g;
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+    pdc_log_ring_g = ring;
+
+    return ring;
+}
+
+void
+PDC_log(pdc_log_level_t level, const char *file, int line, const char *fmt, ...)
+{
+    pdc_log_ring_t *  ring = NULL;
+    pdc_log_record_t *rec;
+    char              msg[PDC_LOG_MSG_SIZE];
+    char              buf[PDC_LOG_MSG_SIZE + 256];
+    va_list           args;
+    uint64_t          now, head, tail;
+
+    now = log_now();
+    if (__atomic_load_n(&pdc_log_running_g, __ATOMIC_ACQUIRE))
+        ring = log_get_ring();
+
+    if (ring == NULL) {
+        // No writer running, write it out now
+        va_start(args, fmt);
+        vsnprintf(msg, sizeof(msg), fmt, args);
+        va_end(args);
+        log_write_all(STDERR_FILENO, buf,
+                      log_format(buf, sizeof(buf), pdc_log_start_g ? now - pdc_log_start_g : 0, level, file,
+                                 line, msg));
+        return;
+    }
+
+    // Errors are never rate limited
+    if (pdc_log_rate_limit_g > 0 && level > PDC_LOG_LEVEL_ERROR) {
+        if (now / 1000000000ULL != ring->window) {
+            ring->window  = now / 1000000000ULL;
+            ring->nwindow = 0;
+        }
+        if (ring->nwindow >= pdc_log_rate_limit_g) {
+            __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        ring->nwindow++;
+    }
+
+    tail = ring->tail;
+    head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head >= PDC_LOG_RING_SIZE) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    rec        = &ring->records[tail & (PDC_LOG_RING_SIZE - 1)];
+    rec->time  = now - pdc_log_start_g;
+    rec->file  = file;
+    rec->line  = line;
+    rec->level = level;
+    va_start(args, fmt);
+    vsnprintf(rec->msg, sizeof(rec->msg), fmt, args);
+    va_end(args);
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+    // Wake the writer early for errors and rings filling up, otherwise it drains on its own interval
+    if (level == PDC_LOG_LEVEL_ERROR || tail + 1 - head >= PDC_LOG_RING_SIZE / 2)
+        pthread_cond_signal(&pdc_log_cond_g);
+}
+
+static int
+log_parse_level(const char *str)
+{
+    int i;
+
+    for (i = PDC_LOG_LEVEL_NONE; i <= PDC_LOG_LEVEL_DEBUG; i++) {
+        if (strcasecmp(str, pdc_log_level_names_g[i]) == 0)
+            return i;
+    }
+    i = atoi(str);
+    if (i < PDC_LOG_LEVEL_NONE)
+        return PDC_LOG_LEVEL_NONE;
+    if (i > PDC_LOG_LEVEL_DEBUG)
+        return PDC_LOG_LEVEL_DEBUG;
+    return i;
+}
+
+void
+PDC_log_init(const char *name, int rank)
+{
+    char *env;
+    int   fd;
+
+    if (pdc_log_running_g)
+        return;
+
+    pdc_log_start_g = log_now();
+    pdc_log_rank_g  = rank;
+    snprintf(pdc_log_name_g, sizeof(pdc_log_name_g), "%s", name);
+
+    env = getenv("PDC_LOG_LEVEL");
+    if (env != NULL)
+        pdc_log_level_g = log_parse_level(env);
+    env = getenv("PDC_LOG_RATE_LIMIT");
+    if (env != NULL)
+        pdc_log_rate_limit_g = strtoull(env, NULL, 10);
+    env = getenv("PDC_LOG_FLUSH_INTERVAL");
+    if (env != NULL && atoi(env) > 0)
+        pdc_log_interval_ms_g = atoi(env);
+    env = getenv("PDC_LOG_FILE");
+    if (env != NULL) {
+        fd = open(env, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0)
+            fprintf(stderr, "==%s[%d]: cannot open log file %s, logging to stdout\n", name, rank, env);
+        else
+            pdc_log_fd_g = fd;
+    }
+
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    __atomic_store_n(&pdc_log_running_g, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+    if (pthread_create(&pdc_log_writer_g, NULL, log_writer, NULL) != 0) {
+        fprintf(stderr, "==%s[%d]: cannot start the log writer, logging to stderr\n", name, rank);
+        __atomic_store_n(&pdc_log_running_g, 0, __ATOMIC_RELEASE);
+    }
+}
+
+void
+PDC_log_flush()
+{
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    log_drain();
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+}
+
+uint64_t
+PDC_log_dropped()
+{
+    pdc_log_ring_t *ring;
+    uint64_t        dropped = 0;
+
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    for (ring = pdc_log_rings_g; ring != NULL; ring = ring->next)
+        dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+
+    return dropped;
+}
+
+void
+PDC_log_finalize()
+{
+    pdc_log_ring_t *ring, *next;
+
+    if (!pdc_log_running_g)
+        return;
+
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    __atomic_store_n(&pdc_log_running_g, 0, __ATOMIC_RELEASE);
+    pthread_cond_signal(&pdc_log_cond_g);
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+    pthread_join(pdc_log_writer_g, NULL);
+
+    pthread_mutex_lock(&pdc_log_mutex_g);
+    for (ring = pdc_log_rings_g; ring != NULL; ring = next) {
+        next = ring->next;
+        free(ring);
+    }
+    pdc_log_rings_g = NULL;
+    __atomic_fetch_add(&pdc_log_generation_g, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&pdc_log_mutex_g);
+
+    if (pdc_log_fd_g != STDOUT_FILENO) {
+        close(pdc_log_fd_g);
+        pdc_log_fd_g = STDOUT_FILENO;
+    }
+}
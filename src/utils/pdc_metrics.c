@@ -0,0 +1,192 @@
+/*
+ * Copyright Notice for
+ * Proactive Data Containers (PDC) Software Library and Utilities
+ * -----------------------------------------------------------------------------
+
+ *** Copyright Notice ***
+
+ * Proactive Data Containers (PDC) Copyright (c) 2017, The Regents of the
+ * University of California, through Lawrence Berkeley National Laboratory,
+ * UChicago Argonne, LLC, operator of Argonne National Laboratory, and The HDF
+ * Group (subject to receipt of any required approvals from the U.S. Dept. of
+ * Energy).  All rights reserved.
+
+ * If you have questions about your rights to use or distribute this software,
+ * please contact Berkeley Lab's Innovation & Partnerships Office at  IPO@lbl.gov.
+
+ * NOTICE.  This Software was developed under funding from the U.S. Department of
+ * Energy and the U.S. Government consequently retains certain rights. As such, the
+ * U.S. Government has been granted for itself and others acting on its behalf a
+ * paid-up, nonexclusive, irrevocable, worldwide license in the Software to
+ * reproduce, distribute copies to the public, prepare derivative works, and
+ * perform publicly and display publicly, and to permit other to do so.
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <inttypes.h>
+#include "pdc_metrics.h"
+
+static pdc_latency_hist_t pdc_metrics_g[PDC_METRIC_COUNT];
+static uint64_t           pdc_metrics_start_g = 0;
+
+static const char *pdc_metric_names_g[PDC_METRIC_COUNT] = {"server_transfer_request",
+                                                           "server_transfer_request_all",
+                                                           "server_transfer_request_wait",
+                                                           "server_transfer_request_wait_all",
+                                                           "server_transfer_request_metadata_query",
+                                                           "server_buf_map",
+                                                           "server_buf_unmap",
+                                                           "server_region_lock",
+                                                           "server_region_release",
+                                                           "server_obj_create",
+                                                           "server_cont_create",
+                                                           "server_write_bulk",
+                                                           "server_read_bulk",
+                                                           "server_data_write_out",
+                                                           "server_data_read_from",
+                                                           "server_cache_write",
+                                                           "server_cache_read",
+                                                           "server_cache_flush",
+                                                           "server_obj_put_data",
+                                                           "server_obj_get_data",
+                                                           "client_transfer_request_write",
+                                                           "client_transfer_request_read",
+                                                           "client_transfer_request_all",
+                                                           "client_transfer_request_wait",
+                                                           "client_transfer_request_wait_all",
+                                                           "client_obj_create",
+                                                           "client_cont_create",
+                                                           "client_obj_put_data",
+                                                           "client_obj_get_data",
+                                                           "client_write_buffer_flush",
+                                                           "client_read_cache_hit"};
+
+static inline int
+metrics_bucket(uint64_t value)
+{
+    int msb;
+
+    if (value < PDC_METRICS_SUB_BUCKETS)
+        return (int)value;
+    if (value >> PDC_METRICS_MAX_BITS)
+        return PDC_METRICS_NBUCKET - 1;
+
+    // The bits right after the leading one pick the sub-bucket
+    msb = 63 - __builtin_clzll(value);
+    return (msb - PDC_METRICS_SUB_BITS + 1) * PDC_METRICS_SUB_BUCKETS +
+           (int)((value >> (msb - PDC_METRICS_SUB_BITS)) - PDC_METRICS_SUB_BUCKETS);
+}
+
+// Middle of the values that fall in a bucket
+static inline uint64_t
+metrics_bucket_value(int bucket)
+{
+    int      shift;
+    uint64_t low;
+
+    if (bucket < PDC_METRICS_SUB_BUCKETS)
+        return (uint64_t)bucket;
+
+    shift = bucket / PDC_METRICS_SUB_BUCKETS - 1;
+    low   = (uint64_t)(PDC_METRICS_SUB_BUCKETS + bucket % PDC_METRICS_SUB_BUCKETS) << shift;
+    return low + ((1ULL << shift) >> 1);
+}
+
+uint64_t
+PDC_metrics_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+void
+PDC_metrics_record(pdc_metric_t metric, uint64_t start, uint64_t bytes)
+{
+    pdc_latency_hist_t *hist  = &pdc_metrics_g[metric];
+    uint64_t            value = PDC_metrics_now() - start;
+    uint64_t            max, first = 0;
+
+    if (pdc_metrics_start_g == 0)
+        __atomic_compare_exchange_n(&pdc_metrics_start_g, &first, start, 0, __ATOMIC_RELAXED,
+                                    __ATOMIC_RELAXED);
+
+    __atomic_fetch_add(&hist->buckets[metrics_bucket(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+    if (bytes > 0)
+        __atomic_fetch_add(&hist->bytes, bytes, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&hist->max, &max, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+uint64_t
+PDC_metrics_percentile(const pdc_latency_hist_t *hist, double quantile)
+{
+    uint64_t rank, seen = 0, count = 0;
+    int      i;
+
+    for (i = 0; i < PDC_METRICS_NBUCKET; i++)
+        count += hist->buckets[i];
+    if (count == 0)
+        return 0;
+
+    rank = (uint64_t)(quantile * count);
+    if (rank >= count)
+        rank = count - 1;
+    for (i = 0; i < PDC_METRICS_NBUCKET; i++) {
+        seen += hist->buckets[i];
+        if (seen > rank)
+            break;
+    }
+
+    // Report the max rather than the bucket middle when it falls in the same bucket
+    if (i == metrics_bucket(hist->max))
+        return hist->max;
+    return metrics_bucket_value(i);
+}
+
+const pdc_latency_hist_t *
+PDC_metrics_get(pdc_metric_t metric)
+{
+    return &pdc_metrics_g[metric];
+}
+
+const char *
+PDC_metrics_name(pdc_metric_t metric)
+{
+    return pdc_metric_names_g[metric];
+}
+
+size_t
+PDC_metrics_snapshot(char *buf, size_t size)
+{
+    const pdc_latency_hist_t *hist;
+    double                    elapsed;
+    size_t                    len = 0;
+    int                       i;
+
+    elapsed = pdc_metrics_start_g == 0 ? 0 : (PDC_metrics_now() - pdc_metrics_start_g) / 1e9;
+    len += snprintf(buf + len, size - len, "# %.3f s since the first recorded operation\n", elapsed);
+    len += snprintf(buf + len, size - len, "# %-38s %10s %12s %10s %10s %10s %10s %10s %8s\n", "metric",
+                    "count", "total_ms", "p50_us", "p99_us", "p999_us", "max_us", "MB", "MB/s");
+
+    for (i = 0; i < PDC_METRIC_COUNT && len < size; i++) {
+        hist = &pdc_metrics_g[i];
+        if (hist->count == 0)
+            continue;
+        len += snprintf(buf + len, size - len,
+                        "  %-38s %10" PRIu64 " %12.3f %10.1f %10.1f %10.1f %10.1f %10.1f %8.1f\n",
+                        pdc_metric_names_g[i], hist->count, hist->sum / 1e6,
+                        PDC_metrics_percentile(hist, 0.5) / 1e3, PDC_metrics_percentile(hist, 0.99) / 1e3,
+                        PDC_metrics_percentile(hist, 0.999) / 1e3, hist->max / 1e3, hist->bytes / 1048576.0,
+                        elapsed > 0 ? hist->bytes / 1048576.0 / elapsed : 0);
+    }
+
+    return len < size ? len : size - 1;
+}
@@ -349,6 +349,7 @@ pdc_timestamp_register(pdc_timestamp *timestamp, double start, double end)
         memcpy(temp, timestamp->start, sizeof(double) * timestamp->timestamp_max_size);
         memcpy(temp + timestamp->timestamp_max_size * 2, timestamp->end,
                sizeof(double) * timestamp->timestamp_max_size);
+        free(timestamp->start);
         timestamp->start = temp;
         timestamp->end   = temp + timestamp->timestamp_max_size * 2;
         timestamp->timestamp_max_size *= 2;
@@ -485,6 +486,15 @@ PDC_server_timing_report()
     fprintf(stream, "PDCdata_server_write_posix, %lf\n", pdc_server_timings->PDCdata_server_write_posix);
     fprintf(stream, "PDCdata_server_read_posix, %lf\n", pdc_server_timings->PDCdata_server_read_posix);
 
+    fprintf(stream, "PDCquery_cache_hit, %lf\n", pdc_server_timings->PDCquery_cache_hit);
+    fprintf(stream, "PDCquery_cache_miss, %lf\n", pdc_server_timings->PDCquery_cache_miss);
+    fprintf(stream, "PDCquery_cache_invalidate, %lf\n", pdc_server_timings->PDCquery_cache_invalidate);
+    fprintf(stream, "PDCquery_cache_hit_rate, %lf\n",
+            pdc_server_timings->PDCquery_cache_hit + pdc_server_timings->PDCquery_cache_miss > 0
+                ? pdc_server_timings->PDCquery_cache_hit /
+                      (pdc_server_timings->PDCquery_cache_hit + pdc_server_timings->PDCquery_cache_miss)
+                : 0.0);
+
     fprintf(stream, "PDCserver_restart, %lf\n", pdc_server_timings->PDCserver_restart);
     fprintf(stream, "PDCserver_checkpoint, %lf\n", pdc_server_timings->PDCserver_checkpoint);
     fprintf(stream, "PDCstart_server_total, %lf\n", pdc_server_timings->PDCserver_start_total);